@@ -0,0 +1,1354 @@
+/**
+ * NoLeak Vault Engine - Archive Import Implementation
+ *
+ * The source is consumed through one read buffer. ZIP members are parsed
+ * from their local headers (the central directory at the end is never
+ * needed); TAR is read block by block, optionally through a gzip inflater.
+ * Each member is produced in STREAMING_CHUNK_SIZE plaintext chunks with the
+ * same layout, AAD and per-file DEK wrapping as streaming imports.
+ *
+ * Importing is split in two so the caller's vault lock is only needed at the
+ * end: staging reads and encrypts every member into an unlinked spool file
+ * next to the vault, touching no vault state but its ID; the commit copies
+ * the spool into one append batch, wraps the DEKs with the master key and
+ * publishes all members with one index commit.
+ */
+
+#include "vault_archive.h"
+#include "vault_governor.h"
+#include "vault_search.h"
+#include "vault_streaming.h"
+#include <android/log.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/statvfs.h>
+#include <time.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#define LOG_TAG "VaultArchive"
+
+#ifdef NDEBUG
+#define LOGI(...) ((void)0)
+#define LOGE(...) ((void)0)
+#else
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#endif
+
+#define ARCHIVE_READ_BUFFER (256 * 1024)
+#define ARCHIVE_SKIP_BUFFER (64 * 1024)
+#define ARCHIVE_MAX_PATH 4096
+// Larger members are skipped, as a streaming import would reject them
+#ifndef ARCHIVE_MAX_MEMBER_SIZE
+#define ARCHIVE_MAX_MEMBER_SIZE STREAMING_MAX_FILE_SIZE
+#endif
+// Volume space an import leaves free
+#ifndef ARCHIVE_SPACE_RESERVE
+#define ARCHIVE_SPACE_RESERVE (64ULL * 1024 * 1024)
+#endif
+
+#define ZIP_LOCAL_SIG 0x04034b50u
+#define ZIP_CENTRAL_SIG 0x02014b50u
+#define ZIP_END_SIG 0x06054b50u
+#define ZIP64_END_SIG 0x06064b50u
+#define ZIP_EXTRA_DATA_SIG 0x08064b50u
+#define ZIP_DESCRIPTOR_SIG 0x08074b50u
+#define ZIP_LOCAL_HEADER_LEN 30
+#define ZIP_FLAG_ENCRYPTED 0x0001
+#define ZIP_FLAG_DESCRIPTOR 0x0008
+#define ZIP_METHOD_STORED 0
+#define ZIP_METHOD_DEFLATE 8
+#define ZIP_EXTRA_ZIP64 0x0001
+
+#define TAR_BLOCK 512
+
+extern vault_state_t g_vault;
+void vault_random_bytes(uint8_t *buf, size_t len);
+void vault_generate_id(uint8_t id_out[VAULT_ID_LEN]);
+
+static _Atomic uint64_t g_archive_bytes_read;
+
+typedef struct {
+  int fd;
+  uint8_t *buf;
+  size_t pos;
+  size_t len;
+  int eof;
+} archive_input_t;
+
+typedef enum {
+  MEMBER_STORED, // exactly `remaining` bytes from the raw input
+  MEMBER_DEFLATE, // raw deflate stream from the raw input
+  MEMBER_TAR     // exactly `remaining` bytes from the TAR stream
+} member_kind_t;
+
+typedef struct archive archive_t;
+
+typedef struct {
+  archive_t *ar;
+  member_kind_t kind;
+  uint64_t remaining;
+  z_stream z;
+  int z_ready;
+  int z_ended;
+  uint32_t crc;
+  uint64_t produced;
+} member_reader_t;
+
+struct archive {
+  archive_input_t in;
+  // .tar.gz: the TAR stream is inflated from the raw input
+  int gzip;
+  z_stream gz;
+  int gz_ready;
+  int gz_ended;
+  uint8_t vault_id[VAULT_ID_LEN]; // vault the chunks are bound to
+  int spool_fd;                    // staged ciphertext (unlinked)
+  uint64_t spool_size;
+  uint64_t spool_limit; // staged bytes that fit the volume
+  uint8_t *plain;       // one plaintext chunk
+  uint8_t *cipher;      // its ciphertext
+  uint8_t *skip;        // scratch for discarded data
+  // Parallel per member; chunk offsets are spool offsets until the commit
+  vault_archive_member_t *members;
+  vault_entry_t *entries;
+  uint8_t (*deks)[VAULT_KEY_LEN];
+  uint32_t member_count;
+  uint32_t member_cap;
+  uint32_t skipped;
+  vault_pace_t pace; // holds member writes to the governor's I/O rate
+};
+
+// The import staged by vault_archive_stage, awaiting its commit
+static archive_t *g_staged;
+
+static uint64_t get_timestamp_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static uint16_t read_le16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t read_le32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+
+static uint64_t read_le64(const uint8_t *p) {
+  return (uint64_t)read_le32(p) | ((uint64_t)read_le32(p + 4) << 32);
+}
+
+// ============================================================================
+// Raw input
+// ============================================================================
+
+// Refill the buffer once it is drained; pos == len afterwards means EOF.
+static int input_fill(archive_input_t *in) {
+  if (in->pos < in->len || in->eof)
+    return VAULT_OK;
+  in->pos = 0;
+  in->len = 0;
+  for (;;) {
+    ssize_t n = read(in->fd, in->buf, ARCHIVE_READ_BUFFER);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0)
+      return VAULT_ERR_IO;
+    if (n == 0)
+      in->eof = 1;
+    in->len = (size_t)n;
+    atomic_fetch_add(&g_archive_bytes_read, (uint64_t)n);
+    return VAULT_OK;
+  }
+}
+
+// Make at least n bytes available at pos unless the source ends first.
+static int input_ensure(archive_input_t *in, size_t n) {
+  if (in->len - in->pos >= n)
+    return VAULT_OK;
+  memmove(in->buf, in->buf + in->pos, in->len - in->pos);
+  in->len -= in->pos;
+  in->pos = 0;
+  while (in->len < n && !in->eof) {
+    ssize_t r = read(in->fd, in->buf + in->len, ARCHIVE_READ_BUFFER - in->len);
+    if (r < 0 && errno == EINTR)
+      continue;
+    if (r < 0)
+      return VAULT_ERR_IO;
+    if (r == 0)
+      in->eof = 1;
+    in->len += (size_t)r;
+    atomic_fetch_add(&g_archive_bytes_read, (uint64_t)r);
+  }
+  return VAULT_OK;
+}
+
+static int input_read(archive_input_t *in, uint8_t *dst, size_t n,
+                      size_t *got) {
+  *got = 0;
+  while (*got < n) {
+    int result = input_fill(in);
+    if (result != VAULT_OK)
+      return result;
+    size_t available = in->len - in->pos;
+    if (available == 0)
+      break;
+    size_t take = n - *got < available ? n - *got : available;
+    memcpy(dst + *got, in->buf + in->pos, take);
+    in->pos += take;
+    *got += take;
+  }
+  return VAULT_OK;
+}
+
+static int input_read_exact(archive_input_t *in, uint8_t *dst, size_t n) {
+  size_t got = 0;
+  int result = input_read(in, dst, n, &got);
+  if (result != VAULT_OK)
+    return result;
+  return got == n ? VAULT_OK : VAULT_ERR_CORRUPTED;
+}
+
+// Inflate from the raw input until dst is full or the stream ends; the
+// inflater only advances pos past the bytes it consumed.
+static int input_inflate(archive_input_t *in, z_stream *z, uint8_t *dst,
+                         size_t cap, size_t *got, int *ended) {
+  z->next_out = dst;
+  z->avail_out = (uInt)cap;
+  while (z->avail_out > 0 && !*ended) {
+    int result = input_fill(in);
+    if (result != VAULT_OK)
+      return result;
+    if (in->pos == in->len)
+      return VAULT_ERR_CORRUPTED;
+    z->next_in = in->buf + in->pos;
+    z->avail_in = (uInt)(in->len - in->pos);
+    int ret = inflate(z, Z_NO_FLUSH);
+    in->pos = in->len - z->avail_in;
+    if (ret == Z_STREAM_END)
+      *ended = 1;
+    else if (ret != Z_OK)
+      return VAULT_ERR_CORRUPTED;
+  }
+  *got = cap - z->avail_out;
+  return VAULT_OK;
+}
+
+// ============================================================================
+// TAR stream (raw or gzip)
+// ============================================================================
+
+static int stream_read_exact(archive_t *ar, uint8_t *dst, size_t n) {
+  if (!ar->gzip)
+    return input_read_exact(&ar->in, dst, n);
+  size_t got = 0;
+  int result = input_inflate(&ar->in, &ar->gz, dst, n, &got, &ar->gz_ended);
+  if (result != VAULT_OK)
+    return result;
+  return got == n ? VAULT_OK : VAULT_ERR_CORRUPTED;
+}
+
+static int stream_skip(archive_t *ar, uint64_t n) {
+  while (n > 0) {
+    size_t take = n < ARCHIVE_SKIP_BUFFER ? (size_t)n : ARCHIVE_SKIP_BUFFER;
+    int result = stream_read_exact(ar, ar->skip, take);
+    if (result != VAULT_OK)
+      return result;
+    n -= take;
+  }
+  return VAULT_OK;
+}
+
+static int raw_skip(archive_t *ar, uint64_t n) {
+  while (n > 0) {
+    size_t take = n < ARCHIVE_SKIP_BUFFER ? (size_t)n : ARCHIVE_SKIP_BUFFER;
+    int result = input_read_exact(&ar->in, ar->skip, take);
+    if (result != VAULT_OK)
+      return result;
+    n -= take;
+  }
+  return VAULT_OK;
+}
+
+// ============================================================================
+// Member data
+// ============================================================================
+
+// Produce up to cap plaintext bytes of the current member; *got == 0 at its
+// end.
+static int member_read(member_reader_t *r, uint8_t *dst, size_t cap,
+                       size_t *got) {
+  *got = 0;
+  int result = VAULT_OK;
+  switch (r->kind) {
+  case MEMBER_STORED:
+  case MEMBER_TAR: {
+    if (r->remaining == 0)
+      return VAULT_OK;
+    size_t take = r->remaining < cap ? (size_t)r->remaining : cap;
+    result = r->kind == MEMBER_TAR ? stream_read_exact(r->ar, dst, take)
+                                   : input_read_exact(&r->ar->in, dst, take);
+    if (result != VAULT_OK)
+      return result;
+    r->remaining -= take;
+    *got = take;
+    break;
+  }
+  case MEMBER_DEFLATE:
+    if (r->z_ended)
+      return VAULT_OK;
+    result = input_inflate(&r->ar->in, &r->z, dst, cap, got, &r->z_ended);
+    if (result != VAULT_OK)
+      return result;
+    break;
+  }
+  r->crc = (uint32_t)crc32(r->crc, dst, (uInt)*got);
+  r->produced += *got;
+  return VAULT_OK;
+}
+
+static int member_drain(member_reader_t *r) {
+  size_t got = 0;
+  do {
+    int result = member_read(r, r->ar->skip, ARCHIVE_SKIP_BUFFER, &got);
+    if (result != VAULT_OK)
+      return result;
+  } while (got > 0);
+  return VAULT_OK;
+}
+
+// ============================================================================
+// Names and types
+// ============================================================================
+
+static const struct {
+  const char *ext;
+  const char *mime;
+} g_archive_mime_types[] = {
+    {"jpg", "image/jpeg"},        {"jpeg", "image/jpeg"},
+    {"png", "image/png"},         {"gif", "image/gif"},
+    {"webp", "image/webp"},       {"bmp", "image/bmp"},
+    {"heic", "image/heic"},       {"heif", "image/heif"},
+    {"mp4", "video/mp4"},         {"m4v", "video/x-m4v"},
+    {"mkv", "video/x-matroska"},  {"webm", "video/webm"},
+    {"mov", "video/quicktime"},   {"3gp", "video/3gpp"},
+    {"mp3", "audio/mpeg"},        {"m4a", "audio/mp4"},
+    {"aac", "audio/aac"},         {"wav", "audio/x-wav"},
+    {"ogg", "audio/ogg"},         {"flac", "audio/flac"},
+    {"txt", "text/plain"},        {"md", "text/markdown"},
+    {"csv", "text/csv"},          {"log", "text/plain"},
+    {"json", "application/json"}, {"xml", "text/xml"},
+    {"html", "text/html"},        {"htm", "text/html"},
+    {"pdf", "application/pdf"},
+    {"docx", "application/"
+             "vnd.openxmlformats-officedocument.wordprocessingml.document"},
+    {"xlsx",
+     "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet"},
+    {"pptx", "application/"
+             "vnd.openxmlformats-officedocument.presentationml.presentation"},
+    {"pem", "application/x-pem-file"},
+    {"key", "application/x-pem-file"},
+    {"pub", "application/x-ssh-key"},
+    {"asc", "application/pgp-keys"},
+};
+
+// Archives carry no MIME types; map common extensions the way the picker
+// would and fall back to an opaque type.
+static const char *archive_mime_for_name(const char *name) {
+  const char *dot = strrchr(name, '.');
+  if (!dot || dot == name || dot[1] == '\0')
+    return "application/octet-stream";
+  char ext[8];
+  size_t len = strlen(dot + 1);
+  if (len >= sizeof(ext))
+    return "application/octet-stream";
+  for (size_t i = 0; i <= len; i++) {
+    char c = dot[1 + i];
+    ext[i] = (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+  }
+  for (size_t i = 0;
+       i < sizeof(g_archive_mime_types) / sizeof(g_archive_mime_types[0]);
+       i++) {
+    if (strcmp(ext, g_archive_mime_types[i].ext) == 0)
+      return g_archive_mime_types[i].mime;
+  }
+  return "application/octet-stream";
+}
+
+static uint8_t archive_type_for_mime(const char *mime) {
+  if (strncmp(mime, "image/", 6) == 0)
+    return VAULT_FILE_TYPE_IMG;
+  if (strncmp(mime, "video/", 6) == 0)
+    return VAULT_FILE_TYPE_VIDEO;
+  return VAULT_FILE_TYPE_TXT;
+}
+
+// Length of the valid UTF-8 sequence at p (at most n bytes), or 0.
+static size_t utf8_sequence_len(const uint8_t *p, size_t n) {
+  size_t len;
+  uint32_t min;
+  uint32_t cp;
+  if (p[0] < 0x80)
+    return 1;
+  if ((p[0] & 0xE0) == 0xC0) {
+    len = 2;
+    min = 0x80;
+    cp = p[0] & 0x1F;
+  } else if ((p[0] & 0xF0) == 0xE0) {
+    len = 3;
+    min = 0x800;
+    cp = p[0] & 0x0F;
+  } else if ((p[0] & 0xF8) == 0xF0) {
+    len = 4;
+    min = 0x10000;
+    cp = p[0] & 0x07;
+  } else {
+    return 0;
+  }
+  if (len > n)
+    return 0;
+  for (size_t i = 1; i < len; i++) {
+    if ((p[i] & 0xC0) != 0x80)
+      return 0;
+    cp = (cp << 6) | (p[i] & 0x3F);
+  }
+  if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+    return 0;
+  return len;
+}
+
+// Split an archive path into folder and file name. Separators are
+// normalized, "." / ".." / empty components dropped (nothing escapes the
+// archive root), and invalid UTF-8 or control bytes replaced. Directories
+// and hidden macOS metadata yield no name.
+static int archive_split_path(const char *path, size_t path_len,
+                              char **folder_out, char **name_out) {
+  *folder_out = NULL;
+  *name_out = NULL;
+  if (path_len == 0 || path_len > ARCHIVE_MAX_PATH)
+    return VAULT_OK;
+
+  // Surrogate pairs take 6 bytes for every 4 of input
+  char *clean = malloc(path_len / 2 * 3 + 4);
+  if (!clean)
+    return VAULT_ERR_MEMORY;
+  size_t out = 0;
+  size_t component_start = 0;
+  size_t last_sep = SIZE_MAX; // position of the separator before the name
+  const uint8_t *p = (const uint8_t *)path;
+  for (size_t i = 0; i <= path_len; i++) {
+    if (i == path_len || p[i] == '/' || p[i] == '\\') {
+      size_t component_len = out - component_start;
+      const char *component = clean + component_start;
+      if (component_len == 0 ||
+          (component_len == 1 && component[0] == '.') ||
+          (component_len == 2 && component[0] == '.' && component[1] == '.')) {
+        out = component_start;
+      } else if (component_len == 8 &&
+                 memcmp(component, "__MACOSX", 8) == 0) {
+        free(clean);
+        return VAULT_OK;
+      } else if (i < path_len) {
+        last_sep = out;
+        clean[out++] = '/';
+        component_start = out;
+      }
+      continue;
+    }
+    size_t seq = utf8_sequence_len(p + i, path_len - i);
+    if (seq == 0 || p[i] < 0x20 || p[i] == 0x7F) {
+      clean[out++] = '_';
+      continue;
+    }
+    if (seq == 4) {
+      // Names reach Java through JNI's modified UTF-8, which encodes
+      // supplementary characters as surrogate pairs
+      uint32_t cp = ((uint32_t)(p[i] & 0x07) << 18) |
+                    ((uint32_t)(p[i + 1] & 0x3F) << 12) |
+                    ((uint32_t)(p[i + 2] & 0x3F) << 6) | (p[i + 3] & 0x3F);
+      cp -= 0x10000;
+      uint32_t surrogates[2] = {0xD800 | (cp >> 10), 0xDC00 | (cp & 0x3FF)};
+      for (int h = 0; h < 2; h++) {
+        clean[out++] = (char)(0xE0 | (surrogates[h] >> 12));
+        clean[out++] = (char)(0x80 | ((surrogates[h] >> 6) & 0x3F));
+        clean[out++] = (char)(0x80 | (surrogates[h] & 0x3F));
+      }
+    } else {
+      memcpy(clean + out, p + i, seq);
+      out += seq;
+    }
+    i += seq - 1;
+  }
+  // A trailing separator means a directory entry
+  if (out == 0 || (out > 0 && clean[out - 1] == '/')) {
+    free(clean);
+    return VAULT_OK;
+  }
+  clean[out] = '\0';
+
+  const char *name = last_sep == SIZE_MAX ? clean : clean + last_sep + 1;
+  // AppleDouble files and reserved system names are never imported
+  if (strncmp(name, "._", 2) == 0 || strncmp(name, "__", 2) == 0 ||
+      strcmp(name, ".DS_Store") == 0) {
+    free(clean);
+    return VAULT_OK;
+  }
+  *name_out = strdup(name);
+  if (last_sep == SIZE_MAX) {
+    *folder_out = strdup("");
+  } else {
+    clean[last_sep] = '\0';
+    *folder_out = strdup(clean);
+  }
+  free(clean);
+  if (!*name_out || !*folder_out) {
+    free(*name_out);
+    free(*folder_out);
+    *name_out = NULL;
+    *folder_out = NULL;
+    return VAULT_ERR_MEMORY;
+  }
+  return VAULT_OK;
+}
+
+// ============================================================================
+// Member import
+// ============================================================================
+
+static int spool_write(archive_t *ar, const uint8_t *data, size_t len) {
+  while (len > 0) {
+    ssize_t n = write(ar->spool_fd, data, len);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return VAULT_ERR_IO;
+    data += n;
+    len -= (size_t)n;
+  }
+  return VAULT_OK;
+}
+
+// Drop a partly staged member from the spool tail.
+static int spool_rewind(archive_t *ar, uint64_t size) {
+  if (ftruncate(ar->spool_fd, (off_t)size) != 0 ||
+      lseek(ar->spool_fd, (off_t)size, SEEK_SET) < 0)
+    return VAULT_ERR_IO;
+  ar->spool_size = size;
+  return VAULT_OK;
+}
+
+// Encrypt one member into the spool. Rejected names, empty members and
+// members past the limits are drained and counted as skipped. Text members
+// are tokenized for search while their plaintext passes through.
+static int archive_import_member(archive_t *ar, const char *path,
+                                 size_t path_len, member_reader_t *reader) {
+  char *folder = NULL;
+  char *name = NULL;
+  int result = archive_split_path(path, path_len, &folder, &name);
+  if (result != VAULT_OK)
+    return result;
+  if (!name) {
+    // Directory entries are implied by member paths and not counted
+    if (path_len == 0 ||
+        (path[path_len - 1] != '/' && path[path_len - 1] != '\\'))
+      ar->skipped++;
+    return member_drain(reader);
+  }
+  if (ar->member_count >= VAULT_ARCHIVE_MAX_MEMBERS) {
+    free(folder);
+    free(name);
+    ar->skipped++;
+    return member_drain(reader);
+  }
+
+  vault_entry_t entry;
+  memset(&entry, 0, sizeof(entry));
+  uint8_t dek[VAULT_KEY_LEN];
+  uint32_t chunk_cap = 0;
+  uint64_t spool_start = ar->spool_size;
+  uint8_t *text = NULL;
+  size_t text_cap = 0;
+  vault_random_bytes(dek, VAULT_KEY_LEN);
+  vault_generate_id(entry.file_id);
+  entry.created_at = get_timestamp_ms();
+  entry.name = name;
+  name = NULL;
+  entry.mime = strdup(archive_mime_for_name(entry.name));
+  if (!entry.mime) {
+    result = VAULT_ERR_MEMORY;
+    goto cleanup;
+  }
+  entry.type = archive_type_for_mime(entry.mime);
+  int index_text = entry.type == VAULT_FILE_TYPE_TXT &&
+                   vault_search_is_indexable(entry.mime);
+
+  vault_aad_t aad = {0};
+  memcpy(aad.vault_id, ar->vault_id, VAULT_ID_LEN);
+  memcpy(aad.file_id, entry.file_id, VAULT_ID_LEN);
+  aad.format_version = VAULT_VERSION;
+
+  // Chunks use the streaming layout: every chunk but the last holds
+  // STREAMING_CHUNK_SIZE plaintext bytes.
+  int ended = 0;
+  while (!ended) {
+    size_t filled = 0;
+    while (filled < STREAMING_CHUNK_SIZE) {
+      size_t got = 0;
+      result = member_read(reader, ar->plain + filled,
+                           STREAMING_CHUNK_SIZE - filled, &got);
+      if (result != VAULT_OK)
+        goto cleanup;
+      if (got == 0) {
+        ended = 1;
+        break;
+      }
+      filled += got;
+    }
+    if (filled == 0)
+      break;
+
+    if (entry.size + filled > ARCHIVE_MAX_MEMBER_SIZE) {
+      LOGE("archive_import_member: member exceeds %llu bytes, skipped",
+           (unsigned long long)ARCHIVE_MAX_MEMBER_SIZE);
+      vault_zeroize(ar->plain, filled);
+      result = spool_rewind(ar, spool_start);
+      if (result == VAULT_OK)
+        result = member_drain(reader);
+      entry.size = 0;
+      break;
+    }
+    if (ar->spool_size + filled + VAULT_TAG_LEN > ar->spool_limit) {
+      LOGE("archive_import_member: not enough free space for the archive");
+      vault_zeroize(ar->plain, filled);
+      result = VAULT_ERR_IO;
+      goto cleanup;
+    }
+
+    if (index_text) {
+      if (entry.size + filled > VAULT_SEARCH_MAX_INDEX_SIZE) {
+        // Too large to tokenize, like a streamed text import
+        if (text) {
+          vault_zeroize(text, (size_t)entry.size);
+          free(text);
+          text = NULL;
+        }
+        index_text = 0;
+      } else {
+        if (entry.size + filled > text_cap) {
+          size_t cap = text_cap ? text_cap * 2 : STREAMING_CHUNK_SIZE;
+          while (cap < entry.size + filled)
+            cap *= 2;
+          uint8_t *grown = malloc(cap);
+          if (!grown) {
+            vault_zeroize(ar->plain, filled);
+            result = VAULT_ERR_MEMORY;
+            goto cleanup;
+          }
+          if (text) {
+            memcpy(grown, text, (size_t)entry.size);
+            vault_zeroize(text, (size_t)entry.size);
+            free(text);
+          }
+          text = grown;
+          text_cap = cap;
+        }
+        memcpy(text + entry.size, ar->plain, filled);
+      }
+    }
+
+    if (entry.chunk_count == chunk_cap) {
+      uint32_t cap = chunk_cap ? chunk_cap * 2 : 4;
+      void *resized = realloc(entry.chunks, cap * sizeof(entry.chunks[0]));
+      if (!resized) {
+        vault_zeroize(ar->plain, filled);
+        result = VAULT_ERR_MEMORY;
+        goto cleanup;
+      }
+      entry.chunks = resized;
+      chunk_cap = cap;
+    }
+    uint32_t c = entry.chunk_count;
+    aad.chunk_index = c;
+    result = vault_aead_encrypt(dek, NULL, (uint8_t *)&aad, sizeof(aad),
+                                ar->plain, filled, ar->cipher,
+                                entry.chunks[c].nonce);
+    vault_zeroize(ar->plain, filled);
+    if (result != VAULT_OK)
+      goto cleanup;
+    result = spool_write(ar, ar->cipher, filled + VAULT_TAG_LEN);
+    if (result != VAULT_OK)
+      goto cleanup;
+    entry.chunks[c].offset = ar->spool_size;
+    entry.chunks[c].length = (uint32_t)(filled + VAULT_TAG_LEN);
+    ar->spool_size += filled + VAULT_TAG_LEN;
+    entry.chunk_count++;
+    entry.size += filled;
+    vault_governor_pace(&ar->pace, filled + VAULT_TAG_LEN);
+  }
+  if (result != VAULT_OK)
+    goto cleanup;
+
+  if (entry.size == 0) {
+    ar->skipped++;
+    goto cleanup;
+  }
+  if (index_text) {
+    result = vault_search_attach_terms(&entry, text, (size_t)entry.size);
+    if (result != VAULT_OK)
+      goto cleanup;
+  }
+
+  if (ar->member_count == ar->member_cap) {
+    uint32_t cap = ar->member_cap ? ar->member_cap * 2 : 16;
+    vault_archive_member_t *members =
+        realloc(ar->members, cap * sizeof(vault_archive_member_t));
+    if (members)
+      ar->members = members;
+    vault_entry_t *entries =
+        realloc(ar->entries, cap * sizeof(vault_entry_t));
+    if (entries)
+      ar->entries = entries;
+    uint8_t(*deks)[VAULT_KEY_LEN] = realloc(ar->deks, cap * sizeof(*deks));
+    if (deks)
+      ar->deks = deks;
+    if (!members || !entries || !deks) {
+      result = VAULT_ERR_MEMORY;
+      goto cleanup;
+    }
+    ar->member_cap = cap;
+  }
+  vault_archive_member_t *member = &ar->members[ar->member_count];
+  memset(member, 0, sizeof(*member));
+  member->name = strdup(entry.name);
+  if (!member->name) {
+    result = VAULT_ERR_MEMORY;
+    goto cleanup;
+  }
+  memcpy(member->file_id, entry.file_id, VAULT_ID_LEN);
+  member->folder = folder;
+  member->size = entry.size;
+  folder = NULL;
+  // The entry and its DEK move to the stage; the DEK is wrapped at commit
+  ar->entries[ar->member_count] = entry;
+  memset(&entry, 0, sizeof(entry));
+  memcpy(ar->deks[ar->member_count], dek, VAULT_KEY_LEN);
+  ar->member_count++;
+
+cleanup:
+  if (text) {
+    vault_zeroize(text, text_cap);
+    free(text);
+  }
+  vault_zeroize(dek, sizeof(dek));
+  vault_free_entry(&entry);
+  free(folder);
+  free(name);
+  return result;
+}
+
+// ============================================================================
+// ZIP
+// ============================================================================
+
+static int zip_import(archive_t *ar) {
+  archive_input_t *in = &ar->in;
+  uint8_t header[ZIP_LOCAL_HEADER_LEN];
+  char *path = NULL;
+  uint8_t *extra = NULL;
+  int result = VAULT_OK;
+
+  for (;;) {
+    result = input_ensure(in, 4);
+    if (result != VAULT_OK)
+      break;
+    if (in->len - in->pos < 4) {
+      result = VAULT_ERR_CORRUPTED;
+      break;
+    }
+    uint32_t signature = read_le32(in->buf + in->pos);
+    // Local entries end where the central directory begins
+    if (signature == ZIP_CENTRAL_SIG || signature == ZIP_END_SIG ||
+        signature == ZIP64_END_SIG || signature == ZIP_EXTRA_DATA_SIG)
+      break;
+    if (signature != ZIP_LOCAL_SIG) {
+      result = VAULT_ERR_CORRUPTED;
+      break;
+    }
+    result = input_read_exact(in, header, sizeof(header));
+    if (result != VAULT_OK)
+      break;
+    uint16_t flags = read_le16(header + 6);
+    uint16_t method = read_le16(header + 8);
+    uint32_t expected_crc = read_le32(header + 14);
+    uint64_t compressed = read_le32(header + 18);
+    uint64_t uncompressed = read_le32(header + 22);
+    uint16_t name_len = read_le16(header + 26);
+    uint16_t extra_len = read_le16(header + 28);
+
+    path = malloc((size_t)name_len + 1);
+    extra = malloc((size_t)extra_len + 1);
+    if (!path || !extra) {
+      result = VAULT_ERR_MEMORY;
+      break;
+    }
+    result = input_read_exact(in, (uint8_t *)path, name_len);
+    if (result == VAULT_OK)
+      result = input_read_exact(in, extra, extra_len);
+    if (result != VAULT_OK)
+      break;
+    path[name_len] = '\0';
+
+    // ZIP64 sizes replace the 32-bit fields that are saturated, in order
+    int zip64 = 0;
+    for (size_t e = 0; e + 4 <= extra_len;) {
+      uint16_t id = read_le16(extra + e);
+      uint16_t size = read_le16(extra + e + 2);
+      if (e + 4 + size > extra_len)
+        break;
+      if (id == ZIP_EXTRA_ZIP64) {
+        const uint8_t *field = extra + e + 4;
+        size_t left = size;
+        zip64 = 1;
+        if (uncompressed == 0xFFFFFFFFu && left >= 8) {
+          uncompressed = read_le64(field);
+          field += 8;
+          left -= 8;
+        }
+        if (compressed == 0xFFFFFFFFu && left >= 8)
+          compressed = read_le64(field);
+      }
+      e += 4 + size;
+    }
+
+    int has_descriptor = (flags & ZIP_FLAG_DESCRIPTOR) != 0;
+    int supported = !(flags & ZIP_FLAG_ENCRYPTED) &&
+                    (method == ZIP_METHOD_DEFLATE ||
+                     (method == ZIP_METHOD_STORED && !has_descriptor));
+    if (!supported) {
+      // Without sizes in the local header the member cannot be stepped over
+      if (has_descriptor) {
+        result = VAULT_ERR_INVALID_PARAM;
+        break;
+      }
+      ar->skipped++;
+      result = raw_skip(ar, compressed);
+      if (result != VAULT_OK)
+        break;
+    } else {
+      member_reader_t reader;
+      memset(&reader, 0, sizeof(reader));
+      reader.ar = ar;
+      reader.crc = (uint32_t)crc32(0, Z_NULL, 0);
+      if (method == ZIP_METHOD_STORED) {
+        reader.kind = MEMBER_STORED;
+        reader.remaining = compressed;
+      } else {
+        reader.kind = MEMBER_DEFLATE;
+        if (inflateInit2(&reader.z, -MAX_WBITS) != Z_OK) {
+          result = VAULT_ERR_MEMORY;
+          break;
+        }
+        reader.z_ready = 1;
+      }
+      result = archive_import_member(ar, path, name_len, &reader);
+      if (reader.z_ready)
+        inflateEnd(&reader.z);
+      if (result != VAULT_OK)
+        break;
+
+      if (has_descriptor) {
+        // Optional signature, CRC, then sizes (8 bytes each for ZIP64)
+        size_t sizes_len = zip64 ? 16 : 8;
+        uint8_t descriptor[4 + 4 + 16];
+        result = input_ensure(in, 4);
+        if (result != VAULT_OK)
+          break;
+        if (in->len - in->pos >= 4 &&
+            read_le32(in->buf + in->pos) == ZIP_DESCRIPTOR_SIG)
+          in->pos += 4;
+        result = input_read_exact(in, descriptor, 4 + sizes_len);
+        if (result != VAULT_OK)
+          break;
+        expected_crc = read_le32(descriptor);
+        uncompressed =
+            zip64 ? read_le64(descriptor + 12) : read_le32(descriptor + 8);
+      }
+      if (reader.crc != expected_crc || reader.produced != uncompressed) {
+        result = VAULT_ERR_CORRUPTED;
+        break;
+      }
+    }
+    free(path);
+    free(extra);
+    path = NULL;
+    extra = NULL;
+  }
+  free(path);
+  free(extra);
+  return result;
+}
+
+// ============================================================================
+// TAR
+// ============================================================================
+
+// Octal field, or base-256 when the high bit of the first byte is set.
+static int tar_parse_number(const uint8_t *field, size_t len,
+                            uint64_t *value_out) {
+  uint64_t value = 0;
+  if (field[0] & 0x80) {
+    if (field[0] & 0x40)
+      return VAULT_ERR_CORRUPTED;
+    value = field[0] & 0x3F;
+    for (size_t i = 1; i < len; i++) {
+      if (value >> 56)
+        return VAULT_ERR_CORRUPTED;
+      value = (value << 8) | field[i];
+    }
+    *value_out = value;
+    return VAULT_OK;
+  }
+  size_t i = 0;
+  while (i < len && field[i] == ' ')
+    i++;
+  for (; i < len && field[i] >= '0' && field[i] <= '7'; i++) {
+    if (value >> 61)
+      return VAULT_ERR_CORRUPTED;
+    value = (value << 3) | (uint64_t)(field[i] - '0');
+  }
+  *value_out = value;
+  return VAULT_OK;
+}
+
+static int tar_checksum_valid(const uint8_t *block) {
+  uint64_t stored = 0;
+  if (tar_parse_number(block + 148, 8, &stored) != VAULT_OK)
+    return 0;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < TAR_BLOCK; i++)
+    sum += (i >= 148 && i < 156) ? ' ' : block[i];
+  return sum == stored;
+}
+
+static int tar_block_is_zero(const uint8_t *block) {
+  for (size_t i = 0; i < TAR_BLOCK; i++) {
+    if (block[i])
+      return 0;
+  }
+  return 1;
+}
+
+// Read an extended header (GNU long name or pax records) of len bytes.
+static int tar_read_extension(archive_t *ar, uint64_t len, char **out) {
+  *out = NULL;
+  uint64_t padded = (len + TAR_BLOCK - 1) / TAR_BLOCK * TAR_BLOCK;
+  if (len > ARCHIVE_MAX_PATH * 4)
+    return stream_skip(ar, padded);
+  char *data = malloc((size_t)len + 1);
+  if (!data)
+    return VAULT_ERR_MEMORY;
+  int result = stream_read_exact(ar, (uint8_t *)data, (size_t)len);
+  if (result == VAULT_OK)
+    result = stream_skip(ar, padded - len);
+  if (result != VAULT_OK) {
+    free(data);
+    return result;
+  }
+  data[len] = '\0';
+  *out = data;
+  return VAULT_OK;
+}
+
+// Apply "length key=value\n" pax records for path and size.
+static int tar_apply_pax(const char *records, size_t len, char **path_out,
+                         uint64_t *size_out, int *has_size_out) {
+  size_t pos = 0;
+  while (pos < len) {
+    char *end = NULL;
+    unsigned long record_len = strtoul(records + pos, &end, 10);
+    if (!end || *end != ' ' || record_len == 0 || record_len > len - pos)
+      return VAULT_ERR_CORRUPTED;
+    const char *key = end + 1;
+    const char *record_end = records + pos + record_len - 1; // '\n'
+    if (record_end < key)
+      return VAULT_ERR_CORRUPTED;
+    const char *eq = memchr(key, '=', (size_t)(record_end - key));
+    if (eq) {
+      size_t key_len = (size_t)(eq - key);
+      size_t value_len = (size_t)(record_end - eq - 1);
+      if (key_len == 4 && memcmp(key, "path", 4) == 0) {
+        char *value = malloc(value_len + 1);
+        if (!value)
+          return VAULT_ERR_MEMORY;
+        memcpy(value, eq + 1, value_len);
+        value[value_len] = '\0';
+        free(*path_out);
+        *path_out = value;
+      } else if (key_len == 4 && memcmp(key, "size", 4) == 0) {
+        *size_out = strtoull(eq + 1, NULL, 10);
+        *has_size_out = 1;
+      }
+    }
+    pos += record_len;
+  }
+  return VAULT_OK;
+}
+
+static int tar_import(archive_t *ar) {
+  uint8_t block[TAR_BLOCK];
+  char *long_path = NULL; // from a GNU 'L' or pax header
+  uint64_t pax_size = 0;
+  int has_pax_size = 0;
+  int first = 1;
+  int result = VAULT_OK;
+
+  for (;;) {
+    result = stream_read_exact(ar, block, TAR_BLOCK);
+    if (result != VAULT_OK)
+      break;
+    if (tar_block_is_zero(block))
+      break; // end-of-archive marker
+    if (!tar_checksum_valid(block)) {
+      result = first ? VAULT_ERR_INVALID_PARAM : VAULT_ERR_CORRUPTED;
+      break;
+    }
+    first = 0;
+
+    uint64_t size = 0;
+    result = tar_parse_number(block + 124, 12, &size);
+    if (result != VAULT_OK)
+      break;
+    if (has_pax_size)
+      size = pax_size;
+    uint64_t padding = (TAR_BLOCK - size % TAR_BLOCK) % TAR_BLOCK;
+    char type = (char)block[156];
+
+    if (type == 'L' || type == 'x') {
+      char *data = NULL;
+      result = tar_read_extension(ar, size, &data);
+      if (result != VAULT_OK)
+        break;
+      if (data && type == 'L') {
+        free(long_path);
+        long_path = data;
+      } else if (data) {
+        result = tar_apply_pax(data, (size_t)size, &long_path, &pax_size,
+                               &has_pax_size);
+        free(data);
+        if (result != VAULT_OK)
+          break;
+      }
+      continue;
+    }
+
+    if (type == '0' || type == '\0' || type == '7') {
+      char name_field[101];
+      char prefix_field[156];
+      memcpy(name_field, block, 100);
+      name_field[100] = '\0';
+      memcpy(prefix_field, block + 345, 155);
+      prefix_field[155] = '\0';
+      char joined[sizeof(prefix_field) + sizeof(name_field) + 1];
+      const char *path = joined;
+      if (long_path) {
+        path = long_path;
+      } else if (memcmp(block + 257, "ustar", 5) == 0 && prefix_field[0]) {
+        snprintf(joined, sizeof(joined), "%s/%s", prefix_field, name_field);
+      } else {
+        snprintf(joined, sizeof(joined), "%s", name_field);
+      }
+
+      member_reader_t reader;
+      memset(&reader, 0, sizeof(reader));
+      reader.ar = ar;
+      reader.kind = MEMBER_TAR;
+      reader.remaining = size;
+      result = archive_import_member(ar, path, strlen(path), &reader);
+    } else {
+      // Directories are implied by member paths; links, devices and global
+      // headers carry nothing to import
+      if (type != '5' && type != 'g')
+        ar->skipped++;
+      result = stream_skip(ar, size);
+    }
+    if (result == VAULT_OK)
+      result = stream_skip(ar, padding);
+    if (result != VAULT_OK)
+      break;
+    free(long_path);
+    long_path = NULL;
+    has_pax_size = 0;
+  }
+  free(long_path);
+  return result;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void vault_archive_free_members(vault_archive_member_t *members,
+                                uint32_t count) {
+  if (!members)
+    return;
+  for (uint32_t i = 0; i < count; i++) {
+    free(members[i].folder);
+    free(members[i].name);
+  }
+  free(members);
+}
+
+uint64_t vault_archive_bytes_read(void) {
+  return atomic_load(&g_archive_bytes_read);
+}
+
+static void archive_free(archive_t *ar) {
+  if (!ar)
+    return;
+  if (ar->gz_ready)
+    inflateEnd(&ar->gz);
+  if (ar->spool_fd >= 0)
+    close(ar->spool_fd);
+  vault_archive_free_members(ar->members, ar->member_count);
+  for (uint32_t i = 0; i < ar->member_count; i++)
+    vault_free_entry(&ar->entries[i]);
+  free(ar->entries);
+  if (ar->deks) {
+    vault_zeroize(ar->deks, ar->member_cap * sizeof(*ar->deks));
+    free(ar->deks);
+  }
+  if (ar->plain) {
+    vault_zeroize(ar->plain, STREAMING_CHUNK_SIZE);
+    free(ar->plain);
+  }
+  free(ar->cipher);
+  if (ar->skip) {
+    vault_zeroize(ar->skip, ARCHIVE_SKIP_BUFFER);
+    free(ar->skip);
+  }
+  if (ar->in.buf) {
+    vault_zeroize(ar->in.buf, ARCHIVE_READ_BUFFER);
+    free(ar->in.buf);
+  }
+  free(ar);
+}
+
+// Unlinked spool next to the vault, so staging and the vault share a volume.
+static int archive_open_spool(archive_t *ar) {
+  size_t len = strlen(g_vault.path);
+  char *path = malloc(len + sizeof(".archive"));
+  if (!path)
+    return VAULT_ERR_MEMORY;
+  memcpy(path, g_vault.path, len);
+  memcpy(path + len, ".archive", sizeof(".archive"));
+  ar->spool_fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+  if (ar->spool_fd >= 0)
+    unlink(path);
+
+  // Every staged byte is written twice: to the spool, then to the vault
+  ar->spool_limit = UINT64_MAX;
+  char *slash = strrchr(path, '/');
+  if (slash)
+    *slash = '\0';
+  struct statvfs fs;
+  if (statvfs(slash ? (slash == path ? "/" : path) : ".", &fs) == 0) {
+    uint64_t free_bytes = (uint64_t)fs.f_bavail * fs.f_frsize;
+    uint64_t reserve = ARCHIVE_SPACE_RESERVE;
+    ar->spool_limit = free_bytes > reserve ? (free_bytes - reserve) / 2 : 0;
+  }
+  free(path);
+  return ar->spool_fd >= 0 ? VAULT_OK : VAULT_ERR_IO;
+}
+
+int vault_archive_stage(int fd, uint32_t *count_out, uint32_t *skipped_out) {
+  if (!g_vault.is_open || !g_vault.path)
+    return VAULT_ERR_NOT_OPEN;
+  if (fd < 0 || !count_out || !skipped_out)
+    return VAULT_ERR_INVALID_PARAM;
+  *count_out = 0;
+  *skipped_out = 0;
+  vault_archive_discard();
+  atomic_store(&g_archive_bytes_read, 0);
+
+  archive_t *ar = calloc(1, sizeof(*ar));
+  if (!ar)
+    return VAULT_ERR_MEMORY;
+  ar->spool_fd = -1;
+  memcpy(ar->vault_id, g_vault.vault_id, VAULT_ID_LEN);
+  ar->in.fd = fd;
+  ar->in.buf = malloc(ARCHIVE_READ_BUFFER);
+  ar->plain = malloc(STREAMING_CHUNK_SIZE);
+  ar->cipher = malloc(STREAMING_CHUNK_SIZE + VAULT_TAG_LEN);
+  ar->skip = malloc(ARCHIVE_SKIP_BUFFER);
+  int result = VAULT_OK;
+  if (!ar->in.buf || !ar->plain || !ar->cipher || !ar->skip) {
+    result = VAULT_ERR_MEMORY;
+    goto fail;
+  }
+
+  result = input_ensure(&ar->in, 4);
+  if (result != VAULT_OK)
+    goto fail;
+  const uint8_t *magic = ar->in.buf;
+  size_t available = ar->in.len;
+  int is_zip = available >= 4 && (read_le32(magic) == ZIP_LOCAL_SIG ||
+                                  read_le32(magic) == ZIP_END_SIG);
+  ar->gzip = available >= 2 && magic[0] == 0x1f && magic[1] == 0x8b;
+  if (!is_zip && !ar->gzip) {
+    result = input_ensure(&ar->in, TAR_BLOCK);
+    if (result != VAULT_OK)
+      goto fail;
+    if (ar->in.len < TAR_BLOCK || !tar_checksum_valid(ar->in.buf)) {
+      result = VAULT_ERR_INVALID_PARAM;
+      goto fail;
+    }
+  }
+  if (ar->gzip) {
+    // 16 + MAX_WBITS: expect a gzip wrapper
+    if (inflateInit2(&ar->gz, 16 + MAX_WBITS) != Z_OK) {
+      result = VAULT_ERR_MEMORY;
+      goto fail;
+    }
+    ar->gz_ready = 1;
+  }
+
+  result = archive_open_spool(ar);
+  if (result != VAULT_OK)
+    goto fail;
+  result = is_zip ? zip_import(ar) : tar_import(ar);
+  if (result != VAULT_OK)
+    goto fail;
+
+  LOGI("vault_archive_stage: %u members staged, %u skipped", ar->member_count,
+       ar->skipped);
+  *count_out = ar->member_count;
+  *skipped_out = ar->skipped;
+  g_staged = ar;
+  return VAULT_OK;
+
+fail:
+  LOGE("vault_archive_stage: failed with %d after %u members", result,
+       ar->member_count);
+  archive_free(ar);
+  return result;
+}
+
+int vault_archive_commit(vault_archive_member_t **members_out,
+                         uint32_t *count_out, uint32_t *skipped_out) {
+  if (!members_out || !count_out || !skipped_out)
+    return VAULT_ERR_INVALID_PARAM;
+  *members_out = NULL;
+  *count_out = 0;
+  *skipped_out = 0;
+  archive_t *ar = g_staged;
+  if (!ar)
+    return VAULT_ERR_INVALID_PARAM;
+  g_staged = NULL;
+  // Chunk AAD binds the staged ciphertext to the vault it was staged for
+  if (!g_vault.is_open ||
+      memcmp(ar->vault_id, g_vault.vault_id, VAULT_ID_LEN) != 0) {
+    archive_free(ar);
+    return VAULT_ERR_NOT_OPEN;
+  }
+
+  vault_append_batch_t *batch = NULL;
+  int result = vault_append_batch_begin(&batch);
+  if (result != VAULT_OK)
+    goto cleanup;
+
+  // Copy the spool in one pass; members keep their relative offsets
+  uint64_t base = 0;
+  if (lseek(ar->spool_fd, 0, SEEK_SET) < 0) {
+    result = VAULT_ERR_IO;
+    goto cleanup;
+  }
+  for (uint64_t copied = 0; copied < ar->spool_size;) {
+    uint64_t left = ar->spool_size - copied;
+    size_t want = left < STREAMING_CHUNK_SIZE + VAULT_TAG_LEN
+                      ? (size_t)left
+                      : STREAMING_CHUNK_SIZE + VAULT_TAG_LEN;
+    ssize_t n = read(ar->spool_fd, ar->cipher, want);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0) {
+      result = VAULT_ERR_IO;
+      goto cleanup;
+    }
+    uint64_t offset = 0;
+    result = vault_append_batch_write(batch, ar->cipher, (size_t)n, &offset);
+    if (result != VAULT_OK)
+      goto cleanup;
+    if (copied == 0)
+      base = offset;
+    copied += (uint64_t)n;
+  }
+
+  for (uint32_t i = 0; i < ar->member_count; i++) {
+    vault_entry_t *entry = &ar->entries[i];
+    entry->wrapped_dek_len = VAULT_NONCE_LEN + VAULT_KEY_LEN + VAULT_TAG_LEN;
+    entry->wrapped_dek = malloc(entry->wrapped_dek_len);
+    if (!entry->wrapped_dek) {
+      result = VAULT_ERR_MEMORY;
+      goto cleanup;
+    }
+    vault_aad_t aad = {0};
+    memcpy(aad.vault_id, g_vault.vault_id, VAULT_ID_LEN);
+    memcpy(aad.file_id, entry->file_id, VAULT_ID_LEN);
+    aad.chunk_index = 0;
+    aad.format_version = VAULT_VERSION;
+    uint8_t dek_nonce[VAULT_NONCE_LEN];
+    result = vault_aead_encrypt(g_vault.master_key, NULL, (uint8_t *)&aad,
+                                sizeof(aad), ar->deks[i], VAULT_KEY_LEN,
+                                entry->wrapped_dek + VAULT_NONCE_LEN,
+                                dek_nonce);
+    if (result != VAULT_OK)
+      goto cleanup;
+    memcpy(entry->wrapped_dek, dek_nonce, VAULT_NONCE_LEN);
+    for (uint32_t c = 0; c < entry->chunk_count; c++)
+      entry->chunks[c].offset += base;
+    result = vault_append_batch_add(batch, entry);
+    if (result != VAULT_OK)
+      goto cleanup;
+  }
+  result = vault_append_batch_commit(batch);
+  if (result != VAULT_OK)
+    goto cleanup;
+
+  LOGI("vault_archive_commit: %u members imported, %u skipped",
+       ar->member_count, ar->skipped);
+  *members_out = ar->members;
+  *count_out = ar->member_count;
+  *skipped_out = ar->skipped;
+  ar->members = NULL;
+
+cleanup:
+  if (result != VAULT_OK)
+    LOGE("vault_archive_commit: failed with %d", result);
+  vault_append_batch_free(batch);
+  archive_free(ar);
+  return result;
+}
+
+void vault_archive_discard(void) {
+  archive_free(g_staged);
+  g_staged = NULL;
+}
+
+int vault_import_archive(int fd, vault_archive_member_t **members_out,
+                         uint32_t *count_out, uint32_t *skipped_out) {
+  if (!members_out || !count_out || !skipped_out)
+    return VAULT_ERR_INVALID_PARAM;
+  uint32_t staged = 0;
+  int result = vault_archive_stage(fd, &staged, skipped_out);
+  if (result != VAULT_OK)
+    return result;
+  return vault_archive_commit(members_out, count_out, skipped_out);
+}
@@ -0,0 +1,142 @@
+/**
+ * NoLeak Vault Engine - Archive Import and Export
+ *
+ * Reads a ZIP, TAR or gzip-compressed TAR from a descriptor in one forward
+ * pass and stores every regular member as its own chunked entry. Members are
+ * decompressed into a single chunk buffer and encrypted to a spool file, so
+ * no plaintext reaches disk and memory stays bounded by one chunk (plus the
+ * text of a searchable member) regardless of archive size. Staging needs no
+ * vault lock; the commit copies the spool into the vault and publishes all
+ * members together. A failed import leaves the vault unchanged.
+ *
+ * - ZIP: stored and deflated members, data descriptors and ZIP64 sizes;
+ *   encrypted members and other methods are skipped
+ * - TAR: ustar, GNU long names and pax path/size records
+ * - Directory structure is returned per member for the folder map
+ *
+ * Export writes a selection of entries as one uncompressed ZIP or TAR stream
+ * to a single descriptor. Chunks are decrypted by a small worker pool ahead
+ * of the writer, which emits members strictly in order.
+ */
+
+#ifndef VAULT_ARCHIVE_H
+#define VAULT_ARCHIVE_H
+
+#include "vault_engine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Members beyond this are skipped (matches the folder import limit)
+#define VAULT_ARCHIVE_MAX_MEMBERS 5000
+
+typedef struct {
+  uint8_t file_id[VAULT_ID_LEN];
+  char *folder; // directory inside the archive, "" at its root
+  char *name;
+  uint64_t size;
+} vault_archive_member_t;
+
+/**
+ * Read and encrypt every regular member of an archive without changing the
+ * vault; one staged import is kept until vault_archive_commit or
+ * vault_archive_discard. Only the vault ID is read, so the caller need not
+ * hold its vault lock. The descriptor is read sequentially from its current
+ * position and is not closed. Empty files, links, hidden macOS metadata,
+ * reserved "__" names and members over STREAMING_MAX_FILE_SIZE are skipped.
+ *
+ * @param fd Archive source
+ * @param count_out Receives the number of members staged
+ * @param skipped_out Receives the number of members not staged
+ * @return VAULT_OK on success, VAULT_ERR_INVALID_PARAM for an unsupported
+ * format, VAULT_ERR_CORRUPTED for a damaged archive, VAULT_ERR_IO when the
+ * volume cannot hold the spool and the imported copy
+ */
+int vault_archive_stage(int fd, uint32_t *count_out, uint32_t *skipped_out);
+
+/**
+ * Copy the staged import into the vault and publish it with one index
+ * commit. The stage is released whether or not the commit succeeds.
+ *
+ * @param members_out Receives the imported members (free with
+ * vault_archive_free_members)
+ * @param count_out Receives the number of members
+ * @param skipped_out Receives the number of members not imported
+ * @return VAULT_OK on success, VAULT_ERR_INVALID_PARAM when nothing is
+ * staged, VAULT_ERR_NOT_OPEN when the staging vault is no longer open
+ */
+int vault_archive_commit(vault_archive_member_t **members_out,
+                         uint32_t *count_out, uint32_t *skipped_out);
+
+/**
+ * Release a staged import that will not be committed (no-op if none).
+ */
+void vault_archive_discard(void);
+
+/**
+ * Stage and commit in one call.
+ */
+int vault_import_archive(int fd, vault_archive_member_t **members_out,
+                         uint32_t *count_out, uint32_t *skipped_out);
+
+/**
+ * Free members returned by vault_archive_commit.
+ */
+void vault_archive_free_members(vault_archive_member_t *members,
+                                uint32_t count);
+
+/**
+ * Source bytes consumed by the running (or last) archive import, for
+ * progress reporting from another thread.
+ */
+uint64_t vault_archive_bytes_read(void);
+
+#define VAULT_ARCHIVE_FORMAT_ZIP 0
+#define VAULT_ARCHIVE_FORMAT_TAR 1
+
+typedef struct {
+  uint8_t file_id[VAULT_ID_LEN];
+  const char *path; // member path inside the archive, '/' separated
+} vault_export_item_t;
+
+/**
+ * Write entries as one archive. Members are stored without compression,
+ * since vault content is mostly media that is compressed already. On a
+ * seekable descriptor ZIP headers are patched with the final CRC; on a pipe
+ * each ZIP member is followed by a data descriptor instead.
+ * @param fd Destination, written from its current position (not closed)
+ * @param items Entries and their paths, in archive order
+ * @param count Number of items
+ * @param format VAULT_ARCHIVE_FORMAT_ZIP or VAULT_ARCHIVE_FORMAT_TAR
+ * @return VAULT_OK on success, VAULT_ERR_NOT_FOUND for an unknown ID
+ */
+int vault_export_archive(int fd, const vault_export_item_t *items,
+                         uint32_t count, int format);
+
+/**
+ * The two halves of vault_export_archive. Prepare clones the selected
+ * entries from the live index (call it under the vault lock); write then
+ * streams that snapshot without touching the index, and releases it
+ * whether or not it succeeds. One prepared export is kept at a time.
+ * @return VAULT_OK on success; write returns VAULT_ERR_INVALID_PARAM when
+ * nothing is prepared
+ */
+int vault_export_prepare(const vault_export_item_t *items, uint32_t count);
+int vault_export_write(int fd, int format);
+
+/**
+ * Release a prepared export that will not be written (no-op if none).
+ */
+void vault_export_discard(void);
+
+/**
+ * Plaintext bytes written by the running (or last) archive export.
+ */
+uint64_t vault_archive_bytes_written(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VAULT_ARCHIVE_H
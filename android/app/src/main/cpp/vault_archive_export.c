@@ -0,0 +1,835 @@
+/**
+ * NoLeak Vault Engine - Archive Export Implementation
+ *
+ * Every member is split into units (one per chunk, or one for a single-blob
+ * entry). Worker threads claim units in archive order and decrypt them into
+ * a small ring of slots; the calling thread writes the slots out in the same
+ * order, framing each member with its ZIP or TAR headers. A worker never
+ * runs more than the ring size ahead of the writer, so plaintext in memory
+ * stays bounded by a few chunks however large the selection is.
+ *
+ * Members are stored uncompressed. ZIP headers record the known size up
+ * front; the CRC is patched into the local header afterwards when the
+ * descriptor is seekable and otherwise follows the data in a descriptor.
+ *
+ * The selection is cloned from the live index first, so the caller's vault
+ * lock is only needed for that step: commits that replace the index while
+ * the archive is written leave the snapshot intact. Moving committed
+ * ciphertext (compaction, tiering) still has to wait for the export.
+ */
+
+#include "vault_archive.h"
+#include "vault_governor.h"
+#include <android/log.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#define LOG_TAG "VaultArchive"
+
+#ifdef NDEBUG
+#define LOGI(...) ((void)0)
+#define LOGE(...) ((void)0)
+#else
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#endif
+
+#define EXPORT_MAX_THREADS 4
+#define EXPORT_MAX_PATH 4096
+
+#define ZIP_LOCAL_SIG 0x04034b50u
+#define ZIP_CENTRAL_SIG 0x02014b50u
+#define ZIP_END_SIG 0x06054b50u
+#define ZIP64_END_SIG 0x06064b50u
+#define ZIP64_LOCATOR_SIG 0x07064b50u
+#define ZIP_DESCRIPTOR_SIG 0x08074b50u
+#define ZIP_FLAG_DESCRIPTOR 0x0008
+#define ZIP_FLAG_UTF8 0x0800
+#define ZIP_EXTRA_ZIP64 0x0001
+#define ZIP_VERSION 20
+#define ZIP64_VERSION 45
+#define ZIP_MADE_BY_UNIX 3
+#define ZIP32_LIMIT 0xFFFFFFFFull
+
+#define TAR_BLOCK 512
+#define TAR_MAX_SIZE 077777777777ull // 11 octal digits
+
+extern vault_state_t g_vault;
+extern int vault_decrypt_entry_blob(const vault_entry_t *entry,
+                                    uint8_t **data_out, size_t *len_out);
+extern int vault_decrypt_entry_chunk(const vault_entry_t *entry,
+                                     uint32_t chunk_idx, uint8_t **data_out,
+                                     size_t *len_out);
+extern int clone_entries(const vault_entry_t *source, uint32_t count,
+                         vault_entry_t **dest_out);
+extern void free_entries_array(vault_entry_t *entries, uint32_t count);
+
+static _Atomic uint64_t g_archive_bytes_written;
+
+typedef struct {
+  const vault_entry_t *entry;
+  char *path;
+  uint32_t unit_count;
+  uint64_t header_offset;
+  uint32_t crc;
+  uint16_t dos_time;
+  uint16_t dos_date;
+  int zip64;
+} export_member_t;
+
+typedef struct {
+  const vault_entry_t *entry;
+  uint32_t chunk;
+} export_unit_t;
+
+typedef struct {
+  uint8_t *data;
+  size_t len;
+  uint32_t crc;
+  int result;
+  int ready;
+} export_slot_t;
+
+typedef struct {
+  const export_unit_t *units;
+  uint32_t unit_count;
+  export_slot_t slots[EXPORT_MAX_THREADS + 2];
+  uint32_t window;
+  uint32_t next_unit; // next unit a worker claims
+  uint32_t consumed;  // units taken by the writer
+  int abort;
+  pthread_mutex_t lock;
+  pthread_cond_t ready_cond;
+  pthread_cond_t space_cond;
+} export_pipeline_t;
+
+typedef struct {
+  int fd;
+  off_t base;      // descriptor position at the start, -1 if not seekable
+  uint64_t offset; // archive bytes written
+  vault_pace_t pace;
+} export_out_t;
+
+static void put_le16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_le32(uint8_t *p, uint32_t v) {
+  put_le16(p, (uint16_t)v);
+  put_le16(p + 2, (uint16_t)(v >> 16));
+}
+
+static void put_le64(uint8_t *p, uint64_t v) {
+  put_le32(p, (uint32_t)v);
+  put_le32(p + 4, (uint32_t)(v >> 32));
+}
+
+// ============================================================================
+// Output
+// ============================================================================
+
+static int out_write(export_out_t *out, const uint8_t *data, size_t len) {
+  while (len > 0) {
+    ssize_t n = write(out->fd, data, len);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return VAULT_ERR_IO;
+    data += n;
+    len -= (size_t)n;
+    out->offset += (uint64_t)n;
+    vault_governor_pace(&out->pace, (uint64_t)n);
+  }
+  return VAULT_OK;
+}
+
+static int out_patch(export_out_t *out, uint64_t at, const uint8_t *data,
+                     size_t len) {
+  off_t pos = out->base + (off_t)at;
+  while (len > 0) {
+    ssize_t n = pwrite(out->fd, data, len, pos);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return VAULT_ERR_IO;
+    data += n;
+    len -= (size_t)n;
+    pos += n;
+  }
+  return VAULT_OK;
+}
+
+static int out_zero_pad(export_out_t *out, uint64_t size) {
+  static const uint8_t zeros[TAR_BLOCK];
+  size_t pad = (size_t)((TAR_BLOCK - size % TAR_BLOCK) % TAR_BLOCK);
+  return pad > 0 ? out_write(out, zeros, pad) : VAULT_OK;
+}
+
+// ============================================================================
+// Paths
+// ============================================================================
+
+// Entry names come through JNI as modified UTF-8; characters outside the BMP
+// arrive as an encoded surrogate pair. Returns the code point of such a pair
+// at p, or 0.
+static uint32_t surrogate_pair_at(const uint8_t *p, size_t n) {
+  if (n < 6 || p[0] != 0xED || (p[1] & 0xF0) != 0xA0 ||
+      (p[2] & 0xC0) != 0x80 || p[3] != 0xED || (p[4] & 0xF0) != 0xB0 ||
+      (p[5] & 0xC0) != 0x80)
+    return 0;
+  uint32_t high = 0xD000 | ((uint32_t)(p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+  uint32_t low = 0xD000 | ((uint32_t)(p[4] & 0x3F) << 6) | (p[5] & 0x3F);
+  return 0x10000 + ((high - 0xD800) << 10) + (low - 0xDC00);
+}
+
+// Normalize a member path: '/' separated, no empty, "." or ".." components,
+// no control characters, standard UTF-8.
+static char *export_clean_path(const char *path) {
+  size_t len = strlen(path);
+  if (len == 0 || len > EXPORT_MAX_PATH)
+    return NULL;
+  char *clean = malloc(len + 1);
+  if (!clean)
+    return NULL;
+  size_t out = 0;
+  const uint8_t *p = (const uint8_t *)path;
+  const uint8_t *end = p + len;
+  while (p < end) {
+    const uint8_t *seg = p;
+    while (p < end && *p != '/')
+      p++;
+    size_t seg_len = (size_t)(p - seg);
+    if (p < end)
+      p++;
+    if (seg_len == 0 || (seg_len == 1 && seg[0] == '.') ||
+        (seg_len == 2 && seg[0] == '.' && seg[1] == '.'))
+      continue;
+    if (out > 0)
+      clean[out++] = '/';
+    for (size_t i = 0; i < seg_len;) {
+      uint32_t cp = surrogate_pair_at(seg + i, seg_len - i);
+      if (cp) {
+        clean[out++] = (char)(0xF0 | (cp >> 18));
+        clean[out++] = (char)(0x80 | ((cp >> 12) & 0x3F));
+        clean[out++] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        clean[out++] = (char)(0x80 | (cp & 0x3F));
+        i += 6;
+      } else if (seg[i] < 0x20 || seg[i] == 0x7F || seg[i] == '\\') {
+        clean[out++] = '_';
+        i++;
+      } else {
+        clean[out++] = (char)seg[i++];
+      }
+    }
+  }
+  if (out == 0) {
+    free(clean);
+    return NULL;
+  }
+  clean[out] = '\0';
+  return clean;
+}
+
+// ============================================================================
+// Decrypt pipeline
+// ============================================================================
+
+static void export_decrypt_unit(const export_unit_t *unit, export_slot_t *slot) {
+  const vault_entry_t *entry = unit->entry;
+  uint8_t *data = NULL;
+  size_t len = 0;
+  // Exports read every file once; counting that as access would keep the
+  // whole selection out of the cold tier.
+  int result = entry->chunk_count > 0
+                   ? vault_decrypt_entry_chunk(entry, unit->chunk, &data, &len)
+                   : vault_decrypt_entry_blob(entry, &data, &len);
+  slot->result = result;
+  slot->data = result == VAULT_OK ? data : NULL;
+  slot->len = result == VAULT_OK ? len : 0;
+  slot->crc = result == VAULT_OK
+                  ? (uint32_t)crc32(crc32(0L, Z_NULL, 0), data, (uInt)len)
+                  : 0;
+}
+
+static void *export_worker(void *arg) {
+  export_pipeline_t *p = arg;
+  pthread_mutex_lock(&p->lock);
+  for (;;) {
+    // The slot for unit u is free once the writer took unit u - window.
+    while (!p->abort && p->next_unit < p->unit_count &&
+           p->next_unit >= p->consumed + p->window)
+      pthread_cond_wait(&p->space_cond, &p->lock);
+    if (p->abort || p->next_unit >= p->unit_count)
+      break;
+    uint32_t u = p->next_unit++;
+    pthread_mutex_unlock(&p->lock);
+
+    export_slot_t slot = {0};
+    export_decrypt_unit(&p->units[u], &slot);
+    slot.ready = 1;
+
+    pthread_mutex_lock(&p->lock);
+    p->slots[u % p->window] = slot;
+    pthread_cond_broadcast(&p->ready_cond);
+  }
+  pthread_mutex_unlock(&p->lock);
+  return NULL;
+}
+
+// Hand the next unit to the writer in archive order; the caller owns data.
+static int pipeline_take(export_pipeline_t *p, export_slot_t *out) {
+  pthread_mutex_lock(&p->lock);
+  export_slot_t *slot = &p->slots[p->consumed % p->window];
+  while (!slot->ready)
+    pthread_cond_wait(&p->ready_cond, &p->lock);
+  *out = *slot;
+  memset(slot, 0, sizeof(*slot));
+  p->consumed++;
+  pthread_cond_broadcast(&p->space_cond);
+  pthread_mutex_unlock(&p->lock);
+  return out->result;
+}
+
+static void slot_release(export_slot_t *slot) {
+  if (slot->data) {
+    vault_zeroize(slot->data, slot->len);
+    free(slot->data);
+  }
+  memset(slot, 0, sizeof(*slot));
+}
+
+// Write a member's data and return its CRC.
+static int export_member_data(export_out_t *out, export_pipeline_t *p,
+                              export_member_t *m) {
+  uint32_t crc = (uint32_t)crc32(0L, Z_NULL, 0);
+  uint64_t written = 0;
+  for (uint32_t i = 0; i < m->unit_count; i++) {
+    export_slot_t slot;
+    int result = pipeline_take(p, &slot);
+    if (result == VAULT_OK && written + slot.len > m->entry->size)
+      result = VAULT_ERR_CORRUPTED;
+    if (result == VAULT_OK)
+      result = out_write(out, slot.data, slot.len);
+    if (result == VAULT_OK) {
+      crc = (uint32_t)crc32_combine(crc, slot.crc, (z_off_t)slot.len);
+      written += slot.len;
+      atomic_fetch_add(&g_archive_bytes_written, slot.len);
+    }
+    slot_release(&slot);
+    if (result != VAULT_OK)
+      return result;
+  }
+  // The header already announced entry->size bytes.
+  if (written != m->entry->size)
+    return VAULT_ERR_CORRUPTED;
+  m->crc = crc;
+  return VAULT_OK;
+}
+
+// ============================================================================
+// ZIP
+// ============================================================================
+
+static void zip_dos_time(uint64_t created_ms, uint16_t *time_out,
+                         uint16_t *date_out) {
+  time_t t = (time_t)(created_ms / 1000);
+  struct tm tm;
+  if (!localtime_r(&t, &tm) || tm.tm_year < 80) {
+    *time_out = 0;
+    *date_out = (1 << 5) | 1; // 1980-01-01
+    return;
+  }
+  *time_out =
+      (uint16_t)((tm.tm_hour << 11) | (tm.tm_min << 5) | (tm.tm_sec / 2));
+  *date_out = (uint16_t)(((tm.tm_year - 80) << 9) | ((tm.tm_mon + 1) << 5) |
+                         tm.tm_mday);
+}
+
+static int zip_write_member(export_out_t *out, export_pipeline_t *p,
+                            export_member_t *m) {
+  size_t name_len = strlen(m->path);
+  uint64_t size = m->entry->size;
+  int streamed = out->base < 0;
+  m->zip64 = size >= ZIP32_LIMIT;
+  m->header_offset = out->offset;
+  zip_dos_time(m->entry->created_at, &m->dos_time, &m->dos_date);
+
+  uint8_t header[30 + EXPORT_MAX_PATH + 20];
+  uint32_t size32 = m->zip64 ? (uint32_t)ZIP32_LIMIT : (uint32_t)size;
+  put_le32(header, ZIP_LOCAL_SIG);
+  put_le16(header + 4, m->zip64 ? ZIP64_VERSION : ZIP_VERSION);
+  put_le16(header + 6, ZIP_FLAG_UTF8 | (streamed ? ZIP_FLAG_DESCRIPTOR : 0));
+  put_le16(header + 8, 0); // stored
+  put_le16(header + 10, m->dos_time);
+  put_le16(header + 12, m->dos_date);
+  put_le32(header + 14, 0); // CRC, patched or in the descriptor
+  // Sizes are known up front even when streaming; keeping them lets
+  // forward-only readers find the end of a stored member.
+  put_le32(header + 18, size32);
+  put_le32(header + 22, size32);
+  put_le16(header + 26, (uint16_t)name_len);
+  put_le16(header + 28, m->zip64 ? 20 : 0);
+  memcpy(header + 30, m->path, name_len);
+  size_t header_len = 30 + name_len;
+  if (m->zip64) {
+    put_le16(header + header_len, ZIP_EXTRA_ZIP64);
+    put_le16(header + header_len + 2, 16);
+    put_le64(header + header_len + 4, size);
+    put_le64(header + header_len + 12, size);
+    header_len += 20;
+  }
+  int result = out_write(out, header, header_len);
+  if (result == VAULT_OK)
+    result = export_member_data(out, p, m);
+  if (result != VAULT_OK)
+    return result;
+
+  uint8_t trailer[24];
+  put_le32(trailer, m->crc);
+  if (!streamed)
+    return out_patch(out, m->header_offset + 14, trailer, 4);
+  put_le32(trailer, ZIP_DESCRIPTOR_SIG);
+  put_le32(trailer + 4, m->crc);
+  if (m->zip64) {
+    put_le64(trailer + 8, size);
+    put_le64(trailer + 16, size);
+    return out_write(out, trailer, 24);
+  }
+  put_le32(trailer + 8, (uint32_t)size);
+  put_le32(trailer + 12, (uint32_t)size);
+  return out_write(out, trailer, 16);
+}
+
+static int zip_write_central(export_out_t *out, const export_member_t *members,
+                             uint32_t count) {
+  uint64_t cd_start = out->offset;
+  uint8_t header[46 + EXPORT_MAX_PATH + 28];
+  for (uint32_t i = 0; i < count; i++) {
+    const export_member_t *m = &members[i];
+    size_t name_len = strlen(m->path);
+    uint64_t size = m->entry->size;
+    int big_offset = m->header_offset >= ZIP32_LIMIT;
+    uint16_t extra_len = (uint16_t)((m->zip64 ? 16 : 0) + (big_offset ? 8 : 0));
+    uint16_t version = m->zip64 || big_offset ? ZIP64_VERSION : ZIP_VERSION;
+    uint32_t size32 = m->zip64 ? (uint32_t)ZIP32_LIMIT : (uint32_t)size;
+    uint16_t flags = ZIP_FLAG_UTF8 | (out->base < 0 ? ZIP_FLAG_DESCRIPTOR : 0);
+
+    put_le32(header, ZIP_CENTRAL_SIG);
+    put_le16(header + 4, (uint16_t)((ZIP_MADE_BY_UNIX << 8) | version));
+    put_le16(header + 6, version);
+    put_le16(header + 8, flags);
+    put_le16(header + 10, 0); // stored
+    put_le16(header + 12, m->dos_time);
+    put_le16(header + 14, m->dos_date);
+    put_le32(header + 16, m->crc);
+    put_le32(header + 20, size32);
+    put_le32(header + 24, size32);
+    put_le16(header + 28, (uint16_t)name_len);
+    put_le16(header + 30, extra_len > 0 ? (uint16_t)(extra_len + 4) : 0);
+    put_le16(header + 32, 0); // comment
+    put_le16(header + 34, 0); // disk
+    put_le16(header + 36, 0); // internal attributes
+    put_le32(header + 38, 0100644u << 16);
+    put_le32(header + 42, big_offset ? (uint32_t)ZIP32_LIMIT
+                                     : (uint32_t)m->header_offset);
+    memcpy(header + 46, m->path, name_len);
+    size_t header_len = 46 + name_len;
+    if (extra_len > 0) {
+      put_le16(header + header_len, ZIP_EXTRA_ZIP64);
+      put_le16(header + header_len + 2, extra_len);
+      header_len += 4;
+      if (m->zip64) {
+        put_le64(header + header_len, size);
+        put_le64(header + header_len + 8, size);
+        header_len += 16;
+      }
+      if (big_offset) {
+        put_le64(header + header_len, m->header_offset);
+        header_len += 8;
+      }
+    }
+    int result = out_write(out, header, header_len);
+    if (result != VAULT_OK)
+      return result;
+  }
+
+  uint64_t cd_size = out->offset - cd_start;
+  uint8_t end[56 + 20 + 22];
+  size_t end_len = 0;
+  int zip64_end = count >= 0xFFFF || cd_start >= ZIP32_LIMIT ||
+                  cd_size >= ZIP32_LIMIT;
+  if (zip64_end) {
+    uint64_t record_offset = out->offset;
+    put_le32(end, ZIP64_END_SIG);
+    put_le64(end + 4, 44); // record size after this field
+    put_le16(end + 12, (ZIP_MADE_BY_UNIX << 8) | ZIP64_VERSION);
+    put_le16(end + 14, ZIP64_VERSION);
+    put_le32(end + 16, 0);
+    put_le32(end + 20, 0);
+    put_le64(end + 24, count);
+    put_le64(end + 32, count);
+    put_le64(end + 40, cd_size);
+    put_le64(end + 48, cd_start);
+    put_le32(end + 56, ZIP64_LOCATOR_SIG);
+    put_le32(end + 60, 0);
+    put_le64(end + 64, record_offset);
+    put_le32(end + 72, 1);
+    end_len = 76;
+  }
+  uint8_t *eocd = end + end_len;
+  uint16_t count16 = count >= 0xFFFF ? 0xFFFF : (uint16_t)count;
+  put_le32(eocd, ZIP_END_SIG);
+  put_le16(eocd + 4, 0);
+  put_le16(eocd + 6, 0);
+  put_le16(eocd + 8, count16);
+  put_le16(eocd + 10, count16);
+  put_le32(eocd + 12, zip64_end ? (uint32_t)ZIP32_LIMIT : (uint32_t)cd_size);
+  put_le32(eocd + 16, zip64_end ? (uint32_t)ZIP32_LIMIT : (uint32_t)cd_start);
+  put_le16(eocd + 20, 0); // comment
+  return out_write(out, end, end_len + 22);
+}
+
+// ============================================================================
+// TAR
+// ============================================================================
+
+static int tar_write_header(export_out_t *out, const char *prefix,
+                            size_t prefix_len, const char *name,
+                            size_t name_len, uint64_t size, uint64_t mtime,
+                            char type) {
+  uint8_t block[TAR_BLOCK];
+  memset(block, 0, sizeof(block));
+  memcpy(block, name, name_len);
+  snprintf((char *)block + 100, 8, "%07o", 0644);
+  snprintf((char *)block + 108, 8, "%07o", 0);
+  snprintf((char *)block + 116, 8, "%07o", 0);
+  snprintf((char *)block + 124, 12, "%011llo",
+           (unsigned long long)(size > TAR_MAX_SIZE ? 0 : size));
+  snprintf((char *)block + 136, 12, "%011llo",
+           (unsigned long long)(mtime > TAR_MAX_SIZE ? TAR_MAX_SIZE : mtime));
+  memset(block + 148, ' ', 8);
+  block[156] = (uint8_t)type;
+  memcpy(block + 257, "ustar", 6);
+  memcpy(block + 263, "00", 2);
+  memcpy(block + 345, prefix, prefix_len);
+  unsigned sum = 0;
+  for (size_t i = 0; i < TAR_BLOCK; i++)
+    sum += block[i];
+  snprintf((char *)block + 148, 8, "%06o", sum);
+  block[155] = ' ';
+  return out_write(out, block, TAR_BLOCK);
+}
+
+// Append "<len> key=value\n", where len counts the whole record.
+static size_t pax_record(char *dst, const char *key, const char *value) {
+  size_t base = strlen(key) + strlen(value) + 3; // ' ', '=', '\n'
+  size_t len = base + 1;
+  for (;;) {
+    int digits = snprintf(NULL, 0, "%zu", len);
+    if (base + (size_t)digits == len)
+      break;
+    len = base + (size_t)digits;
+  }
+  if (dst)
+    snprintf(dst, len + 1, "%zu %s=%s\n", len, key, value);
+  return len;
+}
+
+static int tar_write_member(export_out_t *out, export_pipeline_t *p,
+                            export_member_t *m) {
+  const char *path = m->path;
+  size_t len = strlen(path);
+  uint64_t size = m->entry->size;
+  uint64_t mtime = m->entry->created_at / 1000;
+
+  // ustar keeps up to 155 bytes of directories in the prefix field.
+  const char *prefix = "";
+  size_t prefix_len = 0;
+  const char *name = path;
+  size_t name_len = len;
+  if (len > 100) {
+    const char *split = NULL;
+    for (const char *s = path; s < path + len && s - path <= 155; s++) {
+      if (*s == '/')
+        split = s;
+    }
+    if (split && path + len - split - 1 <= 100 && split[1] != '\0') {
+      prefix = path;
+      prefix_len = (size_t)(split - path);
+      name = split + 1;
+      name_len = len - prefix_len - 1;
+    } else {
+      name_len = 0;
+    }
+  }
+
+  int result = VAULT_OK;
+  if (name_len == 0 || size > TAR_MAX_SIZE) {
+    char size_text[24];
+    snprintf(size_text, sizeof(size_text), "%llu", (unsigned long long)size);
+    size_t records_len = (name_len == 0 ? pax_record(NULL, "path", path) : 0) +
+                         (size > TAR_MAX_SIZE
+                              ? pax_record(NULL, "size", size_text)
+                              : 0);
+    char *records = malloc(records_len + 1);
+    if (!records)
+      return VAULT_ERR_MEMORY;
+    size_t at = 0;
+    if (name_len == 0)
+      at += pax_record(records + at, "path", path);
+    if (size > TAR_MAX_SIZE)
+      pax_record(records + at, "size", size_text);
+    result = tar_write_header(out, "", 0, "PaxHeader", 9, records_len, mtime,
+                              'x');
+    if (result == VAULT_OK)
+      result = out_write(out, (const uint8_t *)records, records_len);
+    if (result == VAULT_OK)
+      result = out_zero_pad(out, records_len);
+    free(records);
+    if (result != VAULT_OK)
+      return result;
+    if (name_len == 0) {
+      // Readers without pax support still get the file name.
+      const char *slash = strrchr(path, '/');
+      name = slash ? slash + 1 : path;
+      name_len = strlen(name) > 100 ? 100 : strlen(name);
+    }
+  }
+
+  result = tar_write_header(out, prefix, prefix_len, name, name_len, size,
+                            mtime, '0');
+  if (result == VAULT_OK)
+    result = export_member_data(out, p, m);
+  if (result == VAULT_OK)
+    result = out_zero_pad(out, size);
+  return result;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+uint64_t vault_archive_bytes_written(void) {
+  return atomic_load(&g_archive_bytes_written);
+}
+
+// The selection cloned by vault_export_prepare, awaiting its write
+typedef struct {
+  vault_entry_t *entries;
+  export_member_t *members;
+  uint32_t count;
+} export_snapshot_t;
+
+static export_snapshot_t *g_export;
+
+static const vault_entry_t *find_entry(const uint8_t file_id[VAULT_ID_LEN]) {
+  for (uint32_t i = 0; i < g_vault.entry_count; i++) {
+    if (memcmp(g_vault.entries[i].file_id, file_id, VAULT_ID_LEN) == 0)
+      return &g_vault.entries[i];
+  }
+  return NULL;
+}
+
+static void snapshot_free(export_snapshot_t *snap) {
+  if (!snap)
+    return;
+  for (uint32_t i = 0; i < snap->count; i++) {
+    if (snap->members[i].path) {
+      vault_zeroize(snap->members[i].path, strlen(snap->members[i].path));
+      free(snap->members[i].path);
+    }
+  }
+  free(snap->members);
+  free_entries_array(snap->entries, snap->count);
+  free(snap);
+}
+
+int vault_export_prepare(const vault_export_item_t *items, uint32_t count) {
+  if (!g_vault.is_open)
+    return VAULT_ERR_NOT_OPEN;
+  if (!items || count == 0)
+    return VAULT_ERR_INVALID_PARAM;
+  vault_export_discard();
+
+  export_snapshot_t *snap = calloc(1, sizeof(*snap));
+  if (!snap)
+    return VAULT_ERR_MEMORY;
+  snap->entries = calloc(count, sizeof(vault_entry_t));
+  snap->members = calloc(count, sizeof(export_member_t));
+  if (!snap->entries || !snap->members) {
+    snapshot_free(snap);
+    return VAULT_ERR_MEMORY;
+  }
+
+  int result = VAULT_OK;
+  for (uint32_t i = 0; i < count && result == VAULT_OK; i++) {
+    const vault_entry_t *live = find_entry(items[i].file_id);
+    if (!live) {
+      result = VAULT_ERR_NOT_FOUND;
+      break;
+    }
+    vault_entry_t *copy = NULL;
+    result = clone_entries(live, 1, &copy);
+    if (result != VAULT_OK)
+      break;
+    snap->entries[i] = copy[0];
+    free(copy);
+    snap->count = i + 1;
+    snap->members[i].entry = &snap->entries[i];
+    snap->members[i].path =
+        items[i].path ? export_clean_path(items[i].path) : NULL;
+    if (!snap->members[i].path)
+      result = VAULT_ERR_INVALID_PARAM;
+  }
+  if (result != VAULT_OK) {
+    snapshot_free(snap);
+    return result;
+  }
+  g_export = snap;
+  return VAULT_OK;
+}
+
+void vault_export_discard(void) {
+  snapshot_free(g_export);
+  g_export = NULL;
+}
+
+int vault_export_write(int fd, int format) {
+  export_snapshot_t *snap = g_export;
+  if (!snap)
+    return VAULT_ERR_INVALID_PARAM;
+  g_export = NULL;
+  if (!g_vault.is_open) {
+    snapshot_free(snap);
+    return VAULT_ERR_NOT_OPEN;
+  }
+  if (fd < 0 || (format != VAULT_ARCHIVE_FORMAT_ZIP &&
+                 format != VAULT_ARCHIVE_FORMAT_TAR)) {
+    snapshot_free(snap);
+    return VAULT_ERR_INVALID_PARAM;
+  }
+  atomic_store(&g_archive_bytes_written, 0);
+
+  export_member_t *members = snap->members;
+  uint32_t count = snap->count;
+  int result = VAULT_OK;
+  uint64_t unit_total = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    const vault_entry_t *entry = members[i].entry;
+    members[i].unit_count =
+        entry->chunk_count > 0 ? entry->chunk_count : (entry->size > 0 ? 1 : 0);
+    unit_total += members[i].unit_count;
+  }
+  if (unit_total > UINT32_MAX)
+    result = VAULT_ERR_INVALID_PARAM;
+
+  export_unit_t *units = NULL;
+  if (result == VAULT_OK && unit_total > 0) {
+    units = malloc((size_t)unit_total * sizeof(export_unit_t));
+    if (!units)
+      result = VAULT_ERR_MEMORY;
+  }
+  if (result != VAULT_OK) {
+    snapshot_free(snap);
+    return result;
+  }
+  uint32_t u = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    for (uint32_t c = 0; c < members[i].unit_count; c++) {
+      units[u].entry = members[i].entry;
+      units[u].chunk = c;
+      u++;
+    }
+  }
+
+  export_pipeline_t pipeline;
+  memset(&pipeline, 0, sizeof(pipeline));
+  pipeline.units = units;
+  pipeline.unit_count = (uint32_t)unit_total;
+  pthread_mutex_init(&pipeline.lock, NULL);
+  pthread_cond_init(&pipeline.ready_cond, NULL);
+  pthread_cond_init(&pipeline.space_cond, NULL);
+
+  uint32_t thread_count =
+      vault_governor_workers(VAULT_JOB_EXPORT, EXPORT_MAX_THREADS);
+  if (thread_count > pipeline.unit_count)
+    thread_count = pipeline.unit_count;
+  // Two spare slots keep the writer from idling while workers decrypt.
+  pipeline.window = thread_count + 2;
+
+  // The calling thread writes; all decryption runs on the workers.
+  pthread_t threads[EXPORT_MAX_THREADS];
+  uint32_t started = 0;
+  uint64_t begin_ns = vault_governor_now_ns();
+  for (uint32_t t = 0; t < thread_count; t++) {
+    if (pthread_create(&threads[started], NULL, export_worker, &pipeline) != 0)
+      break;
+    started++;
+  }
+  if (started == 0 && pipeline.unit_count > 0)
+    result = VAULT_ERR_MEMORY;
+
+  export_out_t out = {.fd = fd, .base = lseek(fd, 0, SEEK_CUR), .offset = 0};
+  for (uint32_t i = 0; i < count && result == VAULT_OK; i++) {
+    result = format == VAULT_ARCHIVE_FORMAT_ZIP
+                 ? zip_write_member(&out, &pipeline, &members[i])
+                 : tar_write_member(&out, &pipeline, &members[i]);
+  }
+  if (result == VAULT_OK) {
+    if (format == VAULT_ARCHIVE_FORMAT_ZIP) {
+      result = zip_write_central(&out, members, count);
+    } else {
+      static const uint8_t end_blocks[TAR_BLOCK * 2];
+      result = out_write(&out, end_blocks, sizeof(end_blocks));
+    }
+  }
+  // Some providers hand out descriptors that cannot be synced; only a
+  // reported I/O error fails the export.
+  if (result == VAULT_OK && out.base >= 0 && fsync(fd) != 0 && errno == EIO)
+    result = VAULT_ERR_IO;
+
+  pthread_mutex_lock(&pipeline.lock);
+  pipeline.abort = 1;
+  pthread_cond_broadcast(&pipeline.space_cond);
+  pthread_mutex_unlock(&pipeline.lock);
+  for (uint32_t t = 0; t < started; t++)
+    pthread_join(threads[t], NULL);
+  for (uint32_t s = 0; s < pipeline.window; s++)
+    slot_release(&pipeline.slots[s]);
+  pthread_cond_destroy(&pipeline.space_cond);
+  pthread_cond_destroy(&pipeline.ready_cond);
+  pthread_mutex_destroy(&pipeline.lock);
+
+  if (result == VAULT_OK) {
+    vault_governor_report(VAULT_JOB_EXPORT, started, out.offset,
+                          vault_governor_now_ns() - begin_ns);
+    LOGI("vault_export_archive: %u members, %llu bytes", count,
+         (unsigned long long)out.offset);
+  } else {
+    LOGE("vault_export_archive: failed with %d", result);
+  }
+  snapshot_free(snap);
+  free(units);
+  return result;
+}
+
+int vault_export_archive(int fd, const vault_export_item_t *items,
+                         uint32_t count, int format) {
+  if (!g_vault.is_open)
+    return VAULT_ERR_NOT_OPEN;
+  if (fd < 0 || (format != VAULT_ARCHIVE_FORMAT_ZIP &&
+                 format != VAULT_ARCHIVE_FORMAT_TAR))
+    return VAULT_ERR_INVALID_PARAM;
+  int result = vault_export_prepare(items, count);
+  if (result != VAULT_OK)
+    return result;
+  return vault_export_write(fd, format);
+}
@@ -8,6 +8,9 @@
  */
 
 #include "vault_engine.h"
+#include "vault_layout.h"
+#include "vault_search.h"
+#include "vault_tier.h"
 #include <android/log.h>
 #include <errno.h>
 #include <fcntl.h>
@@ -17,6 +20,7 @@
 #include <string.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <zlib.h>
 
 #define LOG_TAG "VaultContainer"
 
@@ -44,6 +48,11 @@ static int serialize_index(const vault_entry_t *entries, uint32_t count,
                            uint8_t **out, size_t *len_out);
 static int deserialize_index(const uint8_t *data, size_t len,
                              vault_entry_t **entries_out, uint32_t *count_out);
+static int serialize_index_compact(const vault_entry_t *entries, uint32_t count,
+                                   uint8_t **out, size_t *len_out);
+static int deserialize_log_index(const uint8_t *data, size_t len,
+                                 vault_entry_t **entries_out,
+                                 uint32_t *count_out);
 static void free_entries_array(vault_entry_t *entries, uint32_t count);
 static int validate_kdf_params(uint32_t mem_limit, uint32_t iterations,
                                uint32_t parallel);
@@ -54,6 +63,9 @@ static int migrate_journal_to_v1(const char *path, size_t old_header_size,
 static int migrate_active_to_log(const char *path);
 extern int clone_entries(const vault_entry_t *source, uint32_t count,
                          vault_entry_t **dest_out);
+extern void vault_stats_add_entry(const vault_entry_t *entry);
+extern void vault_stats_remove_entry(const vault_entry_t *entry);
+extern void vault_stats_rebuild(void);
 
 // Header structure (binary layout)
 #pragma pack(push, 1)
@@ -77,7 +89,17 @@ typedef struct {
 #define VAULT_JOURNAL_MAGIC "VAULTJ1"
 #define VAULT_JOURNAL_SLOT_COUNT 2
 #define VAULT_INDEX_PAD_FLAG 0x80000000u
-#define VAULT_INDEX_COUNT_MASK 0x7FFFFFFFu
+// Set when every entry is followed by u32 ext_len + extension records
+#define VAULT_INDEX_EXT_FLAG 0x40000000u
+#define VAULT_INDEX_COUNT_MASK 0x3FFFFFFFu
+// Compact index encoding used by log containers. The magic read as a u32
+// exceeds any legal legacy entry count, so the two layouts cannot collide.
+#define VAULT_INDEX_COMPACT_MAGIC "VIX2"
+#define VAULT_INDEX_COMPACT_MAGIC_LEN 4
+#define VAULT_INDEX_COMPACT_DEFLATE 0x01u
+#define VAULT_INDEX_MAX_ENTRIES 1000000u
+#define VAULT_INDEX_MAX_PLAINTEXT (100u * 1024u * 1024u)
+#define VAULT_INDEX_MIME_DICT_MAX 64u
 #define VAULT_CONTAINER_V1 1u
 #define VAULT_CONTAINER_LOG 2u
 #define VAULT_CONTAINER_LOG_LEGACY 3u
@@ -249,7 +271,8 @@ static int journal_select_slot(int fd, const vault_journal_super_t *super,
   return VAULT_OK;
 }
 
-static int read_all_at(int fd, void *buffer, size_t len, uint64_t offset) {
+// EINTR-safe positional I/O; also used by vault_tier.c
+int read_all_at(int fd, void *buffer, size_t len, uint64_t offset) {
   uint8_t *cursor = (uint8_t *)buffer;
   while (len > 0) {
     ssize_t n = pread(fd, cursor, len, (off_t)offset);
@@ -278,8 +301,7 @@ static int write_all(int fd, const void *buffer, size_t len) {
   return VAULT_OK;
 }
 
-static int write_all_at(int fd, const void *buffer, size_t len,
-                        uint64_t offset) {
+int write_all_at(int fd, const void *buffer, size_t len, uint64_t offset) {
   const uint8_t *cursor = (const uint8_t *)buffer;
   while (len > 0) {
     ssize_t n = pwrite(fd, cursor, len, (off_t)offset);
@@ -679,6 +701,14 @@ static int ensure_capacity(uint8_t **buffer, size_t *capacity, size_t needed) {
   return VAULT_OK;
 }
 
+static int index_has_extensions(const vault_entry_t *entries, uint32_t count) {
+  for (uint32_t i = 0; i < count; i++) {
+    if (entries[i].ext_len > 0)
+      return 1;
+  }
+  return 0;
+}
+
 // Compute plaintext index size (without encryption overhead)
 static int calculate_index_plaintext_size(const vault_entry_t *entries,
                                           uint32_t count, size_t *size_out) {
@@ -686,6 +716,7 @@ static int calculate_index_plaintext_size(const vault_entry_t *entries,
     return VAULT_ERR_INVALID_PARAM;
 
   size_t total = sizeof(uint32_t); // entry_count
+  int has_ext = index_has_extensions(entries, count);
 
   for (uint32_t i = 0; i < count; i++) {
     const vault_entry_t *entry = &entries[i];
@@ -713,6 +744,8 @@ static int calculate_index_plaintext_size(const vault_entry_t *entries,
       // Non-chunked format: offset/length follows
       total += sizeof(uint64_t) * 2; // data_offset + data_length
     }
+    if (has_ext)
+      total += sizeof(uint32_t) + entry->ext_len;
   }
 
   *size_out = total;
@@ -738,8 +771,11 @@ static int serialize_index(const vault_entry_t *entries, uint32_t count,
   if (res != VAULT_OK)
     return res;
 
-  // entry_count
-  memcpy(buffer + offset, &count, sizeof(uint32_t));
+  // entry_count; the extension section is only written when some entry has
+  // one, so vaults without extensions keep the original layout.
+  int has_ext = index_has_extensions(entries, count);
+  uint32_t count_field = count | (has_ext ? VAULT_INDEX_EXT_FLAG : 0);
+  memcpy(buffer + offset, &count_field, sizeof(uint32_t));
   offset += sizeof(uint32_t);
 
   for (uint32_t i = 0; i < count; i++) {
@@ -802,6 +838,15 @@ static int serialize_index(const vault_entry_t *entries, uint32_t count,
       memcpy(buffer + offset, &entry->data_length, sizeof(uint64_t));
       offset += sizeof(uint64_t);
     }
+
+    if (has_ext) {
+      memcpy(buffer + offset, &entry->ext_len, sizeof(uint32_t));
+      offset += sizeof(uint32_t);
+      if (entry->ext_len > 0) {
+        memcpy(buffer + offset, entry->ext, entry->ext_len);
+        offset += entry->ext_len;
+      }
+    }
   }
 
   *out = buffer;
@@ -821,6 +866,7 @@ static int deserialize_index(const uint8_t *data, size_t len,
   uint32_t count_field = 0;
   memcpy(&count_field, data + offset, sizeof(uint32_t));
   uint32_t count = count_field & VAULT_INDEX_COUNT_MASK;
+  int has_ext = (count_field & VAULT_INDEX_EXT_FLAG) != 0;
   offset += sizeof(uint32_t);
 
   if (count > 1000000) {
@@ -965,6 +1011,30 @@ static int deserialize_index(const uint8_t *data, size_t len,
       memcpy(&entry->data_length, data + offset, sizeof(uint64_t));
       offset += sizeof(uint64_t);
     }
+
+    if (has_ext) {
+      if (offset + sizeof(uint32_t) > len) {
+        free_entries_array(entries, i + 1);
+        return VAULT_ERR_CORRUPTED;
+      }
+      uint32_t ext_len;
+      memcpy(&ext_len, data + offset, sizeof(uint32_t));
+      offset += sizeof(uint32_t);
+      if (ext_len > 0) {
+        if (ext_len > VAULT_EXT_MAX_LEN || offset + ext_len > len) {
+          free_entries_array(entries, i + 1);
+          return VAULT_ERR_CORRUPTED;
+        }
+        entry->ext = malloc(ext_len);
+        if (!entry->ext) {
+          free_entries_array(entries, i + 1);
+          return VAULT_ERR_MEMORY;
+        }
+        memcpy(entry->ext, data + offset, ext_len);
+        entry->ext_len = ext_len;
+        offset += ext_len;
+      }
+    }
   }
 
   *entries_out = entries;
@@ -972,6 +1042,510 @@ static int deserialize_index(const uint8_t *data, size_t len,
   return VAULT_OK;
 }
 
+/*
+ * Compact index layout (all integers LEB128 varints unless noted):
+ *
+ *   "VIX2" u8 flags
+ *   [flags & DEFLATE: varint raw_len, zlib stream of the body]
+ *   body:
+ *     count
+ *     per entry:
+ *       file_id[16] u8 type zigzag(created_at - previous created_at)
+ *       name_len name
+ *       mime_code: 0 = literal (len, bytes) follows, k = k-th literal seen
+ *       size wrapped_dek_len wrapped_dek chunk_count
+ *       chunked: per chunk zigzag(offset - previous chunk end),
+ *                zigzag(length - previous length), nonce[24]
+ *       otherwise: data_offset data_length
+ *       ext_len ext
+ *
+ * Chunk ciphertext is appended contiguously, so chunk offsets and lengths
+ * collapse to single zero bytes.
+ */
+typedef struct {
+  uint8_t *data;
+  size_t len;
+  size_t cap;
+} index_writer_t;
+
+typedef struct {
+  const uint8_t *data;
+  size_t len;
+  size_t pos;
+} index_reader_t;
+
+static uint64_t zigzag_encode(int64_t value) {
+  return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t zigzag_decode(uint64_t value) {
+  return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static int writer_reserve(index_writer_t *w, size_t len) {
+  if (w->cap - w->len >= len)
+    return VAULT_OK;
+  // Grow by hand so the old buffer can be wiped before release
+  size_t new_cap = w->cap ? w->cap : 4096;
+  while (new_cap - w->len < len)
+    new_cap *= 2;
+  uint8_t *grown = malloc(new_cap);
+  if (!grown)
+    return VAULT_ERR_MEMORY;
+  if (w->data) {
+    memcpy(grown, w->data, w->len);
+    vault_zeroize(w->data, w->cap);
+    free(w->data);
+  }
+  w->data = grown;
+  w->cap = new_cap;
+  return VAULT_OK;
+}
+
+static int writer_put(index_writer_t *w, const void *bytes, size_t len) {
+  if (len == 0)
+    return VAULT_OK;
+  int result = writer_reserve(w, len);
+  if (result != VAULT_OK)
+    return result;
+  memcpy(w->data + w->len, bytes, len);
+  w->len += len;
+  return VAULT_OK;
+}
+
+static int writer_put_varint(index_writer_t *w, uint64_t value) {
+  uint8_t buf[10];
+  size_t n = 0;
+  do {
+    uint8_t byte = value & 0x7F;
+    value >>= 7;
+    buf[n++] = byte | (value ? 0x80 : 0);
+  } while (value);
+  return writer_put(w, buf, n);
+}
+
+static int writer_put_blob(index_writer_t *w, const void *bytes, size_t len) {
+  int result = writer_put_varint(w, len);
+  return result == VAULT_OK ? writer_put(w, bytes, len) : result;
+}
+
+static void writer_wipe(index_writer_t *w) {
+  if (w->data) {
+    vault_zeroize(w->data, w->cap);
+    free(w->data);
+  }
+  memset(w, 0, sizeof(*w));
+}
+
+static int reader_get_varint(index_reader_t *r, uint64_t *value_out) {
+  uint64_t value = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    if (r->pos >= r->len)
+      return VAULT_ERR_CORRUPTED;
+    uint8_t byte = r->data[r->pos++];
+    value |= (uint64_t)(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      *value_out = value;
+      return VAULT_OK;
+    }
+  }
+  return VAULT_ERR_CORRUPTED;
+}
+
+static int reader_get_bytes(index_reader_t *r, void *out, size_t len) {
+  if (r->len - r->pos < len)
+    return VAULT_ERR_CORRUPTED;
+  memcpy(out, r->data + r->pos, len);
+  r->pos += len;
+  return VAULT_OK;
+}
+
+// Read a length-prefixed field into a fresh allocation, optionally
+// NUL-terminated. Lengths above max_len are rejected.
+static int reader_get_blob(index_reader_t *r, size_t max_len, int as_string,
+                           uint8_t **out, size_t *len_out) {
+  uint64_t len = 0;
+  if (reader_get_varint(r, &len) != VAULT_OK || len > max_len ||
+      r->len - r->pos < len)
+    return VAULT_ERR_CORRUPTED;
+  *out = NULL;
+  *len_out = (size_t)len;
+  if (len == 0 && !as_string)
+    return VAULT_OK;
+  uint8_t *buf = malloc((size_t)len + (as_string ? 1 : 0));
+  if (!buf)
+    return VAULT_ERR_MEMORY;
+  memcpy(buf, r->data + r->pos, (size_t)len);
+  if (as_string)
+    buf[len] = '\0';
+  r->pos += (size_t)len;
+  *out = buf;
+  return VAULT_OK;
+}
+
+// zlib allocator that wipes its buffers, which hold index plaintext
+static voidpf index_zalloc(voidpf opaque, uInt items, uInt size) {
+  (void)opaque;
+  if (size && items > (SIZE_MAX - sizeof(size_t)) / size)
+    return Z_NULL;
+  size_t len = (size_t)items * size;
+  size_t *block = malloc(sizeof(size_t) + len);
+  if (!block)
+    return Z_NULL;
+  block[0] = len;
+  return block + 1;
+}
+
+static void index_zfree(voidpf opaque, voidpf address) {
+  (void)opaque;
+  if (!address)
+    return;
+  size_t *block = (size_t *)address - 1;
+  vault_zeroize((uint8_t *)address, block[0]);
+  free(block);
+}
+
+static int encode_compact_body(const vault_entry_t *entries, uint32_t count,
+                               index_writer_t *w) {
+  const char *mimes[VAULT_INDEX_MIME_DICT_MAX];
+  uint32_t mime_count = 0;
+  uint64_t prev_created = 0;
+  int result = writer_put_varint(w, count);
+
+  for (uint32_t i = 0; i < count && result == VAULT_OK; i++) {
+    const vault_entry_t *entry = &entries[i];
+    const char *name = entry->name ? entry->name : "";
+    const char *mime = entry->mime ? entry->mime : "";
+
+    result = writer_put(w, entry->file_id, VAULT_ID_LEN);
+    if (result == VAULT_OK)
+      result = writer_put(w, &entry->type, 1);
+    if (result == VAULT_OK)
+      result = writer_put_varint(
+          w, zigzag_encode((int64_t)(entry->created_at - prev_created)));
+    prev_created = entry->created_at;
+    if (result == VAULT_OK)
+      result = writer_put_blob(w, name, strlen(name));
+
+    if (result == VAULT_OK) {
+      uint32_t code = 0;
+      for (uint32_t m = 0; m < mime_count; m++) {
+        if (strcmp(mimes[m], mime) == 0) {
+          code = m + 1;
+          break;
+        }
+      }
+      if (code > 0) {
+        result = writer_put_varint(w, code);
+      } else {
+        result = writer_put_varint(w, 0);
+        if (result == VAULT_OK)
+          result = writer_put_blob(w, mime, strlen(mime));
+        if (mime_count < VAULT_INDEX_MIME_DICT_MAX)
+          mimes[mime_count++] = mime;
+      }
+    }
+
+    if (result == VAULT_OK)
+      result = writer_put_varint(w, entry->size);
+    if (result == VAULT_OK)
+      result = writer_put_blob(w, entry->wrapped_dek, entry->wrapped_dek_len);
+    if (result == VAULT_OK)
+      result = writer_put_varint(w, entry->chunk_count);
+
+    if (entry->chunk_count > 0) {
+      uint64_t expected = 0;
+      uint32_t prev_length = 0;
+      for (uint32_t c = 0; c < entry->chunk_count && result == VAULT_OK;
+           c++) {
+        result = writer_put_varint(
+            w, zigzag_encode((int64_t)(entry->chunks[c].offset - expected)));
+        if (result == VAULT_OK)
+          result = writer_put_varint(
+              w, zigzag_encode((int64_t)entry->chunks[c].length -
+                               (int64_t)prev_length));
+        if (result == VAULT_OK)
+          result = writer_put(w, entry->chunks[c].nonce, VAULT_NONCE_LEN);
+        expected = entry->chunks[c].offset + entry->chunks[c].length;
+        prev_length = entry->chunks[c].length;
+      }
+    } else if (result == VAULT_OK) {
+      result = writer_put_varint(w, entry->data_offset);
+      if (result == VAULT_OK)
+        result = writer_put_varint(w, entry->data_length);
+    }
+
+    if (result == VAULT_OK)
+      result = writer_put_blob(w, entry->ext, entry->ext_len);
+  }
+  return result;
+}
+
+// Serialize entries in the compact layout; the body is deflated when that
+// makes it smaller.
+static int serialize_index_compact(const vault_entry_t *entries, uint32_t count,
+                                   uint8_t **out, size_t *len_out) {
+  if (!out || !len_out || (count > 0 && !entries))
+    return VAULT_ERR_INVALID_PARAM;
+
+  index_writer_t body = {0};
+  index_writer_t record = {0};
+  int result = encode_compact_body(entries, count, &body);
+  if (result != VAULT_OK)
+    goto cleanup;
+  if (body.len > VAULT_INDEX_MAX_PLAINTEXT) {
+    result = VAULT_ERR_INVALID_PARAM;
+    goto cleanup;
+  }
+
+  uint8_t flags = VAULT_INDEX_COMPACT_DEFLATE;
+  result = writer_put(&record, VAULT_INDEX_COMPACT_MAGIC,
+                      VAULT_INDEX_COMPACT_MAGIC_LEN);
+  if (result == VAULT_OK)
+    result = writer_put(&record, &flags, 1);
+  if (result == VAULT_OK)
+    result = writer_put_varint(&record, body.len);
+  if (result != VAULT_OK)
+    goto cleanup;
+  size_t header_len = record.len;
+
+  z_stream zs;
+  memset(&zs, 0, sizeof(zs));
+  zs.zalloc = index_zalloc;
+  zs.zfree = index_zfree;
+  int deflated = 0;
+  if (deflateInit(&zs, Z_BEST_SPEED) == Z_OK) {
+    uLong bound = deflateBound(&zs, (uLong)body.len);
+    result = writer_reserve(&record, bound);
+    if (result == VAULT_OK) {
+      zs.next_in = body.data;
+      zs.avail_in = (uInt)body.len;
+      zs.next_out = record.data + header_len;
+      zs.avail_out = (uInt)bound;
+      if (deflate(&zs, Z_FINISH) == Z_STREAM_END &&
+          zs.total_out < body.len) {
+        record.len = header_len + zs.total_out;
+        deflated = 1;
+      }
+    }
+    deflateEnd(&zs);
+  }
+  if (result != VAULT_OK)
+    goto cleanup;
+
+  if (!deflated) {
+    vault_zeroize(record.data + VAULT_INDEX_COMPACT_MAGIC_LEN,
+                  record.cap - VAULT_INDEX_COMPACT_MAGIC_LEN);
+    record.len = VAULT_INDEX_COMPACT_MAGIC_LEN;
+    flags = 0;
+    result = writer_put(&record, &flags, 1);
+    if (result == VAULT_OK)
+      result = writer_put(&record, body.data, body.len);
+    if (result != VAULT_OK)
+      goto cleanup;
+  }
+
+  *out = record.data;
+  *len_out = record.len;
+  record.data = NULL;
+
+cleanup:
+  writer_wipe(&body);
+  writer_wipe(&record);
+  return result;
+}
+
+static int decode_compact_body(index_reader_t *r, vault_entry_t **entries_out,
+                               uint32_t *count_out) {
+  uint64_t count64 = 0;
+  if (reader_get_varint(r, &count64) != VAULT_OK ||
+      count64 > VAULT_INDEX_MAX_ENTRIES)
+    return VAULT_ERR_CORRUPTED;
+  uint32_t count = (uint32_t)count64;
+
+  vault_entry_t *entries = count ? calloc(count, sizeof(vault_entry_t)) : NULL;
+  if (count && !entries)
+    return VAULT_ERR_MEMORY;
+
+  const char *mimes[VAULT_INDEX_MIME_DICT_MAX];
+  uint32_t mime_count = 0;
+  uint64_t prev_created = 0;
+  int result = VAULT_OK;
+  uint32_t i = 0;
+
+  for (; i < count; i++) {
+    vault_entry_t *entry = &entries[i];
+    uint64_t value = 0;
+    size_t len = 0;
+
+    result = reader_get_bytes(r, entry->file_id, VAULT_ID_LEN);
+    if (result == VAULT_OK)
+      result = reader_get_bytes(r, &entry->type, 1);
+    if (result == VAULT_OK)
+      result = reader_get_varint(r, &value);
+    if (result != VAULT_OK)
+      break;
+    entry->created_at = prev_created + (uint64_t)zigzag_decode(value);
+    prev_created = entry->created_at;
+
+    uint8_t *text = NULL;
+    result = reader_get_blob(r, 4096, 1, &text, &len);
+    entry->name = (char *)text;
+    if (result == VAULT_OK)
+      result = reader_get_varint(r, &value);
+    if (result != VAULT_OK)
+      break;
+    if (value == 0) {
+      text = NULL;
+      result = reader_get_blob(r, 512, 1, &text, &len);
+      entry->mime = (char *)text;
+      if (result != VAULT_OK)
+        break;
+      if (mime_count < VAULT_INDEX_MIME_DICT_MAX)
+        mimes[mime_count++] = entry->mime;
+    } else {
+      if (value > mime_count) {
+        result = VAULT_ERR_CORRUPTED;
+        break;
+      }
+      entry->mime = strdup(mimes[value - 1]);
+      if (!entry->mime) {
+        result = VAULT_ERR_MEMORY;
+        break;
+      }
+    }
+
+    result = reader_get_varint(r, &entry->size);
+    if (result == VAULT_OK)
+      result = reader_get_blob(r, 512, 0, &entry->wrapped_dek, &len);
+    if (result != VAULT_OK)
+      break;
+    entry->wrapped_dek_len = (uint16_t)len;
+
+    result = reader_get_varint(r, &value);
+    if (result == VAULT_OK && value > UINT32_MAX)
+      result = VAULT_ERR_CORRUPTED;
+    if (result != VAULT_OK)
+      break;
+    entry->chunk_count = (uint32_t)value;
+
+    if (entry->chunk_count > 0) {
+      // Each chunk needs at least its nonce plus two varint bytes
+      if ((r->len - r->pos) / (VAULT_NONCE_LEN + 2) < entry->chunk_count) {
+        result = VAULT_ERR_CORRUPTED;
+        break;
+      }
+      entry->chunks = calloc(entry->chunk_count, sizeof(entry->chunks[0]));
+      if (!entry->chunks) {
+        result = VAULT_ERR_MEMORY;
+        break;
+      }
+      uint64_t expected = 0;
+      int64_t prev_length = 0;
+      for (uint32_t c = 0; c < entry->chunk_count && result == VAULT_OK;
+           c++) {
+        uint64_t offset_delta = 0;
+        uint64_t length_delta = 0;
+        result = reader_get_varint(r, &offset_delta);
+        if (result == VAULT_OK)
+          result = reader_get_varint(r, &length_delta);
+        if (result == VAULT_OK)
+          result = reader_get_bytes(r, entry->chunks[c].nonce, VAULT_NONCE_LEN);
+        if (result != VAULT_OK)
+          break;
+        int64_t length = prev_length + zigzag_decode(length_delta);
+        if (length < 0 || length > UINT32_MAX) {
+          result = VAULT_ERR_CORRUPTED;
+          break;
+        }
+        entry->chunks[c].offset =
+            expected + (uint64_t)zigzag_decode(offset_delta);
+        entry->chunks[c].length = (uint32_t)length;
+        expected = entry->chunks[c].offset + entry->chunks[c].length;
+        prev_length = length;
+      }
+      if (result != VAULT_OK)
+        break;
+    } else {
+      result = reader_get_varint(r, &entry->data_offset);
+      if (result == VAULT_OK)
+        result = reader_get_varint(r, &entry->data_length);
+      if (result != VAULT_OK)
+        break;
+    }
+
+    result = reader_get_blob(r, VAULT_EXT_MAX_LEN, 0, &entry->ext, &len);
+    if (result != VAULT_OK)
+      break;
+    entry->ext_len = (uint32_t)len;
+  }
+
+  if (result == VAULT_OK && r->pos != r->len)
+    result = VAULT_ERR_CORRUPTED;
+  if (result != VAULT_OK) {
+    free_entries_array(entries, i < count ? i + 1 : count);
+    return result;
+  }
+  *entries_out = entries;
+  *count_out = count;
+  return VAULT_OK;
+}
+
+// Parse a log index record in either the compact or the legacy layout
+static int deserialize_log_index(const uint8_t *data, size_t len,
+                                 vault_entry_t **entries_out,
+                                 uint32_t *count_out) {
+  if (!data || !entries_out || !count_out)
+    return VAULT_ERR_INVALID_PARAM;
+  if (len < VAULT_INDEX_COMPACT_MAGIC_LEN + 1 ||
+      memcmp(data, VAULT_INDEX_COMPACT_MAGIC, VAULT_INDEX_COMPACT_MAGIC_LEN) !=
+          0)
+    return deserialize_index(data, len, entries_out, count_out);
+
+  uint8_t flags = data[VAULT_INDEX_COMPACT_MAGIC_LEN];
+  index_reader_t r = {.data = data,
+                      .len = len,
+                      .pos = VAULT_INDEX_COMPACT_MAGIC_LEN + 1};
+  if (flags & ~VAULT_INDEX_COMPACT_DEFLATE)
+    return VAULT_ERR_CORRUPTED;
+  if (!(flags & VAULT_INDEX_COMPACT_DEFLATE))
+    return decode_compact_body(&r, entries_out, count_out);
+
+  uint64_t raw_len = 0;
+  if (reader_get_varint(&r, &raw_len) != VAULT_OK || raw_len == 0 ||
+      raw_len > VAULT_INDEX_MAX_PLAINTEXT)
+    return VAULT_ERR_CORRUPTED;
+  uint8_t *body = malloc((size_t)raw_len);
+  if (!body)
+    return VAULT_ERR_MEMORY;
+
+  z_stream zs;
+  memset(&zs, 0, sizeof(zs));
+  zs.zalloc = index_zalloc;
+  zs.zfree = index_zfree;
+  int result = VAULT_ERR_CORRUPTED;
+  if (inflateInit(&zs) == Z_OK) {
+    zs.next_in = (Bytef *)(data + r.pos);
+    zs.avail_in = (uInt)(len - r.pos);
+    zs.next_out = body;
+    zs.avail_out = (uInt)raw_len;
+    if (inflate(&zs, Z_FINISH) == Z_STREAM_END && zs.total_out == raw_len &&
+        zs.avail_in == 0)
+      result = VAULT_OK;
+    inflateEnd(&zs);
+  } else {
+    result = VAULT_ERR_MEMORY;
+  }
+
+  if (result == VAULT_OK) {
+    index_reader_t body_reader = {.data = body, .len = (size_t)raw_len};
+    result = decode_compact_body(&body_reader, entries_out, count_out);
+  }
+  vault_zeroize(body, (size_t)raw_len);
+  free(body);
+  return result;
+}
+
 static void log_index_aad_init(vault_log_index_aad_t *aad,
                                const uint8_t vault_id[VAULT_ID_LEN],
                                uint64_t sequence) {
@@ -1030,7 +1604,8 @@ static int build_log_index_record(const vault_entry_t *entries,
   uint8_t *plaintext = NULL;
   uint8_t *record = NULL;
   size_t plaintext_len = 0;
-  int result = serialize_index(entries, count, &plaintext, &plaintext_len);
+  int result =
+      serialize_index_compact(entries, count, &plaintext, &plaintext_len);
   if (result != VAULT_OK)
     return result;
 
@@ -1113,12 +1688,14 @@ static int read_log_index(int fd, const vault_log_slot_t *slot,
   if (result == VAULT_OK) {
     vault_entry_t *entries = NULL;
     uint32_t count = 0;
-    result = deserialize_index(plaintext, actual_len, &entries, &count);
+    result = deserialize_log_index(plaintext, actual_len, &entries, &count);
     if (result == VAULT_OK) {
       if (g_vault.entries)
         free_entries_array(g_vault.entries, g_vault.entry_count);
       g_vault.entries = entries;
       g_vault.entry_count = count;
+      vault_stats_rebuild();
+      vault_search_rebuild();
     }
   }
 
@@ -1187,6 +1764,12 @@ static int log_validate_entry_ranges(const vault_log_slot_t *slot,
       for (uint32_t c = 0; c < entry->chunk_count; c++) {
         uint64_t offset = entry->chunks[c].offset;
         uint64_t length = entry->chunks[c].length;
+        // Cold chunks live in the segment and are authenticated on read
+        if (vault_tier_chunk_is_cold(entry, c)) {
+          if (length < VAULT_TAG_LEN)
+            return VAULT_ERR_CORRUPTED;
+          continue;
+        }
         if (length < VAULT_TAG_LEN || offset < minimum_data_offset ||
             offset > UINT64_MAX - length ||
             offset + length > slot->index_offset) {
@@ -1206,17 +1789,10 @@ static int log_validate_entry_ranges(const vault_log_slot_t *slot,
   return VAULT_OK;
 }
 
+// O(1): live payload bytes are tracked incrementally in g_vault.stats.
 static void log_refresh_metrics(void) {
-  uint64_t used = log_header_size() + g_vault.index_length;
-  for (uint32_t i = 0; i < g_vault.entry_count; i++) {
-    const vault_entry_t *entry = &g_vault.entries[i];
-    if (entry->chunk_count > 0) {
-      for (uint32_t c = 0; c < entry->chunk_count; c++)
-        used += entry->chunks[c].length;
-    } else {
-      used += entry->data_length;
-    }
-  }
+  uint64_t used = log_header_size() + g_vault.index_length +
+                  g_vault.stats.live_bytes;
   g_vault.total_size = g_vault.committed_size;
   g_vault.free_space =
       g_vault.committed_size > used ? g_vault.committed_size - used : 0;
@@ -2048,6 +2624,8 @@ static int migrate_journal_to_v1(const char *path, size_t old_header_size,
   }
   g_vault.entries = entries_copy;
   entries_copy = NULL;
+  vault_stats_rebuild();
+  vault_search_rebuild();
 
 cleanup:
   if (fd_in >= 0)
@@ -2141,6 +2719,8 @@ static int migrate_active_to_log(const char *path) {
     goto cleanup;
   }
 
+  // Runs under the app's vault lock (open, compaction), so it is not paced:
+  // throttling here would only stall every call queued behind it
   uint64_t output_offset = log_header_size();
   for (uint32_t i = 0; i < g_vault.entry_count; i++) {
     const vault_entry_t *source = &g_vault.entries[i];
@@ -2148,6 +2728,9 @@ static int migrate_active_to_log(const char *path) {
     if (source->chunk_count > 0) {
       for (uint32_t c = 0; c < source->chunk_count; c++) {
         uint64_t length = source->chunks[c].length;
+        // Cold chunks stay in the segment; only the container is compacted
+        if (vault_tier_chunk_is_cold(source, c))
+          continue;
         destination->chunks[c].offset = output_offset;
         result = copy_ciphertext_range(fd_in, source->chunks[c].offset,
                                        length, fd_out, copy_buffer,
@@ -2219,6 +2802,8 @@ static int migrate_active_to_log(const char *path) {
   free_entries_array(g_vault.entries, g_vault.entry_count);
   g_vault.entries = entries;
   entries = NULL;
+  vault_stats_rebuild();
+  vault_search_rebuild();
   g_vault.container_format = VAULT_CONTAINER_LOG;
   g_vault.commit_sequence = sequence;
   g_vault.committed_size = committed_size;
@@ -2247,6 +2832,61 @@ cleanup:
   return result;
 }
 
+int vault_container_is_log(void) {
+  return g_vault.container_format == VAULT_CONTAINER_LOG;
+}
+
+// Bytes before the first record of a log container (super block and root
+// slots); 0 for other formats.
+uint64_t vault_container_header_size(void) {
+  if (g_vault.container_format == VAULT_CONTAINER_LOG)
+    return log_header_size();
+  if (g_vault.container_format == VAULT_CONTAINER_LOG_LEGACY)
+    return log_legacy_header_size();
+  return 0;
+}
+
+// Index records named by the valid root slots of a log container, newest
+// first; slots that fail validation are left out. Used by vault_layout.c.
+int vault_container_index_records(int fd, uint64_t file_size,
+                                  vault_layout_index_t *records, uint32_t cap,
+                                  uint32_t *count_out) {
+  *count_out = 0;
+  int legacy = g_vault.container_format == VAULT_CONTAINER_LOG_LEGACY;
+  if (!legacy && g_vault.container_format != VAULT_CONTAINER_LOG)
+    return VAULT_ERR_INVALID_PARAM;
+  vault_log_super_t super;
+  int result = log_read_super(fd, &super);
+  if (result != VAULT_OK)
+    return result;
+
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < super.slot_count && count < cap; i++) {
+    vault_layout_index_t record;
+    if (legacy) {
+      vault_log_legacy_slot_t slot;
+      if (log_read_legacy_slot(fd, &super, i, file_size, &slot) != VAULT_OK)
+        continue;
+      record = (vault_layout_index_t){slot.seq, slot.index_offset,
+                                      slot.index_length};
+    } else {
+      vault_log_slot_t slot;
+      if (log_read_slot(fd, &super, i, file_size, &slot) != VAULT_OK)
+        continue;
+      record = (vault_layout_index_t){slot.seq, slot.index_offset,
+                                      slot.index_length};
+    }
+    uint32_t at = count++;
+    while (at > 0 && records[at - 1].seq < record.seq) {
+      records[at] = records[at - 1];
+      at--;
+    }
+    records[at] = record;
+  }
+  *count_out = count;
+  return VAULT_OK;
+}
+
 int vault_compact_storage(void) {
   if (!g_vault.is_open || !g_vault.path)
     return VAULT_ERR_NOT_OPEN;
@@ -2312,6 +2952,8 @@ static int read_index(int fd, const uint8_t mk[VAULT_KEY_LEN]) {
     }
     g_vault.entries = entries;
     g_vault.entry_count = count;
+    vault_stats_rebuild();
+    vault_search_rebuild();
   }
 
   vault_zeroize(plaintext, pt_len);
@@ -3180,9 +3822,11 @@ int vault_save_index_only(void) {
   header.kdf_iter = g_vault.kdf_iter;
   header.kdf_parallel = g_vault.kdf_parallel;
 
+  uint32_t crc = calculate_crc32((uint8_t *)&header, sizeof(header));
   if (write(fd_out, &header, sizeof(header)) != sizeof(header) ||
       write(fd_out, g_vault.wrapped_mk, g_vault.wrapped_mk_len) !=
-          (ssize_t)g_vault.wrapped_mk_len) {
+          (ssize_t)g_vault.wrapped_mk_len ||
+      write(fd_out, &crc, sizeof(crc)) != sizeof(crc)) {
     close(fd_out);
     unlink(temp_path);
     free(temp_path);
@@ -3190,9 +3834,6 @@ int vault_save_index_only(void) {
     goto cleanup;
   }
 
-  uint32_t crc = calculate_crc32((uint8_t *)&header, sizeof(header));
-  write(fd_out, &crc, sizeof(crc));
-
   // Write index
   uint64_t ct_len_u64 = ct_len;
   if (write(fd_out, index_nonce, VAULT_NONCE_LEN) != VAULT_NONCE_LEN ||
@@ -3256,6 +3897,8 @@ int vault_save_index_only(void) {
   free_entries_array(g_vault.entries, g_vault.entry_count);
   g_vault.entries = entries_copy;
   entries_copy = NULL;
+  vault_stats_rebuild();
+  vault_search_rebuild();
 
   LOGI("vault_save_index_only: SLOW PATH complete");
   result = VAULT_OK;
@@ -3280,7 +3923,9 @@ cleanup:
 
 static int log_append_entry(const vault_entry_t *new_entry,
                             const vault_payload_t *payload,
-                            const char *chunk_dir) {
+                            const char *chunk_dir,
+                            vault_chunk_source_fn source, void *source_ctx,
+                            size_t source_chunk_cap) {
   int result = VAULT_OK;
   int fd = -1;
   uint8_t *index_record = NULL;
@@ -3288,6 +3933,7 @@ static int log_append_entry(const vault_entry_t *new_entry,
   uint8_t index_key[VAULT_KEY_LEN] = {0};
   uint8_t wrapped_index_key[WRAPPED_INDEX_KEY_SIZE] = {0};
   uint8_t *copy_buffer = NULL;
+  size_t copy_buffer_size = 0;
   vault_entry_t *entries = NULL;
   vault_entry_t *entry_copy = NULL;
   uint32_t new_count = g_vault.entry_count + 1;
@@ -3330,8 +3976,11 @@ static int log_append_entry(const vault_entry_t *new_entry,
 
   uint64_t output_offset = g_vault.committed_size;
   if (new_entry->chunk_count > 0) {
-    if (chunk_dir) {
-      copy_buffer = malloc(1024 * 1024);
+    if (chunk_dir || source) {
+      // Chunk-dir copies and source-encrypted chunks share one reused buffer,
+      // so peak memory stays at a single chunk regardless of entry size.
+      copy_buffer_size = source ? source_chunk_cap : 1024 * 1024;
+      copy_buffer = malloc(copy_buffer_size);
       if (!copy_buffer) {
         result = VAULT_ERR_MEMORY;
         goto cleanup;
@@ -3339,6 +3988,21 @@ static int log_append_entry(const vault_entry_t *new_entry,
     }
     for (uint32_t c = 0; c < new_entry->chunk_count; c++) {
       destination->chunks[c].offset = output_offset;
+      if (source) {
+        size_t length = 0;
+        result = source(source_ctx, c, copy_buffer, copy_buffer_size, &length,
+                        destination->chunks[c].nonce);
+        if (result == VAULT_OK &&
+            (length == 0 || length > copy_buffer_size || length > UINT32_MAX))
+          result = VAULT_ERR_INVALID_PARAM;
+        if (result == VAULT_OK)
+          result = write_all(fd, copy_buffer, length);
+        if (result != VAULT_OK)
+          goto cleanup;
+        destination->chunks[c].length = (uint32_t)length;
+        output_offset += length;
+        continue;
+      }
       if (payload) {
         size_t length = payload->chunk_lens[c];
         if (length > UINT32_MAX) {
@@ -3375,7 +4039,7 @@ static int log_append_entry(const vault_entry_t *new_entry,
         result = VAULT_ERR_CORRUPTED;
       if (result == VAULT_OK)
         result = copy_ciphertext_range(chunk_fd, VAULT_NONCE_LEN, length, fd,
-                                       copy_buffer, 1024 * 1024);
+                                       copy_buffer, copy_buffer_size);
       close(chunk_fd);
       if (result != VAULT_OK)
         goto cleanup;
@@ -3433,6 +4097,8 @@ static int log_append_entry(const vault_entry_t *new_entry,
   g_vault.entries = entries;
   g_vault.entry_count = new_count;
   entries = NULL;
+  vault_stats_add_entry(&g_vault.entries[new_count - 1]);
+  vault_search_add_entry(&g_vault.entries[new_count - 1]);
   g_vault.commit_sequence = sequence;
   g_vault.committed_size = committed_size;
   g_vault.index_offset = index_offset;
@@ -3449,7 +4115,10 @@ cleanup:
   }
   vault_zeroize(index_key, sizeof(index_key));
   vault_zeroize(wrapped_index_key, sizeof(wrapped_index_key));
-  free(copy_buffer);
+  if (copy_buffer) {
+    vault_zeroize(copy_buffer, copy_buffer_size);
+    free(copy_buffer);
+  }
   if (entry_copy)
     free_entries_array(entry_copy, 1);
   if (entries)
@@ -3486,7 +4155,7 @@ static int vault_append_entry_internal(const vault_entry_t *new_entry,
   }
 
   if (g_vault.container_format == VAULT_CONTAINER_LOG)
-    return log_append_entry(new_entry, payload, chunk_dir);
+    return log_append_entry(new_entry, payload, chunk_dir, NULL, NULL, 0);
 
   int result = VAULT_OK;
   int fd_in = -1;
@@ -3584,6 +4253,15 @@ static int vault_append_entry_internal(const vault_entry_t *new_entry,
       result = VAULT_ERR_MEMORY;
       goto cleanup;
     }
+    if (new_entry->ext_len > 0) {
+      dst->ext = malloc(new_entry->ext_len);
+      if (!dst->ext) {
+        result = VAULT_ERR_MEMORY;
+        goto cleanup;
+      }
+      memcpy(dst->ext, new_entry->ext, new_entry->ext_len);
+      dst->ext_len = new_entry->ext_len;
+    }
     dst->chunk_count = new_entry->chunk_count;
 
     // Set offsets for new entry's data
@@ -3833,6 +4511,8 @@ static int vault_append_entry_internal(const vault_entry_t *new_entry,
   g_vault.entries = new_entries;
   g_vault.entry_count = new_count;
   new_entries = NULL; // Ownership transferred
+  vault_stats_add_entry(&g_vault.entries[new_count - 1]);
+  vault_search_add_entry(&g_vault.entries[new_count - 1]);
 
   LOGI("vault_append_entry: completed successfully, new count=%u",
        g_vault.entry_count);
@@ -3872,3 +4552,450 @@ int vault_append_entry_from_chunk_dir(const vault_entry_t *new_entry,
                                       const char *chunk_dir) {
   return vault_append_entry_internal(new_entry, NULL, chunk_dir);
 }
+
+int vault_append_entry_from_source(const vault_entry_t *new_entry,
+                                   vault_chunk_source_fn source, void *ctx,
+                                   size_t max_chunk_len) {
+  if (!g_vault.is_open || !g_vault.path)
+    return VAULT_ERR_NOT_OPEN;
+  if (!new_entry || !source || new_entry->chunk_count == 0 ||
+      max_chunk_len == 0)
+    return VAULT_ERR_INVALID_PARAM;
+
+  if (g_vault.container_format == VAULT_CONTAINER_LOG)
+    return log_append_entry(new_entry, NULL, NULL, source, ctx, max_chunk_len);
+
+  // Legacy containers are rewritten through a temp file, so materialize the
+  // ciphertext payload once and fall back to the buffered append path.
+  vault_entry_t *entry = NULL;
+  vault_payload_t payload;
+  memset(&payload, 0, sizeof(payload));
+  int result = clone_entries(new_entry, 1, &entry);
+  if (result != VAULT_OK)
+    return result;
+  payload.chunks = calloc(entry->chunk_count, sizeof(uint8_t *));
+  payload.chunk_lens = calloc(entry->chunk_count, sizeof(size_t));
+  if (!payload.chunks || !payload.chunk_lens) {
+    result = VAULT_ERR_MEMORY;
+    goto cleanup;
+  }
+  payload.chunk_count = entry->chunk_count;
+  for (uint32_t c = 0; c < entry->chunk_count; c++) {
+    payload.chunks[c] = malloc(max_chunk_len);
+    if (!payload.chunks[c]) {
+      result = VAULT_ERR_MEMORY;
+      goto cleanup;
+    }
+    size_t length = 0;
+    result = source(ctx, c, payload.chunks[c], max_chunk_len, &length,
+                    entry->chunks[c].nonce);
+    if (result == VAULT_OK &&
+        (length == 0 || length > max_chunk_len || length > UINT32_MAX))
+      result = VAULT_ERR_INVALID_PARAM;
+    if (result != VAULT_OK)
+      goto cleanup;
+    payload.chunk_lens[c] = length;
+    entry->chunks[c].length = (uint32_t)length;
+  }
+  result = vault_append_entry_internal(entry, &payload, NULL);
+
+cleanup:
+  if (payload.chunks) {
+    for (uint32_t c = 0; c < payload.chunk_count; c++) {
+      if (payload.chunks[c]) {
+        vault_zeroize(payload.chunks[c], max_chunk_len);
+        free(payload.chunks[c]);
+      }
+    }
+    free(payload.chunks);
+  }
+  free(payload.chunk_lens);
+  free_entries_array(entry, 1);
+  return result;
+}
+
+int vault_update_entry_from_source(const vault_entry_t *updated,
+                                   uint32_t first, uint32_t count,
+                                   vault_chunk_source_fn source, void *ctx,
+                                   size_t max_chunk_len) {
+  if (!g_vault.is_open || !g_vault.path)
+    return VAULT_ERR_NOT_OPEN;
+  if (!updated || !source || count == 0 || max_chunk_len == 0 ||
+      max_chunk_len > UINT32_MAX)
+    return VAULT_ERR_INVALID_PARAM;
+  if (updated->chunk_count > 0 ? first > updated->chunk_count ||
+                                     count > updated->chunk_count - first
+                               : first != 0 || count != 1)
+    return VAULT_ERR_INVALID_PARAM;
+  // Legacy containers are rewritten whole on every change; they are migrated
+  // to the log on open, so partial updates only target the log format.
+  if (g_vault.container_format != VAULT_CONTAINER_LOG ||
+      g_vault.commit_sequence == UINT64_MAX)
+    return VAULT_ERR_CORRUPTED;
+
+  uint32_t target = UINT32_MAX;
+  for (uint32_t i = 0; i < g_vault.entry_count; i++) {
+    if (memcmp(g_vault.entries[i].file_id, updated->file_id, VAULT_ID_LEN) ==
+        0) {
+      target = i;
+      break;
+    }
+  }
+  if (target == UINT32_MAX)
+    return VAULT_ERR_NOT_FOUND;
+
+  int result = VAULT_OK;
+  int fd = -1;
+  uint8_t *index_record = NULL;
+  size_t index_record_len = 0;
+  uint8_t index_key[VAULT_KEY_LEN] = {0};
+  uint8_t wrapped_index_key[WRAPPED_INDEX_KEY_SIZE] = {0};
+  uint8_t *buffer = NULL;
+  vault_entry_t *entries = NULL;
+  vault_entry_t *entry_copy = NULL;
+  uint32_t entry_count = g_vault.entry_count;
+
+  result = clone_entries(g_vault.entries, entry_count, &entries);
+  if (result != VAULT_OK)
+    goto cleanup;
+  result = clone_entries(updated, 1, &entry_copy);
+  if (result != VAULT_OK)
+    goto cleanup;
+  vault_free_entry(&entries[target]);
+  entries[target] = entry_copy[0];
+  free(entry_copy);
+  entry_copy = NULL;
+  vault_entry_t *destination = &entries[target];
+
+  buffer = malloc(max_chunk_len);
+  if (!buffer) {
+    result = VAULT_ERR_MEMORY;
+    goto cleanup;
+  }
+  fd = open(g_vault.path, O_RDWR);
+  if (fd < 0) {
+    result = VAULT_ERR_IO;
+    goto cleanup;
+  }
+  if (ftruncate(fd, (off_t)g_vault.committed_size) != 0 ||
+      lseek(fd, (off_t)g_vault.committed_size, SEEK_SET) < 0) {
+    result = VAULT_ERR_IO;
+    goto cleanup;
+  }
+
+  // Only the rewritten chunks go to the tail; every other chunk descriptor
+  // still points at ciphertext committed by an earlier version.
+  uint64_t output_offset = g_vault.committed_size;
+  for (uint32_t c = first; c < first + count; c++) {
+    size_t length = 0;
+    uint8_t nonce[VAULT_NONCE_LEN];
+    result = source(ctx, c, buffer, max_chunk_len, &length, nonce);
+    if (result == VAULT_OK && (length == 0 || length > max_chunk_len))
+      result = VAULT_ERR_INVALID_PARAM;
+    if (result != VAULT_OK)
+      goto cleanup;
+    if (destination->chunk_count > 0) {
+      destination->chunks[c].offset = output_offset;
+      destination->chunks[c].length = (uint32_t)length;
+      memcpy(destination->chunks[c].nonce, nonce, VAULT_NONCE_LEN);
+    } else {
+      // Single-blob entries store the nonce in front of the ciphertext
+      result = write_all(fd, nonce, VAULT_NONCE_LEN);
+      if (result != VAULT_OK)
+        goto cleanup;
+      destination->data_offset = output_offset;
+      destination->data_length = VAULT_NONCE_LEN + length;
+      output_offset += VAULT_NONCE_LEN;
+    }
+    result = write_all(fd, buffer, length);
+    if (result != VAULT_OK)
+      goto cleanup;
+    output_offset += length;
+  }
+  if (destination->chunk_count > 0) {
+    result = vault_tier_mark_internal(destination, first, count);
+    if (result != VAULT_OK)
+      goto cleanup;
+  }
+
+  uint64_t sequence = g_vault.commit_sequence + 1;
+  vault_random_bytes(index_key, sizeof(index_key));
+  result = log_wrap_index_key(g_vault.master_key, g_vault.vault_id, sequence,
+                              index_key, wrapped_index_key);
+  if (result != VAULT_OK)
+    goto cleanup;
+  result = build_log_index_record(entries, entry_count, index_key,
+                                  g_vault.vault_id, sequence, &index_record,
+                                  &index_record_len);
+  if (result != VAULT_OK)
+    goto cleanup;
+  uint64_t index_offset = output_offset;
+  result = write_all(fd, index_record, index_record_len);
+  if (result != VAULT_OK || fsync(fd) != 0) {
+    result = VAULT_ERR_IO;
+    goto cleanup;
+  }
+
+  uint64_t committed_size = index_offset + index_record_len;
+  uint32_t next_slot = (g_vault.active_root_slot + 1) % VAULT_LOG_SLOT_COUNT;
+  vault_log_slot_t root;
+  result = log_fill_slot(
+      &root, sequence, g_vault.vault_id, g_vault.salt, g_vault.kdf_mem,
+      g_vault.kdf_iter, g_vault.kdf_parallel, g_vault.wrapped_mk,
+      wrapped_index_key, index_offset, index_record_len, committed_size,
+      g_vault.master_key);
+  if (result != VAULT_OK)
+    goto cleanup;
+  result = log_write_slot(fd, next_slot, &root);
+  if (result != VAULT_OK || fsync(fd) != 0) {
+    result = VAULT_ERR_IO;
+    goto cleanup;
+  }
+
+  int mirror_result = log_write_slot(fd, g_vault.active_root_slot, &root);
+  if (mirror_result != VAULT_OK || fsync(fd) != 0)
+    LOGE("vault_update_entry: failed to mirror committed root slot");
+
+  // Superseded chunks become dead space for compaction
+  vault_stats_remove_entry(&g_vault.entries[target]);
+  vault_search_remove_entry(updated->file_id);
+  free_entries_array(g_vault.entries, g_vault.entry_count);
+  g_vault.entries = entries;
+  entries = NULL;
+  vault_stats_add_entry(&g_vault.entries[target]);
+  vault_search_add_entry(&g_vault.entries[target]);
+  g_vault.commit_sequence = sequence;
+  g_vault.committed_size = committed_size;
+  g_vault.index_offset = index_offset;
+  g_vault.index_length = index_record_len;
+  g_vault.active_root_slot = next_slot;
+  log_refresh_metrics();
+
+cleanup:
+  if (fd >= 0)
+    close(fd);
+  if (index_record) {
+    vault_zeroize(index_record, index_record_len);
+    free(index_record);
+  }
+  vault_zeroize(index_key, sizeof(index_key));
+  vault_zeroize(wrapped_index_key, sizeof(wrapped_index_key));
+  if (buffer) {
+    vault_zeroize(buffer, max_chunk_len);
+    free(buffer);
+  }
+  if (entry_copy)
+    free_entries_array(entry_copy, 1);
+  if (entries)
+    free_entries_array(entries, entry_count);
+  return result;
+}
+
+struct vault_append_batch {
+  int fd;
+  uint64_t base_size;     // committed size when the batch began
+  uint64_t base_sequence; // commit the batch builds on
+  uint64_t tail;          // next ciphertext offset
+  vault_entry_t *entries;
+  uint32_t entry_count;
+  uint32_t entry_cap;
+  int committed;
+};
+
+int vault_append_batch_begin(vault_append_batch_t **batch_out) {
+  if (!batch_out)
+    return VAULT_ERR_INVALID_PARAM;
+  *batch_out = NULL;
+  if (!g_vault.is_open || !g_vault.path)
+    return VAULT_ERR_NOT_OPEN;
+  if (g_vault.container_format != VAULT_CONTAINER_LOG ||
+      g_vault.commit_sequence == UINT64_MAX)
+    return VAULT_ERR_CORRUPTED;
+
+  vault_append_batch_t *batch = calloc(1, sizeof(*batch));
+  if (!batch)
+    return VAULT_ERR_MEMORY;
+  batch->fd = open(g_vault.path, O_RDWR);
+  if (batch->fd < 0) {
+    free(batch);
+    return VAULT_ERR_IO;
+  }
+  if (ftruncate(batch->fd, (off_t)g_vault.committed_size) != 0 ||
+      lseek(batch->fd, (off_t)g_vault.committed_size, SEEK_SET) < 0) {
+    close(batch->fd);
+    free(batch);
+    return VAULT_ERR_IO;
+  }
+  batch->base_size = g_vault.committed_size;
+  batch->base_sequence = g_vault.commit_sequence;
+  batch->tail = g_vault.committed_size;
+  *batch_out = batch;
+  return VAULT_OK;
+}
+
+int vault_append_batch_write(vault_append_batch_t *batch, const uint8_t *data,
+                             size_t len, uint64_t *offset_out) {
+  if (!batch || batch->committed || !data || len == 0 || !offset_out)
+    return VAULT_ERR_INVALID_PARAM;
+  int result = write_all(batch->fd, data, len);
+  if (result != VAULT_OK)
+    return result;
+  *offset_out = batch->tail;
+  batch->tail += len;
+  return VAULT_OK;
+}
+
+int vault_append_batch_add(vault_append_batch_t *batch,
+                           const vault_entry_t *entry) {
+  if (!batch || batch->committed || !entry)
+    return VAULT_ERR_INVALID_PARAM;
+  if (g_vault.entry_count + batch->entry_count + 1 == 0)
+    return VAULT_ERR_CORRUPTED;
+  for (uint32_t c = 0; c < entry->chunk_count; c++) {
+    if (entry->chunks[c].offset < batch->base_size ||
+        entry->chunks[c].offset + entry->chunks[c].length > batch->tail)
+      return VAULT_ERR_INVALID_PARAM;
+  }
+  if (entry->chunk_count == 0 &&
+      (entry->data_offset < batch->base_size ||
+       entry->data_offset + entry->data_length > batch->tail))
+    return VAULT_ERR_INVALID_PARAM;
+
+  if (batch->entry_count == batch->entry_cap) {
+    uint32_t cap = batch->entry_cap ? batch->entry_cap * 2 : 16;
+    vault_entry_t *resized =
+        realloc(batch->entries, cap * sizeof(vault_entry_t));
+    if (!resized)
+      return VAULT_ERR_MEMORY;
+    batch->entries = resized;
+    batch->entry_cap = cap;
+  }
+  vault_entry_t *copy = NULL;
+  int result = clone_entries(entry, 1, &copy);
+  if (result != VAULT_OK)
+    return result;
+  batch->entries[batch->entry_count++] = copy[0];
+  free(copy);
+  return VAULT_OK;
+}
+
+int vault_append_batch_commit(vault_append_batch_t *batch) {
+  if (!batch || batch->committed)
+    return VAULT_ERR_INVALID_PARAM;
+  if (!g_vault.is_open)
+    return VAULT_ERR_NOT_OPEN;
+  // Another commit since begin would have truncated the batch's ciphertext
+  if (g_vault.commit_sequence != batch->base_sequence ||
+      g_vault.committed_size != batch->base_size)
+    return VAULT_ERR_CORRUPTED;
+  if (batch->entry_count == 0)
+    return VAULT_OK;
+
+  int result = VAULT_OK;
+  uint8_t *index_record = NULL;
+  size_t index_record_len = 0;
+  uint8_t index_key[VAULT_KEY_LEN] = {0};
+  uint8_t wrapped_index_key[WRAPPED_INDEX_KEY_SIZE] = {0};
+  vault_entry_t *entries = NULL;
+  uint32_t new_count = g_vault.entry_count + batch->entry_count;
+
+  result = clone_entries(g_vault.entries, g_vault.entry_count, &entries);
+  if (result != VAULT_OK)
+    goto cleanup;
+  vault_entry_t *resized =
+      realloc(entries, new_count * sizeof(vault_entry_t));
+  if (!resized) {
+    result = VAULT_ERR_MEMORY;
+    goto cleanup;
+  }
+  entries = resized;
+  // Ownership of the batch entries moves to the new index
+  memcpy(&entries[g_vault.entry_count], batch->entries,
+         batch->entry_count * sizeof(vault_entry_t));
+
+  uint64_t sequence = g_vault.commit_sequence + 1;
+  vault_random_bytes(index_key, sizeof(index_key));
+  result = log_wrap_index_key(g_vault.master_key, g_vault.vault_id, sequence,
+                              index_key, wrapped_index_key);
+  if (result != VAULT_OK)
+    goto cleanup;
+  result = build_log_index_record(entries, new_count, index_key,
+                                  g_vault.vault_id, sequence, &index_record,
+                                  &index_record_len);
+  if (result != VAULT_OK)
+    goto cleanup;
+  uint64_t index_offset = batch->tail;
+  result = write_all(batch->fd, index_record, index_record_len);
+  if (result != VAULT_OK || fsync(batch->fd) != 0) {
+    result = VAULT_ERR_IO;
+    goto cleanup;
+  }
+
+  uint64_t committed_size = index_offset + index_record_len;
+  uint32_t next_slot = (g_vault.active_root_slot + 1) % VAULT_LOG_SLOT_COUNT;
+  vault_log_slot_t root;
+  result = log_fill_slot(
+      &root, sequence, g_vault.vault_id, g_vault.salt, g_vault.kdf_mem,
+      g_vault.kdf_iter, g_vault.kdf_parallel, g_vault.wrapped_mk,
+      wrapped_index_key, index_offset, index_record_len, committed_size,
+      g_vault.master_key);
+  if (result != VAULT_OK)
+    goto cleanup;
+  result = log_write_slot(batch->fd, next_slot, &root);
+  if (result != VAULT_OK || fsync(batch->fd) != 0) {
+    result = VAULT_ERR_IO;
+    goto cleanup;
+  }
+
+  int mirror_result = log_write_slot(batch->fd, g_vault.active_root_slot, &root);
+  if (mirror_result != VAULT_OK || fsync(batch->fd) != 0)
+    LOGE("vault_append_batch_commit: failed to mirror committed root slot");
+
+  free_entries_array(g_vault.entries, g_vault.entry_count);
+  g_vault.entries = entries;
+  g_vault.entry_count = new_count;
+  entries = NULL;
+  for (uint32_t i = new_count - batch->entry_count; i < new_count; i++) {
+    vault_stats_add_entry(&g_vault.entries[i]);
+    vault_search_add_entry(&g_vault.entries[i]);
+  }
+  g_vault.commit_sequence = sequence;
+  g_vault.committed_size = committed_size;
+  g_vault.index_offset = index_offset;
+  g_vault.index_length = index_record_len;
+  g_vault.active_root_slot = next_slot;
+  log_refresh_metrics();
+  free(batch->entries);
+  batch->entries = NULL;
+  batch->entry_count = 0;
+  batch->committed = 1;
+
+cleanup:
+  if (index_record) {
+    vault_zeroize(index_record, index_record_len);
+    free(index_record);
+  }
+  vault_zeroize(index_key, sizeof(index_key));
+  vault_zeroize(wrapped_index_key, sizeof(wrapped_index_key));
+  // On failure the batch still owns its entries; free only the clones
+  if (entries)
+    free_entries_array(entries, g_vault.entry_count);
+  return result;
+}
+
+void vault_append_batch_free(vault_append_batch_t *batch) {
+  if (!batch)
+    return;
+  if (batch->fd >= 0) {
+    // Uncommitted ciphertext past the committed size is unreachable; drop it
+    if (!batch->committed && g_vault.is_open &&
+        g_vault.commit_sequence == batch->base_sequence &&
+        g_vault.committed_size == batch->base_size &&
+        ftruncate(batch->fd, (off_t)batch->base_size) != 0)
+      LOGE("vault_append_batch_free: failed to trim uncommitted data");
+    close(batch->fd);
+  }
+  if (batch->entries)
+    free_entries_array(batch->entries, batch->entry_count);
+  free(batch);
+}
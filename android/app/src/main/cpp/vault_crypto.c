@@ -7,6 +7,7 @@
  */
 
 #include "vault_engine.h"
+#include "vault_governor.h"
 #include <android/log.h>
 #include <fcntl.h>
 #include <sodium.h>
@@ -276,6 +277,7 @@ int vault_secure_wipe_file(const char *path) {
   uint64_t file_size = (uint64_t)st.st_size;
   uint8_t buffer[64 * 1024];
   uint64_t remaining = file_size;
+  vault_pace_t pace = {0, 0};
 
   // Overwrite with random data
   while (remaining > 0) {
@@ -287,6 +289,10 @@ int vault_secure_wipe_file(const char *path) {
       return VAULT_ERR_IO;
     }
     remaining -= to_write;
+    // Spaces out consecutive writes only: a file that fits in one buffer
+    // (a streaming import's state, wiped inside its commit) never sleeps
+    if (remaining > 0)
+      vault_governor_pace(&pace, to_write);
   }
 
   // Sync to disk
@@ -3,6 +3,8 @@
  */
 
 #include "vault_engine.h"
+#include "vault_search.h"
+#include "vault_tier.h"
 #include <sodium.h>
 #include <stdlib.h>
 #include <string.h>
@@ -80,6 +82,10 @@ void vault_free_entry(vault_entry_t* entry) {
         vault_zeroize(entry->chunks, entry->chunk_count * sizeof(entry->chunks[0]));
         free(entry->chunks);
     }
+    if (entry->ext) {
+        vault_zeroize(entry->ext, entry->ext_len);
+        free(entry->ext);
+    }
     vault_zeroize(entry, sizeof(*entry));
 }
 
@@ -126,6 +132,10 @@ void vault_close(void) {
     g_vault.entry_count = 0;
     g_vault.total_size = 0;
     g_vault.free_space = 0;
+    memset(&g_vault.stats, 0, sizeof(g_vault.stats));
+    g_vault.stats_largest_stale = 0;
+    vault_search_reset();
+    vault_tier_reset();
     
     LOGI("Vault closed");
 }
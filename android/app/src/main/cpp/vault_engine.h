@@ -142,8 +142,55 @@ typedef struct {
     uint32_t length;
     uint8_t nonce[VAULT_NONCE_LEN];
   } *chunks;
+
+  // Optional encrypted per-entry extension records (tag, u32 len, data)*.
+  // Unknown tags are carried through unchanged.
+  uint8_t *ext;
+  uint32_t ext_len;
 } vault_entry_t;
 
+// Entry extension record tags
+#define VAULT_EXT_SEARCH_TERMS 1
+#define VAULT_EXT_MEDIA_INFO 2
+#define VAULT_EXT_TIER 3
+#define VAULT_EXT_ACCESS 4
+#define VAULT_EXT_MAX_LEN (1024 * 1024)
+
+#define VAULT_MEDIA_CODEC_LEN 32
+
+// Container metadata captured at import so playback can skip probing
+typedef struct {
+  uint32_t width;  // Coded size, before rotation
+  uint32_t height;
+  uint32_t rotation; // Degrees clockwise
+  uint64_t duration_ms;
+  uint32_t video_tracks;
+  uint32_t audio_tracks;
+  char video_codec[VAULT_MEDIA_CODEC_LEN]; // MIME, e.g. "video/avc"
+  char audio_codec[VAULT_MEDIA_CODEC_LEN];
+} vault_media_info_t;
+
+// Stats breakdown slots: index is VAULT_FILE_TYPE_*, slot 0 collects others
+#define VAULT_STATS_TYPE_SLOTS 4
+#define VAULT_STATS_LARGEST_FILES 5
+
+// Vault statistics, maintained incrementally as entries are added/removed
+typedef struct {
+  uint64_t total_size;      // Committed container size
+  uint64_t free_space;      // Dead bytes reclaimable by compaction
+  uint64_t live_bytes;      // Ciphertext bytes referenced by the index
+  uint64_t index_bytes;     // Current encrypted index record
+  uint64_t plaintext_bytes; // Sum of user file sizes
+  uint32_t file_count;      // User files (system entries excluded)
+  uint32_t fragmented_files;
+  uint64_t extent_count;    // Contiguous ciphertext runs over all entries
+  uint64_t type_bytes[VAULT_STATS_TYPE_SLOTS];
+  uint32_t type_files[VAULT_STATS_TYPE_SLOTS];
+  uint32_t largest_count;
+  uint8_t largest_ids[VAULT_STATS_LARGEST_FILES][VAULT_ID_LEN];
+  uint64_t largest_sizes[VAULT_STATS_LARGEST_FILES];
+} vault_stats_t;
+
 // Vault state
 typedef struct {
   int is_open;
@@ -163,6 +210,8 @@ typedef struct {
   // Free space tracking
   uint64_t total_size;
   uint64_t free_space;
+  vault_stats_t stats;
+  int stats_largest_stale;
 
   // Wrapped master key (stored from header for rewrites)
   uint8_t wrapped_mk[VAULT_NONCE_LEN + VAULT_KEY_LEN + VAULT_TAG_LEN];
@@ -380,6 +429,8 @@ int vault_is_open(void);
 
 /**
  * Import a file into the vault
+ * Videos, and other files over STREAMING_CHUNK_SIZE, are stored chunked and
+ * encrypted one chunk at a time, so only one chunk of ciphertext is held.
  * @param data File data
  * @param len Length of data
  * @param type File type (VAULT_FILE_TYPE_*)
@@ -413,6 +464,37 @@ int vault_read_file(const uint8_t file_id[VAULT_ID_LEN], uint8_t **data_out,
 int vault_read_chunk(const uint8_t file_id[VAULT_ID_LEN], uint32_t chunk_idx,
                      uint8_t **data_out, size_t *len_out);
 
+/**
+ * Read a run of chunks into one buffer.
+ * Ciphertext adjacent on disk is fetched with a single read and the chunks
+ * are decrypted in parallel directly into out. Reading stops once out_cap
+ * bytes are filled; the last chunk may be truncated.
+ * @param file_id File ID
+ * @param first First chunk index
+ * @param count Number of chunks
+ * @param out Output buffer (zeroized on failure)
+ * @param out_cap Capacity of out
+ * @param len_out Receives the number of plaintext bytes written
+ * @return VAULT_OK on success
+ */
+int vault_read_chunks(const uint8_t file_id[VAULT_ID_LEN], uint32_t first,
+                      uint32_t count, uint8_t *out, size_t out_cap,
+                      size_t *len_out);
+
+/**
+ * Read plaintext bytes [offset, offset + len) of a file, clamped to its size.
+ * Only the chunks overlapping the range are decrypted; whole chunks go
+ * through vault_read_chunks, a leading partial chunk is decrypted on its own.
+ * @param file_id File ID
+ * @param offset Plaintext offset
+ * @param out Output buffer (zeroized on failure)
+ * @param len Bytes requested
+ * @param len_out Receives the bytes written (0 at or past the end)
+ * @return VAULT_OK on success
+ */
+int vault_read_range(const uint8_t file_id[VAULT_ID_LEN], uint64_t offset,
+                     uint8_t *out, size_t len, size_t *len_out);
+
 /**
  * Delete a file from the vault
  * @param file_id File ID
@@ -429,6 +511,90 @@ int vault_delete_file(const uint8_t file_id[VAULT_ID_LEN]);
 int vault_rename_file(const uint8_t file_id[VAULT_ID_LEN],
                       const char *new_name);
 
+/**
+ * Delete several files with a single index commit.
+ * All IDs are validated first; on any error nothing is deleted.
+ * @param file_ids count packed file IDs (count * VAULT_ID_LEN bytes)
+ * @param count Number of IDs
+ * @return VAULT_OK on success, VAULT_ERR_NOT_FOUND if any ID is unknown
+ */
+int vault_delete_files(const uint8_t *file_ids, uint32_t count);
+
+/**
+ * Rename several files with a single index commit.
+ * All names are validated first; on any error nothing is renamed.
+ * @param file_ids count packed file IDs (count * VAULT_ID_LEN bytes)
+ * @param new_names New name for each ID
+ * @param count Number of IDs
+ * @return VAULT_OK on success
+ */
+int vault_rename_files(const uint8_t *file_ids, const char *const *new_names,
+                       uint32_t count);
+
+// Metadata operation kinds for vault_commit_metadata_ops
+#define VAULT_META_OP_RENAME 1
+#define VAULT_META_OP_DELETE 2
+
+typedef struct {
+  uint8_t kind;                  // VAULT_META_OP_*
+  uint8_t file_id[VAULT_ID_LEN];
+  const char *new_name;          // VAULT_META_OP_RENAME only
+} vault_meta_op_t;
+
+/**
+ * Apply independent renames and deletes from several callers with a single
+ * index commit (group commit). Operations are checked in order as if run
+ * one after another; an invalid one fails alone and the rest still commit.
+ * If the shared commit fails, every valid operation is rolled back and
+ * reports the commit error.
+ * @param ops Operations in arrival order
+ * @param count Number of operations
+ * @param status_out Receives one VAULT_OK / error code per operation
+ * @return VAULT_OK if the commit landed (or nothing needed committing),
+ * otherwise the commit error
+ */
+int vault_commit_metadata_ops(const vault_meta_op_t *ops, uint32_t count,
+                              int *status_out);
+
+/**
+ * Overwrite part of a file, growing it when the range runs past the end.
+ * Only chunks overlapping the range are re-encrypted (same DEK, fresh
+ * nonces) and appended; unchanged chunks are shared with the previous
+ * version, whose superseded ciphertext is reclaimed by compaction.
+ * Stored media metadata is dropped so playback probes the new content.
+ * @param file_id File ID
+ * @param offset Plaintext offset, at most the current size
+ * @param data New bytes
+ * @param len Length of data
+ * @return VAULT_OK on success
+ */
+int vault_write_file_range(const uint8_t file_id[VAULT_ID_LEN],
+                           uint64_t offset, const uint8_t *data, size_t len);
+
+/**
+ * Append bytes to the end of a file; see vault_write_file_range.
+ * @return VAULT_OK on success
+ */
+int vault_append_to_file(const uint8_t file_id[VAULT_ID_LEN],
+                         const uint8_t *data, size_t len);
+
+/**
+ * Move files still stored in the legacy 1 MB chunk layout to the 4 MB layout
+ * of streaming imports, one file per commit. Each new chunk is assembled
+ * from the old ones and encrypted with the file's DEK under a fresh nonce;
+ * the new chunk table replaces the old one atomically and the superseded
+ * ciphertext is reclaimed by compaction. Files with cold chunks, files read
+ * within idle_ms, and damaged files are left as they are. Nothing here is
+ * paced: a caller holding a lock passes max_bytes = 1 to convert one file
+ * per call, and throttles between calls after releasing it.
+ * @param idle_ms Skip files read more recently than this
+ * @param max_bytes Stop starting new files once this many bytes are done
+ * @param bytes_out Receives the plaintext bytes converted (may be NULL)
+ * @return VAULT_OK on success
+ */
+int vault_rechunk_legacy(uint64_t idle_ms, uint64_t max_bytes,
+                         uint64_t *bytes_out);
+
 /**
  * Get list of files in vault
  * @param entries_out Output array (caller must free)
@@ -457,13 +623,51 @@ int vault_compact_storage(void);
 int vault_change_password(const uint8_t *old_passphrase, size_t old_pass_len,
                           const uint8_t *new_passphrase, size_t new_pass_len);
 
+/**
+ * Find an extension record on an entry.
+ * @return 1 and sets data_out/len_out if present, 0 otherwise
+ */
+int vault_entry_ext_find(const vault_entry_t *entry, uint8_t tag,
+                         const uint8_t **data_out, uint32_t *len_out);
+
+/**
+ * Replace (or with data == NULL remove) an extension record on an entry.
+ * Only the in-memory entry changes; the next index commit persists it.
+ * @return VAULT_OK on success
+ */
+int vault_entry_ext_set(vault_entry_t *entry, uint8_t tag, const uint8_t *data,
+                        uint32_t len);
+
+/**
+ * Attach media metadata to an entry in memory (no commit).
+ * @return VAULT_OK on success
+ */
+int vault_entry_set_media_info(vault_entry_t *entry,
+                               const vault_media_info_t *info);
+
+/**
+ * Store media metadata for a file with one index commit.
+ * @return VAULT_OK on success, VAULT_ERR_NOT_FOUND for unknown IDs
+ */
+int vault_set_media_info(const uint8_t file_id[VAULT_ID_LEN],
+                         const vault_media_info_t *info);
+
+/**
+ * Read media metadata stored for a file.
+ * @return VAULT_OK on success, VAULT_ERR_NOT_FOUND if none is stored
+ */
+int vault_get_media_info(const uint8_t file_id[VAULT_ID_LEN],
+                         vault_media_info_t *info_out);
+
 /**
  * Get vault statistics
- * @param total_size_out Total container size
- * @param free_space_out Free space from deleted files
+ * Counters are maintained incrementally by append/delete/compaction, so this
+ * does not walk the index.
+ * @param stats_out Receives sizes, dead space, per-type breakdown,
+ * fragmentation and largest files
  * @return VAULT_OK on success
  */
-int vault_get_stats(uint64_t *total_size_out, uint64_t *free_space_out);
+int vault_get_stats(vault_stats_t *stats_out);
 
 // ============================================================================
 // Performance Optimization Functions
@@ -502,6 +706,95 @@ int vault_append_entry(const vault_entry_t *new_entry,
 int vault_append_entry_from_chunk_dir(const vault_entry_t *new_entry,
                                       const char *chunk_dir);
 
+/**
+ * Produces the ciphertext for one chunk of an entry being appended.
+ * @param ctx Caller context
+ * @param chunk_index Index of the chunk to produce
+ * @param out Reused output buffer (out_cap bytes)
+ * @param out_cap Capacity of out
+ * @param out_len Receives the ciphertext length written to out
+ * @param nonce_out Receives the chunk nonce recorded in the index
+ * @return VAULT_OK on success
+ */
+typedef int (*vault_chunk_source_fn)(void *ctx, uint32_t chunk_index,
+                                     uint8_t *out, size_t out_cap,
+                                     size_t *out_len,
+                                     uint8_t nonce_out[VAULT_NONCE_LEN]);
+
+/**
+ * Append a chunked entry whose ciphertext is produced on demand.
+ * Each chunk is encrypted into a single reused buffer and written to the
+ * container tail immediately; the index is committed once at the end.
+ *
+ * @param new_entry Entry metadata with chunk_count set (copied)
+ * @param source Chunk producer invoked once per chunk, in order
+ * @param ctx Context passed to source
+ * @param max_chunk_len Largest ciphertext length source may produce
+ * @return VAULT_OK on success
+ */
+int vault_append_entry_from_source(const vault_entry_t *new_entry,
+                                   vault_chunk_source_fn source, void *ctx,
+                                   size_t max_chunk_len);
+
+/**
+ * Commit a new version of an existing entry in which chunks
+ * [first, first + count) are produced by source and appended to the log
+ * tail. Every other chunk keeps its committed ciphertext, so the old and new
+ * chunk tables share it. An entry without chunks is rewritten as one data
+ * blob (first 0, count 1).
+ *
+ * @param updated New metadata and chunk table (copied); file_id selects the
+ * entry to replace
+ * @param first First chunk produced by source
+ * @param count Number of chunks produced
+ * @param source Chunk producer invoked once per chunk, in order
+ * @param ctx Context passed to source
+ * @param max_chunk_len Largest ciphertext length source may produce
+ * @return VAULT_OK on success, VAULT_ERR_NOT_FOUND for unknown IDs
+ */
+int vault_update_entry_from_source(const vault_entry_t *updated,
+                                   uint32_t first, uint32_t count,
+                                   vault_chunk_source_fn source, void *ctx,
+                                   size_t max_chunk_len);
+
+/**
+ * Several new entries appended with a single index commit. Ciphertext is
+ * written to the log tail as it is produced and only becomes reachable when
+ * the batch commits; a batch freed without committing is cut off again.
+ * No other commit may run while a batch is open.
+ */
+typedef struct vault_append_batch vault_append_batch_t;
+
+/**
+ * Start a batch at the current end of the log.
+ * @return VAULT_OK on success, VAULT_ERR_CORRUPTED for legacy containers
+ */
+int vault_append_batch_begin(vault_append_batch_t **batch_out);
+
+/**
+ * Write ciphertext (a chunk, or nonce + ciphertext of a blob) to the tail.
+ * @param offset_out Receives the container offset of the data
+ */
+int vault_append_batch_write(vault_append_batch_t *batch, const uint8_t *data,
+                             size_t len, uint64_t *offset_out);
+
+/**
+ * Queue an entry whose data was written by this batch (copied).
+ */
+int vault_append_batch_add(vault_append_batch_t *batch,
+                           const vault_entry_t *entry);
+
+/**
+ * Commit every queued entry with one index record.
+ * @return VAULT_OK on success; the batch must still be freed
+ */
+int vault_append_batch_commit(vault_append_batch_t *batch);
+
+/**
+ * Release a batch, trimming its data if it was not committed.
+ */
+void vault_append_batch_free(vault_append_batch_t *batch);
+
 // ============================================================================
 // Memory Management
 // ============================================================================
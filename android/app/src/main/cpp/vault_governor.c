@@ -0,0 +1,246 @@
+/**
+ * NoLeak Vault Engine - Concurrency Governor Implementation
+ *
+ * Severity ladder (the worst of thermal and battery wins):
+ *   0  cool, or charging with thermal headroom     all workers, unpaced
+ *   1  light thermal load, or battery below 30%    half the workers
+ *   2  moderate thermal load, battery below 15%,   two workers
+ *      or power-save mode
+ *   3  severe thermal load or worse                one worker
+ *
+ * Measured throughput is an EWMA per job class and worker count. Within the
+ * signal cap a job gets the fewest workers that reach 90% of the best
+ * measured rate. The cap is measured first; after that, while half of the
+ * chosen count is unmeasured it is tried next, so an I/O-bound job walks
+ * down 8 -> 4 -> 2 -> 1 until fewer workers measurably lose throughput.
+ * The cap is probed again every few decisions so stale measurements age
+ * out.
+ */
+
+#include "vault_governor.h"
+#include <android/log.h>
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define LOG_TAG "VaultGovernor"
+
+#ifdef NDEBUG
+#define LOGI(...) ((void)0)
+#else
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#endif
+
+#define MB (1024ull * 1024)
+
+// Paced rate per severity level (0 = unpaced)
+static const uint64_t k_io_rate[4] = {0, 160 * MB, 64 * MB, 24 * MB};
+
+#define PROBE_INTERVAL 8
+#define NEAR_BEST_PERCENT 90
+#define EWMA_WEIGHT 0.3
+// Phases shorter or smaller than this say more about noise than speed
+#define MIN_REPORT_NS 2000000ull
+#define MIN_REPORT_BYTES (256 * 1024ull)
+// Longest single pacing sleep; keeps jobs responsive to cancellation
+#define MAX_PACE_SLEEP_NS 250000000ull
+// Pacing credit is not carried over longer than this
+#define PACE_WINDOW_NS 1000000000ull
+
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static vault_governor_signals_t g_signals;
+static int g_have_signals = 0;
+static vault_governor_source_t g_source = {NULL, NULL};
+static double g_throughput[VAULT_JOB_CLASSES][VAULT_GOVERNOR_MAX_WORKERS + 1];
+static uint32_t g_decisions[VAULT_JOB_CLASSES];
+// Last count handed out per class; decisions are only logged on a change
+static uint32_t g_last_chosen[VAULT_JOB_CLASSES];
+
+static int default_sample(void *ctx, vault_governor_signals_t *out) {
+  (void)ctx;
+  pthread_mutex_lock(&g_lock);
+  int have = g_have_signals;
+  if (have)
+    *out = g_signals;
+  pthread_mutex_unlock(&g_lock);
+  return have ? 0 : -1;
+}
+
+void vault_governor_set_source(const vault_governor_source_t *source) {
+  pthread_mutex_lock(&g_lock);
+  if (source && source->sample) {
+    g_source = *source;
+  } else {
+    g_source.sample = NULL;
+    g_source.ctx = NULL;
+  }
+  pthread_mutex_unlock(&g_lock);
+}
+
+void vault_governor_set_signals(const vault_governor_signals_t *signals) {
+  if (!signals)
+    return;
+  pthread_mutex_lock(&g_lock);
+  g_signals = *signals;
+  g_have_signals = 1;
+  pthread_mutex_unlock(&g_lock);
+}
+
+static int current_severity(void) {
+  vault_governor_source_t source;
+  pthread_mutex_lock(&g_lock);
+  source = g_source;
+  pthread_mutex_unlock(&g_lock);
+
+  vault_governor_signals_t s;
+  memset(&s, 0, sizeof(s));
+  int rc = source.sample ? source.sample(source.ctx, &s)
+                         : default_sample(NULL, &s);
+  if (rc != 0)
+    return 0;
+
+  int severity = 0;
+  if (s.thermal_status >= VAULT_THERMAL_SEVERE || s.thermal_headroom >= 0.95f)
+    severity = 3;
+  else if (s.thermal_status == VAULT_THERMAL_MODERATE ||
+           s.thermal_headroom >= 0.85f)
+    severity = 2;
+  else if (s.thermal_status == VAULT_THERMAL_LIGHT ||
+           s.thermal_headroom >= 0.70f)
+    severity = 1;
+
+  if (!s.charging) {
+    int battery = 0;
+    if (s.power_save || (s.battery_percent >= 0 && s.battery_percent < 15))
+      battery = 2;
+    else if (s.battery_percent >= 0 && s.battery_percent < 30)
+      battery = 1;
+    if (battery > severity)
+      severity = battery;
+  }
+  return severity;
+}
+
+static uint32_t severity_cap(int severity, uint32_t max_workers) {
+  switch (severity) {
+  case 0:
+    return max_workers;
+  case 1:
+    return (max_workers + 1) / 2;
+  case 2:
+    return max_workers < 2 ? max_workers : 2;
+  default:
+    return 1;
+  }
+}
+
+uint32_t vault_governor_workers(vault_job_t job, uint32_t max_workers) {
+  if (max_workers == 0)
+    return 1;
+  if (max_workers > VAULT_GOVERNOR_MAX_WORKERS)
+    max_workers = VAULT_GOVERNOR_MAX_WORKERS;
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  if (cpus > 0 && (uint32_t)cpus < max_workers)
+    max_workers = (uint32_t)cpus;
+
+  int severity = current_severity();
+  uint32_t cap = severity_cap(severity, max_workers);
+  if (cap < 1)
+    cap = 1;
+  if ((unsigned)job >= VAULT_JOB_CLASSES)
+    return cap;
+
+  pthread_mutex_lock(&g_lock);
+  const double *measured = g_throughput[job];
+  uint32_t chosen = cap;
+  int probe = (++g_decisions[job] % PROBE_INTERVAL) == 0;
+  if (!probe && measured[cap] > 0) {
+    double best = 0;
+    for (uint32_t w = 1; w <= cap; w++) {
+      if (measured[w] > best)
+        best = measured[w];
+    }
+    for (uint32_t w = 1; w <= cap; w++) {
+      if (measured[w] > 0 && measured[w] * 100 >= best * NEAR_BEST_PERCENT) {
+        chosen = w;
+        break;
+      }
+    }
+    // Explore downwards: fewer workers may do as well
+    if (chosen > 1 && measured[chosen / 2] == 0)
+      chosen /= 2;
+  }
+  int changed = g_last_chosen[job] != chosen;
+  g_last_chosen[job] = chosen;
+  pthread_mutex_unlock(&g_lock);
+
+  if (changed) {
+    LOGI("workers: job=%d severity=%d cap=%u chosen=%u", (int)job, severity,
+         cap, chosen);
+  }
+  return chosen;
+}
+
+uint64_t vault_governor_io_rate(void) {
+  return k_io_rate[current_severity()];
+}
+
+void vault_governor_report(vault_job_t job, uint32_t workers, uint64_t bytes,
+                           uint64_t elapsed_ns) {
+  if ((unsigned)job >= VAULT_JOB_CLASSES || workers == 0 ||
+      workers > VAULT_GOVERNOR_MAX_WORKERS || elapsed_ns < MIN_REPORT_NS ||
+      bytes < MIN_REPORT_BYTES)
+    return;
+  double rate = (double)bytes * 1e9 / (double)elapsed_ns;
+  pthread_mutex_lock(&g_lock);
+  double *slot = &g_throughput[job][workers];
+  *slot = *slot > 0 ? *slot + EWMA_WEIGHT * (rate - *slot) : rate;
+  pthread_mutex_unlock(&g_lock);
+}
+
+uint64_t vault_governor_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void vault_governor_pace(vault_pace_t *pace, uint64_t bytes) {
+  if (!pace)
+    return;
+  uint64_t rate = vault_governor_io_rate();
+  uint64_t now = vault_governor_now_ns();
+  if (rate == 0) {
+    pace->window_start_ns = 0;
+    pace->window_bytes = 0;
+    return;
+  }
+  if (pace->window_start_ns == 0 ||
+      now - pace->window_start_ns > PACE_WINDOW_NS) {
+    pace->window_start_ns = now;
+    pace->window_bytes = 0;
+  }
+  pace->window_bytes += bytes;
+
+  // Time the window's bytes should have taken at the allowed rate
+  uint64_t due_ns = (uint64_t)((double)pace->window_bytes * 1e9 / (double)rate);
+  uint64_t elapsed = now - pace->window_start_ns;
+  if (due_ns <= elapsed)
+    return;
+  uint64_t wait = due_ns - elapsed;
+  if (wait > MAX_PACE_SLEEP_NS)
+    wait = MAX_PACE_SLEEP_NS;
+  struct timespec ts = {(time_t)(wait / 1000000000ull),
+                        (long)(wait % 1000000000ull)};
+  while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+  }
+}
+
+void vault_governor_reset(void) {
+  pthread_mutex_lock(&g_lock);
+  memset(g_throughput, 0, sizeof(g_throughput));
+  memset(g_decisions, 0, sizeof(g_decisions));
+  memset(g_last_chosen, 0, sizeof(g_last_chosen));
+  pthread_mutex_unlock(&g_lock);
+}
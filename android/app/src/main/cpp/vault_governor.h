@@ -0,0 +1,136 @@
+/**
+ * NoLeak Vault Engine - Concurrency Governor
+ *
+ * One policy for how hard background jobs (archive import and export,
+ * streaming import writes, plaintext scans, file wipes, re-chunking) may
+ * push the device. Jobs ask for a worker count before starting threads
+ * and pace their bulk I/O through it, so a long import or export backs off
+ * before the phone throttles and starves the foreground (e.g. video
+ * playback).
+ *
+ * Interactive reads are neither paced nor stalled by pacing: they queue on
+ * the app's vault lock, so nothing paces while holding it. Work that must
+ * run under the lock (commits, compaction, converting one file) runs at
+ * full speed; jobs made of many such steps release the lock and pace
+ * between them.
+ *
+ * - Device signals (thermal headroom/status, battery level, charging,
+ *   power-save) come from a pluggable source; the app pushes Android
+ *   values, host tests install a fake
+ * - Worker counts are capped by the signals, then trimmed to the smallest
+ *   count whose measured throughput is close to the best seen, since more
+ *   workers on a throttled or I/O-bound device only add heat
+ * - Bulk I/O is paced to a byte rate that drops as the device heats up or
+ *   the battery runs low; a cool, charging device is never paced
+ */
+
+#ifndef VAULT_GOVERNOR_H
+#define VAULT_GOVERNOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Largest worker count any job may be granted
+#define VAULT_GOVERNOR_MAX_WORKERS 8
+
+// Thermal status levels (PowerManager.THERMAL_STATUS_*)
+#define VAULT_THERMAL_NONE 0
+#define VAULT_THERMAL_LIGHT 1
+#define VAULT_THERMAL_MODERATE 2
+#define VAULT_THERMAL_SEVERE 3
+#define VAULT_THERMAL_CRITICAL 4
+
+// Job classes; measured throughput is kept per class
+typedef enum {
+  VAULT_JOB_EXPORT = 0,  // archive export pipeline
+  VAULT_JOB_SCAN = 1,    // plaintext scanner
+  VAULT_JOB_KOTLIN = 2,  // worker pools on the Kotlin side
+  VAULT_JOB_CLASSES = 3
+} vault_job_t;
+
+typedef struct {
+  // Forecast headroom (PowerManager.getThermalHeadroom): 1.0 is the point
+  // where the system throttles; negative when unknown
+  float thermal_headroom;
+  int thermal_status;   // VAULT_THERMAL_*
+  int battery_percent;  // 0-100, negative when unknown
+  int charging;
+  int power_save;
+} vault_governor_signals_t;
+
+/**
+ * Signal source. sample fills the current signals and returns 0, or
+ * returns non-zero when nothing is known (treated as a cool device).
+ */
+typedef struct {
+  int (*sample)(void *ctx, vault_governor_signals_t *out);
+  void *ctx;
+} vault_governor_source_t;
+
+/**
+ * Install a signal source (NULL restores the default, which serves the
+ * values last passed to vault_governor_set_signals). Not thread-safe with
+ * running jobs; install before starting work.
+ */
+void vault_governor_set_source(const vault_governor_source_t *source);
+
+/**
+ * Update the signals served by the default source.
+ */
+void vault_governor_set_signals(const vault_governor_signals_t *signals);
+
+/**
+ * Workers a job may start now, between 1 and max_workers.
+ */
+uint32_t vault_governor_workers(vault_job_t job, uint32_t max_workers);
+
+/**
+ * Bulk I/O rate allowed now in bytes per second (0 = unpaced).
+ */
+uint64_t vault_governor_io_rate(void);
+
+/**
+ * Report a finished job phase so later worker counts follow the measured
+ * throughput.
+ * @param job Job class
+ * @param workers Workers the phase ran with
+ * @param bytes Bytes processed
+ * @param elapsed_ns Wall time of the phase
+ */
+void vault_governor_report(vault_job_t job, uint32_t workers, uint64_t bytes,
+                           uint64_t elapsed_ns);
+
+/**
+ * Pacing state for one bulk transfer; zero-initialize before use.
+ */
+typedef struct {
+  uint64_t window_start_ns;
+  uint64_t window_bytes;
+} vault_pace_t;
+
+/**
+ * Account bytes just transferred and sleep as needed to hold the current
+ * I/O rate. The rate is re-read on every call, so it follows the device
+ * through long jobs. Never call with the app's vault lock held.
+ */
+void vault_governor_pace(vault_pace_t *pace, uint64_t bytes);
+
+/**
+ * Monotonic clock in nanoseconds (for timing phases).
+ */
+uint64_t vault_governor_now_ns(void);
+
+/**
+ * Forget measured throughput (tests, or after the signals changed a lot).
+ */
+void vault_governor_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VAULT_GOVERNOR_H
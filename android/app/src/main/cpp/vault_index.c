@@ -3,9 +3,15 @@
  */
 
 #include "vault_engine.h"
+#include "vault_search.h"
+#include "vault_streaming.h"
+#include "vault_tier.h"
 #include <android/log.h>
+#include <errno.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <sodium.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -14,6 +20,14 @@
 
 #define LOG_TAG "VaultIndex"
 
+// Batch chunk reads: contiguous ciphertext is fetched in windows of at most
+// this size and the chunks of a window are decrypted on worker threads.
+#define READ_CHUNKS_WINDOW (32 * 1024 * 1024)
+#define READ_CHUNKS_MAX_THREADS 4
+// Smaller windows are decrypted on the calling thread alone; starting
+// helper threads for them costs more than it saves.
+#define READ_CHUNKS_PARALLEL_MIN (8 * 1024 * 1024)
+
 // SECURITY: Disable logging in release builds
 #ifdef NDEBUG
 #define LOGI(...) ((void)0)
@@ -27,23 +41,87 @@
 extern vault_state_t g_vault;
 void vault_random_bytes(uint8_t *buf, size_t len);
 void vault_generate_id(uint8_t id_out[VAULT_ID_LEN]);
+int vault_container_is_log(void);
 
 // Forward declarations - some are non-static for use by vault_streaming.c
 void free_entries_array(vault_entry_t *entries, uint32_t count);
 static void free_payload(vault_payload_t *payload);
 int clone_entries(const vault_entry_t *source, uint32_t count,
                   vault_entry_t **dest_out);
+// Decrypt without recording an access; also used by vault_archive_export.c
+int vault_decrypt_entry_blob(const vault_entry_t *entry, uint8_t **data_out,
+                             size_t *len_out);
+int vault_decrypt_entry_chunk(const vault_entry_t *entry, uint32_t chunk_idx,
+                              uint8_t **data_out, size_t *len_out);
 static int build_text_image_entry(const uint8_t *data, size_t len, uint8_t type,
                                   const char *name, const char *mime,
                                   vault_entry_t *entry_out,
                                   vault_payload_t *payload_out);
-static int build_video_entry(const uint8_t *data, size_t len, const char *name,
-                             const char *mime, vault_entry_t *entry_out,
-                             vault_payload_t *payload_out);
+// Plaintext source for chunked imports; chunks are encrypted on demand.
+typedef struct {
+  const uint8_t *data;
+  size_t len;
+  size_t chunk_size;
+  uint8_t dek[VAULT_KEY_LEN];
+  vault_aad_t aad_base;
+} import_chunk_source_t;
+
+static int prepare_chunked_entry(const uint8_t *data, size_t len,
+                                 uint8_t type, const char *name,
+                                 const char *mime, size_t chunk_size,
+                                 vault_entry_t *entry_out,
+                                 import_chunk_source_t *source_out);
+static int encrypt_import_chunk(void *ctx, uint32_t chunk_index,
+                                uint8_t *out, size_t out_cap, size_t *out_len,
+                                uint8_t nonce_out[VAULT_NONCE_LEN]);
+// Plaintext source for partial updates: rewritten chunks merge committed
+// plaintext with the new bytes before being re-encrypted.
+typedef struct {
+  const vault_entry_t *entry; // committed version
+  uint8_t dek[VAULT_KEY_LEN];
+  vault_aad_t aad_base;
+  size_t chunk_size; // plaintext bytes per chunk, 0 for single blobs
+  uint64_t new_size;
+  uint64_t offset;
+  const uint8_t *data;
+  size_t len;
+  uint8_t *plain; // one chunk, or the whole new blob
+} update_chunk_source_t;
+// Source for re-chunking: each new chunk is assembled from the committed
+// legacy chunks it covers.
+typedef struct {
+  const vault_entry_t *entry; // committed version
+  uint8_t dek[VAULT_KEY_LEN];
+  vault_aad_t aad_base;
+  uint8_t *plain; // one new chunk
+} rechunk_source_t;
+
+static size_t entry_chunk_size(const vault_entry_t *entry);
+static int encrypt_rechunk_chunk(void *ctx, uint32_t chunk_index,
+                                 uint8_t *out, size_t out_cap,
+                                 size_t *out_len,
+                                 uint8_t nonce_out[VAULT_NONCE_LEN]);
+static int encrypt_update_chunk(void *ctx, uint32_t chunk_index, uint8_t *out,
+                                size_t out_cap, size_t *out_len,
+                                uint8_t nonce_out[VAULT_NONCE_LEN]);
 static int unwrap_dek(const vault_entry_t *entry,
                       uint8_t dek_out[VAULT_KEY_LEN]);
 static int load_blob(uint64_t offset, uint64_t length, uint8_t **out);
+static int load_chunk(const vault_entry_t *entry, uint32_t chunk_idx,
+                      uint8_t **out);
 static void clear_entry_allocations(vault_entry_t *entry);
+static void stats_rebuild_largest(void);
+void vault_stats_add_entry(const vault_entry_t *entry);
+void vault_stats_remove_entry(const vault_entry_t *entry);
+void vault_stats_rebuild(void);
+
+// Per-source records of the watched-folder store: <prefix><id...>__
+static int is_watch_record_name(const char *name, const char *prefix) {
+  size_t len = strlen(name);
+  size_t prefix_len = strlen(prefix);
+  return len > prefix_len + 2 && strncmp(name, prefix, prefix_len) == 0 &&
+         strcmp(name + len - 2, "__") == 0;
+}
 
 static int is_allowed_system_name(const char *name) {
   if (!name)
@@ -51,7 +129,75 @@ static int is_allowed_system_name(const char *name) {
   return strcmp(name, "__folder_map__") == 0 ||
          strcmp(name, "__folder_map__.tmp") == 0 ||
          strcmp(name, "__vault_title__") == 0 ||
-         strcmp(name, "__vault_title__.tmp") == 0;
+         strcmp(name, "__vault_title__.tmp") == 0 ||
+         strcmp(name, "__watched_sources__") == 0 ||
+         is_watch_record_name(name, "__watch_cursor_") ||
+         is_watch_record_name(name, "__watch_delta_");
+}
+
+static int validate_rename(const vault_entry_t *entry, const char *new_name) {
+  if (!new_name)
+    return VAULT_ERR_INVALID_PARAM;
+  size_t name_len = strlen(new_name);
+  if (name_len == 0 || name_len > 4096)
+    return VAULT_ERR_INVALID_PARAM;
+  const int new_is_system = is_allowed_system_name(new_name);
+  if (strncmp(new_name, "__", 2) == 0 && !new_is_system)
+    return VAULT_ERR_INVALID_PARAM;
+
+  const char *current_name = entry->name;
+  const int current_is_system = is_allowed_system_name(current_name);
+  if (current_name && strncmp(current_name, "__", 2) == 0) {
+    if (!current_is_system || !new_is_system)
+      return VAULT_ERR_INVALID_PARAM;
+  } else if (new_is_system) {
+    return VAULT_ERR_INVALID_PARAM;
+  }
+  return VAULT_OK;
+}
+
+typedef struct {
+  const uint8_t *id;
+  uint32_t request;
+} id_lookup_t;
+
+static int compare_id_lookup(const void *a, const void *b) {
+  return memcmp(((const id_lookup_t *)a)->id, ((const id_lookup_t *)b)->id,
+                VAULT_ID_LEN);
+}
+
+// Resolve count packed file IDs to entry indices with one pass over the
+// index (sorted lookup), rejecting duplicates and unknown IDs.
+static int resolve_file_ids(const uint8_t *file_ids, uint32_t count,
+                            uint32_t *indices_out) {
+  id_lookup_t *lookup = malloc(count * sizeof(id_lookup_t));
+  if (!lookup)
+    return VAULT_ERR_MEMORY;
+  for (uint32_t i = 0; i < count; i++) {
+    lookup[i].id = file_ids + (size_t)i * VAULT_ID_LEN;
+    lookup[i].request = i;
+    indices_out[i] = UINT32_MAX;
+  }
+  qsort(lookup, count, sizeof(id_lookup_t), compare_id_lookup);
+  for (uint32_t i = 1; i < count; i++) {
+    if (compare_id_lookup(&lookup[i - 1], &lookup[i]) == 0) {
+      free(lookup);
+      return VAULT_ERR_INVALID_PARAM;
+    }
+  }
+
+  uint32_t resolved = 0;
+  for (uint32_t e = 0; e < g_vault.entry_count && resolved < count; e++) {
+    id_lookup_t key = {g_vault.entries[e].file_id, 0};
+    id_lookup_t *hit =
+        bsearch(&key, lookup, count, sizeof(id_lookup_t), compare_id_lookup);
+    if (hit && indices_out[hit->request] == UINT32_MAX) {
+      indices_out[hit->request] = e;
+      resolved++;
+    }
+  }
+  free(lookup);
+  return resolved == count ? VAULT_OK : VAULT_ERR_NOT_FOUND;
 }
 
 // Helper: Get current timestamp in milliseconds
@@ -84,12 +230,24 @@ int vault_import_file(const uint8_t *data, size_t len, uint8_t type,
   int result = VAULT_OK;
   vault_entry_t new_entry;
   vault_payload_t new_payload;
+  import_chunk_source_t chunk_source;
   memset(&new_entry, 0, sizeof(new_entry));
   memset(&new_payload, 0, sizeof(new_payload));
+  memset(&chunk_source, 0, sizeof(chunk_source));
+
+  // Videos keep the 1 MB layout; other content larger than one streaming
+  // chunk is stored in that layout so its ciphertext never exists in full.
+  // System entries stay single blobs for vault_read_file.
+  size_t chunk_size = 0;
+  if (type == VAULT_FILE_TYPE_VIDEO)
+    chunk_size = VAULT_CHUNK_SIZE;
+  else if (len > STREAMING_CHUNK_SIZE && strncmp(name, "__", 2) != 0)
+    chunk_size = STREAMING_CHUNK_SIZE;
 
   LOGI("vault_import_file: building entry");
-  if (type == VAULT_FILE_TYPE_VIDEO) {
-    result = build_video_entry(data, len, name, mime, &new_entry, &new_payload);
+  if (chunk_size > 0) {
+    result = prepare_chunked_entry(data, len, type, name, mime, chunk_size,
+                                   &new_entry, &chunk_source);
   } else {
     result = build_text_image_entry(data, len, type, name, mime, &new_entry,
                                     &new_payload);
@@ -101,9 +259,30 @@ int vault_import_file(const uint8_t *data, size_t len, uint8_t type,
   }
   LOGI("vault_import_file: entry built successfully");
 
+  // Text content is tokenized now, while the plaintext is already in memory;
+  // the term record is encrypted with the index.
+  if (type == VAULT_FILE_TYPE_TXT && strncmp(name, "__", 2) != 0 &&
+      vault_search_is_indexable(mime)) {
+    result = vault_search_attach_terms(&new_entry, data, len);
+    if (result != VAULT_OK) {
+      LOGE("vault_import_file: search terms failed with %d", result);
+      vault_free_entry(&new_entry);
+      free_payload(&new_payload);
+      return result;
+    }
+  }
+
   // Append only the new encrypted payload and updated index; existing payloads
-  // are never loaded or copied.
-  result = vault_append_entry(&new_entry, &new_payload);
+  // are never loaded or copied. Chunks are encrypted one at a time into a
+  // reused buffer and written straight to the container tail.
+  if (chunk_size > 0) {
+    result = vault_append_entry_from_source(&new_entry, encrypt_import_chunk,
+                                            &chunk_source,
+                                            chunk_size + VAULT_TAG_LEN);
+    vault_zeroize(&chunk_source, sizeof(chunk_source));
+  } else {
+    result = vault_append_entry(&new_entry, &new_payload);
+  }
 
   // Copy file_id BEFORE freeing entry (vault_append_entry made deep copies)
   memcpy(file_id_out, new_entry.file_id, VAULT_ID_LEN);
@@ -141,7 +320,12 @@ int vault_read_file(const uint8_t file_id[VAULT_ID_LEN], uint8_t **data_out,
   // Streaming import stores all large files as chunked, regardless of type
   if (entry->chunk_count > 0)
     return VAULT_ERR_INVALID_PARAM;
+  vault_tier_note_access(entry->file_id);
+  return vault_decrypt_entry_blob(entry, data_out, len_out);
+}
 
+int vault_decrypt_entry_blob(const vault_entry_t *entry, uint8_t **data_out,
+                             size_t *len_out) {
   uint8_t dek[VAULT_KEY_LEN];
   int result = unwrap_dek(entry, dek);
   if (result != VAULT_OK) {
@@ -219,18 +403,22 @@ int vault_read_chunk(const uint8_t file_id[VAULT_ID_LEN], uint32_t chunk_idx,
     return VAULT_ERR_INVALID_PARAM;
   if (chunk_idx >= entry->chunk_count)
     return VAULT_ERR_NOT_FOUND;
+  vault_tier_note_access(entry->file_id);
+  return vault_decrypt_entry_chunk(entry, chunk_idx, data_out, len_out);
+}
 
+int vault_decrypt_entry_chunk(const vault_entry_t *entry, uint32_t chunk_idx,
+                              uint8_t **data_out, size_t *len_out) {
   uint8_t dek[VAULT_KEY_LEN];
   int result = unwrap_dek(entry, dek);
   if (result != VAULT_OK) {
     return result;
   }
 
-  uint64_t offset = entry->chunks[chunk_idx].offset;
   uint64_t length = entry->chunks[chunk_idx].length;
 
   uint8_t *ciphertext = NULL;
-  result = load_blob(offset, length, &ciphertext);
+  result = load_chunk(entry, chunk_idx, &ciphertext);
   if (result != VAULT_OK) {
     vault_zeroize(dek, VAULT_KEY_LEN);
     return result;
@@ -276,71 +464,424 @@ int vault_read_chunk(const uint8_t file_id[VAULT_ID_LEN], uint32_t chunk_idx,
   return VAULT_OK;
 }
 
-int vault_delete_file(const uint8_t file_id[VAULT_ID_LEN]) {
+typedef struct {
+  const vault_entry_t *entry;
+  const uint8_t *dek;
+  const uint8_t *ciphertext; // window buffer
+  uint64_t window_offset;    // file offset of ciphertext[0]
+  uint32_t first;            // first chunk of the window
+  uint32_t count;            // chunks in the window
+  const size_t *pt_offsets;  // plaintext offset of each requested chunk
+  uint32_t pt_base;          // request index of chunk `first`
+  uint8_t *out;
+  size_t out_cap;
+  atomic_uint next_index;
+  atomic_int result;
+} read_chunks_job_t;
+
+static int read_fully_at(int fd, uint8_t *buf, size_t len, uint64_t offset) {
+  while (len > 0) {
+    ssize_t n = pread(fd, buf, len, (off_t)offset);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return VAULT_ERR_IO;
+    buf += n;
+    len -= (size_t)n;
+    offset += (uint64_t)n;
+  }
+  return VAULT_OK;
+}
+
+static int decrypt_window_chunk(read_chunks_job_t *job, uint32_t i) {
+  uint32_t chunk_idx = job->first + i;
+  uint64_t offset = job->entry->chunks[chunk_idx].offset;
+  uint32_t length = job->entry->chunks[chunk_idx].length;
+  const uint8_t *nonce = job->entry->chunks[chunk_idx].nonce;
+
+  vault_aad_t aad = {0};
+  memcpy(aad.vault_id, g_vault.vault_id, VAULT_ID_LEN);
+  memcpy(aad.file_id, job->entry->file_id, VAULT_ID_LEN);
+  aad.chunk_index = chunk_idx;
+  aad.format_version = VAULT_VERSION;
+
+  const uint8_t *ct = job->ciphertext + (offset - job->window_offset);
+  size_t pt_len = length - VAULT_TAG_LEN;
+  size_t pt_off = job->pt_offsets[job->pt_base + i];
+  size_t pt_out = 0;
+
+  // Decrypt straight into the caller's buffer unless the chunk is cut off
+  // by out_cap; only that last chunk goes through a temporary.
+  if (pt_off + pt_len <= job->out_cap) {
+    return vault_aead_decrypt(job->dek, nonce, (uint8_t *)&aad, sizeof(aad),
+                              ct, length,
+                              job->out + pt_off, &pt_out);
+  }
+
+  uint8_t *tmp = malloc(pt_len > 0 ? pt_len : 1);
+  if (!tmp)
+    return VAULT_ERR_MEMORY;
+  int result = vault_aead_decrypt(job->dek, nonce, (uint8_t *)&aad,
+                                  sizeof(aad), ct, length, tmp, &pt_out);
+  if (result == VAULT_OK)
+    memcpy(job->out + pt_off, tmp, job->out_cap - pt_off);
+  vault_zeroize(tmp, pt_len);
+  free(tmp);
+  return result;
+}
+
+static void *read_chunks_worker(void *arg) {
+  read_chunks_job_t *job = arg;
+  for (;;) {
+    uint32_t i = atomic_fetch_add(&job->next_index, 1);
+    if (i >= job->count || atomic_load(&job->result) != VAULT_OK)
+      break;
+    int result = decrypt_window_chunk(job, i);
+    if (result != VAULT_OK)
+      atomic_store(&job->result, result);
+  }
+  return NULL;
+}
+
+static int decrypt_window(read_chunks_job_t *job, uint64_t window_len) {
+  atomic_init(&job->next_index, 0);
+  atomic_init(&job->result, VAULT_OK);
+
+  // Not governed: these reads feed playback and the viewer, which the
+  // governor protects from background jobs.
+  uint32_t thread_count = 1;
+  if (window_len >= READ_CHUNKS_PARALLEL_MIN) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    thread_count = cpus > 0 ? (uint32_t)cpus : 1;
+    if (thread_count > READ_CHUNKS_MAX_THREADS)
+      thread_count = READ_CHUNKS_MAX_THREADS;
+  }
+  if (thread_count > job->count)
+    thread_count = job->count;
+
+  // The calling thread is one of the workers.
+  pthread_t threads[READ_CHUNKS_MAX_THREADS];
+  uint32_t started = 0;
+  for (uint32_t t = 1; t < thread_count; t++) {
+    if (pthread_create(&threads[started], NULL, read_chunks_worker, job) != 0)
+      break;
+    started++;
+  }
+  read_chunks_worker(job);
+  for (uint32_t t = 0; t < started; t++)
+    pthread_join(threads[t], NULL);
+  return atomic_load(&job->result);
+}
+
+int vault_read_chunks(const uint8_t file_id[VAULT_ID_LEN], uint32_t first,
+                      uint32_t count, uint8_t *out, size_t out_cap,
+                      size_t *len_out) {
   if (!g_vault.is_open)
     return VAULT_ERR_NOT_OPEN;
-  if (!file_id)
+  if (!file_id || !out || !len_out || count == 0 || out_cap == 0)
     return VAULT_ERR_INVALID_PARAM;
+  *len_out = 0;
 
-  int found_idx = -1;
+  vault_entry_t *entry = NULL;
   for (uint32_t i = 0; i < g_vault.entry_count; i++) {
     if (memcmp(g_vault.entries[i].file_id, file_id, VAULT_ID_LEN) == 0) {
-      found_idx = (int)i;
+      entry = &g_vault.entries[i];
       break;
     }
   }
-  if (found_idx < 0)
+  if (!entry)
+    return VAULT_ERR_NOT_FOUND;
+  if (entry->chunk_count == 0)
+    return VAULT_ERR_INVALID_PARAM;
+  if (first >= entry->chunk_count || count > entry->chunk_count - first)
     return VAULT_ERR_NOT_FOUND;
+  vault_tier_note_access(entry->file_id);
 
-  uint32_t old_count = g_vault.entry_count;
-  vault_entry_t *backup_entries = NULL;
-  int result = clone_entries(g_vault.entries, old_count, &backup_entries);
-  if (result != VAULT_OK)
+  // Plaintext layout; chunks starting at or past out_cap are not read.
+  size_t *pt_offsets = malloc(count * sizeof(size_t));
+  if (!pt_offsets)
+    return VAULT_ERR_MEMORY;
+  size_t total = 0;
+  uint32_t needed = 0;
+  for (; needed < count && total < out_cap; needed++) {
+    uint64_t length = entry->chunks[first + needed].length;
+    if (length < VAULT_TAG_LEN) {
+      free(pt_offsets);
+      return VAULT_ERR_CORRUPTED;
+    }
+    pt_offsets[needed] = total;
+    total += (size_t)(length - VAULT_TAG_LEN);
+  }
+  if (total > out_cap)
+    total = out_cap;
+
+  uint8_t dek[VAULT_KEY_LEN];
+  int result = unwrap_dek(entry, dek);
+  if (result != VAULT_OK) {
+    free(pt_offsets);
     return result;
+  }
 
-  // Remove from the encrypted index only. The retired per-commit index key
-  // makes the orphaned ciphertext inaccessible; compaction reclaims its space.
+  uint8_t *window = NULL;
+  size_t window_cap = 0;
+  // Cold chunks come from the segment; its descriptor is opened on demand
+  int fds[2] = {-1, -1};
+
+  for (uint32_t start = 0; start < needed && result == VAULT_OK;) {
+    // Grow the window over chunks that are adjacent on disk.
+    int cold = vault_tier_chunk_is_cold(entry, first + start);
+    uint64_t win_off = entry->chunks[first + start].offset;
+    uint64_t win_len = entry->chunks[first + start].length;
+    uint32_t end = start + 1;
+    while (end < needed &&
+           vault_tier_chunk_is_cold(entry, first + end) == cold &&
+           entry->chunks[first + end].offset == win_off + win_len &&
+           win_len + entry->chunks[first + end].length <= READ_CHUNKS_WINDOW) {
+      win_len += entry->chunks[first + end].length;
+      end++;
+    }
+
+    if (win_len > window_cap) {
+      if (window) {
+        vault_zeroize(window, window_cap);
+        free(window);
+      }
+      window = malloc((size_t)win_len);
+      window_cap = window ? (size_t)win_len : 0;
+      if (!window) {
+        result = VAULT_ERR_MEMORY;
+        break;
+      }
+    }
+
+    if (fds[cold] < 0) {
+      fds[cold] = vault_tier_open_chunk(entry, first + start);
+      if (fds[cold] < 0) {
+        result = VAULT_ERR_IO;
+        break;
+      }
+    }
+    result = read_fully_at(fds[cold], window, (size_t)win_len, win_off);
+    if (result != VAULT_OK)
+      break;
 
-  uint32_t new_count = g_vault.entry_count - 1;
+    read_chunks_job_t job = {.entry = entry,
+                             .dek = dek,
+                             .ciphertext = window,
+                             .window_offset = win_off,
+                             .first = first + start,
+                             .count = end - start,
+                             .pt_offsets = pt_offsets,
+                             .pt_base = start,
+                             .out = out,
+                             .out_cap = out_cap};
+    result = decrypt_window(&job, win_len);
+    start = end;
+  }
 
-  // Free the entry being deleted
-  vault_free_entry(&g_vault.entries[found_idx]);
+  for (int i = 0; i < 2; i++) {
+    if (fds[i] >= 0)
+      close(fds[i]);
+  }
+  vault_zeroize(dek, VAULT_KEY_LEN);
+  if (window) {
+    vault_zeroize(window, window_cap);
+    free(window);
+  }
+  free(pt_offsets);
 
-  // Shift remaining entries down
-  if ((uint32_t)found_idx < new_count) {
-    memmove(&g_vault.entries[found_idx], &g_vault.entries[found_idx + 1],
-            (new_count - found_idx) * sizeof(vault_entry_t));
+  if (result != VAULT_OK) {
+    vault_zeroize(out, total);
+    return result;
   }
+  *len_out = total;
+  return VAULT_OK;
+}
 
-  // Update count
-  g_vault.entry_count = new_count;
+int vault_read_range(const uint8_t file_id[VAULT_ID_LEN], uint64_t offset,
+                     uint8_t *out, size_t len, size_t *len_out) {
+  if (!g_vault.is_open)
+    return VAULT_ERR_NOT_OPEN;
+  if (!file_id || !out || !len_out)
+    return VAULT_ERR_INVALID_PARAM;
+  *len_out = 0;
 
-  // Resize array if needed (optional, can skip for performance)
-  if (new_count > 0) {
-    vault_entry_t *resized =
-        realloc(g_vault.entries, new_count * sizeof(vault_entry_t));
-    if (resized) {
-      g_vault.entries = resized;
+  vault_entry_t *entry = NULL;
+  for (uint32_t i = 0; i < g_vault.entry_count; i++) {
+    if (memcmp(g_vault.entries[i].file_id, file_id, VAULT_ID_LEN) == 0) {
+      entry = &g_vault.entries[i];
+      break;
     }
-    // If realloc fails, we still have valid data, just wasted space
-  } else {
-    free(g_vault.entries);
-    g_vault.entries = NULL;
   }
+  if (!entry)
+    return VAULT_ERR_NOT_FOUND;
+  if (offset >= entry->size || len == 0)
+    return VAULT_OK;
+  if (len > entry->size - offset)
+    len = (size_t)(entry->size - offset);
+
+  uint8_t *data = NULL;
+  size_t data_len = 0;
+  int result;
+
+  if (entry->chunk_count == 0) {
+    // Single-blob entries are small; decrypt whole and copy the slice
+    result = vault_read_file(file_id, &data, &data_len);
+    if (result == VAULT_OK && data_len != entry->size)
+      result = VAULT_ERR_CORRUPTED;
+    if (result == VAULT_OK)
+      memcpy(out, data + offset, len);
+    if (data) {
+      vault_zeroize(data, data_len);
+      vault_free(data);
+    }
+    if (result != VAULT_OK)
+      return result;
+    *len_out = len;
+    return VAULT_OK;
+  }
+
+  // Locate the chunk holding offset from the plaintext chunk lengths
+  uint32_t first = 0;
+  uint64_t chunk_start = 0;
+  for (; first < entry->chunk_count; first++) {
+    uint64_t length = entry->chunks[first].length;
+    if (length < VAULT_TAG_LEN)
+      return VAULT_ERR_CORRUPTED;
+    if (offset < chunk_start + (length - VAULT_TAG_LEN))
+      break;
+    chunk_start += length - VAULT_TAG_LEN;
+  }
+  if (first == entry->chunk_count)
+    return VAULT_ERR_CORRUPTED;
 
+  size_t done = 0;
+  uint64_t skip = offset - chunk_start;
+  if (skip > 0) {
+    result = vault_read_chunk(file_id, first, &data, &data_len);
+    if (result == VAULT_OK && data_len <= skip)
+      result = VAULT_ERR_CORRUPTED;
+    if (result == VAULT_OK) {
+      done = data_len - (size_t)skip < len ? data_len - (size_t)skip : len;
+      memcpy(out, data + skip, done);
+    }
+    if (data) {
+      vault_zeroize(data, data_len);
+      vault_free(data);
+    }
+    if (result != VAULT_OK)
+      return result;
+    first++;
+  }
+
+  if (done < len) {
+    // Whole chunks from here; the last one may be cut short by len
+    uint32_t count = 0;
+    uint64_t covered = 0;
+    while (first + count < entry->chunk_count && covered < len - done) {
+      covered += entry->chunks[first + count].length - VAULT_TAG_LEN;
+      count++;
+    }
+    size_t written = 0;
+    result = count > 0 ? vault_read_chunks(file_id, first, count, out + done,
+                                           len - done, &written)
+                       : VAULT_ERR_CORRUPTED;
+    if (result != VAULT_OK) {
+      vault_zeroize(out, done);
+      return result;
+    }
+    done += written;
+  }
+  *len_out = done;
+  return VAULT_OK;
+}
+
+int vault_delete_file(const uint8_t file_id[VAULT_ID_LEN]) {
+  if (!g_vault.is_open)
+    return VAULT_ERR_NOT_OPEN;
+  if (!file_id)
+    return VAULT_ERR_INVALID_PARAM;
+  return vault_delete_files(file_id, 1);
+}
+
+// Drop the entries flagged in doomed (deleted of them) and commit the
+// index. Entries are moved by value, so nothing is freed until the commit
+// lands; on failure the previous array and stats are restored.
+static int commit_without_doomed(const uint8_t *doomed, uint32_t deleted) {
   // Save only index section - doesn't load any payloads
-  result = vault_save_index_only();
+  if (deleted == 0)
+    return vault_save_index_only();
+
+  uint32_t old_count = g_vault.entry_count;
+  vault_entry_t *old_entries = g_vault.entries;
+  vault_entry_t *kept = NULL;
+  if (old_count > deleted) {
+    kept = malloc((old_count - deleted) * sizeof(vault_entry_t));
+    if (!kept)
+      return VAULT_ERR_MEMORY;
+  }
+  vault_stats_t backup_stats = g_vault.stats;
+  int backup_largest_stale = g_vault.stats_largest_stale;
+  for (uint32_t e = 0, k = 0; e < old_count; e++) {
+    if (doomed[e])
+      vault_stats_remove_entry(&old_entries[e]);
+    else
+      kept[k++] = old_entries[e];
+  }
+  g_vault.entries = kept;
+  g_vault.entry_count = old_count - deleted;
+
+  int result = vault_save_index_only();
   if (result != VAULT_OK) {
-    LOGE("vault_delete_file: vault_save_index_only failed with %d", result);
-    free_entries_array(g_vault.entries, g_vault.entry_count);
-    g_vault.entries = backup_entries;
+    // Legacy rewrites may have replaced the array with a deep copy.
+    if (g_vault.entries != kept)
+      free_entries_array(g_vault.entries, g_vault.entry_count);
+    else
+      free(kept);
+    g_vault.entries = old_entries;
     g_vault.entry_count = old_count;
-    backup_entries = NULL;
+    g_vault.stats = backup_stats;
+    g_vault.stats_largest_stale = backup_largest_stale;
+    return result;
   }
 
-  if (backup_entries)
-    free_entries_array(backup_entries, old_count);
+  for (uint32_t e = 0; e < old_count; e++) {
+    if (doomed[e]) {
+      vault_search_remove_entry(old_entries[e].file_id);
+      vault_tier_forget_access(old_entries[e].file_id);
+      vault_free_entry(&old_entries[e]);
+    }
+  }
+  free(old_entries);
+  return VAULT_OK;
+}
 
+int vault_delete_files(const uint8_t *file_ids, uint32_t count) {
+  if (!g_vault.is_open)
+    return VAULT_ERR_NOT_OPEN;
+  if (!file_ids || count == 0 || count > g_vault.entry_count)
+    return VAULT_ERR_INVALID_PARAM;
+
+  uint32_t *indices = malloc(count * sizeof(uint32_t));
+  uint8_t *doomed = calloc(g_vault.entry_count, 1);
+  if (!indices || !doomed) {
+    free(indices);
+    free(doomed);
+    return VAULT_ERR_MEMORY;
+  }
+  int result = resolve_file_ids(file_ids, count, indices);
+  if (result == VAULT_OK) {
+    for (uint32_t i = 0; i < count; i++)
+      doomed[indices[i]] = 1;
+    // Remove from the encrypted index only. The retired per-commit index
+    // key makes the orphaned ciphertext inaccessible; compaction reclaims
+    // its space.
+    result = commit_without_doomed(doomed, count);
+    if (result != VAULT_OK)
+      LOGE("vault_delete_files: commit failed with %d", result);
+  }
+  free(indices);
+  free(doomed);
   return result;
 }
 
@@ -350,71 +891,467 @@ int vault_rename_file(const uint8_t file_id[VAULT_ID_LEN],
     return VAULT_ERR_NOT_OPEN;
   if (!file_id || !new_name)
     return VAULT_ERR_INVALID_PARAM;
+  return vault_rename_files(file_id, &new_name, 1);
+}
 
-  size_t name_len = strlen(new_name);
-  if (name_len == 0 || name_len > 4096)
-    return VAULT_ERR_INVALID_PARAM;
-  const int new_is_system = is_allowed_system_name(new_name);
-  if (strncmp(new_name, "__", 2) == 0 && !new_is_system) {
+int vault_rename_files(const uint8_t *file_ids, const char *const *new_names,
+                       uint32_t count) {
+  if (!g_vault.is_open)
+    return VAULT_ERR_NOT_OPEN;
+  if (!file_ids || !new_names || count == 0 || count > g_vault.entry_count)
     return VAULT_ERR_INVALID_PARAM;
+
+  uint32_t *indices = malloc(count * sizeof(uint32_t));
+  char **old_names = calloc(count, sizeof(char *));
+  char **new_copies = calloc(count, sizeof(char *));
+  int result = VAULT_OK;
+  if (!indices || !old_names || !new_copies) {
+    result = VAULT_ERR_MEMORY;
+    goto cleanup;
   }
+  result = resolve_file_ids(file_ids, count, indices);
+  if (result != VAULT_OK)
+    goto cleanup;
 
-  int found_idx = -1;
-  for (uint32_t i = 0; i < g_vault.entry_count; i++) {
-    if (memcmp(g_vault.entries[i].file_id, file_id, VAULT_ID_LEN) == 0) {
-      found_idx = (int)i;
-      break;
+  // Validate the whole batch before touching any entry.
+  for (uint32_t i = 0; i < count; i++) {
+    result = validate_rename(&g_vault.entries[indices[i]], new_names[i]);
+    if (result != VAULT_OK)
+      goto cleanup;
+    new_copies[i] = strdup(new_names[i]);
+    if (!new_copies[i]) {
+      result = VAULT_ERR_MEMORY;
+      goto cleanup;
     }
   }
-  if (found_idx < 0)
-    return VAULT_ERR_NOT_FOUND;
 
-  const char *current_name = g_vault.entries[found_idx].name;
-  const int current_is_system = is_allowed_system_name(current_name);
-  if (current_name && strncmp(current_name, "__", 2) == 0) {
-    if (!current_is_system || !new_is_system) {
-      return VAULT_ERR_INVALID_PARAM;
+  // Update only the encrypted index; payload size does not affect this commit.
+  for (uint32_t i = 0; i < count; i++) {
+    old_names[i] = g_vault.entries[indices[i]].name;
+    g_vault.entries[indices[i]].name = new_copies[i];
+    new_copies[i] = NULL;
+  }
+
+  // Save only index section - doesn't load any payloads
+  result = vault_save_index_only();
+  if (result != VAULT_OK) {
+    LOGE("vault_rename_files: vault_save_index_only failed with %d", result);
+    for (uint32_t i = 0; i < count; i++) {
+      new_copies[i] = g_vault.entries[indices[i]].name;
+      g_vault.entries[indices[i]].name = old_names[i];
+      old_names[i] = NULL;
     }
-  } else if (new_is_system) {
+  }
+
+cleanup:
+  for (uint32_t i = 0; old_names && i < count; i++) {
+    // Securely zeroize and free replaced names
+    if (old_names[i]) {
+      vault_zeroize(old_names[i], strlen(old_names[i]));
+      free(old_names[i]);
+    }
+  }
+  for (uint32_t i = 0; new_copies && i < count; i++) {
+    if (new_copies[i]) {
+      vault_zeroize(new_copies[i], strlen(new_copies[i]));
+      free(new_copies[i]);
+    }
+  }
+  free(old_names);
+  free(new_copies);
+  free(indices);
+  return result;
+}
+
+// Resolve the file IDs of a metadata batch to entry indices. Unlike
+// resolve_file_ids the same ID may appear several times (rename, then
+// delete); unknown IDs resolve to UINT32_MAX.
+static int resolve_op_ids(const vault_meta_op_t *ops, uint32_t count,
+                          uint32_t *indices_out) {
+  id_lookup_t *lookup = malloc(count * sizeof(id_lookup_t));
+  if (!lookup)
+    return VAULT_ERR_MEMORY;
+  for (uint32_t i = 0; i < count; i++) {
+    lookup[i].id = ops[i].file_id;
+    lookup[i].request = i;
+    indices_out[i] = UINT32_MAX;
+  }
+  qsort(lookup, count, sizeof(id_lookup_t), compare_id_lookup);
+
+  uint32_t resolved = 0;
+  for (uint32_t e = 0; e < g_vault.entry_count && resolved < count; e++) {
+    id_lookup_t key = {g_vault.entries[e].file_id, 0};
+    id_lookup_t *hit =
+        bsearch(&key, lookup, count, sizeof(id_lookup_t), compare_id_lookup);
+    if (!hit)
+      continue;
+    while (hit > lookup && compare_id_lookup(hit - 1, &key) == 0)
+      hit--;
+    for (; hit < lookup + count && compare_id_lookup(hit, &key) == 0; hit++) {
+      indices_out[hit->request] = e;
+      resolved++;
+    }
+  }
+  free(lookup);
+  return VAULT_OK;
+}
+
+int vault_commit_metadata_ops(const vault_meta_op_t *ops, uint32_t count,
+                              int *status_out) {
+  if (!ops || !status_out || count == 0)
     return VAULT_ERR_INVALID_PARAM;
+  if (!g_vault.is_open) {
+    for (uint32_t i = 0; i < count; i++)
+      status_out[i] = VAULT_ERR_NOT_OPEN;
+    return VAULT_ERR_NOT_OPEN;
   }
 
-  uint32_t entry_count = g_vault.entry_count;
-  vault_entry_t *backup_entries = NULL;
-  int result = clone_entries(g_vault.entries, entry_count, &backup_entries);
+  uint32_t old_count = g_vault.entry_count;
+  vault_entry_t *old_entries = g_vault.entries;
+  uint32_t *indices = malloc(count * sizeof(uint32_t));
+  char **old_names = calloc(count, sizeof(char *));
+  uint8_t *doomed = calloc(old_count ? old_count : 1, 1);
+  int result = VAULT_OK;
+  if (!indices || !old_names || !doomed) {
+    result = VAULT_ERR_MEMORY;
+    goto fail_all;
+  }
+  result = resolve_op_ids(ops, count, indices);
+  if (result != VAULT_OK)
+    goto fail_all;
+
+  // Apply in arrival order so each operation sees the ones before it.
+  // Renames swap the name in place; deletes only mark the entry.
+  uint32_t applied = 0;
+  uint32_t deleted = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t e = indices[i];
+    if (e == UINT32_MAX || doomed[e]) {
+      status_out[i] = VAULT_ERR_NOT_FOUND;
+      continue;
+    }
+    if (ops[i].kind == VAULT_META_OP_DELETE) {
+      doomed[e] = 1;
+      deleted++;
+    } else if (ops[i].kind == VAULT_META_OP_RENAME) {
+      int valid = validate_rename(&old_entries[e], ops[i].new_name);
+      char *copy = valid == VAULT_OK ? strdup(ops[i].new_name) : NULL;
+      if (!copy) {
+        status_out[i] = valid == VAULT_OK ? VAULT_ERR_MEMORY : valid;
+        continue;
+      }
+      old_names[i] = old_entries[e].name;
+      old_entries[e].name = copy;
+    } else {
+      status_out[i] = VAULT_ERR_INVALID_PARAM;
+      continue;
+    }
+    status_out[i] = VAULT_OK;
+    applied++;
+  }
+  if (applied == 0)
+    goto cleanup;
+
+  LOGI("vault_commit_metadata_ops: %u of %u operations in one commit",
+       applied, count);
+  result = commit_without_doomed(doomed, deleted);
+  if (result == VAULT_OK)
+    goto cleanup;
+  LOGE("vault_commit_metadata_ops: commit failed with %d", result);
+
+  // Undo renames newest first so chained renames of one entry unwind
+  // correctly; the discarded names end up in old_names for cleanup. The
+  // entry array is the pre-batch one again, so indices still apply.
+  for (uint32_t i = count; i-- > 0;) {
+    if (old_names[i]) {
+      char *discarded = g_vault.entries[indices[i]].name;
+      g_vault.entries[indices[i]].name = old_names[i];
+      old_names[i] = discarded;
+    }
+    if (status_out[i] == VAULT_OK)
+      status_out[i] = result;
+  }
+  goto cleanup;
+
+fail_all:
+  for (uint32_t i = 0; i < count; i++)
+    status_out[i] = result;
+
+cleanup:
+  for (uint32_t i = 0; old_names && i < count; i++) {
+    if (old_names[i]) {
+      vault_zeroize(old_names[i], strlen(old_names[i]));
+      free(old_names[i]);
+    }
+  }
+  free(old_names);
+  free(indices);
+  free(doomed);
+  return result;
+}
+
+int vault_write_file_range(const uint8_t file_id[VAULT_ID_LEN],
+                           uint64_t offset, const uint8_t *data, size_t len) {
+  if (!g_vault.is_open)
+    return VAULT_ERR_NOT_OPEN;
+  if (!file_id || !data || len == 0)
+    return VAULT_ERR_INVALID_PARAM;
+
+  uint32_t index;
+  int result = resolve_file_ids(file_id, 1, &index);
+  if (result != VAULT_OK)
+    return result;
+  const vault_entry_t *entry = &g_vault.entries[index];
+  // Writes may extend the file but never leave a hole
+  if (offset > entry->size || len > UINT64_MAX - offset)
+    return VAULT_ERR_INVALID_PARAM;
+  uint64_t end = offset + len;
+  uint64_t new_size = end > entry->size ? end : entry->size;
+
+  update_chunk_source_t source;
+  memset(&source, 0, sizeof(source));
+  source.entry = entry;
+  source.new_size = new_size;
+  source.offset = offset;
+  source.data = data;
+  source.len = len;
+  size_t plain_len = 0;
+  uint32_t first = 0;
+  uint32_t count = 1;
+  size_t max_chunk_len = 0;
+
+  vault_entry_t *updated = NULL;
+  result = clone_entries(entry, 1, &updated);
   if (result != VAULT_OK)
     return result;
+  updated->size = new_size;
+
+  if (entry->chunk_count > 0) {
+    size_t chunk_size = entry_chunk_size(entry);
+    if (chunk_size == 0 ||
+        (entry->size + chunk_size - 1) / chunk_size != entry->chunk_count) {
+      result = VAULT_ERR_CORRUPTED;
+      goto cleanup;
+    }
+    uint64_t new_count = (new_size + chunk_size - 1) / chunk_size;
+    if (new_size > STREAMING_MAX_FILE_SIZE || new_count > UINT32_MAX) {
+      result = VAULT_ERR_INVALID_PARAM;
+      goto cleanup;
+    }
+    if (new_count > updated->chunk_count) {
+      void *grown =
+          realloc(updated->chunks, new_count * sizeof(updated->chunks[0]));
+      if (!grown) {
+        result = VAULT_ERR_MEMORY;
+        goto cleanup;
+      }
+      updated->chunks = grown;
+      memset(&updated->chunks[updated->chunk_count], 0,
+             (new_count - updated->chunk_count) * sizeof(updated->chunks[0]));
+      updated->chunk_count = (uint32_t)new_count;
+    }
+    first = (uint32_t)(offset / chunk_size);
+    count = (uint32_t)((end - 1) / chunk_size) - first + 1;
+    source.chunk_size = chunk_size;
+    plain_len = chunk_size;
+    max_chunk_len = chunk_size + VAULT_TAG_LEN;
+  } else {
+    // Single blobs hold small text and images and are rewritten whole
+    if (new_size > SIZE_MAX - VAULT_TAG_LEN) {
+      result = VAULT_ERR_INVALID_PARAM;
+      goto cleanup;
+    }
+    plain_len = (size_t)new_size;
+    max_chunk_len = plain_len + VAULT_TAG_LEN;
+  }
 
-  // Update only the encrypted index; payload size does not affect this commit.
-  char *new_name_copy = strdup(new_name);
-  if (!new_name_copy) {
-    free_entries_array(backup_entries, entry_count);
-    return VAULT_ERR_MEMORY;
+  source.plain = malloc(plain_len);
+  if (!source.plain) {
+    result = VAULT_ERR_MEMORY;
+    goto cleanup;
   }
 
-  // Securely zeroize and free old name
-  if (g_vault.entries[found_idx].name) {
-    vault_zeroize(g_vault.entries[found_idx].name,
-                  strlen(g_vault.entries[found_idx].name));
-    free(g_vault.entries[found_idx].name);
+  if (entry->chunk_count == 0) {
+    uint8_t *old_data = NULL;
+    size_t old_len = 0;
+    result = vault_read_file(file_id, &old_data, &old_len);
+    if (result != VAULT_OK)
+      goto cleanup;
+    if (old_len == entry->size) {
+      memcpy(source.plain, old_data, old_len);
+      memcpy(source.plain + offset, data, len);
+    } else {
+      result = VAULT_ERR_CORRUPTED;
+    }
+    vault_zeroize(old_data, old_len);
+    free(old_data);
+    if (result != VAULT_OK)
+      goto cleanup;
+
+    if (entry->type == VAULT_FILE_TYPE_TXT && entry->name &&
+        strncmp(entry->name, "__", 2) != 0 &&
+        vault_search_is_indexable(entry->mime)) {
+      result = vault_search_attach_terms(updated, source.plain, plain_len);
+      if (result != VAULT_OK)
+        goto cleanup;
+    }
   }
-  g_vault.entries[found_idx].name = new_name_copy;
 
-  // Save only index section - doesn't load any payloads
-  result = vault_save_index_only();
-  if (result != VAULT_OK) {
-    LOGE("vault_rename_file: vault_save_index_only failed with %d", result);
-    free_entries_array(g_vault.entries, g_vault.entry_count);
-    g_vault.entries = backup_entries;
-    backup_entries = NULL;
+  // Stored playback metadata described the old content
+  result = vault_entry_ext_set(updated, VAULT_EXT_MEDIA_INFO, NULL, 0);
+  if (result != VAULT_OK)
+    goto cleanup;
+
+  result = unwrap_dek(entry, source.dek);
+  if (result != VAULT_OK)
+    goto cleanup;
+  memcpy(source.aad_base.vault_id, g_vault.vault_id, VAULT_ID_LEN);
+  memcpy(source.aad_base.file_id, entry->file_id, VAULT_ID_LEN);
+  source.aad_base.format_version = VAULT_VERSION;
+
+  result = vault_update_entry_from_source(updated, first, count,
+                                          encrypt_update_chunk, &source,
+                                          max_chunk_len);
+  if (result != VAULT_OK)
+    LOGE("vault_write_file_range: update failed with %d", result);
+  else
+    LOGI("File updated: %u chunk(s) rewritten, size=%llu", count,
+         (unsigned long long)new_size);
+
+cleanup:
+  if (source.plain) {
+    vault_zeroize(source.plain, plain_len);
+    free(source.plain);
+  }
+  vault_zeroize(&source, sizeof(source));
+  free_entries_array(updated, 1);
+  return result;
+}
+
+int vault_append_to_file(const uint8_t file_id[VAULT_ID_LEN],
+                         const uint8_t *data, size_t len) {
+  if (!g_vault.is_open)
+    return VAULT_ERR_NOT_OPEN;
+  if (!file_id)
+    return VAULT_ERR_INVALID_PARAM;
+
+  uint32_t index;
+  int result = resolve_file_ids(file_id, 1, &index);
+  if (result != VAULT_OK)
+    return result;
+  return vault_write_file_range(file_id, g_vault.entries[index].size, data,
+                                len);
+}
+
+// Chunked entries written by the original import path still use 1 MB chunks;
+// cold entries stay put so re-chunking never pulls data off the SD card.
+static int entry_is_legacy_chunked(const vault_entry_t *entry) {
+  if (entry->chunk_count < 2 || !entry->chunks ||
+      (entry->name && strncmp(entry->name, "__", 2) == 0) ||
+      entry_chunk_size(entry) != VAULT_CHUNK_SIZE ||
+      (entry->size + VAULT_CHUNK_SIZE - 1) / VAULT_CHUNK_SIZE !=
+          entry->chunk_count)
+    return 0;
+  for (uint32_t c = 0; c < entry->chunk_count; c++) {
+    if (vault_tier_chunk_is_cold(entry, c))
+      return 0;
   }
+  return 1;
+}
 
-  if (backup_entries)
-    free_entries_array(backup_entries, entry_count);
+static int rechunk_entry(const vault_entry_t *entry) {
+  uint64_t new_count =
+      (entry->size + STREAMING_CHUNK_SIZE - 1) / STREAMING_CHUNK_SIZE;
+  rechunk_source_t source;
+  memset(&source, 0, sizeof(source));
+  source.entry = entry;
 
+  vault_entry_t *updated = NULL;
+  int result = clone_entries(entry, 1, &updated);
+  if (result != VAULT_OK)
+    return result;
+  updated->chunk_count = (uint32_t)new_count;
+  // Every rewritten chunk lands in the container
+  result = vault_entry_ext_set(updated, VAULT_EXT_TIER, NULL, 0);
+  if (result != VAULT_OK)
+    goto cleanup;
+
+  source.plain = malloc(STREAMING_CHUNK_SIZE);
+  if (!source.plain) {
+    result = VAULT_ERR_MEMORY;
+    goto cleanup;
+  }
+  result = unwrap_dek(entry, source.dek);
+  if (result != VAULT_OK)
+    goto cleanup;
+  memcpy(source.aad_base.vault_id, g_vault.vault_id, VAULT_ID_LEN);
+  memcpy(source.aad_base.file_id, entry->file_id, VAULT_ID_LEN);
+  source.aad_base.format_version = VAULT_VERSION;
+
+  // Replaces g_vault.entries on success; entry is not used afterwards
+  result = vault_update_entry_from_source(updated, 0, (uint32_t)new_count,
+                                          encrypt_rechunk_chunk, &source,
+                                          STREAMING_CHUNK_SIZE + VAULT_TAG_LEN);
+
+cleanup:
+  if (source.plain) {
+    vault_zeroize(source.plain, STREAMING_CHUNK_SIZE);
+    free(source.plain);
+  }
+  vault_zeroize(&source, sizeof(source));
+  free_entries_array(updated, 1);
   return result;
 }
 
+int vault_rechunk_legacy(uint64_t idle_ms, uint64_t max_bytes,
+                         uint64_t *bytes_out) {
+  if (bytes_out)
+    *bytes_out = 0;
+  if (!g_vault.is_open)
+    return VAULT_ERR_NOT_OPEN;
+  if (max_bytes == 0)
+    return VAULT_ERR_INVALID_PARAM;
+  // Legacy containers are migrated to the log on open
+  if (!vault_container_is_log())
+    return VAULT_OK;
+
+  uint64_t now = get_timestamp_ms();
+  uint64_t done = 0;
+  uint32_t converted = 0;
+  // Commits replace the entry array but keep its order, so indices stay valid
+  for (uint32_t i = 0; i < g_vault.entry_count && done < max_bytes; i++) {
+    const vault_entry_t *entry = &g_vault.entries[i];
+    if (!entry_is_legacy_chunked(entry))
+      continue;
+    // Open players and exports cache the chunk layout while they read
+    uint64_t last = vault_tier_last_access(entry);
+    if (last > now || now - last < idle_ms)
+      continue;
+
+    uint64_t size = entry->size;
+    int result = rechunk_entry(entry);
+    if (result == VAULT_ERR_CORRUPTED || result == VAULT_ERR_AUTH_FAIL) {
+      // Leave a damaged file as it is; the rest can still be converted
+      LOGE("vault_rechunk_legacy: skipping entry %u (%d)", i, result);
+      continue;
+    }
+    if (result != VAULT_OK) {
+      if (bytes_out)
+        *bytes_out = done;
+      return result;
+    }
+    done += size;
+    converted++;
+  }
+
+  if (converted > 0)
+    LOGI("Re-chunked %u file(s), %llu bytes", converted,
+         (unsigned long long)done);
+  if (bytes_out)
+    *bytes_out = done;
+  return VAULT_OK;
+}
+
 int vault_list_files(vault_entry_t **entries_out, uint32_t *count_out) {
   if (!g_vault.is_open) {
     return VAULT_ERR_NOT_OPEN;
@@ -444,21 +1381,356 @@ int vault_compact(void) {
   return vault_compact_storage();
 }
 
-int vault_get_stats(uint64_t *total_size_out, uint64_t *free_space_out) {
+int vault_get_stats(vault_stats_t *stats_out) {
   if (!g_vault.is_open) {
     return VAULT_ERR_NOT_OPEN;
   }
+  if (!stats_out)
+    return VAULT_ERR_INVALID_PARAM;
+
+  // Only deleting one of the largest files forces a rescan of entry sizes.
+  if (g_vault.stats_largest_stale)
+    stats_rebuild_largest();
+
+  *stats_out = g_vault.stats;
+  stats_out->total_size = g_vault.total_size;
+  stats_out->free_space = g_vault.free_space;
+  stats_out->index_bytes = g_vault.index_length;
+  return VAULT_OK;
+}
 
-  if (total_size_out) {
-    *total_size_out = g_vault.total_size;
+// ========================================================================
+// Entry extension records
+// ========================================================================
+
+#define EXT_RECORD_HEADER (1 + sizeof(uint32_t)) // tag + length
+
+int vault_entry_ext_find(const vault_entry_t *entry, uint8_t tag,
+                         const uint8_t **data_out, uint32_t *len_out) {
+  if (!entry || !entry->ext)
+    return 0;
+  uint32_t offset = 0;
+  while (entry->ext_len - offset >= EXT_RECORD_HEADER) {
+    uint8_t record_tag = entry->ext[offset];
+    uint32_t record_len;
+    memcpy(&record_len, entry->ext + offset + 1, sizeof(uint32_t));
+    offset += EXT_RECORD_HEADER;
+    if (record_len > entry->ext_len - offset)
+      return 0;
+    if (record_tag == tag) {
+      if (data_out)
+        *data_out = entry->ext + offset;
+      if (len_out)
+        *len_out = record_len;
+      return 1;
+    }
+    offset += record_len;
   }
-  if (free_space_out) {
-    *free_space_out = g_vault.free_space;
+  return 0;
+}
+
+int vault_entry_ext_set(vault_entry_t *entry, uint8_t tag, const uint8_t *data,
+                        uint32_t len) {
+  if (!entry || (!data && len > 0))
+    return VAULT_ERR_INVALID_PARAM;
+
+  // Keep every other well-formed record, then append the replacement.
+  size_t kept = 0;
+  uint32_t offset = 0;
+  while (entry->ext && entry->ext_len - offset >= EXT_RECORD_HEADER) {
+    uint32_t record_len;
+    memcpy(&record_len, entry->ext + offset + 1, sizeof(uint32_t));
+    if (record_len > entry->ext_len - offset - EXT_RECORD_HEADER)
+      break;
+    if (entry->ext[offset] != tag)
+      kept += EXT_RECORD_HEADER + record_len;
+    offset += EXT_RECORD_HEADER + record_len;
+  }
+  size_t new_len = kept + (data ? EXT_RECORD_HEADER + len : 0);
+  if (new_len > VAULT_EXT_MAX_LEN)
+    return VAULT_ERR_INVALID_PARAM;
+
+  uint8_t *ext = NULL;
+  if (new_len > 0) {
+    ext = malloc(new_len);
+    if (!ext)
+      return VAULT_ERR_MEMORY;
+    size_t out = 0;
+    for (uint32_t in = 0; in < offset;) {
+      uint32_t record_len;
+      memcpy(&record_len, entry->ext + in + 1, sizeof(uint32_t));
+      if (entry->ext[in] != tag) {
+        memcpy(ext + out, entry->ext + in, EXT_RECORD_HEADER + record_len);
+        out += EXT_RECORD_HEADER + record_len;
+      }
+      in += EXT_RECORD_HEADER + record_len;
+    }
+    if (data) {
+      ext[out] = tag;
+      memcpy(ext + out + 1, &len, sizeof(uint32_t));
+      if (len > 0)
+        memcpy(ext + out + EXT_RECORD_HEADER, data, len);
+    }
   }
 
+  if (entry->ext) {
+    vault_zeroize(entry->ext, entry->ext_len);
+    free(entry->ext);
+  }
+  entry->ext = ext;
+  entry->ext_len = (uint32_t)new_len;
   return VAULT_OK;
 }
 
+// Media info record: u8 version, then fixed little-endian fields and two
+// length-prefixed codec strings. Newer versions may only append fields.
+#define MEDIA_INFO_VERSION 1
+#define MEDIA_INFO_FIXED_LEN (1 + 3 * sizeof(uint32_t) + sizeof(uint64_t) + \
+                              2 * sizeof(uint32_t))
+
+int vault_entry_set_media_info(vault_entry_t *entry,
+                               const vault_media_info_t *info) {
+  if (!entry || !info)
+    return VAULT_ERR_INVALID_PARAM;
+
+  uint8_t record[MEDIA_INFO_FIXED_LEN + 2 * VAULT_MEDIA_CODEC_LEN];
+  size_t offset = 0;
+  record[offset++] = MEDIA_INFO_VERSION;
+  memcpy(record + offset, &info->width, sizeof(uint32_t));
+  offset += sizeof(uint32_t);
+  memcpy(record + offset, &info->height, sizeof(uint32_t));
+  offset += sizeof(uint32_t);
+  memcpy(record + offset, &info->rotation, sizeof(uint32_t));
+  offset += sizeof(uint32_t);
+  memcpy(record + offset, &info->duration_ms, sizeof(uint64_t));
+  offset += sizeof(uint64_t);
+  memcpy(record + offset, &info->video_tracks, sizeof(uint32_t));
+  offset += sizeof(uint32_t);
+  memcpy(record + offset, &info->audio_tracks, sizeof(uint32_t));
+  offset += sizeof(uint32_t);
+  const char *codecs[2] = {info->video_codec, info->audio_codec};
+  for (int i = 0; i < 2; i++) {
+    uint8_t len = (uint8_t)strnlen(codecs[i], VAULT_MEDIA_CODEC_LEN - 1);
+    record[offset++] = len;
+    memcpy(record + offset, codecs[i], len);
+    offset += len;
+  }
+  return vault_entry_ext_set(entry, VAULT_EXT_MEDIA_INFO, record,
+                             (uint32_t)offset);
+}
+
+int vault_set_media_info(const uint8_t file_id[VAULT_ID_LEN],
+                         const vault_media_info_t *info) {
+  if (!g_vault.is_open)
+    return VAULT_ERR_NOT_OPEN;
+  if (!file_id || !info)
+    return VAULT_ERR_INVALID_PARAM;
+
+  uint32_t index;
+  int result = resolve_file_ids(file_id, 1, &index);
+  if (result != VAULT_OK)
+    return result;
+  vault_entry_t *entry = &g_vault.entries[index];
+
+  // Keep the current records so a failed commit leaves the entry unchanged.
+  uint8_t *old_ext = entry->ext;
+  uint32_t old_ext_len = entry->ext_len;
+  if (old_ext_len > 0) {
+    entry->ext = malloc(old_ext_len);
+    if (!entry->ext) {
+      entry->ext = old_ext;
+      return VAULT_ERR_MEMORY;
+    }
+    memcpy(entry->ext, old_ext, old_ext_len);
+  }
+  result = vault_entry_set_media_info(entry, info);
+  if (result == VAULT_OK)
+    result = vault_save_index_only();
+
+  if (result != VAULT_OK) {
+    LOGE("vault_set_media_info: failed with %d", result);
+    if (entry->ext) {
+      vault_zeroize(entry->ext, entry->ext_len);
+      free(entry->ext);
+    }
+    entry->ext = old_ext;
+    entry->ext_len = old_ext_len;
+    return result;
+  }
+  if (old_ext) {
+    vault_zeroize(old_ext, old_ext_len);
+    free(old_ext);
+  }
+  return VAULT_OK;
+}
+
+int vault_get_media_info(const uint8_t file_id[VAULT_ID_LEN],
+                         vault_media_info_t *info_out) {
+  if (!g_vault.is_open)
+    return VAULT_ERR_NOT_OPEN;
+  if (!file_id || !info_out)
+    return VAULT_ERR_INVALID_PARAM;
+
+  uint32_t index;
+  int result = resolve_file_ids(file_id, 1, &index);
+  if (result != VAULT_OK)
+    return result;
+  const uint8_t *record;
+  uint32_t len;
+  if (!vault_entry_ext_find(&g_vault.entries[index], VAULT_EXT_MEDIA_INFO,
+                            &record, &len) ||
+      len < MEDIA_INFO_FIXED_LEN || record[0] < MEDIA_INFO_VERSION)
+    return VAULT_ERR_NOT_FOUND;
+
+  memset(info_out, 0, sizeof(*info_out));
+  size_t offset = 1;
+  memcpy(&info_out->width, record + offset, sizeof(uint32_t));
+  offset += sizeof(uint32_t);
+  memcpy(&info_out->height, record + offset, sizeof(uint32_t));
+  offset += sizeof(uint32_t);
+  memcpy(&info_out->rotation, record + offset, sizeof(uint32_t));
+  offset += sizeof(uint32_t);
+  memcpy(&info_out->duration_ms, record + offset, sizeof(uint64_t));
+  offset += sizeof(uint64_t);
+  memcpy(&info_out->video_tracks, record + offset, sizeof(uint32_t));
+  offset += sizeof(uint32_t);
+  memcpy(&info_out->audio_tracks, record + offset, sizeof(uint32_t));
+  offset += sizeof(uint32_t);
+  char *codecs[2] = {info_out->video_codec, info_out->audio_codec};
+  for (int i = 0; i < 2; i++) {
+    if (offset >= len)
+      return VAULT_ERR_CORRUPTED;
+    uint8_t codec_len = record[offset++];
+    if (codec_len >= VAULT_MEDIA_CODEC_LEN || codec_len > len - offset)
+      return VAULT_ERR_CORRUPTED;
+    memcpy(codecs[i], record + offset, codec_len);
+    offset += codec_len;
+  }
+  return VAULT_OK;
+}
+
+// ========================================================================
+// Statistics
+// ========================================================================
+
+// Stored ciphertext bytes and number of contiguous runs for one entry.
+static uint64_t entry_stored_bytes(const vault_entry_t *entry,
+                                   uint64_t *extents_out) {
+  uint64_t bytes = 0;
+  uint64_t extents = 0;
+  if (entry->chunk_count > 0 && entry->chunks) {
+    for (uint32_t c = 0; c < entry->chunk_count; c++) {
+      // Cold chunks do not occupy the container
+      if (vault_tier_chunk_is_cold(entry, c))
+        continue;
+      bytes += entry->chunks[c].length;
+      if (c == 0 || entry->chunks[c - 1].offset + entry->chunks[c - 1].length !=
+                        entry->chunks[c].offset)
+        extents++;
+    }
+  } else {
+    bytes = entry->data_length;
+    extents = entry->data_length > 0 ? 1 : 0;
+  }
+  *extents_out = extents;
+  return bytes;
+}
+
+static uint32_t stats_type_slot(uint8_t type) {
+  return type < VAULT_STATS_TYPE_SLOTS ? type : 0;
+}
+
+static void stats_offer_largest(const vault_entry_t *entry) {
+  vault_stats_t *stats = &g_vault.stats;
+  uint32_t pos = stats->largest_count;
+  while (pos > 0 && stats->largest_sizes[pos - 1] < entry->size)
+    pos--;
+  if (pos >= VAULT_STATS_LARGEST_FILES)
+    return;
+
+  uint32_t last = stats->largest_count < VAULT_STATS_LARGEST_FILES
+                      ? stats->largest_count
+                      : VAULT_STATS_LARGEST_FILES - 1;
+  for (uint32_t i = last; i > pos; i--) {
+    stats->largest_sizes[i] = stats->largest_sizes[i - 1];
+    memcpy(stats->largest_ids[i], stats->largest_ids[i - 1], VAULT_ID_LEN);
+  }
+  stats->largest_sizes[pos] = entry->size;
+  memcpy(stats->largest_ids[pos], entry->file_id, VAULT_ID_LEN);
+  if (stats->largest_count < VAULT_STATS_LARGEST_FILES)
+    stats->largest_count++;
+}
+
+static void stats_rebuild_largest(void) {
+  g_vault.stats.largest_count = 0;
+  for (uint32_t i = 0; i < g_vault.entry_count; i++) {
+    const vault_entry_t *entry = &g_vault.entries[i];
+    if (!(entry->name && strncmp(entry->name, "__", 2) == 0))
+      stats_offer_largest(entry);
+  }
+  g_vault.stats_largest_stale = 0;
+}
+
+void vault_stats_add_entry(const vault_entry_t *entry) {
+  vault_stats_t *stats = &g_vault.stats;
+  uint64_t extents = 0;
+  stats->live_bytes += entry_stored_bytes(entry, &extents);
+  stats->extent_count += extents;
+
+  // System entries (folder map, vault title) occupy space but are not files.
+  if (entry->name && strncmp(entry->name, "__", 2) == 0)
+    return;
+  uint32_t slot = stats_type_slot(entry->type);
+  stats->file_count++;
+  stats->plaintext_bytes += entry->size;
+  stats->type_bytes[slot] += entry->size;
+  stats->type_files[slot]++;
+  if (extents > 1)
+    stats->fragmented_files++;
+  if (!g_vault.stats_largest_stale)
+    stats_offer_largest(entry);
+}
+
+void vault_stats_remove_entry(const vault_entry_t *entry) {
+  vault_stats_t *stats = &g_vault.stats;
+  uint64_t extents = 0;
+  uint64_t bytes = entry_stored_bytes(entry, &extents);
+  stats->live_bytes = stats->live_bytes > bytes ? stats->live_bytes - bytes : 0;
+  stats->extent_count =
+      stats->extent_count > extents ? stats->extent_count - extents : 0;
+
+  if (entry->name && strncmp(entry->name, "__", 2) == 0)
+    return;
+  uint32_t slot = stats_type_slot(entry->type);
+  if (stats->file_count > 0)
+    stats->file_count--;
+  stats->plaintext_bytes = stats->plaintext_bytes > entry->size
+                               ? stats->plaintext_bytes - entry->size
+                               : 0;
+  stats->type_bytes[slot] =
+      stats->type_bytes[slot] > entry->size ? stats->type_bytes[slot] - entry->size
+                                            : 0;
+  if (stats->type_files[slot] > 0)
+    stats->type_files[slot]--;
+  if (extents > 1 && stats->fragmented_files > 0)
+    stats->fragmented_files--;
+  for (uint32_t i = 0; i < stats->largest_count; i++) {
+    if (memcmp(stats->largest_ids[i], entry->file_id, VAULT_ID_LEN) == 0) {
+      g_vault.stats_largest_stale = 1;
+      break;
+    }
+  }
+}
+
+// Full recount; used only when the whole index is replaced (open, migration,
+// compaction).
+void vault_stats_rebuild(void) {
+  memset(&g_vault.stats, 0, sizeof(g_vault.stats));
+  g_vault.stats_largest_stale = 0;
+  for (uint32_t i = 0; i < g_vault.entry_count; i++)
+    vault_stats_add_entry(&g_vault.entries[i]);
+}
+
 // ========================================================================
 // Helpers
 // ========================================================================
@@ -538,6 +1810,16 @@ int clone_entries(const vault_entry_t *source, uint32_t count,
       dst->wrapped_dek_len = src->wrapped_dek_len;
     }
 
+    if (src->ext_len > 0) {
+      dst->ext = malloc(src->ext_len);
+      if (!dst->ext) {
+        free_entries_array(dest, count);
+        return VAULT_ERR_MEMORY;
+      }
+      memcpy(dst->ext, src->ext, src->ext_len);
+      dst->ext_len = src->ext_len;
+    }
+
     // FIX: Use chunk_count > 0 to determine if entry has chunks
     // Streaming import stores all large files as chunked, regardless of type
     if (src->chunk_count > 0) {
@@ -638,20 +1920,26 @@ static int build_text_image_entry(const uint8_t *data, size_t len, uint8_t type,
   return VAULT_OK;
 }
 
-static int build_video_entry(const uint8_t *data, size_t len, const char *name,
-                             const char *mime, vault_entry_t *entry_out,
-                             vault_payload_t *payload_out) {
-  if (!data || !entry_out || !payload_out)
+static int prepare_chunked_entry(const uint8_t *data, size_t len,
+                                 uint8_t type, const char *name,
+                                 const char *mime, size_t chunk_size,
+                                 vault_entry_t *entry_out,
+                                 import_chunk_source_t *source_out) {
+  if (!data || !entry_out || !source_out || chunk_size == 0)
     return VAULT_ERR_INVALID_PARAM;
 
   uint8_t dek[VAULT_KEY_LEN];
   vault_random_bytes(dek, VAULT_KEY_LEN);
 
   vault_generate_id(entry_out->file_id);
-  entry_out->type = VAULT_FILE_TYPE_VIDEO;
+  entry_out->type = type;
   entry_out->created_at = get_timestamp_ms();
   entry_out->name = strdup(name);
-  entry_out->mime = mime ? strdup(mime) : strdup("video/mp4");
+  if (mime)
+    entry_out->mime = strdup(mime);
+  else
+    entry_out->mime =
+        strdup(type == VAULT_FILE_TYPE_VIDEO ? "video/mp4" : "");
   entry_out->size = len;
 
   if (!entry_out->name || !entry_out->mime) {
@@ -688,62 +1976,188 @@ static int build_video_entry(const uint8_t *data, size_t len, const char *name,
   entry_out->wrapped_dek = wrapped_dek;
   entry_out->wrapped_dek_len = VAULT_NONCE_LEN + VAULT_KEY_LEN + VAULT_TAG_LEN;
 
-  // Chunk encryption
-  uint32_t chunk_count = (len + VAULT_CHUNK_SIZE - 1) / VAULT_CHUNK_SIZE;
+  // Chunk layout only; ciphertext is produced by encrypt_import_chunk while
+  // the entry is appended.
+  uint32_t chunk_count = (len + chunk_size - 1) / chunk_size;
   entry_out->chunk_count = chunk_count;
   entry_out->chunks = calloc(chunk_count, sizeof(entry_out->chunks[0]));
-  payload_out->chunks = calloc(chunk_count, sizeof(uint8_t *));
-  payload_out->chunk_lens = calloc(chunk_count, sizeof(size_t));
-  if (!entry_out->chunks || !payload_out->chunks || !payload_out->chunk_lens) {
+  if (!entry_out->chunks) {
     vault_zeroize(dek, VAULT_KEY_LEN);
-    result = VAULT_ERR_MEMORY;
-    goto error;
+    clear_entry_allocations(entry_out);
+    return VAULT_ERR_MEMORY;
   }
-  payload_out->chunk_count = chunk_count;
 
-  size_t offset = 0;
-  for (uint32_t i = 0; i < chunk_count; i++) {
-    size_t chunk_pt_len =
-        (i == chunk_count - 1) ? (len - offset) : VAULT_CHUNK_SIZE;
-    size_t chunk_ct_len = chunk_pt_len + VAULT_TAG_LEN;
-
-    uint8_t *chunk_buf = malloc(chunk_ct_len);
-    if (!chunk_buf) {
-      vault_zeroize(dek, VAULT_KEY_LEN);
-      result = VAULT_ERR_MEMORY;
-      goto error;
-    }
+  source_out->data = data;
+  source_out->len = len;
+  source_out->chunk_size = chunk_size;
+  memcpy(source_out->dek, dek, VAULT_KEY_LEN);
+  source_out->aad_base = aad_base;
+  vault_zeroize(dek, VAULT_KEY_LEN);
+  return VAULT_OK;
+}
 
-    vault_aad_t aad = aad_base;
-    aad.chunk_index = i;
+static int encrypt_import_chunk(void *ctx, uint32_t chunk_index,
+                                uint8_t *out, size_t out_cap, size_t *out_len,
+                                uint8_t nonce_out[VAULT_NONCE_LEN]) {
+  import_chunk_source_t *source = ctx;
+  size_t offset = (size_t)chunk_index * source->chunk_size;
+  if (!source || !out || !out_len || offset >= source->len)
+    return VAULT_ERR_INVALID_PARAM;
 
-    uint8_t chunk_nonce[VAULT_NONCE_LEN];
-    result =
-        vault_aead_encrypt(dek, NULL, (uint8_t *)&aad, sizeof(aad),
-                           data + offset, chunk_pt_len, chunk_buf, chunk_nonce);
-    if (result != VAULT_OK) {
-      vault_zeroize(dek, VAULT_KEY_LEN);
-      vault_zeroize(chunk_buf, chunk_ct_len);
-      free(chunk_buf);
-      goto error;
-    }
+  size_t chunk_pt_len = source->len - offset;
+  if (chunk_pt_len > source->chunk_size)
+    chunk_pt_len = source->chunk_size;
+  if (out_cap < chunk_pt_len + VAULT_TAG_LEN)
+    return VAULT_ERR_INVALID_PARAM;
 
-    memcpy(entry_out->chunks[i].nonce, chunk_nonce, VAULT_NONCE_LEN);
-    entry_out->chunks[i].length = (uint32_t)chunk_ct_len;
-    payload_out->chunks[i] = chunk_buf;
-    payload_out->chunk_lens[i] = chunk_ct_len;
+  vault_aad_t aad = source->aad_base;
+  aad.chunk_index = chunk_index;
+  int result = vault_aead_encrypt(source->dek, NULL, (uint8_t *)&aad,
+                                  sizeof(aad), source->data + offset,
+                                  chunk_pt_len, out, nonce_out);
+  if (result != VAULT_OK)
+    return result;
+  *out_len = chunk_pt_len + VAULT_TAG_LEN;
+  return VAULT_OK;
+}
+
+// Plaintext bytes per chunk, matching the layout readers infer from size and
+// chunk count: every chunk but the last is full.
+static size_t entry_chunk_size(const vault_entry_t *entry) {
+  if (entry->chunk_count > 1)
+    return entry->chunks[0].length > VAULT_TAG_LEN
+               ? entry->chunks[0].length - VAULT_TAG_LEN
+               : 0;
+  return entry->size <= VAULT_CHUNK_SIZE ? VAULT_CHUNK_SIZE
+                                         : STREAMING_CHUNK_SIZE;
+}
+
+static int encrypt_update_chunk(void *ctx, uint32_t chunk_index, uint8_t *out,
+                                size_t out_cap, size_t *out_len,
+                                uint8_t nonce_out[VAULT_NONCE_LEN]) {
+  update_chunk_source_t *source = ctx;
+  if (!source || !out || !out_len)
+    return VAULT_ERR_INVALID_PARAM;
 
-    offset += chunk_pt_len;
+  size_t pt_len = (size_t)source->new_size;
+  if (source->chunk_size > 0) {
+    const vault_entry_t *entry = source->entry;
+    uint64_t start = (uint64_t)chunk_index * source->chunk_size;
+    if (start >= source->new_size)
+      return VAULT_ERR_INVALID_PARAM;
+    pt_len = source->new_size - start < source->chunk_size
+                 ? (size_t)(source->new_size - start)
+                 : source->chunk_size;
+
+    // Start from the committed plaintext of this chunk, if it exists
+    size_t kept = 0;
+    if (chunk_index < entry->chunk_count) {
+      uint32_t length = entry->chunks[chunk_index].length;
+      if (length <= VAULT_TAG_LEN ||
+          length - VAULT_TAG_LEN > source->chunk_size)
+        return VAULT_ERR_CORRUPTED;
+      uint8_t *ciphertext = NULL;
+      int result = load_chunk(entry, chunk_index, &ciphertext);
+      if (result != VAULT_OK)
+        return result;
+      vault_aad_t aad = source->aad_base;
+      aad.chunk_index = chunk_index;
+      result = vault_aead_decrypt(source->dek, entry->chunks[chunk_index].nonce,
+                                  (uint8_t *)&aad, sizeof(aad), ciphertext,
+                                  length, source->plain, &kept);
+      vault_zeroize(ciphertext, length);
+      free(ciphertext);
+      if (result != VAULT_OK)
+        return result;
+    }
+
+    uint64_t end = source->offset + source->len;
+    uint64_t from = source->offset > start ? source->offset : start;
+    uint64_t to = end < start + pt_len ? end : start + pt_len;
+    if (from < to)
+      memcpy(source->plain + (from - start),
+             source->data + (from - source->offset), (size_t)(to - from));
+    // Every byte comes from the committed chunk or the new data
+    if (kept < pt_len &&
+        (from >= to || from > start + kept || to != start + pt_len)) {
+      vault_zeroize(source->plain, source->chunk_size);
+      return VAULT_ERR_CORRUPTED;
+    }
   }
+  if (out_cap < pt_len + VAULT_TAG_LEN)
+    return VAULT_ERR_INVALID_PARAM;
 
-  vault_zeroize(dek, VAULT_KEY_LEN);
+  vault_aad_t aad = source->aad_base;
+  aad.chunk_index = chunk_index;
+  int result = vault_aead_encrypt(source->dek, NULL, (uint8_t *)&aad,
+                                  sizeof(aad), source->plain, pt_len, out,
+                                  nonce_out);
+  if (source->chunk_size > 0)
+    vault_zeroize(source->plain, source->chunk_size);
+  if (result != VAULT_OK)
+    return result;
+  *out_len = pt_len + VAULT_TAG_LEN;
   return VAULT_OK;
+}
 
-error:
-  clear_entry_allocations(entry_out);
-  free_payload(payload_out);
-  vault_zeroize(dek, VAULT_KEY_LEN);
-  return result;
+static int encrypt_rechunk_chunk(void *ctx, uint32_t chunk_index,
+                                 uint8_t *out, size_t out_cap,
+                                 size_t *out_len,
+                                 uint8_t nonce_out[VAULT_NONCE_LEN]) {
+  rechunk_source_t *source = ctx;
+  if (!source || !out || !out_len)
+    return VAULT_ERR_INVALID_PARAM;
+  const vault_entry_t *entry = source->entry;
+  uint64_t start = (uint64_t)chunk_index * STREAMING_CHUNK_SIZE;
+  if (start >= entry->size)
+    return VAULT_ERR_INVALID_PARAM;
+  size_t pt_len = entry->size - start < STREAMING_CHUNK_SIZE
+                      ? (size_t)(entry->size - start)
+                      : STREAMING_CHUNK_SIZE;
+  if (out_cap < pt_len + VAULT_TAG_LEN)
+    return VAULT_ERR_INVALID_PARAM;
+
+  // The new chunk size is a whole multiple of the legacy one
+  uint32_t old = (uint32_t)(start / VAULT_CHUNK_SIZE);
+  size_t filled = 0;
+  int result = VAULT_OK;
+  while (result == VAULT_OK && filled < pt_len) {
+    size_t expected =
+        pt_len - filled < VAULT_CHUNK_SIZE ? pt_len - filled : VAULT_CHUNK_SIZE;
+    if (old >= entry->chunk_count ||
+        entry->chunks[old].length != expected + VAULT_TAG_LEN) {
+      result = VAULT_ERR_CORRUPTED;
+      break;
+    }
+    uint32_t length = entry->chunks[old].length;
+    uint8_t *ciphertext = NULL;
+    result = load_chunk(entry, old, &ciphertext);
+    if (result != VAULT_OK)
+      break;
+    vault_aad_t aad = source->aad_base;
+    aad.chunk_index = old;
+    size_t got = 0;
+    result = vault_aead_decrypt(source->dek, entry->chunks[old].nonce,
+                                (uint8_t *)&aad, sizeof(aad), ciphertext,
+                                length, source->plain + filled, &got);
+    vault_zeroize(ciphertext, length);
+    free(ciphertext);
+    filled += got;
+    old++;
+  }
+
+  if (result == VAULT_OK) {
+    vault_aad_t aad = source->aad_base;
+    aad.chunk_index = chunk_index;
+    result = vault_aead_encrypt(source->dek, NULL, (uint8_t *)&aad,
+                                sizeof(aad), source->plain, pt_len, out,
+                                nonce_out);
+  }
+  vault_zeroize(source->plain, filled);
+  if (result != VAULT_OK)
+    return result;
+  *out_len = pt_len + VAULT_TAG_LEN;
+  return VAULT_OK;
 }
 
 static int unwrap_dek(const vault_entry_t *entry,
@@ -792,3 +2206,31 @@ static int load_blob(uint64_t offset, uint64_t length, uint8_t **out) {
   *out = buf;
   return VAULT_OK;
 }
+
+static int load_chunk(const vault_entry_t *entry, uint32_t chunk_idx,
+                      uint8_t **out) {
+  uint64_t length = entry->chunks[chunk_idx].length;
+  if (length == 0 || !out)
+    return VAULT_ERR_INVALID_PARAM;
+  int fd = vault_tier_open_chunk(entry, chunk_idx);
+  if (fd < 0)
+    return VAULT_ERR_IO;
+
+  uint8_t *buf = malloc(length);
+  if (!buf) {
+    close(fd);
+    return VAULT_ERR_MEMORY;
+  }
+
+  int result = read_fully_at(fd, buf, (size_t)length,
+                             entry->chunks[chunk_idx].offset);
+  close(fd);
+  if (result != VAULT_OK) {
+    vault_zeroize(buf, length);
+    free(buf);
+    return result;
+  }
+
+  *out = buf;
+  return VAULT_OK;
+}
@@ -5,6 +5,12 @@
  */
 
 #include "vault_engine.h"
+#include "vault_archive.h"
+#include "vault_governor.h"
+#include "vault_layout.h"
+#include "vault_scanner.h"
+#include "vault_search.h"
+#include "vault_tier.h"
 #include <jni.h>
 #include <string.h>
 #include <stdlib.h>
@@ -86,6 +92,35 @@ static char* jstring_to_cstring(JNIEnv* env, jstring str) {
     return result;
 }
 
+// Helper: Fill media info from [width, height, rotation, durationMs,
+// videoTracks, audioTracks] and codec MIME strings (also used by
+// vault_streaming_jni.c)
+int vault_media_info_from_java(JNIEnv* env, jlongArray values, jstring videoCodec,
+                               jstring audioCodec, vault_media_info_t* info) {
+    if (!values || (*env)->GetArrayLength(env, values) < 6) {
+        return 0;
+    }
+    jlong v[6];
+    (*env)->GetLongArrayRegion(env, values, 0, 6, v);
+    memset(info, 0, sizeof(*info));
+    info->width = (uint32_t)v[0];
+    info->height = (uint32_t)v[1];
+    info->rotation = (uint32_t)v[2];
+    info->duration_ms = (uint64_t)v[3];
+    info->video_tracks = (uint32_t)v[4];
+    info->audio_tracks = (uint32_t)v[5];
+    jstring codecs[2] = {videoCodec, audioCodec};
+    char* out[2] = {info->video_codec, info->audio_codec};
+    for (int i = 0; i < 2; i++) {
+        char* codec = jstring_to_cstring(env, codecs[i]);
+        if (codec) {
+            strncpy(out[i], codec, VAULT_MEDIA_CODEC_LEN - 1);
+            free(codec);
+        }
+    }
+    return 1;
+}
+
 // ============================================================================
 // JNI Functions
 // ============================================================================
@@ -351,6 +386,92 @@ Java_com_noleak_noleak_vault_VaultEngine_nativeReadChunk(
     return array;
 }
 
+// Returns plaintext bytes written into out[outOffset..outOffset+length), or a
+// negative VAULT_ERR_* code. Decrypted data is staged natively (the Java heap
+// cannot be pinned across worker threads) and copied with one region write.
+JNIEXPORT jint JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeReadChunks(
+    JNIEnv* env, jclass clazz,
+    jbyteArray fileId,
+    jint firstChunk,
+    jint chunkCount,
+    jbyteArray out,
+    jint outOffset,
+    jint length
+) {
+    UNUSED(clazz);
+    if (!out || firstChunk < 0 || chunkCount <= 0 || outOffset < 0 || length <= 0 ||
+        (*env)->GetArrayLength(env, out) - outOffset < length) {
+        return VAULT_ERR_INVALID_PARAM;
+    }
+    size_t id_len;
+    uint8_t* c_id = jbytearray_to_uint8(env, fileId, &id_len);
+    if (!c_id || id_len != VAULT_ID_LEN) {
+        if (c_id) free(c_id);
+        return VAULT_ERR_INVALID_PARAM;
+    }
+
+    uint8_t* staging = malloc((size_t)length);
+    if (!staging) {
+        free(c_id);
+        return VAULT_ERR_MEMORY;
+    }
+
+    size_t written = 0;
+    int result = vault_read_chunks(c_id, (uint32_t)firstChunk, (uint32_t)chunkCount,
+                                   staging, (size_t)length, &written);
+    free(c_id);
+
+    if (result == VAULT_OK) {
+        (*env)->SetByteArrayRegion(env, out, outOffset, (jsize)written, (const jbyte*)staging);
+    }
+    vault_zeroize(staging, (size_t)length);
+    free(staging);
+
+    return result == VAULT_OK ? (jint)written : result;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeReadRange(
+    JNIEnv* env, jclass clazz,
+    jbyteArray fileId,
+    jlong offset,
+    jbyteArray out,
+    jint outOffset,
+    jint length
+) {
+    UNUSED(clazz);
+    if (!out || offset < 0 || outOffset < 0 || length <= 0 ||
+        (*env)->GetArrayLength(env, out) - outOffset < length) {
+        return VAULT_ERR_INVALID_PARAM;
+    }
+    size_t id_len;
+    uint8_t* c_id = jbytearray_to_uint8(env, fileId, &id_len);
+    if (!c_id || id_len != VAULT_ID_LEN) {
+        if (c_id) free(c_id);
+        return VAULT_ERR_INVALID_PARAM;
+    }
+
+    uint8_t* staging = malloc((size_t)length);
+    if (!staging) {
+        free(c_id);
+        return VAULT_ERR_MEMORY;
+    }
+
+    size_t written = 0;
+    int result = vault_read_range(c_id, (uint64_t)offset, staging, (size_t)length,
+                                  &written);
+    free(c_id);
+
+    if (result == VAULT_OK && written > 0) {
+        (*env)->SetByteArrayRegion(env, out, outOffset, (jsize)written, (const jbyte*)staging);
+    }
+    vault_zeroize(staging, (size_t)length);
+    free(staging);
+
+    return result == VAULT_OK ? (jint)written : result;
+}
+
 JNIEXPORT jint JNICALL
 Java_com_noleak_noleak_vault_VaultEngine_nativeDeleteFile(
     JNIEnv* env, jclass clazz,
@@ -398,6 +519,151 @@ Java_com_noleak_noleak_vault_VaultEngine_nativeRenameFile(
     return result;
 }
 
+/**
+ * Delete several files with one index commit.
+ * @param fileIds Packed file IDs (count * VAULT_ID_LEN bytes)
+ */
+JNIEXPORT jint JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeDeleteFiles(
+    JNIEnv* env, jclass clazz,
+    jbyteArray fileIds
+) {
+    UNUSED(clazz);
+    size_t ids_len;
+    uint8_t* c_ids = jbytearray_to_uint8(env, fileIds, &ids_len);
+    if (!c_ids || ids_len == 0 || ids_len % VAULT_ID_LEN != 0) {
+        if (c_ids) free(c_ids);
+        return VAULT_ERR_INVALID_PARAM;
+    }
+
+    int result = vault_delete_files(c_ids, (uint32_t)(ids_len / VAULT_ID_LEN));
+    free(c_ids);
+
+    return result;
+}
+
+/**
+ * Rename several files with one index commit.
+ * @param fileIds Packed file IDs (count * VAULT_ID_LEN bytes)
+ * @param newNames One name per ID
+ */
+JNIEXPORT jint JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeRenameFiles(
+    JNIEnv* env, jclass clazz,
+    jbyteArray fileIds,
+    jobjectArray newNames
+) {
+    UNUSED(clazz);
+    if (!newNames) {
+        return VAULT_ERR_INVALID_PARAM;
+    }
+    size_t ids_len;
+    uint8_t* c_ids = jbytearray_to_uint8(env, fileIds, &ids_len);
+    jsize count = (*env)->GetArrayLength(env, newNames);
+    if (!c_ids || count <= 0 || ids_len != (size_t)count * VAULT_ID_LEN) {
+        if (c_ids) free(c_ids);
+        return VAULT_ERR_INVALID_PARAM;
+    }
+
+    int result = VAULT_OK;
+    char** c_names = calloc(count, sizeof(char*));
+    if (!c_names) {
+        free(c_ids);
+        return VAULT_ERR_MEMORY;
+    }
+    for (jsize i = 0; i < count && result == VAULT_OK; i++) {
+        jstring name = (jstring)(*env)->GetObjectArrayElement(env, newNames, i);
+        c_names[i] = jstring_to_cstring(env, name);
+        if (name) (*env)->DeleteLocalRef(env, name);
+        if (!c_names[i]) result = VAULT_ERR_INVALID_PARAM;
+    }
+
+    if (result == VAULT_OK) {
+        result = vault_rename_files(c_ids, (const char* const*)c_names, (uint32_t)count);
+    }
+
+    for (jsize i = 0; i < count; i++) {
+        if (c_names[i]) {
+            vault_zeroize(c_names[i], strlen(c_names[i]));
+            free(c_names[i]);
+        }
+    }
+    free(c_names);
+    free(c_ids);
+
+    return result;
+}
+
+/**
+ * Apply queued renames and deletes with one shared index commit.
+ * @param kinds VAULT_META_OP_* per operation
+ * @param fileIds Packed file IDs (count * VAULT_ID_LEN bytes)
+ * @param newNames New name per operation (null for deletes)
+ * @return One status code per operation, or null on invalid input
+ */
+JNIEXPORT jintArray JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeCommitMetadataOps(
+    JNIEnv* env, jclass clazz,
+    jbyteArray kinds,
+    jbyteArray fileIds,
+    jobjectArray newNames
+) {
+    UNUSED(clazz);
+    if (!kinds || !newNames) return NULL;
+
+    jsize count = (*env)->GetArrayLength(env, kinds);
+    if (count <= 0 || (*env)->GetArrayLength(env, newNames) != count) return NULL;
+    size_t ids_len;
+    uint8_t* c_ids = jbytearray_to_uint8(env, fileIds, &ids_len);
+    if (!c_ids || ids_len != (size_t)count * VAULT_ID_LEN) {
+        if (c_ids) free(c_ids);
+        return NULL;
+    }
+
+    jintArray output = NULL;
+    vault_meta_op_t* ops = calloc(count, sizeof(vault_meta_op_t));
+    char** c_names = calloc(count, sizeof(char*));
+    int32_t* statuses = calloc(count, sizeof(int32_t));
+    if (!ops || !c_names || !statuses) goto cleanup;
+
+    jbyte* c_kinds = (*env)->GetByteArrayElements(env, kinds, NULL);
+    if (!c_kinds) goto cleanup;
+    for (jsize i = 0; i < count; i++) {
+        ops[i].kind = (uint8_t)c_kinds[i];
+        memcpy(ops[i].file_id, c_ids + (size_t)i * VAULT_ID_LEN, VAULT_ID_LEN);
+    }
+    (*env)->ReleaseByteArrayElements(env, kinds, c_kinds, JNI_ABORT);
+
+    for (jsize i = 0; i < count; i++) {
+        jstring name = (jstring)(*env)->GetObjectArrayElement(env, newNames, i);
+        if (name) {
+            c_names[i] = jstring_to_cstring(env, name);
+            (*env)->DeleteLocalRef(env, name);
+            if (!c_names[i]) goto cleanup;
+        }
+        ops[i].new_name = c_names[i];
+    }
+
+    vault_commit_metadata_ops(ops, (uint32_t)count, statuses);
+    output = (*env)->NewIntArray(env, count);
+    if (output) (*env)->SetIntArrayRegion(env, output, 0, count, (const jint*)statuses);
+
+cleanup:
+    if (c_names) {
+        for (jsize i = 0; i < count; i++) {
+            if (c_names[i]) {
+                vault_zeroize(c_names[i], strlen(c_names[i]));
+                free(c_names[i]);
+            }
+        }
+        free(c_names);
+    }
+    free(ops);
+    free(statuses);
+    free(c_ids);
+    return output;
+}
+
 JNIEXPORT jint JNICALL
 Java_com_noleak_noleak_vault_VaultEngine_nativeCompact(JNIEnv* env, jclass clazz) {
     UNUSED(env);
@@ -405,6 +671,354 @@ Java_com_noleak_noleak_vault_VaultEngine_nativeCompact(JNIEnv* env, jclass clazz
     return vault_compact();
 }
 
+/**
+ * Select the cold segment directory for the open vault (null disables).
+ */
+JNIEXPORT jint JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeTierSetColdDir(
+    JNIEnv* env, jclass clazz, jstring dir
+) {
+    UNUSED(clazz);
+    if (!dir) {
+        return vault_tier_set_cold_dir(NULL);
+    }
+
+    const char* c_dir = (*env)->GetStringUTFChars(env, dir, NULL);
+    if (!c_dir) {
+        return VAULT_ERR_MEMORY;
+    }
+
+    int result = vault_tier_set_cold_dir(c_dir);
+
+    (*env)->ReleaseStringUTFChars(env, dir, c_dir);
+
+    return result;
+}
+
+/**
+ * Move chunks of files unread for coldDays to the cold segment.
+ * @return Bytes moved, or a negative error code
+ */
+JNIEXPORT jlong JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeTierMigrate(
+    JNIEnv* env, jclass clazz, jint coldDays, jlong maxBytes
+) {
+    UNUSED(env);
+    UNUSED(clazz);
+    if (coldDays < 0 || maxBytes <= 0) {
+        return VAULT_ERR_INVALID_PARAM;
+    }
+
+    uint64_t moved = 0;
+    int result = vault_tier_migrate((uint32_t)coldDays, (uint64_t)maxBytes, &moved);
+    if (result != VAULT_OK) {
+        return result;
+    }
+    return (jlong)moved;
+}
+
+/**
+ * Move files unread for idleMs from the legacy 1 MB chunk layout to 4 MB chunks.
+ * @return Bytes converted, or a negative error code
+ */
+JNIEXPORT jlong JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeRechunkLegacy(
+    JNIEnv* env, jclass clazz, jlong idleMs, jlong maxBytes
+) {
+    UNUSED(env);
+    UNUSED(clazz);
+    if (idleMs < 0 || maxBytes <= 0) {
+        return VAULT_ERR_INVALID_PARAM;
+    }
+
+    uint64_t converted = 0;
+    int result = vault_rechunk_legacy((uint64_t)idleMs, (uint64_t)maxBytes, &converted);
+    if (result != VAULT_OK) {
+        return result;
+    }
+    return (jlong)converted;
+}
+
+/**
+ * Copy every cold chunk back into the container.
+ * @return Files recalled, or a negative error code
+ */
+JNIEXPORT jint JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeTierRecallAll(JNIEnv* env, jclass clazz) {
+    UNUSED(env);
+    UNUSED(clazz);
+    uint32_t recalled = 0;
+    int result = vault_tier_recall_all(&recalled);
+    if (result != VAULT_OK) {
+        return result;
+    }
+    return (jint)recalled;
+}
+
+/**
+ * Get vault statistics as a flat long array:
+ * [total, free, live, index, plaintext, files, fragmented, extents,
+ *  type_bytes[4], type_files[4], largest_count, largest_sizes[5]]
+ * Largest file IDs are written to largestIds (5 * 16 bytes).
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeGetStats(
+    JNIEnv* env, jclass clazz, jbyteArray largestIds) {
+    UNUSED(clazz);
+    vault_stats_t stats;
+    if (vault_get_stats(&stats) != VAULT_OK) {
+        return NULL;
+    }
+
+    jlong values[17 + VAULT_STATS_LARGEST_FILES];
+    size_t n = 0;
+    values[n++] = (jlong)stats.total_size;
+    values[n++] = (jlong)stats.free_space;
+    values[n++] = (jlong)stats.live_bytes;
+    values[n++] = (jlong)stats.index_bytes;
+    values[n++] = (jlong)stats.plaintext_bytes;
+    values[n++] = (jlong)stats.file_count;
+    values[n++] = (jlong)stats.fragmented_files;
+    values[n++] = (jlong)stats.extent_count;
+    for (int i = 0; i < VAULT_STATS_TYPE_SLOTS; i++) values[n++] = (jlong)stats.type_bytes[i];
+    for (int i = 0; i < VAULT_STATS_TYPE_SLOTS; i++) values[n++] = (jlong)stats.type_files[i];
+    values[n++] = (jlong)stats.largest_count;
+    for (int i = 0; i < VAULT_STATS_LARGEST_FILES; i++) values[n++] = (jlong)stats.largest_sizes[i];
+
+    if (largestIds &&
+        (*env)->GetArrayLength(env, largestIds) >= (jsize)sizeof(stats.largest_ids)) {
+        (*env)->SetByteArrayRegion(env, largestIds, 0, sizeof(stats.largest_ids),
+                                   (const jbyte*)stats.largest_ids);
+    }
+
+    jlongArray result = (*env)->NewLongArray(env, (jsize)n);
+    if (result) (*env)->SetLongArrayRegion(env, result, 0, (jsize)n, values);
+    return result;
+}
+
+#define VAULT_LAYOUT_JNI_HEADER 14
+#define VAULT_LAYOUT_JNI_INDEX 3
+#define VAULT_LAYOUT_JNI_ENTRY 11
+
+static jlong id_half(const uint8_t* id) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v = (v << 8) | id[i];
+    return (jlong)v;
+}
+
+/**
+ * Container layout report.
+ * statusOut receives [result].
+ * @return VAULT_LAYOUT_JNI_HEADER summary values, the dead-space buckets,
+ * VAULT_LAYOUT_JNI_INDEX values (seq, offset, length) for each of the
+ * VAULT_LAYOUT_MAX_INDEX_RECORDS index slots, then VAULT_LAYOUT_JNI_ENTRY
+ * values per entry (the file ID as two big-endian longs first); null on
+ * error
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeAnalyzeLayout(
+    JNIEnv* env, jclass clazz, jintArray statusOut) {
+    UNUSED(clazz);
+    if (!statusOut || (*env)->GetArrayLength(env, statusOut) < 1) {
+        return NULL;
+    }
+    vault_layout_report_t report;
+    jint status = vault_analyze_layout(&report);
+    if (status != VAULT_OK) {
+        (*env)->SetIntArrayRegion(env, statusOut, 0, 1, &status);
+        return NULL;
+    }
+
+    size_t total = VAULT_LAYOUT_JNI_HEADER + VAULT_LAYOUT_DEAD_BUCKETS +
+                   VAULT_LAYOUT_MAX_INDEX_RECORDS * VAULT_LAYOUT_JNI_INDEX +
+                   (size_t)report.entry_count * VAULT_LAYOUT_JNI_ENTRY;
+    jlong* values = malloc(total * sizeof(jlong));
+    if (!values) {
+        vault_layout_free(&report);
+        status = VAULT_ERR_MEMORY;
+        (*env)->SetIntArrayRegion(env, statusOut, 0, 1, &status);
+        return NULL;
+    }
+    size_t n = 0;
+    values[n++] = (jlong)report.file_size;
+    values[n++] = (jlong)report.committed_size;
+    values[n++] = (jlong)report.header_bytes;
+    values[n++] = (jlong)report.index_offset;
+    values[n++] = (jlong)report.index_length;
+    values[n++] = (jlong)report.live_bytes;
+    values[n++] = (jlong)report.dead_bytes;
+    values[n++] = (jlong)report.dead_runs;
+    values[n++] = (jlong)report.largest_dead_run;
+    values[n++] = (jlong)report.fiemap_supported;
+    values[n++] = (jlong)report.file_physical_extents;
+    values[n++] = (jlong)report.read_cost_us;
+    values[n++] = (jlong)report.entry_count;
+    values[n++] = (jlong)report.index_record_count;
+    for (int i = 0; i < VAULT_LAYOUT_DEAD_BUCKETS; i++) values[n++] = (jlong)report.dead_buckets[i];
+    for (uint32_t i = 0; i < VAULT_LAYOUT_MAX_INDEX_RECORDS; i++) {
+        const vault_layout_index_t* r = &report.index_records[i];
+        int used = i < report.index_record_count;
+        values[n++] = used ? (jlong)r->seq : 0;
+        values[n++] = used ? (jlong)r->offset : 0;
+        values[n++] = used ? (jlong)r->length : 0;
+    }
+    for (uint32_t i = 0; i < report.entry_count; i++) {
+        const vault_layout_entry_t* e = &report.entries[i];
+        values[n++] = id_half(e->file_id);
+        values[n++] = id_half(e->file_id + 8);
+        values[n++] = (jlong)e->is_system;
+        values[n++] = (jlong)e->size;
+        values[n++] = (jlong)e->stored_bytes;
+        values[n++] = (jlong)e->first_offset;
+        values[n++] = (jlong)e->span;
+        values[n++] = (jlong)e->logical_extents;
+        values[n++] = (jlong)e->physical_extents;
+        values[n++] = (jlong)e->cold_chunks;
+        values[n++] = (jlong)e->read_cost_us;
+    }
+    vault_layout_free(&report);
+
+    jlongArray result = (*env)->NewLongArray(env, (jsize)n);
+    if (result) (*env)->SetLongArrayRegion(env, result, 0, (jsize)n, values);
+    free(values);
+    status = result ? VAULT_OK : VAULT_ERR_MEMORY;
+    (*env)->SetIntArrayRegion(env, statusOut, 0, 1, &status);
+    return result;
+}
+
+/**
+ * Full-text search over indexed text entries.
+ * statusOut receives [result].
+ * @return Packed file IDs (count * VAULT_ID_LEN bytes), best match first;
+ * null on error
+ */
+JNIEXPORT jbyteArray JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeSearchFiles(
+    JNIEnv* env, jclass clazz, jstring query, jint maxResults, jintArray statusOut) {
+    UNUSED(clazz);
+    if (!statusOut || (*env)->GetArrayLength(env, statusOut) < 1) {
+        return NULL;
+    }
+    jint status = VAULT_ERR_INVALID_PARAM;
+    char* c_query = jstring_to_cstring(env, query);
+    if (!c_query || maxResults < 0) {
+        if (c_query) free(c_query);
+        (*env)->SetIntArrayRegion(env, statusOut, 0, 1, &status);
+        return NULL;
+    }
+
+    uint8_t* ids = NULL;
+    uint32_t count = 0;
+    int result = vault_search_query(c_query, (uint32_t)maxResults, &ids, &count);
+    vault_zeroize(c_query, strlen(c_query));
+    free(c_query);
+    status = (jint)result;
+    (*env)->SetIntArrayRegion(env, statusOut, 0, 1, &status);
+    if (result != VAULT_OK) {
+        return NULL;
+    }
+
+    jbyteArray array = (*env)->NewByteArray(env, (jsize)(count * VAULT_ID_LEN));
+    if (array && count > 0) {
+        (*env)->SetByteArrayRegion(env, array, 0, (jsize)(count * VAULT_ID_LEN),
+                                   (const jbyte*)ids);
+    }
+    free(ids);
+    if (!array) {
+        status = VAULT_ERR_MEMORY;
+        (*env)->SetIntArrayRegion(env, statusOut, 0, 1, &status);
+    }
+    return array;
+}
+
+/**
+ * Index text entries that have no search terms, resuming a pass at start.
+ * @param statusOut [0] receives VAULT_OK or a VAULT_ERR_* code
+ * @return Position to resume from, or -1 once the pass is complete
+ */
+JNIEXPORT jint JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeIndexPendingText(
+    JNIEnv* env, jclass clazz, jint start, jint maxFiles, jintArray statusOut) {
+    UNUSED(clazz);
+    if (!statusOut || (*env)->GetArrayLength(env, statusOut) < 1) {
+        return -1;
+    }
+    jint status = VAULT_ERR_INVALID_PARAM;
+    uint32_t next = 0;
+    if (start >= 0 && maxFiles > 0) {
+        status = vault_search_index_pending((uint32_t)start, (uint32_t)maxFiles,
+                                            &next, NULL);
+    }
+    (*env)->SetIntArrayRegion(env, statusOut, 0, 1, &status);
+    if (status != VAULT_OK || next >= g_vault.entry_count) {
+        return -1;
+    }
+    return (jint)next;
+}
+
+/**
+ * Store media metadata for a file (one index commit).
+ * @param values [width, height, rotation, durationMs, videoTracks, audioTracks]
+ */
+JNIEXPORT jint JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeSetMediaInfo(
+    JNIEnv* env, jclass clazz, jbyteArray fileId, jlongArray values,
+    jstring videoCodec, jstring audioCodec) {
+    UNUSED(clazz);
+    vault_media_info_t info;
+    if (!vault_media_info_from_java(env, values, videoCodec, audioCodec, &info)) {
+        return VAULT_ERR_INVALID_PARAM;
+    }
+    size_t id_len;
+    uint8_t* c_id = jbytearray_to_uint8(env, fileId, &id_len);
+    if (!c_id || id_len != VAULT_ID_LEN) {
+        if (c_id) free(c_id);
+        return VAULT_ERR_INVALID_PARAM;
+    }
+    int result = vault_set_media_info(c_id, &info);
+    free(c_id);
+    return result;
+}
+
+/**
+ * Read stored media metadata.
+ * @param codecsOut Receives [videoCodec, audioCodec]
+ * @return Values in nativeSetMediaInfo order, or null if none is stored
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeGetMediaInfo(
+    JNIEnv* env, jclass clazz, jbyteArray fileId, jobjectArray codecsOut) {
+    UNUSED(clazz);
+    size_t id_len;
+    uint8_t* c_id = jbytearray_to_uint8(env, fileId, &id_len);
+    if (!c_id || id_len != VAULT_ID_LEN) {
+        if (c_id) free(c_id);
+        return NULL;
+    }
+    vault_media_info_t info;
+    int result = vault_get_media_info(c_id, &info);
+    free(c_id);
+    if (result != VAULT_OK) {
+        return NULL;
+    }
+
+    if (codecsOut && (*env)->GetArrayLength(env, codecsOut) >= 2) {
+        jstring video = (*env)->NewStringUTF(env, info.video_codec);
+        jstring audio = (*env)->NewStringUTF(env, info.audio_codec);
+        (*env)->SetObjectArrayElement(env, codecsOut, 0, video);
+        (*env)->SetObjectArrayElement(env, codecsOut, 1, audio);
+        if (video) (*env)->DeleteLocalRef(env, video);
+        if (audio) (*env)->DeleteLocalRef(env, audio);
+    }
+    jlong values[6] = {
+        (jlong)info.width, (jlong)info.height, (jlong)info.rotation,
+        (jlong)info.duration_ms, (jlong)info.video_tracks, (jlong)info.audio_tracks
+    };
+    jlongArray array = (*env)->NewLongArray(env, 6);
+    if (array) (*env)->SetLongArrayRegion(env, array, 0, 6, values);
+    return array;
+}
+
 JNIEXPORT jint JNICALL
 Java_com_noleak_noleak_vault_VaultEngine_nativeGetEntryCount(JNIEnv* env, jclass clazz) {
     UNUSED(env);
@@ -480,6 +1094,170 @@ Java_com_noleak_noleak_vault_VaultEngine_nativeListFiles(JNIEnv* env, jclass cla
     return result;
 }
 
+/**
+ * Read and encrypt every member of a ZIP/TAR from fd into the stage.
+ */
+JNIEXPORT jint JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeStageArchive(
+    JNIEnv* env, jclass clazz, jint fd
+) {
+    UNUSED(env);
+    UNUSED(clazz);
+    uint32_t count = 0;
+    uint32_t skipped = 0;
+    return vault_archive_stage(fd, &count, &skipped);
+}
+
+/**
+ * Commit the staged archive members with one index commit.
+ * statusOut receives [result, skipped]; returns null on failure.
+ */
+JNIEXPORT jobjectArray JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeCommitArchive(
+    JNIEnv* env, jclass clazz, jintArray statusOut
+) {
+    UNUSED(clazz);
+    if (!statusOut || (*env)->GetArrayLength(env, statusOut) < 2) {
+        return NULL;
+    }
+
+    vault_archive_member_t* members = NULL;
+    uint32_t count = 0;
+    uint32_t skipped = 0;
+    int result = vault_archive_commit(&members, &count, &skipped);
+    jint status[2] = { (jint)result, (jint)skipped };
+    (*env)->SetIntArrayRegion(env, statusOut, 0, 2, status);
+    if (result != VAULT_OK) {
+        return NULL;
+    }
+
+    jclass memberClass = (*env)->FindClass(env, "com/noleak/noleak/vault/VaultArchiveMember");
+    if (!memberClass) {
+        LOGE("Failed to find VaultArchiveMember class");
+        vault_archive_free_members(members, count);
+        return NULL;
+    }
+    jmethodID constructor = (*env)->GetMethodID(env, memberClass, "<init>",
+        "([BLjava/lang/String;Ljava/lang/String;J)V");
+    jobjectArray array = constructor
+        ? (*env)->NewObjectArray(env, count, memberClass, NULL)
+        : NULL;
+    if (!array) {
+        vault_archive_free_members(members, count);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        jbyteArray fileId = uint8_to_jbytearray(env, members[i].file_id, VAULT_ID_LEN);
+        jstring folder = (*env)->NewStringUTF(env, members[i].folder);
+        jstring name = (*env)->NewStringUTF(env, members[i].name);
+        jobject member = (*env)->NewObject(env, memberClass, constructor,
+            fileId, folder, name, (jlong)members[i].size);
+        (*env)->SetObjectArrayElement(env, array, i, member);
+        (*env)->DeleteLocalRef(env, fileId);
+        (*env)->DeleteLocalRef(env, folder);
+        (*env)->DeleteLocalRef(env, name);
+        (*env)->DeleteLocalRef(env, member);
+    }
+
+    vault_archive_free_members(members, count);
+    return array;
+}
+
+JNIEXPORT void JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeDiscardArchive(JNIEnv* env, jclass clazz) {
+    UNUSED(env);
+    UNUSED(clazz);
+    vault_archive_discard();
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeArchiveBytesRead(JNIEnv* env, jclass clazz) {
+    UNUSED(env);
+    UNUSED(clazz);
+    return (jlong)vault_archive_bytes_read();
+}
+
+/**
+ * Snapshot several files for one ZIP or TAR export.
+ * @param fileIds Packed file IDs (count * VAULT_ID_LEN bytes)
+ * @param paths One archive path per ID
+ */
+JNIEXPORT jint JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativePrepareExport(
+    JNIEnv* env, jclass clazz,
+    jbyteArray fileIds,
+    jobjectArray paths
+) {
+    UNUSED(clazz);
+    if (!paths) {
+        return VAULT_ERR_INVALID_PARAM;
+    }
+    size_t ids_len;
+    uint8_t* c_ids = jbytearray_to_uint8(env, fileIds, &ids_len);
+    jsize count = (*env)->GetArrayLength(env, paths);
+    if (!c_ids || count <= 0 || ids_len != (size_t)count * VAULT_ID_LEN) {
+        if (c_ids) free(c_ids);
+        return VAULT_ERR_INVALID_PARAM;
+    }
+
+    int result = VAULT_OK;
+    vault_export_item_t* items = calloc(count, sizeof(vault_export_item_t));
+    if (!items) {
+        free(c_ids);
+        return VAULT_ERR_MEMORY;
+    }
+    for (jsize i = 0; i < count && result == VAULT_OK; i++) {
+        memcpy(items[i].file_id, c_ids + (size_t)i * VAULT_ID_LEN, VAULT_ID_LEN);
+        jstring path = (jstring)(*env)->GetObjectArrayElement(env, paths, i);
+        items[i].path = jstring_to_cstring(env, path);
+        if (path) (*env)->DeleteLocalRef(env, path);
+        if (!items[i].path) result = VAULT_ERR_INVALID_PARAM;
+    }
+
+    if (result == VAULT_OK) {
+        result = vault_export_prepare(items, (uint32_t)count);
+    }
+
+    for (jsize i = 0; i < count; i++) {
+        if (items[i].path) {
+            char* path = (char*)items[i].path;
+            vault_zeroize(path, strlen(path));
+            free(path);
+        }
+    }
+    free(items);
+    free(c_ids);
+
+    return result;
+}
+
+/**
+ * Write the prepared export to fd as one ZIP or TAR stream.
+ */
+JNIEXPORT jint JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeWriteExport(
+    JNIEnv* env, jclass clazz, jint fd, jint format
+) {
+    UNUSED(env);
+    UNUSED(clazz);
+    return vault_export_write(fd, format);
+}
+
+JNIEXPORT void JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeDiscardExport(JNIEnv* env, jclass clazz) {
+    UNUSED(env);
+    UNUSED(clazz);
+    vault_export_discard();
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeArchiveBytesWritten(JNIEnv* env, jclass clazz) {
+    UNUSED(env);
+    UNUSED(clazz);
+    return (jlong)vault_archive_bytes_written();
+}
+
 JNIEXPORT jint JNICALL
 Java_com_noleak_noleak_vault_VaultEngine_nativeChangePassword(
     JNIEnv* env, jclass clazz,
@@ -542,6 +1320,135 @@ Java_com_noleak_noleak_vault_VaultEngine_nativeSecureWipeFile(
     return result == VAULT_OK ? JNI_TRUE : JNI_FALSE;
 }
 
+/**
+ * Scan files for plaintext patterns and file signatures.
+ * Returns one int per path: SCAN_SIG_* | SCAN_RESULT_PATTERN, or a negative
+ * error code when the file could not be read.
+ */
+JNIEXPORT jintArray JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeScanFiles(
+    JNIEnv* env, jclass clazz,
+    jobjectArray paths,
+    jobjectArray patterns,
+    jint threads
+) {
+    UNUSED(clazz);
+    if (!paths) return NULL;
+
+    jsize path_count = (*env)->GetArrayLength(env, paths);
+    jsize pattern_count = patterns ? (*env)->GetArrayLength(env, patterns) : 0;
+    jintArray output = NULL;
+    vault_scanner_t* scanner = NULL;
+    char** c_paths = calloc(path_count > 0 ? path_count : 1, sizeof(char*));
+    uint8_t** c_patterns = calloc(pattern_count > 0 ? pattern_count : 1, sizeof(uint8_t*));
+    size_t* pattern_lens = calloc(pattern_count > 0 ? pattern_count : 1, sizeof(size_t));
+    int32_t* results = calloc(path_count > 0 ? path_count : 1, sizeof(int32_t));
+    if (!c_paths || !c_patterns || !pattern_lens || !results) {
+        goto cleanup;
+    }
+
+    for (jsize i = 0; i < pattern_count; i++) {
+        jbyteArray pattern = (jbyteArray)(*env)->GetObjectArrayElement(env, patterns, i);
+        c_patterns[i] = jbytearray_to_uint8(env, pattern, &pattern_lens[i]);
+        if (pattern) (*env)->DeleteLocalRef(env, pattern);
+    }
+    for (jsize i = 0; i < path_count; i++) {
+        jstring path = (jstring)(*env)->GetObjectArrayElement(env, paths, i);
+        c_paths[i] = jstring_to_cstring(env, path);
+        if (path) (*env)->DeleteLocalRef(env, path);
+        if (!c_paths[i]) goto cleanup;
+    }
+
+    if (vault_scanner_create((const uint8_t* const*)c_patterns, pattern_lens,
+                             (uint32_t)pattern_count, &scanner) != VAULT_OK) {
+        goto cleanup;
+    }
+    if (vault_scanner_scan_files(scanner, (const char* const*)c_paths,
+                                 (uint32_t)path_count,
+                                 threads > 0 ? (uint32_t)threads : 1,
+                                 results) != VAULT_OK) {
+        goto cleanup;
+    }
+
+    output = (*env)->NewIntArray(env, path_count);
+    if (output) (*env)->SetIntArrayRegion(env, output, 0, path_count, (const jint*)results);
+
+cleanup:
+    vault_scanner_free(scanner);
+    if (c_paths) {
+        for (jsize i = 0; i < path_count; i++) free(c_paths[i]);
+        free(c_paths);
+    }
+    if (c_patterns) {
+        for (jsize i = 0; i < pattern_count; i++) {
+            if (c_patterns[i]) {
+                vault_zeroize(c_patterns[i], pattern_lens[i]);
+                free(c_patterns[i]);
+            }
+        }
+        free(c_patterns);
+    }
+    free(pattern_lens);
+    free(results);
+    return output;
+}
+
+/**
+ * Push the device signals the concurrency governor works from.
+ * Negative headroom/battery mean unknown.
+ */
+JNIEXPORT void JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeGovernorSetSignals(
+    JNIEnv* env, jclass clazz,
+    jfloat thermalHeadroom,
+    jint thermalStatus,
+    jint batteryPercent,
+    jboolean charging,
+    jboolean powerSave
+) {
+    UNUSED(env);
+    UNUSED(clazz);
+
+    vault_governor_signals_t signals = {
+        .thermal_headroom = thermalHeadroom,
+        .thermal_status = thermalStatus,
+        .battery_percent = batteryPercent,
+        .charging = charging == JNI_TRUE,
+        .power_save = powerSave == JNI_TRUE
+    };
+    vault_governor_set_signals(&signals);
+}
+
+/**
+ * Worker count a Kotlin-side pool may use now (1..maxWorkers).
+ */
+JNIEXPORT jint JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeGovernorWorkers(
+    JNIEnv* env, jclass clazz,
+    jint maxWorkers
+) {
+    UNUSED(env);
+    UNUSED(clazz);
+
+    if (maxWorkers < 1) {
+        return 1;
+    }
+    return (jint)vault_governor_workers(VAULT_JOB_KOTLIN, (uint32_t)maxWorkers);
+}
+
+/**
+ * Bulk I/O rate a Kotlin-side job may use now, in bytes per second (0 = unpaced).
+ */
+JNIEXPORT jlong JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeGovernorIoRate(
+    JNIEnv* env, jclass clazz
+) {
+    UNUSED(env);
+    UNUSED(clazz);
+
+    return (jlong)vault_governor_io_rate();
+}
+
 // Register native methods
 static JNINativeMethod gMethods[] = {
     {"nativeInit", "()I", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeInit},
@@ -556,13 +1463,40 @@ static JNINativeMethod gMethods[] = {
     {"nativeImportFile", "([BILjava/lang/String;Ljava/lang/String;)[B", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeImportFile},
     {"nativeReadFile", "([B)[B", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeReadFile},
     {"nativeReadChunk", "([BI)[B", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeReadChunk},
+    {"nativeReadChunks", "([BII[BII)I", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeReadChunks},
+    {"nativeReadRange", "([BJ[BII)I", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeReadRange},
     {"nativeDeleteFile", "([B)I", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeDeleteFile},
     {"nativeRenameFile", "([BLjava/lang/String;)I", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeRenameFile},
+    {"nativeDeleteFiles", "([B)I", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeDeleteFiles},
+    {"nativeRenameFiles", "([B[Ljava/lang/String;)I", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeRenameFiles},
+    {"nativeCommitMetadataOps", "([B[B[Ljava/lang/String;)[I", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeCommitMetadataOps},
     {"nativeCompact", "()I", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeCompact},
+    {"nativeTierSetColdDir", "(Ljava/lang/String;)I", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeTierSetColdDir},
+    {"nativeTierMigrate", "(IJ)J", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeTierMigrate},
+    {"nativeTierRecallAll", "()I", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeTierRecallAll},
+    {"nativeRechunkLegacy", "(JJ)J", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeRechunkLegacy},
+    {"nativeGetStats", "([B)[J", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeGetStats},
+    {"nativeAnalyzeLayout", "([I)[J", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeAnalyzeLayout},
+    {"nativeSearchFiles", "(Ljava/lang/String;I[I)[B", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeSearchFiles},
+    {"nativeIndexPendingText", "(II[I)I", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeIndexPendingText},
+    {"nativeSetMediaInfo", "([B[JLjava/lang/String;Ljava/lang/String;)I", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeSetMediaInfo},
+    {"nativeGetMediaInfo", "([B[Ljava/lang/String;)[J", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeGetMediaInfo},
     {"nativeGetEntryCount", "()I", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeGetEntryCount},
     {"nativeListFiles", "()[Lcom/noleak/noleak/vault/VaultFileEntry;", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeListFiles},
+    {"nativeStageArchive", "(I)I", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeStageArchive},
+    {"nativeCommitArchive", "([I)[Lcom/noleak/noleak/vault/VaultArchiveMember;", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeCommitArchive},
+    {"nativeDiscardArchive", "()V", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeDiscardArchive},
+    {"nativeArchiveBytesRead", "()J", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeArchiveBytesRead},
+    {"nativePrepareExport", "([B[Ljava/lang/String;)I", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativePrepareExport},
+    {"nativeWriteExport", "(II)I", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeWriteExport},
+    {"nativeDiscardExport", "()V", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeDiscardExport},
+    {"nativeArchiveBytesWritten", "()J", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeArchiveBytesWritten},
     {"nativeChangePassword", "([B[B)I", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeChangePassword},
     {"nativeSecureWipeFile", "(Ljava/lang/String;)Z", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeSecureWipeFile},
+    {"nativeScanFiles", "([Ljava/lang/String;[[BI)[I", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeScanFiles},
+    {"nativeGovernorSetSignals", "(FIIZZ)V", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeGovernorSetSignals},
+    {"nativeGovernorWorkers", "(I)I", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeGovernorWorkers},
+    {"nativeGovernorIoRate", "()J", (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeGovernorIoRate},
 };
 
 // Register streaming natives (defined in vault_streaming_jni.c)
@@ -0,0 +1,424 @@
+/**
+ * NoLeak Vault Engine - Container Layout Analysis Implementation
+ *
+ * FIEMAP extents of the container are fetched once and merged where they
+ * are contiguous both logically and physically. Each entry is then walked
+ * in read order (chunk 0..n, or its single blob): a logical extent starts
+ * wherever the next piece does not follow the previous one in the file, a
+ * physical extent wherever it does not follow on the device. Dead space is
+ * what remains of [0, committed_size) once the header, the current index
+ * record and every internal piece are removed.
+ */
+
+#include "vault_layout.h"
+#include "vault_tier.h"
+#include <android/log.h>
+#include <fcntl.h>
+#include <linux/fiemap.h>
+#include <linux/fs.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define LOG_TAG "VaultLayout"
+
+#ifdef NDEBUG
+#define LOGI(...) ((void)0)
+#define LOGE(...) ((void)0)
+#else
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#endif
+
+#define FIEMAP_BATCH 256
+
+extern vault_state_t g_vault;
+extern uint64_t vault_container_header_size(void);
+extern int vault_container_index_records(int fd, uint64_t file_size,
+                                         vault_layout_index_t *records,
+                                         uint32_t cap, uint32_t *count_out);
+
+typedef struct {
+  uint64_t logical;
+  uint64_t physical;
+  uint64_t length;
+} layout_extent_t;
+
+typedef struct {
+  uint64_t start;
+  uint64_t end;
+} layout_range_t;
+
+typedef struct {
+  const layout_extent_t *extents; // NULL without FIEMAP
+  uint32_t extent_count;
+  vault_layout_entry_t *out;
+  int have_span;
+  int have_logical;
+  uint64_t logical_end;
+  int have_physical;
+  uint64_t physical_end;
+} layout_walk_t;
+
+// ============================================================================
+// Physical extents
+// ============================================================================
+
+static int extent_append(layout_extent_t **extents, uint32_t *count,
+                         uint32_t *cap, const struct fiemap_extent *fe) {
+  if (*count > 0) {
+    layout_extent_t *last = &(*extents)[*count - 1];
+    if (last->logical + last->length == fe->fe_logical &&
+        last->physical + last->length == fe->fe_physical) {
+      last->length += fe->fe_length;
+      return VAULT_OK;
+    }
+  }
+  if (*count == *cap) {
+    uint32_t new_cap = *cap ? *cap * 2 : FIEMAP_BATCH;
+    layout_extent_t *grown = realloc(*extents, new_cap * sizeof(**extents));
+    if (!grown)
+      return VAULT_ERR_MEMORY;
+    *extents = grown;
+    *cap = new_cap;
+  }
+  (*extents)[*count].logical = fe->fe_logical;
+  (*extents)[*count].physical = fe->fe_physical;
+  (*extents)[*count].length = fe->fe_length;
+  (*count)++;
+  return VAULT_OK;
+}
+
+// Map the whole file. Returns VAULT_ERR_IO when the filesystem has no
+// FIEMAP support; the caller then reports logical figures only.
+static int layout_fiemap(int fd, uint64_t size, layout_extent_t **out,
+                         uint32_t *count_out) {
+  *out = NULL;
+  *count_out = 0;
+  struct fiemap *fm = calloc(1, sizeof(struct fiemap) +
+                                    FIEMAP_BATCH * sizeof(struct fiemap_extent));
+  if (!fm)
+    return VAULT_ERR_MEMORY;
+
+  layout_extent_t *extents = NULL;
+  uint32_t count = 0;
+  uint32_t cap = 0;
+  uint64_t start = 0;
+  int result = VAULT_OK;
+  // SYNC first so delayed allocations have their final placement.
+  uint32_t flags = FIEMAP_FLAG_SYNC;
+  while (start < size) {
+    memset(fm, 0, sizeof(struct fiemap));
+    fm->fm_start = start;
+    fm->fm_length = size - start;
+    fm->fm_flags = flags;
+    fm->fm_extent_count = FIEMAP_BATCH;
+    if (ioctl(fd, FS_IOC_FIEMAP, fm) != 0) {
+      result = VAULT_ERR_IO;
+      break;
+    }
+    flags = 0;
+    if (fm->fm_mapped_extents == 0)
+      break;
+    int last = 0;
+    for (uint32_t i = 0; i < fm->fm_mapped_extents && result == VAULT_OK;
+         i++) {
+      const struct fiemap_extent *fe = &fm->fm_extents[i];
+      result = extent_append(&extents, &count, &cap, fe);
+      start = fe->fe_logical + fe->fe_length;
+      if (fe->fe_flags & FIEMAP_EXTENT_LAST)
+        last = 1;
+    }
+    if (result != VAULT_OK || last)
+      break;
+  }
+  free(fm);
+  if (result != VAULT_OK) {
+    free(extents);
+    return result;
+  }
+  *out = extents;
+  *count_out = count;
+  return VAULT_OK;
+}
+
+// Index of the extent containing offset, or of the first one after it
+// (extent_count if none).
+static uint32_t extent_find(const layout_extent_t *extents, uint32_t count,
+                            uint64_t offset) {
+  uint32_t lo = 0;
+  uint32_t hi = count;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (extents[mid].logical + extents[mid].length <= offset)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+// ============================================================================
+// Entry walk
+// ============================================================================
+
+static void walk_piece(layout_walk_t *w, uint64_t offset, uint64_t length) {
+  vault_layout_entry_t *out = w->out;
+  uint64_t end = offset + length;
+  if (!w->have_span) {
+    out->first_offset = offset;
+    out->span = length;
+    w->have_span = 1;
+  } else {
+    uint64_t last = out->first_offset + out->span;
+    if (offset < out->first_offset)
+      out->first_offset = offset;
+    if (end > last)
+      last = end;
+    out->span = last - out->first_offset;
+  }
+  out->stored_bytes += length;
+
+  if (!w->have_logical || offset != w->logical_end)
+    out->logical_extents++;
+  w->have_logical = 1;
+  w->logical_end = end;
+
+  if (!w->extents) {
+    out->physical_extents = out->logical_extents;
+    return;
+  }
+  uint64_t pos = offset;
+  while (pos < end) {
+    uint32_t i = extent_find(w->extents, w->extent_count, pos);
+    if (i == w->extent_count || w->extents[i].logical > pos) {
+      // Unmapped range (hole or inline data): always a new run
+      uint64_t next = i < w->extent_count ? w->extents[i].logical : end;
+      out->physical_extents++;
+      w->have_physical = 0;
+      pos = next < end ? next : end;
+      continue;
+    }
+    const layout_extent_t *e = &w->extents[i];
+    uint64_t physical = e->physical + (pos - e->logical);
+    uint64_t extent_end = e->logical + e->length;
+    uint64_t run = (extent_end < end ? extent_end : end) - pos;
+    if (!w->have_physical || physical != w->physical_end)
+      out->physical_extents++;
+    w->have_physical = 1;
+    w->physical_end = physical + run;
+    pos += run;
+  }
+}
+
+static void walk_entry(layout_walk_t *w, const vault_entry_t *entry) {
+  vault_layout_entry_t *out = w->out;
+  memcpy(out->file_id, entry->file_id, VAULT_ID_LEN);
+  out->is_system = entry->name && strncmp(entry->name, "__", 2) == 0;
+  out->size = entry->size;
+  w->have_span = 0;
+  w->have_logical = 0;
+  w->have_physical = 0;
+
+  if (entry->chunk_count > 0) {
+    for (uint32_t c = 0; c < entry->chunk_count; c++) {
+      if (vault_tier_chunk_is_cold(entry, c)) {
+        // Read from another file: the next internal chunk starts over.
+        out->cold_chunks++;
+        w->have_logical = 0;
+        w->have_physical = 0;
+        continue;
+      }
+      walk_piece(w, entry->chunks[c].offset, entry->chunks[c].length);
+    }
+  } else if (entry->data_length > 0) {
+    walk_piece(w, entry->data_offset, entry->data_length);
+  }
+
+  uint64_t bytes = out->stored_bytes;
+  for (uint32_t c = 0; c < entry->chunk_count; c++) {
+    if (vault_tier_chunk_is_cold(entry, c))
+      bytes += entry->chunks[c].length;
+  }
+  out->read_cost_us =
+      bytes * 1000 / VAULT_LAYOUT_READ_BYTES_PER_MS +
+      (uint64_t)(out->physical_extents + out->cold_chunks) *
+          VAULT_LAYOUT_BREAK_COST_US;
+}
+
+// ============================================================================
+// Dead space
+// ============================================================================
+
+static int range_compare(const void *a, const void *b) {
+  const layout_range_t *ra = a;
+  const layout_range_t *rb = b;
+  if (ra->start != rb->start)
+    return ra->start < rb->start ? -1 : 1;
+  return 0;
+}
+
+static void add_dead(vault_layout_report_t *report, uint64_t start,
+                     uint64_t end) {
+  uint64_t length = end - start;
+  report->dead_bytes += length;
+  report->dead_runs++;
+  if (length > report->largest_dead_run)
+    report->largest_dead_run = length;
+
+  uint64_t width = (report->committed_size + VAULT_LAYOUT_DEAD_BUCKETS - 1) /
+                   VAULT_LAYOUT_DEAD_BUCKETS;
+  if (width == 0)
+    width = 1;
+  while (start < end) {
+    uint64_t bucket = start / width;
+    if (bucket >= VAULT_LAYOUT_DEAD_BUCKETS)
+      bucket = VAULT_LAYOUT_DEAD_BUCKETS - 1;
+    uint64_t bucket_end = (bucket + 1) * width;
+    uint64_t piece = (bucket_end < end ? bucket_end : end) - start;
+    if (bucket == VAULT_LAYOUT_DEAD_BUCKETS - 1)
+      piece = end - start;
+    report->dead_buckets[bucket] += piece;
+    start += piece;
+  }
+}
+
+static int layout_dead_space(vault_layout_report_t *report) {
+  uint64_t range_count = 2;
+  for (uint32_t i = 0; i < g_vault.entry_count; i++) {
+    const vault_entry_t *entry = &g_vault.entries[i];
+    range_count += entry->chunk_count > 0 ? entry->chunk_count : 1;
+  }
+  layout_range_t *ranges = malloc((size_t)range_count * sizeof(*ranges));
+  if (!ranges)
+    return VAULT_ERR_MEMORY;
+
+  size_t n = 0;
+  ranges[n++] = (layout_range_t){0, report->header_bytes};
+  ranges[n++] = (layout_range_t){report->index_offset,
+                                 report->index_offset + report->index_length};
+  for (uint32_t i = 0; i < g_vault.entry_count; i++) {
+    const vault_entry_t *entry = &g_vault.entries[i];
+    if (entry->chunk_count == 0) {
+      if (entry->data_length > 0)
+        ranges[n++] = (layout_range_t){
+            entry->data_offset, entry->data_offset + entry->data_length};
+      continue;
+    }
+    for (uint32_t c = 0; c < entry->chunk_count; c++) {
+      if (!vault_tier_chunk_is_cold(entry, c))
+        ranges[n++] = (layout_range_t){
+            entry->chunks[c].offset,
+            entry->chunks[c].offset + entry->chunks[c].length};
+    }
+  }
+  qsort(ranges, n, sizeof(*ranges), range_compare);
+
+  uint64_t cursor = 0;
+  uint64_t limit = report->committed_size;
+  for (size_t i = 0; i < n && cursor < limit; i++) {
+    if (ranges[i].start > cursor)
+      add_dead(report, cursor, ranges[i].start < limit ? ranges[i].start
+                                                        : limit);
+    if (ranges[i].end > cursor)
+      cursor = ranges[i].end;
+  }
+  if (cursor < limit)
+    add_dead(report, cursor, limit);
+  report->live_bytes = limit - report->dead_bytes;
+  free(ranges);
+  return VAULT_OK;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void vault_layout_free(vault_layout_report_t *report) {
+  if (!report)
+    return;
+  free(report->entries);
+  report->entries = NULL;
+  report->entry_count = 0;
+}
+
+int vault_analyze_layout(vault_layout_report_t *report_out) {
+  if (!g_vault.is_open || !g_vault.path)
+    return VAULT_ERR_NOT_OPEN;
+  if (!report_out)
+    return VAULT_ERR_INVALID_PARAM;
+  memset(report_out, 0, sizeof(*report_out));
+  uint64_t header_bytes = vault_container_header_size();
+  if (header_bytes == 0)
+    return VAULT_ERR_INVALID_PARAM;
+
+  int fd = open(g_vault.path, O_RDONLY);
+  if (fd < 0)
+    return VAULT_ERR_IO;
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return VAULT_ERR_IO;
+  }
+
+  vault_layout_report_t report;
+  memset(&report, 0, sizeof(report));
+  report.file_size = (uint64_t)st.st_size;
+  report.committed_size = g_vault.committed_size;
+  report.header_bytes = header_bytes;
+  report.index_offset = g_vault.index_offset;
+  report.index_length = g_vault.index_length;
+
+  int result = vault_container_index_records(
+      fd, report.file_size, report.index_records,
+      VAULT_LAYOUT_MAX_INDEX_RECORDS, &report.index_record_count);
+  if (result != VAULT_OK) {
+    close(fd);
+    return result;
+  }
+
+  layout_extent_t *extents = NULL;
+  uint32_t extent_count = 0;
+  result = layout_fiemap(fd, report.file_size, &extents, &extent_count);
+  close(fd);
+  if (result == VAULT_ERR_MEMORY)
+    return result;
+  report.fiemap_supported = result == VAULT_OK;
+  report.file_physical_extents = extent_count;
+  if (!report.fiemap_supported)
+    LOGI("vault_analyze_layout: FIEMAP unavailable, logical layout only");
+
+  report.entries =
+      calloc(g_vault.entry_count ? g_vault.entry_count : 1,
+             sizeof(vault_layout_entry_t));
+  if (!report.entries) {
+    free(extents);
+    return VAULT_ERR_MEMORY;
+  }
+  report.entry_count = g_vault.entry_count;
+  layout_walk_t walk = {
+      .extents = report.fiemap_supported ? extents : NULL,
+      .extent_count = extent_count,
+  };
+  for (uint32_t i = 0; i < g_vault.entry_count; i++) {
+    walk.out = &report.entries[i];
+    walk_entry(&walk, &g_vault.entries[i]);
+    report.read_cost_us += report.entries[i].read_cost_us;
+  }
+  free(extents);
+
+  result = layout_dead_space(&report);
+  if (result != VAULT_OK) {
+    vault_layout_free(&report);
+    return result;
+  }
+
+  LOGI("vault_analyze_layout: %u entries, %llu dead bytes in %u runs, "
+       "%u physical extents",
+       report.entry_count, (unsigned long long)report.dead_bytes,
+       report.dead_runs, report.file_physical_extents);
+  *report_out = report;
+  return VAULT_OK;
+}
@@ -0,0 +1,96 @@
+/**
+ * NoLeak Vault Engine - Container Layout Analysis
+ *
+ * Combines the logical extent map from the index (where each entry's
+ * ciphertext sits inside the container) with the filesystem's physical
+ * extent map (FIEMAP) to show how reads of each entry actually hit flash.
+ * The analysis is read-only and only walks in-memory metadata plus one
+ * FIEMAP query; no ciphertext is read.
+ *
+ * - Per entry: logical runs in read order, physical extents behind them,
+ *   chunks moved to the cold segment and a sequential-read cost estimate
+ * - Whole file: dead space (retired index records, deleted data) and how it
+ *   is spread over the file, plus the index record of every root slot
+ * - Without FIEMAP (FUSE, some SD card filesystems) physical figures fall
+ *   back to the logical ones and fiemap_supported is 0
+ */
+
+#ifndef VAULT_LAYOUT_H
+#define VAULT_LAYOUT_H
+
+#include "vault_engine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Dead space is reported per 1/VAULT_LAYOUT_DEAD_BUCKETS of the file
+#define VAULT_LAYOUT_DEAD_BUCKETS 32
+
+// Read cost model: streaming throughput plus a fixed penalty per break in
+// the physical read sequence (request split, flash page miss)
+#define VAULT_LAYOUT_READ_BYTES_PER_MS (200ull * 1024)
+#define VAULT_LAYOUT_BREAK_COST_US 150ull
+
+// One index record per root slot; the container keeps two
+#define VAULT_LAYOUT_MAX_INDEX_RECORDS 2
+
+typedef struct {
+  uint64_t seq;               // commit sequence of the root slot
+  uint64_t offset;
+  uint64_t length;
+} vault_layout_index_t;
+
+typedef struct {
+  uint8_t file_id[VAULT_ID_LEN];
+  uint8_t is_system;          // "__" entries (folder map, vault title)
+  uint64_t size;              // plaintext bytes
+  uint64_t stored_bytes;      // ciphertext bytes in the container
+  uint64_t first_offset;      // lowest container offset used
+  uint64_t span;              // highest end minus first_offset
+  uint32_t logical_extents;   // contiguous runs in read order
+  uint32_t physical_extents;  // physical runs in read order
+  uint32_t cold_chunks;       // chunks stored in the cold segment
+  uint64_t read_cost_us;      // estimated time to read the entry once
+} vault_layout_entry_t;
+
+typedef struct {
+  uint64_t file_size;         // container size on disk
+  uint64_t committed_size;    // size covered by the current root slot
+  uint64_t header_bytes;      // super block and root slots
+  uint64_t index_offset;      // current encrypted index record
+  uint64_t index_length;
+  // Records named by valid root slots, newest (current) first. Older ones
+  // are retired and count as dead space unless a slot mirrors the current.
+  uint32_t index_record_count;
+  vault_layout_index_t index_records[VAULT_LAYOUT_MAX_INDEX_RECORDS];
+  uint64_t live_bytes;        // referenced ciphertext, header and index
+  uint64_t dead_bytes;        // unreferenced bytes below committed_size
+  uint32_t dead_runs;
+  uint64_t largest_dead_run;
+  uint64_t dead_buckets[VAULT_LAYOUT_DEAD_BUCKETS];
+  int fiemap_supported;
+  uint32_t file_physical_extents; // extents of the whole container file
+  uint64_t read_cost_us;      // all entries read once, in index order
+  uint32_t entry_count;
+  vault_layout_entry_t *entries;
+} vault_layout_report_t;
+
+/**
+ * Analyze the open vault's container layout.
+ * @param report_out Receives the report (free with vault_layout_free)
+ * @return VAULT_OK on success, VAULT_ERR_INVALID_PARAM for containers that
+ * predate the log format
+ */
+int vault_analyze_layout(vault_layout_report_t *report_out);
+
+/**
+ * Free the entries of a report returned by vault_analyze_layout.
+ */
+void vault_layout_free(vault_layout_report_t *report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VAULT_LAYOUT_H
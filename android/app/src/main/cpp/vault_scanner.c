@@ -0,0 +1,270 @@
+/**
+ * NoLeak Vault Engine - Plaintext Leak Scanner Implementation
+ *
+ * Aho-Corasick automaton compiled to a dense DFA (256 transitions per state),
+ * so the inner loop is one table lookup per input byte independent of the
+ * number of patterns.
+ */
+
+#include "vault_scanner.h"
+#include "vault_engine.h"
+#include "vault_governor.h"
+#include <android/log.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define LOG_TAG "VaultScanner"
+
+#ifdef NDEBUG
+#define LOGI(...) ((void)0)
+#define LOGE(...) ((void)0)
+#else
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#endif
+
+// Files are read in windows of this size; automaton state carries across.
+#define SCAN_READ_SIZE (1024 * 1024)
+// Upper bound on automaton size (sum of pattern lengths + root).
+#define SCAN_MAX_STATES (64 * 1024)
+
+struct vault_scanner {
+  uint32_t state_count;
+  int32_t *next;    // state_count * 256 DFA transitions
+  uint8_t *output;  // non-zero when a pattern ends in this state
+};
+
+typedef struct {
+  const vault_scanner_t *scanner;
+  const char *const *paths;
+  uint32_t count;
+  int32_t *results;
+  atomic_uint next_index;
+} scan_job_t;
+
+int vault_scanner_create(const uint8_t *const *patterns, const size_t *lens,
+                         uint32_t count, vault_scanner_t **scanner_out) {
+  if (!scanner_out || (count > 0 && (!patterns || !lens)))
+    return VAULT_ERR_INVALID_PARAM;
+  *scanner_out = NULL;
+
+  size_t max_states = 1;
+  for (uint32_t i = 0; i < count; i++) {
+    if (!patterns[i] && lens[i] > 0)
+      return VAULT_ERR_INVALID_PARAM;
+    max_states += lens[i];
+    if (max_states > SCAN_MAX_STATES)
+      return VAULT_ERR_INVALID_PARAM;
+  }
+
+  int result = VAULT_OK;
+  uint32_t *fail = NULL;
+  uint32_t *queue = NULL;
+  vault_scanner_t *scanner = calloc(1, sizeof(*scanner));
+  if (!scanner)
+    return VAULT_ERR_MEMORY;
+  scanner->next = malloc(max_states * 256 * sizeof(int32_t));
+  scanner->output = calloc(max_states, 1);
+  fail = calloc(max_states, sizeof(uint32_t));
+  queue = malloc(max_states * sizeof(uint32_t));
+  if (!scanner->next || !scanner->output || !fail || !queue) {
+    result = VAULT_ERR_MEMORY;
+    goto cleanup;
+  }
+  memset(scanner->next, 0xFF, max_states * 256 * sizeof(int32_t));
+
+  // Trie of all patterns; -1 marks a missing edge until the DFA pass.
+  uint32_t states = 1;
+  for (uint32_t i = 0; i < count; i++) {
+    if (lens[i] == 0)
+      continue;
+    uint32_t s = 0;
+    for (size_t j = 0; j < lens[i]; j++) {
+      int32_t *edge = &scanner->next[s * 256 + patterns[i][j]];
+      if (*edge < 0)
+        *edge = (int32_t)states++;
+      s = (uint32_t)*edge;
+    }
+    scanner->output[s] = 1;
+  }
+
+  // Breadth-first failure links, filling missing edges so the result is a
+  // complete DFA.
+  uint32_t head = 0;
+  uint32_t tail = 0;
+  for (int c = 0; c < 256; c++) {
+    int32_t *edge = &scanner->next[c];
+    if (*edge < 0) {
+      *edge = 0;
+    } else {
+      fail[*edge] = 0;
+      queue[tail++] = (uint32_t)*edge;
+    }
+  }
+  while (head < tail) {
+    uint32_t s = queue[head++];
+    if (scanner->output[fail[s]])
+      scanner->output[s] = 1;
+    for (int c = 0; c < 256; c++) {
+      int32_t *edge = &scanner->next[s * 256 + c];
+      int32_t via_fail = scanner->next[fail[s] * 256 + c];
+      if (*edge < 0) {
+        *edge = via_fail;
+      } else {
+        fail[*edge] = (uint32_t)via_fail;
+        queue[tail++] = (uint32_t)*edge;
+      }
+    }
+  }
+  scanner->state_count = states;
+
+  *scanner_out = scanner;
+  scanner = NULL;
+  LOGI("Scanner built: %u patterns, %u states", count, states);
+
+cleanup:
+  free(fail);
+  free(queue);
+  vault_scanner_free(scanner);
+  return result;
+}
+
+void vault_scanner_free(vault_scanner_t *scanner) {
+  if (!scanner)
+    return;
+  free(scanner->next);
+  free(scanner->output);
+  free(scanner);
+}
+
+int vault_scanner_scan_file(const vault_scanner_t *scanner, const char *path,
+                            int32_t *result_out) {
+  if (!scanner || !path || !result_out)
+    return VAULT_ERR_INVALID_PARAM;
+  *result_out = SCAN_SIG_NONE;
+
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return VAULT_ERR_IO;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    close(fd);
+    return VAULT_ERR_IO;
+  }
+  uint64_t size = (uint64_t)st.st_size;
+  int has_patterns = scanner->state_count > 1;
+
+  // Signature-only scans never need more than the header.
+  if (!has_patterns) {
+    uint8_t header[SCAN_SIGNATURE_LEN];
+    ssize_t n = size >= SCAN_SIGNATURE_LEN ? pread(fd, header, sizeof(header), 0)
+                                           : 0;
+    close(fd);
+    if (n < 0)
+      return VAULT_ERR_IO;
+    *result_out = vault_scanner_detect_signature(header, (size_t)n);
+    return VAULT_OK;
+  }
+
+  uint8_t *buffer = malloc(SCAN_READ_SIZE);
+  if (!buffer) {
+    close(fd);
+    return VAULT_ERR_MEMORY;
+  }
+  posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+  // pread rather than mmap: a file truncated mid-scan reads short instead of
+  // raising SIGBUS, and the scan simply ends at the new end of file.
+  int result = VAULT_OK;
+  int32_t found = SCAN_SIG_NONE;
+  uint32_t s = 0;
+  uint64_t offset = 0;
+  for (;;) {
+    ssize_t n = pread(fd, buffer, SCAN_READ_SIZE, (off_t)offset);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0) {
+      result = VAULT_ERR_IO;
+      break;
+    }
+    if (n == 0)
+      break;
+    size_t window = (size_t)n;
+    if (offset == 0)
+      found = vault_scanner_detect_signature(buffer, window);
+    offset += window;
+
+    int matched = 0;
+    for (size_t i = 0; i < window; i++) {
+      s = (uint32_t)scanner->next[s * 256 + buffer[i]];
+      if (scanner->output[s]) {
+        matched = 1;
+        break;
+      }
+    }
+    if (matched) {
+      found |= SCAN_RESULT_PATTERN;
+      break;
+    }
+  }
+  free(buffer);
+  close(fd);
+
+  *result_out = found;
+  return result;
+}
+
+static void *scan_worker(void *arg) {
+  scan_job_t *job = arg;
+  for (;;) {
+    uint32_t i = atomic_fetch_add(&job->next_index, 1);
+    if (i >= job->count)
+      break;
+    int32_t found = SCAN_SIG_NONE;
+    int result = vault_scanner_scan_file(job->scanner, job->paths[i], &found);
+    job->results[i] = result == VAULT_OK ? found : result;
+  }
+  return NULL;
+}
+
+int vault_scanner_scan_files(const vault_scanner_t *scanner,
+                             const char *const *paths, uint32_t count,
+                             uint32_t thread_count, int32_t *results) {
+  if (!scanner || (count > 0 && (!paths || !results)))
+    return VAULT_ERR_INVALID_PARAM;
+  if (count == 0)
+    return VAULT_OK;
+
+  scan_job_t job = {
+      .scanner = scanner, .paths = paths, .count = count, .results = results};
+  atomic_init(&job.next_index, 0);
+
+  if (thread_count == 0)
+    thread_count = 1;
+  if (thread_count > SCAN_MAX_THREADS)
+    thread_count = SCAN_MAX_THREADS;
+  thread_count = vault_governor_workers(VAULT_JOB_SCAN, thread_count);
+  if (thread_count > count)
+    thread_count = count;
+
+  // The calling thread is one of the workers.
+  pthread_t threads[SCAN_MAX_THREADS];
+  uint32_t started = 0;
+  for (uint32_t t = 1; t < thread_count; t++) {
+    if (pthread_create(&threads[started], NULL, scan_worker, &job) != 0)
+      break;
+    started++;
+  }
+  scan_worker(&job);
+  for (uint32_t t = 0; t < started; t++)
+    pthread_join(threads[t], NULL);
+
+  LOGI("Scanned %u files on %u threads", count, started + 1);
+  return VAULT_OK;
+}
@@ -0,0 +1,101 @@
+/**
+ * NoLeak Vault Engine - Plaintext Leak Scanner
+ *
+ * Multi-pattern (Aho-Corasick) scan of app storage files for known plaintext
+ * markers, combined with file-signature detection in the same pass.
+ *
+ * - Files are streamed through fixed-size pread windows, so size is unbounded
+ *   and a file truncated during the scan cannot fault the process
+ * - The automaton is built once and shared read-only across worker threads
+ * - Signature (magic byte) detection reuses the first window
+ */
+
+#ifndef VAULT_SCANNER_H
+#define VAULT_SCANNER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Detected file signatures (low byte of a scan result)
+#define SCAN_SIG_NONE 0
+#define SCAN_SIG_JPEG 1
+#define SCAN_SIG_PNG 2
+#define SCAN_SIG_MP4 3
+#define SCAN_SIG_RIFF 4
+#define SCAN_SIG_MKV 5
+
+// Set in a scan result when any known pattern occurs in the file
+#define SCAN_RESULT_PATTERN 0x100
+
+#define SCAN_MAX_THREADS 8
+#define SCAN_SIGNATURE_LEN 8
+
+typedef struct vault_scanner vault_scanner_t;
+
+/**
+ * Build a scanner for the given byte patterns.
+ * Empty patterns are ignored; zero patterns yields a signature-only scanner.
+ *
+ * @param patterns Pattern byte arrays
+ * @param lens Pattern lengths
+ * @param count Number of patterns
+ * @param scanner_out Receives the scanner (free with vault_scanner_free)
+ * @return VAULT_OK on success
+ */
+int vault_scanner_create(const uint8_t *const *patterns, const size_t *lens,
+                         uint32_t count, vault_scanner_t **scanner_out);
+
+void vault_scanner_free(vault_scanner_t *scanner);
+
+/**
+ * Scan one file.
+ * @param scanner Scanner from vault_scanner_create
+ * @param path File path
+ * @param result_out SCAN_SIG_* in the low byte, SCAN_RESULT_PATTERN if a
+ * pattern matched
+ * @return VAULT_OK on success, VAULT_ERR_IO if the file cannot be read
+ */
+int vault_scanner_scan_file(const vault_scanner_t *scanner, const char *path,
+                            int32_t *result_out);
+
+/**
+ * Scan many files on up to thread_count worker threads.
+ * results[i] receives the scan result for paths[i], or a negative
+ * VAULT_ERR_* code when that file could not be read.
+ *
+ * @return VAULT_OK on success
+ */
+int vault_scanner_scan_files(const vault_scanner_t *scanner,
+                             const char *const *paths, uint32_t count,
+                             uint32_t thread_count, int32_t *results);
+
+/**
+ * Classify the first SCAN_SIGNATURE_LEN bytes of a file.
+ * @return SCAN_SIG_* value
+ */
+static inline int vault_scanner_detect_signature(const uint8_t *h,
+                                                 size_t len) {
+  if (!h || len < SCAN_SIGNATURE_LEN)
+    return SCAN_SIG_NONE;
+  if (h[0] == 0xFF && h[1] == 0xD8 && h[2] == 0xFF)
+    return SCAN_SIG_JPEG;
+  if (h[0] == 0x89 && h[1] == 0x50 && h[2] == 0x4E && h[3] == 0x47)
+    return SCAN_SIG_PNG;
+  if (h[4] == 0x66 && h[5] == 0x74 && h[6] == 0x79 && h[7] == 0x70)
+    return SCAN_SIG_MP4;
+  if (h[0] == 0x52 && h[1] == 0x49 && h[2] == 0x46 && h[3] == 0x46)
+    return SCAN_SIG_RIFF;
+  if (h[0] == 0x1A && h[1] == 0x45 && h[2] == 0xDF && h[3] == 0xA3)
+    return SCAN_SIG_MKV;
+  return SCAN_SIG_NONE;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VAULT_SCANNER_H
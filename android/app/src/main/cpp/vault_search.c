@@ -0,0 +1,616 @@
+/**
+ * NoLeak Vault Engine - Encrypted Full-Text Search Implementation
+ *
+ * Term record layout (VAULT_EXT_SEARCH_TERMS), all varints (LEB128):
+ *   term_count, then per term sorted by hash:
+ *   hash delta, first position (token ordinal), frequency
+ *
+ * Only the first position of each term is kept, not its full position list,
+ * so queries cannot match phrases or proximity. Full lists would make the
+ * record of a 10 MB text several MB, in an index rewritten on every commit.
+ *
+ * The inverted index maps each term hash to postings ordered by document
+ * number. Documents are numbered in the order they join the index, so
+ * appends keep every posting list sorted and queries intersect by binary
+ * search. Deleted documents are tombstoned and dropped by the next rebuild.
+ */
+
+#include "vault_search.h"
+#include <android/log.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "VaultSearch"
+
+#ifdef NDEBUG
+#define LOGI(...) ((void)0)
+#define LOGE(...) ((void)0)
+#else
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#endif
+
+#define SEARCH_MIN_TOKEN_LEN 2
+#define SEARCH_MAX_TOKEN_LEN 64
+#define SEARCH_MAX_QUERY_TERMS 16
+#define SEARCH_VARINT_MAX 5
+// Tombstones tolerated before the next query rebuilds the inverted index.
+#define SEARCH_MAX_DEAD_DOCS 64
+
+typedef void (*search_token_fn)(void *ctx, uint32_t term, uint32_t position);
+
+typedef struct {
+  uint32_t term;
+  uint32_t first_pos;
+  uint32_t freq;
+} search_term_t;
+
+typedef struct {
+  search_term_t *slots; // open addressing, term 0 = empty
+  uint32_t slot_cap;
+  uint32_t distinct;
+} term_builder_t;
+
+typedef struct {
+  uint32_t doc;
+  uint32_t first_pos;
+  uint32_t freq;
+} search_posting_t;
+
+typedef struct {
+  uint32_t term; // 0 = empty slot
+  uint32_t count;
+  uint32_t cap;
+  search_posting_t *postings;
+} search_slot_t;
+
+typedef struct {
+  uint8_t file_id[VAULT_ID_LEN];
+  uint8_t live;
+} search_doc_t;
+
+typedef struct {
+  uint32_t doc;
+  uint32_t score;
+  uint32_t first_pos;
+} search_hit_t;
+
+static struct {
+  search_slot_t *slots;
+  uint32_t slot_cap;
+  uint32_t slot_used;
+  search_doc_t *docs;
+  uint32_t doc_count;
+  uint32_t doc_cap;
+  uint32_t dead_docs;
+  int stale; // rebuilt from g_vault.entries before the next query
+} g_search = {.stale = 1};
+
+// ========================================================================
+// Tokenizer and term records
+// ========================================================================
+
+static int is_token_byte(uint8_t c) {
+  uint8_t lower = c | 0x20;
+  return (c >= '0' && c <= '9') || (lower >= 'a' && lower <= 'z') || c >= 0x80;
+}
+
+static void tokenize(const uint8_t *text, size_t len, search_token_fn fn,
+                     void *ctx) {
+  uint32_t position = 0;
+  size_t i = 0;
+  while (i < len) {
+    if (!is_token_byte(text[i])) {
+      i++;
+      continue;
+    }
+    // FNV-1a over the case-folded token, capped at SEARCH_MAX_TOKEN_LEN.
+    uint32_t hash = 2166136261u;
+    size_t token_len = 0;
+    for (; i < len && is_token_byte(text[i]); i++, token_len++) {
+      if (token_len >= SEARCH_MAX_TOKEN_LEN)
+        continue;
+      uint8_t c = text[i];
+      if (c >= 'A' && c <= 'Z')
+        c |= 0x20;
+      hash = (hash ^ c) * 16777619u;
+    }
+    if (token_len < SEARCH_MIN_TOKEN_LEN)
+      continue;
+    fn(ctx, hash ? hash : 1, position);
+    if (position < UINT32_MAX)
+      position++;
+  }
+}
+
+static void builder_add(void *ctx, uint32_t term, uint32_t position) {
+  term_builder_t *builder = ctx;
+  uint32_t mask = builder->slot_cap - 1;
+  for (uint32_t i = term & mask;; i = (i + 1) & mask) {
+    search_term_t *slot = &builder->slots[i];
+    if (slot->term == term) {
+      if (slot->freq < UINT32_MAX)
+        slot->freq++;
+      return;
+    }
+    if (slot->term == 0) {
+      if (builder->distinct >= VAULT_SEARCH_MAX_TERMS)
+        return;
+      slot->term = term;
+      slot->first_pos = position;
+      slot->freq = 1;
+      builder->distinct++;
+      return;
+    }
+  }
+}
+
+static int compare_terms(const void *a, const void *b) {
+  uint32_t ta = ((const search_term_t *)a)->term;
+  uint32_t tb = ((const search_term_t *)b)->term;
+  return ta < tb ? -1 : (ta > tb ? 1 : 0);
+}
+
+static size_t put_varint(uint8_t *out, uint32_t value) {
+  size_t n = 0;
+  while (value >= 0x80) {
+    out[n++] = (uint8_t)(value | 0x80);
+    value >>= 7;
+  }
+  out[n++] = (uint8_t)value;
+  return n;
+}
+
+static int get_varint(const uint8_t *data, uint32_t len, uint32_t *offset,
+                      uint32_t *value_out) {
+  uint32_t value = 0;
+  for (uint32_t shift = 0; shift < 35; shift += 7) {
+    if (*offset >= len)
+      return 0;
+    uint8_t b = data[(*offset)++];
+    value |= (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) {
+      *value_out = value;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int vault_search_is_indexable(const char *mime) {
+  if (!mime)
+    return 0;
+  return strncmp(mime, "text/", 5) == 0 ||
+         strcmp(mime, "application/json") == 0 ||
+         strcmp(mime, "application/xml") == 0 ||
+         strcmp(mime, "application/x-yaml") == 0;
+}
+
+int vault_search_build_terms(const uint8_t *text, size_t len,
+                             uint8_t **blob_out, uint32_t *blob_len_out) {
+  if ((!text && len > 0) || !blob_out || !blob_len_out)
+    return VAULT_ERR_INVALID_PARAM;
+
+  term_builder_t builder = {0};
+  builder.slot_cap = VAULT_SEARCH_MAX_TERMS * 2;
+  builder.slots = calloc(builder.slot_cap, sizeof(search_term_t));
+  if (!builder.slots)
+    return VAULT_ERR_MEMORY;
+  tokenize(text, len, builder_add, &builder);
+
+  // Compact occupied slots to the front, then sort by hash for delta coding.
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < builder.slot_cap; i++) {
+    if (builder.slots[i].term != 0)
+      builder.slots[n++] = builder.slots[i];
+  }
+  qsort(builder.slots, n, sizeof(search_term_t), compare_terms);
+
+  uint8_t *blob = malloc(SEARCH_VARINT_MAX * (1 + 3 * (size_t)n));
+  if (!blob) {
+    vault_zeroize(builder.slots, builder.slot_cap * sizeof(search_term_t));
+    free(builder.slots);
+    return VAULT_ERR_MEMORY;
+  }
+  size_t offset = put_varint(blob, n);
+  uint32_t previous = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    offset += put_varint(blob + offset, builder.slots[i].term - previous);
+    offset += put_varint(blob + offset, builder.slots[i].first_pos);
+    offset += put_varint(blob + offset, builder.slots[i].freq);
+    previous = builder.slots[i].term;
+  }
+  vault_zeroize(builder.slots, builder.slot_cap * sizeof(search_term_t));
+  free(builder.slots);
+
+  *blob_out = blob;
+  *blob_len_out = (uint32_t)offset;
+  return VAULT_OK;
+}
+
+int vault_search_attach_terms(vault_entry_t *entry, const uint8_t *text,
+                              size_t len) {
+  if (!entry)
+    return VAULT_ERR_INVALID_PARAM;
+  uint8_t *blob = NULL;
+  uint32_t blob_len = 0;
+  int result = vault_search_build_terms(text, len, &blob, &blob_len);
+  if (result != VAULT_OK)
+    return result;
+  result = vault_entry_ext_set(entry, VAULT_EXT_SEARCH_TERMS, blob, blob_len);
+  vault_zeroize(blob, blob_len);
+  free(blob);
+  return result;
+}
+
+// ========================================================================
+// Inverted index
+// ========================================================================
+
+static search_slot_t *find_slot(uint32_t term) {
+  if (!g_search.slots)
+    return NULL;
+  uint32_t mask = g_search.slot_cap - 1;
+  for (uint32_t i = term & mask;; i = (i + 1) & mask) {
+    if (g_search.slots[i].term == term)
+      return &g_search.slots[i];
+    if (g_search.slots[i].term == 0)
+      return NULL;
+  }
+}
+
+static int grow_slots(void) {
+  uint32_t new_cap = g_search.slot_cap ? g_search.slot_cap * 2 : 1024;
+  search_slot_t *slots = calloc(new_cap, sizeof(search_slot_t));
+  if (!slots)
+    return VAULT_ERR_MEMORY;
+  uint32_t mask = new_cap - 1;
+  for (uint32_t i = 0; i < g_search.slot_cap; i++) {
+    search_slot_t *old = &g_search.slots[i];
+    if (old->term == 0)
+      continue;
+    uint32_t j = old->term & mask;
+    while (slots[j].term != 0)
+      j = (j + 1) & mask;
+    slots[j] = *old;
+  }
+  if (g_search.slots) {
+    vault_zeroize(g_search.slots, g_search.slot_cap * sizeof(search_slot_t));
+    free(g_search.slots);
+  }
+  g_search.slots = slots;
+  g_search.slot_cap = new_cap;
+  return VAULT_OK;
+}
+
+static search_slot_t *find_or_insert_slot(uint32_t term) {
+  if ((g_search.slot_used + 1) * 4 > g_search.slot_cap * 3 &&
+      grow_slots() != VAULT_OK)
+    return NULL;
+  uint32_t mask = g_search.slot_cap - 1;
+  for (uint32_t i = term & mask;; i = (i + 1) & mask) {
+    search_slot_t *slot = &g_search.slots[i];
+    if (slot->term == term)
+      return slot;
+    if (slot->term == 0) {
+      slot->term = term;
+      g_search.slot_used++;
+      return slot;
+    }
+  }
+}
+
+static int index_terms(uint32_t doc, const uint8_t *blob, uint32_t blob_len) {
+  uint32_t offset = 0;
+  uint32_t n = 0;
+  if (!get_varint(blob, blob_len, &offset, &n))
+    return VAULT_ERR_CORRUPTED;
+  uint32_t term = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    uint32_t delta, first_pos, freq;
+    if (!get_varint(blob, blob_len, &offset, &delta) ||
+        !get_varint(blob, blob_len, &offset, &first_pos) ||
+        !get_varint(blob, blob_len, &offset, &freq))
+      return VAULT_ERR_CORRUPTED;
+    term += delta;
+    if (term == 0)
+      continue;
+    search_slot_t *slot = find_or_insert_slot(term);
+    if (!slot)
+      return VAULT_ERR_MEMORY;
+    if (slot->count == slot->cap) {
+      uint32_t new_cap = slot->cap ? slot->cap * 2 : 4;
+      search_posting_t *postings =
+          realloc(slot->postings, new_cap * sizeof(search_posting_t));
+      if (!postings)
+        return VAULT_ERR_MEMORY;
+      slot->postings = postings;
+      slot->cap = new_cap;
+    }
+    slot->postings[slot->count++] =
+        (search_posting_t){.doc = doc, .first_pos = first_pos, .freq = freq};
+  }
+  return VAULT_OK;
+}
+
+void vault_search_reset(void) {
+  for (uint32_t i = 0; i < g_search.slot_cap; i++) {
+    search_slot_t *slot = &g_search.slots[i];
+    if (slot->postings) {
+      vault_zeroize(slot->postings, slot->cap * sizeof(search_posting_t));
+      free(slot->postings);
+    }
+  }
+  if (g_search.slots) {
+    vault_zeroize(g_search.slots, g_search.slot_cap * sizeof(search_slot_t));
+    free(g_search.slots);
+  }
+  if (g_search.docs) {
+    vault_zeroize(g_search.docs, g_search.doc_cap * sizeof(search_doc_t));
+    free(g_search.docs);
+  }
+  memset(&g_search, 0, sizeof(g_search));
+  g_search.stale = 1;
+}
+
+static int add_entry(const vault_entry_t *entry) {
+  const uint8_t *blob;
+  uint32_t blob_len;
+  if (!vault_entry_ext_find(entry, VAULT_EXT_SEARCH_TERMS, &blob, &blob_len))
+    return VAULT_OK;
+
+  if (g_search.doc_count == g_search.doc_cap) {
+    uint32_t new_cap = g_search.doc_cap ? g_search.doc_cap * 2 : 64;
+    search_doc_t *docs = realloc(g_search.docs, new_cap * sizeof(search_doc_t));
+    if (!docs)
+      return VAULT_ERR_MEMORY;
+    g_search.docs = docs;
+    g_search.doc_cap = new_cap;
+  }
+  uint32_t doc = g_search.doc_count++;
+  memcpy(g_search.docs[doc].file_id, entry->file_id, VAULT_ID_LEN);
+  g_search.docs[doc].live = 1;
+  return index_terms(doc, blob, blob_len);
+}
+
+void vault_search_add_entry(const vault_entry_t *entry) {
+  if (g_search.stale || !entry)
+    return;
+  if (add_entry(entry) != VAULT_OK) {
+    LOGE("vault_search_add_entry: index update failed, rebuilding lazily");
+    vault_search_reset();
+  }
+}
+
+void vault_search_remove_entry(const uint8_t file_id[VAULT_ID_LEN]) {
+  if (g_search.stale || !file_id)
+    return;
+  for (uint32_t d = 0; d < g_search.doc_count; d++) {
+    search_doc_t *doc = &g_search.docs[d];
+    if (doc->live && memcmp(doc->file_id, file_id, VAULT_ID_LEN) == 0) {
+      doc->live = 0;
+      g_search.dead_docs++;
+      break;
+    }
+  }
+  if (g_search.dead_docs > SEARCH_MAX_DEAD_DOCS &&
+      g_search.dead_docs * 2 > g_search.doc_count)
+    vault_search_reset();
+}
+
+// The whole index was replaced (open, migration, compaction); rebuild on the
+// next query rather than on the open path.
+void vault_search_rebuild(void) { vault_search_reset(); }
+
+static int ensure_built(void) {
+  if (!g_search.stale)
+    return VAULT_OK;
+  vault_search_reset();
+  g_search.stale = 0;
+  for (uint32_t i = 0; i < g_vault.entry_count; i++) {
+    int result = add_entry(&g_vault.entries[i]);
+    if (result != VAULT_OK) {
+      vault_search_reset();
+      return result;
+    }
+  }
+  LOGI("Search index built: %u docs, %u terms", g_search.doc_count,
+       g_search.slot_used);
+  return VAULT_OK;
+}
+
+// ========================================================================
+// Backfill and query
+// ========================================================================
+
+// Whole plaintext of a text entry, single blob or chunked
+static int read_text(const vault_entry_t *entry, uint8_t **text_out,
+                     size_t *len_out) {
+  if (entry->chunk_count == 0)
+    return vault_read_file(entry->file_id, text_out, len_out);
+  uint8_t *text = malloc(entry->size ? (size_t)entry->size : 1);
+  if (!text)
+    return VAULT_ERR_MEMORY;
+  size_t got = 0;
+  int result =
+      vault_read_range(entry->file_id, 0, text, (size_t)entry->size, &got);
+  if (result == VAULT_OK && got != entry->size)
+    result = VAULT_ERR_CORRUPTED;
+  if (result != VAULT_OK) {
+    vault_zeroize(text, (size_t)entry->size);
+    free(text);
+    return result;
+  }
+  *text_out = text;
+  *len_out = got;
+  return VAULT_OK;
+}
+
+int vault_search_index_pending(uint32_t start, uint32_t max_files,
+                               uint32_t *next_out, uint32_t *indexed_out) {
+  if (indexed_out)
+    *indexed_out = 0;
+  if (!next_out)
+    return VAULT_ERR_INVALID_PARAM;
+  *next_out = g_vault.entry_count;
+  if (!g_vault.is_open)
+    return VAULT_ERR_NOT_OPEN;
+
+  uint32_t attempted = 0;
+  uint32_t indexed = 0;
+  uint32_t i = start;
+  for (; i < g_vault.entry_count && attempted < max_files; i++) {
+    vault_entry_t *entry = &g_vault.entries[i];
+    if (entry->type != VAULT_FILE_TYPE_TXT ||
+        entry->size > VAULT_SEARCH_MAX_INDEX_SIZE ||
+        (entry->name && strncmp(entry->name, "__", 2) == 0) ||
+        !vault_search_is_indexable(entry->mime) ||
+        vault_entry_ext_find(entry, VAULT_EXT_SEARCH_TERMS, NULL, NULL))
+      continue;
+    attempted++;
+
+    uint8_t *text = NULL;
+    size_t text_len = 0;
+    int result = read_text(entry, &text, &text_len);
+    if (result != VAULT_OK) {
+      // Skipped for this pass; the cursor moves on past it
+      LOGE("vault_search_index_pending: read failed with %d", result);
+      continue;
+    }
+    result = vault_search_attach_terms(entry, text, text_len);
+    vault_zeroize(text, text_len);
+    free(text);
+    if (result != VAULT_OK)
+      return result;
+    indexed++;
+  }
+  *next_out = i < g_vault.entry_count ? i : g_vault.entry_count;
+  if (indexed == 0)
+    return VAULT_OK;
+
+  // Term records are derived data: if this commit fails they stay attached
+  // in memory and are persisted by the next successful commit.
+  vault_search_reset();
+  int result = vault_save_index_only();
+  if (result != VAULT_OK)
+    return result;
+  if (indexed_out)
+    *indexed_out = indexed;
+  LOGI("vault_search_index_pending: indexed %u entries", indexed);
+  return VAULT_OK;
+}
+
+static void collect_query_term(void *ctx, uint32_t term, uint32_t position) {
+  (void)position;
+  uint32_t *terms = ctx;
+  // terms[0] holds the count
+  for (uint32_t i = 1; i <= terms[0]; i++) {
+    if (terms[i] == term)
+      return;
+  }
+  if (terms[0] < SEARCH_MAX_QUERY_TERMS)
+    terms[++terms[0]] = term;
+}
+
+static const search_posting_t *find_posting(const search_slot_t *slot,
+                                            uint32_t doc) {
+  uint32_t lo = 0;
+  uint32_t hi = slot->count;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (slot->postings[mid].doc < doc)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo < slot->count && slot->postings[lo].doc == doc ? &slot->postings[lo]
+                                                           : NULL;
+}
+
+static int compare_slots_by_count(const void *a, const void *b) {
+  uint32_t ca = (*(const search_slot_t *const *)a)->count;
+  uint32_t cb = (*(const search_slot_t *const *)b)->count;
+  return ca < cb ? -1 : (ca > cb ? 1 : 0);
+}
+
+static int compare_hits(const void *a, const void *b) {
+  const search_hit_t *ha = a;
+  const search_hit_t *hb = b;
+  if (ha->score != hb->score)
+    return ha->score > hb->score ? -1 : 1;
+  if (ha->first_pos != hb->first_pos)
+    return ha->first_pos < hb->first_pos ? -1 : 1;
+  return ha->doc < hb->doc ? -1 : (ha->doc > hb->doc ? 1 : 0);
+}
+
+int vault_search_query(const char *query, uint32_t max_results,
+                       uint8_t **ids_out, uint32_t *count_out) {
+  if (!query || !ids_out || !count_out)
+    return VAULT_ERR_INVALID_PARAM;
+  *ids_out = NULL;
+  *count_out = 0;
+  if (!g_vault.is_open)
+    return VAULT_ERR_NOT_OPEN;
+  if (max_results == 0 || max_results > VAULT_SEARCH_MAX_RESULTS)
+    max_results = VAULT_SEARCH_MAX_RESULTS;
+
+  uint32_t terms[SEARCH_MAX_QUERY_TERMS + 1] = {0};
+  tokenize((const uint8_t *)query, strlen(query), collect_query_term, terms);
+  if (terms[0] == 0)
+    return VAULT_OK;
+
+  int result = ensure_built();
+  if (result != VAULT_OK)
+    return result;
+
+  const search_slot_t *slots[SEARCH_MAX_QUERY_TERMS];
+  for (uint32_t i = 0; i < terms[0]; i++) {
+    slots[i] = find_slot(terms[i + 1]);
+    if (!slots[i] || slots[i]->count == 0)
+      return VAULT_OK;
+  }
+  // Drive the intersection from the rarest term.
+  qsort(slots, terms[0], sizeof(slots[0]), compare_slots_by_count);
+
+  search_hit_t *hits = malloc(slots[0]->count * sizeof(search_hit_t));
+  if (!hits)
+    return VAULT_ERR_MEMORY;
+  uint32_t hit_count = 0;
+  for (uint32_t p = 0; p < slots[0]->count; p++) {
+    const search_posting_t *posting = &slots[0]->postings[p];
+    if (!g_search.docs[posting->doc].live)
+      continue;
+    search_hit_t hit = {posting->doc, posting->freq, posting->first_pos};
+    uint32_t t = 1;
+    for (; t < terms[0]; t++) {
+      const search_posting_t *other = find_posting(slots[t], posting->doc);
+      if (!other)
+        break;
+      hit.score = hit.score + other->freq < hit.score ? UINT32_MAX
+                                                      : hit.score + other->freq;
+      if (other->first_pos < hit.first_pos)
+        hit.first_pos = other->first_pos;
+    }
+    if (t == terms[0])
+      hits[hit_count++] = hit;
+  }
+
+  qsort(hits, hit_count, sizeof(search_hit_t), compare_hits);
+  if (hit_count > max_results)
+    hit_count = max_results;
+  if (hit_count > 0) {
+    uint8_t *ids = malloc((size_t)hit_count * VAULT_ID_LEN);
+    if (!ids) {
+      free(hits);
+      return VAULT_ERR_MEMORY;
+    }
+    for (uint32_t i = 0; i < hit_count; i++)
+      memcpy(ids + (size_t)i * VAULT_ID_LEN, g_search.docs[hits[i].doc].file_id,
+             VAULT_ID_LEN);
+    *ids_out = ids;
+    *count_out = hit_count;
+  }
+  vault_zeroize(hits, slots[0]->count * sizeof(search_hit_t));
+  free(hits);
+  return VAULT_OK;
+}
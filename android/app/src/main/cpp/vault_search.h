@@ -0,0 +1,95 @@
+/**
+ * NoLeak Vault Engine - Encrypted Full-Text Search
+ *
+ * Text entries carry their term list (hashed tokens with first position and
+ * frequency) as a VAULT_EXT_SEARCH_TERMS record inside the encrypted index.
+ * Imports tokenize blob entries up front; chunked (streamed) text entries up
+ * to 10 MB are tokenized later by vault_search_index_pending.
+ * An in-memory inverted index is derived from those records, so queries never
+ * decrypt payloads.
+ *
+ * - Tokens are runs of ASCII letters/digits or non-ASCII (UTF-8) bytes;
+ *   ASCII is case-folded
+ * - Terms are 32-bit hashes; a rare collision can add a false positive
+ * - Multi-word queries match entries containing every word, anywhere;
+ *   there are no phrase or proximity queries (no full position lists)
+ */
+
+#ifndef VAULT_SEARCH_H
+#define VAULT_SEARCH_H
+
+#include "vault_engine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Distinct terms recorded per entry; later new words are ignored
+#define VAULT_SEARCH_MAX_TERMS 4096
+#define VAULT_SEARCH_MAX_RESULTS 1000
+// Larger texts are not tokenized; matches the streaming import cutoff
+#define VAULT_SEARCH_MAX_INDEX_SIZE (10 * 1024 * 1024)
+
+/**
+ * Whether content of this MIME type is tokenized at import.
+ */
+int vault_search_is_indexable(const char *mime);
+
+/**
+ * Tokenize text and encode its term list.
+ * @param text Plaintext bytes (need not be NUL-terminated)
+ * @param len Length of text
+ * @param blob_out Receives the encoded record (caller frees)
+ * @param blob_len_out Receives its length
+ * @return VAULT_OK on success
+ */
+int vault_search_build_terms(const uint8_t *text, size_t len,
+                             uint8_t **blob_out, uint32_t *blob_len_out);
+
+/**
+ * Tokenize an entry's plaintext and attach the term record to it.
+ * @return VAULT_OK on success
+ */
+int vault_search_attach_terms(vault_entry_t *entry, const uint8_t *text,
+                              size_t len);
+
+/**
+ * Keep the inverted index in step with the live index.
+ */
+void vault_search_add_entry(const vault_entry_t *entry);
+void vault_search_remove_entry(const uint8_t file_id[VAULT_ID_LEN]);
+void vault_search_rebuild(void);
+void vault_search_reset(void);
+
+/**
+ * Tokenize and attach terms to indexable entries that have none (imported
+ * before search existed, or streamed in chunks), then commit the index once.
+ * A pass walks the entries in order across calls; entries that cannot be
+ * read are skipped rather than retried.
+ * @param start Entry position to resume from (0 starts a pass)
+ * @param max_files Upper bound on entries decrypted by this call
+ * @param next_out Receives the position to resume from; the entry count
+ *   once the pass is complete
+ * @param indexed_out Receives the number of entries indexed (may be NULL)
+ * @return VAULT_OK on success
+ */
+int vault_search_index_pending(uint32_t start, uint32_t max_files,
+                               uint32_t *next_out, uint32_t *indexed_out);
+
+/**
+ * Find entries containing every word of the query.
+ * Results are ordered by total term frequency, then earliest occurrence.
+ * @param query UTF-8 query text
+ * @param max_results Maximum number of IDs returned
+ * @param ids_out Receives packed file IDs (count * VAULT_ID_LEN, caller frees)
+ * @param count_out Receives the number of IDs
+ * @return VAULT_OK on success
+ */
+int vault_search_query(const char *query, uint32_t max_results,
+                       uint8_t **ids_out, uint32_t *count_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VAULT_SEARCH_H
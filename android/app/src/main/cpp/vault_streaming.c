@@ -6,6 +6,7 @@
  */
 
 #include "vault_streaming.h"
+#include "vault_governor.h"
 #include <android/log.h>
 #include <dirent.h>
 #include <errno.h>
@@ -45,6 +46,8 @@ static streaming_import_state_t *g_active_imports[MAX_ACTIVE_IMPORTS] = {0};
 static streaming_progress_callback_t g_progress_callbacks[MAX_ACTIVE_IMPORTS] =
     {0};
 static void *g_progress_user_data[MAX_ACTIVE_IMPORTS] = {0};
+// Chunk writes are paced per slot to the governor's bulk I/O rate
+static vault_pace_t g_import_pace[MAX_ACTIVE_IMPORTS];
 
 // Pending imports directory path
 static char *g_pending_dir = NULL;
@@ -239,6 +242,28 @@ static int save_state(const streaming_import_state_t *state) {
   return STREAMING_OK;
 }
 
+// Flush chunk files written since the last checkpoint
+static int sync_chunks(streaming_import_state_t *state) {
+  while (state->synced_chunks < state->completed_chunks) {
+    char *chunk_path = get_chunk_path(state->import_id, state->synced_chunks);
+    if (!chunk_path) {
+      return STREAMING_ERR_MEMORY;
+    }
+    int fd = open(chunk_path, O_RDONLY);
+    free(chunk_path);
+    if (fd < 0) {
+      return STREAMING_ERR_IO;
+    }
+    int rc = fsync(fd);
+    close(fd);
+    if (rc != 0) {
+      return STREAMING_ERR_IO;
+    }
+    state->synced_chunks++;
+  }
+  return STREAMING_OK;
+}
+
 // Load state from disk
 static int load_state(const uint8_t import_id[VAULT_ID_LEN],
                       streaming_import_state_t *state) {
@@ -370,6 +395,8 @@ static int load_state(const uint8_t import_id[VAULT_ID_LEN],
 
   // Set pending dir
   state->pending_dir = get_import_dir(import_id);
+  // Persisted progress only ever covers synced chunks
+  state->synced_chunks = state->completed_chunks;
   if (!state->file_name) {
     state->file_name = strdup("imported");
   }
@@ -778,8 +805,9 @@ int streaming_write_chunk(const uint8_t import_id[VAULT_ID_LEN],
     return STREAMING_ERR_IO;
   }
 
+  // Not fsynced here: chunk files are flushed in batches at the next
+  // checkpoint so the caller can read ahead while the device writes back
   ssize_t written = write(fd, ciphertext, VAULT_NONCE_LEN + ct_len);
-  fsync(fd);
   close(fd);
 
   vault_zeroize(ciphertext, VAULT_NONCE_LEN + ct_len);
@@ -788,15 +816,28 @@ int streaming_write_chunk(const uint8_t import_id[VAULT_ID_LEN],
   if (written != (ssize_t)(VAULT_NONCE_LEN + ct_len)) {
     return STREAMING_ERR_IO;
   }
+  vault_governor_pace(&g_import_pace[slot], (uint64_t)written);
 
   // Update state
   state->completed_chunks = chunk_index + 1;
   state->bytes_written = chunk_offset + len;
   state->updated_at = get_timestamp_ms();
 
-  // Save state periodically (every 10 chunks or on last chunk)
+  // Save state periodically (every 10 chunks or on last chunk). The state
+  // only advances once every chunk it covers is durable.
   if (chunk_index % 10 == 9 || state->completed_chunks == state->total_chunks) {
-    save_state(state);
+    result = sync_chunks(state);
+    if (result != STREAMING_OK) {
+      // Resume from the last durable chunk; the caller rewrites the rest
+      LOGE("Chunk flush failed at %u/%u", state->synced_chunks,
+           state->total_chunks);
+      state->completed_chunks = state->synced_chunks;
+      state->bytes_written = (uint64_t)state->synced_chunks * state->chunk_size;
+      return result;
+    }
+    result = save_state(state);
+    if (result != STREAMING_OK)
+      return result;
   }
 
   // Call progress callback
@@ -811,6 +852,107 @@ int streaming_write_chunk(const uint8_t import_id[VAULT_ID_LEN],
   return STREAMING_OK;
 }
 
+int streaming_verify_chunk(const uint8_t import_id[VAULT_ID_LEN],
+                           uint32_t chunk_index, const uint8_t *plaintext,
+                           size_t len) {
+  if (!g_vault.is_open)
+    return STREAMING_ERR_VAULT_NOT_OPEN;
+  if (!import_id || !plaintext || len == 0)
+    return STREAMING_ERR_INVALID_PARAM;
+
+  streaming_import_state_t state;
+  memset(&state, 0, sizeof(state));
+  int result = streaming_get_state(import_id, &state);
+  if (result != STREAMING_OK)
+    return result;
+
+  uint8_t dek[VAULT_KEY_LEN];
+  uint8_t *ciphertext = NULL;
+  uint8_t *decrypted = NULL;
+  size_t ct_len = len + VAULT_TAG_LEN;
+  char *chunk_path = NULL;
+  int fd = -1;
+
+  size_t expected_len = 0;
+  if (chunk_index >= state.completed_chunks ||
+      !streaming_chunk_plaintext_len(state.file_size, state.chunk_size,
+                                     chunk_index, &expected_len)) {
+    result = STREAMING_ERR_INVALID_PARAM;
+    goto cleanup;
+  }
+  if (len != expected_len) {
+    result = STREAMING_ERR_SOURCE_CHANGED;
+    goto cleanup;
+  }
+
+  chunk_path = get_chunk_path(import_id, chunk_index);
+  ciphertext = malloc(VAULT_NONCE_LEN + ct_len);
+  decrypted = malloc(len);
+  if (!chunk_path || !ciphertext || !decrypted) {
+    result = STREAMING_ERR_MEMORY;
+    goto cleanup;
+  }
+  fd = open(chunk_path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0 || read(fd, ciphertext, VAULT_NONCE_LEN + ct_len) !=
+                    (ssize_t)(VAULT_NONCE_LEN + ct_len)) {
+    result = STREAMING_ERR_CHUNK_CORRUPTED;
+    goto cleanup;
+  }
+
+  result = unwrap_dek(&state, dek);
+  if (result != VAULT_OK) {
+    result = STREAMING_ERR_CRYPTO;
+    goto cleanup;
+  }
+  vault_aad_t aad = {0};
+  memcpy(aad.vault_id, g_vault.vault_id, VAULT_ID_LEN);
+  memcpy(aad.file_id, state.file_id, VAULT_ID_LEN);
+  aad.chunk_index = chunk_index;
+  aad.format_version = VAULT_VERSION;
+
+  size_t pt_len = 0;
+  result = vault_aead_decrypt(dek, ciphertext, (uint8_t *)&aad, sizeof(aad),
+                              ciphertext + VAULT_NONCE_LEN, ct_len, decrypted,
+                              &pt_len);
+  vault_zeroize(dek, VAULT_KEY_LEN);
+  if (result != VAULT_OK || pt_len != len) {
+    result = STREAMING_ERR_CHUNK_CORRUPTED;
+    goto cleanup;
+  }
+  result = sodium_memcmp(decrypted, plaintext, len) == 0
+               ? STREAMING_OK
+               : STREAMING_ERR_SOURCE_CHANGED;
+
+cleanup:
+  if (fd >= 0)
+    close(fd);
+  free(chunk_path);
+  if (ciphertext) {
+    vault_zeroize(ciphertext, VAULT_NONCE_LEN + ct_len);
+    free(ciphertext);
+  }
+  if (decrypted) {
+    vault_zeroize(decrypted, len);
+    free(decrypted);
+  }
+  streaming_free_state(&state);
+  if (result != STREAMING_OK)
+    LOGE("Verify chunk %u failed: %d", chunk_index, result);
+  return result;
+}
+
+int streaming_set_media_info(const uint8_t import_id[VAULT_ID_LEN],
+                             const vault_media_info_t *info) {
+  if (!import_id || !info)
+    return STREAMING_ERR_INVALID_PARAM;
+  int slot = find_active_slot(import_id);
+  if (slot < 0)
+    return STREAMING_ERR_NOT_FOUND;
+  g_active_imports[slot]->media_info = *info;
+  g_active_imports[slot]->has_media_info = 1;
+  return STREAMING_OK;
+}
+
 int streaming_finish(const uint8_t import_id[VAULT_ID_LEN],
                      uint8_t file_id_out[VAULT_ID_LEN]) {
   LOGD("streaming_finish: START");
@@ -974,6 +1116,10 @@ int streaming_finish(const uint8_t import_id[VAULT_ID_LEN],
     return result;
   }
 
+  if (state->has_media_info &&
+      vault_entry_set_media_info(&new_entry, &state->media_info) != VAULT_OK)
+    LOGE("streaming_finish: media info dropped");
+
   LOGI("streaming_finish: committing chunks with bounded memory");
   result = vault_append_entry_from_chunk_dir(&new_entry, state->pending_dir);
   vault_free_entry(&new_entry);
@@ -1029,7 +1175,24 @@ int streaming_abort(const uint8_t import_id[VAULT_ID_LEN]) {
   if (!import_dir)
     return STREAMING_ERR_MEMORY;
 
-  // Securely delete all files in directory
+  // Crypto-shred: the state file holds the only wrapped copy of an aborted
+  // import's DEK, so wiping it leaves the chunk ciphertext unreadable. After
+  // a successful finish the same ciphertext is already in the vault. The
+  // chunks are therefore unlinked without a content overwrite.
+  char *state_path = get_state_path(import_id);
+  if (!state_path) {
+    free(import_dir);
+    return STREAMING_ERR_MEMORY;
+  }
+  vault_secure_wipe_file(state_path);
+  unlink(state_path);
+  free(state_path);
+  int dir_fd = open(import_dir, O_RDONLY | O_DIRECTORY);
+  if (dir_fd >= 0) {
+    fsync(dir_fd);
+    close(dir_fd);
+  }
+
   DIR *dir = opendir(import_dir);
   if (dir) {
     struct dirent *entry;
@@ -1044,9 +1207,6 @@ int streaming_abort(const uint8_t import_id[VAULT_ID_LEN]) {
       char *file_path = malloc(path_len);
       if (file_path) {
         snprintf(file_path, path_len, "%s/%s", import_dir, entry->d_name);
-
-        // Secure wipe before delete
-        vault_secure_wipe_file(file_path);
         unlink(file_path);
         free(file_path);
       }
@@ -64,6 +64,9 @@ typedef struct {
     // Runtime state (not persisted)
     int is_active;                         // Currently being processed
     char* pending_dir;                     // Directory for pending chunks
+    uint32_t synced_chunks;                // Chunks fsynced at the last checkpoint
+    int has_media_info;                    // media_info set by caller
+    vault_media_info_t media_info;         // Stored with the entry on finish
 } streaming_import_state_t;
 
 // Streaming import result codes
@@ -138,6 +141,36 @@ int streaming_write_chunk(
     uint32_t chunk_index
 );
 
+/**
+ * Check that an already-written chunk matches the given source bytes, so a
+ * resume can confirm the source is unchanged at the resume point
+ *
+ * @param import_id Import session ID
+ * @param chunk_index Chunk index (must be below completed_chunks)
+ * @param plaintext Source bytes for that chunk
+ * @param len Length of plaintext
+ * @return STREAMING_OK if identical, STREAMING_ERR_SOURCE_CHANGED if not
+ */
+int streaming_verify_chunk(
+    const uint8_t import_id[VAULT_ID_LEN],
+    uint32_t chunk_index,
+    const uint8_t* plaintext,
+    size_t len
+);
+
+/**
+ * Attach media metadata to an active import; stored in the entry's
+ * encrypted index record by streaming_finish
+ *
+ * @param import_id Import session ID
+ * @param info Probed metadata
+ * @return STREAMING_OK on success, STREAMING_ERR_NOT_FOUND if not active
+ */
+int streaming_set_media_info(
+    const uint8_t import_id[VAULT_ID_LEN],
+    const vault_media_info_t* info
+);
+
 /**
  * Finalize streaming import
  * Combines chunks into vault container, updates index
@@ -153,7 +186,7 @@ int streaming_finish(
 
 /**
  * Abort streaming import and cleanup
- * Securely deletes all pending chunks and state
+ * Wipes the state file (the wrapped DEK), then unlinks the pending chunks
  * 
  * @param import_id Import session ID
  * @return STREAMING_OK on success
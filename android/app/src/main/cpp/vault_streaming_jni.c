@@ -57,6 +57,11 @@ static char* jstring_to_cstring(JNIEnv* env, jstring str) {
     return result;
 }
 
+// Shared with vault_jni.c
+extern int vault_media_info_from_java(JNIEnv* env, jlongArray values,
+                                      jstring videoCodec, jstring audioCodec,
+                                      vault_media_info_t* info);
+
 
 // ============================================================================
 // Streaming JNI Functions
@@ -184,6 +189,42 @@ Java_com_noleak_noleak_vault_VaultEngine_nativeStreamingWriteChunk(
     return result;
 }
 
+JNIEXPORT jint JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeStreamingVerifyChunk(
+    JNIEnv* env, jclass clazz,
+    jbyteArray importId,
+    jint chunkIndex,
+    jbyteArray plaintext,
+    jint length
+) {
+    UNUSED(clazz);
+    
+    if (!plaintext || chunkIndex < 0 || length <= 0 ||
+        (*env)->GetArrayLength(env, plaintext) < length) {
+        return STREAMING_ERR_INVALID_PARAM;
+    }
+    size_t id_len;
+    uint8_t* c_id = jbytearray_to_uint8(env, importId, &id_len);
+    if (!c_id || id_len != VAULT_ID_LEN) {
+        if (c_id) free(c_id);
+        return STREAMING_ERR_INVALID_PARAM;
+    }
+    uint8_t* c_pt = malloc((size_t)length);
+    if (!c_pt) {
+        free(c_id);
+        return STREAMING_ERR_MEMORY;
+    }
+    (*env)->GetByteArrayRegion(env, plaintext, 0, length, (jbyte*)c_pt);
+    
+    int result = streaming_verify_chunk(c_id, (uint32_t)chunkIndex, c_pt, (size_t)length);
+    
+    free(c_id);
+    vault_zeroize(c_pt, (size_t)length);
+    free(c_pt);
+    
+    return result;
+}
+
 JNIEXPORT jbyteArray JNICALL
 Java_com_noleak_noleak_vault_VaultEngine_nativeStreamingFinish(
     JNIEnv* env, jclass clazz,
@@ -212,6 +253,32 @@ Java_com_noleak_noleak_vault_VaultEngine_nativeStreamingFinish(
     return uint8_to_jbytearray(env, file_id, VAULT_ID_LEN);
 }
 
+JNIEXPORT jint JNICALL
+Java_com_noleak_noleak_vault_VaultEngine_nativeStreamingSetMediaInfo(
+    JNIEnv* env, jclass clazz,
+    jbyteArray importId,
+    jlongArray values,
+    jstring videoCodec,
+    jstring audioCodec
+) {
+    UNUSED(clazz);
+    
+    vault_media_info_t info;
+    if (!vault_media_info_from_java(env, values, videoCodec, audioCodec, &info)) {
+        return STREAMING_ERR_INVALID_PARAM;
+    }
+    size_t id_len;
+    uint8_t* c_id = jbytearray_to_uint8(env, importId, &id_len);
+    if (!c_id || id_len != VAULT_ID_LEN) {
+        if (c_id) free(c_id);
+        return STREAMING_ERR_INVALID_PARAM;
+    }
+    
+    int result = streaming_set_media_info(c_id, &info);
+    free(c_id);
+    return result;
+}
+
 JNIEXPORT jint JNICALL
 Java_com_noleak_noleak_vault_VaultEngine_nativeStreamingAbort(
     JNIEnv* env, jclass clazz,
@@ -359,8 +426,12 @@ static JNINativeMethod gStreamingMethods[] = {
         (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeStreamingStart},
     {"nativeStreamingWriteChunk", "([B[BI)I", 
         (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeStreamingWriteChunk},
+    {"nativeStreamingVerifyChunk", "([BI[BI)I", 
+        (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeStreamingVerifyChunk},
     {"nativeStreamingFinish", "([B)[B", 
         (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeStreamingFinish},
+    {"nativeStreamingSetMediaInfo", "([B[JLjava/lang/String;Ljava/lang/String;)I", 
+        (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeStreamingSetMediaInfo},
     {"nativeStreamingAbort", "([B)I", 
         (void*)Java_com_noleak_noleak_vault_VaultEngine_nativeStreamingAbort},
     {"nativeStreamingGetState", "([B)Lcom/noleak/noleak/vault/StreamingImportState;", 
@@ -0,0 +1,753 @@
+/**
+ * NoLeak Vault Engine - Tiered Chunk Placement Implementation
+ *
+ * Segment file: VAULT_TIER_SEGMENT_MAGIC, vault_id, then chunk ciphertext
+ * appended by migrations. Ciphertext is copied verbatim, so nothing in the
+ * segment is readable without the entry's DEK and the nonce in the index.
+ *
+ * Tier record layout (VAULT_EXT_TIER):
+ *   version (1 byte), then one bit per chunk (LSB first), set = cold
+ * Access record layout (VAULT_EXT_ACCESS):
+ *   version (1 byte), last access in ms since the epoch (u64)
+ *
+ * A migration copies chunks to the segment tail, flushes it, then commits
+ * the index. A crash before the commit leaves only an unreferenced segment
+ * tail; the container still points at the internal copies.
+ *
+ * Compaction packs the live chunks against the header in two commits, each
+ * writing only where the committed index places nothing: live chunks in
+ * the target range are first copied to the tail, then every live chunk is
+ * copied into the range, which is dead by then. A crash between the steps
+ * leaves a valid index; the next trim drops the tail.
+ */
+
+#include "vault_tier.h"
+#include <android/log.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define LOG_TAG "VaultTier"
+
+#ifdef NDEBUG
+#define LOGI(...) ((void)0)
+#define LOGE(...) ((void)0)
+#else
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#endif
+
+#define TIER_RECORD_VERSION 1
+#define ACCESS_RECORD_VERSION 1
+#define ACCESS_RECORD_LEN (1 + sizeof(uint64_t))
+#define TIER_SEGMENT_HEADER_LEN (VAULT_TIER_SEGMENT_MAGIC_LEN + VAULT_ID_LEN)
+#define TIER_COPY_BUFFER (1024 * 1024)
+#define TIER_MS_PER_DAY (24ULL * 60 * 60 * 1000)
+// Compaction copies up to twice the live bytes, so it waits until at least
+// that much is dead, and for this much at least
+#ifndef TIER_COMPACT_MIN_DEAD
+#define TIER_COMPACT_MIN_DEAD (64ULL * 1024 * 1024)
+#endif
+
+extern vault_state_t g_vault;
+extern int clone_entries(const vault_entry_t *source, uint32_t count,
+                         vault_entry_t **dest_out);
+extern void free_entries_array(vault_entry_t *entries, uint32_t count);
+extern void vault_stats_rebuild(void);
+extern int vault_container_is_log(void);
+extern int read_all_at(int fd, void *buffer, size_t len, uint64_t offset);
+extern int write_all_at(int fd, const void *buffer, size_t len,
+                        uint64_t offset);
+
+// Open-addressing slot; at == 0 marks an empty slot
+typedef struct {
+  uint8_t file_id[VAULT_ID_LEN];
+  uint64_t at;
+} tier_access_t;
+
+typedef struct {
+  uint32_t index;
+  uint64_t last_access;
+} tier_candidate_t;
+
+// Reads may come from player threads, so access times have their own lock.
+// They are kept in a hash table keyed by file ID (random, so its leading
+// bytes are a good hash); the capacity is a power of two.
+static pthread_mutex_t g_access_lock = PTHREAD_MUTEX_INITIALIZER;
+static tier_access_t *g_access = NULL;
+static uint32_t g_access_count = 0;
+static uint32_t g_access_cap = 0;
+
+static char *g_segment_path = NULL;
+
+static uint64_t get_timestamp_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// Write the header of a new segment or check that an existing one belongs
+// to the open vault.
+static int tier_prepare_segment(int fd) {
+  uint8_t header[TIER_SEGMENT_HEADER_LEN];
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+    return VAULT_ERR_IO;
+  if (st.st_size == 0) {
+    memcpy(header, VAULT_TIER_SEGMENT_MAGIC, VAULT_TIER_SEGMENT_MAGIC_LEN);
+    memcpy(header + VAULT_TIER_SEGMENT_MAGIC_LEN, g_vault.vault_id,
+           VAULT_ID_LEN);
+    if (write_all_at(fd, header, sizeof(header), 0) != VAULT_OK ||
+        fsync(fd) != 0)
+      return VAULT_ERR_IO;
+    return VAULT_OK;
+  }
+  if (st.st_size < (off_t)sizeof(header) ||
+      read_all_at(fd, header, sizeof(header), 0) != VAULT_OK)
+    return VAULT_ERR_CORRUPTED;
+  if (memcmp(header, VAULT_TIER_SEGMENT_MAGIC, VAULT_TIER_SEGMENT_MAGIC_LEN) !=
+          0 ||
+      memcmp(header + VAULT_TIER_SEGMENT_MAGIC_LEN, g_vault.vault_id,
+             VAULT_ID_LEN) != 0)
+    return VAULT_ERR_CORRUPTED;
+  return VAULT_OK;
+}
+
+// Trim the segment to the end of the last chunk the committed index still
+// places there, and remove it once nothing does. Holes left by deleted or
+// recalled files in the middle wait for tier_compact_segment.
+static void tier_reclaim_segment(void) {
+  if (!g_segment_path)
+    return;
+  uint64_t end = 0;
+  for (uint32_t i = 0; i < g_vault.entry_count; i++) {
+    const vault_entry_t *entry = &g_vault.entries[i];
+    for (uint32_t c = 0; c < entry->chunk_count; c++) {
+      if (!vault_tier_chunk_is_cold(entry, c))
+        continue;
+      uint64_t chunk_end = entry->chunks[c].offset + entry->chunks[c].length;
+      if (chunk_end > end)
+        end = chunk_end;
+    }
+  }
+  if (end == 0) {
+    if (unlink(g_segment_path) != 0 && errno != ENOENT)
+      LOGE("tier_reclaim_segment: failed to remove empty segment");
+    return;
+  }
+  int fd = open(g_segment_path, O_RDWR | O_CLOEXEC);
+  if (fd < 0)
+    return;
+  struct stat st;
+  if (fstat(fd, &st) == 0 && (uint64_t)st.st_size > end) {
+    if (ftruncate(fd, (off_t)end) != 0)
+      LOGE("tier_reclaim_segment: failed to trim segment");
+    else
+      LOGI("tier_reclaim_segment: reclaimed %llu bytes",
+           (unsigned long long)((uint64_t)st.st_size - end));
+  }
+  close(fd);
+}
+
+// Copy every cold chunk that starts below `below` to *next onwards, then
+// flush and commit the new offsets.
+static int tier_relocate_chunks(int fd, uint8_t *buffer, uint64_t below,
+                                uint64_t *next) {
+  vault_entry_t *entries = NULL;
+  uint32_t entry_count = g_vault.entry_count;
+  int result = clone_entries(g_vault.entries, entry_count, &entries);
+  if (result != VAULT_OK)
+    return result;
+
+  uint32_t relocated = 0;
+  for (uint32_t i = 0; i < entry_count && result == VAULT_OK; i++) {
+    vault_entry_t *entry = &entries[i];
+    for (uint32_t c = 0; c < entry->chunk_count; c++) {
+      if (!vault_tier_chunk_is_cold(entry, c) ||
+          entry->chunks[c].offset >= below)
+        continue;
+      uint64_t source = entry->chunks[c].offset;
+      uint64_t destination = *next;
+      uint64_t remaining = entry->chunks[c].length;
+      while (remaining > 0 && result == VAULT_OK) {
+        size_t n = remaining > TIER_COPY_BUFFER ? TIER_COPY_BUFFER
+                                                : (size_t)remaining;
+        result = read_all_at(fd, buffer, n, source);
+        if (result == VAULT_OK)
+          result = write_all_at(fd, buffer, n, destination);
+        source += n;
+        destination += n;
+        remaining -= n;
+      }
+      if (result != VAULT_OK)
+        break;
+      entry->chunks[c].offset = *next;
+      *next += entry->chunks[c].length;
+      relocated++;
+    }
+  }
+  if (result == VAULT_OK && relocated > 0 && fsync(fd) != 0)
+    result = VAULT_ERR_IO;
+  if (result != VAULT_OK || relocated == 0) {
+    free_entries_array(entries, entry_count);
+    return result;
+  }
+
+  vault_entry_t *old_entries = g_vault.entries;
+  g_vault.entries = entries;
+  vault_stats_rebuild();
+  result = vault_save_index_only();
+  if (result != VAULT_OK) {
+    g_vault.entries = old_entries;
+    vault_stats_rebuild();
+    free_entries_array(entries, entry_count);
+    return result;
+  }
+  free_entries_array(old_entries, entry_count);
+  return VAULT_OK;
+}
+
+// Pack the live chunks against the header once enough of the segment is
+// dead (see the file comment); tier_reclaim_segment then trims the rest.
+static int tier_compact_segment(void) {
+  if (!g_segment_path)
+    return VAULT_OK;
+  uint64_t live = 0;
+  for (uint32_t i = 0; i < g_vault.entry_count; i++) {
+    const vault_entry_t *entry = &g_vault.entries[i];
+    for (uint32_t c = 0; c < entry->chunk_count; c++) {
+      if (vault_tier_chunk_is_cold(entry, c))
+        live += entry->chunks[c].length;
+    }
+  }
+  struct stat st;
+  if (live == 0 || stat(g_segment_path, &st) != 0 ||
+      (uint64_t)st.st_size < TIER_SEGMENT_HEADER_LEN + live)
+    return VAULT_OK;
+  uint64_t dead = (uint64_t)st.st_size - TIER_SEGMENT_HEADER_LEN - live;
+  if (dead < live || dead < TIER_COMPACT_MIN_DEAD)
+    return VAULT_OK;
+
+  int fd = open(g_segment_path, O_RDWR | O_CLOEXEC);
+  if (fd < 0)
+    return VAULT_ERR_IO;
+  uint8_t *buffer = malloc(TIER_COPY_BUFFER);
+  if (!buffer) {
+    close(fd);
+    return VAULT_ERR_MEMORY;
+  }
+  uint64_t packed_end = TIER_SEGMENT_HEADER_LEN + live;
+  uint64_t tail = (uint64_t)st.st_size;
+  int result = tier_relocate_chunks(fd, buffer, packed_end, &tail);
+  uint64_t next = TIER_SEGMENT_HEADER_LEN;
+  if (result == VAULT_OK)
+    result = tier_relocate_chunks(fd, buffer, UINT64_MAX, &next);
+  if (result == VAULT_OK)
+    LOGI("tier_compact_segment: packed %llu live bytes",
+         (unsigned long long)live);
+  vault_zeroize(buffer, TIER_COPY_BUFFER);
+  free(buffer);
+  close(fd);
+  return result;
+}
+
+int vault_tier_set_cold_dir(const char *dir) {
+  if (!g_vault.is_open)
+    return VAULT_ERR_NOT_OPEN;
+
+  free(g_segment_path);
+  g_segment_path = NULL;
+  if (!dir || dir[0] == '\0')
+    return VAULT_OK;
+
+  // One segment per vault, named after the vault ID
+  static const char hex_chars[] = "0123456789abcdef";
+  char hex[VAULT_ID_LEN * 2 + 1];
+  for (int i = 0; i < VAULT_ID_LEN; i++) {
+    hex[i * 2] = hex_chars[(g_vault.vault_id[i] >> 4) & 0xF];
+    hex[i * 2 + 1] = hex_chars[g_vault.vault_id[i] & 0xF];
+  }
+  hex[VAULT_ID_LEN * 2] = '\0';
+
+  size_t path_len = strlen(dir) + sizeof(hex) + 8;
+  char *path = malloc(path_len);
+  if (!path)
+    return VAULT_ERR_MEMORY;
+  snprintf(path, path_len, "%s/%s.seg", dir, hex);
+
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd >= 0) {
+    struct stat st;
+    int result = fstat(fd, &st) == 0 && st.st_size > 0
+                     ? tier_prepare_segment(fd)
+                     : VAULT_OK;
+    close(fd);
+    if (result != VAULT_OK) {
+      LOGE("vault_tier_set_cold_dir: segment does not belong to this vault");
+      free(path);
+      return result;
+    }
+  }
+  g_segment_path = path;
+  tier_reclaim_segment();
+  return VAULT_OK;
+}
+
+int vault_tier_chunk_is_cold(const vault_entry_t *entry, uint32_t chunk_index) {
+  if (!entry || chunk_index >= entry->chunk_count)
+    return 0;
+  const uint8_t *record;
+  uint32_t len;
+  if (!vault_entry_ext_find(entry, VAULT_EXT_TIER, &record, &len) || len < 1 ||
+      record[0] != TIER_RECORD_VERSION)
+    return 0;
+  uint32_t byte = 1 + chunk_index / 8;
+  if (byte >= len)
+    return 0;
+  return (record[byte] >> (chunk_index % 8)) & 1;
+}
+
+int vault_tier_open_chunk(const vault_entry_t *entry, uint32_t chunk_index) {
+  if (vault_tier_chunk_is_cold(entry, chunk_index)) {
+    if (!g_segment_path) {
+      LOGE("vault_tier_open_chunk: cold storage is not available");
+      return -1;
+    }
+    return open(g_segment_path, O_RDONLY | O_CLOEXEC);
+  }
+  return open(g_vault.path, O_RDONLY | O_CLOEXEC);
+}
+
+int vault_tier_mark_internal(vault_entry_t *entry, uint32_t first,
+                             uint32_t count) {
+  const uint8_t *record;
+  uint32_t len;
+  if (!entry ||
+      !vault_entry_ext_find(entry, VAULT_EXT_TIER, &record, &len) || len < 1)
+    return VAULT_OK;
+
+  uint8_t *bitmap = malloc(len);
+  if (!bitmap)
+    return VAULT_ERR_MEMORY;
+  memcpy(bitmap, record, len);
+  uint64_t limit = (uint64_t)(len - 1) * 8;
+  for (uint64_t c = first; c < (uint64_t)first + count && c < limit; c++)
+    bitmap[1 + c / 8] &= (uint8_t)~(1u << (c % 8));
+
+  int any_cold = 0;
+  for (uint32_t i = 1; i < len; i++)
+    any_cold |= bitmap[i];
+  int result = vault_entry_ext_set(entry, VAULT_EXT_TIER,
+                                   any_cold ? bitmap : NULL,
+                                   any_cold ? len : 0);
+  free(bitmap);
+  return result;
+}
+
+static uint32_t access_hash(const uint8_t file_id[VAULT_ID_LEN]) {
+  uint32_t hash;
+  memcpy(&hash, file_id, sizeof(hash));
+  return hash;
+}
+
+// Slot holding file_id, or the empty slot where it belongs.
+// Caller holds g_access_lock and g_access_cap > 0.
+static tier_access_t *access_slot(const uint8_t file_id[VAULT_ID_LEN]) {
+  uint32_t mask = g_access_cap - 1;
+  for (uint32_t i = access_hash(file_id) & mask;; i = (i + 1) & mask) {
+    tier_access_t *slot = &g_access[i];
+    if (slot->at == 0 || memcmp(slot->file_id, file_id, VAULT_ID_LEN) == 0)
+      return slot;
+  }
+}
+
+static int access_grow(void) {
+  uint32_t cap = g_access_cap ? g_access_cap * 2 : 64;
+  tier_access_t *table = calloc(cap, sizeof(tier_access_t));
+  if (!table)
+    return VAULT_ERR_MEMORY;
+  tier_access_t *old = g_access;
+  uint32_t old_cap = g_access_cap;
+  g_access = table;
+  g_access_cap = cap;
+  for (uint32_t i = 0; i < old_cap; i++) {
+    if (old[i].at != 0)
+      *access_slot(old[i].file_id) = old[i];
+  }
+  free(old);
+  return VAULT_OK;
+}
+
+void vault_tier_note_access(const uint8_t file_id[VAULT_ID_LEN]) {
+  if (!file_id)
+    return;
+  uint64_t now = get_timestamp_ms();
+  pthread_mutex_lock(&g_access_lock);
+  // Keep the load factor at or below 3/4
+  if ((g_access_count + 1) * 4 > g_access_cap * 3 &&
+      access_grow() != VAULT_OK) {
+    // Losing an access time only makes a file look colder than it is
+    pthread_mutex_unlock(&g_access_lock);
+    return;
+  }
+  tier_access_t *slot = access_slot(file_id);
+  if (slot->at == 0) {
+    memcpy(slot->file_id, file_id, VAULT_ID_LEN);
+    g_access_count++;
+  }
+  slot->at = now;
+  pthread_mutex_unlock(&g_access_lock);
+}
+
+void vault_tier_forget_access(const uint8_t file_id[VAULT_ID_LEN]) {
+  if (!file_id)
+    return;
+  pthread_mutex_lock(&g_access_lock);
+  if (g_access_count > 0) {
+    tier_access_t *slot = access_slot(file_id);
+    if (slot->at != 0) {
+      // Backward-shift deletion: pull later slots of the same probe run into
+      // the hole so every remaining ID is still found before an empty slot
+      uint32_t mask = g_access_cap - 1;
+      uint32_t hole = (uint32_t)(slot - g_access);
+      for (uint32_t i = (hole + 1) & mask; g_access[i].at != 0;
+           i = (i + 1) & mask) {
+        uint32_t home = access_hash(g_access[i].file_id) & mask;
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+          g_access[hole] = g_access[i];
+          hole = i;
+        }
+      }
+      memset(&g_access[hole], 0, sizeof(g_access[hole]));
+      g_access_count--;
+    }
+  }
+  pthread_mutex_unlock(&g_access_lock);
+}
+
+static uint64_t entry_last_access(const vault_entry_t *entry) {
+  const uint8_t *record;
+  uint32_t len;
+  uint64_t at = entry->created_at;
+  if (vault_entry_ext_find(entry, VAULT_EXT_ACCESS, &record, &len) &&
+      len >= ACCESS_RECORD_LEN && record[0] == ACCESS_RECORD_VERSION) {
+    uint64_t stored;
+    memcpy(&stored, record + 1, sizeof(stored));
+    if (stored > at)
+      at = stored;
+  }
+  return at;
+}
+
+uint64_t vault_tier_last_access(const vault_entry_t *entry) {
+  if (!entry)
+    return 0;
+  uint64_t at = entry_last_access(entry);
+  pthread_mutex_lock(&g_access_lock);
+  if (g_access_count > 0) {
+    const tier_access_t *slot = access_slot(entry->file_id);
+    if (slot->at > at)
+      at = slot->at;
+  }
+  pthread_mutex_unlock(&g_access_lock);
+  return at;
+}
+
+// Attach in-memory access times to their entries. Like search terms these
+// are derived data: the next successful commit persists them.
+static void tier_fold_access(void) {
+  pthread_mutex_lock(&g_access_lock);
+  for (uint32_t i = 0; i < g_vault.entry_count && g_access_count > 0; i++) {
+    vault_entry_t *entry = &g_vault.entries[i];
+    const tier_access_t *slot = access_slot(entry->file_id);
+    if (slot->at > entry_last_access(entry)) {
+      uint8_t record[ACCESS_RECORD_LEN];
+      record[0] = ACCESS_RECORD_VERSION;
+      memcpy(record + 1, &slot->at, sizeof(uint64_t));
+      vault_entry_ext_set(entry, VAULT_EXT_ACCESS, record, sizeof(record));
+    }
+  }
+  if (g_access)
+    memset(g_access, 0, g_access_cap * sizeof(tier_access_t));
+  g_access_count = 0;
+  pthread_mutex_unlock(&g_access_lock);
+}
+
+static int compare_candidates(const void *a, const void *b) {
+  const tier_candidate_t *x = a;
+  const tier_candidate_t *y = b;
+  if (x->last_access != y->last_access)
+    return x->last_access < y->last_access ? -1 : 1;
+  return x->index < y->index ? -1 : (x->index > y->index);
+}
+
+static int entry_has_internal_chunks(const vault_entry_t *entry) {
+  for (uint32_t c = 0; c < entry->chunk_count; c++) {
+    if (!vault_tier_chunk_is_cold(entry, c))
+      return 1;
+  }
+  return 0;
+}
+
+// Copy an entry's internal chunks to the segment tail and mark them cold.
+static int tier_move_entry(vault_entry_t *entry, int vault_fd, int segment_fd,
+                           uint64_t *segment_end, uint8_t *buffer,
+                           uint64_t *moved) {
+  uint32_t bitmap_len = 1 + (entry->chunk_count + 7) / 8;
+  uint8_t *bitmap = calloc(bitmap_len, 1);
+  if (!bitmap)
+    return VAULT_ERR_MEMORY;
+  bitmap[0] = TIER_RECORD_VERSION;
+
+  int result = VAULT_OK;
+  for (uint32_t c = 0; c < entry->chunk_count; c++) {
+    if (vault_tier_chunk_is_cold(entry, c)) {
+      bitmap[1 + c / 8] |= (uint8_t)(1u << (c % 8));
+      continue;
+    }
+    uint64_t source = entry->chunks[c].offset;
+    uint64_t remaining = entry->chunks[c].length;
+    uint64_t destination = *segment_end;
+    while (remaining > 0 && result == VAULT_OK) {
+      size_t n = remaining > TIER_COPY_BUFFER ? TIER_COPY_BUFFER
+                                              : (size_t)remaining;
+      result = read_all_at(vault_fd, buffer, n, source);
+      if (result == VAULT_OK)
+        result = write_all_at(segment_fd, buffer, n, destination);
+      source += n;
+      destination += n;
+      remaining -= n;
+    }
+    if (result != VAULT_OK)
+      break;
+    entry->chunks[c].offset = *segment_end;
+    *segment_end += entry->chunks[c].length;
+    *moved += entry->chunks[c].length;
+    bitmap[1 + c / 8] |= (uint8_t)(1u << (c % 8));
+  }
+  if (result == VAULT_OK)
+    result = vault_entry_ext_set(entry, VAULT_EXT_TIER, bitmap, bitmap_len);
+  free(bitmap);
+  return result;
+}
+
+int vault_tier_migrate(uint32_t cold_days, uint64_t max_bytes,
+                       uint64_t *moved_out) {
+  if (moved_out)
+    *moved_out = 0;
+  if (!g_vault.is_open)
+    return VAULT_ERR_NOT_OPEN;
+  if (!g_segment_path || max_bytes == 0)
+    return VAULT_ERR_INVALID_PARAM;
+  // Legacy containers are rewritten whole and know nothing about segments
+  if (!vault_container_is_log())
+    return VAULT_ERR_INVALID_PARAM;
+
+  tier_fold_access();
+  // A failed compaction leaves a valid, if larger, segment behind
+  if (tier_compact_segment() != VAULT_OK)
+    LOGE("vault_tier_migrate: segment compaction failed");
+  tier_reclaim_segment();
+
+  uint64_t now = get_timestamp_ms();
+  uint64_t age = (uint64_t)cold_days * TIER_MS_PER_DAY;
+  uint64_t cutoff = now > age ? now - age : 0;
+
+  int result = VAULT_OK;
+  int vault_fd = -1;
+  int segment_fd = -1;
+  uint64_t segment_start = 0;
+  uint64_t moved = 0;
+  uint8_t *buffer = NULL;
+  vault_entry_t *entries = NULL;
+  uint32_t entry_count = g_vault.entry_count;
+  tier_candidate_t *candidates = NULL;
+  uint32_t candidate_count = 0;
+
+  if (entry_count == 0)
+    return VAULT_OK;
+  candidates = malloc(entry_count * sizeof(tier_candidate_t));
+  if (!candidates)
+    return VAULT_ERR_MEMORY;
+  // Notes, images and thumbnails are single blobs and stay internal
+  for (uint32_t i = 0; i < entry_count; i++) {
+    const vault_entry_t *entry = &g_vault.entries[i];
+    if (entry->chunk_count == 0 ||
+        (entry->name && strncmp(entry->name, "__", 2) == 0))
+      continue;
+    uint64_t last_access = entry_last_access(entry);
+    if (last_access >= cutoff || !entry_has_internal_chunks(entry))
+      continue;
+    candidates[candidate_count].index = i;
+    candidates[candidate_count].last_access = last_access;
+    candidate_count++;
+  }
+  if (candidate_count == 0)
+    goto cleanup;
+  qsort(candidates, candidate_count, sizeof(tier_candidate_t),
+        compare_candidates);
+
+  result = clone_entries(g_vault.entries, entry_count, &entries);
+  if (result != VAULT_OK)
+    goto cleanup;
+  buffer = malloc(TIER_COPY_BUFFER);
+  if (!buffer) {
+    result = VAULT_ERR_MEMORY;
+    goto cleanup;
+  }
+  vault_fd = open(g_vault.path, O_RDONLY | O_CLOEXEC);
+  segment_fd = open(g_segment_path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+  if (vault_fd < 0 || segment_fd < 0) {
+    result = VAULT_ERR_IO;
+    goto cleanup;
+  }
+  result = tier_prepare_segment(segment_fd);
+  if (result != VAULT_OK)
+    goto cleanup;
+  off_t end = lseek(segment_fd, 0, SEEK_END);
+  if (end < 0) {
+    result = VAULT_ERR_IO;
+    goto cleanup;
+  }
+  segment_start = (uint64_t)end;
+  uint64_t segment_end = segment_start;
+
+  for (uint32_t k = 0; k < candidate_count && moved < max_bytes; k++) {
+    result = tier_move_entry(&entries[candidates[k].index], vault_fd,
+                             segment_fd, &segment_end, buffer, &moved);
+    if (result != VAULT_OK)
+      goto cleanup;
+  }
+  // Chunks must be durable in the segment before the index points at them
+  if (fsync(segment_fd) != 0) {
+    result = VAULT_ERR_IO;
+    goto cleanup;
+  }
+
+  vault_entry_t *old_entries = g_vault.entries;
+  g_vault.entries = entries;
+  vault_stats_rebuild();
+  result = vault_save_index_only();
+  if (result != VAULT_OK) {
+    LOGE("vault_tier_migrate: commit failed with %d", result);
+    g_vault.entries = old_entries;
+    vault_stats_rebuild();
+    goto cleanup;
+  }
+  entries = old_entries;
+  LOGI("vault_tier_migrate: moved %llu bytes to cold storage",
+       (unsigned long long)moved);
+  if (moved_out)
+    *moved_out = moved;
+
+cleanup:
+  if (segment_fd >= 0) {
+    // Drop the unreferenced tail of a migration that did not commit
+    if (result != VAULT_OK && segment_start > 0 &&
+        ftruncate(segment_fd, (off_t)segment_start) != 0)
+      LOGE("vault_tier_migrate: failed to trim segment");
+    close(segment_fd);
+  }
+  if (vault_fd >= 0)
+    close(vault_fd);
+  if (buffer) {
+    vault_zeroize(buffer, TIER_COPY_BUFFER);
+    free(buffer);
+  }
+  if (entries)
+    free_entries_array(entries, entry_count);
+  free(candidates);
+  return result;
+}
+
+typedef struct {
+  const vault_entry_t *entry;
+} tier_recall_source_t;
+
+// Chunk source that hands back a cold chunk's ciphertext and nonce unchanged
+static int copy_cold_chunk(void *ctx, uint32_t chunk_index, uint8_t *out,
+                           size_t out_cap, size_t *out_len,
+                           uint8_t nonce_out[VAULT_NONCE_LEN]) {
+  tier_recall_source_t *source = ctx;
+  const vault_entry_t *entry = source->entry;
+  if (chunk_index >= entry->chunk_count)
+    return VAULT_ERR_INVALID_PARAM;
+  uint32_t length = entry->chunks[chunk_index].length;
+  if (length > out_cap)
+    return VAULT_ERR_INVALID_PARAM;
+  int fd = vault_tier_open_chunk(entry, chunk_index);
+  if (fd < 0)
+    return VAULT_ERR_IO;
+  int result =
+      read_all_at(fd, out, length, entry->chunks[chunk_index].offset);
+  close(fd);
+  if (result != VAULT_OK)
+    return result;
+  memcpy(nonce_out, entry->chunks[chunk_index].nonce, VAULT_NONCE_LEN);
+  *out_len = length;
+  return VAULT_OK;
+}
+
+int vault_tier_recall_all(uint32_t *recalled_out) {
+  if (recalled_out)
+    *recalled_out = 0;
+  if (!g_vault.is_open)
+    return VAULT_ERR_NOT_OPEN;
+
+  uint32_t recalled = 0;
+  // Each recall commits and replaces the entries array; indices stay stable
+  for (uint32_t i = 0; i < g_vault.entry_count; i++) {
+    const vault_entry_t *entry = &g_vault.entries[i];
+    uint32_t first = UINT32_MAX;
+    uint32_t last = 0;
+    size_t max_len = 0;
+    for (uint32_t c = 0; c < entry->chunk_count; c++) {
+      if (!vault_tier_chunk_is_cold(entry, c))
+        continue;
+      if (first == UINT32_MAX)
+        first = c;
+      last = c;
+    }
+    if (first == UINT32_MAX)
+      continue;
+    for (uint32_t c = first; c <= last; c++) {
+      if (entry->chunks[c].length > max_len)
+        max_len = entry->chunks[c].length;
+    }
+
+    vault_entry_t *updated = NULL;
+    int result = clone_entries(entry, 1, &updated);
+    if (result != VAULT_OK)
+      return result;
+    tier_recall_source_t source = {.entry = entry};
+    result = vault_update_entry_from_source(updated, first, last - first + 1,
+                                            copy_cold_chunk, &source, max_len);
+    free_entries_array(updated, 1);
+    if (result != VAULT_OK) {
+      LOGE("vault_tier_recall_all: recall failed with %d", result);
+      return result;
+    }
+    recalled++;
+    if (recalled_out)
+      *recalled_out = recalled;
+  }
+  tier_reclaim_segment();
+  return VAULT_OK;
+}
+
+void vault_tier_reset(void) {
+  pthread_mutex_lock(&g_access_lock);
+  free(g_access);
+  g_access = NULL;
+  g_access_count = 0;
+  g_access_cap = 0;
+  pthread_mutex_unlock(&g_access_lock);
+  free(g_segment_path);
+  g_segment_path = NULL;
+}
@@ -0,0 +1,105 @@
+/**
+ * NoLeak Vault Engine - Tiered Chunk Placement
+ *
+ * Chunks of files left unread for a while can move from the container on
+ * internal storage to a cold segment file on a secondary volume (SD card).
+ * The segment only ever holds ciphertext: chunks keep their nonce and AAD,
+ * so they are authenticated exactly as before. Which chunks live in the
+ * segment is recorded per entry as a VAULT_EXT_TIER bitmap inside the
+ * encrypted index; a set bit means the chunk's offset refers to the segment.
+ *
+ * - Last access is tracked in memory on reads and stored with the entry
+ *   (VAULT_EXT_ACCESS) by the next migration commit
+ * - Single-blob entries (notes, images, thumbnails) and system entries are
+ *   never moved
+ * - Rewriting a chunk (partial update, recall) brings it back to internal
+ *   storage; compaction leaves cold chunks where they are
+ * - The segment is trimmed past its last referenced chunk, and removed once
+ *   it holds none, when it is attached, before a migration and after a recall
+ * - Before a migration, a segment at least half dead space is compacted
+ */
+
+#ifndef VAULT_TIER_H
+#define VAULT_TIER_H
+
+#include "vault_engine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VAULT_TIER_SEGMENT_MAGIC "VAULTSG1"
+#define VAULT_TIER_SEGMENT_MAGIC_LEN 8
+
+/**
+ * Select the directory holding this vault's cold segment (NULL disables
+ * tiering). Must be called after the vault is opened; an existing segment
+ * must belong to the open vault.
+ * @return VAULT_OK on success, VAULT_ERR_CORRUPTED for a foreign segment
+ */
+int vault_tier_set_cold_dir(const char *dir);
+
+/**
+ * Whether a chunk's ciphertext lives in the cold segment.
+ */
+int vault_tier_chunk_is_cold(const vault_entry_t *entry, uint32_t chunk_index);
+
+/**
+ * Open the file holding a chunk's ciphertext for reading.
+ * @return File descriptor (caller closes), or -1
+ */
+int vault_tier_open_chunk(const vault_entry_t *entry, uint32_t chunk_index);
+
+/**
+ * Record chunks [first, first + count) as internal again after they were
+ * rewritten to the container. Only the in-memory entry changes.
+ * @return VAULT_OK on success
+ */
+int vault_tier_mark_internal(vault_entry_t *entry, uint32_t first,
+                             uint32_t count);
+
+/**
+ * Note a read of a file for cold-data selection.
+ */
+void vault_tier_note_access(const uint8_t file_id[VAULT_ID_LEN]);
+
+/**
+ * Drop a deleted file's in-memory access time.
+ */
+void vault_tier_forget_access(const uint8_t file_id[VAULT_ID_LEN]);
+
+/**
+ * Last read of a file: the newer of the in-memory access time and the one
+ * stored with the entry (creation time if it was never read).
+ */
+uint64_t vault_tier_last_access(const vault_entry_t *entry);
+
+/**
+ * Move chunks of files not read for cold_days to the cold segment, oldest
+ * first, with one index commit.
+ * @param cold_days Days without access before a file is cold
+ * @param max_bytes Ciphertext moved by this call stops after this many bytes
+ * @param moved_out Receives the bytes moved (may be NULL)
+ * @return VAULT_OK on success
+ */
+int vault_tier_migrate(uint32_t cold_days, uint64_t max_bytes,
+                       uint64_t *moved_out);
+
+/**
+ * Copy every cold chunk back into the container, e.g. before the container
+ * file is exported on its own.
+ * @param recalled_out Receives the number of files recalled (may be NULL)
+ * @return VAULT_OK on success
+ */
+int vault_tier_recall_all(uint32_t *recalled_out);
+
+/**
+ * Forget the cold directory and access times (vault close).
+ */
+void vault_tier_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VAULT_TIER_H
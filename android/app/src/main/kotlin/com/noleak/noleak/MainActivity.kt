@@ -5,13 +5,16 @@ import android.os.Build
 import android.os.Bundle
 import android.os.Handler
 import android.os.Looper
+import android.os.SystemClock
 import android.view.MotionEvent
 import android.view.WindowManager
 import io.flutter.embedding.android.FlutterFragmentActivity
 import io.flutter.embedding.engine.FlutterEngine
 import com.noleak.noleak.audio.AudioPlayerManager
+import com.noleak.noleak.vault.ConcurrencyGovernor
 import com.noleak.noleak.vault.VaultBridge
 import com.noleak.noleak.vault.VaultEngine
+import com.noleak.noleak.vault.VaultShareProvider
 import com.noleak.noleak.video.VideoPlayerManager
 import com.noleak.noleak.security.SecureLog
 
@@ -38,9 +41,18 @@ class MainActivity : FlutterFragmentActivity() {
     
     private var vaultEngine: VaultEngine? = null
     private val backgroundHandler = Handler(Looper.getMainLooper())
-    private val pickerLockRunnable = Runnable {
-        SecureLog.security("MainActivity", "SAF picker timeout - closing vault")
-        closeVaultSafely()
+    private var backgroundedAt = 0L
+    private val pickerLockRunnable = object : Runnable {
+        override fun run() {
+            // A receiving app still reading a share keeps the vault open
+            // until its reads go idle, up to a hard cap
+            if (VaultShareProvider.mayDeferLock(backgroundedAt)) {
+                backgroundHandler.postDelayed(this, VaultShareProvider.READ_IDLE_MS)
+                return
+            }
+            SecureLog.security("MainActivity", "SAF picker timeout - closing vault")
+            closeVaultSafely()
+        }
     }
     
     override fun onCreate(savedInstanceState: Bundle?) {
@@ -48,6 +60,9 @@ class MainActivity : FlutterFragmentActivity() {
         
         // Get vault engine instance
         vaultEngine = VaultEngine.getInstance(applicationContext)
+
+        // Heavy jobs back off when the device runs hot or low on battery
+        ConcurrencyGovernor.getInstance(applicationContext).start()
         
         // Set FLAG_SECURE to prevent screenshots and screen recording
         window.setFlags(
@@ -94,13 +109,15 @@ class MainActivity : FlutterFragmentActivity() {
      */
     override fun onStop() {
         super.onStop()
-        if (VaultPlugin.getInstance()?.isAwaitingActivityResult == true) {
+        if (VaultPlugin.getInstance()?.isAwaitingActivityResult == true ||
+            VaultShareProvider.isShareActive()) {
             val timeoutSeconds = getSharedPreferences("FlutterSharedPreferences", MODE_PRIVATE)
                 .getLong("flutter.idle_timeout_seconds", 30L)
                 .coerceIn(10L, 30L)
+            backgroundedAt = SystemClock.elapsedRealtime()
             backgroundHandler.removeCallbacks(pickerLockRunnable)
             backgroundHandler.postDelayed(pickerLockRunnable, timeoutSeconds * 1000L)
-            SecureLog.security("MainActivity", "onStop - SAF picker active, lock scheduled")
+            SecureLog.security("MainActivity", "onStop - SAF picker or share active, lock scheduled")
             return
         }
         backgroundHandler.removeCallbacks(pickerLockRunnable)
@@ -148,6 +165,9 @@ class MainActivity : FlutterFragmentActivity() {
             SecureLog.e("MainActivity", "Error closing audio players: ${e.message}")
         }
         
+        // SECURITY: Revoke shares so receiving apps lose access with the vault
+        VaultShareProvider.revokeAll(applicationContext)
+
         // Close vault engine
         try {
             if (vaultEngine?.isOpen() == true) {
@@ -162,6 +182,7 @@ class MainActivity : FlutterFragmentActivity() {
     
     override fun onDestroy() {
         backgroundHandler.removeCallbacks(pickerLockRunnable)
+        ConcurrencyGovernor.getInstance(applicationContext).stop()
         // Final cleanup - ensure vault is closed
         closeVaultSafely()
         super.onDestroy()
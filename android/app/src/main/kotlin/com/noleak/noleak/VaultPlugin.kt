@@ -1,6 +1,7 @@
 package com.noleak.noleak
 
 import android.app.Activity
+import android.content.ClipData
 import android.content.Intent
 import android.graphics.Bitmap
 import android.graphics.Canvas
@@ -22,12 +23,16 @@ import com.noleak.noleak.audio.AudioPlayerManager
 import com.noleak.noleak.security.SecureKeyManager
 import com.noleak.noleak.security.SecurityManager
 import com.noleak.noleak.security.PlaintextScanner
+import com.noleak.noleak.vault.ConcurrencyGovernor
 import com.noleak.noleak.vault.SafFileHandler
+import com.noleak.noleak.vault.SafFolderEnumerator
 import com.noleak.noleak.vault.StreamingImportHandler
 import com.noleak.noleak.vault.VaultBridge
 import com.noleak.noleak.vault.VaultEngine
 import com.noleak.noleak.vault.VaultException
 import com.noleak.noleak.vault.VaultRegistry
+import com.noleak.noleak.vault.VaultShareProvider
+import com.noleak.noleak.vault.WatchedSourceStore
 import com.noleak.noleak.video.VideoOpenResult
 import com.noleak.noleak.video.VideoPlayerManager
 import io.flutter.embedding.engine.plugins.FlutterPlugin
@@ -40,8 +45,11 @@ import io.flutter.plugin.common.PluginRegistry
 import io.flutter.view.TextureRegistry
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.channels.ReceiveChannel
 import kotlinx.coroutines.flow.catch
 import kotlinx.coroutines.flow.collect
+import kotlinx.coroutines.isActive
 import kotlinx.coroutines.launch
 import kotlinx.coroutines.withContext
 import java.io.ByteArrayOutputStream
@@ -52,6 +60,7 @@ import com.noleak.noleak.security.SecureLog
 import com.noleak.noleak.security.PasswordRateLimiter
 import java.security.SecureRandom
 import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.atomic.AtomicBoolean
 import kotlin.math.roundToInt
 
 /**
@@ -86,8 +95,11 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
         private const val IMPORT_VAULT_REQUEST = 1003
         private const val PICK_FOLDER_REQUEST = 1004
         private const val EXPORT_FILE_REQUEST = 1005
+        private const val EXPORT_ARCHIVE_REQUEST = 1009
         private const val MIN_PASSPHRASE_BYTES = 12
         private const val MAX_PASSPHRASE_BYTES = 1024
+        private const val ARCHIVE_PROGRESS_INTERVAL_MS = 250L
+        private const val RECHUNK_RETRY_MS = 30_000L
         
         @Volatile
         private var instance: VaultPlugin? = null
@@ -96,6 +108,10 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
     }
     
     private lateinit var channel: MethodChannel
+    // Search backfill pass state (see scheduleTextBackfill)
+    private val textBackfillRunning = AtomicBoolean(false)
+    @Volatile
+    private var textBackfillRequested = false
     private var activity: Activity? = null
     private var pendingResult: MethodChannel.Result? = null
     private var pendingFolderResult: MethodChannel.Result? = null
@@ -103,16 +119,22 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
     private var pendingImportResult: MethodChannel.Result? = null
     private var pendingExportFileResult: MethodChannel.Result? = null
     private var pendingExportFileId: ByteArray? = null
+    private var pendingExportArchiveResult: MethodChannel.Result? = null
+    private var pendingExportArchive: Pair<List<ByteArray>, List<String>>? = null
+    private var pendingExportArchiveFormat = VaultEngine.ARCHIVE_FORMAT_ZIP
     
     private lateinit var vaultBridge: VaultBridge
     private lateinit var vaultRegistry: VaultRegistry
     private lateinit var securityManager: SecurityManager
     private lateinit var secureKeyManager: SecureKeyManager
     private lateinit var safFileHandler: SafFileHandler
+    private lateinit var safFolderEnumerator: SafFolderEnumerator
+    private lateinit var watchedSourceStore: WatchedSourceStore
     private lateinit var streamingImportHandler: StreamingImportHandler
     private lateinit var videoPlayerManager: VideoPlayerManager
     private lateinit var audioPlayerManager: AudioPlayerManager
     private lateinit var passwordRateLimiter: PasswordRateLimiter
+    private lateinit var concurrencyGovernor: ConcurrencyGovernor
     private var textureRegistry: TextureRegistry? = null
     private var importProgressChannel: EventChannel? = null
     private var importProgressSink: EventChannel.EventSink? = null
@@ -131,12 +153,6 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
     
     private val scope = CoroutineScope(Dispatchers.Main)
 
-    private data class FolderImportTarget(
-        val uri: Uri,
-        val validation: SafFileHandler.FileValidationResult.Valid,
-        val folder: String
-    )
-
     private fun passwordBytes(
         call: MethodCall,
         key: String,
@@ -222,6 +238,8 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
         securityManager = SecurityManager.getInstance(context)
         secureKeyManager = SecureKeyManager(context)
         safFileHandler = SafFileHandler(context)
+        safFolderEnumerator = SafFolderEnumerator(context, safFileHandler)
+        watchedSourceStore = WatchedSourceStore(vaultBridge)
         cleanupStalePlaintextCache(context.cacheDir)
         cleanupStaleEncryptedVaultTemps(
             context.cacheDir,
@@ -231,6 +249,7 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
         videoPlayerManager = VideoPlayerManager.getInstance(vaultBridge)
         audioPlayerManager = AudioPlayerManager.getInstance(vaultBridge)
         passwordRateLimiter = PasswordRateLimiter.getInstance(context)
+        concurrencyGovernor = ConcurrencyGovernor.getInstance(context)
         textureRegistry = binding.textureRegistry
         
         // Set up EventChannel for import progress
@@ -297,6 +316,11 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
             "pickFolder" -> handlePickFolder(result)
             "importFile" -> handleImportFile(call, result)
             "importFolder" -> handleImportFolder(call, result)
+            "importArchive" -> handleImportArchive(call, result)
+            "addWatchedSource" -> handleAddWatchedSource(call, result)
+            "listWatchedSources" -> handleListWatchedSources(result)
+            "removeWatchedSource" -> handleRemoveWatchedSource(call, result)
+            "syncWatchedSource" -> handleSyncWatchedSource(call, result)
             "importBytes" -> handleImportBytes(call, result)
             "importFileStreaming" -> handleImportFileStreaming(call, result)
             "listPendingImports" -> handleListPendingImports(result)
@@ -306,9 +330,16 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
             "renderPdfPage" -> handleRenderPdfPage(call, result)
             "deleteFile" -> handleDeleteFile(call, result)
             "renameFile" -> handleRenameFile(call, result)
+            "deleteFiles" -> handleDeleteFiles(call, result)
+            "renameFiles" -> handleRenameFiles(call, result)
             "copyFile" -> handleCopyFile(call, result)
             "exportFile" -> handleExportFile(call, result)
+            "exportArchive" -> handleExportArchive(call, result)
+            "shareFile" -> handleShareFile(call, result)
             "getEntryCount" -> handleGetEntryCount(result)
+            "getVaultStats" -> handleGetVaultStats(result)
+            "analyzeLayout" -> handleAnalyzeLayout(result)
+            "searchFiles" -> handleSearchFiles(call, result)
             "listFiles" -> handleListFiles(result)
             "authenticateBiometric" -> handleAuthenticateBiometric(result)
             "recordAuthSuccess" -> handleRecordAuthSuccess(call, result)
@@ -393,7 +424,12 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
         scope.launch {
             try {
                 vaultBridge.openVault(passphrase).fold(
-                    onSuccess = { result.success(true) },
+                    onSuccess = {
+                        result.success(true)
+                        scheduleColdMigration()
+                        scheduleLegacyRechunk()
+                        scheduleTextBackfill()
+                    },
                     onFailure = { e ->
                         if (e is VaultException && e.isAuthError()) {
                             reportAuthFailure(null, result)
@@ -408,6 +444,79 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
         }
     }
     
+    /**
+     * Move long-unread file chunks to removable storage after an open.
+     * Runs in bounded passes so user operations queue between them.
+     */
+    private fun scheduleColdMigration() {
+        scope.launch {
+            while (vaultBridge.isVaultOpen()) {
+                val moved = vaultBridge.migrateColdData().getOrElse { e ->
+                    SecureLog.w("VaultPlugin", "Cold migration stopped: ${e.message}")
+                    0L
+                }
+                if (moved == 0L) break
+            }
+        }
+    }
+
+    /**
+     * Re-encrypt files still in the 1 MB chunk layout into 4 MB chunks after
+     * an open. Waits while a video is open or opening, since its data source
+     * assumes the layout it was opened with; the check is made under the
+     * bridge lock, so an open cannot read the layout in between. Files are
+     * converted one per lock hold and paced to the governor's I/O rate in
+     * between, so a hot device slows the job without stalling other calls.
+     */
+    private fun scheduleLegacyRechunk() {
+        scope.launch {
+            while (vaultBridge.isVaultOpen()) {
+                val startedAt = System.currentTimeMillis()
+                val converted = vaultBridge.rechunkLegacyFiles(
+                    canStart = { !videoPlayerManager.hasOpenVideos() }
+                ).getOrElse { e ->
+                    SecureLog.w("VaultPlugin", "Re-chunking stopped: ${e.message}")
+                    0L
+                }
+                if (converted == null) {
+                    delay(RECHUNK_RETRY_MS)
+                    continue
+                }
+                if (converted == 0L) break
+                concurrencyGovernor.pace(converted, System.currentTimeMillis() - startedAt)
+            }
+        }
+    }
+
+    /**
+     * Tokenize text that has no search terms yet: notes imported before
+     * search existed and text streamed in chunks. Runs after an open and
+     * after imports, one locked batch per call; a request made while a pass
+     * is running starts another pass when it ends.
+     */
+    private fun scheduleTextBackfill() {
+        textBackfillRequested = true
+        if (!textBackfillRunning.compareAndSet(false, true)) return
+        scope.launch {
+            try {
+                while (textBackfillRequested && vaultBridge.isVaultOpen()) {
+                    textBackfillRequested = false
+                    var cursor: Int? = 0
+                    while (cursor != null && vaultBridge.isVaultOpen()) {
+                        cursor = vaultBridge.indexPendingText(cursor).getOrElse { e ->
+                            SecureLog.w("VaultPlugin", "Search backfill stopped: ${e.message}")
+                            null
+                        }
+                    }
+                }
+            } finally {
+                textBackfillRunning.set(false)
+            }
+            // A request that arrived as the last pass ended
+            if (textBackfillRequested && vaultBridge.isVaultOpen()) scheduleTextBackfill()
+        }
+    }
+
     private fun handleCloseVault(result: MethodChannel.Result) {
         scope.launch {
             closeMediaPlayers()
@@ -599,7 +708,8 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
             SecureLog.w("VaultPlugin", "Failed to cleanup stale imports: ${e.message}")
         }
         
-        val root = DocumentFile.fromTreeUri(ctx, Uri.parse(uriString))
+        val treeUri = Uri.parse(uriString)
+        val root = DocumentFile.fromTreeUri(ctx, treeUri)
         if (root == null) {
             SecureLog.e("VaultPlugin", "handleImportFolder: could not access folder")
             result.error("INVALID_FOLDER", "Could not access folder", null)
@@ -608,36 +718,226 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
 
         val rootName = root.name ?: "folder"
         SecureLog.d("VaultPlugin", "handleImportFolder: rootName=$rootName")
-        val targets = mutableListOf<FolderImportTarget>()
-        var skipped = 0
-        collectFolderTargets(root, rootName, targets) { skipped++ }
-        SecureLog.d("VaultPlugin", "handleImportFolder: collected ${targets.size} targets, skipped=$skipped")
+        val importId = ByteArray(16).also { importIdRandom.nextBytes(it) }
+        emitImportProgress(
+            importId = importId,
+            bytesWritten = 0,
+            totalBytes = 0,
+            chunksCompleted = 0,
+            totalChunks = 0,
+            sessionId = sessionId
+        )
+
+        scope.launch {
+            // Files stream in while the tree is still being walked, so the
+            // totals grow until the walk completes
+            val totals = SafFolderEnumerator.Totals()
+            val entries = safFolderEnumerator.enumerate(this, treeUri, rootName, totals)
+            val outcome = importFolderEntries(entries, totals, importId, sessionId, result)
+                ?: return@launch
+
+            if (outcome.imported.isEmpty()) {
+                SecureLog.e("VaultPlugin", "handleImportFolder: folder is empty")
+                result.error("EMPTY_FOLDER", "Folder is empty or contains no importable files", null)
+                return@launch
+            }
+            emitImportComplete(importId, outcome, sessionId)
+
+            SecureLog.d("VaultPlugin", "handleImportFolder: completed, imported ${outcome.imported.size} files, skipped=${outcome.skipped}")
+            for (item in outcome.imported) {
+                SecureLog.d("VaultPlugin", "handleImportFolder: file=${item["name"]}, folder=${item["folder"]}")
+            }
+            result.success(
+                mapOf(
+                    "files" to outcome.imported,
+                    "skipped" to outcome.skipped
+                )
+            )
+        }
+    }
 
-        if (targets.isEmpty()) {
-            SecureLog.e("VaultPlugin", "handleImportFolder: folder is empty")
-            result.error("EMPTY_FOLDER", "Folder is empty or contains no importable files", null)
+    /**
+     * Watch a SAF tree (picked with pickFolder, which keeps the read grant)
+     * so later syncs import only what is new or changed into [folder]
+     */
+    private fun handleAddWatchedSource(call: MethodCall, result: MethodChannel.Result) {
+        val uriString = call.argument<String>("uri")
+        if (uriString == null) {
+            result.error("INVALID_ARGUMENT", "URI required", null)
             return
         }
+        val folder = call.argument<String>("folder") ?: ""
+        if (!vaultBridge.isVaultOpen()) {
+            result.error("VAULT_NOT_OPEN", "Vault must be unlocked to watch folders", null)
+            return
+        }
+        val ctx = activity
+        if (ctx == null) {
+            result.error("NO_ACTIVITY", "No activity available", null)
+            return
+        }
+        val name = DocumentFile.fromTreeUri(ctx, Uri.parse(uriString))?.name ?: "folder"
+
+        scope.launch {
+            watchedSourceStore.add(uriString, name, folder).fold(
+                onSuccess = { result.success(it.toMap()) },
+                onFailure = { result.error("WATCH_FAILED", it.message, null) }
+            )
+        }
+    }
+
+    private fun handleListWatchedSources(result: MethodChannel.Result) {
+        if (!vaultBridge.isVaultOpen()) {
+            result.error("VAULT_NOT_OPEN", "Vault must be unlocked", null)
+            return
+        }
+        scope.launch {
+            result.success(watchedSourceStore.list().map { it.toMap() })
+        }
+    }
+
+    private fun handleRemoveWatchedSource(call: MethodCall, result: MethodChannel.Result) {
+        val id = call.argument<String>("id")
+        if (id == null) {
+            result.error("INVALID_ARGUMENT", "Source ID required", null)
+            return
+        }
+        if (!vaultBridge.isVaultOpen()) {
+            result.error("VAULT_NOT_OPEN", "Vault must be unlocked", null)
+            return
+        }
+        scope.launch {
+            watchedSourceStore.remove(id).fold(
+                onSuccess = { result.success(it) },
+                onFailure = { result.error("WATCH_FAILED", it.message, null) }
+            )
+        }
+    }
+
+    /**
+     * Import what changed in a watched folder since its last sync. The
+     * result has the importFolder shape plus "unchanged" (files skipped via
+     * the cursor) and the source's target "folder". Work done before a
+     * failure is kept in the cursor, so the next sync picks up from there.
+     */
+    private fun handleSyncWatchedSource(call: MethodCall, result: MethodChannel.Result) {
+        val id = call.argument<String>("id")
+        if (id == null) {
+            result.error("INVALID_ARGUMENT", "Source ID required", null)
+            return
+        }
+        val sessionId = call.argument<Number>("sessionId")?.toLong()
+        if (!vaultBridge.isVaultOpen()) {
+            result.error("VAULT_NOT_OPEN", "Vault must be unlocked to sync folders", null)
+            return
+        }
+        val ctx = activity
+        if (ctx == null) {
+            result.error("NO_ACTIVITY", "No activity available", null)
+            return
+        }
+
+        try {
+            vaultBridge.cleanupStalePendingImports()
+        } catch (e: Exception) {
+            SecureLog.w("VaultPlugin", "Failed to cleanup stale imports: ${e.message}")
+        }
 
-        val totalBytes = targets.sumOf { it.validation.size }
         val importId = ByteArray(16).also { importIdRandom.nextBytes(it) }
         emitImportProgress(
             importId = importId,
             bytesWritten = 0,
-            totalBytes = totalBytes,
+            totalBytes = 0,
             chunksCompleted = 0,
-            totalChunks = targets.size,
+            totalChunks = 0,
             sessionId = sessionId
         )
 
         scope.launch {
-            val imported = mutableListOf<Map<String, Any>>()
-            var bytesWritten = 0L
-            var completedFiles = 0
+            val source = watchedSourceStore.find(id)
+            if (source == null) {
+                result.error("NOT_FOUND", "Watched folder not found", null)
+                return@launch
+            }
+            val treeUri = Uri.parse(source.uri)
+            val granted = ctx.contentResolver.persistedUriPermissions.any {
+                it.uri == treeUri && it.isReadPermission
+            }
+            if (!granted) {
+                SecureLog.e("VaultPlugin", "handleSyncWatchedSource: folder access revoked")
+                result.error("SOURCE_UNAVAILABLE", "Folder access was revoked; watch the folder again", null)
+                return@launch
+            }
+
+            val cursor = watchedSourceStore.loadCursor(source)
+            val totals = SafFolderEnumerator.Totals()
+            val (pass, entries) = safFolderEnumerator.enumerateChanges(
+                this, treeUri, source.name, cursor, totals
+            )
+            val outcome = importFolderEntries(entries, totals, importId, sessionId, result) {
+                pass.resolve(it)
+            }
+            // Unchanged passes leave the vault untouched
+            pass.finish()?.let { next ->
+                watchedSourceStore.saveCursor(source, cursor, next).onFailure {
+                    SecureLog.e("VaultPlugin", "handleSyncWatchedSource: cursor not saved")
+                }
+            }
+            if (outcome == null) return@launch
 
-            for (target in targets) {
-                val validation = target.validation
-                val useStreaming = safFileHandler.shouldUseStreaming(target.uri, validation.mimeType)
+            emitImportComplete(importId, outcome, sessionId)
+            SecureLog.d(
+                "VaultPlugin",
+                "handleSyncWatchedSource: imported ${outcome.imported.size}, skipped=${outcome.skipped}, unchanged=${pass.unchangedFiles.get()}"
+            )
+            result.success(
+                mapOf(
+                    "files" to outcome.imported,
+                    "skipped" to outcome.skipped,
+                    "unchanged" to pass.unchangedFiles.get(),
+                    "folder" to source.folder
+                )
+            )
+        }
+    }
+
+    /**
+     * Imports the files arriving on [entries] (small ones in memory, large
+     * ones streamed), reporting progress under [importId]. On failure the
+     * error, with the files imported so far as its details, is sent to
+     * [result] and null is returned. [onResolved] is called
+     * for every entry that was imported or skipped as not importable.
+     */
+    private suspend fun importFolderEntries(
+        entries: ReceiveChannel<SafFolderEnumerator.Entry>,
+        totals: SafFolderEnumerator.Totals,
+        importId: ByteArray,
+        sessionId: Long?,
+        result: MethodChannel.Result,
+        onResolved: (SafFolderEnumerator.Entry) -> Unit = {}
+    ): FolderImportOutcome? {
+        val imported = mutableListOf<Map<String, Any>>()
+        var bytesWritten = 0L
+        var completedFiles = 0
+        var skipped = 0
+
+        // Files placed before a failure are reported with it ("files" and
+        // "skipped" as on success) so the caller can still file them, since
+        // a watched source's cursor already counts them as synced
+        fun fail(code: String, message: String?) {
+            result.error(code, message, mapOf("files" to imported.toList(), "skipped" to skipped))
+        }
+
+        try {
+            for (entry in entries) {
+                val validation = entry.validation
+                if (validation !is SafFileHandler.FileValidationResult.Valid) {
+                    SecureLog.d("VaultPlugin", "importFolderEntries: skipping file (validation failed)")
+                    skipped++
+                    onResolved(entry)
+                    continue
+                }
+                val useStreaming = safFileHandler.shouldUseStreaming(validation.size, validation.mimeType)
                 // FIXED: Use only the file name, folder mapping is handled separately by Dart
                 // Previously used fullName with folder path which caused file names like "Folder/file.txt"
                 val fileName = validation.name
@@ -646,7 +946,7 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
                     var fileId: ByteArray? = null
                     var hadError = false
                     var streamingImportId: ByteArray? = null
-                    streamingImportHandler.importFileStreaming(target.uri, fileName)
+                    streamingImportHandler.importFileStreaming(entry.uri, fileName)
                         .catch { e ->
                             hadError = true
                             // Cleanup pending import on error
@@ -658,13 +958,13 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
                             emitImportProgress(
                                 importId = importId,
                                 bytesWritten = bytesWritten,
-                                totalBytes = totalBytes,
+                                totalBytes = totals.bytes.get(),
                                 chunksCompleted = completedFiles,
-                                totalChunks = targets.size,
+                                totalChunks = totals.files.get(),
                                 sessionId = sessionId,
                                 error = e.message ?: "Streaming import failed"
                             )
-                            result.error("IMPORT_FAILED", e.message, null)
+                            fail("IMPORT_FAILED", e.message)
                         }
                         .collect { progress ->
                             // Track the streaming import ID for cleanup on error
@@ -682,13 +982,13 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
                                 emitImportProgress(
                                     importId = importId,
                                     bytesWritten = bytesWritten,
-                                    totalBytes = totalBytes,
+                                    totalBytes = totals.bytes.get(),
                                     chunksCompleted = completedFiles,
-                                    totalChunks = targets.size,
+                                    totalChunks = totals.files.get(),
                                     sessionId = sessionId,
                                     error = progress.error
                                 )
-                                result.error("IMPORT_FAILED", progress.error, null)
+                                fail("IMPORT_FAILED", progress.error)
                                 hadError = true
                                 return@collect
                             }
@@ -696,35 +996,35 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
                             emitImportProgress(
                                 importId = importId,
                                 bytesWritten = aggregate,
-                                totalBytes = totalBytes,
+                                totalBytes = totals.bytes.get(),
                                 chunksCompleted = completedFiles,
-                                totalChunks = targets.size,
+                                totalChunks = totals.files.get(),
                                 sessionId = sessionId
                             )
                             if (progress.isComplete && progress.fileId != null) {
                                 fileId = progress.fileId
+                                scheduleTextBackfill()
                             }
                         }
-                    if (hadError) return@launch
+                    if (hadError) return null
                     if (fileId == null) {
-                        result.error("IMPORT_FAILED", "Streaming import failed", null)
-                        return@launch
+                        fail("IMPORT_FAILED", "Streaming import failed")
+                        return null
                     }
                     bytesWritten += validation.size
                     completedFiles++
                     emitImportProgress(
                         importId = importId,
                         bytesWritten = bytesWritten,
-                        totalBytes = totalBytes,
+                        totalBytes = totals.bytes.get(),
                         chunksCompleted = completedFiles,
-                        totalChunks = targets.size,
-                        isComplete = completedFiles == targets.size,
+                        totalChunks = totals.files.get(),
                         sessionId = sessionId
                     )
                     imported.add(
                         mapOf(
                             "fileId" to fileId!!.toList(),
-                            "folder" to target.folder,
+                            "folder" to entry.folder,
                             "name" to validation.name,
                             "size" to validation.size
                         )
@@ -732,10 +1032,10 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
                 } else {
                     var data: ByteArray? = null
                     try {
-                        data = withContext(Dispatchers.IO) { safFileHandler.readFileBytes(target.uri) }
+                        data = withContext(Dispatchers.IO) { safFileHandler.readFileBytes(entry.uri) }
                         if (data == null) {
-                            result.error("READ_FAILED", "Could not read file", null)
-                            return@launch
+                            fail("READ_FAILED", "Could not read file")
+                            return null
                         }
                         val importResult = vaultBridge.importFile(
                             data = data,
@@ -744,8 +1044,8 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
                             mime = validation.mimeType
                         )
                         if (importResult.isFailure) {
-                            result.error("IMPORT_FAILED", importResult.exceptionOrNull()?.message, null)
-                            return@launch
+                            fail("IMPORT_FAILED", importResult.exceptionOrNull()?.message)
+                            return null
                         }
                         val fileId = importResult.getOrThrow()
                         bytesWritten += validation.size
@@ -753,16 +1053,15 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
                         emitImportProgress(
                             importId = importId,
                             bytesWritten = bytesWritten,
-                            totalBytes = totalBytes,
+                            totalBytes = totals.bytes.get(),
                             chunksCompleted = completedFiles,
-                            totalChunks = targets.size,
-                            isComplete = completedFiles == targets.size,
+                            totalChunks = totals.files.get(),
                             sessionId = sessionId
                         )
                         imported.add(
                             mapOf(
                                 "fileId" to fileId.toList(),
-                                "folder" to target.folder,
+                                "folder" to entry.folder,
                                 "name" to validation.name,
                                 "size" to validation.size
                             )
@@ -775,63 +1074,160 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
                         }
                     }
                 }
+                onResolved(entry)
             }
-
-            SecureLog.d("VaultPlugin", "handleImportFolder: completed, imported ${imported.size} files, skipped=$skipped")
-            for (item in imported) {
-                SecureLog.d("VaultPlugin", "handleImportFolder: file=${item["name"]}, folder=${item["folder"]}")
-            }
-            result.success(
-                mapOf(
-                    "files" to imported,
-                    "skipped" to skipped
-                )
-            )
+        } catch (e: Exception) {
+            SecureLog.e("VaultPlugin", "importFolderEntries: folder walk failed: ${e.javaClass.simpleName}")
+            fail("INVALID_FOLDER", "Could not read folder")
+            return null
+        } finally {
+            // Stops the walk when the import ends early
+            entries.cancel()
         }
+
+
+        return FolderImportOutcome(imported, skipped, bytesWritten, completedFiles)
     }
 
-    private fun collectFolderTargets(
-        root: DocumentFile,
-        basePath: String,
-        targets: MutableList<FolderImportTarget>,
-        onSkip: () -> Unit
-    ) {
-        // Limit to prevent OOM from too many file metadata
-        val maxFiles = 5000
-        SecureLog.d("VaultPlugin", "collectFolderTargets: basePath=$basePath, root=${root.name}")
-        
-        for (child in root.listFiles()) {
-            if (targets.size >= maxFiles) {
-                SecureLog.w("VaultPlugin", "Folder import limited to $maxFiles files")
-                return
+    private class FolderImportOutcome(
+        val imported: List<Map<String, Any>>,
+        val skipped: Int,
+        val bytesWritten: Long,
+        val completedFiles: Int
+    )
+
+    private fun emitImportComplete(importId: ByteArray, outcome: FolderImportOutcome, sessionId: Long?) {
+        emitImportProgress(
+            importId = importId,
+            bytesWritten = outcome.bytesWritten,
+            totalBytes = outcome.bytesWritten,
+            chunksCompleted = outcome.completedFiles,
+            totalChunks = outcome.completedFiles,
+            isComplete = true,
+            sessionId = sessionId
+        )
+    }
+
+    /**
+     * Import a ZIP/TAR/.tar.gz picked with SAF. Members are decompressed and
+     * encrypted natively from the descriptor and committed together; the
+     * result has the same shape as importFolder, rooted at the archive name.
+     */
+    private fun handleImportArchive(call: MethodCall, result: MethodChannel.Result) {
+        val uriString = call.argument<String>("uri")
+        if (uriString == null) {
+            result.error("INVALID_ARGUMENT", "URI required", null)
+            return
+        }
+        val sessionId = call.argument<Number>("sessionId")?.toLong()
+
+        if (!vaultBridge.isVaultOpen()) {
+            result.error("VAULT_NOT_OPEN", "Vault must be unlocked to import archives", null)
+            return
+        }
+        val ctx = activity
+        if (ctx == null) {
+            result.error("NO_ACTIVITY", "No activity available", null)
+            return
+        }
+
+        val uri = Uri.parse(uriString)
+        val rootName = safFileHandler.getFileName(uri)
+            .replace(Regex("(?i)\\.(zip|tar|tar\\.gz|tgz)$"), "")
+            .ifBlank { "archive" }
+        val totalBytes = safFileHandler.getFileSize(uri)
+        val importId = ByteArray(16).also { importIdRandom.nextBytes(it) }
+        emitImportProgress(
+            importId = importId,
+            bytesWritten = 0,
+            totalBytes = totalBytes,
+            chunksCompleted = 0,
+            totalChunks = 0,
+            sessionId = sessionId
+        )
+
+        scope.launch {
+            val pfd = withContext(Dispatchers.IO) {
+                try {
+                    ctx.contentResolver.openFileDescriptor(uri, "r")
+                } catch (e: Exception) {
+                    null
+                }
             }
-            
-            val name = child.name ?: continue
-            if (child.isDirectory) {
-                val nextPath = if (basePath.isEmpty()) name else "$basePath/$name"
-                SecureLog.d("VaultPlugin", "collectFolderTargets: entering directory $name, nextPath=$nextPath")
-                collectFolderTargets(child, nextPath, targets, onSkip)
-            } else if (child.isFile) {
-                when (val validation = safFileHandler.validateFile(child.uri)) {
-                    is SafFileHandler.FileValidationResult.Valid -> {
-                        SecureLog.d("VaultPlugin", "collectFolderTargets: adding file ${validation.name}, folder=$basePath")
-                        targets.add(
-                            FolderImportTarget(
-                                uri = child.uri,
-                                validation = validation,
-                                folder = basePath
-                            )
+            if (pfd == null) {
+                result.error("READ_FAILED", "Could not open archive", null)
+                return@launch
+            }
+
+            // The import reports no members until its single commit, so
+            // progress is polled from the native byte counter
+            val progressJob = launch {
+                while (isActive) {
+                    delay(ARCHIVE_PROGRESS_INTERVAL_MS)
+                    emitImportProgress(
+                        importId = importId,
+                        bytesWritten = vaultBridge.archiveBytesRead(),
+                        totalBytes = totalBytes,
+                        chunksCompleted = 0,
+                        totalChunks = 0,
+                        sessionId = sessionId
+                    )
+                }
+            }
+            val importResult = try {
+                vaultBridge.importArchive(pfd.fd)
+            } finally {
+                progressJob.cancel()
+                withContext(Dispatchers.IO) { pfd.close() }
+            }
+
+            importResult.fold(
+                onSuccess = { archive ->
+                    emitImportProgress(
+                        importId = importId,
+                        bytesWritten = totalBytes,
+                        totalBytes = totalBytes,
+                        chunksCompleted = archive.members.size,
+                        totalChunks = archive.members.size,
+                        isComplete = true,
+                        sessionId = sessionId
+                    )
+                    SecureLog.d("VaultPlugin", "handleImportArchive: imported ${archive.members.size} files, skipped=${archive.skipped}")
+                    result.success(
+                        mapOf(
+                            "files" to archive.members.map { member ->
+                                mapOf(
+                                    "fileId" to member.fileId.toList(),
+                                    "folder" to if (member.folder.isEmpty()) rootName else "$rootName/${member.folder}",
+                                    "name" to member.name,
+                                    "size" to member.size
+                                )
+                            },
+                            "skipped" to archive.skipped
                         )
+                    )
+                },
+                onFailure = { e ->
+                    val message = when ((e as? VaultException)?.errorCode) {
+                        VaultEngine.VAULT_ERR_INVALID_PARAM -> "Unsupported archive format"
+                        VaultEngine.VAULT_ERR_CORRUPTED -> "Archive is damaged or truncated"
+                        else -> e.message ?: "Archive import failed"
                     }
-                    else -> {
-                        SecureLog.d("VaultPlugin", "collectFolderTargets: skipping file $name (validation failed)")
-                        onSkip()
-                    }
+                    emitImportProgress(
+                        importId = importId,
+                        bytesWritten = 0,
+                        totalBytes = totalBytes,
+                        chunksCompleted = 0,
+                        totalChunks = 0,
+                        sessionId = sessionId,
+                        error = message
+                    )
+                    result.error("IMPORT_FAILED", message, null)
                 }
-            }
+            )
         }
     }
-    
+
     /**
      * Import small files (<10MB) by reading entirely into memory
      * SECURITY: Zeroizes plaintext after import
@@ -961,6 +1357,7 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
                     
                     // Handle completion or error
                     if (progress.isComplete && progress.fileId != null) {
+                        scheduleTextBackfill()
                         result.success(mapOf(
                             "fileId" to progress.fileId.toList(),
                             "name" to validation.name,
@@ -1263,6 +1660,53 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
         }
     }
 
+    private fun handleDeleteFiles(call: MethodCall, result: MethodChannel.Result) {
+        val fileIdLists = call.argument<List<List<Int>>>("fileIds")
+        if (fileIdLists == null) {
+            result.error("INVALID_ARGUMENT", "File IDs required", null)
+            return
+        }
+        
+        val fileIds = fileIdLists.map { id -> id.map { it.toByte() }.toByteArray() }
+        SecureLog.d("VaultPlugin", "handleDeleteFiles: deleting ${fileIds.size} files")
+        
+        scope.launch {
+            vaultBridge.deleteFiles(fileIds).fold(
+                onSuccess = { result.success(true) },
+                onFailure = { e ->
+                    SecureLog.e("VaultPlugin", "handleDeleteFiles: delete failed: ${e.message}")
+                    result.error("DELETE_FAILED", e.message, null)
+                }
+            )
+        }
+    }
+
+    private fun handleRenameFiles(call: MethodCall, result: MethodChannel.Result) {
+        val fileIdLists = call.argument<List<List<Int>>>("fileIds")
+        val names = call.argument<List<String>>("names")?.map { it.trim() }
+        if (fileIdLists == null || names == null || fileIdLists.size != names.size) {
+            result.error("INVALID_ARGUMENT", "File IDs and matching names required", null)
+            return
+        }
+        // System files are renamed one at a time through renameFile.
+        if (names.any { it.isEmpty() || it.length > 4096 || it.startsWith("__") }) {
+            result.error("INVALID_ARGUMENT", "Invalid file name", null)
+            return
+        }
+        
+        val fileIds = fileIdLists.map { id -> id.map { it.toByte() }.toByteArray() }
+        
+        scope.launch {
+            vaultBridge.renameFiles(fileIds, names).fold(
+                onSuccess = { result.success(true) },
+                onFailure = { e ->
+                    SecureLog.e("VaultPlugin", "handleRenameFiles: failed: ${e.message}")
+                    result.error("RENAME_FAILED", e.message, null)
+                }
+            )
+        }
+    }
+
     private fun handleCopyFile(call: MethodCall, result: MethodChannel.Result) {
         val fileIdList = call.argument<List<Int>>("fileId")
         if (fileIdList == null) {
@@ -1276,6 +1720,7 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
             vaultBridge.copyFile(fileId).fold(
                 onSuccess = { newId -> 
                     SecureLog.d("VaultPlugin", "handleCopyFile: file copied successfully, newId=${newId.take(4)}...")
+                    scheduleTextBackfill()
                     result.success(newId.toList()) 
                 },
                 onFailure = { e -> 
@@ -1322,6 +1767,197 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
         currentActivity.startActivityForResult(intent, EXPORT_FILE_REQUEST)
     }
     
+    /**
+     * Export several files as one ZIP or TAR chosen with a single SAF picker.
+     * paths[i] is the member path of fileIds[i] inside the archive.
+     */
+    private fun handleExportArchive(call: MethodCall, result: MethodChannel.Result) {
+        val currentActivity = activity
+        if (currentActivity == null) {
+            result.error("NO_ACTIVITY", "No activity available", null)
+            return
+        }
+        if (!securityManager.isEnvironmentSecure()) {
+            result.error("ENV_BLOCKED", "Environment not supported", null)
+            return
+        }
+
+        val fileIdLists = call.argument<List<List<Int>>>("fileIds")
+        val paths = call.argument<List<String>>("paths")
+        val suggestedName = call.argument<String>("suggestedName")
+        val format = call.argument<String>("format") ?: "zip"
+        if (fileIdLists.isNullOrEmpty() || paths == null || paths.size != fileIdLists.size ||
+            suggestedName.isNullOrEmpty() || (format != "zip" && format != "tar")
+        ) {
+            result.error("INVALID_ARGUMENT", "File IDs, paths and name required", null)
+            return
+        }
+
+        // Archives cannot hold two members with the same path. Compare the
+        // paths as the native writer will store them, so "a/./b" and "a/b"
+        // do not both land on "a/b".
+        val cleanPaths = paths.map { path ->
+            cleanArchivePath(path) ?: run {
+                result.error("INVALID_ARGUMENT", "Invalid archive path", null)
+                return
+            }
+        }
+        val used = HashSet<String>()
+        val uniquePaths = cleanPaths.map { path ->
+            var candidate = path
+            var n = 2
+            while (!used.add(candidate.lowercase())) {
+                val slash = path.lastIndexOf('/')
+                val dot = path.lastIndexOf('.').takeIf { it > slash + 1 } ?: path.length
+                candidate = "${path.substring(0, dot)} ($n)${path.substring(dot)}"
+                n++
+            }
+            candidate
+        }
+
+        pendingExportArchiveResult = result
+        pendingExportArchive = fileIdLists.map { id -> id.map { it.toByte() }.toByteArray() } to uniquePaths
+        pendingExportArchiveFormat = if (format == "tar") {
+            VaultEngine.ARCHIVE_FORMAT_TAR
+        } else {
+            VaultEngine.ARCHIVE_FORMAT_ZIP
+        }
+        val intent = Intent(Intent.ACTION_CREATE_DOCUMENT).apply {
+            addCategory(Intent.CATEGORY_OPENABLE)
+            type = if (format == "tar") "application/x-tar" else "application/zip"
+            putExtra(Intent.EXTRA_TITLE, suggestedName)
+        }
+        isAwaitingActivityResult = true
+        SecureLog.d("VaultPlugin", "handleExportArchive: ${fileIdLists.size} files, format=$format")
+        currentActivity.startActivityForResult(intent, EXPORT_ARCHIVE_REQUEST)
+    }
+
+    /**
+     * Member path as vault_archive_export.c stores it: empty, "." and ".."
+     * components dropped, control characters and backslashes replaced by
+     * '_'. Null when nothing is left.
+     */
+    private fun cleanArchivePath(path: String): String? {
+        val clean = path.split('/')
+            .filter { it.isNotEmpty() && it != "." && it != ".." }
+            .joinToString("/") { segment ->
+                segment.map { c -> if (c < ' ' || c == '\u007F' || c == '\\') '_' else c }
+                    .joinToString("")
+            }
+        return clean.ifEmpty { null }
+    }
+
+    private suspend fun exportArchiveToUri(
+        fileIds: List<ByteArray>,
+        paths: List<String>,
+        format: Int,
+        uri: Uri
+    ): Boolean {
+        val ctx = activity ?: return false
+        val sizes = vaultBridge.listFiles().getOrNull()
+            ?.associate { it.fileId.toList() to it.size }
+            .orEmpty()
+        val totalBytes = fileIds.sumOf { sizes[it.toList()] ?: 0L }
+        emitTransferProgress("export_archive", 0L, totalBytes)
+
+        val pfd = withContext(Dispatchers.IO) {
+            try {
+                ctx.contentResolver.openFileDescriptor(uri, "wt")
+            } catch (e: Exception) {
+                null
+            }
+        }
+        val exported = if (pfd == null) {
+            false
+        } else {
+            // The export reports nothing until it finishes, so progress is
+            // polled from the native byte counter
+            val progressJob = scope.launch {
+                while (isActive) {
+                    delay(ARCHIVE_PROGRESS_INTERVAL_MS)
+                    emitTransferProgress("export_archive", vaultBridge.archiveBytesWritten(), totalBytes)
+                }
+            }
+            try {
+                vaultBridge.exportArchive(pfd.fd, fileIds, paths, format).isSuccess
+            } finally {
+                progressJob.cancel()
+                withContext(Dispatchers.IO) { runCatching { pfd.close() } }
+            }
+        }
+
+        if (exported) {
+            emitTransferProgress("export_archive", totalBytes, totalBytes, isComplete = true)
+            SecureLog.d("VaultPlugin", "exportArchiveToUri: export completed")
+        } else {
+            emitTransferProgress("export_archive", 0L, totalBytes, error = "Export failed")
+            withContext(Dispatchers.IO) {
+                runCatching { DocumentsContract.deleteDocument(ctx.contentResolver, uri) }
+            }
+            SecureLog.e("VaultPlugin", "exportArchiveToUri: export failed")
+        }
+        return exported
+    }
+
+    /**
+     * Hand a vault file to another app without writing plaintext to disk.
+     * The receiver reads it through VaultShareProvider; mode "view" opens it
+     * with ACTION_VIEW, anything else sends it with ACTION_SEND.
+     */
+    private fun handleShareFile(call: MethodCall, result: MethodChannel.Result) {
+        val currentActivity = activity
+        if (currentActivity == null) {
+            result.error("NO_ACTIVITY", "No activity available", null)
+            return
+        }
+        if (!securityManager.isEnvironmentSecure()) {
+            result.error("ENV_BLOCKED", "Environment not supported", null)
+            return
+        }
+
+        val fileIdList = call.argument<List<Int>>("fileId")
+        val mode = call.argument<String>("mode") ?: "send"
+        if (fileIdList == null) {
+            result.error("INVALID_ARGUMENT", "File ID required", null)
+            return
+        }
+        val fileId = fileIdList.map { it.toByte() }.toByteArray()
+
+        scope.launch {
+            val entry = vaultBridge.listFiles().getOrNull()
+                ?.firstOrNull { it.fileId.contentEquals(fileId) }
+            if (entry == null) {
+                result.error("NOT_FOUND", "File not found", null)
+                return@launch
+            }
+            val mimeType = call.argument<String>("mime")
+                ?: entry.mimeType?.takeIf { it.isNotEmpty() }
+                ?: getMimeTypeFromName(entry.name)
+            val uri = VaultShareProvider.share(currentActivity.applicationContext, entry, mimeType)
+
+            val intent = if (mode == "view") {
+                Intent(Intent.ACTION_VIEW).apply { setDataAndType(uri, mimeType) }
+            } else {
+                Intent(Intent.ACTION_SEND).apply {
+                    type = mimeType
+                    putExtra(Intent.EXTRA_STREAM, uri)
+                }
+            }
+            // ClipData carries the grant through the chooser to the receiver
+            intent.clipData = ClipData.newUri(currentActivity.contentResolver, entry.name, uri)
+            intent.addFlags(Intent.FLAG_GRANT_READ_URI_PERMISSION)
+
+            try {
+                currentActivity.startActivity(Intent.createChooser(intent, null))
+                SecureLog.d("VaultPlugin", "handleShareFile: chooser launched, mode=$mode")
+                result.success(true)
+            } catch (e: Exception) {
+                SecureLog.e("VaultPlugin", "handleShareFile: no receiver: ${e.message}")
+                result.error("SHARE_FAILED", "No app can open this file", null)
+            }
+        }
+    }
+
     private fun getMimeTypeFromName(name: String): String {
         val extension = name.substringAfterLast('.', "").lowercase()
         return when (extension) {
@@ -1449,15 +2085,54 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
             "__folder_map__",
             "__folder_map__.tmp",
             "__vault_title__",
-            "__vault_title__.tmp" -> true
-            else -> false
+            "__vault_title__.tmp",
+            "__watched_sources__" -> true
+            else -> isWatchRecordName(name, "__watch_cursor_") ||
+                isWatchRecordName(name, "__watch_delta_")
         }
     }
+
+    // Per-source records of WatchedSourceStore: <prefix><id...>__
+    private fun isWatchRecordName(name: String, prefix: String): Boolean {
+        return name.length > prefix.length + 2 && name.startsWith(prefix) && name.endsWith("__")
+    }
     
     private fun handleGetEntryCount(result: MethodChannel.Result) {
         result.success(vaultBridge.getEntryCount())
     }
     
+    private fun handleGetVaultStats(result: MethodChannel.Result) {
+        scope.launch {
+            vaultBridge.getStats().fold(
+                onSuccess = { stats -> result.success(stats) },
+                onFailure = { e -> result.error("STATS_FAILED", e.message, null) }
+            )
+        }
+    }
+    
+    private fun handleAnalyzeLayout(result: MethodChannel.Result) {
+        scope.launch {
+            vaultBridge.analyzeLayout().fold(
+                onSuccess = { report -> result.success(report) },
+                onFailure = { e -> result.error("LAYOUT_FAILED", e.message, null) }
+            )
+        }
+    }
+    
+    private fun handleSearchFiles(call: MethodCall, result: MethodChannel.Result) {
+        val query = call.argument<String>("query")
+        if (query == null) {
+            result.error("INVALID_ARGUMENT", "Query required", null)
+            return
+        }
+        scope.launch {
+            vaultBridge.searchFiles(query).fold(
+                onSuccess = { ids -> result.success(ids.map { it.toList() }) },
+                onFailure = { e -> result.error("SEARCH_FAILED", e.message, null) }
+            )
+        }
+    }
+
     private fun handleListFiles(result: MethodChannel.Result) {
         scope.launch {
             vaultBridge.listFiles().fold(
@@ -1646,6 +2321,26 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
             return true
         }
         
+        if (requestCode == EXPORT_ARCHIVE_REQUEST) {
+            isAwaitingActivityResult = false
+            val result = pendingExportArchiveResult
+            val selection = pendingExportArchive
+            pendingExportArchiveResult = null
+            pendingExportArchive = null
+
+            if (resultCode == Activity.RESULT_OK && data?.data != null && selection != null) {
+                val uri = data.data!!
+                val format = pendingExportArchiveFormat
+                scope.launch {
+                    val success = exportArchiveToUri(selection.first, selection.second, format, uri)
+                    result?.success(success)
+                }
+            } else {
+                result?.success(false)
+            }
+            return true
+        }
+
         if (requestCode == EXPORT_FILE_REQUEST) {
             SecureLog.d("VaultPlugin", "onActivityResult: EXPORT_FILE_REQUEST received, resultCode=$resultCode")
             isAwaitingActivityResult = false
@@ -2019,9 +2714,17 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
         val surface = Surface(surfaceTexture)
         
         scope.launch {
-            when (val openResult = videoPlayerManager.openVideo(
-                fileId, surface, chunkCount, durationMs, width, height, size
-            )) {
+            val openResult = videoPlayerManager.whileOpening {
+                // The listing Dart passed may predate a background re-chunk
+                val currentChunkCount = vaultBridge.listFiles().getOrNull()
+                    ?.firstOrNull { it.fileId.contentEquals(fileId) }
+                    ?.chunkCount
+                    ?: chunkCount
+                videoPlayerManager.openVideo(
+                    fileId, surface, currentChunkCount, durationMs, width, height, size
+                )
+            }
+            when (openResult) {
                 is VideoOpenResult.Success -> {
                     val actualWidth = openResult.width
                     val actualHeight = openResult.height
@@ -2341,6 +3044,14 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
         // Use pendingExportVaultPath if set (multi-vault), otherwise default vault
         val vaultPath = pendingExportVaultPath ?: VaultEngine.getInstance(ctx).getVaultPath()
         pendingExportVaultPath = null
+        // The exported file must stand alone: pull chunks back from removable storage
+        if (vaultBridge.isVaultOpen() && vaultBridge.getCurrentVaultPath() == vaultPath) {
+            vaultBridge.recallColdData().onFailure { e ->
+                SecureLog.e("VaultPlugin", "copyVaultToUri: cold data recall failed: ${e.message}")
+                emitTransferProgress("export_vault", 0L, 0L, error = "Export failed")
+                return false
+            }
+        }
         val totalBytes = File(vaultPath).length()
         var bytesCopied = 0L
         var lastPercent = -1
@@ -3072,6 +3783,9 @@ class VaultPlugin : FlutterPlugin, MethodChannel.MethodCallHandler, ActivityAwar
                     onSuccess = {
                         currentVaultId = vaultId
                         result.success(true)
+                        scheduleColdMigration()
+                        scheduleLegacyRechunk()
+                        scheduleTextBackfill()
                     },
                     onFailure = { e ->
                         if (e is VaultException && e.isAuthError()) {
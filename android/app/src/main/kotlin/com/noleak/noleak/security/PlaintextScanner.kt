@@ -1,6 +1,7 @@
 package com.noleak.noleak.security
 
 import android.content.Context
+import com.noleak.noleak.vault.VaultEngine
 import java.io.File
 
 /**
@@ -10,8 +11,26 @@ import java.io.File
  */
 object PlaintextScanner {
     
+    // Must match vault_scanner.h
+    private const val SCAN_SIG_JPEG = 1
+    private const val SCAN_SIG_PNG = 2
+    private const val SCAN_SIG_MP4 = 3
+    private const val SCAN_SIG_RIFF = 4
+    private const val SCAN_SIG_MKV = 5
+    private const val SCAN_RESULT_PATTERN = 0x100
+    private const val MAX_SCAN_THREADS = 8
+    
+    private val suspiciousExtensions = listOf(
+        ".txt", ".jpg", ".jpeg", ".png", ".webp",
+        ".mp4", ".mkv", ".tmp", ".bak"
+    )
+    
     /**
      * Scan app storage for any plaintext content
+     * 
+     * Content is scanned natively in a single pass per file (multi-pattern
+     * search plus signature detection) across several threads.
+     * 
      * @param context Application context
      * @param knownPatterns List of byte patterns to search for (e.g., file headers)
      * @return List of files containing plaintext content
@@ -21,24 +40,57 @@ object PlaintextScanner {
         knownPatterns: List<ByteArray> = emptyList()
     ): List<PlaintextFinding> {
         val findings = mutableListOf<PlaintextFinding>()
+        val candidates = mutableListOf<String>()
         
         // Scan internal storage
-        scanDirectory(context.filesDir, knownPatterns, findings)
+        collectDirectory(context.filesDir, candidates, findings)
         
         // Scan cache
-        scanDirectory(context.cacheDir, knownPatterns, findings)
+        collectDirectory(context.cacheDir, candidates, findings)
         
         // Scan external files (if any)
         context.getExternalFilesDir(null)?.let { dir ->
-            scanDirectory(dir, knownPatterns, findings)
+            collectDirectory(dir, candidates, findings)
+        }
+        
+        if (candidates.isEmpty()) return findings
+        
+        val threads = Runtime.getRuntime().availableProcessors().coerceIn(1, MAX_SCAN_THREADS)
+        val results = VaultEngine.getInstance(context)
+            .scanFiles(candidates, knownPatterns.filter { it.isNotEmpty() }, threads)
+            .getOrElse {
+                SecureLog.e("PlaintextScanner", "Native scan failed")
+                candidates.forEach { path ->
+                    findings.add(PlaintextFinding(path = path, reason = "Could not be scanned"))
+                }
+                return findings
+            }
+        
+        for (i in candidates.indices) {
+            val result = results[i]
+            if (result < 0) continue // Ignore read errors
+            
+            if (result and SCAN_RESULT_PATTERN != 0) {
+                findings.add(PlaintextFinding(
+                    path = candidates[i],
+                    reason = "Contains known plaintext pattern"
+                ))
+            }
+            
+            signatureName(result and 0xFF)?.let { signature ->
+                findings.add(PlaintextFinding(
+                    path = candidates[i],
+                    reason = "Detected $signature file signature"
+                ))
+            }
         }
         
         return findings
     }
     
-    private fun scanDirectory(
+    private fun collectDirectory(
         dir: File,
-        patterns: List<ByteArray>,
+        candidates: MutableList<String>,
         findings: MutableList<PlaintextFinding>
     ) {
         if (!dir.exists() || !dir.isDirectory) return
@@ -47,112 +99,32 @@ object PlaintextScanner {
             if (file.isDirectory) {
                 // Skip vault directory (encrypted data is expected there)
                 if (file.name != "vault") {
-                    scanDirectory(file, patterns, findings)
+                    collectDirectory(file, candidates, findings)
                 }
             } else {
-                scanFile(file, patterns, findings)
-            }
-        }
-    }
-    
-    private fun scanFile(
-        file: File,
-        patterns: List<ByteArray>,
-        findings: MutableList<PlaintextFinding>
-    ) {
-        try {
-            // Skip vault.dat (encrypted container)
-            if (file.name == "vault.dat") return
-            
-            // Check file extension for suspicious types
-            val suspiciousExtensions = listOf(
-                ".txt", ".jpg", ".jpeg", ".png", ".webp", 
-                ".mp4", ".mkv", ".tmp", ".bak"
-            )
-            
-            if (suspiciousExtensions.any { file.name.endsWith(it, ignoreCase = true) }) {
-                findings.add(PlaintextFinding(
-                    path = file.absolutePath,
-                    reason = "Suspicious file extension: ${file.extension}"
-                ))
-                return
-            }
-            
-            // Check for known patterns in file content
-            if (patterns.isNotEmpty() && file.length() < 10 * 1024 * 1024) { // Max 10MB
-                val content = file.readBytes()
-                for (pattern in patterns) {
-                    if (containsPattern(content, pattern)) {
-                        findings.add(PlaintextFinding(
-                            path = file.absolutePath,
-                            reason = "Contains known plaintext pattern"
-                        ))
-                        break
-                    }
-                }
-            }
-            
-            // Check for common file signatures (magic bytes)
-            if (file.length() >= 8) {
-                val header = ByteArray(8)
-                file.inputStream().use { it.read(header) }
+                // Skip vault.dat (encrypted container)
+                if (file.name == "vault.dat") return@forEach
                 
-                val signature = detectFileSignature(header)
-                if (signature != null) {
+                // Check file extension for suspicious types
+                if (suspiciousExtensions.any { file.name.endsWith(it, ignoreCase = true) }) {
                     findings.add(PlaintextFinding(
                         path = file.absolutePath,
-                        reason = "Detected $signature file signature"
+                        reason = "Suspicious file extension: ${file.extension}"
                     ))
+                } else {
+                    candidates.add(file.absolutePath)
                 }
             }
-        } catch (e: Exception) {
-            // Ignore read errors
         }
     }
     
-    private fun containsPattern(content: ByteArray, pattern: ByteArray): Boolean {
-        if (pattern.isEmpty() || content.size < pattern.size) return false
-        
-        outer@ for (i in 0..(content.size - pattern.size)) {
-            for (j in pattern.indices) {
-                if (content[i + j] != pattern[j]) continue@outer
-            }
-            return true
-        }
-        return false
-    }
-    
-    private fun detectFileSignature(header: ByteArray): String? {
-        // JPEG
-        if (header[0] == 0xFF.toByte() && header[1] == 0xD8.toByte() && header[2] == 0xFF.toByte()) {
-            return "JPEG"
-        }
-        
-        // PNG
-        if (header[0] == 0x89.toByte() && header[1] == 0x50.toByte() && 
-            header[2] == 0x4E.toByte() && header[3] == 0x47.toByte()) {
-            return "PNG"
-        }
-        
-        // MP4/MOV (ftyp)
-        if (header[4] == 0x66.toByte() && header[5] == 0x74.toByte() && 
-            header[6] == 0x79.toByte() && header[7] == 0x70.toByte()) {
-            return "MP4"
-        }
-        
-        // WebP (RIFF....WEBP)
-        if (header[0] == 0x52.toByte() && header[1] == 0x49.toByte() && 
-            header[2] == 0x46.toByte() && header[3] == 0x46.toByte()) {
-            return "WebP/RIFF"
-        }
-        
-        // MKV (EBML)
-        if (header[0] == 0x1A.toByte() && header[1] == 0x45.toByte() && 
-            header[2] == 0xDF.toByte() && header[3] == 0xA3.toByte()) {
-            return "MKV"
-        }
-        
-        return null
+    private fun signatureName(signature: Int): String? = when (signature) {
+        SCAN_SIG_JPEG -> "JPEG"
+        SCAN_SIG_PNG -> "PNG"
+        SCAN_SIG_MP4 -> "MP4"
+        SCAN_SIG_RIFF -> "WebP/RIFF"
+        SCAN_SIG_MKV -> "MKV"
+        else -> null
     }
 }
 
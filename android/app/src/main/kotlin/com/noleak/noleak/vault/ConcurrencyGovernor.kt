@@ -0,0 +1,197 @@
+package com.noleak.noleak.vault
+
+import android.content.BroadcastReceiver
+import android.content.Context
+import android.content.Intent
+import android.content.IntentFilter
+import android.os.BatteryManager
+import android.os.Build
+import android.os.Handler
+import android.os.Looper
+import android.os.PowerManager
+import androidx.annotation.RequiresApi
+import com.noleak.noleak.security.SecureLog
+import kotlinx.coroutines.delay
+
+/**
+ * ConcurrencyGovernor - Feeds thermal and battery state to the native
+ * concurrency governor (vault_governor.h)
+ *
+ * Heavy jobs (archive import and export, streaming import writes,
+ * plaintext scans, file wipes, re-chunking, folder enumeration) ask the
+ * governor how many workers they may run and how fast they may write.
+ * Pacing only happens outside the vault lock, so playback and viewer
+ * reads are never held back by it. The policy lives in
+ * native code; this class only keeps its signals current:
+ * - Thermal status (Android 10+) and forecast headroom (Android 11+)
+ * - Battery level, charging state and power-save mode
+ *
+ * Without signals (e.g. before start) the device counts as cool.
+ */
+class ConcurrencyGovernor private constructor(private val context: Context) {
+
+    companion object {
+        private const val TAG = "ConcurrencyGovernor"
+
+        // Headroom is polled; the platform rate-limits getThermalHeadroom
+        // to about one call per second and returns NaN when exceeded
+        private const val HEADROOM_POLL_MS = 10_000L
+        private const val HEADROOM_FORECAST_SECONDS = 10
+
+        @Volatile
+        private var instance: ConcurrencyGovernor? = null
+
+        fun getInstance(context: Context): ConcurrencyGovernor {
+            return instance ?: synchronized(this) {
+                instance ?: ConcurrencyGovernor(context.applicationContext).also {
+                    instance = it
+                }
+            }
+        }
+    }
+
+    private val engine = VaultEngine.getInstance(context)
+    private val powerManager = context.getSystemService(Context.POWER_SERVICE) as PowerManager
+    private val handler = Handler(Looper.getMainLooper())
+
+    @Volatile private var thermalHeadroom = -1f
+    @Volatile private var thermalStatus = 0
+    @Volatile private var batteryPercent = -1
+    @Volatile private var charging = false
+    private var started = false
+
+    private val powerReceiver = object : BroadcastReceiver() {
+        override fun onReceive(context: Context, intent: Intent) {
+            if (intent.action == Intent.ACTION_BATTERY_CHANGED) {
+                readBattery(intent)
+            }
+            push()
+        }
+    }
+
+    private var thermalListener: Any? = null
+
+    private val headroomPoll = object : Runnable {
+        override fun run() {
+            if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.R) {
+                readHeadroom()
+                push()
+            }
+            handler.postDelayed(this, HEADROOM_POLL_MS)
+        }
+    }
+
+    /**
+     * Start tracking device state. Call from the main thread.
+     */
+    fun start() {
+        if (started) return
+        started = true
+
+        val filter = IntentFilter().apply {
+            addAction(Intent.ACTION_BATTERY_CHANGED)
+            addAction(PowerManager.ACTION_POWER_SAVE_MODE_CHANGED)
+        }
+        // ACTION_BATTERY_CHANGED is sticky: the current state comes back now
+        context.registerReceiver(powerReceiver, filter)?.let { readBattery(it) }
+
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.Q) {
+            registerThermalListener()
+        }
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.R) {
+            handler.post(headroomPoll)
+        }
+        push()
+        SecureLog.d(TAG, "start: tracking thermal and battery state")
+    }
+
+    /**
+     * Stop tracking; the last pushed signals stay in effect.
+     */
+    fun stop() {
+        if (!started) return
+        started = false
+        handler.removeCallbacks(headroomPoll)
+        try {
+            context.unregisterReceiver(powerReceiver)
+        } catch (e: IllegalArgumentException) {
+            // Not registered
+        }
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.Q) {
+            unregisterThermalListener()
+        }
+    }
+
+    /**
+     * Workers a Kotlin-side job may run now, between 1 and [maxWorkers]
+     */
+    fun workers(maxWorkers: Int): Int {
+        return try {
+            engine.governorWorkers(maxWorkers).coerceIn(1, maxWorkers.coerceAtLeast(1))
+        } catch (e: UnsatisfiedLinkError) {
+            maxWorkers.coerceAtLeast(1)
+        }
+    }
+
+    /**
+     * Wait out the rest of the time [bytes] of bulk I/O should take at the
+     * current rate, given the [elapsedMs] the job already spent on them.
+     * Call between batches, never while holding the vault lock.
+     */
+    suspend fun pace(bytes: Long, elapsedMs: Long) {
+        val rate = try {
+            engine.governorIoRate()
+        } catch (e: UnsatisfiedLinkError) {
+            0L
+        }
+        if (rate <= 0L || bytes <= 0L) return
+        val dueMs = bytes * 1000 / rate
+        if (dueMs > elapsedMs) delay(dueMs - elapsedMs)
+    }
+
+    private fun readBattery(intent: Intent) {
+        val level = intent.getIntExtra(BatteryManager.EXTRA_LEVEL, -1)
+        val scale = intent.getIntExtra(BatteryManager.EXTRA_SCALE, -1)
+        batteryPercent = if (level >= 0 && scale > 0) level * 100 / scale else -1
+        charging = intent.getIntExtra(BatteryManager.EXTRA_PLUGGED, 0) != 0
+    }
+
+    @RequiresApi(Build.VERSION_CODES.Q)
+    private fun registerThermalListener() {
+        val listener = PowerManager.OnThermalStatusChangedListener { status ->
+            thermalStatus = status
+            push()
+        }
+        // Delivered on the main thread; called once right away with the
+        // current status
+        powerManager.addThermalStatusListener(listener)
+        thermalListener = listener
+    }
+
+    @RequiresApi(Build.VERSION_CODES.Q)
+    private fun unregisterThermalListener() {
+        val listener = thermalListener as? PowerManager.OnThermalStatusChangedListener ?: return
+        powerManager.removeThermalStatusListener(listener)
+        thermalListener = null
+    }
+
+    @RequiresApi(Build.VERSION_CODES.R)
+    private fun readHeadroom() {
+        val headroom = powerManager.getThermalHeadroom(HEADROOM_FORECAST_SECONDS)
+        thermalHeadroom = if (headroom.isNaN()) -1f else headroom
+    }
+
+    private fun push() {
+        try {
+            engine.setGovernorSignals(
+                thermalHeadroom,
+                thermalStatus,
+                batteryPercent,
+                charging,
+                powerManager.isPowerSaveMode
+            )
+        } catch (e: UnsatisfiedLinkError) {
+            SecureLog.e(TAG, "push: native governor unavailable")
+        }
+    }
+}
@@ -192,7 +192,13 @@ class SafFileHandler(private val context: Context) {
      * SECURITY: Use streaming for any file > 10MB to prevent OOM
      */
     fun shouldUseStreaming(uri: Uri, mimeType: String): Boolean {
-        val size = getFileSize(uri)
+        return shouldUseStreaming(getFileSize(uri), mimeType)
+    }
+
+    /**
+     * Same as above for a size already known (e.g. from a folder cursor)
+     */
+    fun shouldUseStreaming(size: Long, mimeType: String): Boolean {
         return size > STREAMING_THRESHOLD ||
             !hasDedicatedPreview(mimeType) ||
             (usesBoundedTextPreview(mimeType) && size > TEXT_PREVIEW_LIMIT)
@@ -247,14 +253,19 @@ class SafFileHandler(private val context: Context) {
      * Validate file for import
      */
     fun validateFile(uri: Uri): FileValidationResult {
-        val name = getFileName(uri)
-        val reportedMime = getMimeType(uri)?.lowercase()
+        return validateMetadata(getFileName(uri), getMimeType(uri), getFileSize(uri))
+    }
+
+    /**
+     * Validate metadata that was already queried (no ContentResolver calls)
+     */
+    fun validateMetadata(name: String, reportedType: String?, size: Long): FileValidationResult {
+        val reportedMime = reportedType?.lowercase()
         val mimeType = if (reportedMime.isNullOrBlank() ||
             reportedMime == "application/octet-stream") {
             resolveMimeFromName(name) ?: "application/octet-stream"
         } else reportedMime
 
-        val size = getFileSize(uri)
         if (size < 0L) {
             return FileValidationResult.UnknownSize
         }
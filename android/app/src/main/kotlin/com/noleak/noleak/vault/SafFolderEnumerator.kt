@@ -0,0 +1,391 @@
+package com.noleak.noleak.vault
+
+import android.content.Context
+import android.net.Uri
+import android.provider.DocumentsContract
+import android.provider.DocumentsContract.Document
+import com.noleak.noleak.security.SecureLog
+import kotlinx.coroutines.CancellationException
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.channels.Channel
+import kotlinx.coroutines.channels.ReceiveChannel
+import kotlinx.coroutines.coroutineScope
+import kotlinx.coroutines.launch
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.atomic.AtomicInteger
+import java.util.concurrent.atomic.AtomicLong
+
+/**
+ * SafFolderEnumerator - Walks a SAF document tree for folder import
+ *
+ * PERFORMANCE:
+ * - One child-documents cursor per directory, projecting name, MIME type,
+ *   size and flags together, instead of a ContentResolver query per file
+ *   attribute (DocumentFile issues one per name/isDirectory/size/type call)
+ * - Several directories are listed in parallel, fewer when the
+ *   ConcurrencyGovernor reports a hot device or low battery
+ * - Files are streamed to the caller as they are found, so import starts
+ *   before the walk ends; there is no cap on the file count
+ * - Watched folders are walked against a WatchCursor: directories whose
+ *   last-modified stamp has not moved are not listed again, and only new or
+ *   changed files are returned
+ */
+class SafFolderEnumerator(
+    private val context: Context,
+    private val safFileHandler: SafFileHandler
+) {
+
+    companion object {
+        private const val TAG = "SafFolderEnumerator"
+
+        // Directory listings in flight at once; providers serve each on a
+        // binder thread, so a few are enough to hide per-query latency
+        private const val DIRECTORY_WORKERS = 4
+
+        // Files found ahead of the importer; bounds memory on huge trees
+        private const val ENTRY_BUFFER = 256
+
+        private val PROJECTION = arrayOf(
+            Document.COLUMN_DOCUMENT_ID,
+            Document.COLUMN_DISPLAY_NAME,
+            Document.COLUMN_MIME_TYPE,
+            Document.COLUMN_SIZE,
+            Document.COLUMN_FLAGS,
+            Document.COLUMN_LAST_MODIFIED
+        )
+
+        private val STAMP_PROJECTION = arrayOf(Document.COLUMN_LAST_MODIFIED)
+    }
+
+    /**
+     * One file found in the tree; [folder] is its directory path rooted at
+     * the tree's name. Non-Valid results are files to skip.
+     */
+    class Entry(
+        val uri: Uri,
+        val folder: String,
+        val validation: SafFileHandler.FileValidationResult,
+        internal val change: Change? = null
+    )
+
+    /**
+     * Cursor position of a file returned by a change walk
+     */
+    class Change(
+        val directoryId: String,
+        val documentId: String,
+        val state: WatchCursor.FileState
+    )
+
+    /**
+     * Running totals of the walk, readable while it is in progress
+     */
+    class Totals {
+        val files = AtomicInteger(0)
+        val bytes = AtomicLong(0)
+    }
+
+    /**
+     * One change walk over a watched folder. Report each returned entry to
+     * [resolve] once it has been imported or skipped as not importable; the
+     * cursor from [finish] records only resolved files, and directories with
+     * unresolved files are listed again next time.
+     */
+    class ChangePass internal constructor(internal val previous: WatchCursor) {
+        internal class PassDir(
+            val path: String,
+            val lastModified: Long?,
+            val subdirs: Map<String, String>,
+            val files: ConcurrentHashMap<String, WatchCursor.FileState>,
+            val outstanding: AtomicInteger = AtomicInteger(0)
+        )
+
+        internal val dirs = ConcurrentHashMap<String, PassDir>()
+
+        @Volatile
+        internal var walkComplete = false
+
+        /** Files known from the cursor and found unchanged */
+        val unchangedFiles = AtomicInteger(0)
+
+        fun resolve(entry: Entry) {
+            val change = entry.change ?: return
+            val dir = dirs[change.directoryId] ?: return
+            dir.files[change.documentId] = change.state
+            dir.outstanding.decrementAndGet()
+        }
+
+        /**
+         * The cursor to persist, or null when it would not change. An
+         * interrupted walk keeps the old records of directories it never
+         * reached, so their files are not imported again.
+         */
+        fun finish(): WatchCursor? {
+            val next = WatchCursor()
+            for ((id, dir) in dirs) {
+                next.dirs[id] = WatchCursor.DirState(
+                    path = dir.path,
+                    lastModified = if (dir.outstanding.get() == 0) dir.lastModified else null,
+                    subdirs = dir.subdirs,
+                    files = HashMap(dir.files)
+                )
+            }
+            if (!walkComplete) {
+                for ((id, dir) in previous.dirs) {
+                    next.dirs.putIfAbsent(id, dir)
+                }
+            }
+            return if (next.dirs == previous.dirs) null else next
+        }
+    }
+
+    private class Child(
+        val documentId: String,
+        val name: String,
+        val mimeType: String?,
+        val size: Long?,
+        val flags: Int,
+        val lastModified: Long?
+    )
+
+    /**
+     * Start walking [treeUri] in [scope]. Entries arrive on the returned
+     * channel, which is closed when the walk ends (with the error if a
+     * listing failed). Cancel the channel to stop the walk early.
+     */
+    fun enumerate(
+        scope: CoroutineScope,
+        treeUri: Uri,
+        rootPath: String,
+        totals: Totals
+    ): ReceiveChannel<Entry> {
+        val entries = Channel<Entry>(ENTRY_BUFFER)
+        scope.launch(Dispatchers.IO) {
+            try {
+                walk(treeUri, rootPath, entries, totals)
+                entries.close()
+            } catch (e: CancellationException) {
+                entries.close()
+            } catch (e: Exception) {
+                SecureLog.e(TAG, "enumerate: walk failed: ${e.javaClass.simpleName}")
+                entries.close(e)
+            }
+        }
+        return entries
+    }
+
+    private suspend fun walk(
+        treeUri: Uri,
+        rootPath: String,
+        entries: Channel<Entry>,
+        totals: Totals
+    ) = coroutineScope {
+        val directories = Channel<Pair<String, String>>(Channel.UNLIMITED)
+        // Directories queued or being listed; the walk ends at zero
+        val outstanding = AtomicInteger(1)
+        directories.send(DocumentsContract.getTreeDocumentId(treeUri) to rootPath)
+
+        val workers = ConcurrencyGovernor.getInstance(context).workers(DIRECTORY_WORKERS)
+        repeat(workers) {
+            launch {
+                for ((documentId, path) in directories) {
+                    try {
+                        for (child in listChildren(treeUri, documentId)) {
+                            if (child.mimeType == Document.MIME_TYPE_DIR) {
+                                outstanding.incrementAndGet()
+                                directories.send(child.documentId to "$path/${child.name}")
+                            } else {
+                                entries.send(toEntry(treeUri, child, path, totals))
+                            }
+                        }
+                    } finally {
+                        if (outstanding.decrementAndGet() == 0) {
+                            directories.close()
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Start a change walk of [treeUri] against [cursor]. Only new or changed
+     * files arrive on [ChangePass.entries]; see [enumerate] for the channel
+     * contract.
+     */
+    fun enumerateChanges(
+        scope: CoroutineScope,
+        treeUri: Uri,
+        rootPath: String,
+        cursor: WatchCursor,
+        totals: Totals
+    ): Pair<ChangePass, ReceiveChannel<Entry>> {
+        val pass = ChangePass(cursor)
+        val entries = Channel<Entry>(ENTRY_BUFFER)
+        scope.launch(Dispatchers.IO) {
+            try {
+                walkChanges(treeUri, rootPath, pass, entries, totals)
+                pass.walkComplete = true
+                entries.close()
+            } catch (e: CancellationException) {
+                entries.close()
+            } catch (e: Exception) {
+                SecureLog.e(TAG, "enumerateChanges: walk failed: ${e.javaClass.simpleName}")
+                entries.close(e)
+            }
+        }
+        return pass to entries
+    }
+
+    private class PendingDir(val documentId: String, val path: String, val lastModified: Long?)
+
+    private suspend fun walkChanges(
+        treeUri: Uri,
+        rootPath: String,
+        pass: ChangePass,
+        entries: Channel<Entry>,
+        totals: Totals
+    ) = coroutineScope {
+        val directories = Channel<PendingDir>(Channel.UNLIMITED)
+        val outstanding = AtomicInteger(1)
+        directories.send(PendingDir(DocumentsContract.getTreeDocumentId(treeUri), rootPath, null))
+
+        val workers = ConcurrencyGovernor.getInstance(context).workers(DIRECTORY_WORKERS)
+        repeat(workers) {
+            launch {
+                for (pending in directories) {
+                    try {
+                        val queued = visitChanged(treeUri, pending, pass, entries, totals)
+                        outstanding.addAndGet(queued.size)
+                        for (child in queued) {
+                            directories.send(child)
+                        }
+                    } finally {
+                        if (outstanding.decrementAndGet() == 0) {
+                            directories.close()
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Visit one directory of a change walk; returns its subdirectories
+     */
+    private suspend fun visitChanged(
+        treeUri: Uri,
+        pending: PendingDir,
+        pass: ChangePass,
+        entries: Channel<Entry>,
+        totals: Totals
+    ): List<PendingDir> {
+        val documentId = pending.documentId
+        val previous = pass.previous.dirs[documentId]
+        // The stamp is read before the listing, so anything added while the
+        // directory is listed moves it again and is picked up next time
+        val stamp = pending.lastModified ?: queryLastModified(treeUri, documentId)
+
+        if (previous != null && stamp != null && previous.lastModified == stamp &&
+            previous.path == pending.path) {
+            pass.dirs[documentId] = ChangePass.PassDir(
+                path = pending.path,
+                lastModified = stamp,
+                subdirs = previous.subdirs,
+                files = ConcurrentHashMap(previous.files)
+            )
+            pass.unchangedFiles.addAndGet(previous.files.size)
+            return previous.subdirs.map { (id, name) -> PendingDir(id, "${pending.path}/$name", null) }
+        }
+
+        val children = listChildren(treeUri, documentId)
+        val subdirs = HashMap<String, String>()
+        val queued = ArrayList<PendingDir>()
+        val changed = ArrayList<Child>()
+        val files = ConcurrentHashMap<String, WatchCursor.FileState>()
+        for (child in children) {
+            if (child.mimeType == Document.MIME_TYPE_DIR) {
+                subdirs[child.documentId] = child.name
+                queued.add(PendingDir(child.documentId, "${pending.path}/${child.name}", child.lastModified))
+                continue
+            }
+            val known = previous?.files?.get(child.documentId)
+            if (known != null && known.lastModified == (child.lastModified ?: -1L) &&
+                known.size == (child.size ?: currentSize(treeUri, child))) {
+                files[child.documentId] = known
+                pass.unchangedFiles.incrementAndGet()
+            } else {
+                changed.add(child)
+            }
+        }
+        val dir = ChangePass.PassDir(pending.path, stamp, subdirs, files)
+        dir.outstanding.set(changed.size)
+        pass.dirs[documentId] = dir
+
+        for (child in changed) {
+            entries.send(toEntry(treeUri, child, pending.path, totals, documentId))
+        }
+        return queued
+    }
+
+    // Providers may omit the size in listings; ask the document itself
+    private fun currentSize(treeUri: Uri, child: Child): Long =
+        safFileHandler.getFileSize(DocumentsContract.buildDocumentUriUsingTree(treeUri, child.documentId))
+
+    private fun queryLastModified(treeUri: Uri, documentId: String): Long? {
+        val uri = DocumentsContract.buildDocumentUriUsingTree(treeUri, documentId)
+        return context.contentResolver.query(uri, STAMP_PROJECTION, null, null, null)?.use { cursor ->
+            if (cursor.moveToFirst() && !cursor.isNull(0)) cursor.getLong(0) else null
+        }
+    }
+
+    private fun listChildren(treeUri: Uri, documentId: String): List<Child> {
+        val childrenUri = DocumentsContract.buildChildDocumentsUriUsingTree(treeUri, documentId)
+        val children = ArrayList<Child>()
+        // Read the whole listing up front so the cursor is not held open
+        // while the importer applies backpressure
+        context.contentResolver.query(childrenUri, PROJECTION, null, null, null)?.use { cursor ->
+            while (cursor.moveToNext()) {
+                val id = cursor.getString(0) ?: continue
+                val name = cursor.getString(1) ?: continue
+                children.add(
+                    Child(
+                        documentId = id,
+                        name = name,
+                        mimeType = cursor.getString(2),
+                        size = if (cursor.isNull(3)) null else cursor.getLong(3),
+                        flags = if (cursor.isNull(4)) 0 else cursor.getInt(4),
+                        lastModified = if (cursor.isNull(5)) null else cursor.getLong(5)
+                    )
+                )
+            }
+        } ?: throw IllegalStateException("Folder listing unavailable")
+        return children
+    }
+
+    private fun toEntry(
+        treeUri: Uri,
+        child: Child,
+        folder: String,
+        totals: Totals,
+        directoryId: String? = null
+    ): Entry {
+        val uri = DocumentsContract.buildDocumentUriUsingTree(treeUri, child.documentId)
+        fun change(size: Long?) = directoryId?.let {
+            Change(it, child.documentId, WatchCursor.FileState(size ?: -1L, child.lastModified ?: -1L))
+        }
+        // Virtual documents (e.g. cloud-only files) have no byte stream
+        if (child.flags and Document.FLAG_VIRTUAL_DOCUMENT != 0) {
+            return Entry(uri, folder, SafFileHandler.FileValidationResult.UnknownSize, change(child.size))
+        }
+        // Providers may omit the size; fall back to the descriptor for those
+        val size = child.size ?: safFileHandler.getFileSize(uri)
+        val validation = safFileHandler.validateMetadata(child.name, child.mimeType, size)
+        if (validation is SafFileHandler.FileValidationResult.Valid) {
+            totals.files.incrementAndGet()
+            totals.bytes.addAndGet(validation.size)
+        }
+        return Entry(uri, folder, validation, change(size))
+    }
+}
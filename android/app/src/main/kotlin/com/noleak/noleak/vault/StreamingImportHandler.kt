@@ -2,11 +2,19 @@ package com.noleak.noleak.vault
 
 import android.content.Context
 import android.net.Uri
+import android.os.ParcelFileDescriptor
+import android.system.ErrnoException
+import android.system.Os
+import android.system.OsConstants
 import com.noleak.noleak.security.SecureLog
+import com.noleak.noleak.video.MediaInfoProbe
 import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.channels.Channel
+import kotlinx.coroutines.coroutineScope
 import kotlinx.coroutines.flow.Flow
 import kotlinx.coroutines.flow.flow
 import kotlinx.coroutines.flow.flowOn
+import kotlinx.coroutines.launch
 import kotlinx.coroutines.withContext
 import java.io.InputStream
 import java.security.SecureRandom
@@ -15,7 +23,7 @@ import java.security.SecureRandom
  * StreamingImportHandler - Handles memory-efficient import of large files
  * 
  * SECURITY:
- * - Never holds more than 2 chunks in memory (double buffering)
+ * - Never holds more than PIPELINE_BUFFERS chunks in memory (bounded read-ahead)
  * - Zeroizes plaintext immediately after encryption
  * - Supports resume for interrupted imports
  * - Progress tracking for UI feedback
@@ -24,6 +32,10 @@ class StreamingImportHandler(private val context: Context) {
     
     companion object {
         private const val TAG = "StreamingImportHandler"
+        
+        // Chunk buffers in flight: one being read, one being encrypted,
+        // one spare so the reader never waits on a slow write
+        private const val PIPELINE_BUFFERS = 3
         private val secureRandom = SecureRandom()
         
         fun secureZeroize(data: ByteArray?) {
@@ -33,6 +45,8 @@ class StreamingImportHandler(private val context: Context) {
         }
     }
     
+    private class FilledChunk(val buffer: ByteArray, val length: Int)
+    
     private val vaultEngine = VaultEngine.getInstance(context)
     private val safFileHandler = SafFileHandler(context)
 
@@ -55,6 +69,50 @@ class StreamingImportHandler(private val context: Context) {
             secureZeroize(discard)
         }
     }
+
+    /**
+     * Open the source positioned at [position].
+     * Seekable descriptors are positioned with lseek in constant time; pipes
+     * and other true streams fall back to reading and discarding.
+     * Returns null if the source cannot be opened or ends before [position].
+     */
+    private fun openSourceAt(uri: Uri, position: Long): InputStream? {
+        if (position > 0) {
+            val pfd = try {
+                context.contentResolver.openFileDescriptor(uri, "r")
+            } catch (e: Exception) {
+                null
+            }
+            if (pfd != null) {
+                try {
+                    if (position <= pfd.statSize &&
+                        Os.lseek(pfd.fileDescriptor, position, OsConstants.SEEK_SET) == position) {
+                        return ParcelFileDescriptor.AutoCloseInputStream(pfd)
+                    }
+                } catch (e: ErrnoException) {
+                    SecureLog.d(TAG, "Source is not seekable, skipping sequentially")
+                }
+                pfd.close()
+            }
+        }
+
+        val input = context.contentResolver.openInputStream(uri) ?: return null
+        if (position > 0 && !skipFully(input, position)) {
+            input.close()
+            return null
+        }
+        return input
+    }
+
+    private fun readFully(input: InputStream, buffer: ByteArray, length: Int): Int {
+        var read = 0
+        while (read < length) {
+            val r = input.read(buffer, read, length - read)
+            if (r <= 0) break
+            read += r
+        }
+        return read
+    }
     
     /**
      * Import progress data class
@@ -136,75 +194,109 @@ class StreamingImportHandler(private val context: Context) {
         val initialBytesWritten = resumeFromChunk.toLong() * StreamingConstants.CHUNK_SIZE
         emit(ImportProgress(importId, initialBytesWritten, validation.size, resumeFromChunk, totalChunks))
         
-        // Open input stream and skip to resume position
+        // Open the source at the last written chunk; on resume it is
+        // re-read and compared so a source edited in the middle is caught
         var inputStream: InputStream? = null
         try {
-            inputStream = context.contentResolver.openInputStream(uri)
+            val verifyChunk = resumeFromChunk - 1
+            val startOffset = maxOf(verifyChunk, 0).toLong() * StreamingConstants.CHUNK_SIZE
+            inputStream = openSourceAt(uri, startOffset)
             if (inputStream == null) {
                 emit(ImportProgress(importId, 0, validation.size, 0, totalChunks, 
                     error = "Failed to open file"))
                 return@flow
             }
             
-            // Skip to resume position
-            if (resumeFromChunk > 0) {
-                val skipBytes = resumeFromChunk.toLong() * StreamingConstants.CHUNK_SIZE
-                if (!skipFully(inputStream, skipBytes)) {
+            if (verifyChunk >= 0) {
+                val expected = minOf(StreamingConstants.CHUNK_SIZE.toLong(), validation.size - startOffset).toInt()
+                val sample = ByteArray(StreamingConstants.CHUNK_SIZE)
+                val verified = try {
+                    readFully(inputStream, sample, expected) == expected &&
+                        vaultEngine.streamingVerifyChunk(importId, verifyChunk, sample, expected).isSuccess
+                } finally {
+                    secureZeroize(sample)
+                }
+                if (!verified) {
                     vaultEngine.streamingAbort(importId)
                     emit(ImportProgress(importId, 0, validation.size, 0, totalChunks,
-                        error = "Source file ended before the resume position"))
+                        error = "Source file changed since the import was interrupted"))
                     return@flow
                 }
-                SecureLog.d(TAG, "Skipped $skipBytes bytes for resume")
+                SecureLog.d(TAG, "Resuming at chunk $resumeFromChunk after verifying chunk $verifyChunk")
             }
             
-            // Read and write chunks
-            val buffer = ByteArray(StreamingConstants.CHUNK_SIZE)
+            // Pipelined read/encrypt/write: a reader coroutine fills pooled
+            // chunk buffers from the source while this one hands filled
+            // buffers to native, so source reads overlap AEAD and writeback
+            val source: InputStream = inputStream
+            val pool = List(PIPELINE_BUFFERS) { ByteArray(StreamingConstants.CHUNK_SIZE) }
             var chunkIndex = resumeFromChunk
             var bytesWritten = initialBytesWritten
+            var writeError: String? = null
             
-            while (chunkIndex < totalChunks) {
-                // Read chunk
-                var bytesRead = 0
-                while (bytesRead < StreamingConstants.CHUNK_SIZE) {
-                    val read = inputStream.read(buffer, bytesRead, StreamingConstants.CHUNK_SIZE - bytesRead)
-                    if (read <= 0) break
-                    bytesRead += read
-                }
-                
-                if (bytesRead == 0) break
-                
-                // Create chunk data (may be smaller than buffer for last chunk)
-                val chunkData = if (bytesRead == StreamingConstants.CHUNK_SIZE) {
-                    buffer.copyOf()
-                } else {
-                    buffer.copyOf(bytesRead)
-                }
-                
-                val writeResult = try {
-                    vaultEngine.streamingWriteChunk(importId, chunkData, chunkIndex)
-                } finally {
-                    secureZeroize(chunkData)
-                    secureZeroize(buffer)
-                }
-                
-                if (writeResult.isFailure) {
-                    SecureLog.e(TAG, "Failed to write chunk $chunkIndex: ${writeResult.exceptionOrNull()?.message}")
-                    emit(ImportProgress(importId, bytesWritten, validation.size, chunkIndex, totalChunks,
-                        error = "Failed to write chunk $chunkIndex: ${writeResult.exceptionOrNull()?.message}"))
-                    return@flow
-                }
-                
-                bytesWritten += bytesRead
-                chunkIndex++
-                
-                // Log progress every 10 chunks
-                if (chunkIndex % 10 == 0 || chunkIndex == totalChunks) {
-                    SecureLog.d(TAG, "Chunk progress: $chunkIndex/$totalChunks, bytesWritten=$bytesWritten")
+            try {
+                coroutineScope {
+                    val free = Channel<ByteArray>(PIPELINE_BUFFERS)
+                    val filled = Channel<FilledChunk>(PIPELINE_BUFFERS)
+                    pool.forEach { free.trySend(it) }
+                    
+                    val reader = launch {
+                        try {
+                            for (i in resumeFromChunk until totalChunks) {
+                                val buffer = free.receive()
+                                val bytesRead = readFully(source, buffer, StreamingConstants.CHUNK_SIZE)
+                                if (bytesRead == 0) break
+                                filled.send(FilledChunk(buffer, bytesRead))
+                                if (bytesRead < StreamingConstants.CHUNK_SIZE) break
+                            }
+                        } finally {
+                            filled.close()
+                        }
+                    }
+                    
+                    for (chunk in filled) {
+                        // Native takes the whole array; only a short last chunk is copied
+                        val chunkData = if (chunk.length == StreamingConstants.CHUNK_SIZE) {
+                            chunk.buffer
+                        } else {
+                            chunk.buffer.copyOf(chunk.length)
+                        }
+                        
+                        val writeResult = try {
+                            vaultEngine.streamingWriteChunk(importId, chunkData, chunkIndex)
+                        } finally {
+                            if (chunkData !== chunk.buffer) secureZeroize(chunkData)
+                            secureZeroize(chunk.buffer)
+                        }
+                        free.send(chunk.buffer)
+                        
+                        if (writeResult.isFailure) {
+                            writeError = "Failed to write chunk $chunkIndex: ${writeResult.exceptionOrNull()?.message}"
+                            reader.cancel()
+                            break
+                        }
+                        
+                        bytesWritten += chunk.length
+                        chunkIndex++
+                        
+                        // Log progress every 10 chunks
+                        if (chunkIndex % 10 == 0 || chunkIndex == totalChunks) {
+                            SecureLog.d(TAG, "Chunk progress: $chunkIndex/$totalChunks, bytesWritten=$bytesWritten")
+                        }
+                        
+                        // Emit progress every chunk
+                        emit(ImportProgress(importId, bytesWritten, validation.size, chunkIndex, totalChunks))
+                    }
                 }
-                
-                // Emit progress every chunk
-                emit(ImportProgress(importId, bytesWritten, validation.size, chunkIndex, totalChunks))
+            } finally {
+                pool.forEach { secureZeroize(it) }
+            }
+            
+            writeError?.let { error ->
+                SecureLog.e(TAG, error)
+                emit(ImportProgress(importId, bytesWritten, validation.size, chunkIndex, totalChunks,
+                    error = error))
+                return@flow
             }
 
             if (chunkIndex != totalChunks || bytesWritten != validation.size) {
@@ -215,6 +307,16 @@ class StreamingImportHandler(private val context: Context) {
             }
 
             
+            // Capture playback metadata from the plaintext source so the
+            // player never probes the encrypted copy (best-effort)
+            if (validation.mimeType.startsWith("video/")) {
+                MediaInfoProbe.probe(context, uri)?.let { info ->
+                    vaultEngine.streamingSetMediaInfo(importId, info).onFailure {
+                        SecureLog.w(TAG, "Media metadata not stored: ${it.message}")
+                    }
+                }
+            }
+
             // Finalize import
             SecureLog.d(TAG, "All chunks written, finalizing import... (totalChunks=$totalChunks, bytesWritten=$bytesWritten)")
             val finishResult = vaultEngine.streamingFinish(importId)
@@ -266,19 +368,12 @@ class StreamingImportHandler(private val context: Context) {
             if (fileSize > sampleSize * 2) {
                 val lastBuffer = ByteArray(sampleSize.toInt())
                 lastMb = lastBuffer
-                val lastInput = context.contentResolver.openInputStream(uri)
+                val lastInput = openSourceAt(uri, fileSize - sampleSize)
                     ?: return@withContext null
                 lastInput.use { input ->
-                    if (!skipFully(input, fileSize - sampleSize)) {
+                    if (readFully(input, lastBuffer, lastBuffer.size) != lastBuffer.size) {
                         return@withContext null
                     }
-                    var read = 0
-                    while (read < lastBuffer.size) {
-                        val r = input.read(lastBuffer, read, lastBuffer.size - read)
-                        if (r <= 0) break
-                        read += r
-                    }
-                    if (read != lastBuffer.size) return@withContext null
                 }
             }
 
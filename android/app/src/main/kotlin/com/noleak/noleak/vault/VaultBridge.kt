@@ -1,12 +1,17 @@
 package com.noleak.noleak.vault
 
 import android.content.Context
+import android.os.Environment
 import com.noleak.noleak.security.SecureLog
 import com.noleak.noleak.security.SecurityManager
+import kotlinx.coroutines.CompletableDeferred
 import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.NonCancellable
 import kotlinx.coroutines.sync.Mutex
 import kotlinx.coroutines.sync.withLock
 import kotlinx.coroutines.withContext
+import kotlinx.coroutines.withTimeoutOrNull
+import java.io.File
 import java.security.SecureRandom
 
 /**
@@ -17,9 +22,35 @@ class VaultBridge private constructor(private val context: Context) {
     private val vaultEngine = VaultEngine.getInstance(context)
     private val securityManager = SecurityManager.getInstance(context)
     private val mutex = Mutex()
+    // One archive import at a time: the native side keeps a single stage
+    private val archiveMutex = Mutex()
+    // Held by a running archive export, which reads a snapshot of the index
+    // without [mutex] (see withExportsDrained)
+    private val exportMutex = Mutex()
+
+    @Volatile
+    private var coldStorageAttached = false
+
+    // Group commit: single renames and deletes from concurrent callers are
+    // queued and published as one index commit (see submitMetadataOp)
+    private class PendingMetadataOp(
+        val op: VaultMetadataOp,
+        val done: CompletableDeferred<Result<Unit>> = CompletableDeferred()
+    )
+    private val pendingMetadataOps = ArrayList<PendingMetadataOp>()
+    private var metadataBatchFull: CompletableDeferred<Unit>? = null
     
     companion object {
         private const val MAX_IN_MEMORY_FILE_SIZE = 64L * 1024 * 1024
+        private const val COLD_DIR_NAME = "vault_cold"
+
+        // A batch is published this long after its first operation arrives,
+        // or as soon as it holds GROUP_COMMIT_MAX_OPS operations
+        private const val GROUP_COMMIT_WINDOW_MS = 4L
+        private const val GROUP_COMMIT_MAX_OPS = 64
+
+        // Text entries decrypted and tokenized per backfill call (and lock hold)
+        private const val TEXT_BACKFILL_BATCH = 8
 
         @Volatile
         private var instance: VaultBridge? = null
@@ -75,7 +106,7 @@ class VaultBridge private constructor(private val context: Context) {
             return@withContext Result.failure(SecurityException("Environment not supported"))
         }
         
-        mutex.withLock {
+        withExportsDrained {
             vaultEngine.create(passphrase)
         }
     }
@@ -88,7 +119,7 @@ class VaultBridge private constructor(private val context: Context) {
             return@withContext Result.failure(SecurityException("Environment not supported"))
         }
         
-        mutex.withLock {
+        withExportsDrained {
             val result = vaultEngine.open(passphrase)
             if (result.isSuccess) {
                 // SECURITY: Cleanup stale pending imports (older than 24 hours)
@@ -97,6 +128,7 @@ class VaultBridge private constructor(private val context: Context) {
                 if (cleaned > 0) {
                     SecureLog.i("VaultBridge", "Cleaned up $cleaned stale pending imports")
                 }
+                attachColdStorage()
             }
             result
         }
@@ -106,8 +138,10 @@ class VaultBridge private constructor(private val context: Context) {
      * Close vault
      */
     suspend fun closeVault() = withContext(Dispatchers.IO) {
-        mutex.withLock {
+        VaultShareProvider.revokeAll(context)
+        withExportsDrained {
             vaultEngine.streamingCleanupOld(0)
+            coldStorageAttached = false
             vaultEngine.close()
         }
     }
@@ -144,22 +178,93 @@ class VaultBridge private constructor(private val context: Context) {
         }
     }
 
+    /**
+     * Import a ZIP/TAR archive from an open descriptor; members become
+     * separate files committed together. The archive is read and encrypted
+     * without the vault lock, which is held only to copy and commit it.
+     */
+    suspend fun importArchive(fd: Int): Result<VaultArchiveImport> = withContext(Dispatchers.IO) {
+        if (!checkEnvironment()) {
+            return@withContext Result.failure(SecurityException("Environment not supported"))
+        }
+
+        archiveMutex.withLock {
+            try {
+                vaultEngine.stageArchive(fd).fold(
+                    onSuccess = { mutex.withLock { vaultEngine.commitArchive() } },
+                    onFailure = { Result.failure(it) }
+                )
+            } finally {
+                vaultEngine.discardArchive()
+            }
+        }
+    }
+
+    /**
+     * Progress of the running archive import (source bytes read)
+     */
+    fun archiveBytesRead(): Long = vaultEngine.archiveBytesRead()
+
+    /**
+     * Export files as one archive to an open descriptor. The selection is
+     * snapshotted under the vault lock and streamed without it.
+     */
+    suspend fun exportArchive(
+        fd: Int,
+        fileIds: List<ByteArray>,
+        paths: List<String>,
+        format: Int
+    ): Result<Unit> = withContext(Dispatchers.IO) {
+        if (!checkEnvironment()) {
+            return@withContext Result.failure(SecurityException("Environment not supported"))
+        }
+
+        exportMutex.withLock {
+            try {
+                mutex.withLock { vaultEngine.prepareExport(fileIds, paths) }.fold(
+                    onSuccess = { vaultEngine.writeExport(fd, format) },
+                    onFailure = { Result.failure(it) }
+                )
+            } finally {
+                vaultEngine.discardExport()
+            }
+        }
+    }
+
+    /**
+     * Run [block] under [mutex] once no archive export is running. For
+     * operations that move or drop committed ciphertext, or replace the open
+     * vault, which an export's snapshot still points at.
+     */
+    private suspend fun <T> withExportsDrained(block: suspend () -> T): T =
+        exportMutex.withLock { mutex.withLock { block() } }
+
+    /**
+     * Progress of the running archive export (plaintext bytes written)
+     */
+    fun archiveBytesWritten(): Long = vaultEngine.archiveBytesWritten()
+
     /**
      * Copy file (re-encrypts to new file ID)
+     *
+     * Chunked files are copied through a streaming import: each chunk is
+     * read under the lock and written outside it, where the import paces
+     * itself to the concurrency governor. Reading a chunk refreshes the
+     * file's access time, which keeps re-chunking off it meanwhile.
      */
     suspend fun copyFile(fileId: ByteArray): Result<ByteArray> = withContext(Dispatchers.IO) {
         if (!checkEnvironment()) {
             return@withContext Result.failure(SecurityException("Environment not supported"))
         }
 
-        mutex.withLock {
+        val (entry, importId) = mutex.withLock {
             val entriesResult = vaultEngine.listFiles()
             if (entriesResult.isFailure) {
-                return@withLock Result.failure(entriesResult.exceptionOrNull() ?: VaultException("List failed", VaultEngine.VAULT_ERR_IO))
+                return@withContext Result.failure(entriesResult.exceptionOrNull() ?: VaultException("List failed", VaultEngine.VAULT_ERR_IO))
             }
             val entry = entriesResult.getOrNull()
                 ?.firstOrNull { it.fileId.contentEquals(fileId) }
-                ?: return@withLock Result.failure(VaultException("File not found", VaultEngine.VAULT_ERR_NOT_FOUND))
+                ?: return@withContext Result.failure(VaultException("File not found", VaultEngine.VAULT_ERR_NOT_FOUND))
 
             // FIX: Check if file is chunked first, not just file type
             // Large files imported via streaming are chunked regardless of type
@@ -170,17 +275,17 @@ class VaultBridge private constructor(private val context: Context) {
                 // Non-chunked file: read all data and re-import
                 val dataResult = vaultEngine.readFile(fileId)
                 if (dataResult.isFailure) {
-                    return@withLock Result.failure(dataResult.exceptionOrNull() ?: VaultException("Read failed", VaultEngine.VAULT_ERR_IO))
+                    return@withContext Result.failure(dataResult.exceptionOrNull() ?: VaultException("Read failed", VaultEngine.VAULT_ERR_IO))
                 }
                 val data = dataResult.getOrThrow()
                 val importResult = vaultEngine.importFile(data, entry.type, entry.name, entry.mimeType)
                 VaultEngine.secureZeroize(data)
-                return@withLock importResult
+                return@withContext importResult
             }
 
             // Chunked file: use streaming copy
             if (entry.size <= 0) {
-                return@withLock Result.failure(VaultException("Invalid chunked entry", VaultEngine.VAULT_ERR_INVALID_PARAM))
+                return@withContext Result.failure(VaultException("Invalid chunked entry", VaultEngine.VAULT_ERR_INVALID_PARAM))
             }
 
             val sourceHash = ByteArray(32).also { SecureRandom().nextBytes(it) }
@@ -194,57 +299,57 @@ class VaultBridge private constructor(private val context: Context) {
                 fileSize = entry.size
             )
             if (startResult.isFailure) {
-                return@withLock Result.failure(startResult.exceptionOrNull() ?: VaultException("Copy start failed", StreamingConstants.ERR_IO))
+                return@withContext Result.failure(startResult.exceptionOrNull() ?: VaultException("Copy start failed", StreamingConstants.ERR_IO))
             }
-            val importId = startResult.getOrThrow().importId
+            entry to startResult.getOrThrow().importId
+        }
 
-            val buffer = ByteArray(StreamingConstants.CHUNK_SIZE)
-            var buffered = 0
-            var targetChunkIndex = 0
-            try {
-                for (i in 0 until entry.chunkCount) {
-                    val chunkResult = vaultEngine.readChunk(fileId, i)
-                    if (chunkResult.isFailure) {
-                        vaultEngine.streamingAbort(importId)
-                        return@withLock Result.failure(chunkResult.exceptionOrNull() ?: VaultException("Chunk read failed", VaultEngine.VAULT_ERR_IO))
-                    }
-                    val chunk = chunkResult.getOrThrow()
-                    var offset = 0
-                    while (offset < chunk.size) {
-                        val remaining = StreamingConstants.CHUNK_SIZE - buffered
-                        val toCopy = minOf(remaining, chunk.size - offset)
-                        System.arraycopy(chunk, offset, buffer, buffered, toCopy)
-                        buffered += toCopy
-                        offset += toCopy
-                        if (buffered == StreamingConstants.CHUNK_SIZE) {
-                            val outChunk = buffer.copyOf(buffered)
-                            val writeResult = vaultEngine.streamingWriteChunk(importId, outChunk, targetChunkIndex)
-                            VaultEngine.secureZeroize(outChunk)
-                            if (writeResult.isFailure) {
-                                vaultEngine.streamingAbort(importId)
-                                return@withLock Result.failure(writeResult.exceptionOrNull() ?: VaultException("Chunk write failed", StreamingConstants.ERR_IO))
-                            }
-                            targetChunkIndex++
-                            buffered = 0
+        val buffer = ByteArray(StreamingConstants.CHUNK_SIZE)
+        var buffered = 0
+        var targetChunkIndex = 0
+        try {
+            for (i in 0 until entry.chunkCount) {
+                val chunkResult = mutex.withLock { vaultEngine.readChunk(fileId, i) }
+                if (chunkResult.isFailure) {
+                    vaultEngine.streamingAbort(importId)
+                    return@withContext Result.failure(chunkResult.exceptionOrNull() ?: VaultException("Chunk read failed", VaultEngine.VAULT_ERR_IO))
+                }
+                val chunk = chunkResult.getOrThrow()
+                var offset = 0
+                while (offset < chunk.size) {
+                    val remaining = StreamingConstants.CHUNK_SIZE - buffered
+                    val toCopy = minOf(remaining, chunk.size - offset)
+                    System.arraycopy(chunk, offset, buffer, buffered, toCopy)
+                    buffered += toCopy
+                    offset += toCopy
+                    if (buffered == StreamingConstants.CHUNK_SIZE) {
+                        val outChunk = buffer.copyOf(buffered)
+                        val writeResult = vaultEngine.streamingWriteChunk(importId, outChunk, targetChunkIndex)
+                        VaultEngine.secureZeroize(outChunk)
+                        if (writeResult.isFailure) {
+                            vaultEngine.streamingAbort(importId)
+                            return@withContext Result.failure(writeResult.exceptionOrNull() ?: VaultException("Chunk write failed", StreamingConstants.ERR_IO))
                         }
+                        targetChunkIndex++
+                        buffered = 0
                     }
-                    VaultEngine.secureZeroize(chunk)
                 }
+                VaultEngine.secureZeroize(chunk)
+            }
 
-                if (buffered > 0) {
-                    val outChunk = buffer.copyOf(buffered)
-                    val writeResult = vaultEngine.streamingWriteChunk(importId, outChunk, targetChunkIndex)
-                    VaultEngine.secureZeroize(outChunk)
-                    if (writeResult.isFailure) {
-                        vaultEngine.streamingAbort(importId)
-                        return@withLock Result.failure(writeResult.exceptionOrNull() ?: VaultException("Chunk write failed", StreamingConstants.ERR_IO))
-                    }
+            if (buffered > 0) {
+                val outChunk = buffer.copyOf(buffered)
+                val writeResult = vaultEngine.streamingWriteChunk(importId, outChunk, targetChunkIndex)
+                VaultEngine.secureZeroize(outChunk)
+                if (writeResult.isFailure) {
+                    vaultEngine.streamingAbort(importId)
+                    return@withContext Result.failure(writeResult.exceptionOrNull() ?: VaultException("Chunk write failed", StreamingConstants.ERR_IO))
                 }
-
-                return@withLock vaultEngine.streamingFinish(importId)
-            } finally {
-                VaultEngine.secureZeroize(buffer)
             }
+
+            mutex.withLock { vaultEngine.streamingFinish(importId) }
+        } finally {
+            VaultEngine.secureZeroize(buffer)
         }
     }
 
@@ -371,84 +476,28 @@ class VaultBridge private constructor(private val context: Context) {
                     ))
                 }
                 
-                // If chunked, read all chunks
+                // If chunked, read all chunks in one batch
                 if (entry.chunkCount > 0) {
-                    try {
-                        val chunks = mutableListOf<ByteArray>()
-                        var readSize = 0
-                        
-                        for (i in 0 until entry.chunkCount) {
-                            val chunkResult = vaultEngine.readChunk(fileId, i)
-                            if (chunkResult.isFailure) {
-                                chunks.forEach { VaultEngine.secureZeroize(it) }
-                                return@withLock Result.failure(chunkResult.exceptionOrNull() ?: VaultException("Chunk read failed", VaultEngine.VAULT_ERR_IO))
-                            }
-                            val chunk = chunkResult.getOrThrow()
-                            chunks.add(chunk)
-                            readSize += chunk.size
-                        }
-                        
-                        val combined = ByteArray(readSize)
-                        var offset = 0
-                        for (chunk in chunks) {
-                            System.arraycopy(chunk, 0, combined, offset, chunk.size)
-                            offset += chunk.size
-                            VaultEngine.secureZeroize(chunk)
-                        }
-                        
-                        return@withLock Result.success(TextPreviewResult(
-                            data = combined,
+                    return@withLock readPreviewChunks(fileId, entry.chunkCount, totalSize.toInt()).map { data ->
+                        TextPreviewResult(
+                            data = data,
                             truncated = false,
                             totalSize = totalSize
-                        ))
-                    } catch (e: Exception) {
-                        return@withLock Result.failure(VaultException("Read failed: ${e.message}", VaultEngine.VAULT_ERR_IO))
+                        )
                     }
                 }
                 
                 return@withLock Result.failure(result.exceptionOrNull() ?: VaultException("Read failed", VaultEngine.VAULT_ERR_IO))
             }
             
-            // File is larger than maxBytes - read only first chunks up to limit
+            // File is larger than maxBytes - read only the chunks up to limit
             if (entry.chunkCount > 0) {
-                try {
-                    val chunks = mutableListOf<ByteArray>()
-                    var readSize = 0
-                    
-                    for (i in 0 until entry.chunkCount) {
-                        if (readSize >= maxBytes) break
-                        
-                        val chunkResult = vaultEngine.readChunk(fileId, i)
-                        if (chunkResult.isFailure) {
-                            chunks.forEach { VaultEngine.secureZeroize(it) }
-                            return@withLock Result.failure(chunkResult.exceptionOrNull() ?: VaultException("Chunk read failed", VaultEngine.VAULT_ERR_IO))
-                        }
-                        val chunk = chunkResult.getOrThrow()
-                        chunks.add(chunk)
-                        readSize += chunk.size
-                    }
-                    
-                    // Combine and truncate to maxBytes
-                    val actualSize = minOf(readSize, maxBytes)
-                    val combined = ByteArray(actualSize)
-                    var offset = 0
-                    for (chunk in chunks) {
-                        val toCopy = minOf(chunk.size, actualSize - offset)
-                        if (toCopy > 0) {
-                            System.arraycopy(chunk, 0, combined, offset, toCopy)
-                            offset += toCopy
-                        }
-                        VaultEngine.secureZeroize(chunk)
-                        if (offset >= actualSize) break
-                    }
-                    
-                    return@withLock Result.success(TextPreviewResult(
-                        data = combined,
+                return@withLock readPreviewChunks(fileId, entry.chunkCount, maxBytes).map { data ->
+                    TextPreviewResult(
+                        data = data,
                         truncated = true,
                         totalSize = totalSize
-                    ))
-                } catch (e: Exception) {
-                    return@withLock Result.failure(VaultException("Read failed: ${e.message}", VaultEngine.VAULT_ERR_IO))
+                    )
                 }
             }
             
@@ -457,6 +506,31 @@ class VaultBridge private constructor(private val context: Context) {
         }
     }
     
+    /**
+     * Batch-read the leading chunks of a file into a buffer of at most
+     * [maxBytes], trimmed to the bytes actually written.
+     * Must be called with [mutex] held.
+     */
+    private fun readPreviewChunks(fileId: ByteArray, chunkCount: Int, maxBytes: Int): Result<ByteArray> {
+        val combined = ByteArray(maxBytes)
+        return try {
+            val written = vaultEngine.readChunks(fileId, 0, chunkCount, combined).getOrElse { e ->
+                VaultEngine.secureZeroize(combined)
+                return Result.failure(e)
+            }
+            if (written == combined.size) {
+                Result.success(combined)
+            } else {
+                val data = combined.copyOf(written)
+                VaultEngine.secureZeroize(combined)
+                Result.success(data)
+            }
+        } catch (e: Exception) {
+            VaultEngine.secureZeroize(combined)
+            Result.failure(VaultException("Read failed: ${e.message}", VaultEngine.VAULT_ERR_IO))
+        }
+    }
+
     /**
      * Read video chunk (with security check)
      */
@@ -469,28 +543,161 @@ class VaultBridge private constructor(private val context: Context) {
             vaultEngine.readChunk(fileId, chunkIndex)
         }
     }
-    
+
     /**
-     * Delete file
+     * Read a run of chunks into one buffer (with security check)
      */
-    suspend fun deleteFile(fileId: ByteArray): Result<Unit> = withContext(Dispatchers.IO) {
+    suspend fun readChunks(
+        fileId: ByteArray,
+        firstChunk: Int,
+        chunkCount: Int,
+        out: ByteArray,
+        outOffset: Int = 0,
+        length: Int = out.size - outOffset
+    ): Result<Int> = withContext(Dispatchers.IO) {
+        if (!checkEnvironment()) {
+            return@withContext Result.failure(SecurityException("Environment not supported"))
+        }
+        mutex.withLock {
+            vaultEngine.readChunks(fileId, firstChunk, chunkCount, out, outOffset, length)
+        }
+    }
+
+    /**
+     * Read a plaintext byte range of a file (with security check)
+     */
+    suspend fun readRange(
+        fileId: ByteArray,
+        offset: Long,
+        out: ByteArray,
+        outOffset: Int = 0,
+        length: Int = out.size - outOffset
+    ): Result<Int> = withContext(Dispatchers.IO) {
+        if (!checkEnvironment()) {
+            return@withContext Result.failure(SecurityException("Environment not supported"))
+        }
+        mutex.withLock {
+            vaultEngine.readRange(fileId, offset, out, outOffset, length)
+        }
+    }
+
+    /**
+     * Get media metadata stored in the index (null if never recorded)
+     */
+    suspend fun getMediaInfo(fileId: ByteArray): VaultMediaInfo? = withContext(Dispatchers.IO) {
+        if (!checkEnvironment()) {
+            return@withContext null
+        }
+        mutex.withLock {
+            vaultEngine.getMediaInfo(fileId)
+        }
+    }
+
+    /**
+     * Record media metadata for an entry (one index commit)
+     */
+    suspend fun setMediaInfo(fileId: ByteArray, info: VaultMediaInfo): Result<Unit> = withContext(Dispatchers.IO) {
         if (!checkEnvironment()) {
             return@withContext Result.failure(SecurityException("Environment not supported"))
         }
         mutex.withLock {
-            vaultEngine.deleteFile(fileId)
+            vaultEngine.setMediaInfo(fileId, info)
         }
     }
 
+    /**
+     * Delete file
+     * Group-committed with other renames/deletes arriving at the same time.
+     */
+    suspend fun deleteFile(fileId: ByteArray): Result<Unit> = withContext(Dispatchers.IO) {
+        if (!checkEnvironment()) {
+            return@withContext Result.failure(SecurityException("Environment not supported"))
+        }
+        submitMetadataOp(VaultMetadataOp(fileId.copyOf(), null))
+    }
+
     /**
      * Rename a file
+     * Group-committed with other renames/deletes arriving at the same time.
      */
     suspend fun renameFile(fileId: ByteArray, newName: String): Result<Unit> = withContext(Dispatchers.IO) {
+        if (!checkEnvironment()) {
+            return@withContext Result.failure(SecurityException("Environment not supported"))
+        }
+        submitMetadataOp(VaultMetadataOp(fileId.copyOf(), newName))
+    }
+
+    /**
+     * Queue a metadata operation and wait until the index commit carrying it
+     * is durable. The first caller of a batch leads it: it holds the window
+     * open briefly, then publishes everything queued so far in one commit.
+     * Operations that queue up while the leader waits for the vault lock join
+     * the same commit, so bursts cost one commit instead of one each.
+     */
+    private suspend fun submitMetadataOp(op: VaultMetadataOp): Result<Unit> {
+        val pending = PendingMetadataOp(op)
+        var batchFull: CompletableDeferred<Unit>? = null
+        synchronized(pendingMetadataOps) {
+            pendingMetadataOps.add(pending)
+            if (pendingMetadataOps.size == 1) {
+                batchFull = CompletableDeferred<Unit>().also { metadataBatchFull = it }
+            } else if (pendingMetadataOps.size >= GROUP_COMMIT_MAX_OPS) {
+                metadataBatchFull?.complete(Unit)
+            }
+        }
+
+        batchFull?.let { full ->
+            // The batch must be published even if the leader is cancelled,
+            // or every caller that joined it would wait forever
+            withContext(NonCancellable) {
+                withTimeoutOrNull(GROUP_COMMIT_WINDOW_MS) { full.await() }
+                mutex.withLock {
+                    val batch = synchronized(pendingMetadataOps) {
+                        val taken = ArrayList(pendingMetadataOps)
+                        pendingMetadataOps.clear()
+                        metadataBatchFull = null
+                        taken
+                    }
+                    try {
+                        val results = vaultEngine.commitMetadataOps(batch.map { it.op })
+                        batch.forEachIndexed { i, queued -> queued.done.complete(results[i]) }
+                        if (batch.size > 1) {
+                            SecureLog.d("VaultBridge", "Group commit: ${batch.size} operations")
+                        }
+                    } catch (e: Throwable) {
+                        // Errors too (native link, out of memory): every
+                        // caller that joined must still be answered.
+                        // complete() is a no-op for ops already answered.
+                        SecureLog.e("VaultBridge", "Group commit failed: ${e.javaClass.simpleName}")
+                        batch.forEach { it.done.complete(Result.failure(e)) }
+                    }
+                }
+            }
+        }
+        return pending.done.await()
+    }
+    
+    /**
+     * Delete several files with one index commit
+     */
+    suspend fun deleteFiles(fileIds: List<ByteArray>): Result<Unit> = withContext(Dispatchers.IO) {
+        if (!checkEnvironment()) {
+            return@withContext Result.failure(SecurityException("Environment not supported"))
+        }
+        mutex.withLock {
+            vaultEngine.deleteFiles(fileIds)
+        }
+    }
+
+    /**
+     * Rename several files with one index commit
+     */
+    suspend fun renameFiles(fileIds: List<ByteArray>, newNames: List<String>): Result<Unit> = withContext(Dispatchers.IO) {
         if (!checkEnvironment()) {
             return@withContext Result.failure(SecurityException("Environment not supported"))
         }
         mutex.withLock {
-            vaultEngine.renameFile(fileId, newName)
+            vaultEngine.renameFiles(fileIds, newNames)
         }
     }
     
@@ -501,11 +708,64 @@ class VaultBridge private constructor(private val context: Context) {
         if (!checkEnvironment()) {
             return@withContext Result.failure(SecurityException("Environment not supported"))
         }
-        mutex.withLock {
+        withExportsDrained {
             vaultEngine.compact()
         }
     }
     
+    /**
+     * Full-text search over the term index; text without terms yet is
+     * picked up by the background backfill (see indexPendingText)
+     */
+    suspend fun searchFiles(query: String): Result<List<ByteArray>> = withContext(Dispatchers.IO) {
+        if (!checkEnvironment()) {
+            return@withContext Result.failure(SecurityException("Environment not supported"))
+        }
+        mutex.withLock {
+            vaultEngine.searchFiles(query)
+        }
+    }
+
+    /**
+     * Index one batch of text entries without search terms, resuming a pass
+     * at [start]. The lock is held for this batch only; unreadable entries
+     * are skipped so they never hold up the rest.
+     * @return Position to resume from, or null once the pass is complete
+     */
+    suspend fun indexPendingText(start: Int): Result<Int?> = withContext(Dispatchers.IO) {
+        if (!checkEnvironment()) {
+            return@withContext Result.failure(SecurityException("Environment not supported"))
+        }
+        mutex.withLock {
+            vaultEngine.indexPendingText(start, TEXT_BACKFILL_BATCH)
+        }
+    }
+
+    /**
+     * Get vault statistics
+     */
+    suspend fun getStats(): Result<Map<String, Any>> = withContext(Dispatchers.IO) {
+        if (!checkEnvironment()) {
+            return@withContext Result.failure(SecurityException("Environment not supported"))
+        }
+        mutex.withLock {
+            vaultEngine.getStats()
+        }
+    }
+    
+    /**
+     * Container layout report (see VaultEngine.analyzeLayout). Holds the
+     * vault lock for the whole index walk.
+     */
+    suspend fun analyzeLayout(): Result<Map<String, Any>> = withContext(Dispatchers.IO) {
+        if (!checkEnvironment()) {
+            return@withContext Result.failure(SecurityException("Environment not supported"))
+        }
+        mutex.withLock {
+            vaultEngine.analyzeLayout()
+        }
+    }
+    
     /**
      * Get entry count
      */
@@ -545,7 +805,7 @@ class VaultBridge private constructor(private val context: Context) {
         if (!checkEnvironment()) {
             return@withContext Result.failure(SecurityException("Environment not supported"))
         }
-        mutex.withLock {
+        withExportsDrained {
             vaultEngine.changePassword(currentPassword, newPassword)
         }
     }
@@ -560,7 +820,7 @@ class VaultBridge private constructor(private val context: Context) {
             return@withContext Result.failure(SecurityException("Environment not supported"))
         }
         
-        mutex.withLock {
+        withExportsDrained {
             vaultEngine.createAtPath(path, passphrase)
         }
     }
@@ -573,8 +833,93 @@ class VaultBridge private constructor(private val context: Context) {
             return@withContext Result.failure(SecurityException("Environment not supported"))
         }
         
+        withExportsDrained {
+            val result = vaultEngine.openAtPath(path, passphrase)
+            if (result.isSuccess) {
+                attachColdStorage()
+            }
+            result
+        }
+    }
+
+    /**
+     * Point the open vault at its cold segment on removable storage, if any.
+     * Without one (no SD card, or a segment from another vault) tiering stays off.
+     * Must be called with [mutex] held.
+     */
+    private fun attachColdStorage() {
+        val coldDir = context.getExternalFilesDirs(null)
+            .drop(1)
+            .firstOrNull { dir ->
+                dir != null &&
+                    Environment.getExternalStorageState(dir) == Environment.MEDIA_MOUNTED &&
+                    Environment.isExternalStorageRemovable(dir)
+            }
+            ?.let { File(it, COLD_DIR_NAME) }
+            ?.takeIf { it.isDirectory || it.mkdirs() }
+
+        coldStorageAttached = vaultEngine.setColdDir(coldDir?.absolutePath)
+            .onFailure {
+                SecureLog.w("VaultBridge", "Cold storage unavailable: ${it.message}")
+                vaultEngine.setColdDir(null)
+            }
+            .isSuccess && coldDir != null
+    }
+
+    /**
+     * Move chunks of files unread for [coldDays] to removable storage, at most
+     * [maxBytes] per call so other operations are not held off for long
+     * @return Ciphertext bytes moved (0 when nothing is cold or tiering is off)
+     */
+    suspend fun migrateColdData(
+        coldDays: Int = 30,
+        maxBytes: Long = 256L * 1024 * 1024
+    ): Result<Long> = withContext(Dispatchers.IO) {
+        if (!checkEnvironment()) {
+            return@withContext Result.failure(SecurityException("Environment not supported"))
+        }
+        withExportsDrained {
+            if (!coldStorageAttached) {
+                Result.success(0L)
+            } else {
+                vaultEngine.migrateColdData(coldDays, maxBytes)
+            }
+        }
+    }
+
+    /**
+     * Bring every cold chunk back into the container file
+     * @return Number of files recalled
+     */
+    suspend fun recallColdData(): Result<Int> = withContext(Dispatchers.IO) {
+        if (!checkEnvironment()) {
+            return@withContext Result.failure(SecurityException("Environment not supported"))
+        }
+        withExportsDrained {
+            vaultEngine.recallColdData()
+        }
+    }
+
+    /**
+     * Move one file imported with 1 MB chunks to the 4 MB layout of
+     * streaming imports. Files read within [idleMs] are left for a later
+     * pass. One file per call keeps the lock short; the caller paces
+     * between calls, after the lock is released.
+     * [canStart] is asked while the lock is held, right before converting.
+     * @return Bytes converted (0 when nothing is left), or null when
+     *   [canStart] declined
+     */
+    suspend fun rechunkLegacyFiles(
+        idleMs: Long = 10 * 60 * 1000L,
+        canStart: () -> Boolean = { true }
+    ): Result<Long?> = withContext(Dispatchers.IO) {
+        if (!checkEnvironment()) {
+            return@withContext Result.failure(SecurityException("Environment not supported"))
+        }
         mutex.withLock {
-            vaultEngine.openAtPath(path, passphrase)
+            if (!canStart()) return@withLock Result.success(null)
+            // Any byte budget stops after the first converted file
+            vaultEngine.rechunkLegacy(idleMs, 1L)
         }
     }
 }
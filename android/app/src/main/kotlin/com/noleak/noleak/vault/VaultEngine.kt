@@ -33,6 +33,27 @@ class VaultEngine private constructor(private val context: Context) {
         // Minimum passphrase length
         const val MIN_PASSPHRASE_LENGTH = 12
         
+        // Largest-file slots reported by getStats (must match vault_engine.h)
+        const val STATS_LARGEST_FILES = 5
+
+        // Metadata operation kinds (must match VAULT_META_OP_*)
+        const val META_OP_RENAME = 1
+        const val META_OP_DELETE = 2
+
+        // Search result cap (must match VAULT_SEARCH_MAX_RESULTS)
+        const val SEARCH_MAX_RESULTS = 1000
+
+        // Layout report packing (must match vault_jni.c / vault_layout.h)
+        private const val LAYOUT_HEADER_VALUES = 14
+        private const val LAYOUT_INDEX_VALUES = 3
+        private const val LAYOUT_INDEX_RECORDS = 2
+        private const val LAYOUT_ENTRY_VALUES = 11
+        private const val LAYOUT_DEAD_BUCKETS = 32
+
+        // Archive export formats (must match vault_archive.h)
+        const val ARCHIVE_FORMAT_ZIP = 0
+        const val ARCHIVE_FORMAT_TAR = 1
+        
         // SECURITY: Secure random for zeroization
         private val secureRandom = java.security.SecureRandom()
         
@@ -80,19 +101,46 @@ class VaultEngine private constructor(private val context: Context) {
     private external fun nativeImportFile(data: ByteArray, type: Int, name: String, mime: String?): ByteArray?
     private external fun nativeReadFile(fileId: ByteArray): ByteArray?
     private external fun nativeReadChunk(fileId: ByteArray, chunkIndex: Int): ByteArray?
+    private external fun nativeReadChunks(fileId: ByteArray, firstChunk: Int, chunkCount: Int, out: ByteArray, outOffset: Int, length: Int): Int
+    private external fun nativeReadRange(fileId: ByteArray, offset: Long, out: ByteArray, outOffset: Int, length: Int): Int
     private external fun nativeDeleteFile(fileId: ByteArray): Int
     private external fun nativeRenameFile(fileId: ByteArray, name: String): Int
+    private external fun nativeDeleteFiles(fileIds: ByteArray): Int
+    private external fun nativeRenameFiles(fileIds: ByteArray, names: Array<String>): Int
+    private external fun nativeCommitMetadataOps(kinds: ByteArray, fileIds: ByteArray, names: Array<String?>): IntArray?
     private external fun nativeCompact(): Int
+    private external fun nativeTierSetColdDir(dir: String?): Int
+    private external fun nativeTierMigrate(coldDays: Int, maxBytes: Long): Long
+    private external fun nativeTierRecallAll(): Int
+    private external fun nativeRechunkLegacy(idleMs: Long, maxBytes: Long): Long
+    private external fun nativeGetStats(largestIds: ByteArray): LongArray?
+    private external fun nativeAnalyzeLayout(statusOut: IntArray): LongArray?
+    private external fun nativeSearchFiles(query: String, maxResults: Int, statusOut: IntArray): ByteArray?
+    private external fun nativeIndexPendingText(start: Int, maxFiles: Int, statusOut: IntArray): Int
+    private external fun nativeSetMediaInfo(fileId: ByteArray, values: LongArray, videoCodec: String?, audioCodec: String?): Int
+    private external fun nativeGetMediaInfo(fileId: ByteArray, codecsOut: Array<String?>): LongArray?
     private external fun nativeGetEntryCount(): Int
     private external fun nativeListFiles(): Array<VaultFileEntry>?
+    private external fun nativeStageArchive(fd: Int): Int
+    private external fun nativeCommitArchive(statusOut: IntArray): Array<VaultArchiveMember>?
+    private external fun nativeDiscardArchive()
+    private external fun nativeArchiveBytesRead(): Long
+    private external fun nativeExportArchive(fd: Int, fileIds: ByteArray, paths: Array<String>, format: Int): Int
+    private external fun nativeArchiveBytesWritten(): Long
     private external fun nativeChangePassword(oldPassphrase: ByteArray, newPassphrase: ByteArray): Int
     private external fun nativeSecureWipeFile(path: String): Boolean
+    private external fun nativeScanFiles(paths: Array<String>, patterns: Array<ByteArray>, threads: Int): IntArray?
+    private external fun nativeGovernorSetSignals(thermalHeadroom: Float, thermalStatus: Int, batteryPercent: Int, charging: Boolean, powerSave: Boolean)
+    private external fun nativeGovernorWorkers(maxWorkers: Int): Int
+    private external fun nativeGovernorIoRate(): Long
     
     // Streaming import native methods
     private external fun nativeStreamingInit(): Int
     private external fun nativeStreamingComputeSourceHash(firstMb: ByteArray, lastMb: ByteArray?, fileSize: Long): ByteArray?
     private external fun nativeStreamingStart(sourceUri: String, sourceHash: ByteArray, name: String, mime: String?, type: Int, fileSize: Long): StreamingStartResult?
     private external fun nativeStreamingWriteChunk(importId: ByteArray, plaintext: ByteArray, chunkIndex: Int): Int
+    private external fun nativeStreamingVerifyChunk(importId: ByteArray, chunkIndex: Int, plaintext: ByteArray, length: Int): Int
+    private external fun nativeStreamingSetMediaInfo(importId: ByteArray, values: LongArray, videoCodec: String?, audioCodec: String?): Int
     private external fun nativeStreamingFinish(importId: ByteArray): ByteArray?
     private external fun nativeStreamingAbort(importId: ByteArray): Int
     private external fun nativeStreamingGetState(importId: ByteArray): StreamingImportState?
@@ -326,6 +374,80 @@ class VaultEngine private constructor(private val context: Context) {
         }
     }
     
+    /**
+     * Read and encrypt every member of a ZIP, TAR or .tar.gz from [fd] (not
+     * closed) into a spool without changing the vault; nothing is staged if
+     * the archive is damaged
+     */
+    fun stageArchive(fd: Int): Result<Unit> {
+        val result = nativeStageArchive(fd)
+        return if (result == VAULT_OK) {
+            Result.success(Unit)
+        } else {
+            Result.failure(VaultException.fromCode(result))
+        }
+    }
+
+    /**
+     * Publish the staged archive members with a single commit; the stage is
+     * released either way
+     */
+    fun commitArchive(): Result<VaultArchiveImport> {
+        val status = IntArray(2)
+        val members = nativeCommitArchive(status)
+            ?: return Result.failure(VaultException.fromCode(status[0]))
+        return Result.success(VaultArchiveImport(members.toList(), status[1]))
+    }
+
+    /**
+     * Drop a staged archive that will not be committed
+     */
+    fun discardArchive() = nativeDiscardArchive()
+
+    /**
+     * Source bytes consumed by the running archive import
+     */
+    fun archiveBytesRead(): Long = nativeArchiveBytesRead()
+
+    /**
+     * Snapshot files for one archive export; [paths] gives each file's
+     * location inside the archive
+     */
+    fun prepareExport(fileIds: List<ByteArray>, paths: List<String>): Result<Unit> {
+        if (fileIds.isEmpty() || fileIds.size != paths.size) {
+            return Result.failure(VaultException.fromCode(VAULT_ERR_INVALID_PARAM))
+        }
+        val result = nativePrepareExport(packFileIds(fileIds), paths.toTypedArray())
+        return if (result == VAULT_OK) {
+            Result.success(Unit)
+        } else {
+            Result.failure(VaultException.fromCode(result))
+        }
+    }
+
+    /**
+     * Write the prepared files as one uncompressed ZIP or TAR stream to [fd]
+     * (not closed); the snapshot is released either way
+     */
+    fun writeExport(fd: Int, format: Int): Result<Unit> {
+        val result = nativeWriteExport(fd, format)
+        return if (result == VAULT_OK) {
+            Result.success(Unit)
+        } else {
+            Result.failure(VaultException.fromCode(result))
+        }
+    }
+
+    /**
+     * Drop a prepared export that will not be written
+     */
+    fun discardExport() = nativeDiscardExport()
+
+    /**
+     * Plaintext bytes written by the running archive export
+     */
+    fun archiveBytesWritten(): Long = nativeArchiveBytesWritten()
+
     /**
      * Read a file from the vault
      */
@@ -349,6 +471,45 @@ class VaultEngine private constructor(private val context: Context) {
             Result.failure(VaultException("Failed to read chunk", VAULT_ERR_NOT_FOUND))
         }
     }
+
+    /**
+     * Read a run of chunks into out[outOffset, outOffset + length).
+     * Stops once length bytes are filled; returns the bytes written.
+     */
+    fun readChunks(
+        fileId: ByteArray,
+        firstChunk: Int,
+        chunkCount: Int,
+        out: ByteArray,
+        outOffset: Int = 0,
+        length: Int = out.size - outOffset
+    ): Result<Int> {
+        val result = nativeReadChunks(fileId, firstChunk, chunkCount, out, outOffset, length)
+        return if (result >= 0) {
+            Result.success(result)
+        } else {
+            Result.failure(VaultException.fromCode(result))
+        }
+    }
+
+    /**
+     * Read plaintext bytes [offset, offset + length) of a file into
+     * out[outOffset, ...). Returns the bytes written, 0 at or past the end.
+     */
+    fun readRange(
+        fileId: ByteArray,
+        offset: Long,
+        out: ByteArray,
+        outOffset: Int = 0,
+        length: Int = out.size - outOffset
+    ): Result<Int> {
+        val result = nativeReadRange(fileId, offset, out, outOffset, length)
+        return if (result >= 0) {
+            Result.success(result)
+        } else {
+            Result.failure(VaultException.fromCode(result))
+        }
+    }
     
     /**
      * Delete a file from the vault
@@ -373,6 +534,70 @@ class VaultEngine private constructor(private val context: Context) {
             Result.failure(VaultException.fromCode(result))
         }
     }
+
+    /**
+     * Delete several files with a single index commit
+     * All IDs are validated first; on failure nothing is deleted.
+     */
+    fun deleteFiles(fileIds: List<ByteArray>): Result<Unit> {
+        if (fileIds.isEmpty()) return Result.success(Unit)
+        val result = nativeDeleteFiles(packFileIds(fileIds))
+        return if (result == VAULT_OK) {
+            Result.success(Unit)
+        } else {
+            Result.failure(VaultException.fromCode(result))
+        }
+    }
+
+    /**
+     * Rename several files with a single index commit
+     * All names are validated first; on failure nothing is renamed.
+     */
+    fun renameFiles(fileIds: List<ByteArray>, names: List<String>): Result<Unit> {
+        if (fileIds.size != names.size) {
+            return Result.failure(VaultException.fromCode(VAULT_ERR_INVALID_PARAM))
+        }
+        if (fileIds.isEmpty()) return Result.success(Unit)
+        val result = nativeRenameFiles(packFileIds(fileIds), names.toTypedArray())
+        return if (result == VAULT_OK) {
+            Result.success(Unit)
+        } else {
+            Result.failure(VaultException.fromCode(result))
+        }
+    }
+
+    /**
+     * Apply queued renames and deletes with one shared index commit.
+     * Returns one result per operation; an invalid operation fails alone.
+     */
+    fun commitMetadataOps(ops: List<VaultMetadataOp>): List<Result<Unit>> {
+        if (ops.isEmpty()) return emptyList()
+        val kinds = ByteArray(ops.size) {
+            (if (ops[it].newName == null) META_OP_DELETE else META_OP_RENAME).toByte()
+        }
+        val statuses = nativeCommitMetadataOps(
+            kinds,
+            packFileIds(ops.map { it.fileId }),
+            Array(ops.size) { ops[it].newName }
+        ) ?: IntArray(ops.size) { VAULT_ERR_INVALID_PARAM }
+        return statuses.map { status ->
+            if (status == VAULT_OK) {
+                Result.success(Unit)
+            } else {
+                Result.failure(VaultException.fromCode(status))
+            }
+        }
+    }
+
+    private fun packFileIds(fileIds: List<ByteArray>): ByteArray {
+        val packed = ByteArray(fileIds.sumOf { it.size })
+        var offset = 0
+        for (id in fileIds) {
+            id.copyInto(packed, offset)
+            offset += id.size
+        }
+        return packed
+    }
     
     /**
      * Compact the vault
@@ -385,7 +610,206 @@ class VaultEngine private constructor(private val context: Context) {
             Result.failure(VaultException.fromCode(result))
         }
     }
+
+    /**
+     * Select the directory for the open vault's cold segment (null disables tiering)
+     */
+    fun setColdDir(dir: String?): Result<Unit> {
+        val result = nativeTierSetColdDir(dir)
+        return if (result == VAULT_OK) {
+            Result.success(Unit)
+        } else {
+            Result.failure(VaultException.fromCode(result))
+        }
+    }
+
+    /**
+     * Move chunks of files unread for [coldDays] to the cold segment
+     * @return Ciphertext bytes moved
+     */
+    fun migrateColdData(coldDays: Int, maxBytes: Long): Result<Long> {
+        val result = nativeTierMigrate(coldDays, maxBytes)
+        return if (result >= 0) {
+            Result.success(result)
+        } else {
+            Result.failure(VaultException.fromCode(result.toInt()))
+        }
+    }
+
+    /**
+     * Copy every cold chunk back into the container
+     * @return Number of files recalled
+     */
+    fun recallColdData(): Result<Int> {
+        val result = nativeTierRecallAll()
+        return if (result >= 0) {
+            Result.success(result)
+        } else {
+            Result.failure(VaultException.fromCode(result))
+        }
+    }
+    
+    /**
+     * Move files unread for [idleMs] from 1 MB to 4 MB chunks
+     * @return Plaintext bytes converted
+     */
+    fun rechunkLegacy(idleMs: Long, maxBytes: Long): Result<Long> {
+        val result = nativeRechunkLegacy(idleMs, maxBytes)
+        return if (result >= 0) {
+            Result.success(result)
+        } else {
+            Result.failure(VaultException.fromCode(result.toInt()))
+        }
+    }
+
+    /**
+     * Full-text search over indexed text entries, best match first
+     * Matches entries containing every word; no payload is decrypted.
+     */
+    fun searchFiles(query: String, maxResults: Int = SEARCH_MAX_RESULTS): Result<List<ByteArray>> {
+        val status = IntArray(1)
+        val packed = nativeSearchFiles(query, maxResults, status)
+            ?: return Result.failure(VaultException.fromCode(status[0]))
+        return Result.success((0 until packed.size / 16).map { i ->
+            packed.copyOfRange(i * 16, (i + 1) * 16)
+        })
+    }
+
+    /**
+     * Index text entries without search terms (imported before search
+     * existed, or streamed in chunks), resuming a pass at [start]; one
+     * commit per call. Unreadable entries are skipped.
+     * @return Position to resume from, or null once the pass is complete
+     */
+    fun indexPendingText(start: Int, maxFiles: Int): Result<Int?> {
+        val status = IntArray(1)
+        val next = nativeIndexPendingText(start, maxFiles, status)
+        return if (status[0] == VAULT_OK) {
+            Result.success(next.takeIf { it >= 0 })
+        } else {
+            Result.failure(VaultException.fromCode(status[0]))
+        }
+    }
+
+    /**
+     * Store probed media metadata in the file's index entry (one commit)
+     */
+    fun setMediaInfo(fileId: ByteArray, info: VaultMediaInfo): Result<Unit> {
+        val result = nativeSetMediaInfo(fileId, info.toValues(), info.videoCodec, info.audioCodec)
+        return if (result == VAULT_OK) {
+            Result.success(Unit)
+        } else {
+            Result.failure(VaultException.fromCode(result))
+        }
+    }
+
+    /**
+     * Media metadata stored at import, or null if the file has none
+     */
+    fun getMediaInfo(fileId: ByteArray): VaultMediaInfo? {
+        val codecs = arrayOfNulls<String>(2)
+        val values = nativeGetMediaInfo(fileId, codecs) ?: return null
+        return VaultMediaInfo(
+            width = values[0].toInt(),
+            height = values[1].toInt(),
+            rotation = values[2].toInt(),
+            durationMs = values[3],
+            videoTracks = values[4].toInt(),
+            audioTracks = values[5].toInt(),
+            videoCodec = codecs[0]?.takeIf { it.isNotEmpty() },
+            audioCodec = codecs[1]?.takeIf { it.isNotEmpty() }
+        )
+    }
+
+    /**
+     * Get vault statistics (maintained incrementally in native code)
+     */
+    fun getStats(): Result<Map<String, Any>> {
+        val largestIds = ByteArray(STATS_LARGEST_FILES * 16)
+        val values = nativeGetStats(largestIds)
+            ?: return Result.failure(VaultException.fromCode(VAULT_ERR_NOT_OPEN))
+        val typeNames = listOf("other", "text", "image", "video")
+        val largestCount = values[16].toInt().coerceIn(0, STATS_LARGEST_FILES)
+        return Result.success(mapOf(
+            "totalSize" to values[0],
+            "freeSpace" to values[1],
+            "liveBytes" to values[2],
+            "indexBytes" to values[3],
+            "plaintextBytes" to values[4],
+            "fileCount" to values[5],
+            "fragmentedFiles" to values[6],
+            "extentCount" to values[7],
+            "typeBytes" to typeNames.indices.associate { typeNames[it] to values[8 + it] },
+            "typeFiles" to typeNames.indices.associate { typeNames[it] to values[12 + it] },
+            "largestFiles" to (0 until largestCount).map { i ->
+                mapOf(
+                    "fileId" to largestIds.copyOfRange(i * 16, (i + 1) * 16).toList(),
+                    "size" to values[17 + i]
+                )
+            }
+        ))
+    }
     
+    /**
+     * Physical layout of the container: per-entry fragmentation (logical
+     * runs vs. FIEMAP extents), dead-space distribution, index record
+     * positions and read cost estimates. Walks the whole index, unlike
+     * getStats.
+     */
+    fun analyzeLayout(): Result<Map<String, Any>> {
+        val status = IntArray(1)
+        val values = nativeAnalyzeLayout(status)
+            ?: return Result.failure(VaultException.fromCode(status[0]))
+        val entryCount = values[12].toInt()
+        val indexCount = values[13].toInt()
+        val indexStart = LAYOUT_HEADER_VALUES + LAYOUT_DEAD_BUCKETS
+        val entriesStart = indexStart + LAYOUT_INDEX_RECORDS * LAYOUT_INDEX_VALUES
+        return Result.success(mapOf(
+            "fileSize" to values[0],
+            "committedSize" to values[1],
+            "headerBytes" to values[2],
+            "indexOffset" to values[3],
+            "indexLength" to values[4],
+            "liveBytes" to values[5],
+            "deadBytes" to values[6],
+            "deadRuns" to values[7],
+            "largestDeadRun" to values[8],
+            "fiemapSupported" to (values[9] != 0L),
+            "physicalExtents" to values[10],
+            "readCostUs" to values[11],
+            "deadBuckets" to values.copyOfRange(LAYOUT_HEADER_VALUES, indexStart).toList(),
+            // Newest first; the first one is the current index record
+            "indexRecords" to (0 until indexCount).map { i ->
+                val at = indexStart + i * LAYOUT_INDEX_VALUES
+                mapOf(
+                    "seq" to values[at],
+                    "offset" to values[at + 1],
+                    "length" to values[at + 2]
+                )
+            },
+            "entries" to (0 until entryCount).map { i ->
+                val at = entriesStart + i * LAYOUT_ENTRY_VALUES
+                val fileId = ByteArray(16)
+                for (b in 0 until 8) {
+                    fileId[b] = (values[at] ushr (56 - 8 * b)).toByte()
+                    fileId[8 + b] = (values[at + 1] ushr (56 - 8 * b)).toByte()
+                }
+                mapOf(
+                    "fileId" to fileId.toList(),
+                    "isSystem" to (values[at + 2] != 0L),
+                    "size" to values[at + 3],
+                    "storedBytes" to values[at + 4],
+                    "firstOffset" to values[at + 5],
+                    "span" to values[at + 6],
+                    "logicalExtents" to values[at + 7],
+                    "physicalExtents" to values[at + 8],
+                    "coldChunks" to values[at + 9],
+                    "readCostUs" to values[at + 10]
+                )
+            }
+        ))
+    }
+
     /**
      * Get number of entries in vault
      */
@@ -493,6 +917,49 @@ class VaultEngine private constructor(private val context: Context) {
         }
     }
     
+    /**
+     * Scan files natively for known byte patterns and file signatures
+     * @param paths Absolute file paths
+     * @param patterns Byte patterns to search for (may be empty)
+     * @param threads Worker thread count
+     * @return One result per path: signature in the low byte, SCAN_RESULT_PATTERN
+     *         if a pattern matched, or a negative error code if unreadable
+     */
+    fun scanFiles(paths: List<String>, patterns: List<ByteArray>, threads: Int): Result<IntArray> {
+        val results = nativeScanFiles(paths.toTypedArray(), patterns.toTypedArray(), threads)
+        return if (results != null) {
+            Result.success(results)
+        } else {
+            Result.failure(VaultException.fromCode(VAULT_ERR_MEMORY))
+        }
+    }
+    
+    /**
+     * Feed device signals to the native concurrency governor
+     * @param thermalHeadroom Forecast thermal headroom (1.0 = throttling), negative if unknown
+     * @param thermalStatus PowerManager.THERMAL_STATUS_* level
+     * @param batteryPercent Battery level 0-100, negative if unknown
+     */
+    fun setGovernorSignals(
+        thermalHeadroom: Float,
+        thermalStatus: Int,
+        batteryPercent: Int,
+        charging: Boolean,
+        powerSave: Boolean
+    ) {
+        nativeGovernorSetSignals(thermalHeadroom, thermalStatus, batteryPercent, charging, powerSave)
+    }
+
+    /**
+     * Worker count a Kotlin-side pool may use now, between 1 and maxWorkers
+     */
+    fun governorWorkers(maxWorkers: Int): Int = nativeGovernorWorkers(maxWorkers)
+
+    /**
+     * Bulk I/O rate a Kotlin-side job may use now, in bytes per second (0 = unpaced)
+     */
+    fun governorIoRate(): Long = nativeGovernorIoRate()
+    
     // ========================================================================
     // Streaming Import API (for large files up to 50GB)
     // ========================================================================
@@ -551,6 +1018,31 @@ class VaultEngine private constructor(private val context: Context) {
         }
     }
     
+    /**
+     * Check an already-written chunk against source bytes before resuming.
+     * Fails with ERR_SOURCE_CHANGED when they differ.
+     */
+    fun streamingVerifyChunk(importId: ByteArray, chunkIndex: Int, plaintext: ByteArray, length: Int): Result<Unit> {
+        val result = nativeStreamingVerifyChunk(importId, chunkIndex, plaintext, length)
+        return if (result == StreamingConstants.OK) {
+            Result.success(Unit)
+        } else {
+            Result.failure(VaultException("Chunk verification failed", result))
+        }
+    }
+    
+    /**
+     * Attach probed media metadata to an active import; stored on finish
+     */
+    fun streamingSetMediaInfo(importId: ByteArray, info: VaultMediaInfo): Result<Unit> {
+        val result = nativeStreamingSetMediaInfo(importId, info.toValues(), info.videoCodec, info.audioCodec)
+        return if (result == StreamingConstants.OK) {
+            Result.success(Unit)
+        } else {
+            Result.failure(VaultException("Failed to set media info", result))
+        }
+    }
+
     /**
      * Finalize streaming import
      * @return fileId of the imported file
@@ -649,3 +1141,56 @@ data class VaultFileEntry(
     
     override fun hashCode(): Int = fileId.contentHashCode()
 }
+
+/**
+ * One file imported from an archive; [folder] is its directory inside the
+ * archive ("" at the root)
+ */
+data class VaultArchiveMember(
+    val fileId: ByteArray,
+    val folder: String,
+    val name: String,
+    val size: Long
+) {
+    override fun equals(other: Any?): Boolean {
+        if (this === other) return true
+        if (javaClass != other?.javaClass) return false
+        other as VaultArchiveMember
+        return fileId.contentEquals(other.fileId)
+    }
+
+    override fun hashCode(): Int = fileId.contentHashCode()
+}
+
+/**
+ * One rename (or delete, when [newName] is null) queued for a group commit
+ */
+class VaultMetadataOp(
+    val fileId: ByteArray,
+    val newName: String?
+)
+
+data class VaultArchiveImport(
+    val members: List<VaultArchiveMember>,
+    val skipped: Int
+)
+
+/**
+ * Media metadata kept in the encrypted index (see vault_media_info_t)
+ * width/height are the coded size, before rotation.
+ */
+data class VaultMediaInfo(
+    val width: Int,
+    val height: Int,
+    val rotation: Int,
+    val durationMs: Long,
+    val videoTracks: Int,
+    val audioTracks: Int,
+    val videoCodec: String?,
+    val audioCodec: String?
+) {
+    fun toValues(): LongArray = longArrayOf(
+        width.toLong(), height.toLong(), rotation.toLong(),
+        durationMs, videoTracks.toLong(), audioTracks.toLong()
+    )
+}
@@ -0,0 +1,403 @@
+package com.noleak.noleak.vault
+
+import android.content.ContentProvider
+import android.content.ContentValues
+import android.content.Context
+import android.content.Intent
+import android.database.Cursor
+import android.database.MatrixCursor
+import android.net.Uri
+import android.os.Build
+import android.os.Handler
+import android.os.HandlerThread
+import android.os.ParcelFileDescriptor
+import android.os.ProxyFileDescriptorCallback
+import android.os.SystemClock
+import android.os.storage.StorageManager
+import android.provider.OpenableColumns
+import android.system.ErrnoException
+import android.system.OsConstants
+import androidx.annotation.RequiresApi
+import com.noleak.noleak.security.SecureLog
+import kotlinx.coroutines.runBlocking
+import java.io.FileNotFoundException
+import java.io.FileOutputStream
+import java.io.IOException
+import java.security.SecureRandom
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.atomic.AtomicInteger
+import kotlin.concurrent.thread
+
+/**
+ * VaultShareProvider - Serves decrypted vault files to other apps without
+ * writing plaintext to disk.
+ *
+ * A share is an unguessable content:// URI granted to one receiving app via
+ * FLAG_GRANT_READ_URI_PERMISSION (the provider itself is not exported).
+ * Content is decrypted on demand from native range reads:
+ * - Android 8+: a seekable proxy file descriptor, so viewers can seek
+ * - Android 7: a one-way pipe streamed from the start of the file
+ *
+ * SECURITY:
+ * - Read-only; shares are revoked when the vault closes, after which open
+ *   descriptors fail with EACCES
+ * - Decrypted blocks live only in a small per-descriptor cache and are
+ *   zeroized on eviction and release
+ * - While a receiver keeps reading, the background lock is deferred (see
+ *   MainActivity); it proceeds once reads stop for READ_IDLE_MS, and never
+ *   later than MAX_LOCK_DEFERRAL_MS after the app left the foreground
+ * - A share expires READ_IDLE_MS after its last descriptor closes, or
+ *   LAUNCH_GRACE_MS after it was handed out if it is never opened
+ */
+class VaultShareProvider : ContentProvider() {
+
+    companion object {
+        private const val TAG = "VaultShareProvider"
+        private const val AUTHORITY_SUFFIX = ".share"
+
+        // Block size matches streaming-import chunks, so one block read
+        // decrypts one chunk (four for legacy 1MB chunks)
+        private const val BLOCK_SIZE = StreamingConstants.CHUNK_SIZE
+        private const val CACHED_BLOCKS = 3
+
+        // A share keeps the vault open this long after it is handed out,
+        // and for as long as reads keep arriving this often
+        private const val LAUNCH_GRACE_MS = 60_000L
+        const val READ_IDLE_MS = 10_000L
+
+        // Hard cap on keeping the vault open in the background for a reader
+        const val MAX_LOCK_DEFERRAL_MS = 10 * 60_000L
+
+        private val secureRandom = SecureRandom()
+        private val shares = ConcurrentHashMap<String, Share>()
+
+        @Volatile
+        private var lastSharedAt = 0L
+
+        @Volatile
+        private var lastReadAt = 0L
+
+        private class Share(
+            val fileId: ByteArray,
+            val name: String,
+            val mimeType: String,
+            val size: Long,
+            val sharedAt: Long
+        ) {
+            val openDescriptors = AtomicInteger(0)
+
+            @Volatile
+            var releasedAt = 0L
+
+            fun isExpired(now: Long): Boolean {
+                if (openDescriptors.get() > 0) return false
+                return if (releasedAt == 0L) {
+                    now - sharedAt >= LAUNCH_GRACE_MS
+                } else {
+                    now - releasedAt >= READ_IDLE_MS
+                }
+            }
+        }
+
+        private fun shareUri(authority: String, token: String, name: String): Uri =
+            Uri.Builder()
+                .scheme("content")
+                .authority(authority)
+                .appendPath(token)
+                .appendPath(name)
+                .build()
+
+        /**
+         * Drop shares that were closed or never opened in time. Grants are
+         * revoked when a context is at hand; either way the token no longer
+         * resolves.
+         */
+        private fun pruneExpired(context: Context?) {
+            val now = SystemClock.elapsedRealtime()
+            val iterator = shares.entries.iterator()
+            while (iterator.hasNext()) {
+                val (token, share) = iterator.next()
+                if (!share.isExpired(now)) continue
+                iterator.remove()
+                if (context != null) {
+                    val uri = shareUri(context.packageName + AUTHORITY_SUFFIX, token, share.name)
+                    runCatching {
+                        context.revokeUriPermission(uri, Intent.FLAG_GRANT_READ_URI_PERMISSION)
+                    }
+                }
+                SecureLog.d(TAG, "pruneExpired: share expired")
+            }
+        }
+
+        private fun releaseDescriptor(share: Share) {
+            if (share.openDescriptors.decrementAndGet() == 0) {
+                share.releasedAt = SystemClock.elapsedRealtime()
+            }
+        }
+
+        /**
+         * Register a vault file for sharing and return its content URI.
+         * The caller grants read access on the intent that carries it.
+         */
+        fun share(context: Context, entry: VaultFileEntry, mimeType: String): Uri {
+            pruneExpired(context)
+            val tokenBytes = ByteArray(16)
+            secureRandom.nextBytes(tokenBytes)
+            val token = tokenBytes.joinToString("") { "%02x".format(it) }
+            val now = SystemClock.elapsedRealtime()
+            shares[token] = Share(entry.fileId.copyOf(), entry.name, mimeType, entry.size, now)
+            lastSharedAt = now
+            SecureLog.d(TAG, "share: registered ${entry.size} bytes")
+            return shareUri(context.packageName + AUTHORITY_SUFFIX, token, entry.name)
+        }
+
+        /**
+         * SECURITY: Revoke every share; open descriptors fail from now on
+         */
+        fun revokeAll(context: Context) {
+            if (shares.isEmpty()) return
+            val authority = context.packageName + AUTHORITY_SUFFIX
+            for ((token, share) in shares) {
+                runCatching {
+                    context.revokeUriPermission(
+                        shareUri(authority, token, share.name),
+                        Intent.FLAG_GRANT_READ_URI_PERMISSION
+                    )
+                }
+            }
+            shares.clear()
+            lastSharedAt = 0L
+            lastReadAt = 0L
+            SecureLog.security(TAG, "All shares revoked")
+        }
+
+        /**
+         * Whether a share was just handed out or is still being read
+         */
+        fun isShareActive(): Boolean {
+            pruneExpired(null)
+            if (shares.isEmpty()) return false
+            val now = SystemClock.elapsedRealtime()
+            return now - lastSharedAt < LAUNCH_GRACE_MS || isStreaming()
+        }
+
+        /**
+         * Whether a receiver read from a share within READ_IDLE_MS
+         */
+        fun isStreaming(): Boolean {
+            return shares.isNotEmpty() &&
+                SystemClock.elapsedRealtime() - lastReadAt < READ_IDLE_MS
+        }
+
+        /**
+         * Whether the background lock may wait for a reader once more:
+         * reads are still arriving and the cap since backgroundedAt
+         * (elapsedRealtime) has not been reached
+         */
+        fun mayDeferLock(backgroundedAt: Long): Boolean {
+            return isStreaming() &&
+                SystemClock.elapsedRealtime() - backgroundedAt < MAX_LOCK_DEFERRAL_MS
+        }
+
+        private fun markRead() {
+            lastReadAt = SystemClock.elapsedRealtime()
+        }
+    }
+
+    private val vaultBridge: VaultBridge by lazy {
+        VaultBridge.getInstance(context!!.applicationContext)
+    }
+
+    override fun onCreate(): Boolean = true
+
+    private fun tokenOf(uri: Uri): String? = uri.pathSegments.firstOrNull()
+
+    private fun shareFor(uri: Uri): Share? {
+        pruneExpired(context)
+        return tokenOf(uri)?.let { shares[it] }
+    }
+
+    override fun query(
+        uri: Uri,
+        projection: Array<out String>?,
+        selection: String?,
+        selectionArgs: Array<out String>?,
+        sortOrder: String?
+    ): Cursor? {
+        val share = shareFor(uri) ?: return null
+        val columns = projection?.filter {
+            it == OpenableColumns.DISPLAY_NAME || it == OpenableColumns.SIZE
+        }?.toTypedArray() ?: arrayOf(OpenableColumns.DISPLAY_NAME, OpenableColumns.SIZE)
+        val row = columns.map {
+            if (it == OpenableColumns.DISPLAY_NAME) share.name else share.size
+        }.toTypedArray()
+        return MatrixCursor(columns, 1).apply { addRow(row) }
+    }
+
+    override fun getType(uri: Uri): String? = shareFor(uri)?.mimeType
+
+    override fun openFile(uri: Uri, mode: String): ParcelFileDescriptor? {
+        if (mode != "r") {
+            throw SecurityException("Shares are read-only")
+        }
+        pruneExpired(context)
+        val token = tokenOf(uri) ?: throw FileNotFoundException("Unknown share")
+        val share = shares[token] ?: throw FileNotFoundException("Unknown share")
+        markRead()
+        // Counted from here so the share cannot expire while opening
+        share.openDescriptors.incrementAndGet()
+
+        return if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.O) {
+            openProxy(token, share)
+        } else {
+            openPipe(token, share)
+        }
+    }
+
+    @RequiresApi(Build.VERSION_CODES.O)
+    private fun openProxy(token: String, share: Share): ParcelFileDescriptor {
+        val storageManager = context!!.getSystemService(StorageManager::class.java)
+        // Each descriptor gets its own callback thread, so one slow reader
+        // does not stall another
+        val callbackThread = HandlerThread("VaultShareProxy").apply { start() }
+        return try {
+            storageManager.openProxyFileDescriptor(
+                ParcelFileDescriptor.MODE_READ_ONLY,
+                ProxyReader(token, share, callbackThread),
+                Handler(callbackThread.looper)
+            )
+        } catch (e: IOException) {
+            callbackThread.quitSafely()
+            releaseDescriptor(share)
+            throw FileNotFoundException("Could not open share")
+        }
+    }
+
+    private fun openPipe(token: String, share: Share): ParcelFileDescriptor {
+        val pipe = try {
+            ParcelFileDescriptor.createReliablePipe()
+        } catch (e: IOException) {
+            releaseDescriptor(share)
+            throw FileNotFoundException("Could not open share")
+        }
+        val writeSide = pipe[1]
+        thread(name = "VaultSharePipe") {
+            val block = ByteArray(BLOCK_SIZE)
+            try {
+                FileOutputStream(writeSide.fileDescriptor).use { output ->
+                    var offset = 0L
+                    while (offset < share.size) {
+                        if (!shares.containsKey(token)) {
+                            throw IOException("Share revoked")
+                        }
+                        val read = runBlocking {
+                            vaultBridge.readRange(share.fileId, offset, block)
+                        }.getOrThrow()
+                        if (read <= 0) throw IOException("Short read")
+                        output.write(block, 0, read)
+                        offset += read
+                        markRead()
+                    }
+                }
+                writeSide.close()
+            } catch (e: Exception) {
+                SecureLog.e(TAG, "openPipe: stream failed: ${e.javaClass.simpleName}")
+                runCatching { writeSide.closeWithError("Read failed") }
+            } finally {
+                VaultEngine.secureZeroize(block)
+                releaseDescriptor(share)
+            }
+        }
+        return pipe[0]
+    }
+
+    /**
+     * Seekable reader over a share. Reads are served from a small LRU of
+     * decrypted blocks, so a viewer's small sequential reads decrypt each
+     * chunk once.
+     */
+    @RequiresApi(Build.VERSION_CODES.O)
+    private inner class ProxyReader(
+        private val token: String,
+        private val share: Share,
+        private val callbackThread: HandlerThread
+    ) : ProxyFileDescriptorCallback() {
+
+        private val cache = object : LinkedHashMap<Long, ByteArray>(CACHED_BLOCKS + 1, 0.75f, true) {
+            override fun removeEldestEntry(eldest: MutableMap.MutableEntry<Long, ByteArray>?): Boolean {
+                if (size <= CACHED_BLOCKS) return false
+                VaultEngine.secureZeroize(eldest?.value)
+                return true
+            }
+        }
+
+        override fun onGetSize(): Long = share.size
+
+        override fun onRead(offset: Long, size: Int, data: ByteArray): Int {
+            if (!shares.containsKey(token)) {
+                dropCache()
+                throw ErrnoException("onRead", OsConstants.EACCES)
+            }
+            var copied = 0
+            while (copied < size && offset + copied < share.size) {
+                val position = offset + copied
+                val block = blockAt(position / BLOCK_SIZE)
+                val inBlock = (position % BLOCK_SIZE).toInt()
+                val count = minOf(size - copied, block.size - inBlock)
+                if (count <= 0) break
+                System.arraycopy(block, inBlock, data, copied, count)
+                copied += count
+            }
+            markRead()
+            return copied
+        }
+
+        private fun blockAt(index: Long): ByteArray {
+            cache[index]?.let { return it }
+            val start = index * BLOCK_SIZE
+            val length = minOf(BLOCK_SIZE.toLong(), share.size - start).toInt()
+            val block = ByteArray(length)
+            val read = runBlocking {
+                vaultBridge.readRange(share.fileId, start, block)
+            }.getOrElse {
+                VaultEngine.secureZeroize(block)
+                SecureLog.e(TAG, "ProxyReader: read failed: ${it.javaClass.simpleName}")
+                throw ErrnoException("onRead", OsConstants.EIO)
+            }
+            if (read != length) {
+                VaultEngine.secureZeroize(block)
+                throw ErrnoException("onRead", OsConstants.EIO)
+            }
+            cache[index] = block
+            return block
+        }
+
+        private fun dropCache() {
+            cache.values.forEach { VaultEngine.secureZeroize(it) }
+            cache.clear()
+        }
+
+        override fun onRelease() {
+            dropCache()
+            releaseDescriptor(share)
+            callbackThread.quitSafely()
+        }
+    }
+
+    override fun insert(uri: Uri, values: ContentValues?): Uri? {
+        throw UnsupportedOperationException("Shares are read-only")
+    }
+
+    override fun update(
+        uri: Uri,
+        values: ContentValues?,
+        selection: String?,
+        selectionArgs: Array<out String>?
+    ): Int {
+        throw UnsupportedOperationException("Shares are read-only")
+    }
+
+    override fun delete(uri: Uri, selection: String?, selectionArgs: Array<out String>?): Int {
+        throw UnsupportedOperationException("Shares are read-only")
+    }
+}
@@ -0,0 +1,210 @@
+package com.noleak.noleak.vault
+
+import java.io.ByteArrayInputStream
+import java.io.ByteArrayOutputStream
+import java.io.DataInputStream
+import java.io.DataOutputStream
+import java.io.IOException
+
+/**
+ * WatchCursor - What a watched folder looked like after its last sync
+ *
+ * Per directory (keyed by SAF document ID): its path, last-modified stamp,
+ * subdirectories, and the size and last-modified time of every file that
+ * was imported or skipped as not importable. A sync re-lists only
+ * directories whose stamp moved and imports only files that are new or
+ * whose size or time changed. Between two cursors only a [Delta] (the
+ * directories that changed or went away) needs to be persisted.
+ *
+ * SECURITY: Holds source file names; it is only ever persisted inside the
+ * vault (see WatchedSourceStore) and the serialized bytes are zeroized by
+ * the caller.
+ */
+class WatchCursor {
+
+    companion object {
+        // Version 2 adds the seq of the last delta folded in
+        private const val VERSION = 2
+        private const val VERSION_NO_SEQ = 1
+        private const val DELTA_VERSION = 1
+        private const val NO_STAMP = Long.MIN_VALUE
+
+        // Guards against corrupt counts before anything is allocated
+        private const val MAX_STRING_BYTES = 64 * 1024
+
+        /**
+         * Parse a serialized cursor; null if it is corrupt or from another
+         * version (the next sync then starts over)
+         */
+        fun deserialize(bytes: ByteArray): WatchCursor? {
+            return try {
+                DataInputStream(ByteArrayInputStream(bytes)).use { input ->
+                    val version = input.readInt()
+                    if (version != VERSION && version != VERSION_NO_SEQ) return null
+                    val cursor = WatchCursor()
+                    if (version == VERSION) cursor.seq = input.readInt()
+                    input.readDirs(cursor.dirs)
+                    cursor
+                }
+            } catch (e: IOException) {
+                null
+            }
+        }
+
+        private fun DataInputStream.readDirs(into: MutableMap<String, DirState>) {
+            repeat(readCount()) {
+                val id = readString()
+                val path = readString()
+                val stamp = readLong()
+                val subdirs = HashMap<String, String>()
+                repeat(readCount()) {
+                    val subdirId = readString()
+                    subdirs[subdirId] = readString()
+                }
+                val files = HashMap<String, FileState>()
+                repeat(readCount()) {
+                    val fileId = readString()
+                    files[fileId] = FileState(readLong(), readLong())
+                }
+                into[id] = DirState(
+                    path = path,
+                    lastModified = if (stamp == NO_STAMP) null else stamp,
+                    subdirs = subdirs,
+                    files = files
+                )
+            }
+        }
+
+        private fun DataOutputStream.writeDirs(dirs: Map<String, DirState>) {
+            writeInt(dirs.size)
+            for ((id, dir) in dirs) {
+                writeString(id)
+                writeString(dir.path)
+                writeLong(dir.lastModified ?: NO_STAMP)
+                writeInt(dir.subdirs.size)
+                for ((subdirId, name) in dir.subdirs) {
+                    writeString(subdirId)
+                    writeString(name)
+                }
+                writeInt(dir.files.size)
+                for ((fileId, state) in dir.files) {
+                    writeString(fileId)
+                    writeLong(state.size)
+                    writeLong(state.lastModified)
+                }
+            }
+        }
+
+        private fun DataInputStream.readCount(): Int {
+            val count = readInt()
+            if (count < 0) throw IOException("Negative count")
+            return count
+        }
+
+        private fun DataInputStream.readString(): String {
+            val length = readInt()
+            if (length < 0 || length > MAX_STRING_BYTES) throw IOException("Bad string length")
+            val bytes = ByteArray(length)
+            readFully(bytes)
+            return String(bytes, Charsets.UTF_8)
+        }
+
+        private fun DataOutputStream.writeString(value: String) {
+            val bytes = value.toByteArray(Charsets.UTF_8)
+            writeInt(bytes.size)
+            write(bytes)
+        }
+    }
+
+    /** Size and last-modified time as reported by the provider (-1 if unknown) */
+    data class FileState(val size: Long, val lastModified: Long)
+
+    data class DirState(
+        val path: String,
+        // null: list the directory again on the next sync
+        val lastModified: Long?,
+        // document ID -> name
+        val subdirs: Map<String, String>,
+        // document ID -> state
+        val files: Map<String, FileState>
+    )
+
+    val dirs = HashMap<String, DirState>()
+
+    /** Seq of the last Delta record applied to this cursor (0: none) */
+    var seq = 0
+
+    val fileCount: Int
+        get() = dirs.values.sumOf { it.files.size }
+
+    fun serialize(): ByteArray {
+        val buffer = ByteArrayOutputStream()
+        DataOutputStream(buffer).use { output ->
+            output.writeInt(VERSION)
+            output.writeInt(seq)
+            output.writeDirs(dirs)
+        }
+        return buffer.toByteArray()
+    }
+
+    /**
+     * What changed from [previous] to this cursor
+     */
+    fun diffFrom(previous: WatchCursor): Delta {
+        val changed = HashMap<String, DirState>()
+        for ((id, dir) in dirs) {
+            if (previous.dirs[id] != dir) changed[id] = dir
+        }
+        val removed = previous.dirs.keys.filterTo(HashSet()) { it !in dirs }
+        return Delta(changed, removed)
+    }
+
+    fun apply(delta: Delta) {
+        for (id in delta.removed) dirs.remove(id)
+        dirs.putAll(delta.dirs)
+    }
+
+    /**
+     * Directories added or changed ([dirs]) and removed ([removed]) between
+     * two cursors
+     */
+    class Delta(val dirs: Map<String, DirState>, val removed: Set<String>) {
+
+        companion object {
+            /** Null if the record is corrupt or from another version */
+            fun deserialize(bytes: ByteArray): Delta? {
+                return try {
+                    DataInputStream(ByteArrayInputStream(bytes)).use { input ->
+                        if (input.readInt() != DELTA_VERSION) return null
+                        val dirs = HashMap<String, DirState>()
+
+    /** Seq of the last Delta record applied to this cursor (0: none) */
+    var seq = 0
+                        input.readDirs(dirs)
+                        val removed = HashSet<String>()
+                        repeat(input.readCount()) { removed.add(input.readString()) }
+                        Delta(dirs, removed)
+                    }
+                } catch (e: IOException) {
+                    null
+                }
+            }
+        }
+
+        val size: Int
+            get() = dirs.size + removed.size
+
+        fun isEmpty(): Boolean = size == 0
+
+        fun serialize(): ByteArray {
+            val buffer = ByteArrayOutputStream()
+            DataOutputStream(buffer).use { output ->
+                output.writeInt(DELTA_VERSION)
+                output.writeDirs(dirs)
+                output.writeInt(removed.size)
+                for (id in removed) output.writeString(id)
+            }
+            return buffer.toByteArray()
+        }
+    }
+}
@@ -0,0 +1,266 @@
+package com.noleak.noleak.vault
+
+import com.noleak.noleak.security.SecureLog
+import kotlinx.coroutines.sync.Mutex
+import kotlinx.coroutines.sync.withLock
+import org.json.JSONArray
+import org.json.JSONObject
+import java.security.SecureRandom
+
+/**
+ * WatchedSourceStore - Watched folders of the open vault and their cursors
+ *
+ * Both live inside the vault as system files (hidden by their "__" prefix,
+ * like the folder map), so the folder URIs and source file names are only
+ * readable with the vault unlocked:
+ * - __watched_sources__: JSON list of sources
+ * - __watch_cursor_<id>__: serialized WatchCursor
+ * - __watch_delta_<id>_<seq>__: WatchCursor.Delta records applied on top
+ *   of the cursor in seq order. A sync that changed something writes one
+ *   record sized by what changed; the cursor is rewritten whole (and the
+ *   records dropped) only once they add up
+ */
+class WatchedSourceStore(private val vaultBridge: VaultBridge) {
+
+    companion object {
+        private const val TAG = "WatchedSourceStore"
+        private const val SOURCES_NAME = "__watched_sources__"
+        private const val CURSOR_PREFIX = "__watch_cursor_"
+        private const val DELTA_PREFIX = "__watch_delta_"
+        private const val SOURCES_VERSION = 1
+        private const val ID_BYTES = 8
+
+        // Records kept before the cursor is rewritten whole
+        private const val MAX_DELTAS = 32
+
+        private fun cursorName(id: String) = "$CURSOR_PREFIX${id}__"
+
+        private fun deltaName(id: String, seq: Int) = "$DELTA_PREFIX${id}_${seq}__"
+
+        private fun deltaSeq(id: String, name: String): Int? {
+            val prefix = "$DELTA_PREFIX${id}_"
+            if (!name.startsWith(prefix) || !name.endsWith("__")) return null
+            return name.substring(prefix.length, name.length - 2).toIntOrNull()
+        }
+    }
+
+    /**
+     * A watched SAF tree; imports land in [folder] (vault folder path)
+     */
+    class Source(val id: String, val uri: String, val name: String, val folder: String) {
+        fun toMap(): Map<String, Any> = mapOf(
+            "id" to id,
+            "uri" to uri,
+            "name" to name,
+            "folder" to folder
+        )
+    }
+
+    private val lock = Mutex()
+    private val random = SecureRandom()
+
+    suspend fun list(): List<Source> = lock.withLock { readSources() }
+
+    suspend fun find(id: String): Source? = lock.withLock { readSources().firstOrNull { it.id == id } }
+
+    /**
+     * Watch [uri], importing into [folder]; an existing identical source is
+     * returned as is
+     */
+    suspend fun add(uri: String, name: String, folder: String): Result<Source> = lock.withLock {
+        val sources = readSources()
+        sources.firstOrNull { it.uri == uri && it.folder == folder }?.let {
+            return@withLock Result.success(it)
+        }
+        val id = ByteArray(ID_BYTES).also { random.nextBytes(it) }
+            .joinToString("") { "%02x".format(it) }
+        val source = Source(id, uri, name, folder)
+        writeSources(sources + source).map { source }
+    }
+
+    /**
+     * Stop watching a source and drop its cursor; files already imported
+     * stay in the vault
+     */
+    suspend fun remove(id: String): Result<Boolean> = lock.withLock {
+        val sources = readSources()
+        if (sources.none { it.id == id }) return@withLock Result.success(false)
+        writeSources(sources.filter { it.id != id }).map {
+            deleteSystemFiles(cursorName(id), keep = null)
+            val files = vaultBridge.listFiles().getOrNull() ?: emptyList()
+            deleteEntries(deltas(id, files).map { it.second })
+            true
+        }
+    }
+
+    /**
+     * Cursor of the last sync, empty for a new source or an unreadable one
+     */
+    suspend fun loadCursor(source: Source): WatchCursor = lock.withLock {
+        val files = vaultBridge.listFiles().getOrNull() ?: return@withLock WatchCursor()
+        val bytes = readSystemFile(cursorName(source.id), files) ?: return@withLock WatchCursor()
+        val cursor = try {
+            WatchCursor.deserialize(bytes)
+        } finally {
+            VaultEngine.secureZeroize(bytes)
+        } ?: return@withLock WatchCursor().also {
+            SecureLog.w(TAG, "loadCursor: unreadable cursor, starting over")
+        }
+        for ((seq, entry) in deltas(source.id, files)) {
+            // Records at or below the cursor's seq are already folded in
+            if (seq <= cursor.seq) continue
+            val record = vaultBridge.readFile(entry.fileId).getOrNull()
+            val delta = try {
+                record?.let { WatchCursor.Delta.deserialize(it) }
+            } finally {
+                VaultEngine.secureZeroize(record)
+            }
+            if (delta == null) {
+                // Later records build on this one; the directories they
+                // cover are listed again instead
+                SecureLog.w(TAG, "loadCursor: unreadable delta record, ignoring the rest")
+                break
+            }
+            cursor.apply(delta)
+            cursor.seq = seq
+        }
+        cursor
+    }
+
+    /**
+     * Persist [next], the cursor that [previous] (as returned by
+     * [loadCursor]) became after a sync. Writes one record the size of
+     * what changed; after [MAX_DELTAS] records, or when the change is
+     * about as large as the cursor, the cursor is rewritten whole instead.
+     */
+    suspend fun saveCursor(source: Source, previous: WatchCursor, next: WatchCursor): Result<Unit> =
+        lock.withLock {
+            val delta = next.diffFrom(previous)
+            if (delta.isEmpty()) return@withLock Result.success(Unit)
+            val files = vaultBridge.listFiles().getOrElse { return@withLock Result.failure(it) }
+            val journal = deltas(source.id, files)
+            val lastSeq = maxOf(previous.seq, journal.lastOrNull()?.first ?: 0)
+            val hasCursor = files.any { it.name == cursorName(source.id) }
+
+            // previous.seq falls short of the journal when a record could
+            // not be read; a new record would be hidden behind it
+            if (hasCursor && previous.seq == lastSeq && journal.size < MAX_DELTAS &&
+                delta.size * 2 < next.dirs.size) {
+                val bytes = delta.serialize()
+                return@withLock try {
+                    vaultBridge.importFile(bytes, VaultEngine.FILE_TYPE_TXT,
+                        deltaName(source.id, lastSeq + 1), "application/octet-stream").map { }
+                } finally {
+                    VaultEngine.secureZeroize(bytes)
+                }
+            }
+
+            // The rewritten cursor covers every record so far, including
+            // any that could not be read
+            next.seq = lastSeq
+            val bytes = next.serialize()
+            try {
+                upsertSystemFile(cursorName(source.id), bytes, "application/octet-stream")
+            } finally {
+                VaultEngine.secureZeroize(bytes)
+            }.onSuccess {
+                deleteEntries(journal.map { it.second })
+            }
+        }
+
+    /** Delta records of source [id] among [files], in seq order */
+    private fun deltas(id: String, files: List<VaultFileEntry>): List<Pair<Int, VaultFileEntry>> =
+        files.mapNotNull { entry -> deltaSeq(id, entry.name)?.let { it to entry } }
+            .sortedBy { it.first }
+
+    private suspend fun deleteEntries(entries: List<VaultFileEntry>) {
+        if (entries.isEmpty()) return
+        vaultBridge.deleteFiles(entries.map { it.fileId }).onFailure {
+            SecureLog.w(TAG, "deleteEntries: stale records left for compaction")
+        }
+    }
+
+    private suspend fun readSources(): List<Source> {
+        val bytes = readSystemFile(SOURCES_NAME) ?: return emptyList()
+        return try {
+            val json = JSONObject(String(bytes, Charsets.UTF_8))
+            if (json.optInt("version") != SOURCES_VERSION) {
+                SecureLog.w(TAG, "readSources: unsupported version")
+                return emptyList()
+            }
+            val array = json.optJSONArray("sources") ?: return emptyList()
+            (0 until array.length()).map { i ->
+                val item = array.getJSONObject(i)
+                Source(
+                    id = item.getString("id"),
+                    uri = item.getString("uri"),
+                    name = item.optString("name", "folder"),
+                    folder = item.optString("folder", "")
+                )
+            }
+        } catch (e: Exception) {
+            SecureLog.e(TAG, "readSources: corrupt source list")
+            emptyList()
+        } finally {
+            VaultEngine.secureZeroize(bytes)
+        }
+    }
+
+    private suspend fun writeSources(sources: List<Source>): Result<Unit> {
+        val array = JSONArray()
+        for (source in sources) {
+            array.put(
+                JSONObject()
+                    .put("id", source.id)
+                    .put("uri", source.uri)
+                    .put("name", source.name)
+                    .put("folder", source.folder)
+            )
+        }
+        val json = JSONObject()
+            .put("version", SOURCES_VERSION)
+            .put("sources", array)
+        val bytes = json.toString().toByteArray(Charsets.UTF_8)
+        return try {
+            upsertSystemFile(SOURCES_NAME, bytes, "application/json")
+        } finally {
+            VaultEngine.secureZeroize(bytes)
+        }
+    }
+
+    private suspend fun readSystemFile(
+        name: String,
+        files: List<VaultFileEntry>? = null
+    ): ByteArray? {
+        val entry = (files ?: vaultBridge.listFiles().getOrNull())
+            ?.filter { it.name == name }
+            ?.maxByOrNull { it.createdAt }
+            ?: return null
+        return vaultBridge.readFile(entry.fileId).getOrElse {
+            SecureLog.e(TAG, "readSystemFile: read failed")
+            null
+        }
+    }
+
+    /**
+     * Write the new copy first and drop older ones after, so a failure
+     * leaves the previous copy readable
+     */
+    private suspend fun upsertSystemFile(name: String, data: ByteArray, mime: String): Result<Unit> {
+        val created = vaultBridge.importFile(data, VaultEngine.FILE_TYPE_TXT, name, mime)
+            .getOrElse { return Result.failure(it) }
+        deleteSystemFiles(name, keep = created)
+        return Result.success(Unit)
+    }
+
+    private suspend fun deleteSystemFiles(name: String, keep: ByteArray?) {
+        val stale = vaultBridge.listFiles().getOrNull()
+            ?.filter { it.name == name && (keep == null || !it.fileId.contentEquals(keep)) }
+            ?: return
+        for (entry in stale) {
+            vaultBridge.deleteFile(entry.fileId).onFailure {
+                SecureLog.w(TAG, "deleteSystemFiles: stale copy left for compaction")
+            }
+        }
+    }
+}
@@ -0,0 +1,94 @@
+package com.noleak.noleak.video
+
+import android.content.Context
+import android.media.MediaExtractor
+import android.media.MediaFormat
+import android.net.Uri
+import android.os.Build
+import com.noleak.noleak.security.SecureLog
+import com.noleak.noleak.vault.VaultMediaInfo
+
+/**
+ * MediaInfoProbe - Reads container metadata (size, rotation, duration,
+ * codecs, track layout) with MediaExtractor.
+ *
+ * Used on the plaintext source at import and, for files imported before
+ * metadata was stored, once on first playback.
+ */
+object MediaInfoProbe {
+    private const val TAG = "MediaInfoProbe"
+
+    /**
+     * Probe a SAF source before it is encrypted
+     */
+    fun probe(context: Context, uri: Uri): VaultMediaInfo? {
+        val extractor = MediaExtractor()
+        return try {
+            extractor.setDataSource(context, uri, null)
+            fromExtractor(extractor)
+        } catch (e: Exception) {
+            SecureLog.w(TAG, "Probe failed: ${e.message}")
+            null
+        } finally {
+            extractor.release()
+        }
+    }
+
+    /**
+     * Summarize the tracks of an extractor whose data source is already set
+     */
+    fun fromExtractor(extractor: MediaExtractor): VaultMediaInfo? {
+        var width = 0
+        var height = 0
+        var rotation = 0
+        var durationMs = 0L
+        var videoTracks = 0
+        var audioTracks = 0
+        var videoCodec: String? = null
+        var audioCodec: String? = null
+
+        for (i in 0 until extractor.trackCount) {
+            val format = extractor.getTrackFormat(i)
+            val mime = format.getString(MediaFormat.KEY_MIME) ?: continue
+            val trackDurationMs = if (format.containsKey(MediaFormat.KEY_DURATION)) {
+                format.getLong(MediaFormat.KEY_DURATION) / 1000
+            } else {
+                0L
+            }
+
+            if (mime.startsWith("video/")) {
+                videoTracks++
+                if (videoCodec != null) continue
+                videoCodec = mime
+                if (format.containsKey(MediaFormat.KEY_WIDTH)) {
+                    width = format.getInteger(MediaFormat.KEY_WIDTH)
+                }
+                if (format.containsKey(MediaFormat.KEY_HEIGHT)) {
+                    height = format.getInteger(MediaFormat.KEY_HEIGHT)
+                }
+                // KEY_ROTATION available from API 23
+                if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.M &&
+                    format.containsKey(MediaFormat.KEY_ROTATION)) {
+                    rotation = format.getInteger(MediaFormat.KEY_ROTATION)
+                }
+                if (trackDurationMs > 0) durationMs = trackDurationMs
+            } else if (mime.startsWith("audio/")) {
+                audioTracks++
+                if (audioCodec == null) audioCodec = mime
+                if (durationMs == 0L) durationMs = trackDurationMs
+            }
+        }
+
+        if (videoTracks == 0 && audioTracks == 0) return null
+        return VaultMediaInfo(
+            width = width,
+            height = height,
+            rotation = rotation,
+            durationMs = durationMs,
+            videoTracks = videoTracks,
+            audioTracks = audioTracks,
+            videoCodec = videoCodec,
+            audioCodec = audioCodec
+        )
+    }
+}
@@ -1,11 +1,11 @@
 package com.noleak.noleak.video
 
 import android.media.MediaExtractor
-import android.media.MediaFormat
 import android.media.MediaPlayer
 import android.os.Build
 import android.view.Surface
 import com.noleak.noleak.vault.VaultBridge
+import com.noleak.noleak.vault.VaultMediaInfo
 import com.noleak.noleak.security.SecureLog
 import java.util.concurrent.atomic.AtomicBoolean
 
@@ -72,8 +72,13 @@ class SecureVideoController(
             val actualSize = if (size > 0) size else chunkCount * VaultMediaDataSource.CHUNK_SIZE
             SecureLog.i(TAG, "Using fileSize=$actualSize")
 
-            // Step 1: Probe metadata using a separate DataSource
-            probeVideoMetadata(fileId, chunkCount, actualSize, width, height, durationMs)
+            // Step 1: Use metadata stored at import; probe only if missing
+            val storedInfo = vaultBridge.getMediaInfo(fileId)
+            if (storedInfo != null) {
+                applyMediaInfo(storedInfo)
+            } else {
+                probeVideoMetadata(fileId, chunkCount, actualSize, width, height, durationMs)
+            }
             
             SecureLog.i(TAG, "After probe: ${videoWidth}x${videoHeight}, duration=${videoDurationMs}ms")
 
@@ -217,9 +222,28 @@ class SecureVideoController(
     }
     
     /**
-     * Probe video metadata using a separate DataSource
+     * Apply stored metadata; width/height are swapped for portrait rotation
+     */
+    private fun applyMediaInfo(info: VaultMediaInfo) {
+        videoRotation = info.rotation
+        if (info.rotation == 90 || info.rotation == 270) {
+            videoWidth = info.height
+            videoHeight = info.width
+        } else {
+            videoWidth = info.width
+            videoHeight = info.height
+        }
+        if (info.durationMs > 0) videoDurationMs = info.durationMs
+        SecureLog.d(TAG, "Stored metadata: ${videoWidth}x${videoHeight}, duration=${videoDurationMs}ms, rotation=${videoRotation}°")
+    }
+
+    /**
+     * Probe video metadata using a separate DataSource and record it in the
+     * index so later opens skip this pass.
+     * MediaExtractor.release() closes its source, so the probe source cannot
+     * be handed on to MediaPlayer.
      */
-    private fun probeVideoMetadata(
+    private suspend fun probeVideoMetadata(
         fileId: ByteArray,
         chunkCount: Int,
         fileSize: Long,
@@ -234,6 +258,7 @@ class SecureVideoController(
         
         // Try to probe for actual values
         var probeDataSource: VaultMediaDataSource? = null
+        var probed: VaultMediaInfo? = null
         try {
             SecureLog.d(TAG, "Probing metadata with separate DataSource...")
             probeDataSource = VaultMediaDataSource(
@@ -244,64 +269,30 @@ class SecureVideoController(
             )
             
             val extractor = MediaExtractor()
-            extractor.setDataSource(probeDataSource)
-            
-            SecureLog.d(TAG, "Probe: ${extractor.trackCount} tracks found")
-            
-            for (i in 0 until extractor.trackCount) {
-                val format = extractor.getTrackFormat(i)
-                val mime = format.getString(MediaFormat.KEY_MIME) ?: continue
-                
-                SecureLog.d(TAG, "Probe track $i: mime=$mime")
-                
-                if (mime.startsWith("video/")) {
-                    var rawWidth = 0
-                    var rawHeight = 0
-                    var rotation = 0
-                    
-                    if (format.containsKey(MediaFormat.KEY_WIDTH)) {
-                        rawWidth = format.getInteger(MediaFormat.KEY_WIDTH)
-                    }
-                    if (format.containsKey(MediaFormat.KEY_HEIGHT)) {
-                        rawHeight = format.getInteger(MediaFormat.KEY_HEIGHT)
-                    }
-                    if (format.containsKey(MediaFormat.KEY_DURATION)) {
-                        videoDurationMs = format.getLong(MediaFormat.KEY_DURATION) / 1000
-                    }
-                    // Read rotation - KEY_ROTATION available from API 23
-                    if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.M) {
-                        if (format.containsKey(MediaFormat.KEY_ROTATION)) {
-                            rotation = format.getInteger(MediaFormat.KEY_ROTATION)
-                        }
-                    }
-                    
-                    SecureLog.d(TAG, "Probe raw: ${rawWidth}x${rawHeight}, rotation=${rotation}°")
-                    
-                    // If rotation is 90 or 270, swap width and height for display
-                    videoRotation = rotation
-                    if (rotation == 90 || rotation == 270) {
-                        videoWidth = rawHeight
-                        videoHeight = rawWidth
-                        SecureLog.d(TAG, "Swapped for portrait: ${videoWidth}x${videoHeight}")
-                    } else {
-                        videoWidth = rawWidth
-                        videoHeight = rawHeight
-                    }
-                    
-                    SecureLog.d(TAG, "Probe result: ${videoWidth}x${videoHeight}, duration=${videoDurationMs}ms, rotation=${rotation}°")
-                    break
-                } else if (mime.startsWith("audio/") && videoDurationMs == 0L) {
-                    if (format.containsKey(MediaFormat.KEY_DURATION)) {
-                        videoDurationMs = format.getLong(MediaFormat.KEY_DURATION) / 1000
-                    }
-                }
+            try {
+                extractor.setDataSource(probeDataSource)
+                SecureLog.d(TAG, "Probe: ${extractor.trackCount} tracks found")
+                probed = MediaInfoProbe.fromExtractor(extractor)
+            } finally {
+                extractor.release()
             }
-            extractor.release()
         } catch (e: Exception) {
             SecureLog.w(TAG, "Probe failed: ${e.message}")
         } finally {
             probeDataSource?.close()
         }
+
+        val info = probed ?: return
+        if (info.videoTracks > 0) {
+            applyMediaInfo(info)
+        } else if (videoDurationMs == 0L && info.durationMs > 0) {
+            videoDurationMs = info.durationMs
+        }
+
+        // Backfill for files imported before metadata was stored
+        vaultBridge.setMediaInfo(fileId, info).onFailure {
+            SecureLog.w(TAG, "Storing metadata failed: ${it.message}")
+        }
     }
     
     private fun getErrorDescription(what: Int, extra: Int): String {
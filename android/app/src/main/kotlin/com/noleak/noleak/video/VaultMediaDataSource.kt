@@ -39,6 +39,7 @@ class VaultMediaDataSource(
         const val CHUNK_SIZE: Long = 1024L * 1024L // Default/legacy chunk size (1MB)
         private const val TAG = "VaultMediaDataSource"
         private const val PRELOAD_TIMEOUT_MS = 60_000L
+        private const val PRELOAD_BATCH_BYTES = 16L * 1024L * 1024L
         
         // Threshold: 150MB - files below this are fully preloaded
         private const val MAX_PRELOAD_SIZE = 150L * 1024L * 1024L 
@@ -199,15 +200,19 @@ class VaultMediaDataSource(
         var data: ByteArray? = null
         try {
             data = ByteArray(fileSize.toInt())
+            // Batched native reads: one I/O and parallel decrypt per batch,
+            // written straight into the preload buffer
+            val batchChunks = maxOf(1L, PRELOAD_BATCH_BYTES / chunkSizeBytes).toInt()
             var offset = 0
             runBlocking(Dispatchers.IO) {
                 withTimeout(PRELOAD_TIMEOUT_MS) {
-                    for (i in 0 until chunkCount) {
-                        val chunk = vaultBridge.readChunk(fileId, i).getOrNull() ?: throw IOException("Chunk $i")
-                        val copySize = minOf(chunk.size, data!!.size - offset)
-                        System.arraycopy(chunk, 0, data, offset, copySize)
-                        offset += copySize
-                        secureZeroize(chunk)
+                    var first = 0
+                    while (first < chunkCount && offset < data!!.size) {
+                        val count = minOf(batchChunks, chunkCount - first)
+                        val written = vaultBridge.readChunks(fileId, first, count, data!!, offset)
+                            .getOrNull() ?: throw IOException("Chunks $first+$count")
+                        offset += written
+                        first += count
                     }
                 }
             }
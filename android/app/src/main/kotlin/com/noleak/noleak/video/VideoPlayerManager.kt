@@ -32,6 +32,8 @@ class VideoPlayerManager private constructor(
     
     private val handleCounter = AtomicInteger(0)
     private val controllers = ConcurrentHashMap<Int, SecureVideoController>()
+    // Opens between reading the chunk layout and registering the controller
+    private val opening = AtomicInteger(0)
     private val scope = CoroutineScope(Dispatchers.Main + SupervisorJob())
     
     /**
@@ -143,6 +145,25 @@ class VideoPlayerManager private constructor(
         return true
     }
     
+    /**
+     * Run [block], which reads a video's chunk layout and opens it, counted
+     * as an open video throughout so no re-chunk starts in between
+     */
+    suspend fun <T> whileOpening(block: suspend () -> T): T {
+        opening.incrementAndGet()
+        try {
+            return block()
+        } finally {
+            opening.decrementAndGet()
+        }
+    }
+
+    /**
+     * Whether any video is open or opening (its data source caches the
+     * chunk layout)
+     */
+    fun hasOpenVideos(): Boolean = controllers.isNotEmpty() || opening.get() > 0
+
     /**
      * Close all videos
      */
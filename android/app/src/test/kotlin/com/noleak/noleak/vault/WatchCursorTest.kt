@@ -0,0 +1,104 @@
+package com.noleak.noleak.vault
+
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertNull
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import java.io.ByteArrayOutputStream
+import java.io.DataOutputStream
+
+class WatchCursorTest {
+
+    private fun sample(): WatchCursor {
+        val cursor = WatchCursor()
+        cursor.dirs["root"] = WatchCursor.DirState(
+            path = "Camera",
+            lastModified = 1_700_000_000_000L,
+            subdirs = mapOf("sub" to "2024 – Été"),
+            files = mapOf(
+                "a" to WatchCursor.FileState(1234L, 1_700_000_000_001L),
+                "b" to WatchCursor.FileState(-1L, -1L)
+            )
+        )
+        cursor.dirs["sub"] = WatchCursor.DirState(
+            path = "Camera/2024 – Été",
+            lastModified = null,
+            subdirs = emptyMap(),
+            files = mapOf("c" to WatchCursor.FileState(0L, 5L))
+        )
+        cursor.seq = 7
+        return cursor
+    }
+
+    @Test
+    fun cursorRoundTrip() {
+        val cursor = sample()
+        val copy = WatchCursor.deserialize(cursor.serialize())!!
+        assertEquals(cursor.dirs, copy.dirs)
+        assertEquals(7, copy.seq)
+        assertEquals(3, copy.fileCount)
+        // A directory without a stamp stays unstamped
+        assertNull(copy.dirs["sub"]!!.lastModified)
+
+        val empty = WatchCursor.deserialize(WatchCursor().serialize())!!
+        assertTrue(empty.dirs.isEmpty())
+    }
+
+    @Test
+    fun readsVersionOneCursors() {
+        val buffer = ByteArrayOutputStream()
+        DataOutputStream(buffer).use { output ->
+            output.writeInt(1)
+            output.writeInt(1)
+            for (value in listOf("root", "Camera")) {
+                val bytes = value.toByteArray(Charsets.UTF_8)
+                output.writeInt(bytes.size)
+                output.write(bytes)
+            }
+            output.writeLong(42L)
+            output.writeInt(0)
+            output.writeInt(0)
+        }
+        val cursor = WatchCursor.deserialize(buffer.toByteArray())!!
+        assertEquals(0, cursor.seq)
+        assertEquals(42L, cursor.dirs["root"]!!.lastModified)
+    }
+
+    @Test
+    fun rejectsCorruptCursors() {
+        val bytes = sample().serialize()
+        assertNull(WatchCursor.deserialize(bytes.copyOf(bytes.size - 3)))
+        assertNull(WatchCursor.deserialize(ByteArray(0)))
+        val otherVersion = bytes.copyOf().also { it[3] = 99 }
+        assertNull(WatchCursor.deserialize(otherVersion))
+        // A negative count is caught before anything is allocated
+        val negative = bytes.copyOf().also { it[8] = 0x80.toByte() }
+        assertNull(WatchCursor.deserialize(negative))
+    }
+
+    @Test
+    fun deltaRoundTripRebuildsTheNextCursor() {
+        val previous = sample()
+        val next = WatchCursor()
+        next.dirs.putAll(previous.dirs)
+        next.dirs.remove("sub")
+        next.dirs["root"] = previous.dirs["root"]!!.copy(
+            lastModified = 1_700_000_000_500L,
+            subdirs = emptyMap(),
+            files = previous.dirs["root"]!!.files + ("d" to WatchCursor.FileState(9L, 9L))
+        )
+        next.dirs["new"] = WatchCursor.DirState("Camera/new", 3L, emptyMap(), emptyMap())
+
+        val delta = next.diffFrom(previous)
+        assertEquals(setOf("root", "new"), delta.dirs.keys)
+        assertEquals(setOf("sub"), delta.removed)
+
+        val replayed = WatchCursor.deserialize(previous.serialize())!!
+        replayed.apply(WatchCursor.Delta.deserialize(delta.serialize())!!)
+        assertEquals(next.dirs, replayed.dirs)
+
+        assertTrue(next.diffFrom(next).isEmpty())
+        val bytes = delta.serialize()
+        assertNull(WatchCursor.Delta.deserialize(bytes.copyOf(bytes.size - 1)))
+    }
+}
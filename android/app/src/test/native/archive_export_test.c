@@ -0,0 +1,148 @@
+#include "vault_archive.h"
+#include "vault_engine.h"
+#include "vault_tier.h"
+#include <assert.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+extern vault_state_t g_vault;
+
+static const char *kPath = "/tmp/archive_export_test.vault";
+static const char *kArchive = "/tmp/archive_export_test.bin";
+static const char *kPass = "correct horse battery";
+
+static const vault_entry_t *find_entry(const uint8_t *id) {
+  for (uint32_t i = 0; i < g_vault.entry_count; i++) {
+    if (memcmp(g_vault.entries[i].file_id, id, VAULT_ID_LEN) == 0)
+      return &g_vault.entries[i];
+  }
+  return NULL;
+}
+
+static const vault_archive_member_t *
+find_member(const vault_archive_member_t *members, uint32_t count,
+            const char *folder, const char *name) {
+  for (uint32_t i = 0; i < count; i++) {
+    if (strcmp(members[i].folder, folder) == 0 &&
+        strcmp(members[i].name, name) == 0)
+      return &members[i];
+  }
+  return NULL;
+}
+
+static void assert_content(const vault_archive_member_t *member,
+                           const uint8_t *expected, size_t len) {
+  assert(member && member->size == len);
+  uint8_t *out = malloc(len + 16);
+  size_t got = 0;
+  assert(vault_read_range(member->file_id, 0, out, len + 16, &got) ==
+         VAULT_OK);
+  assert(got == len && memcmp(out, expected, len) == 0);
+  free(out);
+}
+
+// Export, read the archive back through the importer and compare
+static void round_trip(int format, const vault_export_item_t *items,
+                       uint32_t count, const uint8_t *video, size_t video_len,
+                       const char *note) {
+  int fd = open(kArchive, O_RDWR | O_CREAT | O_TRUNC, 0600);
+  assert(fd >= 0);
+  assert(vault_export_archive(fd, items, count, format) == VAULT_OK);
+  // Progress counts member bytes, which is what the UI compares to sizes
+  assert(vault_archive_bytes_written() == video_len + 3 * strlen(note));
+  assert(lseek(fd, 0, SEEK_SET) == 0);
+
+  vault_archive_member_t *members = NULL;
+  uint32_t imported = 0;
+  uint32_t skipped = 0;
+  assert(vault_import_archive(fd, &members, &imported, &skipped) == VAULT_OK);
+  close(fd);
+  assert(imported == count && skipped == 0);
+  assert_content(find_member(members, imported, "docs", "notes.txt"),
+                 (const uint8_t *)note, strlen(note));
+  assert_content(find_member(members, imported, "media", "clip.mp4"), video,
+                 video_len);
+  assert_content(find_member(members, imported, "media", "clip (2).mp4"),
+                 (const uint8_t *)note, strlen(note));
+  assert_content(find_member(members, imported, "x", "a_b_c.txt"),
+                 (const uint8_t *)note, strlen(note));
+  vault_archive_free_members(members, imported);
+}
+
+int main(void) {
+  assert(vault_init() == VAULT_OK);
+  unlink(kPath);
+  assert(vault_create(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+  assert(vault_open(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+
+  // Chunked file with a partial last chunk, and a single-blob file
+  size_t video_len = 9 * 1024 * 1024 + 321;
+  uint8_t *video = malloc(video_len);
+  for (size_t i = 0; i < video_len; i++)
+    video[i] = (uint8_t)(i * 13 + (i >> 10));
+  uint8_t video_id[VAULT_ID_LEN];
+  assert(vault_import_file(video, video_len, VAULT_FILE_TYPE_VIDEO, "v.mp4",
+                           "video/mp4", video_id) == VAULT_OK);
+  const char *note = "member bytes must survive the round trip";
+  uint8_t note_id[VAULT_ID_LEN];
+  assert(vault_import_file((const uint8_t *)note, strlen(note),
+                           VAULT_FILE_TYPE_TXT, "n.txt", "text/plain",
+                           note_id) == VAULT_OK);
+  uint64_t video_seen = vault_tier_last_access(find_entry(video_id));
+  uint64_t note_seen = vault_tier_last_access(find_entry(note_id));
+
+  // Paths are cleaned by the writer; the caller has already made them unique
+  vault_export_item_t items[4];
+  memcpy(items[0].file_id, note_id, VAULT_ID_LEN);
+  items[0].path = "/docs/./notes.txt";
+  memcpy(items[1].file_id, video_id, VAULT_ID_LEN);
+  items[1].path = "../media//clip.mp4";
+  memcpy(items[2].file_id, note_id, VAULT_ID_LEN);
+  items[2].path = "media/clip (2).mp4";
+  memcpy(items[3].file_id, note_id, VAULT_ID_LEN);
+  items[3].path = "x/a\\b\tc.txt";
+
+  round_trip(VAULT_ARCHIVE_FORMAT_ZIP, items, 4, video, video_len, note);
+  round_trip(VAULT_ARCHIVE_FORMAT_TAR, items, 4, video, video_len, note);
+
+  // Exporting is not an access for cold-tier selection
+  assert(vault_tier_last_access(find_entry(video_id)) == video_seen);
+  assert(vault_tier_last_access(find_entry(note_id)) == note_seen);
+
+  // A prepared export writes its snapshot even after later commits replace
+  // the index (the bridge no longer holds the vault lock while writing)
+  assert(vault_export_prepare(items, 4) == VAULT_OK);
+  uint8_t later_id[VAULT_ID_LEN];
+  assert(vault_import_file((const uint8_t *)"later", 5, VAULT_FILE_TYPE_TXT,
+                           "later.txt", "text/plain", later_id) == VAULT_OK);
+  assert(vault_rename_file(note_id, "renamed.txt") == VAULT_OK);
+  int snap_fd = open(kArchive, O_RDWR | O_CREAT | O_TRUNC, 0600);
+  assert(snap_fd >= 0);
+  assert(vault_export_write(snap_fd, VAULT_ARCHIVE_FORMAT_TAR) == VAULT_OK);
+  assert(vault_archive_bytes_written() == video_len + 3 * strlen(note));
+  assert(vault_export_write(snap_fd, VAULT_ARCHIVE_FORMAT_TAR) ==
+         VAULT_ERR_INVALID_PARAM);
+  close(snap_fd);
+
+  // Nothing is written for an unknown ID or a path that cleans to nothing
+  int fd = open(kArchive, O_RDWR | O_CREAT | O_TRUNC, 0600);
+  assert(fd >= 0);
+  items[1].path = "../..";
+  assert(vault_export_archive(fd, items, 2, VAULT_ARCHIVE_FORMAT_ZIP) ==
+         VAULT_ERR_INVALID_PARAM);
+  memset(items[0].file_id, 0xEE, VAULT_ID_LEN);
+  assert(vault_export_archive(fd, items, 1, VAULT_ARCHIVE_FORMAT_TAR) ==
+         VAULT_ERR_NOT_FOUND);
+  assert(lseek(fd, 0, SEEK_END) == 0);
+  close(fd);
+
+  vault_close();
+  unlink(kPath);
+  unlink(kArchive);
+  free(video);
+  return 0;
+}
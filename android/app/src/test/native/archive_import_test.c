@@ -0,0 +1,397 @@
+// Built in place of vault_archive.c so the static parsers are reachable,
+// with limits small enough to reach.
+#include <stdint.h>
+static uint64_t g_space_reserve;
+#define ARCHIVE_MAX_MEMBER_SIZE 64
+#define ARCHIVE_SPACE_RESERVE g_space_reserve
+#include "vault_archive.c"
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+
+static const char *kPath = "/tmp/archive_import_test.vault";
+static const char *kArchive = "/tmp/archive_import_test.bin";
+static const char *kPass = "correct horse battery";
+
+typedef struct {
+  uint8_t data[64 * 1024];
+  size_t len;
+} buf_t;
+
+static void put(buf_t *b, const void *p, size_t n) {
+  assert(b->len + n <= sizeof(b->data));
+  memcpy(b->data + b->len, p, n);
+  b->len += n;
+}
+
+static void put16(buf_t *b, uint16_t v) {
+  uint8_t p[2] = {(uint8_t)v, (uint8_t)(v >> 8)};
+  put(b, p, 2);
+}
+
+static void put32(buf_t *b, uint32_t v) {
+  put16(b, (uint16_t)v);
+  put16(b, (uint16_t)(v >> 16));
+}
+
+static void put64(buf_t *b, uint64_t v) {
+  put32(b, (uint32_t)v);
+  put32(b, (uint32_t)(v >> 32));
+}
+
+// mode: 0 stored, 1 deflated with a data descriptor, 2 stored with ZIP64
+static void zip_member(buf_t *b, const char *name, const char *text, int mode) {
+  size_t len = strlen(text);
+  uint32_t crc = (uint32_t)crc32(0, (const Bytef *)text, (uInt)len);
+  uint8_t packed[1024];
+  size_t packed_len = len;
+  if (mode == 1) {
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    assert(deflateInit2(&z, 6, Z_DEFLATED, -MAX_WBITS, 8,
+                        Z_DEFAULT_STRATEGY) == Z_OK);
+    z.next_in = (Bytef *)text;
+    z.avail_in = (uInt)len;
+    z.next_out = packed;
+    z.avail_out = sizeof(packed);
+    assert(deflate(&z, Z_FINISH) == Z_STREAM_END);
+    packed_len = z.total_out;
+    deflateEnd(&z);
+  } else {
+    memcpy(packed, text, len);
+  }
+
+  put32(b, ZIP_LOCAL_SIG);
+  put16(b, 45);
+  put16(b, mode == 1 ? ZIP_FLAG_DESCRIPTOR : 0);
+  put16(b, mode == 1 ? ZIP_METHOD_DEFLATE : ZIP_METHOD_STORED);
+  put32(b, 0);
+  put32(b, mode == 1 ? 0 : crc);
+  put32(b, mode == 2 ? 0xFFFFFFFFu : (mode == 1 ? 0 : (uint32_t)packed_len));
+  put32(b, mode == 2 ? 0xFFFFFFFFu : (mode == 1 ? 0 : (uint32_t)len));
+  put16(b, (uint16_t)strlen(name));
+  put16(b, mode == 2 ? 20 : 0);
+  put(b, name, strlen(name));
+  if (mode == 2) {
+    put16(b, ZIP_EXTRA_ZIP64);
+    put16(b, 16);
+    put64(b, len);
+    put64(b, packed_len);
+  }
+  put(b, packed, packed_len);
+  if (mode == 1) {
+    put32(b, ZIP_DESCRIPTOR_SIG);
+    put32(b, crc);
+    put32(b, (uint32_t)packed_len);
+    put32(b, (uint32_t)len);
+  }
+}
+
+static void zip_end(buf_t *b) {
+  put32(b, ZIP_END_SIG);
+  uint8_t rest[18] = {0};
+  put(b, rest, sizeof(rest));
+}
+
+static void tar_header(buf_t *b, const char *name, char type, size_t size) {
+  uint8_t block[TAR_BLOCK] = {0};
+  snprintf((char *)block, 100, "%s", name);
+  snprintf((char *)block + 100, 8, "%07o", 0644);
+  snprintf((char *)block + 124, 12, "%011zo", size);
+  block[156] = (uint8_t)type;
+  memcpy(block + 257, "ustar", 6);
+  memcpy(block + 263, "00", 2);
+  memset(block + 148, ' ', 8);
+  unsigned sum = 0;
+  for (size_t i = 0; i < TAR_BLOCK; i++)
+    sum += block[i];
+  snprintf((char *)block + 148, 8, "%06o", sum);
+  put(b, block, TAR_BLOCK);
+}
+
+static void tar_data(buf_t *b, const char *data, size_t len) {
+  put(b, data, len);
+  uint8_t zero[TAR_BLOCK] = {0};
+  put(b, zero, (TAR_BLOCK - len % TAR_BLOCK) % TAR_BLOCK);
+}
+
+static int import_bytes(const uint8_t *data, size_t len,
+                        vault_archive_member_t **members, uint32_t *count,
+                        uint32_t *skipped) {
+  FILE *f = fopen(kArchive, "wb");
+  assert(f);
+  assert(fwrite(data, 1, len, f) == len);
+  fclose(f);
+  int fd = open(kArchive, O_RDONLY);
+  assert(fd >= 0);
+  int result = vault_import_archive(fd, members, count, skipped);
+  close(fd);
+  return result;
+}
+
+static const vault_archive_member_t *
+find_member(const vault_archive_member_t *members, uint32_t count,
+            const char *folder, const char *name) {
+  for (uint32_t i = 0; i < count; i++) {
+    if (strcmp(members[i].folder, folder) == 0 &&
+        strcmp(members[i].name, name) == 0)
+      return &members[i];
+  }
+  return NULL;
+}
+
+static void assert_content(const vault_archive_member_t *member,
+                           const char *text) {
+  uint8_t out[1024];
+  size_t got = 0;
+  assert(member);
+  assert(vault_read_range(member->file_id, 0, out, sizeof(out), &got) ==
+         VAULT_OK);
+  assert(got == strlen(text) && memcmp(out, text, got) == 0);
+}
+
+static void test_split_path(void) {
+  char *folder = NULL;
+  char *name = NULL;
+  const char *path = "../a\\b/./../c.txt";
+  assert(archive_split_path(path, strlen(path), &folder, &name) == VAULT_OK);
+  assert(strcmp(folder, "a/b") == 0 && strcmp(name, "c.txt") == 0);
+  free(folder);
+  free(name);
+
+  path = "/../../top.jpg";
+  assert(archive_split_path(path, strlen(path), &folder, &name) == VAULT_OK);
+  assert(strcmp(folder, "") == 0 && strcmp(name, "top.jpg") == 0);
+  free(folder);
+  free(name);
+
+  const char *rejected[] = {"__MACOSX/photos/._a.jpg", "photos/", "._a.jpg",
+                            "x/.DS_Store", "__folder_map__", "../.."};
+  for (size_t i = 0; i < sizeof(rejected) / sizeof(rejected[0]); i++) {
+    assert(archive_split_path(rejected[i], strlen(rejected[i]), &folder,
+                              &name) == VAULT_OK);
+    assert(!folder && !name);
+  }
+}
+
+static void test_pax(void) {
+  char *path = NULL;
+  uint64_t size = 0;
+  int has_size = 0;
+  const char *records = "21 path=deep/name.md\n15 size=123456\n11 mtime=1\n";
+  assert(tar_apply_pax(records, strlen(records), &path, &size, &has_size) ==
+         VAULT_OK);
+  assert(strcmp(path, "deep/name.md") == 0);
+  assert(has_size && size == 123456);
+  free(path);
+  path = NULL;
+
+  // Length past the end, missing space, zero length
+  const char *bad[] = {"99 path=x\n", "12path=abc\n", "0 path=x\n"};
+  for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+    assert(tar_apply_pax(bad[i], strlen(bad[i]), &path, &size, &has_size) ==
+           VAULT_ERR_CORRUPTED);
+    free(path);
+    path = NULL;
+  }
+}
+
+static void test_zip(void) {
+  static buf_t zip;
+  zip.len = 0;
+  zip_member(&zip, "../../etc/passwd", "not really", 0);
+  zip_member(&zip, "__MACOSX/docs/._notes.txt", "resource fork", 0);
+  zip_member(&zip, "docs/", "", 0);
+  zip_member(&zip, "docs/notes.txt", "deflated behind a data descriptor", 1);
+  zip_member(&zip, "big/video.bin", "sized by a zip64 extra field", 2);
+  size_t end = zip.len;
+  zip_end(&zip);
+
+  uint32_t before = g_vault.entry_count;
+  vault_archive_member_t *members = NULL;
+  uint32_t count = 0;
+  uint32_t skipped = 0;
+  assert(import_bytes(zip.data, zip.len, &members, &count, &skipped) ==
+         VAULT_OK);
+  assert(count == 3 && skipped == 1);
+  assert(g_vault.entry_count == before + 3);
+  assert_content(find_member(members, count, "etc", "passwd"), "not really");
+  assert_content(find_member(members, count, "docs", "notes.txt"),
+                 "deflated behind a data descriptor");
+  assert_content(find_member(members, count, "big", "video.bin"),
+                 "sized by a zip64 extra field");
+  vault_archive_free_members(members, count);
+
+  // Cut anywhere before the end record: corrupted, and nothing committed
+  for (size_t cut = 4; cut <= end; cut += 3) {
+    members = NULL;
+    count = 0;
+    assert(import_bytes(zip.data, cut, &members, &count, &skipped) ==
+           VAULT_ERR_CORRUPTED);
+    assert(!members && count == 0);
+  }
+  assert(g_vault.entry_count == before + 3);
+}
+
+static void test_tar(void) {
+  static buf_t tar;
+  tar.len = 0;
+  char long_path[200];
+  memset(long_path, 'd', sizeof(long_path));
+  memcpy(long_path + 150, "/../long-name.txt", 18);
+  char record[256];
+  int record_len = (int)strlen(long_path) + 10;
+  snprintf(record, sizeof(record), "%d path=%s\n", record_len, long_path);
+  assert((int)strlen(record) == record_len);
+  tar_header(&tar, "PaxHeader", 'x', strlen(record));
+  tar_data(&tar, record, strlen(record));
+  tar_header(&tar, "truncated-by-pax", '0', 5);
+  tar_data(&tar, "hello", 5);
+  tar_header(&tar, "link", '2', 0);
+  tar_header(&tar, "../plain.txt", '0', 3);
+  tar_data(&tar, "abc", 3);
+  size_t end = tar.len;
+  uint8_t zero[TAR_BLOCK * 2] = {0};
+  put(&tar, zero, sizeof(zero));
+
+  vault_archive_member_t *members = NULL;
+  uint32_t count = 0;
+  uint32_t skipped = 0;
+  assert(import_bytes(tar.data, tar.len, &members, &count, &skipped) ==
+         VAULT_OK);
+  assert(count == 2 && skipped == 1);
+  char folder[151];
+  memset(folder, 'd', 150);
+  folder[150] = '\0';
+  assert_content(find_member(members, count, folder, "long-name.txt"),
+                 "hello");
+  assert_content(find_member(members, count, "", "plain.txt"), "abc");
+  vault_archive_free_members(members, count);
+
+  for (size_t cut = TAR_BLOCK + 1; cut < end; cut += 97) {
+    members = NULL;
+    count = 0;
+    assert(import_bytes(tar.data, cut, &members, &count, &skipped) ==
+           VAULT_ERR_CORRUPTED);
+  }
+}
+
+static void test_search(void) {
+  static buf_t zip;
+  zip.len = 0;
+  zip_member(&zip, "notes/todo.txt", "feed the aardvark on Tuesday", 1);
+  zip_member(&zip, "photos/aardvark.jpg", "aardvark pixels", 0);
+  zip_end(&zip);
+
+  vault_archive_member_t *members = NULL;
+  uint32_t count = 0;
+  uint32_t skipped = 0;
+  assert(import_bytes(zip.data, zip.len, &members, &count, &skipped) ==
+         VAULT_OK);
+  assert(count == 2);
+  const vault_archive_member_t *todo =
+      find_member(members, count, "notes", "todo.txt");
+  assert(todo);
+
+  // Text members are tokenized at import; other types are not
+  uint8_t *ids = NULL;
+  uint32_t found = 0;
+  assert(vault_search_query("aardvark tuesday", 0, &ids, &found) == VAULT_OK);
+  assert(found == 1 && memcmp(ids, todo->file_id, VAULT_ID_LEN) == 0);
+  free(ids);
+  vault_archive_free_members(members, count);
+}
+
+static void test_limits(void) {
+  static buf_t tar;
+  tar.len = 0;
+  char big[ARCHIVE_MAX_MEMBER_SIZE + 1];
+  memset(big, 'x', sizeof(big));
+  tar_header(&tar, "big.bin", '0', sizeof(big));
+  tar_data(&tar, big, sizeof(big));
+  tar_header(&tar, "after.txt", '0', 4);
+  tar_data(&tar, "fits", 4);
+  uint8_t zero[TAR_BLOCK * 2] = {0};
+  put(&tar, zero, sizeof(zero));
+
+  // A member over the cap is skipped and its staged chunks dropped
+  vault_archive_member_t *members = NULL;
+  uint32_t count = 0;
+  uint32_t skipped = 0;
+  assert(import_bytes(tar.data, tar.len, &members, &count, &skipped) ==
+         VAULT_OK);
+  assert(count == 1 && skipped == 1);
+  assert_content(find_member(members, count, "", "after.txt"), "fits");
+  vault_archive_free_members(members, count);
+
+  // Without room for the spool and its copy nothing is imported
+  uint32_t before = g_vault.entry_count;
+  g_space_reserve = UINT64_MAX;
+  members = NULL;
+  count = 0;
+  assert(import_bytes(tar.data, tar.len, &members, &count, &skipped) ==
+         VAULT_ERR_IO);
+  assert(!members && count == 0 && g_vault.entry_count == before);
+  g_space_reserve = 0;
+}
+
+static void test_stage_commit(void) {
+  static buf_t zip;
+  zip.len = 0;
+  zip_member(&zip, "staged.txt", "written while unlocked", 0);
+  zip_end(&zip);
+  FILE *f = fopen(kArchive, "wb");
+  assert(f);
+  assert(fwrite(zip.data, 1, zip.len, f) == zip.len);
+  fclose(f);
+  int fd = open(kArchive, O_RDONLY);
+  assert(fd >= 0);
+  uint32_t count = 0;
+  uint32_t skipped = 0;
+  uint32_t before = g_vault.entry_count;
+  assert(vault_archive_stage(fd, &count, &skipped) == VAULT_OK);
+  close(fd);
+  assert(count == 1 && g_vault.entry_count == before);
+
+  // Another writer may commit between staging and the archive's commit
+  uint8_t other[VAULT_ID_LEN];
+  assert(vault_import_file((const uint8_t *)"meanwhile", 9,
+                           VAULT_FILE_TYPE_TXT, "other.txt", "text/plain",
+                           other) == VAULT_OK);
+  vault_archive_member_t *members = NULL;
+  assert(vault_archive_commit(&members, &count, &skipped) == VAULT_OK);
+  assert(count == 1 && g_vault.entry_count == before + 2);
+  assert_content(find_member(members, count, "", "staged.txt"),
+                 "written while unlocked");
+  uint8_t out[16];
+  size_t got = 0;
+  assert(vault_read_range(other, 0, out, sizeof(out), &got) == VAULT_OK);
+  assert(got == 9 && memcmp(out, "meanwhile", 9) == 0);
+  vault_archive_free_members(members, count);
+
+  // The stage is consumed by its commit
+  assert(vault_archive_commit(&members, &count, &skipped) ==
+         VAULT_ERR_INVALID_PARAM);
+}
+
+int main(void) {
+  assert(vault_init() == VAULT_OK);
+  unlink(kPath);
+  assert(vault_create(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+  assert(vault_open(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+
+  test_split_path();
+  test_pax();
+  test_zip();
+  test_tar();
+  test_search();
+  test_limits();
+  test_stage_commit();
+
+  vault_close();
+  unlink(kPath);
+  unlink(kArchive);
+  return 0;
+}
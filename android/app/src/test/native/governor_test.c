@@ -0,0 +1,144 @@
+#include "vault_governor.h"
+#include <assert.h>
+#include <string.h>
+#include <unistd.h>
+
+static vault_governor_signals_t g_fake;
+static int g_fake_known;
+
+static int fake_sample(void *ctx, vault_governor_signals_t *out) {
+  (void)ctx;
+  if (!g_fake_known)
+    return -1;
+  *out = g_fake;
+  return 0;
+}
+
+static void set_fake(float headroom, int thermal, int battery, int charging,
+                     int power_save) {
+  g_fake.thermal_headroom = headroom;
+  g_fake.thermal_status = thermal;
+  g_fake.battery_percent = battery;
+  g_fake.charging = charging;
+  g_fake.power_save = power_save;
+  g_fake_known = 1;
+}
+
+// Runs decisions against a device whose throughput is rate(workers), and
+// returns the count chosen most often over the last rounds
+static uint32_t converge(uint32_t max, double (*rate)(uint32_t)) {
+  vault_governor_reset();
+  uint32_t seen[VAULT_GOVERNOR_MAX_WORKERS + 1] = {0};
+  for (int round = 0; round < 64; round++) {
+    uint32_t w = vault_governor_workers(VAULT_JOB_EXPORT, max);
+    assert(w >= 1 && w <= max);
+    // 100 ms phases, well above the report noise floor
+    uint64_t bytes = (uint64_t)(rate(w) * 0.1);
+    vault_governor_report(VAULT_JOB_EXPORT, w, bytes, 100000000ull);
+    if (round >= 32)
+      seen[w]++;
+  }
+  uint32_t most = 1;
+  for (uint32_t w = 1; w <= max; w++) {
+    if (seen[w] > seen[most])
+      most = w;
+  }
+  // Only the periodic re-probe of the cap deviates from the choice
+  assert(seen[most] >= 32 - 32 / 8);
+  return most;
+}
+
+static double flat_rate(uint32_t w) {
+  (void)w;
+  return 200e6;
+}
+
+static double linear_rate(uint32_t w) { return 50e6 * w; }
+
+static double saturating_rate(uint32_t w) { return 50e6 * (w < 2 ? w : 2); }
+
+int main(void) {
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  uint32_t max = cpus >= VAULT_GOVERNOR_MAX_WORKERS
+                     ? VAULT_GOVERNOR_MAX_WORKERS
+                     : (uint32_t)(cpus > 0 ? cpus : 1);
+  vault_governor_source_t source = {fake_sample, NULL};
+  vault_governor_set_source(&source);
+  vault_governor_reset();
+
+  // Nothing known: a cool device, all workers, unpaced
+  g_fake_known = 0;
+  assert(vault_governor_workers(VAULT_JOB_SCAN, max) == max);
+  assert(vault_governor_io_rate() == 0);
+  assert(vault_governor_workers(VAULT_JOB_SCAN, 0) == 1);
+  assert(vault_governor_workers(VAULT_JOB_SCAN, 1000) == max);
+
+  // Thermal severity caps
+  set_fake(0.2f, VAULT_THERMAL_NONE, 80, 0, 0);
+  assert(vault_governor_workers(VAULT_JOB_SCAN, max) == max);
+  set_fake(0.2f, VAULT_THERMAL_LIGHT, 80, 0, 0);
+  assert(vault_governor_workers(VAULT_JOB_SCAN, max) == (max + 1) / 2);
+  uint64_t light_rate = vault_governor_io_rate();
+  set_fake(0.2f, VAULT_THERMAL_MODERATE, 80, 0, 0);
+  assert(vault_governor_workers(VAULT_JOB_SCAN, max) == (max < 2 ? max : 2));
+  uint64_t moderate_rate = vault_governor_io_rate();
+  set_fake(0.2f, VAULT_THERMAL_SEVERE, 80, 0, 0);
+  assert(vault_governor_workers(VAULT_JOB_SCAN, max) == 1);
+  uint64_t severe_rate = vault_governor_io_rate();
+  assert(light_rate > moderate_rate && moderate_rate > severe_rate &&
+         severe_rate > 0);
+  set_fake(0.2f, VAULT_THERMAL_CRITICAL, 80, 0, 0);
+  assert(vault_governor_workers(VAULT_JOB_SCAN, max) == 1);
+  // Forecast headroom alone raises the level
+  set_fake(0.96f, VAULT_THERMAL_NONE, 80, 0, 0);
+  assert(vault_governor_workers(VAULT_JOB_SCAN, max) == 1);
+  set_fake(0.75f, VAULT_THERMAL_NONE, 80, 0, 0);
+  assert(vault_governor_workers(VAULT_JOB_SCAN, max) == (max + 1) / 2);
+
+  // Battery and power-save caps apply only off the charger
+  set_fake(0.2f, VAULT_THERMAL_NONE, 25, 0, 0);
+  assert(vault_governor_workers(VAULT_JOB_SCAN, max) == (max + 1) / 2);
+  set_fake(0.2f, VAULT_THERMAL_NONE, 10, 0, 0);
+  assert(vault_governor_workers(VAULT_JOB_SCAN, max) == (max < 2 ? max : 2));
+  set_fake(0.2f, VAULT_THERMAL_NONE, 90, 0, 1);
+  assert(vault_governor_workers(VAULT_JOB_SCAN, max) == (max < 2 ? max : 2));
+  assert(vault_governor_io_rate() == moderate_rate);
+  set_fake(0.2f, VAULT_THERMAL_NONE, 10, 1, 1);
+  assert(vault_governor_workers(VAULT_JOB_SCAN, max) == max);
+  assert(vault_governor_io_rate() == 0);
+  // The worse of thermal and battery wins, charging or not
+  set_fake(0.2f, VAULT_THERMAL_SEVERE, 90, 1, 0);
+  assert(vault_governor_workers(VAULT_JOB_SCAN, max) == 1);
+  set_fake(0.2f, VAULT_THERMAL_LIGHT, 10, 0, 0);
+  assert(vault_governor_workers(VAULT_JOB_SCAN, max) == (max < 2 ? max : 2));
+
+  // Measured throughput picks the count on a cool device
+  set_fake(0.2f, VAULT_THERMAL_NONE, 90, 1, 0);
+  assert(converge(max, flat_rate) == 1);
+  assert(converge(max, linear_rate) == max);
+  if (max >= 4)
+    assert(converge(max, saturating_rate) == 2);
+
+  // Too short or too small phases are not measurements
+  vault_governor_reset();
+  vault_governor_report(VAULT_JOB_EXPORT, max, 1024, 100000000ull);
+  vault_governor_report(VAULT_JOB_EXPORT, max, 64ull << 20, 1000);
+  assert(vault_governor_workers(VAULT_JOB_EXPORT, max) == max);
+  assert(vault_governor_workers(VAULT_JOB_EXPORT, max) == max);
+
+  // Pacing holds writes to the rate only when a rate applies
+  vault_pace_t pace;
+  memset(&pace, 0, sizeof(pace));
+  uint64_t start = vault_governor_now_ns();
+  vault_governor_pace(&pace, 64ull << 20);
+  assert(vault_governor_now_ns() - start < 50000000ull);
+  set_fake(0.2f, VAULT_THERMAL_SEVERE, 90, 0, 0);
+  memset(&pace, 0, sizeof(pace));
+  start = vault_governor_now_ns();
+  vault_governor_pace(&pace, severe_rate / 10);
+  assert(vault_governor_now_ns() - start >= 90000000ull);
+
+  vault_governor_set_source(NULL);
+  vault_governor_reset();
+  return 0;
+}
@@ -0,0 +1,141 @@
+// Built in place of vault_container.c so the static codec is reachable.
+#include "vault_container.c"
+#include <assert.h>
+
+// Incompressible filler, like real IDs and wrapped keys
+static void fill_random(uint8_t *out, size_t len, uint32_t seed) {
+  for (size_t k = 0; k < len; k++) {
+    seed = seed * 1103515245u + 12345u;
+    out[k] = (uint8_t)(seed >> 16);
+  }
+}
+
+static void fill_entry(vault_entry_t *entry, uint32_t i, uint32_t chunks) {
+  memset(entry, 0, sizeof(*entry));
+  fill_random(entry->file_id, VAULT_ID_LEN, i + 1);
+  entry->type = (uint8_t)(i % 4);
+  entry->created_at = 1700000000000ULL + i * 1000;
+  entry->name = strdup(i % 2 ? "IMG_0001.jpg" : "notes.txt");
+  entry->mime = strdup(i % 2 ? "image/jpeg" : "text/plain");
+  entry->wrapped_dek_len = 72;
+  entry->wrapped_dek = malloc(entry->wrapped_dek_len);
+  fill_random(entry->wrapped_dek, entry->wrapped_dek_len, i + 100);
+  entry->chunk_count = chunks;
+  if (chunks > 0) {
+    entry->chunks = calloc(chunks, sizeof(entry->chunks[0]));
+    for (uint32_t c = 0; c < chunks; c++) {
+      entry->chunks[c].offset = 4096 + (uint64_t)c * 1000;
+      entry->chunks[c].length = c + 1 == chunks ? 500 : 1000;
+      fill_random(entry->chunks[c].nonce, VAULT_NONCE_LEN, i * 1000 + c);
+    }
+    entry->size = (uint64_t)chunks * 1000;
+  } else {
+    entry->data_offset = 8192 + i;
+    entry->data_length = 100 + i;
+    entry->size = entry->data_length - VAULT_TAG_LEN;
+  }
+}
+
+static void assert_same(const vault_entry_t *a, const vault_entry_t *b) {
+  assert(memcmp(a->file_id, b->file_id, VAULT_ID_LEN) == 0);
+  assert(a->type == b->type && a->created_at == b->created_at);
+  assert(strcmp(a->name, b->name) == 0 && strcmp(a->mime, b->mime) == 0);
+  assert(a->size == b->size);
+  assert(a->wrapped_dek_len == b->wrapped_dek_len);
+  assert(memcmp(a->wrapped_dek, b->wrapped_dek, a->wrapped_dek_len) == 0);
+  assert(a->chunk_count == b->chunk_count);
+  for (uint32_t c = 0; c < a->chunk_count; c++) {
+    assert(a->chunks[c].offset == b->chunks[c].offset);
+    assert(a->chunks[c].length == b->chunks[c].length);
+    assert(memcmp(a->chunks[c].nonce, b->chunks[c].nonce, VAULT_NONCE_LEN) ==
+           0);
+  }
+  if (a->chunk_count == 0) {
+    assert(a->data_offset == b->data_offset);
+    assert(a->data_length == b->data_length);
+  }
+  assert(a->ext_len == b->ext_len);
+  assert(a->ext_len == 0 || memcmp(a->ext, b->ext, a->ext_len) == 0);
+}
+
+// Every prefix and every single-byte flip must be rejected or decode cleanly;
+// each attempt gets an exact-size copy so an over-read is caught by ASan.
+static void check_damaged(const uint8_t *record, size_t len) {
+  for (size_t cut = 0; cut < len; cut++) {
+    uint8_t *copy = malloc(cut ? cut : 1);
+    memcpy(copy, record, cut);
+    vault_entry_t *entries = NULL;
+    uint32_t count = 0;
+    assert(deserialize_log_index(copy, cut, &entries, &count) != VAULT_OK);
+    free(copy);
+  }
+  for (size_t i = 0; i < len; i++) {
+    uint8_t *copy = malloc(len);
+    memcpy(copy, record, len);
+    copy[i] ^= 0x5A;
+    vault_entry_t *entries = NULL;
+    uint32_t count = 0;
+    if (deserialize_log_index(copy, len, &entries, &count) == VAULT_OK)
+      free_entries_array(entries, count);
+    free(copy);
+  }
+}
+
+int main(void) {
+  vault_entry_t entries[6];
+  for (uint32_t i = 0; i < 6; i++)
+    fill_entry(&entries[i], i, i == 2 ? 40 : (i == 5 ? 1 : 0));
+
+  // Ext records of several tags, including one this build does not know
+  const uint8_t terms[] = {1, 2, 3, 4, 5};
+  const uint8_t access[8] = {0x10, 0x20};
+  const uint8_t unknown[] = {0xEE};
+  assert(vault_entry_ext_set(&entries[0], VAULT_EXT_SEARCH_TERMS, terms,
+                             sizeof(terms)) == VAULT_OK);
+  assert(vault_entry_ext_set(&entries[2], VAULT_EXT_ACCESS, access,
+                             sizeof(access)) == VAULT_OK);
+  assert(vault_entry_ext_set(&entries[2], 200, unknown, sizeof(unknown)) ==
+         VAULT_OK);
+
+  uint8_t *record = NULL;
+  size_t len = 0;
+  assert(serialize_index_compact(entries, 6, &record, &len) == VAULT_OK);
+  assert(memcmp(record, VAULT_INDEX_COMPACT_MAGIC,
+                VAULT_INDEX_COMPACT_MAGIC_LEN) == 0);
+
+  vault_entry_t *decoded = NULL;
+  uint32_t count = 0;
+  assert(deserialize_log_index(record, len, &decoded, &count) == VAULT_OK);
+  assert(count == 6);
+  for (uint32_t i = 0; i < 6; i++)
+    assert_same(&entries[i], &decoded[i]);
+  free_entries_array(decoded, count);
+  check_damaged(record, len);
+
+  // A lone entry does not deflate smaller, so the raw body path is used
+  uint8_t *raw = NULL;
+  size_t raw_len = 0;
+  assert(serialize_index_compact(&entries[1], 1, &raw, &raw_len) == VAULT_OK);
+  assert(raw[VAULT_INDEX_COMPACT_MAGIC_LEN] == 0);
+  assert(deserialize_log_index(raw, raw_len, &decoded, &count) == VAULT_OK);
+  assert(count == 1);
+  assert_same(&entries[1], &decoded[0]);
+  free_entries_array(decoded, count);
+  check_damaged(raw, raw_len);
+
+  // Unknown flag bits are refused
+  raw[VAULT_INDEX_COMPACT_MAGIC_LEN] = 0x80;
+  assert(deserialize_log_index(raw, raw_len, &decoded, &count) ==
+         VAULT_ERR_CORRUPTED);
+
+  free(raw);
+  free(record);
+  for (uint32_t i = 0; i < 6; i++) {
+    free(entries[i].name);
+    free(entries[i].mime);
+    free(entries[i].wrapped_dek);
+    free(entries[i].chunks);
+    free(entries[i].ext);
+  }
+  return 0;
+}
@@ -0,0 +1,81 @@
+#include "vault_engine.h"
+#include "vault_layout.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char *kPath = "/tmp/layout_report_test.vault";
+static const char *kPass = "correct horse battery";
+
+// The layout walk and the O(1) stats counter must agree on dead space
+static void check_report(uint32_t expected_entries) {
+  vault_layout_report_t report;
+  assert(vault_analyze_layout(&report) == VAULT_OK);
+  vault_stats_t stats;
+  assert(vault_get_stats(&stats) == VAULT_OK);
+  assert(report.entry_count == expected_entries);
+  assert(report.dead_bytes == stats.free_space);
+  assert(report.live_bytes + report.dead_bytes == report.committed_size);
+
+  uint64_t bucket_sum = 0;
+  for (int i = 0; i < VAULT_LAYOUT_DEAD_BUCKETS; i++)
+    bucket_sum += report.dead_buckets[i];
+  assert(bucket_sum == report.dead_bytes);
+
+  // Every root slot is reported, newest first; the newest is current
+  assert(report.index_record_count >= 1);
+  assert(report.index_record_count <= VAULT_LAYOUT_MAX_INDEX_RECORDS);
+  assert(report.index_records[0].offset == report.index_offset);
+  assert(report.index_records[0].length == report.index_length);
+  for (uint32_t i = 1; i < report.index_record_count; i++)
+    assert(report.index_records[i].seq <= report.index_records[i - 1].seq);
+  vault_layout_free(&report);
+}
+
+int main(void) {
+  assert(vault_init() == VAULT_OK);
+  unlink(kPath);
+  assert(vault_create(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+  assert(vault_open(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+
+  size_t big_len = 6 * 1024 * 1024 + 99;
+  uint8_t *big = malloc(big_len);
+  for (size_t i = 0; i < big_len; i++)
+    big[i] = (uint8_t)(i * 7 + (i >> 9));
+  uint8_t ids[4][VAULT_ID_LEN];
+  assert(vault_import_file(big, big_len, VAULT_FILE_TYPE_VIDEO, "a.mp4",
+                           "video/mp4", ids[0]) == VAULT_OK);
+  for (int i = 1; i < 4; i++) {
+    assert(vault_import_file(big, 1000 * (size_t)i, VAULT_FILE_TYPE_TXT,
+                             "n.txt", "text/plain", ids[i]) == VAULT_OK);
+  }
+  check_report(4);
+
+  // Deleting a chunked file and a blob leaves dead runs between live data
+  assert(vault_delete_file(ids[0]) == VAULT_OK);
+  assert(vault_delete_file(ids[2]) == VAULT_OK);
+  check_report(2);
+
+  vault_layout_report_t report;
+  assert(vault_analyze_layout(&report) == VAULT_OK);
+  assert(report.dead_bytes > big_len && report.dead_runs >= 2);
+  // A completed commit mirrors the root into both slots
+  assert(report.index_record_count == VAULT_LAYOUT_MAX_INDEX_RECORDS);
+  assert(report.index_records[1].offset == report.index_offset);
+  vault_layout_free(&report);
+
+  // Same figures after a reopen
+  vault_close();
+  assert(vault_open(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+  check_report(2);
+
+  vault_close();
+  assert(vault_analyze_layout(&report) == VAULT_ERR_NOT_OPEN);
+  unlink(kPath);
+  free(big);
+  return 0;
+}
@@ -0,0 +1,132 @@
+#include "vault_archive.h"
+#include "vault_engine.h"
+#include "vault_governor.h"
+#include "vault_streaming.h"
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+extern vault_state_t g_vault;
+
+static const char *kPath = "/tmp/lock_pacing_test.vault";
+static const char *kArchive = "/tmp/lock_pacing_test.tar";
+static const char *kPass = "correct horse battery";
+
+// A hot device, so any pacing would sleep; every consultation is counted
+static int g_samples;
+
+static int hot_sample(void *ctx, vault_governor_signals_t *out) {
+  (void)ctx;
+  memset(out, 0, sizeof(*out));
+  out->thermal_headroom = 0.2f;
+  out->thermal_status = VAULT_THERMAL_SEVERE;
+  out->battery_percent = 80;
+  g_samples++;
+  return 0;
+}
+
+static int write_tar(const char *name, const uint8_t *data, size_t len) {
+  uint8_t block[512] = {0};
+  snprintf((char *)block, 100, "%s", name);
+  snprintf((char *)block + 100, 8, "%07o", 0644);
+  snprintf((char *)block + 124, 12, "%011zo", len);
+  block[156] = '0';
+  memcpy(block + 257, "ustar", 6);
+  memcpy(block + 263, "00", 2);
+  memset(block + 148, ' ', 8);
+  unsigned sum = 0;
+  for (size_t i = 0; i < sizeof(block); i++)
+    sum += block[i];
+  snprintf((char *)block + 148, 8, "%06o", sum);
+
+  FILE *f = fopen(kArchive, "wb");
+  assert(f);
+  assert(fwrite(block, 1, sizeof(block), f) == sizeof(block));
+  assert(fwrite(data, 1, len, f) == len);
+  memset(block, 0, sizeof(block));
+  assert(fwrite(block, 1, (512 - len % 512) % 512, f) ==
+         (512 - len % 512) % 512);
+  assert(fwrite(block, 1, sizeof(block), f) == sizeof(block));
+  assert(fwrite(block, 1, sizeof(block), f) == sizeof(block));
+  fclose(f);
+  int fd = open(kArchive, O_RDONLY);
+  assert(fd >= 0);
+  return fd;
+}
+
+// Everything VaultBridge runs under its vault lock must leave the governor
+// alone; the unlocked halves of the same jobs are where pacing happens
+int main(void) {
+  assert(vault_init() == VAULT_OK);
+  unlink(kPath);
+  assert(vault_create(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+  assert(vault_open(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+  assert(streaming_init() == STREAMING_OK);
+  vault_governor_source_t source = {hot_sample, NULL};
+  vault_governor_set_source(&source);
+
+  size_t len = 3 * VAULT_CHUNK_SIZE + 123;
+  uint8_t *data = malloc(STREAMING_CHUNK_SIZE);
+  for (size_t i = 0; i < STREAMING_CHUNK_SIZE; i++)
+    data[i] = (uint8_t)(i * 7);
+
+  // Locked: an in-memory import in the legacy chunk layout
+  g_samples = 0;
+  uint8_t video[VAULT_ID_LEN];
+  assert(vault_import_file(data, len, VAULT_FILE_TYPE_VIDEO, "a.mp4",
+                           "video/mp4", video) == VAULT_OK);
+  assert(g_samples == 0);
+
+  // Unlocked chunk writes pace; the locked finish does not
+  uint8_t hash[VAULT_HASH_LEN] = {9};
+  uint8_t import_id[VAULT_ID_LEN];
+  uint32_t resume = 0;
+  assert(streaming_start("vault://copy/a", hash, "b.mp4", "video/mp4",
+                         VAULT_FILE_TYPE_VIDEO, len, import_id,
+                         &resume) == STREAMING_OK);
+  g_samples = 0;
+  assert(streaming_write_chunk(import_id, data, len, 0) == STREAMING_OK);
+  assert(g_samples > 0);
+  g_samples = 0;
+  uint8_t copy[VAULT_ID_LEN];
+  assert(streaming_finish(import_id, copy) == STREAMING_OK);
+  assert(g_samples == 0);
+
+  // Locked: converting one legacy file
+  g_samples = 0;
+  uint64_t converted = 0;
+  assert(vault_rechunk_legacy(0, 1, &converted) == VAULT_OK);
+  assert(converted == len && g_samples == 0);
+
+  // Staging an archive paces; its commit does not
+  int fd = write_tar("notes.txt", data, 1000);
+  uint32_t count = 0;
+  uint32_t skipped = 0;
+  g_samples = 0;
+  assert(vault_archive_stage(fd, &count, &skipped) == VAULT_OK);
+  close(fd);
+  assert(count == 1 && g_samples > 0);
+  g_samples = 0;
+  vault_archive_member_t *members = NULL;
+  assert(vault_archive_commit(&members, &count, &skipped) == VAULT_OK);
+  assert(count == 1 && g_samples == 0);
+  vault_archive_free_members(members, count);
+
+  // Locked: delete and compaction
+  g_samples = 0;
+  assert(vault_delete_file(copy) == VAULT_OK);
+  assert(vault_compact_storage() == VAULT_OK);
+  assert(g_samples == 0);
+
+  vault_governor_set_source(NULL);
+  vault_close();
+  unlink(kPath);
+  unlink(kArchive);
+  free(data);
+  return 0;
+}
@@ -0,0 +1,147 @@
+#include "vault_engine.h"
+#include <assert.h>
+#include <string.h>
+#include <unistd.h>
+
+extern vault_state_t g_vault;
+
+static const char *kPath = "/tmp/metadata_ops_test.vault";
+static const char *kPass = "correct horse battery";
+// Swapped in as the vault path so the next commit fails to open it
+static char kMissing[] = "/nonexistent/metadata_ops_test.vault";
+
+static const vault_entry_t *find_entry(const uint8_t *id) {
+  for (uint32_t i = 0; i < g_vault.entry_count; i++) {
+    if (memcmp(g_vault.entries[i].file_id, id, VAULT_ID_LEN) == 0)
+      return &g_vault.entries[i];
+  }
+  return NULL;
+}
+
+static void op(vault_meta_op_t *out, uint8_t kind, const uint8_t *id,
+               const char *new_name) {
+  out->kind = kind;
+  memcpy(out->file_id, id, VAULT_ID_LEN);
+  out->new_name = new_name;
+}
+
+static void import(const char *name, uint8_t *id_out) {
+  assert(vault_import_file((const uint8_t *)name, strlen(name),
+                           VAULT_FILE_TYPE_TXT, name, "text/plain",
+                           id_out) == VAULT_OK);
+}
+
+int main(void) {
+  assert(vault_init() == VAULT_OK);
+  unlink(kPath);
+  assert(vault_create(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+  assert(vault_open(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+
+  uint8_t a[VAULT_ID_LEN], b[VAULT_ID_LEN], c[VAULT_ID_LEN], d[VAULT_ID_LEN];
+  import("a.txt", a);
+  import("b.txt", b);
+  import("c.txt", c);
+  import("d.txt", d);
+  uint8_t unknown[VAULT_ID_LEN];
+  memset(unknown, 0xEE, sizeof(unknown));
+
+  // Mixed batch, applied in order; bad operations fail alone
+  vault_meta_op_t ops[10];
+  int status[10];
+  op(&ops[0], VAULT_META_OP_RENAME, a, "a1.txt");
+  op(&ops[1], VAULT_META_OP_DELETE, b, NULL);
+  op(&ops[2], VAULT_META_OP_RENAME, a, "a2.txt"); // sees the first rename
+  op(&ops[3], VAULT_META_OP_DELETE, b, NULL);     // already deleted
+  op(&ops[4], VAULT_META_OP_RENAME, b, "b1.txt"); // renames a deleted entry
+  op(&ops[5], VAULT_META_OP_RENAME, unknown, "x.txt");
+  op(&ops[6], VAULT_META_OP_RENAME, c, "__not_system__");
+  op(&ops[7], VAULT_META_OP_RENAME, c, "");
+  op(&ops[8], 99, c, NULL);
+  op(&ops[9], VAULT_META_OP_RENAME, d, "d1.txt");
+  assert(vault_commit_metadata_ops(ops, 10, status) == VAULT_OK);
+  const int expected[10] = {
+      VAULT_OK,            VAULT_OK,
+      VAULT_OK,            VAULT_ERR_NOT_FOUND,
+      VAULT_ERR_NOT_FOUND, VAULT_ERR_NOT_FOUND,
+      VAULT_ERR_INVALID_PARAM, VAULT_ERR_INVALID_PARAM,
+      VAULT_ERR_INVALID_PARAM, VAULT_OK};
+  for (int i = 0; i < 10; i++)
+    assert(status[i] == expected[i]);
+  assert(g_vault.entry_count == 3);
+  assert(strcmp(find_entry(a)->name, "a2.txt") == 0);
+  assert(!find_entry(b));
+  assert(strcmp(find_entry(c)->name, "c.txt") == 0);
+  assert(strcmp(find_entry(d)->name, "d1.txt") == 0);
+
+  // Rename then delete of the same entry in one batch
+  op(&ops[0], VAULT_META_OP_RENAME, d, "d2.txt");
+  op(&ops[1], VAULT_META_OP_DELETE, d, NULL);
+  assert(vault_commit_metadata_ops(ops, 2, status) == VAULT_OK);
+  assert(status[0] == VAULT_OK && status[1] == VAULT_OK);
+  assert(g_vault.entry_count == 2 && !find_entry(d));
+
+  // A batch with nothing valid commits nothing
+  op(&ops[0], VAULT_META_OP_DELETE, unknown, NULL);
+  assert(vault_commit_metadata_ops(ops, 1, status) == VAULT_OK);
+  assert(status[0] == VAULT_ERR_NOT_FOUND && g_vault.entry_count == 2);
+
+  // A failed commit rolls every valid operation back, chained renames too
+  vault_stats_t before;
+  assert(vault_get_stats(&before) == VAULT_OK);
+  char *path = g_vault.path;
+  g_vault.path = kMissing;
+  op(&ops[0], VAULT_META_OP_RENAME, a, "a3.txt");
+  op(&ops[1], VAULT_META_OP_RENAME, a, "a4.txt");
+  op(&ops[2], VAULT_META_OP_DELETE, c, NULL);
+  op(&ops[3], VAULT_META_OP_DELETE, unknown, NULL);
+  int result = vault_commit_metadata_ops(ops, 4, status);
+  g_vault.path = path;
+  assert(result != VAULT_OK);
+  assert(status[0] == result && status[1] == result && status[2] == result);
+  assert(status[3] == VAULT_ERR_NOT_FOUND);
+  assert(g_vault.entry_count == 2);
+  assert(strcmp(find_entry(a)->name, "a2.txt") == 0);
+  assert(strcmp(find_entry(c)->name, "c.txt") == 0);
+  vault_stats_t after;
+  assert(vault_get_stats(&after) == VAULT_OK);
+  assert(after.file_count == before.file_count);
+  assert(after.free_space == before.free_space);
+
+  // The same helper backs vault_delete_files
+  g_vault.path = kMissing;
+  result = vault_delete_files(c, 1);
+  g_vault.path = path;
+  assert(result != VAULT_OK && find_entry(c));
+  assert(vault_delete_files(c, 1) == VAULT_OK && !find_entry(c));
+
+  // Committed state survives a reopen
+  vault_close();
+  assert(vault_open(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+  assert(g_vault.entry_count == 1);
+  assert(strcmp(find_entry(a)->name, "a2.txt") == 0);
+
+  // Watched-folder records are system files; they only rename to system names
+  uint8_t w[VAULT_ID_LEN];
+  import("__watch_cursor_ab12__", w);
+  op(&ops[0], VAULT_META_OP_RENAME, w, "__watch_delta_ab12_3__");
+  op(&ops[1], VAULT_META_OP_RENAME, w, "__watched_sources__");
+  op(&ops[2], VAULT_META_OP_RENAME, w, "__watch_cursor___");
+  op(&ops[3], VAULT_META_OP_RENAME, w, "__watch_other_ab12__");
+  op(&ops[4], VAULT_META_OP_RENAME, w, "plain.txt");
+  op(&ops[5], VAULT_META_OP_RENAME, a, "__watch_cursor_ab12__");
+  assert(vault_commit_metadata_ops(ops, 6, status) == VAULT_OK);
+  assert(status[0] == VAULT_OK && status[1] == VAULT_OK);
+  for (int i = 2; i < 6; i++)
+    assert(status[i] == VAULT_ERR_INVALID_PARAM);
+  assert(strcmp(find_entry(w)->name, "__watched_sources__") == 0);
+
+  vault_close();
+  op(&ops[0], VAULT_META_OP_DELETE, a, NULL);
+  assert(vault_commit_metadata_ops(ops, 1, status) == VAULT_ERR_NOT_OPEN);
+  assert(status[0] == VAULT_ERR_NOT_OPEN);
+  unlink(kPath);
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include "vault_engine.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char *kPath = "/tmp/range_write_test.vault";
+static const char *kPass = "correct horse battery";
+
+static void assert_content(const uint8_t *id, const uint8_t *expected,
+                           size_t len) {
+  uint8_t *out = malloc(len + 16);
+  size_t got = 0;
+  assert(vault_read_range(id, 0, out, len + 16, &got) == VAULT_OK);
+  assert(got == len);
+  assert(memcmp(out, expected, len) == 0);
+  free(out);
+}
+
+int main(void) {
+  assert(vault_init() == VAULT_OK);
+  unlink(kPath);
+  assert(vault_create(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+  assert(vault_open(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+
+  // Chunked file: 10 MB plus a partial chunk, with room to append
+  size_t size = 10 * 1024 * 1024 + 777;
+  size_t cap = size + 3 * 1024 * 1024;
+  uint8_t *expected = malloc(cap);
+  for (size_t i = 0; i < cap; i++)
+    expected[i] = (uint8_t)(i * 31 + (i >> 12));
+  uint8_t video[VAULT_ID_LEN];
+  assert(vault_import_file(expected, size, VAULT_FILE_TYPE_VIDEO, "v.mp4",
+                           "video/mp4", video) == VAULT_OK);
+  vault_media_info_t info = {0};
+  info.width = 1920;
+  assert(vault_set_media_info(video, &info) == VAULT_OK);
+
+  // An overwrite straddling a chunk boundary drops the stored media info
+  size_t at = 4 * 1024 * 1024 - 1000;
+  memset(expected + at, 0xAB, 2000);
+  assert(vault_write_file_range(video, at, expected + at, 2000) == VAULT_OK);
+  assert_content(video, expected, size);
+  assert(vault_get_media_info(video, &info) == VAULT_ERR_NOT_FOUND);
+
+  // Append fills the partial last chunk, then adds new ones
+  assert(vault_append_to_file(video, expected + size, cap - size) ==
+         VAULT_OK);
+  size = cap;
+  assert_content(video, expected, size);
+
+  // Writing at the end appends; past the end would leave a hole
+  assert(vault_write_file_range(video, size + 1, expected, 10) ==
+         VAULT_ERR_INVALID_PARAM);
+
+  // Single-blob file
+  const char *note = "hello quick brown fox";
+  uint8_t text[VAULT_ID_LEN];
+  assert(vault_import_file((const uint8_t *)note, strlen(note),
+                           VAULT_FILE_TYPE_TXT, "n.txt", "text/plain",
+                           text) == VAULT_OK);
+  assert(vault_append_to_file(text, (const uint8_t *)" jumps", 6) ==
+         VAULT_OK);
+  assert(vault_write_file_range(text, 0, (const uint8_t *)"HOWDY", 5) ==
+         VAULT_OK);
+  assert_content(text, (const uint8_t *)"HOWDY quick brown fox jumps", 27);
+
+  // Edits survive a reopen
+  vault_close();
+  assert(vault_open(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+  assert_content(video, expected, size);
+  assert_content(text, (const uint8_t *)"HOWDY quick brown fox jumps", 27);
+  assert(vault_get_media_info(video, &info) == VAULT_ERR_NOT_FOUND);
+
+  vault_close();
+  unlink(kPath);
+  free(expected);
+  return 0;
+}
@@ -0,0 +1,129 @@
+#include "vault_engine.h"
+#include "vault_streaming.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+extern vault_state_t g_vault;
+
+static const char *kPath = "/tmp/read_range_test.vault";
+static const char *kPass = "correct horse battery";
+
+// Read [offset, offset + len) and compare with the source, and check that
+// nothing past the returned length was written
+static void check_range(const uint8_t *id, const uint8_t *expected,
+                        size_t size, uint64_t offset, size_t len) {
+  uint8_t *out = malloc(len + 64);
+  memset(out, 0xCC, len + 64);
+  size_t got = 12345;
+  assert(vault_read_range(id, offset, out, len, &got) == VAULT_OK);
+  size_t want = 0;
+  if (offset < size)
+    want = len < size - offset ? len : (size_t)(size - offset);
+  assert(got == want);
+  assert(want == 0 || memcmp(out, expected + offset, want) == 0);
+  for (size_t i = want; i < len + 64; i++)
+    assert(out[i] == 0xCC);
+  free(out);
+}
+
+// Offsets and lengths around every chunk boundary, the start and the end
+static void check_boundaries(const uint8_t *id, const uint8_t *expected,
+                             size_t size, size_t chunk) {
+  size_t lens[] = {1, 2, 4095, chunk - 1, chunk, chunk + 1, 2 * chunk + 17};
+  for (size_t b = 0; b <= size; b += chunk) {
+    uint64_t offsets[] = {b == 0 ? 0 : b - 1, b, b + 1};
+    for (size_t o = 0; o < 3; o++) {
+      for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++)
+        check_range(id, expected, size, offsets[o], lens[l]);
+    }
+  }
+  check_range(id, expected, size, 0, size);
+  check_range(id, expected, size, 0, size + 100);
+  check_range(id, expected, size, size - 1, 10);
+  check_range(id, expected, size, size, 10);
+  check_range(id, expected, size, size + 1, 10);
+  check_range(id, expected, size, UINT64_MAX, 10);
+
+  // A zero-length read succeeds without touching the buffer
+  uint8_t byte = 0xCC;
+  size_t got = 7;
+  assert(vault_read_range(id, 0, &byte, 0, &got) == VAULT_OK);
+  assert(got == 0 && byte == 0xCC);
+}
+
+int main(void) {
+  assert(vault_init() == VAULT_OK);
+  unlink(kPath);
+  assert(vault_create(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+  assert(vault_open(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+
+  size_t size = 2 * STREAMING_CHUNK_SIZE + 4321;
+  uint8_t *data = malloc(size);
+  for (size_t i = 0; i < size; i++)
+    data[i] = (uint8_t)(i * 131 + (i >> 11));
+
+  // Single blob
+  uint8_t blob[VAULT_ID_LEN];
+  assert(vault_import_file(data, 5000, VAULT_FILE_TYPE_TXT, "n.txt",
+                           "text/plain", blob) == VAULT_OK);
+  check_boundaries(blob, data, 5000, 1024);
+
+  // Legacy 1 MB chunks from an in-memory import
+  size_t legacy_size = 3 * VAULT_CHUNK_SIZE + 999;
+  uint8_t legacy[VAULT_ID_LEN];
+  assert(vault_import_file(data, legacy_size, VAULT_FILE_TYPE_VIDEO, "l.mp4",
+                           "video/mp4", legacy) == VAULT_OK);
+  check_boundaries(legacy, data, legacy_size, VAULT_CHUNK_SIZE);
+
+  // A blob over one streaming chunk is imported in the streaming layout
+  uint8_t image[VAULT_ID_LEN];
+  assert(vault_import_file(data, size, VAULT_FILE_TYPE_IMG, "i.png",
+                           "image/png", image) == VAULT_OK);
+  const vault_entry_t *entry = &g_vault.entries[g_vault.entry_count - 1];
+  assert(memcmp(entry->file_id, image, VAULT_ID_LEN) == 0);
+  assert(entry->chunk_count == 3 &&
+         entry->chunks[0].length == STREAMING_CHUNK_SIZE + VAULT_TAG_LEN &&
+         entry->chunks[2].length == 4321 + VAULT_TAG_LEN);
+  check_boundaries(image, data, size, STREAMING_CHUNK_SIZE);
+
+  // 4 MB chunks from a streaming import
+  assert(streaming_init() == STREAMING_OK);
+  uint8_t hash[VAULT_HASH_LEN] = {7};
+  uint8_t import_id[VAULT_ID_LEN];
+  uint32_t resume = 99;
+  assert(streaming_start("content://read-range", hash, "s.bin",
+                         "application/octet-stream", VAULT_FILE_TYPE_VIDEO,
+                         size, import_id, &resume) == STREAMING_OK);
+  assert(resume == 0);
+  uint8_t *chunk = malloc(STREAMING_CHUNK_SIZE);
+  for (uint32_t c = 0; (size_t)c * STREAMING_CHUNK_SIZE < size; c++) {
+    size_t at = (size_t)c * STREAMING_CHUNK_SIZE;
+    size_t len = size - at < STREAMING_CHUNK_SIZE ? size - at
+                                                  : STREAMING_CHUNK_SIZE;
+    memcpy(chunk, data + at, len);
+    assert(streaming_write_chunk(import_id, chunk, len, c) == STREAMING_OK);
+  }
+  uint8_t streamed[VAULT_ID_LEN];
+  assert(streaming_finish(import_id, streamed) == STREAMING_OK);
+  check_boundaries(streamed, data, size, STREAMING_CHUNK_SIZE);
+
+  uint8_t unknown[VAULT_ID_LEN];
+  memset(unknown, 0xEE, sizeof(unknown));
+  size_t got = 0;
+  assert(vault_read_range(unknown, 0, chunk, 10, &got) ==
+         VAULT_ERR_NOT_FOUND);
+  assert(vault_read_range(streamed, 0, NULL, 10, &got) ==
+         VAULT_ERR_INVALID_PARAM);
+
+  vault_close();
+  assert(vault_read_range(streamed, 0, chunk, 10, &got) ==
+         VAULT_ERR_NOT_OPEN);
+  unlink(kPath);
+  free(chunk);
+  free(data);
+  return 0;
+}
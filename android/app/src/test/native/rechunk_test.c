@@ -0,0 +1,143 @@
+#include "vault_engine.h"
+#include "vault_layout.h"
+#include "vault_streaming.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+extern vault_state_t g_vault;
+
+static const char *kPath = "/tmp/rechunk_test.vault";
+static const char *kPass = "correct horse battery";
+
+static const vault_entry_t *find_entry(const uint8_t *id) {
+  for (uint32_t i = 0; i < g_vault.entry_count; i++) {
+    if (memcmp(g_vault.entries[i].file_id, id, VAULT_ID_LEN) == 0)
+      return &g_vault.entries[i];
+  }
+  return NULL;
+}
+
+static void assert_content(const uint8_t *id, const uint8_t *expected,
+                           size_t len) {
+  uint8_t *out = malloc(len + 16);
+  size_t got = 0;
+  assert(vault_read_range(id, 0, out, len + 16, &got) == VAULT_OK);
+  assert(got == len && memcmp(out, expected, len) == 0);
+  free(out);
+}
+
+// Everything but the space figures, which shrink with fewer chunk tags
+static void assert_same_files(const vault_stats_t *a, const vault_stats_t *b) {
+  assert(a->file_count == b->file_count);
+  assert(a->plaintext_bytes == b->plaintext_bytes);
+  for (int i = 0; i < VAULT_STATS_TYPE_SLOTS; i++) {
+    assert(a->type_bytes[i] == b->type_bytes[i]);
+    assert(a->type_files[i] == b->type_files[i]);
+  }
+  assert(a->largest_count == b->largest_count);
+  for (uint32_t i = 0; i < a->largest_count; i++) {
+    assert(a->largest_sizes[i] == b->largest_sizes[i]);
+    assert(memcmp(a->largest_ids[i], b->largest_ids[i], VAULT_ID_LEN) == 0);
+  }
+}
+
+// Incremental stats must match what a reopen rebuilds from the index
+static void assert_same_stats(const vault_stats_t *a, const vault_stats_t *b) {
+  assert_same_files(a, b);
+  assert(a->total_size == b->total_size);
+  assert(a->free_space == b->free_space);
+  assert(a->live_bytes == b->live_bytes);
+  assert(a->index_bytes == b->index_bytes);
+  assert(a->fragmented_files == b->fragmented_files);
+  assert(a->extent_count == b->extent_count);
+}
+
+static void assert_layout_agrees(void) {
+  vault_layout_report_t report;
+  assert(vault_analyze_layout(&report) == VAULT_OK);
+  vault_stats_t stats;
+  assert(vault_get_stats(&stats) == VAULT_OK);
+  assert(report.dead_bytes == stats.free_space);
+  assert(report.live_bytes ==
+         report.header_bytes + stats.live_bytes + stats.index_bytes);
+  vault_layout_free(&report);
+}
+
+int main(void) {
+  assert(vault_init() == VAULT_OK);
+  unlink(kPath);
+  assert(vault_create(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+  assert(vault_open(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+
+  // Two files in the legacy 1 MB layout and one single blob
+  size_t a_len = 9 * VAULT_CHUNK_SIZE + 777;
+  size_t b_len = 2 * VAULT_CHUNK_SIZE + 5;
+  uint8_t *data = malloc(a_len);
+  for (size_t i = 0; i < a_len; i++)
+    data[i] = (uint8_t)(i * 29 + (i >> 12));
+  uint8_t a[VAULT_ID_LEN], b[VAULT_ID_LEN], note[VAULT_ID_LEN];
+  assert(vault_import_file(data, a_len, VAULT_FILE_TYPE_VIDEO, "a.mp4",
+                           "video/mp4", a) == VAULT_OK);
+  assert(vault_import_file(data + 3, b_len, VAULT_FILE_TYPE_VIDEO, "b.mp4",
+                           "video/mp4", b) == VAULT_OK);
+  const char *text = "blobs are not re-chunked";
+  assert(vault_import_file((const uint8_t *)text, strlen(text),
+                           VAULT_FILE_TYPE_TXT, "n.txt", "text/plain",
+                           note) == VAULT_OK);
+  assert(find_entry(a)->chunk_count == 10 && find_entry(b)->chunk_count == 3);
+  uint64_t a_created = find_entry(a)->created_at;
+
+  vault_stats_t before;
+  assert(vault_get_stats(&before) == VAULT_OK);
+
+  // A byte budget still converts whole files, one per call here
+  uint64_t converted = 0;
+  assert(vault_rechunk_legacy(0, 1, &converted) == VAULT_OK);
+  assert(converted == a_len);
+  assert(vault_rechunk_legacy(0, UINT64_MAX, &converted) == VAULT_OK);
+  assert(converted == b_len);
+  assert(vault_rechunk_legacy(0, UINT64_MAX, &converted) == VAULT_OK);
+  assert(converted == 0);
+
+  const vault_entry_t *entry = find_entry(a);
+  assert(entry && entry->chunk_count == 3 && entry->size == a_len);
+  assert(strcmp(entry->name, "a.mp4") == 0 && entry->created_at == a_created);
+  assert(find_entry(b)->chunk_count == 1);
+  assert(find_entry(note)->chunk_count == 0);
+  assert_content(a, data, a_len);
+  assert_content(b, data + 3, b_len);
+  assert_content(note, (const uint8_t *)text, strlen(text));
+
+  vault_stats_t after;
+  assert(vault_get_stats(&after) == VAULT_OK);
+  assert_same_files(&before, &after);
+  assert(after.live_bytes < before.live_bytes);
+  assert(after.free_space > before.free_space);
+  assert_layout_agrees();
+
+  // The converted layout and the stats survive a reopen
+  vault_close();
+  assert(vault_open(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+  assert(find_entry(a)->chunk_count == 3 && find_entry(b)->chunk_count == 1);
+  assert_content(a, data, a_len);
+  assert_content(b, data + 3, b_len);
+  assert_content(note, (const uint8_t *)text, strlen(text));
+  vault_stats_t reopened;
+  assert(vault_get_stats(&reopened) == VAULT_OK);
+  assert_same_stats(&after, &reopened);
+  assert_layout_agrees();
+  assert(vault_rechunk_legacy(0, UINT64_MAX, &converted) == VAULT_OK);
+  assert(converted == 0);
+
+  vault_close();
+  assert(vault_rechunk_legacy(0, UINT64_MAX, &converted) ==
+         VAULT_ERR_NOT_OPEN);
+  unlink(kPath);
+  free(data);
+  return 0;
+}
@@ -0,0 +1,62 @@
+#include "vault_engine.h"
+#include "vault_scanner.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static void write_file(const char *path, const uint8_t *data, size_t len) {
+  FILE *f = fopen(path, "wb");
+  assert(f);
+  assert(fwrite(data, 1, len, f) == len);
+  fclose(f);
+}
+
+int main(void) {
+  const uint8_t marker[] = "NOLEAK-PLAINTEXT";
+  const uint8_t *patterns[] = {marker};
+  const size_t lens[] = {sizeof(marker) - 1};
+  vault_scanner_t *scanner = NULL;
+  assert(vault_scanner_create(patterns, lens, 1, &scanner) == VAULT_OK);
+
+  char clean[] = "/tmp/scanner_clean_XXXXXX";
+  char hit[] = "/tmp/scanner_hit_XXXXXX";
+  close(mkstemp(clean));
+  close(mkstemp(hit));
+
+  // 3 MB PNG with no marker, then the same with the marker straddling the
+  // 1 MB read window boundary
+  size_t size = 3 * 1024 * 1024;
+  uint8_t *data = calloc(1, size);
+  assert(data);
+  const uint8_t png[8] = {0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A};
+  memcpy(data, png, sizeof(png));
+  write_file(clean, data, size);
+  memcpy(data + 1024 * 1024 - 5, marker, lens[0]);
+  write_file(hit, data, size);
+
+  int32_t result = -1;
+  assert(vault_scanner_scan_file(scanner, clean, &result) == VAULT_OK);
+  assert(result == SCAN_SIG_PNG);
+  assert(vault_scanner_scan_file(scanner, hit, &result) == VAULT_OK);
+  assert(result == (SCAN_SIG_PNG | SCAN_RESULT_PATTERN));
+
+  // Empty file: no signature, no match
+  assert(truncate(clean, 0) == 0);
+  assert(vault_scanner_scan_file(scanner, clean, &result) == VAULT_OK);
+  assert(result == SCAN_SIG_NONE);
+
+  const char *paths[] = {hit, clean, "/nonexistent/scanner_test"};
+  int32_t results[3] = {0};
+  assert(vault_scanner_scan_files(scanner, paths, 3, 2, results) == VAULT_OK);
+  assert(results[0] == (SCAN_SIG_PNG | SCAN_RESULT_PATTERN));
+  assert(results[1] == SCAN_SIG_NONE);
+  assert(results[2] == VAULT_ERR_IO);
+
+  unlink(clean);
+  unlink(hit);
+  free(data);
+  vault_scanner_free(scanner);
+  return 0;
+}
@@ -0,0 +1,21 @@
+#include "vault_scanner.h"
+#include <assert.h>
+
+int main(void) {
+  const uint8_t jpeg[8] = {0xFF, 0xD8, 0xFF, 0xE0, 0, 0, 0, 0};
+  const uint8_t png[8] = {0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A};
+  const uint8_t mp4[8] = {0, 0, 0, 0x20, 0x66, 0x74, 0x79, 0x70};
+  const uint8_t riff[8] = {0x52, 0x49, 0x46, 0x46, 0, 0, 0, 0};
+  const uint8_t mkv[8] = {0x1A, 0x45, 0xDF, 0xA3, 0, 0, 0, 0};
+  const uint8_t none[8] = {0};
+
+  assert(vault_scanner_detect_signature(jpeg, 8) == SCAN_SIG_JPEG);
+  assert(vault_scanner_detect_signature(png, 8) == SCAN_SIG_PNG);
+  assert(vault_scanner_detect_signature(mp4, 8) == SCAN_SIG_MP4);
+  assert(vault_scanner_detect_signature(riff, 8) == SCAN_SIG_RIFF);
+  assert(vault_scanner_detect_signature(mkv, 8) == SCAN_SIG_MKV);
+  assert(vault_scanner_detect_signature(none, 8) == SCAN_SIG_NONE);
+  assert(vault_scanner_detect_signature(png, 7) == SCAN_SIG_NONE);
+  assert(vault_scanner_detect_signature(0, 8) == SCAN_SIG_NONE);
+  return 0;
+}
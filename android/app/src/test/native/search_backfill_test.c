@@ -0,0 +1,81 @@
+#include "vault_engine.h"
+#include "vault_search.h"
+#include "vault_streaming.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char *kPath = "/tmp/search_backfill_test.vault";
+static const char *kPass = "correct horse battery";
+
+static uint32_t query(const char *text, uint8_t **ids) {
+  uint32_t count = 0;
+  assert(vault_search_query(text, 0, ids, &count) == VAULT_OK);
+  return count;
+}
+
+int main(void) {
+  assert(vault_init() == VAULT_OK);
+  unlink(kPath);
+  assert(vault_create(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+  assert(vault_open(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+  assert(streaming_init() == STREAMING_OK);
+
+  // A streamed text file is chunked and not tokenized at import
+  size_t size = STREAMING_CHUNK_SIZE + 100;
+  uint8_t *data = malloc(size);
+  memset(data, ' ', size);
+  memcpy(data + STREAMING_CHUNK_SIZE - 3, "platypus", 8);
+  memcpy(data + size - 8, "wombat", 6);
+  uint8_t hash[VAULT_HASH_LEN] = {5};
+  uint8_t import_id[VAULT_ID_LEN];
+  uint32_t resume = 0;
+  assert(streaming_start("content://big", hash, "big.txt", "text/plain",
+                         VAULT_FILE_TYPE_TXT, size, import_id,
+                         &resume) == STREAMING_OK);
+  uint8_t *chunk = malloc(STREAMING_CHUNK_SIZE);
+  memcpy(chunk, data, STREAMING_CHUNK_SIZE);
+  assert(streaming_write_chunk(import_id, chunk, STREAMING_CHUNK_SIZE, 0) ==
+         STREAMING_OK);
+  memcpy(chunk, data + STREAMING_CHUNK_SIZE, 100);
+  assert(streaming_write_chunk(import_id, chunk, 100, 1) == STREAMING_OK);
+  uint8_t big[VAULT_ID_LEN];
+  assert(streaming_finish(import_id, big) == STREAMING_OK);
+  uint8_t *ids = NULL;
+  assert(query("platypus", &ids) == 0);
+
+  // An unreadable pending entry ahead of it is skipped, not a stopper
+  uint8_t bad[VAULT_ID_LEN];
+  assert(vault_import_file((const uint8_t *)"unreadable", 10,
+                           VAULT_FILE_TYPE_TXT, "bad.txt", "text/plain",
+                           bad) == VAULT_OK);
+  uint32_t last = g_vault.entry_count - 1;
+  assert(vault_entry_ext_set(&g_vault.entries[last], VAULT_EXT_SEARCH_TERMS,
+                             NULL, 0) == VAULT_OK);
+  vault_entry_t moved = g_vault.entries[last];
+  g_vault.entries[last] = g_vault.entries[last - 1];
+  g_vault.entries[last - 1] = moved;
+  g_vault.entries[last - 1].data_offset += 1;
+
+  uint32_t next = 0, indexed = 0, passes = 0;
+  do {
+    assert(vault_search_index_pending(next, 1, &next, &indexed) == VAULT_OK);
+    passes++;
+  } while (next < g_vault.entry_count);
+  assert(passes == 2);
+  assert(query("platypus", &ids) == 1 && memcmp(ids, big, VAULT_ID_LEN) == 0);
+  free(ids);
+  assert(query("wombat", &ids) == 1);
+  free(ids);
+  assert(query("unreadable", &ids) == 0);
+
+  g_vault.entries[last - 1].data_offset -= 1;
+  vault_close();
+  unlink(kPath);
+  free(chunk);
+  free(data);
+  return 0;
+}
@@ -0,0 +1,83 @@
+#include "vault_engine.h"
+#include "vault_streaming.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char *kPath = "/tmp/streaming_checkpoint_test.vault";
+static const char *kPass = "correct horse battery";
+
+static void chunk_path(const uint8_t *import_id, uint32_t index, char *out,
+                       size_t out_len) {
+  char hex[VAULT_ID_LEN * 2 + 1];
+  for (int i = 0; i < VAULT_ID_LEN; i++)
+    snprintf(hex + i * 2, 3, "%02x", import_id[i]);
+  snprintf(out, out_len, "/tmp/.pending_imports/%s/chunk_%08u.enc", hex,
+           index);
+}
+
+static int write_chunk(const uint8_t *import_id, const uint8_t *data,
+                       size_t size, uint32_t index) {
+  size_t at = (size_t)index * STREAMING_CHUNK_SIZE;
+  size_t len = size - at < STREAMING_CHUNK_SIZE ? size - at
+                                                : STREAMING_CHUNK_SIZE;
+  uint8_t *chunk = malloc(len);
+  memcpy(chunk, data + at, len);
+  int result = streaming_write_chunk(import_id, chunk, len, index);
+  free(chunk);
+  return result;
+}
+
+int main(void) {
+  assert(vault_init() == VAULT_OK);
+  unlink(kPath);
+  assert(vault_create(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+  assert(vault_open(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+  assert(streaming_init() == STREAMING_OK);
+
+  size_t size = 2 * STREAMING_CHUNK_SIZE + 4321;
+  uint8_t *data = malloc(size);
+  for (size_t i = 0; i < size; i++)
+    data[i] = (uint8_t)(i * 13 + (i >> 16));
+  uint8_t hash[VAULT_HASH_LEN] = {9};
+  uint8_t import_id[VAULT_ID_LEN];
+  uint32_t resume = 99;
+  assert(streaming_start("content://checkpoint", hash, "c.bin",
+                         "application/octet-stream", VAULT_FILE_TYPE_VIDEO,
+                         size, import_id, &resume) == STREAMING_OK);
+  assert(resume == 0);
+
+  // A chunk that cannot be flushed at the checkpoint fails the write that
+  // reaches it, and the import falls back to the last durable chunk
+  assert(write_chunk(import_id, data, size, 0) == STREAMING_OK);
+  assert(write_chunk(import_id, data, size, 1) == STREAMING_OK);
+  char path[512];
+  chunk_path(import_id, 0, path, sizeof(path));
+  assert(unlink(path) == 0);
+  assert(write_chunk(import_id, data, size, 2) == STREAMING_ERR_IO);
+  streaming_import_state_t state;
+  assert(streaming_get_state(import_id, &state) == STREAMING_OK);
+  assert(state.completed_chunks == 0 && state.bytes_written == 0);
+  streaming_free_state(&state);
+  assert(write_chunk(import_id, data, size, 2) == STREAMING_ERR_INVALID_PARAM);
+
+  // Rewriting from there completes the import
+  for (uint32_t c = 0; c < 3; c++)
+    assert(write_chunk(import_id, data, size, c) == STREAMING_OK);
+  uint8_t id[VAULT_ID_LEN];
+  assert(streaming_finish(import_id, id) == STREAMING_OK);
+  uint8_t *out = malloc(size);
+  size_t got = 0;
+  assert(vault_read_range(id, 0, out, size, &got) == VAULT_OK);
+  assert(got == size && memcmp(out, data, size) == 0);
+
+  vault_close();
+  unlink(kPath);
+  free(out);
+  free(data);
+  return 0;
+}
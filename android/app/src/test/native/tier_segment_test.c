@@ -0,0 +1,113 @@
+// Built in place of vault_tier.c so the access table is reachable, with
+// compaction allowed at any amount of dead space.
+#define TIER_COMPACT_MIN_DEAD 1
+#include "vault_tier.c"
+#include <assert.h>
+
+static const char *kPath = "/tmp/tier_segment_test.vault";
+static const char *kColdDir = "/tmp/tier_segment_test_cold";
+static const char *kPass = "correct horse battery";
+
+static char g_segment[256];
+
+static uint64_t segment_size(void) {
+  struct stat st;
+  return stat(g_segment, &st) == 0 ? (uint64_t)st.st_size : 0;
+}
+
+static void assert_content(const uint8_t *id, const uint8_t *expected,
+                           size_t len) {
+  uint8_t *out = malloc(len + 16);
+  size_t got = 0;
+  assert(vault_read_range(id, 0, out, len + 16, &got) == VAULT_OK);
+  assert(got == len && memcmp(out, expected, len) == 0);
+  free(out);
+}
+
+// Removing from the middle of a probe run keeps the IDs after it reachable
+static void test_forget_collisions(void) {
+  uint8_t ids[5][VAULT_ID_LEN];
+  for (int i = 0; i < 5; i++) {
+    memset(ids[i], 0xA5, VAULT_ID_LEN);
+    ids[i][VAULT_ID_LEN - 1] = (uint8_t)i;
+    vault_tier_note_access(ids[i]);
+  }
+  uint32_t count = g_access_count;
+  vault_tier_forget_access(ids[1]);
+  vault_tier_forget_access(ids[1]);
+  assert(g_access_count == count - 1);
+  pthread_mutex_lock(&g_access_lock);
+  assert(access_slot(ids[1])->at == 0);
+  for (int i = 0; i < 5; i++) {
+    if (i != 1)
+      assert(access_slot(ids[i])->at != 0);
+  }
+  pthread_mutex_unlock(&g_access_lock);
+  for (int i = 0; i < 5; i++)
+    vault_tier_forget_access(ids[i]);
+  assert(g_access_count == count - 5);
+}
+
+int main(void) {
+  assert(vault_init() == VAULT_OK);
+  unlink(kPath);
+  mkdir(kColdDir, 0700);
+  assert(vault_create(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+  assert(vault_open(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+  assert(vault_tier_set_cold_dir(kColdDir) == VAULT_OK);
+  snprintf(g_segment, sizeof(g_segment), "%s", g_segment_path);
+  unlink(g_segment);
+
+  size_t len = 2 * VAULT_CHUNK_SIZE + 321;
+  uint8_t *data = malloc(len);
+  for (size_t i = 0; i < len; i++)
+    data[i] = (uint8_t)(i * 13 + (i >> 9));
+  uint8_t ids[3][VAULT_ID_LEN];
+  for (int i = 0; i < 3; i++) {
+    data[0] = (uint8_t)i;
+    assert(vault_import_file(data, len, VAULT_FILE_TYPE_VIDEO, "v.mp4",
+                             "video/mp4", ids[i]) == VAULT_OK);
+  }
+  usleep(2000);
+  uint64_t moved = 0;
+  assert(vault_tier_migrate(0, UINT64_MAX, &moved) == VAULT_OK);
+  uint64_t live = moved / 3;
+  assert(moved > 0 && segment_size() == TIER_SEGMENT_HEADER_LEN + moved);
+
+  // Reads note access times; deletes drop them again
+  uint8_t byte = 0;
+  size_t got = 0;
+  assert(vault_read_range(ids[0], 1, &byte, 1, &got) == VAULT_OK);
+  assert(vault_read_range(ids[1], 1, &byte, 1, &got) == VAULT_OK);
+  assert(g_access_count == 2);
+  assert(vault_delete_file(ids[0]) == VAULT_OK);
+  assert(vault_delete_file(ids[1]) == VAULT_OK);
+  assert(g_access_count == 0);
+
+  // The first two files leave a dead prefix the trim cannot reach
+  assert(segment_size() == TIER_SEGMENT_HEADER_LEN + moved);
+  assert(vault_tier_migrate(0, UINT64_MAX, &moved) == VAULT_OK);
+  assert(moved == 0);
+  assert(segment_size() == TIER_SEGMENT_HEADER_LEN + live);
+  data[0] = 2;
+  assert_content(ids[2], data, len);
+
+  // The packed offsets were committed
+  vault_close();
+  assert(vault_open(kPath, (const uint8_t *)kPass, strlen(kPass)) ==
+         VAULT_OK);
+  assert(vault_tier_set_cold_dir(kColdDir) == VAULT_OK);
+  assert(segment_size() == TIER_SEGMENT_HEADER_LEN + live);
+  assert_content(ids[2], data, len);
+
+  test_forget_collisions();
+
+  vault_close();
+  unlink(kPath);
+  unlink(g_segment);
+  rmdir(kColdDir);
+  free(data);
+  return 0;
+}
@@ -318,9 +318,11 @@ class _NoLeakAppState extends State<NoLeakApp> with WidgetsBindingObserver {
           builder: (_) => TextViewerScreen(entry: entry),
         );
       case '/image-viewer':
-        final entry = settings.arguments as VaultEntry;
+        final args = settings.arguments;
         return MaterialPageRoute(
-          builder: (_) => ImageViewerScreen(entry: entry),
+          builder: (_) => args is ImageViewerArgs
+              ? ImageViewerScreen(entry: args.entry, siblings: args.siblings)
+              : ImageViewerScreen(entry: args as VaultEntry),
         );
       case '/video-player':
         final entry = settings.arguments as VaultEntry;
@@ -1,38 +1,68 @@
 /// ImageViewerScreen - Secure Image Display
-/// 
+///
 /// Displays encrypted images from the vault with zoom and pan support.
 /// Images are decrypted into memory and displayed without creating
 /// any temporary files on disk.
-/// 
+///
+/// Swiping moves through the other images of the folder the viewer was
+/// opened from. Neighbours are decrypted and decoded to screen size ahead
+/// of time (see ViewerPrefetcher); zooming in reloads the current image at
+/// full resolution.
+///
 /// SECURITY:
 /// - Image data decrypted in memory only
-/// - Zeroized on dispose
+/// - Zeroized on dispose and when a prefetched neighbour is evicted
 /// - FLAG_SECURE prevents screenshots
 /// - No share functionality (intentional)
 /// - Environment check before display
-/// 
+///
 /// Supports common image formats: JPEG, PNG, GIF, WebP, etc.
 
+import 'dart:math' as math;
 import 'dart:typed_data';
+import 'dart:ui' as ui;
+
+import 'package:flutter/foundation.dart';
 import 'package:flutter/material.dart';
 import '../models/vault_state.dart';
 import '../services/vault_channel.dart';
+import '../services/viewer_prefetcher.dart';
+import '../utils/secure_passphrase.dart';
+
+/// Route arguments for opening an image with its swipeable neighbours.
+class ImageViewerArgs {
+  final VaultEntry entry;
+
+  /// Images in display order; should contain [entry]
+  final List<VaultEntry> siblings;
+
+  const ImageViewerArgs({required this.entry, required this.siblings});
+}
 
 /// Secure image viewer with zoom/pan support.
-/// 
+///
 /// FLAG_SECURE is set globally in MainActivity to prevent screenshots.
 class ImageViewerScreen extends StatefulWidget {
   final VaultEntry entry;
+  final List<VaultEntry> siblings;
 
-  const ImageViewerScreen({super.key, required this.entry});
+  const ImageViewerScreen({
+    super.key,
+    required this.entry,
+    this.siblings = const [],
+  });
 
   @override
   State<ImageViewerScreen> createState() => _ImageViewerScreenState();
 }
 
 class _ImageViewerScreenState extends State<ImageViewerScreen> {
-  bool _isLoading = true;
-  Uint8List? _imageData;
+  late final List<VaultEntry> _entries;
+  late final PageController _pageController;
+  ViewerPrefetcher? _prefetcher;
+  int _index = 0;
+  bool _isReady = false;
+  bool _isZoomed = false;
   String? _error;
   final TransformationController _transformationController =
       TransformationController();
@@ -40,10 +70,33 @@ class _ImageViewerScreenState extends State<ImageViewerScreen> {
   @override
   void initState() {
     super.initState();
-    _checkSecurityAndLoadImage();
+    final index = widget.siblings
+        .indexWhere((e) => listEquals(e.fileId, widget.entry.fileId));
+    _entries = index < 0 ? [widget.entry] : widget.siblings;
+    _index = index < 0 ? 0 : index;
+    _pageController = PageController(initialPage: _index);
+    _checkSecurity();
   }
 
-  Future<void> _checkSecurityAndLoadImage() async {
+  @override
+  void didChangeDependencies() {
+    super.didChangeDependencies();
+    if (_prefetcher != null) return;
+    // Decode to the screen's physical size; zooming reloads at full size
+    final media = MediaQuery.of(context);
+    final longest = math.max(media.size.width, media.size.height);
+    _prefetcher = ViewerPrefetcher(
+      entries: _entries,
+      decodeMaxSide: (longest * media.devicePixelRatio).round(),
+      // Decoding keeps the first frame only
+      shouldDecode: (entry) =>
+          entry.isImage &&
+          entry.mimeType != 'image/gif' &&
+          !entry.name.toLowerCase().endsWith('.gif'),
+    );
+  }
+
+  Future<void> _checkSecurity() async {
     try {
       // Security check before viewing content (PRD Req 2.5)
       final isSecure = await VaultChannel.checkEnvironment();
@@ -56,14 +109,12 @@ class _ImageViewerScreenState extends State<ImageViewerScreen> {
         }
         return;
       }
-      
-      await _loadImage();
+      if (!mounted) return;
+      _prefetcher!.moveTo(_index);
+      setState(() => _isReady = true);
     } catch (e) {
       if (mounted) {
-        setState(() {
-          _error = e.toString();
-          _isLoading = false;
-        });
+        setState(() => _error = e.toString());
       }
     }
   }
@@ -71,32 +122,24 @@ class _ImageViewerScreenState extends State<ImageViewerScreen> {
   @override
   void dispose() {
     _transformationController.dispose();
-    // Zeroize image data
-    if (_imageData != null) {
-      for (int i = 0; i < _imageData!.length; i++) {
-        _imageData![i] = 0;
-      }
-    }
+    _pageController.dispose();
+    // Zeroizes and disposes everything still prefetched
+    _prefetcher?.dispose();
     super.dispose();
   }
 
-  Future<void> _loadImage() async {
-    try {
-      final data = await VaultChannel.readFile(widget.entry.fileId);
-      setState(() {
-        _imageData = data;
-        _isLoading = false;
-      });
-    } catch (e) {
-      setState(() {
-        _error = e.toString();
-        _isLoading = false;
-      });
-    }
+  void _onPageChanged(int index) {
+    _transformationController.value = Matrix4.identity();
+    _prefetcher!.moveTo(index);
+    setState(() {
+      _index = index;
+      _isZoomed = false;
+    });
   }
 
   void _resetZoom() {
     _transformationController.value = Matrix4.identity();
+    setState(() => _isZoomed = false);
   }
 
   @override
@@ -105,13 +148,15 @@ class _ImageViewerScreenState extends State<ImageViewerScreen> {
       backgroundColor: Colors.black,
       appBar: AppBar(
         title: Text(
-          widget.entry.name,
+          _entries.length > 1
+              ? '${_entries[_index].name}  (${_index + 1}/${_entries.length})'
+              : _entries[_index].name,
           style: const TextStyle(fontSize: 16),
         ),
         backgroundColor: Colors.transparent,
         elevation: 0,
         actions: [
-          if (_imageData != null)
+          if (_isReady)
             IconButton(
               icon: const Icon(Icons.zoom_out_map),
               tooltip: 'Reset Zoom',
@@ -124,56 +169,221 @@ class _ImageViewerScreenState extends State<ImageViewerScreen> {
   }
 
   Widget _buildBody() {
-    if (_isLoading) {
+    if (_error != null) {
+      return _ImageError(message: _error!);
+    }
+    if (!_isReady) {
       return const Center(
         child: CircularProgressIndicator(),
       );
     }
 
+    return PageView.builder(
+      controller: _pageController,
+      itemCount: _entries.length,
+      // A zoomed image pans instead of turning the page
+      physics: _isZoomed
+          ? const NeverScrollableScrollPhysics()
+          : const PageScrollPhysics(),
+      onPageChanged: _onPageChanged,
+      itemBuilder: (context, index) => _ImagePage(
+        key: ValueKey(index),
+        prefetcher: _prefetcher!,
+        index: index,
+        transformationController:
+            index == _index ? _transformationController : null,
+        onZoomChanged: (zoomed) {
+          if (index == _index && zoomed != _isZoomed) {
+            setState(() => _isZoomed = zoomed);
+          }
+        },
+      ),
+    );
+  }
+}
+
+/// One page of the viewer. Holds its own clone of the prefetched image (or
+/// copy of the raw bytes) so eviction by the prefetcher cannot affect it.
+class _ImagePage extends StatefulWidget {
+  final ViewerPrefetcher prefetcher;
+  final int index;
+  final TransformationController? transformationController;
+  final ValueChanged<bool> onZoomChanged;
+
+  const _ImagePage({
+    super.key,
+    required this.prefetcher,
+    required this.index,
+    required this.transformationController,
+    required this.onZoomChanged,
+  });
+
+  @override
+  State<_ImagePage> createState() => _ImagePageState();
+}
+
+class _ImagePageState extends State<_ImagePage> {
+  ui.Image? _image;
+  Uint8List? _bytes;
+  bool _fullResolution = false;
+  bool _upgrading = false;
+  bool _loading = false;
+  String? _error;
+  TransformationController? _ownController;
+
+  TransformationController get _controller =>
+      widget.transformationController ??
+      (_ownController ??= TransformationController());
+
+  @override
+  void initState() {
+    super.initState();
+    final item = widget.prefetcher.peek(widget.index);
+    if (item != null) {
+      _adopt(item);
+    } else {
+      _load();
+    }
+  }
+
+  @override
+  void didUpdateWidget(covariant _ImagePage oldWidget) {
+    super.didUpdateWidget(oldWidget);
+    // A load dropped while the user was elsewhere is retried on return
+    if (_image == null && _bytes == null && _error == null && !_loading) {
+      _load();
+    }
+  }
+
+  @override
+  void dispose() {
+    _clear();
+    _ownController?.dispose();
+    super.dispose();
+  }
+
+  Future<void> _load() async {
+    _loading = true;
+    try {
+      final item = await widget.prefetcher.load(widget.index);
+      if (!mounted) return;
+      if (item == null) {
+        // Moved away before it arrived; PageView disposes this page shortly
+        return;
+      }
+      setState(() => _adopt(item));
+    } catch (e) {
+      if (mounted) setState(() => _error = e.toString());
+    } finally {
+      _loading = false;
+    }
+  }
+
+  void _adopt(PrefetchedItem item) {
+    _clear();
+    _image = item.image?.clone();
+    _fullResolution = item.fullResolution;
+    final bytes = item.bytes;
+    if (bytes != null) _bytes = Uint8List.fromList(bytes);
+  }
+
+  void _clear() {
+    _image?.dispose();
+    _image = null;
+    final bytes = _bytes;
+    _bytes = null;
+    if (bytes != null) {
+      PaintingBinding.instance.imageCache.evict(MemoryImage(bytes));
+      SecurePassphrase.zeroize(bytes);
+    }
+  }
+
+  void _onInteractionEnd(ScaleEndDetails details) {
+    final zoomed = _controller.value.getMaxScaleOnAxis() > 1.01;
+    widget.onZoomChanged(zoomed);
+    if (zoomed && _image != null && !_fullResolution && !_upgrading) {
+      _upgradeResolution();
+    }
+  }
+
+  Future<void> _upgradeResolution() async {
+    _upgrading = true;
+    try {
+      final item = await widget.prefetcher.loadFullResolution(widget.index);
+      if (mounted && item != null) setState(() => _adopt(item));
+    } catch (_) {
+      // Keep showing the screen-size decode
+    } finally {
+      _upgrading = false;
+    }
+  }
+
+  @override
+  Widget build(BuildContext context) {
     if (_error != null) {
-      return Center(
-        child: Column(
-          mainAxisAlignment: MainAxisAlignment.center,
-          children: [
-            Icon(Icons.broken_image, size: 64, color: Colors.red[400]),
-            const SizedBox(height: 16),
-            Text(
-              'Failed to load image',
-              style: TextStyle(color: Colors.grey[300], fontSize: 18),
-            ),
-            const SizedBox(height: 8),
-            Text(
-              _error!,
-              style: TextStyle(color: Colors.grey[500], fontSize: 14),
-              textAlign: TextAlign.center,
-            ),
-          ],
-        ),
+      return _ImageError(message: _error!);
+    }
+    if (_image == null && _bytes == null) {
+      return const Center(
+        child: CircularProgressIndicator(),
       );
     }
 
     return InteractiveViewer(
-      transformationController: _transformationController,
+      transformationController: _controller,
       minScale: 0.5,
       maxScale: 4.0,
+      onInteractionEnd: _onInteractionEnd,
       child: Center(
-        child: Image.memory(
-          _imageData!,
-          fit: BoxFit.contain,
-          errorBuilder: (context, error, stackTrace) {
-            return Column(
-              mainAxisAlignment: MainAxisAlignment.center,
-              children: [
-                Icon(Icons.broken_image, size: 64, color: Colors.red[400]),
-                const SizedBox(height: 16),
-                Text(
-                  'Could not decode image',
-                  style: TextStyle(color: Colors.grey[300]),
-                ),
-              ],
-            );
-          },
-        ),
+        child: _image != null
+            ? RawImage(image: _image, fit: BoxFit.contain)
+            : Image.memory(
+                _bytes!,
+                fit: BoxFit.contain,
+                errorBuilder: (context, error, stackTrace) {
+                  return Column(
+                    mainAxisAlignment: MainAxisAlignment.center,
+                    children: [
+                      Icon(Icons.broken_image,
+                          size: 64, color: Colors.red[400]),
+                      const SizedBox(height: 16),
+                      Text(
+                        'Could not decode image',
+                        style: TextStyle(color: Colors.grey[300]),
+                      ),
+                    ],
+                  );
+                },
+              ),
+      ),
+    );
+  }
+}
+
+class _ImageError extends StatelessWidget {
+  final String message;
+
+  const _ImageError({required this.message});
+
+  @override
+  Widget build(BuildContext context) {
+    return Center(
+      child: Column(
+        mainAxisAlignment: MainAxisAlignment.center,
+        children: [
+          Icon(Icons.broken_image, size: 64, color: Colors.red[400]),
+          const SizedBox(height: 16),
+          Text(
+            'Failed to load image',
+            style: TextStyle(color: Colors.grey[300], fontSize: 18),
+          ),
+          const SizedBox(height: 8),
+          Text(
+            message,
+            style: TextStyle(color: Colors.grey[500], fontSize: 14),
+            textAlign: TextAlign.center,
+          ),
+        ],
       ),
     );
   }
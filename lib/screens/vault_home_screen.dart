@@ -9,7 +9,7 @@
 /// - Create folders
 /// - Move, copy, rename, delete files
 /// - Export files (with security warning)
-/// - Search files by name
+/// - Search files by name and text content
 /// - Change vault password
 /// - Export entire vault
 ///
@@ -22,6 +22,7 @@
 import 'dart:async';
 import 'package:flutter/material.dart';
 import 'package:flutter/foundation.dart';
+import 'package:flutter/services.dart';
 import '../models/vault_state.dart';
 import '../services/vault_state_manager.dart';
 import '../services/vault_channel.dart';
@@ -37,6 +38,7 @@ import '../utils/secure_logger.dart';
 import '../utils/secure_passphrase.dart';
 import '../widgets/secure_keyboard.dart';
 import '../widgets/responsive_layout.dart';
+import 'image_viewer_screen.dart';
 
 /// Main file browser screen for an unlocked vault.
 ///
@@ -61,6 +63,9 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
   final _streamingImportService = StreamingImportService.instance;
   final _transferProgressService = TransferProgressService.instance;
   String _searchQuery = '';
+  List<VaultEntry> _contentMatches = const [];
+  int _contentSearchSeq = 0;
+  Timer? _searchDebounceTimer;
   bool _isImporting = false;
   bool _isExporting = false;
   bool _isVaultOp = false;
@@ -103,7 +108,8 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
         _transferProgressService.progressStream.listen((progress) {
       if (!_isExporting) return;
       if (progress.operation != 'export_vault' &&
-          progress.operation != 'export_file') return;
+          progress.operation != 'export_file' &&
+          progress.operation != 'export_archive') return;
       if (mounted) {
         setState(() {
           _exportProgress = progress.normalized;
@@ -116,13 +122,19 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
   void dispose() {
     _importProgressSub?.cancel();
     _transferProgressSub?.cancel();
+    _searchDebounceTimer?.cancel();
     _searchController.dispose();
     super.dispose();
   }
 
   List<VaultEntry> get _filteredEntries {
     if (_searchQuery.isNotEmpty) {
-      return widget.stateManager.searchEntries(_searchQuery);
+      final byName = widget.stateManager.searchEntries(_searchQuery);
+      final seen = byName.map((e) => e.fileId.join(',')).toSet();
+      return [
+        ...byName,
+        ..._contentMatches.where((e) => seen.add(e.fileId.join(','))),
+      ];
     }
     final current = _currentFolderPath;
     return widget.stateManager.entries
@@ -132,6 +144,34 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
 
   bool get _isSearching => _searchQuery.isNotEmpty;
 
+  void _onSearchChanged(String value) {
+    setState(() => _searchQuery = value);
+    widget.stateManager.recordActivity();
+    // Name matches update at once; content search waits for typing to pause
+    _searchDebounceTimer?.cancel();
+    if (value.trim().isEmpty) {
+      _contentSearchSeq++;
+      setState(() => _contentMatches = const []);
+      return;
+    }
+    _searchDebounceTimer = Timer(const Duration(milliseconds: 300), () {
+      _searchContent(value);
+    });
+  }
+
+  /// Content matches arrive asynchronously; stale responses are dropped.
+  Future<void> _searchContent(String query) async {
+    final seq = ++_contentSearchSeq;
+    var matches = const <VaultEntry>[];
+    try {
+      matches = await widget.stateManager.searchContent(query);
+    } catch (e) {
+      SecureLogger.e('VaultHomeScreen', 'Content search failed: $e');
+    }
+    if (!mounted || seq != _contentSearchSeq) return;
+    setState(() => _contentMatches = matches);
+  }
+
   List<String> get _visibleFolders {
     if (_isSearching) return [];
     final prefix = _currentFolderPath.isEmpty ? '' : '$_currentFolderPath/';
@@ -285,9 +325,11 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
     }
   }
 
-  Future<void> _importFolder() async {
+  /// Import a SAF folder tree, or a ZIP/TAR archive when [fromArchive] is set;
+  /// both return files with their relative folders.
+  Future<void> _importFolder({bool fromArchive = false}) async {
     SecureLogger.d('VaultHomeScreen',
-        '_importFolder: starting, currentFolderPath=$_currentFolderPath');
+        '_importFolder: starting, fromArchive=$fromArchive, currentFolderPath=$_currentFolderPath');
     final sessionId = DateTime.now().microsecondsSinceEpoch;
 
     try {
@@ -306,7 +348,9 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
       }
 
       widget.stateManager.freezeTimers();
-      final folderInfo = await VaultChannel.pickFolder();
+      final folderInfo = fromArchive
+          ? await VaultChannel.pickFile()
+          : await VaultChannel.pickFolder();
       if (folderInfo == null) {
         SecureLogger.d(
             'VaultHomeScreen', '_importFolder: user cancelled folder picker');
@@ -330,50 +374,24 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
 
       SecureLogger.d('VaultHomeScreen',
           '_importFolder: calling VaultChannel.importFolder');
-      final result = await VaultChannel.importFolder(
-        folderInfo['uri'] as String,
-        sessionId: sessionId,
-      );
+      final result = fromArchive
+          ? await VaultChannel.importArchive(
+              folderInfo['uri'] as String,
+              sessionId: sessionId,
+            )
+          : await VaultChannel.importFolder(
+              folderInfo['uri'] as String,
+              sessionId: sessionId,
+            );
 
       final files = (result['files'] as List?) ?? [];
       final skipped = (result['skipped'] as num?)?.toInt() ?? 0;
       SecureLogger.d('VaultHomeScreen',
           '_importFolder: received ${files.length} files, skipped=$skipped');
 
-      final imported = <List<int>, String>{};
-      for (final item in files) {
-        if (item is! Map) continue;
-        final fileId = List<int>.from(item['fileId'] as List);
-        var folder = (item['folder'] as String?) ?? '';
-        SecureLogger.d('VaultHomeScreen',
-            '_importFolder: file folder from native=$folder');
-        if (_currentFolderPath.isNotEmpty) {
-          folder = folder.isEmpty
-              ? _currentFolderPath
-              : '$_currentFolderPath/$folder';
-        }
-        SecureLogger.d(
-            'VaultHomeScreen', '_importFolder: final folder=$folder');
-        imported[fileId] = folder;
-      }
-
-      if (imported.isNotEmpty) {
-        SecureLogger.d('VaultHomeScreen',
-            '_importFolder: calling applyImportedFiles with ${imported.length} files');
-        await widget.stateManager.applyImportedFiles(imported);
-        SecureLogger.d(
-            'VaultHomeScreen', '_importFolder: calling refreshEntries');
-        // Don't call refreshEntries here - it will reload folder map from disk
-        // which may fail if the file was just written. The folders are already
-        // in memory from applyImportedFiles.
-        // Instead, just refresh the entries list without reloading folder map.
-        await widget.stateManager.refreshEntriesOnly();
-        SecureLogger.d('VaultHomeScreen',
-            '_importFolder: folders after import=${widget.stateManager.folders}');
-      }
+      final count = await _applyFolderImport(files, _currentFolderPath);
 
       if (mounted) {
-        final count = imported.length;
         final message = skipped > 0
             ? 'Imported $count file(s), skipped $skipped'
             : 'Imported $count file(s)';
@@ -386,10 +404,12 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
       }
     } catch (e) {
       SecureLogger.e('VaultHomeScreen', '_importFolder: error', e);
+      await _applyPartialImport(e, _currentFolderPath);
       if (mounted) {
         ScaffoldMessenger.of(context).showSnackBar(
           SnackBar(
-            content: Text('Import folder failed: $e'),
+            content: Text(
+                '${fromArchive ? 'Import archive' : 'Import folder'} failed: $e'),
             backgroundColor: CyberpunkTheme.error,
           ),
         );
@@ -413,6 +433,246 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
     }
   }
 
+  /// A failed folder import or sync reports the files it placed before
+  /// stopping; they still get their folders. Returns how many were placed.
+  Future<int> _applyPartialImport(Object error, String baseFolder) async {
+    if (error is! PlatformException || error.details is! Map) return 0;
+    final files = ((error.details as Map)['files'] as List?) ?? [];
+    if (files.isEmpty) return 0;
+    try {
+      return await _applyFolderImport(files, baseFolder);
+    } catch (e) {
+      SecureLogger.e('VaultHomeScreen', '_applyPartialImport: error', e);
+      return 0;
+    }
+  }
+
+  /// Place files returned by a folder-style import under [baseFolder] in
+  /// the folder map; returns how many were placed.
+  Future<int> _applyFolderImport(List files, String baseFolder) async {
+    final imported = <List<int>, String>{};
+    for (final item in files) {
+      if (item is! Map) continue;
+      final fileId = List<int>.from(item['fileId'] as List);
+      var folder = (item['folder'] as String?) ?? '';
+      SecureLogger.d('VaultHomeScreen',
+          '_applyFolderImport: file folder from native=$folder');
+      if (baseFolder.isNotEmpty) {
+        folder = folder.isEmpty ? baseFolder : '$baseFolder/$folder';
+      }
+      SecureLogger.d(
+          'VaultHomeScreen', '_applyFolderImport: final folder=$folder');
+      imported[fileId] = folder;
+    }
+
+    if (imported.isNotEmpty) {
+      SecureLogger.d('VaultHomeScreen',
+          '_applyFolderImport: calling applyImportedFiles with ${imported.length} files');
+      await widget.stateManager.applyImportedFiles(imported);
+      // Don't call refreshEntries here - it will reload folder map from disk
+      // which may fail if the file was just written. The folders are already
+      // in memory from applyImportedFiles.
+      // Instead, just refresh the entries list without reloading folder map.
+      await widget.stateManager.refreshEntriesOnly();
+      SecureLogger.d('VaultHomeScreen',
+          '_applyFolderImport: folders after import=${widget.stateManager.folders}');
+    }
+    return imported.length;
+  }
+
+  /// Pick a folder to watch, register it for the current folder, and run
+  /// its first sync (which imports everything).
+  Future<void> _watchFolder() async {
+    Map<String, dynamic> source;
+    widget.stateManager.freezeTimers();
+    try {
+      final folderInfo = await VaultChannel.pickFolder();
+      if (folderInfo == null) return;
+      source = await VaultChannel.addWatchedSource(
+        folderInfo['uri'] as String,
+        folder: _currentFolderPath,
+      );
+    } catch (e) {
+      SecureLogger.e('VaultHomeScreen', '_watchFolder: error', e);
+      if (mounted) {
+        ScaffoldMessenger.of(context).showSnackBar(
+          SnackBar(
+            content: Text('Watch folder failed: $e'),
+            backgroundColor: CyberpunkTheme.error,
+          ),
+        );
+      }
+      return;
+    } finally {
+      widget.stateManager.unfreezeTimers();
+    }
+    await _syncWatchedSources([source]);
+  }
+
+  Future<void> _showWatchedFolders() async {
+    widget.stateManager.recordActivity();
+    List<Map<String, dynamic>> sources;
+    try {
+      sources = await VaultChannel.listWatchedSources();
+    } catch (e) {
+      SecureLogger.e('VaultHomeScreen', '_showWatchedFolders: error', e);
+      return;
+    }
+    if (!mounted) return;
+    if (sources.isEmpty) {
+      ScaffoldMessenger.of(context).showSnackBar(
+        const SnackBar(content: Text('No watched folders yet')),
+      );
+      return;
+    }
+
+    final action = await showModalBottomSheet<String>(
+      context: context,
+      backgroundColor: CyberpunkTheme.surface,
+      shape: RoundedRectangleBorder(
+        borderRadius: BorderRadius.circular(16),
+        side: BorderSide(color: CyberpunkTheme.surfaceBorder),
+      ),
+      builder: (context) => SafeArea(
+        child: Column(
+          mainAxisSize: MainAxisSize.min,
+          children: [
+            ListTile(
+              leading: const Icon(Icons.sync, color: CyberpunkTheme.neonGreen),
+              title: const Text('Sync All',
+                  style: TextStyle(color: CyberpunkTheme.textPrimary)),
+              onTap: () => Navigator.pop(context, 'sync_all'),
+            ),
+            for (final source in sources)
+              ListTile(
+                leading: const Icon(Icons.folder_special,
+                    color: CyberpunkTheme.neonGreen),
+                title: Text(source['name'] as String? ?? 'folder',
+                    style: const TextStyle(color: CyberpunkTheme.textPrimary)),
+                subtitle: Text(
+                    (source['folder'] as String? ?? '').isEmpty
+                        ? 'Into vault root'
+                        : 'Into ${source['folder']}',
+                    style:
+                        const TextStyle(color: CyberpunkTheme.textSecondary)),
+                trailing: IconButton(
+                  icon: const Icon(Icons.link_off,
+                      color: CyberpunkTheme.textSecondary),
+                  tooltip: 'Stop watching',
+                  onPressed: () =>
+                      Navigator.pop(context, 'remove:${source['id']}'),
+                ),
+                onTap: () => Navigator.pop(context, 'sync:${source['id']}'),
+              ),
+          ],
+        ),
+      ),
+    );
+
+    if (action == null) return;
+    if (action == 'sync_all') {
+      await _syncWatchedSources(sources);
+    } else if (action.startsWith('sync:')) {
+      final id = action.substring(5);
+      await _syncWatchedSources(sources.where((s) => s['id'] == id).toList());
+    } else if (action.startsWith('remove:')) {
+      try {
+        await VaultChannel.removeWatchedSource(action.substring(7));
+        if (mounted) {
+          ScaffoldMessenger.of(context).showSnackBar(
+            const SnackBar(content: Text('Stopped watching folder')),
+          );
+        }
+      } catch (e) {
+        SecureLogger.e('VaultHomeScreen', '_showWatchedFolders: remove failed', e);
+      }
+    }
+  }
+
+  /// Sync watched folders one after another; each sync imports only files
+  /// that are new or changed since the previous one.
+  Future<void> _syncWatchedSources(List<Map<String, dynamic>> sources) async {
+    final sessionId = DateTime.now().microsecondsSinceEpoch;
+    var imported = 0;
+    var skipped = 0;
+    var unchanged = 0;
+    var failed = 0;
+
+    try {
+      widget.stateManager.freezeTimers();
+      await VaultChannel.enableWakelock();
+      if (mounted) {
+        setState(() {
+          _isImporting = true;
+          _importProgress = 0;
+          _activeImportId = null;
+          _activeImportSessionId = sessionId;
+          _isImportFinalizing = false;
+        });
+      }
+
+      for (final source in sources) {
+        // A revoked or failing folder must not hold back the others
+        try {
+          final result = await VaultChannel.syncWatchedSource(
+            source['id'] as String,
+            sessionId: sessionId,
+          );
+          skipped += (result['skipped'] as num?)?.toInt() ?? 0;
+          unchanged += (result['unchanged'] as num?)?.toInt() ?? 0;
+          imported += await _applyFolderImport(
+            (result['files'] as List?) ?? [],
+            (result['folder'] as String?) ?? '',
+          );
+        } catch (e) {
+          SecureLogger.e(
+              'VaultHomeScreen', '_syncWatchedSources: source failed', e);
+          failed++;
+          imported += await _applyPartialImport(
+              e, (source['folder'] as String?) ?? '');
+        }
+      }
+
+      if (mounted) {
+        var message = imported == 0
+            ? 'Up to date ($unchanged file(s) unchanged)'
+            : 'Imported $imported new or changed file(s)';
+        if (skipped > 0) message = '$message, skipped $skipped';
+        if (failed > 0) message = '$message; $failed folder(s) failed to sync';
+        ScaffoldMessenger.of(context).showSnackBar(
+          SnackBar(
+            content: Text(message),
+            backgroundColor: failed > 0
+                ? CyberpunkTheme.error
+                : CyberpunkTheme.neonGreen.withOpacity(0.9),
+          ),
+        );
+      }
+    } catch (e) {
+      SecureLogger.e('VaultHomeScreen', '_syncWatchedSources: error', e);
+      if (mounted) {
+        ScaffoldMessenger.of(context).showSnackBar(
+          SnackBar(
+            content: Text('Sync failed: $e'),
+            backgroundColor: CyberpunkTheme.error,
+          ),
+        );
+      }
+    } finally {
+      await VaultChannel.disableWakelock();
+      widget.stateManager.unfreezeTimers();
+      if (mounted) {
+        setState(() {
+          _isImporting = false;
+          _importProgress = null;
+          _activeImportId = null;
+          _activeImportSessionId = null;
+          _isImportFinalizing = false;
+        });
+      }
+    }
+  }
+
   Future<void> _showImportOptions() async {
     widget.stateManager.recordActivity();
     final action = await showModalBottomSheet<String>(
@@ -440,6 +700,28 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
                   style: TextStyle(color: CyberpunkTheme.textPrimary)),
               onTap: () => Navigator.pop(context, 'folder'),
             ),
+            ListTile(
+              leading:
+                  const Icon(Icons.archive, color: CyberpunkTheme.neonGreen),
+              title: const Text('Import Archive (ZIP/TAR)',
+                  style: TextStyle(color: CyberpunkTheme.textPrimary)),
+              onTap: () => Navigator.pop(context, 'archive'),
+            ),
+            ListTile(
+              leading: const Icon(Icons.sync, color: CyberpunkTheme.neonGreen),
+              title: const Text('Watch Folder',
+                  style: TextStyle(color: CyberpunkTheme.textPrimary)),
+              subtitle: const Text('Later syncs import only new files',
+                  style: TextStyle(color: CyberpunkTheme.textSecondary)),
+              onTap: () => Navigator.pop(context, 'watch'),
+            ),
+            ListTile(
+              leading: const Icon(Icons.folder_special,
+                  color: CyberpunkTheme.neonGreen),
+              title: const Text('Watched Folders',
+                  style: TextStyle(color: CyberpunkTheme.textPrimary)),
+              onTap: () => Navigator.pop(context, 'watched'),
+            ),
             ListTile(
               leading: const Icon(Icons.create_new_folder,
                   color: CyberpunkTheme.neonGreen),
@@ -456,6 +738,12 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
       await _importFile();
     } else if (action == 'folder') {
       await _importFolder();
+    } else if (action == 'archive') {
+      await _importFolder(fromArchive: true);
+    } else if (action == 'watch') {
+      await _watchFolder();
+    } else if (action == 'watched') {
+      await _showWatchedFolders();
     } else if (action == 'create_folder') {
       await _createFolder();
     }
@@ -672,6 +960,123 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
     }
   }
 
+  String _formatBytes(int bytes) {
+    if (bytes < 1024) return '$bytes B';
+    if (bytes < 1024 * 1024) return '${(bytes / 1024).toStringAsFixed(1)} KB';
+    if (bytes < 1024 * 1024 * 1024) {
+      return '${(bytes / (1024 * 1024)).toStringAsFixed(1)} MB';
+    }
+    return '${(bytes / (1024 * 1024 * 1024)).toStringAsFixed(1)} GB';
+  }
+
+  /// Storage breakdown from the native counters: totals, reclaimable space,
+  /// bytes per type and top-level folder, and the largest files.
+  Future<void> _showStorageDialog() async {
+    final Map<String, dynamic> stats;
+    try {
+      stats = await widget.stateManager.getStorageStats();
+    } catch (e) {
+      if (mounted) {
+        ScaffoldMessenger.of(context).showSnackBar(
+          const SnackBar(
+            content: Text('Could not read storage statistics'),
+            backgroundColor: CyberpunkTheme.error,
+          ),
+        );
+      }
+      return;
+    }
+    if (!mounted) return;
+
+    const typeLabels = {
+      'text': 'Documents',
+      'image': 'Images',
+      'video': 'Videos',
+      'other': 'Other',
+    };
+    final typeBytes = Map<String, dynamic>.from(stats['typeBytes'] as Map);
+    final typeFiles = Map<String, dynamic>.from(stats['typeFiles'] as Map);
+    final folderBytes = stats['folderBytes'] as Map<String, int>;
+    final topFolders = folderBytes.entries
+        .where((e) => e.key.isNotEmpty && !e.key.contains('/'))
+        .toList()
+      ..sort((a, b) => b.value.compareTo(a.value));
+    final largest =
+        (stats['largestFiles'] as List).cast<Map<String, dynamic>>();
+
+    Widget row(String label, String value) => Padding(
+          padding: const EdgeInsets.symmetric(vertical: 3),
+          child: Row(
+            children: [
+              Expanded(
+                child: Text(label,
+                    overflow: TextOverflow.ellipsis,
+                    style:
+                        const TextStyle(color: CyberpunkTheme.textSecondary)),
+              ),
+              const SizedBox(width: 12),
+              Text(value,
+                  style: const TextStyle(color: CyberpunkTheme.textPrimary)),
+            ],
+          ),
+        );
+    Widget heading(String text) => Padding(
+          padding: const EdgeInsets.only(top: 16, bottom: 4),
+          child: Text(text,
+              style: const TextStyle(
+                  color: CyberpunkTheme.neonGreen, letterSpacing: 1)),
+        );
+
+    await showDialog<void>(
+      context: context,
+      builder: (context) => AlertDialog(
+        backgroundColor: CyberpunkTheme.surface,
+        shape: RoundedRectangleBorder(
+          borderRadius: BorderRadius.circular(16),
+          side: BorderSide(color: CyberpunkTheme.neonGreen.withOpacity(0.3)),
+        ),
+        title: const Text(
+          'STORAGE',
+          style: TextStyle(
+            color: CyberpunkTheme.neonGreen,
+            letterSpacing: 2,
+          ),
+        ),
+        content: SingleChildScrollView(
+          child: Column(
+            mainAxisSize: MainAxisSize.min,
+            crossAxisAlignment: CrossAxisAlignment.start,
+            children: [
+              row('Files', '${stats['fileCount']}'),
+              row('File data', _formatBytes(stats['plaintextBytes'] as int)),
+              row('Vault size', _formatBytes(stats['totalSize'] as int)),
+              row('Reclaimable', _formatBytes(stats['freeSpace'] as int)),
+              row('Fragmented files', '${stats['fragmentedFiles']}'),
+              heading('BY TYPE'),
+              for (final type in typeLabels.keys)
+                if ((typeFiles[type] as int? ?? 0) > 0)
+                  row('${typeLabels[type]} (${typeFiles[type]})',
+                      _formatBytes(typeBytes[type] as int)),
+              if (topFolders.isNotEmpty) heading('BY FOLDER'),
+              for (final folder in topFolders.take(5))
+                row(folder.key, _formatBytes(folder.value)),
+              if (largest.isNotEmpty) heading('LARGEST FILES'),
+              for (final file in largest)
+                row(file['name'] as String, _formatBytes(file['size'] as int)),
+            ],
+          ),
+        ),
+        actions: [
+          TextButton(
+            onPressed: () => Navigator.pop(context),
+            child: const Text('CLOSE',
+                style: TextStyle(color: CyberpunkTheme.neonGreen)),
+          ),
+        ],
+      ),
+    );
+  }
+
   Future<void> _showExportDialog() async {
     final passwordController = TextEditingController();
     bool obscure = true;
@@ -996,12 +1401,14 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
     }
   }
 
-  Future<void> _exportFile(VaultEntry entry) async {
-    SecureLogger.d(
-        'VaultHomeScreen', '_exportFile: starting export of ${entry.name}');
-    widget.stateManager.recordActivity();
-
-    // Show security warning and confirmation dialog
+  /// Security warning shown before anything leaves the vault decrypted.
+  Future<bool> _confirmPlaintextExport({
+    required String title,
+    required String message,
+    required String noun,
+    String action = 'EXPORT',
+    String? notice,
+  }) async {
     final confirm = await showDialog<bool>(
       context: context,
       builder: (context) => AlertDialog(
@@ -1014,9 +1421,10 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
           children: [
             Icon(Icons.warning_amber, color: CyberpunkTheme.warning, size: 24),
             const SizedBox(width: 8),
-            const Text(
-              'EXPORT FILE',
-              style: TextStyle(color: CyberpunkTheme.warning, letterSpacing: 2),
+            Text(
+              title,
+              style: const TextStyle(
+                  color: CyberpunkTheme.warning, letterSpacing: 2),
             ),
           ],
         ),
@@ -1025,7 +1433,7 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
           crossAxisAlignment: CrossAxisAlignment.start,
           children: [
             Text(
-              'You are about to export "${entry.name}" outside the vault.',
+              message,
               style: const TextStyle(color: CyberpunkTheme.textPrimary),
             ),
             const SizedBox(height: 16),
@@ -1056,12 +1464,13 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
                     ],
                   ),
                   const SizedBox(height: 8),
-                  const Text(
-                    '• The exported file will be DECRYPTED\n'
-                    '• It will be accessible outside the vault\n'
-                    '• Other apps may be able to access it\n'
-                    '• Consider deleting after use',
-                    style: TextStyle(
+                  Text(
+                    notice ??
+                        '• The exported $noun will be DECRYPTED\n'
+                            '• It will be accessible outside the vault\n'
+                            '• Other apps may be able to access it\n'
+                            '• Consider deleting after use',
+                    style: const TextStyle(
                       color: CyberpunkTheme.textSecondary,
                       fontSize: 12,
                       height: 1.5,
@@ -1082,12 +1491,27 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
             onPressed: () => Navigator.pop(context, true),
             style:
                 TextButton.styleFrom(foregroundColor: CyberpunkTheme.warning),
-            child: const Text('EXPORT'),
+            child: Text(action),
           ),
         ],
       ),
     );
 
+    return confirm == true;
+  }
+
+  Future<void> _exportFile(VaultEntry entry) async {
+    SecureLogger.d(
+        'VaultHomeScreen', '_exportFile: starting export of ${entry.name}');
+    widget.stateManager.recordActivity();
+
+    // Show security warning and confirmation dialog
+    final confirm = await _confirmPlaintextExport(
+      title: 'EXPORT FILE',
+      message: 'You are about to export "${entry.name}" outside the vault.',
+      noun: 'file',
+    );
+
     if (confirm != true) {
       SecureLogger.d('VaultHomeScreen', '_exportFile: user cancelled');
       return;
@@ -1145,6 +1569,117 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
     }
   }
 
+  /// Stream a file to another app; no decrypted copy is written to disk.
+  Future<void> _shareFile(VaultEntry entry, {bool openWith = false}) async {
+    widget.stateManager.recordActivity();
+
+    final confirm = await _confirmPlaintextExport(
+      title: openWith ? 'OPEN WITH' : 'SHARE FILE',
+      message: 'You are about to give another app access to "${entry.name}".',
+      noun: 'file',
+      action: openWith ? 'OPEN' : 'SHARE',
+      notice: '• The receiving app reads the file DECRYPTED\n'
+          '• Nothing is written to disk by NoLeak\n'
+          '• Access ends when the vault locks\n'
+          '• The receiving app may keep its own copy',
+    );
+    if (confirm != true) return;
+
+    try {
+      await VaultChannel.shareFile(entry.fileId, openWith: openWith);
+    } catch (e) {
+      SecureLogger.e('VaultHomeScreen', '_shareFile: error', e);
+      if (mounted) {
+        ScaffoldMessenger.of(context).showSnackBar(
+          SnackBar(
+            content: Text(openWith
+                ? 'No app can open this file'
+                : 'Share failed: $e'),
+            backgroundColor: CyberpunkTheme.error,
+          ),
+        );
+      }
+    }
+  }
+
+  Future<void> _exportFolder(String folderPath) async {
+    SecureLogger.d(
+        'VaultHomeScreen', '_exportFolder: starting export of $folderPath');
+    widget.stateManager.recordActivity();
+
+    final folderName = folderPath.split('/').last;
+    final files =
+        widget.stateManager.getFilePathsInFolderRecursive(folderPath);
+    if (files.isEmpty) {
+      ScaffoldMessenger.of(context).showSnackBar(
+        const SnackBar(content: Text('Folder is empty')),
+      );
+      return;
+    }
+
+    final confirm = await _confirmPlaintextExport(
+      title: 'EXPORT FOLDER',
+      message: 'You are about to export "$folderName" (${files.length} '
+          'files) outside the vault as one ZIP archive.',
+      noun: 'archive',
+    );
+    if (!confirm) {
+      SecureLogger.d('VaultHomeScreen', '_exportFolder: user cancelled');
+      return;
+    }
+
+    widget.stateManager.freezeTimers();
+    setState(() {
+      _isExporting = true;
+      _exportProgress = 0;
+    });
+
+    // Keep screen awake during export
+    await VaultChannel.enableWakelock();
+
+    try {
+      final success = await VaultChannel.exportArchive(
+        fileIds: files.keys.map((e) => e.fileId).toList(),
+        paths: files.values.toList(),
+        suggestedName: '$folderName.zip',
+      );
+      SecureLogger.d(
+          'VaultHomeScreen', '_exportFolder: export result=$success');
+
+      if (mounted) {
+        ScaffoldMessenger.of(context).showSnackBar(
+          SnackBar(
+            content: Text(success
+                ? 'Exported: $folderName.zip'
+                : 'Export cancelled or failed'),
+            backgroundColor: success
+                ? CyberpunkTheme.neonGreen.withOpacity(0.9)
+                : CyberpunkTheme.surface,
+          ),
+        );
+      }
+    } catch (e) {
+      SecureLogger.e('VaultHomeScreen', '_exportFolder: error', e);
+      if (mounted) {
+        ScaffoldMessenger.of(context).showSnackBar(
+          SnackBar(
+            content: Text('Export failed: $e'),
+            backgroundColor: CyberpunkTheme.error,
+          ),
+        );
+      }
+    } finally {
+      await VaultChannel.disableWakelock();
+      widget.stateManager.unfreezeTimers();
+      if (mounted) {
+        setState(() {
+          _isExporting = false;
+          _exportProgress = null;
+        });
+      }
+    }
+  }
+
   Future<void> _deleteFolder(String folderPath) async {
     SecureLogger.d(
         'VaultHomeScreen', '_deleteFolder: starting deletion of $folderPath');
@@ -1490,7 +2025,14 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
     } else if (entry.isVideo) {
       Navigator.pushNamed(context, '/video-player', arguments: entry);
     } else if (entry.isImage) {
-      Navigator.pushNamed(context, '/image-viewer', arguments: entry);
+      Navigator.pushNamed(
+        context,
+        '/image-viewer',
+        arguments: ImageViewerArgs(
+          entry: entry,
+          siblings: _filteredEntries.where((e) => e.isImage).toList(),
+        ),
+      );
     } else if (entry.isPdf || entry.isDocx || entry.isPptx || entry.isXlsx) {
       Navigator.pushNamed(context, '/document-viewer', arguments: entry);
     } else if (entry.isCsv || entry.isTextLike) {
@@ -1589,6 +2131,8 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
                     _showChangePasswordDialog();
                   } else if (value == 'export') {
                     _showExportDialog();
+                  } else if (value == 'storage') {
+                    _showStorageDialog();
                   }
                 },
                 itemBuilder: (context) => [
@@ -1605,6 +2149,19 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
                       ],
                     ),
                   ),
+                  PopupMenuItem(
+                    value: 'storage',
+                    child: Row(
+                      children: [
+                        const Icon(Icons.pie_chart_outline,
+                            size: 20, color: CyberpunkTheme.neonGreen),
+                        const SizedBox(width: 12),
+                        const Text('Storage',
+                            style:
+                                TextStyle(color: CyberpunkTheme.textPrimary)),
+                      ],
+                    ),
+                  ),
                   PopupMenuItem(
                     value: 'export',
                     child: Row(
@@ -1665,17 +2222,11 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
                         SecureKeyboard.show(
                           context,
                           controller: _searchController,
-                          onChanged: (value) {
-                            setState(() => _searchQuery = value);
-                            widget.stateManager.recordActivity();
-                          },
+                          onChanged: _onSearchChanged,
                         );
                       }
                     },
-                    onChanged: (value) {
-                      setState(() => _searchQuery = value);
-                      widget.stateManager.recordActivity();
-                    },
+                    onChanged: _onSearchChanged,
                     style: const TextStyle(color: CyberpunkTheme.textPrimary),
                     cursorColor: CyberpunkTheme.neonGreen,
                     decoration: InputDecoration(
@@ -1711,7 +2262,11 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
                                   color: CyberpunkTheme.textSecondary),
                               onPressed: () {
                                 _searchController.clear();
-                                setState(() => _searchQuery = '');
+                                _contentSearchSeq++;
+                                setState(() {
+                                  _searchQuery = '';
+                                  _contentMatches = const [];
+                                });
                               },
                             )
                           : null,
@@ -1743,6 +2298,7 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
                             name: name,
                             onTap: () => _enterFolder(name),
                             onRename: () => _renameFolder(fullPath),
+                            onExport: () => _exportFolder(fullPath),
                             onDelete: () => _deleteFolder(fullPath),
                           );
                         }
@@ -1755,6 +2311,8 @@ class _VaultHomeScreenState extends State<VaultHomeScreen> {
                           onMove: () => _moveFile(entry),
                           onCopy: () => _copyFile(entry),
                           onExport: () => _exportFile(entry),
+                          onShare: () => _shareFile(entry),
+                          onOpenWith: () => _shareFile(entry, openWith: true),
                         );
                       },
                     );
@@ -1845,6 +2403,8 @@ class _FileListItem extends StatelessWidget {
   final VoidCallback onMove;
   final VoidCallback onCopy;
   final VoidCallback onExport;
+  final VoidCallback onShare;
+  final VoidCallback onOpenWith;
 
   const _FileListItem({
     required this.entry,
@@ -1854,6 +2414,8 @@ class _FileListItem extends StatelessWidget {
     required this.onMove,
     required this.onCopy,
     required this.onExport,
+    required this.onShare,
+    required this.onOpenWith,
   });
 
   @override
@@ -1933,6 +2495,10 @@ class _FileListItem extends StatelessWidget {
                       onCopy();
                     } else if (value == 'export') {
                       onExport();
+                    } else if (value == 'share') {
+                      onShare();
+                    } else if (value == 'open_with') {
+                      onOpenWith();
                     } else if (value == 'delete') {
                       onDelete();
                     }
@@ -1989,6 +2555,30 @@ class _FileListItem extends StatelessWidget {
                         ],
                       ),
                     ),
+                    PopupMenuItem(
+                      value: 'share',
+                      child: Row(
+                        children: [
+                          const Icon(Icons.share_outlined,
+                              size: 20, color: CyberpunkTheme.warning),
+                          const SizedBox(width: 12),
+                          const Text('Share',
+                              style: TextStyle(color: CyberpunkTheme.warning)),
+                        ],
+                      ),
+                    ),
+                    PopupMenuItem(
+                      value: 'open_with',
+                      child: Row(
+                        children: [
+                          const Icon(Icons.open_in_new,
+                              size: 20, color: CyberpunkTheme.warning),
+                          const SizedBox(width: 12),
+                          const Text('Open with',
+                              style: TextStyle(color: CyberpunkTheme.warning)),
+                        ],
+                      ),
+                    ),
                     PopupMenuItem(
                       value: 'delete',
                       child: Row(
@@ -2021,12 +2611,14 @@ class _FolderListItem extends StatelessWidget {
   final VoidCallback onTap;
   final VoidCallback? onDelete;
   final VoidCallback? onRename;
+  final VoidCallback? onExport;
 
   const _FolderListItem({
     required this.name,
     required this.onTap,
     this.onDelete,
     this.onRename,
+    this.onExport,
   });
 
   @override
@@ -2042,9 +2634,10 @@ class _FolderListItem extends StatelessWidget {
         color: Colors.transparent,
         child: InkWell(
           onTap: onTap,
-          onLongPress: (onDelete != null || onRename != null)
-              ? () => _showFolderOptions(context)
-              : null,
+          onLongPress:
+              (onDelete != null || onRename != null || onExport != null)
+                  ? () => _showFolderOptions(context)
+                  : null,
           borderRadius: BorderRadius.circular(12),
           child: Padding(
             padding: const EdgeInsets.all(12),
@@ -2130,6 +2723,22 @@ class _FolderListItem extends StatelessWidget {
                     onRename?.call();
                   },
                 ),
+              if (onExport != null)
+                ListTile(
+                  leading:
+                      const Icon(Icons.archive, color: CyberpunkTheme.warning),
+                  title: const Text('Export as ZIP',
+                      style: TextStyle(color: CyberpunkTheme.textPrimary)),
+                  subtitle: const Text(
+                    'Decrypt all contents into one archive',
+                    style:
+                        TextStyle(color: CyberpunkTheme.textHint, fontSize: 12),
+                  ),
+                  onTap: () {
+                    Navigator.pop(context);
+                    onExport?.call();
+                  },
+                ),
               if (onDelete != null)
                 ListTile(
                   leading: const Icon(Icons.delete_forever,
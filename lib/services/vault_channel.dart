@@ -108,6 +108,59 @@ class VaultChannel {
     return Map<String, dynamic>.from(result);
   }
 
+  /// Import every file in a ZIP/TAR archive, keeping its folder structure
+  static Future<Map<String, dynamic>> importArchive(
+    String uri, {
+    int? sessionId,
+  }) async {
+    final result = await _channel.invokeMethod<Map>('importArchive', {
+      'uri': uri,
+      'sessionId': sessionId,
+    });
+    if (result == null) return {};
+    return Map<String, dynamic>.from(result);
+  }
+
+  /// Watch a folder picked with [pickFolder]; syncs import only files that
+  /// are new or changed since the previous sync, into vault [folder]
+  static Future<Map<String, dynamic>> addWatchedSource(String uri,
+      {String folder = ''}) async {
+    final result = await _channel.invokeMethod<Map>('addWatchedSource', {
+      'uri': uri,
+      'folder': folder,
+    });
+    return Map<String, dynamic>.from(result!);
+  }
+
+  /// Watched folders of the open vault
+  static Future<List<Map<String, dynamic>>> listWatchedSources() async {
+    final result = await _channel.invokeMethod<List>('listWatchedSources');
+    if (result == null) return [];
+    return result.map((e) => Map<String, dynamic>.from(e as Map)).toList();
+  }
+
+  /// Stop watching a folder; files already imported stay in the vault
+  static Future<bool> removeWatchedSource(String id) async {
+    return await _channel.invokeMethod<bool>('removeWatchedSource', {
+          'id': id,
+        }) ??
+        false;
+  }
+
+  /// Import what changed in a watched folder. Same shape as [importFolder],
+  /// plus 'unchanged' (files already synced) and the target 'folder'.
+  static Future<Map<String, dynamic>> syncWatchedSource(
+    String id, {
+    int? sessionId,
+  }) async {
+    final result = await _channel.invokeMethod<Map>('syncWatchedSource', {
+      'id': id,
+      'sessionId': sessionId,
+    });
+    if (result == null) return {};
+    return Map<String, dynamic>.from(result);
+  }
+
   /// Import in-memory data (used for system metadata like folder map)
   static Future<List<int>> importBytes({
     required Uint8List data,
@@ -171,6 +224,24 @@ class VaultChannel {
     });
   }
 
+  /// Delete several files with a single index commit.
+  /// All IDs are validated together; on failure nothing is deleted.
+  static Future<void> deleteFiles(List<List<int>> fileIds) async {
+    if (fileIds.isEmpty) return;
+    await _channel.invokeMethod('deleteFiles', {'fileIds': fileIds});
+  }
+
+  /// Rename several files with a single index commit.
+  /// All names are validated together; on failure nothing is renamed.
+  static Future<void> renameFiles(
+      List<List<int>> fileIds, List<String> names) async {
+    if (fileIds.isEmpty) return;
+    await _channel.invokeMethod('renameFiles', {
+      'fileIds': fileIds,
+      'names': names,
+    });
+  }
+
   /// Copy a file in the vault (re-encrypts to new file ID)
   static Future<List<int>> copyFile(List<int> fileId) async {
     final result =
@@ -188,11 +259,70 @@ class VaultChannel {
         false;
   }
 
+  /// Hand a file to another app through a streamed content URI; nothing is
+  /// written to disk. [openWith] opens it in a viewer instead of sending it.
+  /// Access ends when the vault locks.
+  static Future<bool> shareFile(List<int> fileId,
+      {String? mime, bool openWith = false}) async {
+    return await _channel.invokeMethod<bool>('shareFile', {
+          'fileId': fileId,
+          'mime': mime,
+          'mode': openWith ? 'view' : 'send',
+        }) ??
+        false;
+  }
+
+  /// Export several decrypted files as one ZIP or TAR via a single SAF
+  /// picker. [paths] holds each file's location inside the archive; progress
+  /// arrives as 'export_archive' transfer events.
+  /// Returns true if export was successful, false if cancelled
+  static Future<bool> exportArchive({
+    required List<List<int>> fileIds,
+    required List<String> paths,
+    required String suggestedName,
+    String format = 'zip',
+  }) async {
+    return await _channel.invokeMethod<bool>('exportArchive', {
+          'fileIds': fileIds,
+          'paths': paths,
+          'suggestedName': suggestedName,
+          'format': format,
+        }) ??
+        false;
+  }
+
   /// Get number of entries in vault
   static Future<int> getEntryCount() async {
     return await _channel.invokeMethod<int>('getEntryCount') ?? 0;
   }
 
+  /// Get vault statistics: sizes, dead space, per-type breakdown,
+  /// fragmentation and largest files. Served from counters kept by native
+  /// code, so it does not walk the index.
+  static Future<Map<String, dynamic>> getVaultStats() async {
+    final result = await _channel.invokeMethod<Map>('getVaultStats');
+    return Map<String, dynamic>.from(result ?? const {});
+  }
+
+  /// Analyze the container's physical layout: per-entry fragmentation
+  /// (index runs vs. filesystem extents), dead-space distribution across the
+  /// file, the index record of each root slot (`indexRecords`, current
+  /// first) and sequential-read cost estimates.
+  /// Walks the whole index, so call it on demand rather than per frame.
+  static Future<Map<String, dynamic>> analyzeLayout() async {
+    final result = await _channel.invokeMethod<Map>('analyzeLayout');
+    return Map<String, dynamic>.from(result ?? const {});
+  }
+
+  /// Full-text search over stored text; returns file IDs, best match first.
+  /// Matches files containing every word of [query].
+  static Future<List<List<int>>> searchFiles(String query) async {
+    final result =
+        await _channel.invokeMethod<List>('searchFiles', {'query': query});
+    if (result == null) return [];
+    return result.map((id) => (id as List).cast<int>()).toList();
+  }
+
   /// List all files in vault
   static Future<List<Map<String, dynamic>>> listFiles() async {
     final result = await _channel.invokeMethod<List>('listFiles');
@@ -45,6 +45,11 @@ class VaultStateManager extends ChangeNotifier {
   static const String _folderMapName = '__folder_map__';
   static const String _folderMapTempName = '__folder_map__.tmp';
   static const int _folderMapVersion = 1;
+
+  /// Upper bound for one file of the per-file deleteFolder fallback, so a
+  /// stalled delete cannot hold the whole folder deletion open.
+  static const Duration _folderDeleteFileTimeout = Duration(seconds: 30);
+
   VaultState get state => _state;
   List<VaultEntry> get entries => _entries;
   DateTime? get lastActivity => _lastActivity;
@@ -370,6 +375,37 @@ class VaultStateManager extends ChangeNotifier {
     return _fileFolders[_fileIdToHex(entry.fileId)] ?? '';
   }
 
+  /// Vault statistics from native counters, plus a per-folder breakdown.
+  ///
+  /// Folders exist only in the encrypted folder map held here, so the
+  /// folder totals are aggregated from the already-loaded entry list; each
+  /// folder's bytes include its subfolders. Largest files gain their names.
+  Future<Map<String, dynamic>> getStorageStats() async {
+    final stats = await VaultChannel.getVaultStats();
+    final names = <String, String>{};
+    final folderBytes = <String, int>{};
+    for (final entry in _entries) {
+      names[_fileIdToHex(entry.fileId)] = entry.name;
+      var folder = folderForEntry(entry);
+      while (true) {
+        folderBytes[folder] = (folderBytes[folder] ?? 0) + entry.size;
+        if (folder.isEmpty) break;
+        final slash = folder.lastIndexOf('/');
+        folder = slash < 0 ? '' : folder.substring(0, slash);
+      }
+    }
+    stats['folderBytes'] = folderBytes;
+    stats['largestFiles'] = [
+      for (final file in (stats['largestFiles'] as List? ?? const []))
+        {
+          'size': (file as Map)['size'] as int,
+          'name': names[_fileIdToHex((file['fileId'] as List).cast<int>())] ??
+              '',
+        },
+    ];
+    return stats;
+  }
+
   bool hasFolder(String path) {
     final normalized = _normalizeFolderPath(path);
     return normalized.isEmpty || _folders.contains(normalized);
@@ -427,6 +463,21 @@ class VaultStateManager extends ChangeNotifier {
     _safeNotify();
   }
 
+  /// Move several files with a single folder-map commit.
+  Future<void> moveFilesToFolder(
+      List<VaultEntry> entries, String destination) async {
+    if (entries.isEmpty) return;
+    final normalized = _normalizeFolderPath(destination);
+    if (normalized.isNotEmpty) {
+      _addFolderWithParents(normalized);
+    }
+    for (final entry in entries) {
+      _fileFolders[_fileIdToHex(entry.fileId)] = normalized;
+    }
+    await _persistFolderMap();
+    _safeNotify();
+  }
+
   /// Delete a folder and all its contents (files and subfolders)
   /// SECURITY: All files are securely deleted via VaultChannel.deleteFile
   /// which performs secure zeroization before deletion
@@ -463,12 +514,29 @@ class VaultStateManager extends ChangeNotifier {
     SecureLogger.d('VaultStateManager',
         'deleteFolder: found ${filesToDelete.length} files to delete');
 
-    // Delete all files in the folder
-    for (final entry in filesToDelete.entries) {
+    // Delete all files in the folder with one index commit; fall back to
+    // per-file deletion so one bad entry cannot block the rest.
+    try {
+      await VaultChannel.deleteFiles(filesToDelete.values.toList());
+      for (final key in filesToDelete.keys) {
+        _fileFolders.remove(key);
+      }
+      _entries.removeWhere(
+          (e) => filesToDelete.containsKey(_fileIdToHex(e.fileId)));
+      deletedCount = filesToDelete.length;
+      filesToDelete.clear();
+    } catch (e) {
+      SecureLogger.w('VaultStateManager',
+          'deleteFolder: bulk delete failed, deleting individually: $e');
+    }
+    // Issued together so the engine group-commits them; each still
+    // succeeds or fails on its own.
+    await Future.wait(filesToDelete.entries.map((entry) async {
       try {
         SecureLogger.d('VaultStateManager',
             'deleteFolder: deleting file ${entry.key.substring(0, 8)}...');
-        await VaultChannel.deleteFile(entry.value);
+        await VaultChannel.deleteFile(entry.value)
+            .timeout(_folderDeleteFileTimeout);
         _fileFolders.remove(entry.key);
         _entries.removeWhere((e) => _fileIdToHex(e.fileId) == entry.key);
         deletedCount++;
@@ -479,9 +547,9 @@ class VaultStateManager extends ChangeNotifier {
             'VaultStateManager',
             'deleteFolder: failed to delete file ${entry.key.substring(0, 8)}...',
             e);
-        // Continue deleting other files even if one fails
+        // Continue deleting other files even if one fails or times out
       }
-    }
+    }));
 
     // Remove this folder and all subfolders from the folder set
     final foldersToRemove = _folders
@@ -593,6 +661,23 @@ class VaultStateManager extends ChangeNotifier {
     }).toList();
   }
 
+  /// Get all files in a folder and its subfolders with their paths relative
+  /// to the folder's parent (e.g. "Photos/2024/a.jpg" for folder "Photos")
+  Map<VaultEntry, String> getFilePathsInFolderRecursive(String folderPath) {
+    final normalized = _normalizeFolderPath(folderPath);
+    if (normalized.isEmpty) return {};
+
+    final parentLength = normalized.lastIndexOf('/') + 1;
+    final paths = <VaultEntry, String>{};
+    for (final entry in _entries) {
+      final fileFolder = _fileFolders[_fileIdToHex(entry.fileId)] ?? '';
+      if (fileFolder == normalized || fileFolder.startsWith('$normalized/')) {
+        paths[entry] = '${fileFolder.substring(parentLength)}/${entry.name}';
+      }
+    }
+    return paths;
+  }
+
   /// Get count of all files in a folder and its subfolders
   int getFileCountInFolderRecursive(String folderPath) {
     final normalized = _normalizeFolderPath(folderPath);
@@ -1003,6 +1088,19 @@ class VaultStateManager extends ChangeNotifier {
     }
   }
 
+  /// Entries whose stored text contains every word of [query], best match
+  /// first. Served by the native encrypted term index, so no file is
+  /// decrypted.
+  Future<List<VaultEntry>> searchContent(String query) async {
+    if (query.trim().isEmpty) return [];
+    final ids = await VaultChannel.searchFiles(query);
+    final byId = {for (final e in _entries) _fileIdToHex(e.fileId): e};
+    return ids
+        .map((id) => byId[_fileIdToHex(id)])
+        .whereType<VaultEntry>()
+        .toList();
+  }
+
   /// Search entries by name
   List<VaultEntry> searchEntries(String query) {
     if (query.isEmpty) return _entries;
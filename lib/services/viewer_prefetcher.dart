@@ -0,0 +1,288 @@
+/// ViewerPrefetcher - Neighbour Prefetch for Viewer Navigation
+///
+/// Keeps the items around the current position of a viewer list decrypted
+/// (images also decoded to screen size) so a swipe shows them at once
+/// instead of paying the method-channel, decrypt and decode latency.
+///
+/// - Loads [ahead] items in the direction of travel and [behind] against it,
+///   nearest first, one at a time
+/// - A direction change drops queued loads that are no longer wanted; a
+///   load already in flight is discarded when it lands
+/// - Items furthest from the position are evicted to stay within
+///   [budgetBytes]; the current item is always kept, and no decode, full
+///   resolution included, is larger than [budgetBytes] on its own
+///
+/// SECURITY:
+/// - Decrypted bytes live in memory only and are zeroized on eviction
+/// - Encoded image bytes are zeroized as soon as they are decoded
+/// - Decoded images are disposed on eviction and on [dispose]; viewers show
+///   a clone (see [PrefetchedItem.image]) so eviction never pulls an image
+///   out from under the screen
+
+import 'dart:math' as math;
+import 'dart:typed_data';
+import 'dart:ui' as ui;
+
+import 'package:flutter/foundation.dart';
+
+import '../models/vault_state.dart';
+import '../utils/secure_logger.dart';
+import '../utils/secure_passphrase.dart';
+import 'vault_channel.dart';
+
+/// A decrypted viewer item: a decoded [image], or the raw [bytes] when the
+/// item is not decoded (documents, animated images). Both belong to the
+/// prefetcher; callers keep `image.clone()` or a copy of the bytes.
+class PrefetchedItem {
+  final Uint8List? bytes;
+  final ui.Image? image;
+
+  /// Whether [image] was decoded at the source's own resolution
+  final bool fullResolution;
+
+  PrefetchedItem._({this.bytes, this.image, this.fullResolution = false});
+
+  int get sizeBytes =>
+      (bytes?.length ?? 0) +
+      (image == null
+          ? 0
+          : image!.width * image!.height * ViewerPrefetcher._bytesPerPixel);
+
+  void _release() {
+    SecurePassphrase.zeroize(bytes);
+    image?.dispose();
+  }
+}
+
+class ViewerPrefetcher {
+  static const String _tag = 'ViewerPrefetcher';
+
+  /// Decoded images are RGBA
+  static const int _bytesPerPixel = 4;
+
+  final List<VaultEntry> entries;
+  final int ahead;
+  final int behind;
+  final int budgetBytes;
+
+  /// Longest side, in pixels, images are decoded to (null keeps raw bytes)
+  final int? decodeMaxSide;
+
+  /// Whether an entry is decoded; others keep their raw bytes
+  final bool Function(VaultEntry entry) shouldDecode;
+
+  final Map<int, PrefetchedItem> _items = {};
+  final Map<int, Future<void>> _loading = {};
+  final List<int> _queue = [];
+  int _position = 0;
+  int _direction = 1;
+  bool _pumping = false;
+  bool _disposed = false;
+
+  ViewerPrefetcher({
+    required this.entries,
+    this.ahead = 2,
+    this.behind = 1,
+    this.budgetBytes = 64 * 1024 * 1024,
+    this.decodeMaxSide,
+    bool Function(VaultEntry entry)? shouldDecode,
+  }) : shouldDecode = shouldDecode ?? ((entry) => entry.isImage);
+
+  /// The item at [index] if it is already loaded
+  PrefetchedItem? peek(int index) => _items[index];
+
+  /// Load [index] now, ahead of any queued neighbour. Completes with null
+  /// if the viewer moved away before the item arrived.
+  Future<PrefetchedItem?> load(int index) async {
+    final cached = _items[index];
+    if (cached != null) return cached;
+    await (_loading[index] ??= _fetch(index, fullResolution: false));
+    return _items[index];
+  }
+
+  /// Replace the item at [index] with a decode at the source resolution,
+  /// e.g. once the user zooms in
+  Future<PrefetchedItem?> loadFullResolution(int index) async {
+    try {
+      await _loading[index];
+    } catch (_) {
+      // Retried below
+    }
+    final cached = _items[index];
+    if (cached != null && (cached.image == null || cached.fullResolution)) {
+      return cached;
+    }
+    await (_loading[index] = _fetch(index, fullResolution: true));
+    return _items[index];
+  }
+
+  /// Note that the viewer moved to [index] and prefetch around it
+  void moveTo(int index) {
+    if (_disposed || index < 0 || index >= entries.length) return;
+    if (index != _position) {
+      final direction = index > _position ? 1 : -1;
+      if (direction != _direction) {
+        SecureLogger.d(_tag, 'moveTo: direction changed, dropping queue');
+      }
+      _direction = direction;
+    }
+    _position = index;
+
+    _queue
+      ..clear()
+      ..addAll(_wanted().where(
+          (i) => i != index && !_items.containsKey(i) && !_loading.containsKey(i)));
+    _evict();
+    _pump();
+  }
+
+  void dispose() {
+    _disposed = true;
+    _queue.clear();
+    for (final item in _items.values) {
+      item._release();
+    }
+    _items.clear();
+  }
+
+  /// Neighbour indices to keep, nearest first, direction of travel first
+  List<int> _wanted() {
+    final wanted = <int>[];
+    for (var step = 1; step <= math.max(ahead, behind); step++) {
+      final next = _position + step * _direction;
+      final previous = _position - step * _direction;
+      if (step <= ahead && next >= 0 && next < entries.length) {
+        wanted.add(next);
+      }
+      if (step <= behind && previous >= 0 && previous < entries.length) {
+        wanted.add(previous);
+      }
+    }
+    return wanted;
+  }
+
+  bool _isWanted(int index) =>
+      index == _position || _wanted().contains(index);
+
+  Future<void> _pump() async {
+    if (_pumping) return;
+    _pumping = true;
+    try {
+      while (!_disposed && _queue.isNotEmpty) {
+        final index = _queue.removeAt(0);
+        if (_items.containsKey(index) || _loading.containsKey(index)) continue;
+        try {
+          await (_loading[index] = _fetch(index, fullResolution: false));
+        } catch (e) {
+          // The viewer reports the error if the user gets there
+          SecureLogger.w(_tag, 'prefetch of item $index failed: $e');
+        }
+      }
+    } finally {
+      _pumping = false;
+    }
+  }
+
+  Future<void> _fetch(int index, {required bool fullResolution}) async {
+    try {
+      final entry = entries[index];
+      final bytes = await VaultChannel.readFile(entry.fileId);
+      PrefetchedItem item;
+      if (!shouldDecode(entry)) {
+        item = PrefetchedItem._(bytes: bytes);
+      } else {
+        try {
+          final image = await _decode(bytes, fullResolution ? null : decodeMaxSide);
+          item = PrefetchedItem._(image: image, fullResolution: fullResolution);
+        } finally {
+          SecurePassphrase.zeroize(bytes);
+        }
+      }
+
+      // Landed after dispose, or the user has moved away from it
+      if (_disposed || !_isWanted(index)) {
+        item._release();
+        return;
+      }
+      _items.remove(index)?._release();
+      _items[index] = item;
+      _evict();
+    } finally {
+      _loading.remove(index);
+    }
+  }
+
+  Future<ui.Image> _decode(Uint8List bytes, int? maxSide) async {
+    final buffer = await ui.ImmutableBuffer.fromUint8List(bytes);
+    final descriptor = await ui.ImageDescriptor.encoded(buffer);
+    try {
+      // The current item is never evicted, so it must fit the budget alone
+      final target = decodeTarget(
+        descriptor.width,
+        descriptor.height,
+        maxSide: maxSide,
+        maxPixels: budgetBytes ~/ _bytesPerPixel,
+      );
+      final codec = await descriptor.instantiateCodec(
+        targetWidth: target?.width,
+        targetHeight: target?.height,
+      );
+      try {
+        final frame = await codec.getNextFrame();
+        return frame.image;
+      } finally {
+        codec.dispose();
+      }
+    } finally {
+      descriptor.dispose();
+      buffer.dispose();
+    }
+  }
+
+  /// Size to decode a [width] x [height] image to: at most [maxSide] on the
+  /// longest side and at most [maxPixels] pixels, keeping the aspect ratio.
+  /// Null when the image already fits.
+  @visibleForTesting
+  static ({int width, int height})? decodeTarget(int width, int height,
+      {int? maxSide, int? maxPixels}) {
+    final longest = math.max(width, height);
+    final pixels = width * height;
+    var scale = 1.0;
+    if (maxSide != null && longest > maxSide) {
+      scale = maxSide / longest;
+    }
+    if (maxPixels != null && pixels * scale * scale > maxPixels) {
+      // Rounded down so the result never exceeds the cap
+      scale = math.sqrt(math.max(1, maxPixels) / pixels);
+      return (
+        width: math.max(1, (width * scale).floor()),
+        height: math.max(1, (height * scale).floor()),
+      );
+    }
+    if (scale >= 1.0) return null;
+    return (
+      width: math.max(1, (width * scale).round()),
+      height: math.max(1, (height * scale).round()),
+    );
+  }
+
+  /// Drop unwanted items, then the furthest wanted ones while over budget
+  void _evict() {
+    final unwanted = _items.keys.where((i) => !_isWanted(i)).toList();
+    for (final index in unwanted) {
+      _items.remove(index)?._release();
+    }
+
+    var total = _items.values.fold<int>(0, (sum, item) => sum + item.sizeBytes);
+    if (total <= budgetBytes) return;
+    final byDistance = _items.keys.where((i) => i != _position).toList()
+      ..sort((a, b) =>
+          (b - _position).abs().compareTo((a - _position).abs()));
+    for (final index in byDistance) {
+      if (total <= budgetBytes) break;
+      final item = _items.remove(index)!;
+      total -= item.sizeBytes;
+      item._release();
+    }
+  }
+}
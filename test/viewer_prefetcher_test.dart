@@ -0,0 +1,168 @@
+import 'dart:async';
+import 'dart:typed_data';
+import 'package:flutter/services.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:noleak/models/vault_state.dart';
+import 'package:noleak/services/viewer_prefetcher.dart';
+
+void main() {
+  TestWidgetsFlutterBinding.ensureInitialized();
+
+  const channel = MethodChannel('com.noleak.vault');
+  const itemBytes = 100;
+  final messenger =
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger;
+  final entries = List.generate(
+    10,
+    (i) => VaultEntry(
+      fileId: List<int>.filled(16, i),
+      name: 'doc$i.txt',
+      type: 1,
+      size: itemBytes,
+      createdAt: DateTime.fromMillisecondsSinceEpoch(0),
+      mimeType: 'text/plain',
+    ),
+  );
+
+  // Indices in the order readFile was called; a set gate holds every read
+  late List<int> requests;
+  Completer<void>? gate;
+
+  setUp(() {
+    requests = [];
+    gate = null;
+    messenger.setMockMethodCallHandler(channel, (call) async {
+      if (call.method != 'readFile') {
+        throw PlatformException(code: 'UNEXPECTED_METHOD');
+      }
+      final index = ((call.arguments as Map)['fileId'] as List).first as int;
+      requests.add(index);
+      await gate?.future;
+      return Uint8List(itemBytes)..fillRange(0, itemBytes, index + 1);
+    });
+  });
+  tearDown(() => messenger.setMockMethodCallHandler(channel, null));
+
+  Future<void> settle() async {
+    for (var i = 0; i < 50; i++) {
+      await Future<void>.delayed(Duration.zero);
+    }
+  }
+
+  ViewerPrefetcher prefetcher({int budgetBytes = 64 * 1024 * 1024}) {
+    final prefetcher = ViewerPrefetcher(
+      entries: entries,
+      budgetBytes: budgetBytes,
+      shouldDecode: (_) => false,
+    );
+    addTearDown(prefetcher.dispose);
+    return prefetcher;
+  }
+
+  test('loads the window nearest first, direction of travel first', () async {
+    final p = prefetcher();
+    p.moveTo(5);
+    await settle();
+    expect(requests, [6, 4, 7]);
+    for (final index in [4, 6, 7]) {
+      expect(p.peek(index)!.bytes, everyElement(index + 1));
+    }
+    expect(p.peek(3), isNull);
+    expect(p.peek(8), isNull);
+
+    // The current item is loaded on demand and then served from memory
+    expect((await p.load(5))!.bytes, everyElement(6));
+    expect(identical(await p.load(5), p.peek(5)), isTrue);
+    expect(requests, [6, 4, 7, 5]);
+
+    // The window stops at the ends of the list
+    p.moveTo(9);
+    await settle();
+    expect(requests, [6, 4, 7, 5, 8]);
+    expect(p.peek(9), isNull);
+  });
+
+  test('a direction change drops queued and in-flight loads', () async {
+    final p = prefetcher();
+    gate = Completer<void>();
+    p.moveTo(5);
+    await settle();
+    expect(requests, [6]);
+
+    // 4 and 7 were queued going forwards; going back wants 3, 5 and 2
+    p.moveTo(4);
+    gate!.complete();
+    await settle();
+    expect(requests, [6, 3, 5, 2]);
+    expect(p.peek(6), isNull);
+    expect(p.peek(7), isNull);
+    for (final index in [2, 3, 5]) {
+      expect(p.peek(index), isNotNull);
+    }
+  });
+
+  test('moving away evicts and zeroizes items outside the window', () async {
+    final p = prefetcher();
+    p.moveTo(5);
+    await p.load(5);
+    await settle();
+    final far = p.peek(7)!.bytes!;
+    final current = p.peek(5)!.bytes!;
+
+    p.moveTo(3);
+    expect(p.peek(7), isNull);
+    expect(far, everyElement(0));
+    // 5 is now two behind the position, outside a window of one
+    expect(p.peek(5), isNull);
+    expect(current, everyElement(0));
+    expect(p.peek(4), isNotNull);
+  });
+
+  test('evicts the furthest items to stay within the budget', () async {
+    final p = prefetcher(budgetBytes: 3 * itemBytes + itemBytes ~/ 2);
+    p.moveTo(5);
+    await p.load(5);
+    await settle();
+    expect(p.peek(7), isNull);
+    for (final index in [4, 5, 6]) {
+      expect(p.peek(index), isNotNull);
+    }
+
+    // The current item is kept even when it alone exceeds the budget
+    final tight = prefetcher(budgetBytes: itemBytes ~/ 2);
+    tight.moveTo(5);
+    final item = await tight.load(5);
+    await settle();
+    expect(identical(tight.peek(5), item), isTrue);
+    for (final index in [4, 6, 7]) {
+      expect(tight.peek(index), isNull);
+    }
+  });
+
+  test('decode sizes respect the side and pixel caps', () {
+    expect(ViewerPrefetcher.decodeTarget(400, 300), isNull);
+    expect(ViewerPrefetcher.decodeTarget(400, 300, maxSide: 400), isNull);
+    expect(ViewerPrefetcher.decodeTarget(4000, 3000, maxSide: 1000),
+        (width: 1000, height: 750));
+    expect(ViewerPrefetcher.decodeTarget(3000, 4000, maxSide: 1000),
+        (width: 750, height: 1000));
+
+    // A full-resolution decode is capped by pixels alone
+    final capped =
+        ViewerPrefetcher.decodeTarget(4000, 3000, maxPixels: 1000000)!;
+    expect(capped.width * capped.height, lessThanOrEqualTo(1000000));
+    expect(capped.width, closeTo(1154, 1));
+    expect(capped.height, closeTo(866, 1));
+    // The tighter of the two caps wins
+    expect(
+        ViewerPrefetcher.decodeTarget(4000, 3000,
+            maxSide: 2000, maxPixels: 1000000),
+        capped);
+    expect(
+        ViewerPrefetcher.decodeTarget(4000, 3000,
+            maxSide: 100, maxPixels: 1000000),
+        (width: 100, height: 75));
+    expect(ViewerPrefetcher.decodeTarget(4000, 3000, maxPixels: 0),
+        (width: 1, height: 1));
+  });
+}
@@ -0,0 +1,53 @@
+/**
+ * Host stand-in for <android/log.h>
+ *
+ * Lets the engine sources build unchanged on Linux. Messages go to stderr
+ * only when NOLEAK_VAULT_LOG is set, so debug builds stay quiet by default.
+ */
+
+#ifndef NOLEAK_HOST_ANDROID_LOG_H
+#define NOLEAK_HOST_ANDROID_LOG_H
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum android_LogPriority {
+  ANDROID_LOG_UNKNOWN = 0,
+  ANDROID_LOG_DEFAULT,
+  ANDROID_LOG_VERBOSE,
+  ANDROID_LOG_DEBUG,
+  ANDROID_LOG_INFO,
+  ANDROID_LOG_WARN,
+  ANDROID_LOG_ERROR,
+  ANDROID_LOG_FATAL,
+  ANDROID_LOG_SILENT,
+} android_LogPriority;
+
+static inline int __android_log_print(int prio, const char *tag,
+                                      const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+static inline int __android_log_print(int prio, const char *tag,
+                                      const char *fmt, ...) {
+  if (!getenv("NOLEAK_VAULT_LOG"))
+    return 0;
+  va_list args;
+  va_start(args, fmt);
+  int written = fprintf(stderr, "%c/%s: ", prio >= ANDROID_LOG_ERROR ? 'E' : 'I',
+                        tag);
+  written += vfprintf(stderr, fmt, args);
+  written += fprintf(stderr, "\n");
+  va_end(args);
+  return written;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NOLEAK_HOST_ANDROID_LOG_H
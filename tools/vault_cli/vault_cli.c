@@ -0,0 +1,1434 @@
+/**
+ * NoLeak Vault CLI - Offline Container Inspection
+ *
+ * Linux command-line tool built from the same engine sources as the app, so
+ * a copied container is parsed, authenticated and decrypted by exactly the
+ * code that wrote it.
+ *
+ * - list: entries with ID, type, size, chunk count and folder path
+ * - verify: authenticate every chunk and blob (AEAD tag) on all cores
+ * - extract: selected entries, or all, to a directory or a tar stream
+ * - layout: container layout and fragmentation report
+ * - Unlock and per-phase timings are printed to stderr
+ *
+ * Opening runs the same recovery as the app (an uncommitted tail is trimmed,
+ * a stale mirror root slot is rewritten, legacy containers are migrated), so
+ * point the tool at a copy of the container, never at the only one.
+ */
+
+#define _GNU_SOURCE // syncfs
+
+#include "vault_archive.h"
+#include "vault_engine.h"
+#include "vault_layout.h"
+#include "vault_tier.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sodium.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CLI_NAME "noleak-vault"
+#define CLI_MAX_THREADS 64
+#define CLI_PASSPHRASE_MAX 1024
+#define CLI_FOLDER_MAP_NAME "__folder_map__"
+#define CLI_FOLDER_MAP_TEMP_NAME "__folder_map__.tmp"
+#define CLI_FOLDER_MAP_VERSION 1
+#define CLI_JSON_MAX_DEPTH 64
+
+typedef struct {
+  const char *command;
+  const char *container;
+  const char *cold_dir;
+  const char *out_dir;
+  const char *tar_path;
+  int include_system;
+  int threads;
+  char **selectors;
+  int selector_count;
+} cli_options_t;
+
+// Folder assignment from the app's folder map, keyed by file ID
+typedef struct {
+  uint8_t file_id[VAULT_ID_LEN];
+  char *folder;
+} cli_folder_t;
+
+typedef struct {
+  cli_folder_t *items;
+  size_t count;
+  size_t cap;
+} cli_folder_map_t;
+
+// A selected entry and where it goes
+typedef struct {
+  uint32_t entry; // index into the vault's entry table
+  char *path;     // relative output path, unique within the selection
+  atomic_int result;
+  atomic_uint failed_units;
+  uint32_t unit_count;
+} cli_target_t;
+
+// One read unit: a chunk of a chunked entry, or a whole single-blob entry
+typedef struct {
+  uint32_t target;
+  uint32_t chunk;
+  uint64_t offset; // plaintext offset inside the entry
+  uint64_t length; // expected plaintext bytes
+} cli_unit_t;
+
+typedef struct {
+  const vault_entry_t *entries;
+  cli_target_t *targets;
+  const cli_unit_t *units;
+  uint64_t unit_count;
+  int out_dirfd; // -1 verifies only
+  atomic_uint_fast64_t next_unit;
+  atomic_uint_fast64_t bytes;
+  pthread_mutex_t lock;
+  uint64_t read_ns; // summed over workers
+  uint64_t write_ns;
+} cli_job_t;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static double ns_to_ms(uint64_t ns) { return (double)ns / 1e6; }
+
+static double mib(uint64_t bytes) { return (double)bytes / (1024.0 * 1024.0); }
+
+static double mib_per_s(uint64_t bytes, uint64_t ns) {
+  return ns > 0 ? mib(bytes) / ((double)ns / 1e9) : 0.0;
+}
+
+static const char *error_text(int code) {
+  switch (code) {
+  case VAULT_OK:
+    return "ok";
+  case VAULT_ERR_INVALID_PARAM:
+    return "invalid parameter";
+  case VAULT_ERR_MEMORY:
+    return "out of memory";
+  case VAULT_ERR_IO:
+    return "I/O error";
+  case VAULT_ERR_CRYPTO:
+    return "crypto failure";
+  case VAULT_ERR_AUTH_FAIL:
+    return "authentication failed";
+  case VAULT_ERR_CORRUPTED:
+    return "corrupted";
+  case VAULT_ERR_NOT_FOUND:
+    return "not found";
+  case VAULT_ERR_ALREADY_EXISTS:
+    return "already exists";
+  case VAULT_ERR_NOT_OPEN:
+    return "vault not open";
+  default:
+    return "unknown error";
+  }
+}
+
+static const char *type_text(uint8_t type) {
+  switch (type) {
+  case VAULT_FILE_TYPE_TXT:
+    return "txt";
+  case VAULT_FILE_TYPE_IMG:
+    return "img";
+  case VAULT_FILE_TYPE_VIDEO:
+    return "video";
+  default:
+    return "other";
+  }
+}
+
+static void id_to_hex(const uint8_t id[VAULT_ID_LEN],
+                      char hex[VAULT_ID_LEN * 2 + 1]) {
+  sodium_bin2hex(hex, VAULT_ID_LEN * 2 + 1, id, VAULT_ID_LEN);
+}
+
+static int is_system_entry(const vault_entry_t *entry) {
+  return entry->name && strncmp(entry->name, "__", 2) == 0;
+}
+
+static uint32_t entry_unit_count(const vault_entry_t *entry) {
+  if (entry->chunk_count > 0)
+    return entry->chunk_count;
+  return entry->size > 0 ? 1 : 0;
+}
+
+static int write_all_at(int fd, const uint8_t *data, size_t len,
+                        uint64_t offset) {
+  while (len > 0) {
+    ssize_t n = pwrite(fd, data, len, (off_t)offset);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return VAULT_ERR_IO;
+    data += n;
+    len -= (size_t)n;
+    offset += (uint64_t)n;
+  }
+  return VAULT_OK;
+}
+
+// ============================================================================
+// Passphrase
+// ============================================================================
+
+/**
+ * Read one line from the terminal with echo off, or from stdin when it is
+ * not a terminal (scripts, pipes). The buffer is sodium-allocated by the
+ * caller; nothing is copied elsewhere.
+ */
+static int read_passphrase(uint8_t *buf, size_t cap, size_t *len_out) {
+  int tty = -1;
+  int in_fd = STDIN_FILENO;
+  struct termios saved;
+  int restore = 0;
+
+  if (isatty(STDIN_FILENO)) {
+    tty = open("/dev/tty", O_RDWR | O_CLOEXEC);
+    if (tty >= 0) {
+      in_fd = tty;
+      dprintf(tty, "Passphrase: ");
+      if (tcgetattr(tty, &saved) == 0) {
+        struct termios quiet = saved;
+        quiet.c_lflag &= ~(tcflag_t)ECHO;
+        restore = tcsetattr(tty, TCSAFLUSH, &quiet) == 0;
+      }
+    }
+  }
+
+  int result = VAULT_OK;
+  size_t len = 0;
+  for (;;) {
+    uint8_t c;
+    ssize_t n = read(in_fd, &c, 1);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0) {
+      result = VAULT_ERR_IO;
+      break;
+    }
+    if (n == 0 || c == '\n')
+      break;
+    if (len + 1 >= cap) {
+      result = VAULT_ERR_INVALID_PARAM;
+      break;
+    }
+    buf[len++] = c;
+  }
+  if (len > 0 && buf[len - 1] == '\r')
+    len--;
+
+  if (restore)
+    tcsetattr(tty, TCSAFLUSH, &saved);
+  if (tty >= 0) {
+    dprintf(tty, "\n");
+    close(tty);
+  }
+  if (result == VAULT_OK && len == 0)
+    result = VAULT_ERR_INVALID_PARAM;
+  *len_out = result == VAULT_OK ? len : 0;
+  return result;
+}
+
+// ============================================================================
+// Folder map
+// ============================================================================
+
+// The app stores folders as JSON:
+//   {"version":1,"folders":[...],"files":{"<hex id>":"a/b",...}}
+// Only "version" and "files" are needed here; everything else is skipped.
+
+static const char *json_ws(const char *p, const char *end) {
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+    p++;
+  return p;
+}
+
+static int json_hex4(const char *p, const char *end, uint32_t *out) {
+  if (end - p < 4)
+    return 0;
+  uint32_t value = 0;
+  for (int i = 0; i < 4; i++) {
+    char c = p[i];
+    value <<= 4;
+    if (c >= '0' && c <= '9')
+      value |= (uint32_t)(c - '0');
+    else if (c >= 'a' && c <= 'f')
+      value |= (uint32_t)(c - 'a' + 10);
+    else if (c >= 'A' && c <= 'F')
+      value |= (uint32_t)(c - 'A' + 10);
+    else
+      return 0;
+  }
+  *out = value;
+  return 1;
+}
+
+static size_t utf8_put(char *out, uint32_t cp) {
+  if (cp < 0x80) {
+    out[0] = (char)cp;
+    return 1;
+  }
+  if (cp < 0x800) {
+    out[0] = (char)(0xC0 | (cp >> 6));
+    out[1] = (char)(0x80 | (cp & 0x3F));
+    return 2;
+  }
+  if (cp < 0x10000) {
+    out[0] = (char)(0xE0 | (cp >> 12));
+    out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    out[2] = (char)(0x80 | (cp & 0x3F));
+    return 3;
+  }
+  out[0] = (char)(0xF0 | (cp >> 18));
+  out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+  out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+  out[3] = (char)(0x80 | (cp & 0x3F));
+  return 4;
+}
+
+/**
+ * Parse a JSON string starting at its opening quote.
+ * @param out Receives a decoded copy (NULL to skip the string)
+ * @return Position after the closing quote, or NULL if malformed
+ */
+static const char *json_string(const char *p, const char *end, char **out) {
+  if (p >= end || *p != '"')
+    return NULL;
+  const char *start = ++p;
+  while (p < end && *p != '"') {
+    if (*p == '\\')
+      p++;
+    p++;
+  }
+  if (p >= end)
+    return NULL;
+  const char *close = p;
+  if (!out)
+    return close + 1;
+
+  // Escapes never decode to more bytes than they take
+  char *decoded = malloc((size_t)(close - start) + 1);
+  if (!decoded)
+    return NULL;
+  size_t len = 0;
+  for (p = start; p < close; p++) {
+    if (*p != '\\') {
+      decoded[len++] = *p;
+      continue;
+    }
+    p++;
+    uint32_t cp;
+    switch (*p) {
+    case 'b':
+      decoded[len++] = '\b';
+      break;
+    case 'f':
+      decoded[len++] = '\f';
+      break;
+    case 'n':
+      decoded[len++] = '\n';
+      break;
+    case 'r':
+      decoded[len++] = '\r';
+      break;
+    case 't':
+      decoded[len++] = '\t';
+      break;
+    case 'u':
+      if (!json_hex4(p + 1, close, &cp))
+        goto malformed;
+      p += 4;
+      if (cp >= 0xD800 && cp <= 0xDBFF) {
+        uint32_t low;
+        if (close - p > 6 && p[1] == '\\' && p[2] == 'u' &&
+            json_hex4(p + 3, close, &low) && low >= 0xDC00 && low <= 0xDFFF) {
+          cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+          p += 6;
+        } else {
+          cp = 0xFFFD;
+        }
+      } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+        cp = 0xFFFD;
+      }
+      len += utf8_put(decoded + len, cp);
+      break;
+    default:
+      decoded[len++] = *p;
+      break;
+    }
+  }
+  decoded[len] = '\0';
+  *out = decoded;
+  return close + 1;
+
+malformed:
+  free(decoded);
+  return NULL;
+}
+
+// Skip any JSON value
+static const char *json_skip(const char *p, const char *end, int depth) {
+  p = json_ws(p, end);
+  if (p >= end || depth > CLI_JSON_MAX_DEPTH)
+    return NULL;
+  if (*p == '"')
+    return json_string(p, end, NULL);
+  if (*p == '{' || *p == '[') {
+    char close = *p == '{' ? '}' : ']';
+    p = json_ws(p + 1, end);
+    if (p < end && *p == close)
+      return p + 1;
+    for (;;) {
+      if (close == '}') {
+        p = json_string(json_ws(p, end), end, NULL);
+        if (!p)
+          return NULL;
+        p = json_ws(p, end);
+        if (p >= end || *p != ':')
+          return NULL;
+        p++;
+      }
+      p = json_skip(p, end, depth + 1);
+      if (!p)
+        return NULL;
+      p = json_ws(p, end);
+      if (p < end && *p == ',') {
+        p++;
+        continue;
+      }
+      return p < end && *p == close ? p + 1 : NULL;
+    }
+  }
+  // Number or literal
+  const char *start = p;
+  while (p < end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' &&
+         *p != '\t' && *p != '\n' && *p != '\r')
+    p++;
+  return p > start ? p : NULL;
+}
+
+static void folder_map_free(cli_folder_map_t *map) {
+  for (size_t i = 0; i < map->count; i++)
+    free(map->items[i].folder);
+  free(map->items);
+  memset(map, 0, sizeof(*map));
+}
+
+static int folder_map_add(cli_folder_map_t *map, const char *hex,
+                          char *folder) {
+  uint8_t id[VAULT_ID_LEN];
+  size_t id_len = 0;
+  if (sodium_hex2bin(id, sizeof(id), hex, strlen(hex), NULL, &id_len, NULL) !=
+          0 ||
+      id_len != VAULT_ID_LEN) {
+    free(folder);
+    return VAULT_OK;
+  }
+  if (map->count == map->cap) {
+    size_t cap = map->cap ? map->cap * 2 : 64;
+    cli_folder_t *items = realloc(map->items, cap * sizeof(*items));
+    if (!items) {
+      free(folder);
+      return VAULT_ERR_MEMORY;
+    }
+    map->items = items;
+    map->cap = cap;
+  }
+  memcpy(map->items[map->count].file_id, id, VAULT_ID_LEN);
+  map->items[map->count].folder = folder;
+  map->count++;
+  return VAULT_OK;
+}
+
+static int folder_cmp(const void *a, const void *b) {
+  return memcmp(((const cli_folder_t *)a)->file_id,
+                ((const cli_folder_t *)b)->file_id, VAULT_ID_LEN);
+}
+
+static int folder_map_parse(const char *json, size_t len,
+                            cli_folder_map_t *map) {
+  const char *end = json + len;
+  const char *p = json_ws(json, end);
+  int version = -1;
+  if (p >= end || *p != '{')
+    return VAULT_ERR_CORRUPTED;
+  p = json_ws(p + 1, end);
+  while (p < end && *p != '}') {
+    char *key = NULL;
+    p = json_string(p, end, &key);
+    if (!p)
+      return VAULT_ERR_CORRUPTED;
+    p = json_ws(p, end);
+    if (p >= end || *p != ':') {
+      free(key);
+      return VAULT_ERR_CORRUPTED;
+    }
+    p = json_ws(p + 1, end);
+
+    if (strcmp(key, "version") == 0) {
+      // The buffer is not NUL-terminated, so no atoi
+      version = 0;
+      for (const char *d = p; d < end && *d >= '0' && *d <= '9'; d++)
+        version = version < 1000 ? version * 10 + (*d - '0') : version;
+      p = json_skip(p, end, 0);
+    } else if (strcmp(key, "files") == 0 && p < end && *p == '{') {
+      p = json_ws(p + 1, end);
+      while (p && p < end && *p != '}') {
+        char *hex = NULL;
+        char *folder = NULL;
+        p = json_string(p, end, &hex);
+        if (p)
+          p = json_ws(p, end);
+        if (p && p < end && *p == ':')
+          p = json_ws(p + 1, end);
+        else
+          p = NULL;
+        if (p && p < end && *p == '"')
+          p = json_string(p, end, &folder);
+        else if (p)
+          p = json_skip(p, end, 0);
+        if (p && folder && folder_map_add(map, hex, folder) != VAULT_OK)
+          p = NULL;
+        else if (!p)
+          free(folder);
+        free(hex);
+        if (p) {
+          p = json_ws(p, end);
+          if (p < end && *p == ',')
+            p = json_ws(p + 1, end);
+        }
+      }
+      if (p && p < end)
+        p++;
+    } else {
+      p = json_skip(p, end, 0);
+    }
+    free(key);
+    if (!p)
+      return VAULT_ERR_CORRUPTED;
+    p = json_ws(p, end);
+    if (p < end && *p == ',')
+      p = json_ws(p + 1, end);
+  }
+  if (version != CLI_FOLDER_MAP_VERSION)
+    return VAULT_ERR_CORRUPTED;
+  if (map->count > 1)
+    qsort(map->items, map->count, sizeof(map->items[0]), folder_cmp);
+  return VAULT_OK;
+}
+
+/**
+ * Load the newest readable folder map, like the app does on unlock.
+ * A vault without one (or with an unreadable one) lists everything at the
+ * root.
+ */
+static void folder_map_load(const vault_entry_t *entries, uint32_t count,
+                            cli_folder_map_t *map) {
+  uint8_t tried[2][VAULT_ID_LEN];
+  uint32_t tried_count = 0;
+
+  while (tried_count < 2) {
+    const vault_entry_t *candidate = NULL;
+    for (uint32_t i = 0; i < count; i++) {
+      const vault_entry_t *entry = &entries[i];
+      if (!entry->name || (strcmp(entry->name, CLI_FOLDER_MAP_NAME) != 0 &&
+                           strcmp(entry->name, CLI_FOLDER_MAP_TEMP_NAME) != 0))
+        continue;
+      int seen = 0;
+      for (uint32_t t = 0; t < tried_count; t++)
+        seen |= memcmp(tried[t], entry->file_id, VAULT_ID_LEN) == 0;
+      if (!seen && (!candidate || entry->created_at > candidate->created_at))
+        candidate = entry;
+    }
+    if (!candidate)
+      return;
+    memcpy(tried[tried_count++], candidate->file_id, VAULT_ID_LEN);
+
+    uint8_t *data = NULL;
+    size_t len = 0;
+    if (vault_read_file(candidate->file_id, &data, &len) != VAULT_OK)
+      continue;
+    int result = folder_map_parse((const char *)data, len, map);
+    vault_zeroize(data, len);
+    vault_free(data);
+    if (result == VAULT_OK)
+      return;
+    folder_map_free(map);
+  }
+}
+
+static const char *folder_map_find(const cli_folder_map_t *map,
+                                   const uint8_t file_id[VAULT_ID_LEN]) {
+  if (map->count == 0)
+    return NULL;
+  cli_folder_t key;
+  memcpy(key.file_id, file_id, VAULT_ID_LEN);
+  const cli_folder_t *found =
+      bsearch(&key, map->items, map->count, sizeof(map->items[0]), folder_cmp);
+  return found ? found->folder : NULL;
+}
+
+// ============================================================================
+// Output paths
+// ============================================================================
+
+// Append one path component, dropping "", "." and ".." and replacing
+// control characters; slash_ok keeps '/' as a separator (folder paths)
+static void path_append(char *out, size_t *len, const char *src,
+                        int slash_ok) {
+  const char *p = src;
+  while (*p) {
+    const char *start = p;
+    while (*p && !(slash_ok && *p == '/'))
+      p++;
+    size_t n = (size_t)(p - start);
+    if (*p)
+      p++;
+    if (n == 0 || (n == 1 && start[0] == '.') ||
+        (n == 2 && start[0] == '.' && start[1] == '.'))
+      continue;
+    if (*len > 0)
+      out[(*len)++] = '/';
+    for (size_t i = 0; i < n; i++) {
+      unsigned char c = (unsigned char)start[i];
+      out[(*len)++] = (c < 0x20 || c == 0x7F || c == '/' || c == '\\')
+                          ? '_'
+                          : (char)c;
+    }
+  }
+  out[*len] = '\0';
+}
+
+static char *entry_path(const vault_entry_t *entry, const char *folder) {
+  char hex[VAULT_ID_LEN * 2 + 1];
+  id_to_hex(entry->file_id, hex);
+  const char *name = entry->name && entry->name[0] ? entry->name : hex;
+  size_t cap = (folder ? strlen(folder) : 0) + strlen(name) + sizeof(hex) + 2;
+  char *path = malloc(cap);
+  if (!path)
+    return NULL;
+  size_t len = 0;
+  path[0] = '\0';
+  if (folder)
+    path_append(path, &len, folder, 1);
+  size_t folder_len = len;
+  path_append(path, &len, name, 0);
+  if (len == folder_len)
+    path_append(path, &len, hex, 0);
+  return path;
+}
+
+static uint64_t path_hash(const char *s) {
+  uint64_t h = 1469598103934665603ull;
+  for (; *s; s++) {
+    unsigned char c = (unsigned char)*s;
+    if (c >= 'A' && c <= 'Z')
+      c = (unsigned char)(c - 'A' + 'a');
+    h = (h ^ c) * 1099511628211ull;
+  }
+  return h;
+}
+
+// Case-insensitive set, so the output also extracts cleanly on
+// case-insensitive filesystems (matches the app's archive export)
+static int path_set_add(const char **slots, size_t cap, const char *path) {
+  size_t i = (size_t)path_hash(path) & (cap - 1);
+  while (slots[i]) {
+    if (strcasecmp(slots[i], path) == 0)
+      return 0;
+    i = (i + 1) & (cap - 1);
+  }
+  slots[i] = path;
+  return 1;
+}
+
+static int make_paths_unique(cli_target_t *targets, uint32_t count) {
+  size_t cap = 16;
+  while (cap < (size_t)count * 2)
+    cap <<= 1;
+  const char **slots = calloc(cap, sizeof(*slots));
+  if (!slots)
+    return VAULT_ERR_MEMORY;
+
+  for (uint32_t i = 0; i < count; i++) {
+    char *path = targets[i].path;
+    if (path_set_add(slots, cap, path))
+      continue;
+    size_t len = strlen(path);
+    const char *slash = strrchr(path, '/');
+    size_t base = slash ? (size_t)(slash - path) + 1 : 0;
+    const char *dot = strrchr(path + base, '.');
+    size_t stem = dot && dot > path + base ? (size_t)(dot - path) : len;
+    char *candidate = malloc(len + 24);
+    if (!candidate) {
+      free(slots);
+      return VAULT_ERR_MEMORY;
+    }
+    for (unsigned n = 2;; n++) {
+      snprintf(candidate, len + 24, "%.*s (%u)%s", (int)stem, path, n,
+               path + stem);
+      if (path_set_add(slots, cap, candidate))
+        break;
+    }
+    free(path);
+    targets[i].path = candidate;
+  }
+  free(slots);
+  return VAULT_OK;
+}
+
+// ============================================================================
+// Selection
+// ============================================================================
+
+static void targets_free(cli_target_t *targets, uint32_t count) {
+  for (uint32_t i = 0; i < count; i++)
+    free(targets[i].path);
+  free(targets);
+}
+
+/**
+ * Resolve the command-line selectors (hex ID, name or folder path) to
+ * entries. Without selectors every user entry is selected; system entries
+ * only with -a or when named explicitly.
+ */
+static int select_targets(const cli_options_t *opts,
+                          const vault_entry_t *entries, uint32_t count,
+                          const cli_folder_map_t *map,
+                          cli_target_t **targets_out, uint32_t *count_out) {
+  cli_target_t *targets = calloc(count ? count : 1, sizeof(*targets));
+  uint8_t *matched = calloc((size_t)opts->selector_count + 1, 1);
+  if (!targets || !matched) {
+    free(targets);
+    free(matched);
+    return VAULT_ERR_MEMORY;
+  }
+
+  uint32_t selected = 0;
+  int result = VAULT_OK;
+  for (uint32_t i = 0; i < count && result == VAULT_OK; i++) {
+    const vault_entry_t *entry = &entries[i];
+    char *path = entry_path(entry, folder_map_find(map, entry->file_id));
+    if (!path) {
+      result = VAULT_ERR_MEMORY;
+      break;
+    }
+    int take = opts->selector_count == 0 &&
+               (opts->include_system || !is_system_entry(entry));
+    if (opts->selector_count > 0) {
+      char hex[VAULT_ID_LEN * 2 + 1];
+      id_to_hex(entry->file_id, hex);
+      for (int s = 0; s < opts->selector_count; s++) {
+        const char *sel = opts->selectors[s];
+        if (strcasecmp(sel, hex) == 0 ||
+            (entry->name && strcmp(sel, entry->name) == 0) ||
+            strcmp(sel, path) == 0) {
+          matched[s] = 1;
+          take = 1;
+        }
+      }
+    }
+    if (!take) {
+      free(path);
+      continue;
+    }
+    targets[selected].entry = i;
+    targets[selected].path = path;
+    atomic_init(&targets[selected].result, VAULT_OK);
+    atomic_init(&targets[selected].failed_units, 0);
+    selected++;
+  }
+
+  for (int s = 0; s < opts->selector_count && result == VAULT_OK; s++) {
+    if (!matched[s]) {
+      fprintf(stderr, CLI_NAME ": no entry matches '%s'\n",
+              opts->selectors[s]);
+      result = VAULT_ERR_NOT_FOUND;
+    }
+  }
+  free(matched);
+  if (result == VAULT_OK)
+    result = make_paths_unique(targets, selected);
+  if (result != VAULT_OK) {
+    targets_free(targets, selected);
+    return result;
+  }
+  *targets_out = targets;
+  *count_out = selected;
+  return VAULT_OK;
+}
+
+/**
+ * Split the targets into read units. Chunk plaintext sizes follow from the
+ * index (ciphertext length minus the tag), so every unit knows its output
+ * offset and chunks of one file can be decrypted and written out of order.
+ */
+static int plan_units(const vault_entry_t *entries, cli_target_t *targets,
+                      uint32_t count, cli_unit_t **units_out,
+                      uint64_t *count_out, uint64_t *bytes_out) {
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < count; i++)
+    total += entry_unit_count(&entries[targets[i].entry]);
+
+  cli_unit_t *units = malloc((size_t)(total ? total : 1) * sizeof(*units));
+  if (!units)
+    return VAULT_ERR_MEMORY;
+
+  uint64_t n = 0;
+  uint64_t bytes = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    const vault_entry_t *entry = &entries[targets[i].entry];
+    targets[i].unit_count = entry_unit_count(entry);
+    if (entry->chunk_count == 0) {
+      if (entry->size > 0)
+        units[n++] = (cli_unit_t){i, 0, 0, entry->size};
+      bytes += entry->size;
+      continue;
+    }
+    uint64_t offset = 0;
+    for (uint32_t c = 0; c < entry->chunk_count; c++) {
+      uint64_t length = entry->chunks[c].length >= VAULT_TAG_LEN
+                            ? entry->chunks[c].length - VAULT_TAG_LEN
+                            : 0;
+      units[n++] = (cli_unit_t){i, c, offset, length};
+      offset += length;
+    }
+    if (offset != entry->size)
+      atomic_store(&targets[i].result, VAULT_ERR_CORRUPTED);
+    bytes += entry->size;
+  }
+  *units_out = units;
+  *count_out = n;
+  *bytes_out = bytes;
+  return VAULT_OK;
+}
+
+// ============================================================================
+// Parallel read / verify / write
+// ============================================================================
+
+static void target_fail(cli_target_t *target, int result) {
+  int expected = VAULT_OK;
+  atomic_compare_exchange_strong(&target->result, &expected, result);
+  atomic_fetch_add(&target->failed_units, 1);
+}
+
+static void *job_worker(void *arg) {
+  cli_job_t *job = arg;
+  uint64_t read_ns = 0;
+  uint64_t write_ns = 0;
+
+  for (;;) {
+    uint64_t i = atomic_fetch_add(&job->next_unit, 1);
+    if (i >= job->unit_count)
+      break;
+    const cli_unit_t *unit = &job->units[i];
+    cli_target_t *target = &job->targets[unit->target];
+    const vault_entry_t *entry = &job->entries[target->entry];
+
+    // Extraction drops a failed file anyway; verification checks every unit
+    if (job->out_dirfd >= 0 && atomic_load(&target->result) != VAULT_OK)
+      continue;
+
+    uint64_t started = now_ns();
+    uint8_t *data = NULL;
+    size_t len = 0;
+    int result = entry->chunk_count > 0
+                     ? vault_read_chunk(entry->file_id, unit->chunk, &data, &len)
+                     : vault_read_file(entry->file_id, &data, &len);
+    if (result == VAULT_OK && len != unit->length)
+      result = VAULT_ERR_CORRUPTED;
+    uint64_t decrypted = now_ns();
+    read_ns += decrypted - started;
+
+    if (result == VAULT_OK && job->out_dirfd >= 0) {
+      int fd = openat(job->out_dirfd, target->path,
+                      O_WRONLY | O_CLOEXEC | O_NOFOLLOW);
+      if (fd < 0) {
+        result = VAULT_ERR_IO;
+      } else {
+        result = write_all_at(fd, data, len, unit->offset);
+        if (close(fd) != 0)
+          result = VAULT_ERR_IO;
+      }
+      write_ns += now_ns() - decrypted;
+    }
+    if (data) {
+      vault_zeroize(data, len);
+      vault_free(data);
+    }
+    if (result == VAULT_OK)
+      atomic_fetch_add(&job->bytes, len);
+    else
+      target_fail(target, result);
+  }
+
+  pthread_mutex_lock(&job->lock);
+  job->read_ns += read_ns;
+  job->write_ns += write_ns;
+  pthread_mutex_unlock(&job->lock);
+  return NULL;
+}
+
+static int job_run(cli_job_t *job, int threads, int *threads_used) {
+  if ((uint64_t)threads > job->unit_count)
+    threads = job->unit_count > 0 ? (int)job->unit_count : 1;
+  pthread_t workers[CLI_MAX_THREADS];
+  int started = 0;
+  for (int i = 1; i < threads; i++) {
+    if (pthread_create(&workers[started], NULL, job_worker, job) != 0)
+      break;
+    started++;
+  }
+  job_worker(job);
+  for (int i = 0; i < started; i++)
+    pthread_join(workers[i], NULL);
+  *threads_used = started + 1;
+  return VAULT_OK;
+}
+
+static void job_report(const char *phase, const cli_job_t *job,
+                       uint64_t wall_ns, int threads) {
+  uint64_t bytes = atomic_load(&job->bytes);
+  fprintf(stderr,
+          "%-8s %10.1f ms wall, %.1f MiB at %.1f MiB/s on %d thread%s\n",
+          phase, ns_to_ms(wall_ns), mib(bytes), mib_per_s(bytes, wall_ns),
+          threads, threads == 1 ? "" : "s");
+  fprintf(stderr, "%-8s %10.1f ms read+decrypt (summed over threads)\n", "",
+          ns_to_ms(job->read_ns));
+  if (job->out_dirfd >= 0)
+    fprintf(stderr, "%-8s %10.1f ms write (summed over threads)\n", "",
+            ns_to_ms(job->write_ns));
+}
+
+static int report_failures(const vault_entry_t *entries,
+                           const cli_target_t *targets, uint32_t count) {
+  int failed = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    int result = atomic_load(&targets[i].result);
+    if (result == VAULT_OK)
+      continue;
+    char hex[VAULT_ID_LEN * 2 + 1];
+    id_to_hex(entries[targets[i].entry].file_id, hex);
+    unsigned bad = atomic_load(&targets[i].failed_units);
+    fprintf(stderr, "FAIL %s %s: %s", hex, targets[i].path,
+            error_text(result));
+    if (bad > 0)
+      fprintf(stderr, " (%u of %u units)", bad, targets[i].unit_count);
+    fprintf(stderr, "\n");
+    failed++;
+  }
+  return failed;
+}
+
+// ============================================================================
+// Commands
+// ============================================================================
+
+static int cmd_list(const cli_options_t *opts, const vault_entry_t *entries,
+                    uint32_t count, const cli_folder_map_t *map) {
+  cli_target_t *targets = NULL;
+  uint32_t selected = 0;
+  int result = select_targets(opts, entries, count, map, &targets, &selected);
+  if (result != VAULT_OK)
+    return 1;
+
+  printf("%-32s  %-5s  %14s  %7s  %5s  %-16s  %s\n", "ID", "TYPE", "SIZE",
+         "CHUNKS", "COLD", "CREATED (UTC)", "PATH");
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < selected; i++) {
+    const vault_entry_t *entry = &entries[targets[i].entry];
+    char hex[VAULT_ID_LEN * 2 + 1];
+    id_to_hex(entry->file_id, hex);
+    uint32_t cold = 0;
+    for (uint32_t c = 0; c < entry->chunk_count; c++)
+      cold += vault_tier_chunk_is_cold(entry, c) ? 1 : 0;
+    char created[32] = "-";
+    time_t secs = (time_t)(entry->created_at / 1000);
+    struct tm tm;
+    if (entry->created_at > 0 && gmtime_r(&secs, &tm))
+      strftime(created, sizeof(created), "%Y-%m-%d %H:%M", &tm);
+    printf("%-32s  %-5s  %14llu  %7u  %5u  %-16s  %s\n", hex,
+           type_text(entry->type), (unsigned long long)entry->size,
+           entry->chunk_count, cold, created, targets[i].path);
+    total += entry->size;
+  }
+  fprintf(stderr, "%u entries, %.1f MiB\n", selected, mib(total));
+  targets_free(targets, selected);
+  return 0;
+}
+
+static int cmd_verify(const cli_options_t *opts, const vault_entry_t *entries,
+                      uint32_t count, const cli_folder_map_t *map) {
+  cli_target_t *targets = NULL;
+  uint32_t selected = 0;
+  if (select_targets(opts, entries, count, map, &targets, &selected) !=
+      VAULT_OK)
+    return 1;
+
+  cli_unit_t *units = NULL;
+  uint64_t unit_count = 0;
+  uint64_t plaintext = 0;
+  if (plan_units(entries, targets, selected, &units, &unit_count,
+                 &plaintext) != VAULT_OK) {
+    targets_free(targets, selected);
+    return 1;
+  }
+
+  cli_job_t job = {.entries = entries,
+                   .targets = targets,
+                   .units = units,
+                   .unit_count = unit_count,
+                   .out_dirfd = -1,
+                   .lock = PTHREAD_MUTEX_INITIALIZER};
+  atomic_init(&job.next_unit, 0);
+  atomic_init(&job.bytes, 0);
+
+  int threads = 1;
+  uint64_t started = now_ns();
+  job_run(&job, opts->threads, &threads);
+  job_report("verify", &job, now_ns() - started, threads);
+
+  int failed = report_failures(entries, targets, selected);
+  fprintf(stderr, "%u entries, %llu units, %.1f MiB: %s\n", selected,
+          (unsigned long long)unit_count, mib(plaintext),
+          failed ? "FAILED" : "all tags valid");
+  if (failed)
+    fprintf(stderr, "%d entr%s failed verification\n", failed,
+            failed == 1 ? "y" : "ies");
+  free(units);
+  targets_free(targets, selected);
+  return failed ? 1 : 0;
+}
+
+// Create the parent directories of a relative path below dirfd
+static int make_parents(int dirfd, char *path) {
+  for (char *p = strchr(path, '/'); p; p = strchr(p + 1, '/')) {
+    *p = '\0';
+    int result = mkdirat(dirfd, path, 0700) == 0 || errno == EEXIST
+                     ? VAULT_OK
+                     : VAULT_ERR_IO;
+    *p = '/';
+    if (result != VAULT_OK)
+      return result;
+  }
+  return VAULT_OK;
+}
+
+static int extract_to_dir(const cli_options_t *opts,
+                          const vault_entry_t *entries, cli_target_t *targets,
+                          uint32_t count) {
+  if (mkdir(opts->out_dir, 0700) != 0 && errno != EEXIST) {
+    fprintf(stderr, CLI_NAME ": cannot create %s: %s\n", opts->out_dir,
+            strerror(errno));
+    return 1;
+  }
+  int dirfd = open(opts->out_dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dirfd < 0) {
+    fprintf(stderr, CLI_NAME ": cannot open %s: %s\n", opts->out_dir,
+            strerror(errno));
+    return 1;
+  }
+
+  cli_unit_t *units = NULL;
+  uint64_t unit_count = 0;
+  uint64_t plaintext = 0;
+  if (plan_units(entries, targets, count, &units, &unit_count, &plaintext) !=
+      VAULT_OK) {
+    close(dirfd);
+    return 1;
+  }
+
+  // Create every file at full size up front; workers then fill chunks in
+  // any order with positional writes. Existing files are never replaced.
+  uint64_t started = now_ns();
+  for (uint32_t i = 0; i < count; i++) {
+    cli_target_t *target = &targets[i];
+    if (atomic_load(&target->result) != VAULT_OK)
+      continue;
+    int fd = -1;
+    if (make_parents(dirfd, target->path) == VAULT_OK)
+      fd = openat(dirfd, target->path,
+                  O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC | O_NOFOLLOW, 0600);
+    if (fd < 0) {
+      fprintf(stderr, CLI_NAME ": cannot create %s: %s\n", target->path,
+              strerror(errno));
+      atomic_store(&target->result, errno == EEXIST ? VAULT_ERR_ALREADY_EXISTS
+                                                    : VAULT_ERR_IO);
+      continue;
+    }
+    if (ftruncate(fd, (off_t)entries[target->entry].size) != 0)
+      atomic_store(&target->result, VAULT_ERR_IO);
+    close(fd);
+  }
+  uint64_t created = now_ns();
+
+  cli_job_t job = {.entries = entries,
+                   .targets = targets,
+                   .units = units,
+                   .unit_count = unit_count,
+                   .out_dirfd = dirfd,
+                   .lock = PTHREAD_MUTEX_INITIALIZER};
+  atomic_init(&job.next_unit, 0);
+  atomic_init(&job.bytes, 0);
+
+  int threads = 1;
+  job_run(&job, opts->threads, &threads);
+  uint64_t finished = now_ns();
+
+  // Leave no partially written or unauthenticated plaintext behind
+  for (uint32_t i = 0; i < count; i++) {
+    int result = atomic_load(&targets[i].result);
+    if (result != VAULT_OK && result != VAULT_ERR_ALREADY_EXISTS)
+      unlinkat(dirfd, targets[i].path, 0);
+  }
+  if (syncfs(dirfd) != 0)
+    fprintf(stderr, CLI_NAME ": sync failed: %s\n", strerror(errno));
+  uint64_t synced = now_ns();
+  close(dirfd);
+
+  fprintf(stderr, "%-8s %10.1f ms (%u files)\n", "create",
+          ns_to_ms(created - started), count);
+  job_report("extract", &job, finished - created, threads);
+  fprintf(stderr, "%-8s %10.1f ms\n", "sync", ns_to_ms(synced - finished));
+
+  int failed = report_failures(entries, targets, count);
+  fprintf(stderr, "%u of %u entries extracted to %s\n", count - failed, count,
+          opts->out_dir);
+  free(units);
+  return failed ? 1 : 0;
+}
+
+static int extract_to_tar(const cli_options_t *opts,
+                          const vault_entry_t *entries, cli_target_t *targets,
+                          uint32_t count) {
+  int to_stdout = strcmp(opts->tar_path, "-") == 0;
+  if (to_stdout && isatty(STDOUT_FILENO)) {
+    fprintf(stderr, CLI_NAME ": refusing to write a tar stream to a terminal\n");
+    return 1;
+  }
+  int fd = to_stdout ? STDOUT_FILENO
+                     : open(opts->tar_path,
+                            O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+  if (fd < 0) {
+    fprintf(stderr, CLI_NAME ": cannot create %s: %s\n", opts->tar_path,
+            strerror(errno));
+    return 1;
+  }
+
+  vault_export_item_t *items = calloc(count ? count : 1, sizeof(*items));
+  if (!items) {
+    if (!to_stdout) {
+      close(fd);
+      unlink(opts->tar_path);
+    }
+    return 1;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    memcpy(items[i].file_id, entries[targets[i].entry].file_id, VAULT_ID_LEN);
+    items[i].path = targets[i].path;
+  }
+
+  // The engine's export pipeline decrypts on a worker pool and streams in
+  // order; it authenticates every chunk and checks each member's size
+  uint64_t started = now_ns();
+  int result = vault_export_archive(fd, items, count, VAULT_ARCHIVE_FORMAT_TAR);
+  uint64_t wall = now_ns() - started;
+  uint64_t written = vault_archive_bytes_written();
+  free(items);
+
+  if (!to_stdout) {
+    if (close(fd) != 0 && result == VAULT_OK)
+      result = VAULT_ERR_IO;
+    if (result != VAULT_OK)
+      unlink(opts->tar_path);
+  }
+  fprintf(stderr, "%-8s %10.1f ms wall, %.1f MiB at %.1f MiB/s\n", "tar",
+          ns_to_ms(wall), mib(written), mib_per_s(written, wall));
+  if (result != VAULT_OK) {
+    fprintf(stderr, CLI_NAME ": tar export failed: %s\n", error_text(result));
+    return 1;
+  }
+  fprintf(stderr, "%u entries written to %s\n", count,
+          to_stdout ? "stdout" : opts->tar_path);
+  return 0;
+}
+
+static int cmd_extract(const cli_options_t *opts,
+                       const vault_entry_t *entries, uint32_t count,
+                       const cli_folder_map_t *map) {
+  if (!opts->out_dir == !opts->tar_path) {
+    fprintf(stderr, CLI_NAME ": extract needs exactly one of -o DIR or -t FILE\n");
+    return 2;
+  }
+  cli_target_t *targets = NULL;
+  uint32_t selected = 0;
+  if (select_targets(opts, entries, count, map, &targets, &selected) !=
+      VAULT_OK)
+    return 1;
+  int status = opts->out_dir
+                   ? extract_to_dir(opts, entries, targets, selected)
+                   : extract_to_tar(opts, entries, targets, selected);
+  targets_free(targets, selected);
+  return status;
+}
+
+static int cmd_layout(const vault_entry_t *entries, uint32_t count,
+                      const cli_folder_map_t *map) {
+  vault_layout_report_t report;
+  uint64_t started = now_ns();
+  int result = vault_analyze_layout(&report);
+  uint64_t wall = now_ns() - started;
+  if (result != VAULT_OK) {
+    fprintf(stderr, CLI_NAME ": layout analysis failed: %s\n",
+            error_text(result));
+    return 1;
+  }
+
+  printf("container  %llu bytes (committed %llu, header %llu)\n",
+         (unsigned long long)report.file_size,
+         (unsigned long long)report.committed_size,
+         (unsigned long long)report.header_bytes);
+  for (uint32_t i = 0; i < report.index_record_count; i++) {
+    const vault_layout_index_t *record = &report.index_records[i];
+    printf("index      offset %llu, %llu bytes (seq %llu, %s)\n",
+           (unsigned long long)record->offset,
+           (unsigned long long)record->length,
+           (unsigned long long)record->seq, i == 0 ? "current" : "previous");
+  }
+  printf("live       %llu bytes\n", (unsigned long long)report.live_bytes);
+  printf("dead       %llu bytes in %u runs (largest %llu)\n",
+         (unsigned long long)report.dead_bytes, report.dead_runs,
+         (unsigned long long)report.largest_dead_run);
+
+  // One character per bucket, darker = more dead space
+  static const char shades[] = " .:-=+*#%@";
+  uint64_t bucket_bytes =
+      (report.committed_size + VAULT_LAYOUT_DEAD_BUCKETS - 1) /
+      VAULT_LAYOUT_DEAD_BUCKETS;
+  if (bucket_bytes == 0)
+    bucket_bytes = 1;
+  char bar[VAULT_LAYOUT_DEAD_BUCKETS + 1];
+  for (int i = 0; i < VAULT_LAYOUT_DEAD_BUCKETS; i++) {
+    uint64_t level = report.dead_buckets[i] * 9 / bucket_bytes;
+    bar[i] = shades[level > 9 ? 9 : level];
+  }
+  bar[VAULT_LAYOUT_DEAD_BUCKETS] = '\0';
+  printf("dead map   [%s]\n", bar);
+  if (report.fiemap_supported)
+    printf("physical   %u extents\n", report.file_physical_extents);
+  else
+    printf("physical   unavailable (no FIEMAP on this filesystem)\n");
+  printf("read cost  %.1f ms for every entry once\n\n",
+         (double)report.read_cost_us / 1000.0);
+
+  printf("%-32s  %14s  %14s  %7s  %8s  %5s  %10s  %s\n", "ID", "SIZE",
+         "STORED", "LOGICAL", "PHYSICAL", "COLD", "COST (ms)", "PATH");
+  for (uint32_t i = 0; i < report.entry_count; i++) {
+    const vault_layout_entry_t *item = &report.entries[i];
+    const vault_entry_t *entry = NULL;
+    if (i < count &&
+        memcmp(entries[i].file_id, item->file_id, VAULT_ID_LEN) == 0)
+      entry = &entries[i];
+    for (uint32_t e = 0; !entry && e < count; e++)
+      if (memcmp(entries[e].file_id, item->file_id, VAULT_ID_LEN) == 0)
+        entry = &entries[e];
+    char hex[VAULT_ID_LEN * 2 + 1];
+    id_to_hex(item->file_id, hex);
+    char *path =
+        entry ? entry_path(entry, folder_map_find(map, entry->file_id)) : NULL;
+    printf("%-32s  %14llu  %14llu  %7u  %8u  %5u  %10.1f  %s\n", hex,
+           (unsigned long long)item->size,
+           (unsigned long long)item->stored_bytes, item->logical_extents,
+           item->physical_extents, item->cold_chunks,
+           (double)item->read_cost_us / 1000.0, path ? path : "");
+    free(path);
+  }
+  fprintf(stderr, "%-8s %10.1f ms\n", "layout", ns_to_ms(wall));
+  vault_layout_free(&report);
+  return 0;
+}
+
+// ============================================================================
+// Entry point
+// ============================================================================
+
+static void usage(FILE *out) {
+  fprintf(out,
+          "usage: " CLI_NAME " [options] <command> <container> [selector...]\n"
+          "\n"
+          "commands:\n"
+          "  list      list entries (ID, type, size, chunks, folder path)\n"
+          "  verify    authenticate every chunk and blob\n"
+          "  extract   decrypt entries to a directory (-o) or tar (-t)\n"
+          "  layout    container layout and fragmentation report\n"
+          "\n"
+          "selectors: hex file ID, entry name or folder path; none selects\n"
+          "every user entry\n"
+          "\n"
+          "options:\n"
+          "  -j N      worker threads (default: online CPUs)\n"
+          "  -o DIR    extract into DIR; existing files are never replaced\n"
+          "  -t FILE   extract as a tar stream to FILE ('-' for stdout)\n"
+          "  -c DIR    directory holding the vault's cold segment\n"
+          "  -a        include system entries (folder map, vault title)\n"
+          "  -h        show this help\n"
+          "\n"
+          "The passphrase is read from the terminal without echo, or as one\n"
+          "line from stdin. Opening may repair the container exactly like\n"
+          "the app does: always work on a copy.\n");
+}
+
+static int parse_options(int argc, char **argv, cli_options_t *opts) {
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  opts->threads = cpus > 0 ? (int)cpus : 1;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "j:o:t:c:ah")) != -1) {
+    switch (opt) {
+    case 'j':
+      opts->threads = atoi(optarg);
+      if (opts->threads < 1) {
+        fprintf(stderr, CLI_NAME ": -j needs a positive thread count\n");
+        return 2;
+      }
+      break;
+    case 'o':
+      opts->out_dir = optarg;
+      break;
+    case 't':
+      opts->tar_path = optarg;
+      break;
+    case 'c':
+      opts->cold_dir = optarg;
+      break;
+    case 'a':
+      opts->include_system = 1;
+      break;
+    case 'h':
+      usage(stdout);
+      exit(0);
+    default:
+      usage(stderr);
+      return 2;
+    }
+  }
+  if (opts->threads > CLI_MAX_THREADS)
+    opts->threads = CLI_MAX_THREADS;
+  if (argc - optind < 2) {
+    usage(stderr);
+    return 2;
+  }
+  opts->command = argv[optind];
+  opts->container = argv[optind + 1];
+  opts->selectors = argv + optind + 2;
+  opts->selector_count = argc - optind - 2;
+  if (strcmp(opts->command, "list") != 0 &&
+      strcmp(opts->command, "verify") != 0 &&
+      strcmp(opts->command, "extract") != 0 &&
+      strcmp(opts->command, "layout") != 0) {
+    fprintf(stderr, CLI_NAME ": unknown command '%s'\n", opts->command);
+    return 2;
+  }
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  cli_options_t opts = {0};
+  int status = parse_options(argc, argv, &opts);
+  if (status != 0)
+    return status;
+
+  if (vault_init() != VAULT_OK) {
+    fprintf(stderr, CLI_NAME ": libsodium initialization failed\n");
+    return 1;
+  }
+
+  uint8_t *passphrase = sodium_malloc(CLI_PASSPHRASE_MAX);
+  if (!passphrase) {
+    fprintf(stderr, CLI_NAME ": out of memory\n");
+    return 1;
+  }
+  size_t pass_len = 0;
+  if (read_passphrase(passphrase, CLI_PASSPHRASE_MAX, &pass_len) !=
+      VAULT_OK) {
+    sodium_free(passphrase);
+    fprintf(stderr, CLI_NAME ": no passphrase given\n");
+    return 1;
+  }
+
+  uint32_t kdf_mem = 0, kdf_iter = 0, kdf_parallel = 0;
+  vault_inspect_kdf_params(opts.container, &kdf_mem, &kdf_iter,
+                           &kdf_parallel);
+
+  uint64_t started = now_ns();
+  int result = vault_open(opts.container, passphrase, pass_len);
+  uint64_t opened = now_ns();
+  sodium_free(passphrase);
+  if (result != VAULT_OK) {
+    fprintf(stderr, CLI_NAME ": cannot open %s: %s\n", opts.container,
+            result == VAULT_ERR_AUTH_FAIL ? "wrong passphrase"
+                                          : error_text(result));
+    vault_cleanup();
+    return 1;
+  }
+  fprintf(stderr,
+          "%-8s %10.1f ms (Argon2id %u MiB, %u passes; root and index "
+          "decrypted)\n",
+          "unlock", ns_to_ms(opened - started), kdf_mem / (1024 * 1024),
+          kdf_iter);
+
+  if (opts.cold_dir) {
+    result = vault_tier_set_cold_dir(opts.cold_dir);
+    if (result != VAULT_OK) {
+      fprintf(stderr, CLI_NAME ": cold segment in %s: %s\n", opts.cold_dir,
+              error_text(result));
+      vault_cleanup();
+      return 1;
+    }
+  }
+
+  vault_entry_t *entries = NULL;
+  uint32_t count = 0;
+  vault_list_files(&entries, &count);
+
+  cli_folder_map_t map = {0};
+  uint64_t map_started = now_ns();
+  folder_map_load(entries, count, &map);
+  fprintf(stderr, "%-8s %10.1f ms (%u entries, %zu folder assignments)\n",
+          "index", ns_to_ms(now_ns() - map_started), count, map.count);
+
+  if (strcmp(opts.command, "list") == 0)
+    status = cmd_list(&opts, entries, count, &map);
+  else if (strcmp(opts.command, "verify") == 0)
+    status = cmd_verify(&opts, entries, count, &map);
+  else if (strcmp(opts.command, "extract") == 0)
+    status = cmd_extract(&opts, entries, count, &map);
+  else
+    status = cmd_layout(entries, count, &map);
+
+  folder_map_free(&map);
+  vault_cleanup();
+  fprintf(stderr, "%-8s %10.1f ms\n", "total", ns_to_ms(now_ns() - started));
+  return status;
+}